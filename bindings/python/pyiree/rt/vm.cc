@@ -175,6 +175,17 @@ VmModule VmModule::FromFlatbufferBlob(py::buffer flatbuffer_blob) {
   return VmModule::CreateRetained(module);
 }
 
+VmModule VmModule::FromFlatbufferFile(const std::string& path) {
+  // The file is memory-mapped and the module references it in place.
+  iree_vm_module_t* module;
+  CheckApiStatus(
+      iree_vm_bytecode_module_create_from_file({path.data(), path.size()},
+                                               iree_allocator_system(),
+                                               &module),
+      "Error creating vm module from flatbuffer file");
+  return VmModule::CreateRetained(module);
+}
+
 absl::optional<iree_vm_function_t> VmModule::LookupFunction(
     const std::string& name, iree_vm_function_linkage_t linkage) {
   iree_vm_function_t f;
@@ -280,6 +291,7 @@ void SetupVmBindings(pybind11::module m) {
 
   py::class_<VmModule>(m, "VmModule")
       .def_static("from_flatbuffer", &VmModule::FromFlatbufferBlob)
+      .def_static("from_flatbuffer_file", &VmModule::FromFlatbufferFile)
       .def_property_readonly("name", &VmModule::name)
       .def("lookup_function", &VmModule::LookupFunction, py::arg("name"),
            py::arg("linkage") = IREE_VM_FUNCTION_LINKAGE_EXPORT);
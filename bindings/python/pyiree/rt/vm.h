@@ -21,6 +21,7 @@
 #include "iree/base/api.h"
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode_module.h"
+#include "iree/vm/bytecode_module_file.h"
 #include "iree/vm/list.h"
 
 namespace iree {
@@ -117,6 +118,7 @@ class VmInstance : public ApiRefCounted<VmInstance, iree_vm_instance_t> {
 class VmModule : public ApiRefCounted<VmModule, iree_vm_module_t> {
  public:
   static VmModule FromFlatbufferBlob(py::buffer flatbuffer_blob);
+  static VmModule FromFlatbufferFile(const std::string& path);
 
   absl::optional<iree_vm_function_t> LookupFunction(
       const std::string& name, iree_vm_function_linkage_t linkage);
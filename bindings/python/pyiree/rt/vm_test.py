@@ -15,6 +15,8 @@
 
 # pylint: disable=unused-variable
 
+import os
+
 from absl import logging
 from absl.testing import absltest
 import numpy as np
@@ -95,6 +97,23 @@ class VmTest(absltest.TestCase):
     notfound = m.lookup_function("notfound")
     self.assertIs(notfound, None)
 
+  def test_module_from_file(self):
+    ctx = compiler.Context()
+    input_module = ctx.parse_asm("""
+      func @add_scalar(%arg0: i32, %arg1: i32) -> i32 attributes { iree.module.export } {
+        %0 = addi %arg0, %arg1 : i32
+        return %0 : i32
+      }
+      """)
+    binary = input_module.compile()
+    path = os.path.join(self.create_tempdir().full_path, "add_scalar.vmfb")
+    with open(path, "wb") as f:
+      f.write(binary)
+    m = rt.VmModule.from_flatbuffer_file(path)
+    self.assertIsNot(m.lookup_function("add_scalar"), None)
+    with self.assertRaises(RuntimeError):
+      rt.VmModule.from_flatbuffer_file(path + ".notfound")
+
   def test_dynamic_module_context(self):
     instance = rt.VmInstance()
     context = rt.VmContext(instance)
@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "iree/base/status.h"
 
@@ -53,6 +54,15 @@ class DynamicLibrary {
   static StatusOr<std::unique_ptr<DynamicLibrary>> Load(
       absl::Span<const char* const> search_file_names);
 
+  // Loads a library from an in-memory image of the library file, such as one
+  // embedded in another file. |file_name| is used for diagnostics only.
+  //
+  // Where supported (Linux/Android via memfd_create) the library is loaded
+  // without touching the filesystem. Otherwise the image is written to a temp
+  // file that is removed as soon as the platform allows it.
+  static StatusOr<std::unique_ptr<DynamicLibrary>> LoadFromMemory(
+      absl::string_view file_name, absl::Span<const uint8_t> buffer);
+
   // Gets the name of the library file that is loaded.
   const std::string& file_name() const { return file_name_; }
 
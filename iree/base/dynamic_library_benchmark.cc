@@ -0,0 +1,71 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the startup cost of loading an embedded library, as done for each
+// executable by the dylib HAL driver.
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "iree/base/dynamic_library.h"
+#include "iree/base/dynamic_library_test_library_embed.h"
+#include "iree/base/file_io.h"
+#include "iree/base/logging.h"
+#include "iree/base/status.h"
+
+namespace iree {
+namespace {
+
+absl::Span<const uint8_t> GetEmbeddedLibrary() {
+  const auto* file_toc = dynamic_library_test_library_create();
+  return absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(file_toc->data),
+                             file_toc->size);
+}
+
+// Baseline: write the library to a temp file, load it, and delete the file.
+void BM_LoadFromTempFile(benchmark::State& state) {
+  auto buffer = GetEmbeddedLibrary();
+  absl::string_view buffer_view(reinterpret_cast<const char*>(buffer.data()),
+                                buffer.size());
+  // The name is reserved once; each iteration writes, loads and deletes the
+  // library file itself.
+  std::string placeholder_path =
+      file_io::GetTempFile("dynamic_library_benchmark").value();
+  std::string temp_path = placeholder_path + ".so";
+  for (auto _ : state) {
+    IREE_CHECK_OK(file_io::SetFileContents(temp_path, buffer_view));
+    auto library = DynamicLibrary::Load(temp_path.c_str()).value();
+    benchmark::DoNotOptimize(library->GetSymbol("times_two"));
+    library.reset();
+    IREE_CHECK_OK(file_io::DeleteFile(temp_path));
+  }
+  IREE_CHECK_OK(file_io::DeleteFile(placeholder_path));
+}
+BENCHMARK(BM_LoadFromTempFile);
+
+void BM_LoadFromMemory(benchmark::State& state) {
+  auto buffer = GetEmbeddedLibrary();
+  for (auto _ : state) {
+    auto library =
+        DynamicLibrary::LoadFromMemory("dynamic_library_benchmark", buffer)
+            .value();
+    benchmark::DoNotOptimize(library->GetSymbol("times_two"));
+  }
+}
+BENCHMARK(BM_LoadFromMemory);
+
+}  // namespace
+}  // namespace iree
@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
 #include "iree/base/dynamic_library.h"
+#include "iree/base/file_io.h"
 #include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 
@@ -21,6 +23,19 @@
     defined(IREE_PLATFORM_LINUX)
 
 #include <dlfcn.h>
+#include <errno.h>
+#include <unistd.h>
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+#include <sys/syscall.h>
+#if defined(__NR_memfd_create)
+#define IREE_DYNAMIC_LIBRARY_HAVE_MEMFD 1
+#if !defined(MFD_CLOEXEC)
+// Missing from the headers of older libc versions along with the wrapper.
+#define MFD_CLOEXEC 0x0001U
+#endif  // !MFD_CLOEXEC
+#endif  // __NR_memfd_create
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
 
 namespace iree {
 
@@ -31,6 +46,11 @@ class DynamicLibraryPosix : public DynamicLibrary {
     //   Sometimes closing the library can prevent proper symbolization on
     //   crashes or in sampling profilers.
     ::dlclose(library_);
+    // The loader matches libraries by path so the memfd (and its
+    // /proc/self/fd/N path) or temp file name must not be reused while the
+    // library is loaded; they are only released once it has been closed.
+    if (fd_ != -1) ::close(fd_);
+    if (!temp_path_.empty()) file_io::DeleteFile(temp_path_).IgnoreError();
   }
 
   static StatusOr<std::unique_ptr<DynamicLibrary>> Load(
@@ -48,15 +68,113 @@ class DynamicLibraryPosix : public DynamicLibrary {
            << "Unable to open dynamic library:'" << dlerror() << "'";
   }
 
+  static StatusOr<std::unique_ptr<DynamicLibrary>> LoadFromMemory(
+      absl::string_view file_name, absl::Span<const uint8_t> buffer) {
+    IREE_TRACE_SCOPE0("DynamicLibraryPosix::LoadFromMemory");
+
+#if defined(IREE_DYNAMIC_LIBRARY_HAVE_MEMFD)
+    // Older libc versions lack the memfd_create wrapper so we go through the
+    // syscall directly. Failure here (ENOSYS on old kernels, EPERM under some
+    // sandboxes) falls back to the temp file path below.
+    int fd = static_cast<int>(::syscall(
+        __NR_memfd_create, std::string(file_name).c_str(), MFD_CLOEXEC));
+    if (fd != -1) {
+      auto library_or = LoadFromFd(file_name, fd, buffer);
+      if (library_or.ok()) return library_or;
+      ::close(fd);
+      // The fd may not be executable (e.g. SELinux policies on Android); try
+      // again with a real file.
+    }
+#endif  // IREE_DYNAMIC_LIBRARY_HAVE_MEMFD
+
+    return LoadFromTempFile(file_name, buffer);
+  }
+
   void* GetSymbol(const char* symbol_name) const override {
     return ::dlsym(library_, symbol_name);
   }
 
  private:
-  DynamicLibraryPosix(std::string file_name, void* library)
-      : DynamicLibrary(file_name), library_(library) {}
+#if defined(IREE_DYNAMIC_LIBRARY_HAVE_MEMFD)
+  // Writes |buffer| into the anonymous file |fd| and loads it through procfs.
+  // On success the returned library takes ownership of |fd|: dlopen returns an
+  // already loaded library with the same path, so the fd number has to stay
+  // in use for as long as the library is loaded.
+  static StatusOr<std::unique_ptr<DynamicLibrary>> LoadFromFd(
+      absl::string_view file_name, int fd, absl::Span<const uint8_t> buffer) {
+    IREE_RETURN_IF_ERROR(WriteAll(fd, buffer));
+    std::string fd_path = absl::StrCat("/proc/self/fd/", fd);
+    void* library = ::dlopen(fd_path.c_str(), RTLD_LAZY | RTLD_LOCAL);
+    if (!library) {
+      return UnavailableErrorBuilder(IREE_LOC)
+             << "Unable to open in-memory dynamic library:'" << dlerror()
+             << "'";
+    }
+    return absl::WrapUnique(
+        new DynamicLibraryPosix(std::string(file_name), library, fd));
+  }
+
+  static Status WriteAll(int fd, absl::Span<const uint8_t> buffer) {
+    const uint8_t* data = buffer.data();
+    size_t remaining = buffer.size();
+    while (remaining > 0) {
+      ssize_t written = ::write(fd, data, remaining);
+      if (written == -1) {
+        if (errno == EINTR) continue;
+        return ErrnoToCanonicalStatusBuilder(errno, IREE_LOC)
+               << "Failed to write in-memory library contents";
+      }
+      data += written;
+      remaining -= written;
+    }
+    return OkStatus();
+  }
+#endif  // IREE_DYNAMIC_LIBRARY_HAVE_MEMFD
+
+  // Writes |buffer| to a temp file and loads it from there. The file is
+  // unlinked immediately after loading as the mapping keeps it alive. The
+  // unique placeholder file reserving its name is kept until the library is
+  // closed so that no other library gets loaded from the same path meanwhile.
+  static StatusOr<std::unique_ptr<DynamicLibrary>> LoadFromTempFile(
+      absl::string_view file_name, absl::Span<const uint8_t> buffer) {
+    IREE_TRACE_SCOPE0("DynamicLibraryPosix::LoadFromTempFile");
+    IREE_ASSIGN_OR_RETURN(std::string placeholder_path,
+                          file_io::GetTempFile(file_name));
+    // Add a file extension so opinionated dynamic library loaders are more
+    // likely to accept the file.
+    std::string temp_path = placeholder_path + ".so";
+    Status status = file_io::SetFileContents(
+        temp_path,
+        absl::string_view(reinterpret_cast<const char*>(buffer.data()),
+                          buffer.size()));
+    void* library = status.ok()
+                        ? ::dlopen(temp_path.c_str(), RTLD_LAZY | RTLD_LOCAL)
+                        : nullptr;
+    std::string error = library || !status.ok() ? "" : dlerror();
+    file_io::DeleteFile(temp_path).IgnoreError();
+    if (!library) {
+      file_io::DeleteFile(placeholder_path).IgnoreError();
+      IREE_RETURN_IF_ERROR(status);
+      return UnavailableErrorBuilder(IREE_LOC)
+             << "Unable to open dynamic library:'" << error << "'";
+    }
+    return absl::WrapUnique(new DynamicLibraryPosix(
+        std::string(file_name), library, /*fd=*/-1, placeholder_path));
+  }
+
+  DynamicLibraryPosix(std::string file_name, void* library, int fd = -1,
+                      std::string temp_path = "")
+      : DynamicLibrary(file_name),
+        library_(library),
+        fd_(fd),
+        temp_path_(std::move(temp_path)) {}
 
   void* library_;
+  // Anonymous file the library was loaded from, if any.
+  int fd_;
+  // Placeholder reserving the name of the temp file the library was loaded
+  // from, if any.
+  std::string temp_path_;
 };
 
 // static
@@ -65,6 +183,12 @@ StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::Load(
   return DynamicLibraryPosix::Load(search_file_names);
 }
 
+// static
+StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::LoadFromMemory(
+    absl::string_view file_name, absl::Span<const uint8_t> buffer) {
+  return DynamicLibraryPosix::LoadFromMemory(file_name, buffer);
+}
+
 }  // namespace iree
 
 #endif  // IREE_PLATFORM_*
@@ -16,6 +16,7 @@
 
 #include <string>
 
+#include "iree/base/dynamic_library_test_library_2_embed.h"
 #include "iree/base/dynamic_library_test_library_embed.h"
 #include "iree/base/file_io.h"
 #include "iree/base/status.h"
@@ -96,5 +97,83 @@ TEST_F(DynamicLibraryTest, GetSymbolFailure) {
   EXPECT_EQ(nullptr, unknown_fn);
 }
 
+TEST_F(DynamicLibraryTest, LoadLibraryFromMemory) {
+  const auto* file_toc = dynamic_library_test_library_create();
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto library,
+      DynamicLibrary::LoadFromMemory(
+          "dynamic_library_test_library",
+          absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(file_toc->data),
+                              file_toc->size)));
+  EXPECT_EQ("dynamic_library_test_library", library->file_name());
+
+  auto times_two_fn = library->GetSymbol<int (*)(int)>("times_two");
+  ASSERT_NE(nullptr, times_two_fn);
+  EXPECT_EQ(246, times_two_fn(123));
+}
+
+TEST_F(DynamicLibraryTest, LoadLibraryFromMemoryTwice) {
+  const auto* file_toc = dynamic_library_test_library_create();
+  auto buffer = absl::MakeConstSpan(
+      reinterpret_cast<const uint8_t*>(file_toc->data), file_toc->size);
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto library1,
+      DynamicLibrary::LoadFromMemory("dynamic_library_test_library", buffer));
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto library2,
+      DynamicLibrary::LoadFromMemory("dynamic_library_test_library", buffer));
+  EXPECT_NE(nullptr, library1->GetSymbol("times_two"));
+  EXPECT_NE(nullptr, library2->GetSymbol("times_two"));
+}
+
+TEST_F(DynamicLibraryTest, LoadDifferentLibrariesFromMemory) {
+  const auto* file_toc = dynamic_library_test_library_create();
+  auto buffer = absl::MakeConstSpan(
+      reinterpret_cast<const uint8_t*>(file_toc->data), file_toc->size);
+  const auto* file_toc_2 = dynamic_library_test_library_2_create();
+  auto buffer_2 = absl::MakeConstSpan(
+      reinterpret_cast<const uint8_t*>(file_toc_2->data), file_toc_2->size);
+
+  // Load the images one after the other so that resources used by the first
+  // load (such as fd numbers) are released before the second one.
+  {
+    IREE_ASSERT_OK_AND_ASSIGN(
+        auto library,
+        DynamicLibrary::LoadFromMemory("dynamic_library_test_library", buffer));
+    auto times_two_fn = library->GetSymbol<int (*)(int)>("times_two");
+    ASSERT_NE(nullptr, times_two_fn);
+    EXPECT_EQ(246, times_two_fn(123));
+    EXPECT_EQ(nullptr, library->GetSymbol("times_three"));
+  }
+  {
+    IREE_ASSERT_OK_AND_ASSIGN(auto library,
+                              DynamicLibrary::LoadFromMemory(
+                                  "dynamic_library_test_library", buffer_2));
+    auto times_three_fn = library->GetSymbol<int (*)(int)>("times_three");
+    ASSERT_NE(nullptr, times_three_fn);
+    EXPECT_EQ(369, times_three_fn(123));
+    EXPECT_EQ(nullptr, library->GetSymbol("times_two"));
+  }
+
+  // Both loaded at the same time.
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto library1,
+      DynamicLibrary::LoadFromMemory("dynamic_library_test_library", buffer));
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto library2,
+      DynamicLibrary::LoadFromMemory("dynamic_library_test_library", buffer_2));
+  EXPECT_NE(nullptr, library1->GetSymbol("times_two"));
+  EXPECT_EQ(nullptr, library1->GetSymbol("times_three"));
+  EXPECT_EQ(nullptr, library2->GetSymbol("times_two"));
+  EXPECT_NE(nullptr, library2->GetSymbol("times_three"));
+}
+
+TEST_F(DynamicLibraryTest, LoadLibraryFromMemoryFailure) {
+  const uint8_t kNotALibrary[] = {0x00, 0x01, 0x02, 0x03};
+  auto library_or = DynamicLibrary::LoadFromMemory(
+      "not_a_library", absl::MakeConstSpan(kNotALibrary));
+  EXPECT_TRUE(IsUnavailable(library_or.status()));
+}
+
 }  // namespace
 }  // namespace iree
@@ -14,6 +14,7 @@
 
 #include "absl/memory/memory.h"
 #include "iree/base/dynamic_library.h"
+#include "iree/base/file_io.h"
 #include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 
@@ -28,6 +29,9 @@ class DynamicLibraryWin : public DynamicLibrary {
     //   Sometimes closing the library can prevent proper symbolization on
     //   crashes or in sampling profilers.
     ::FreeLibrary(library_);
+    if (!temp_file_path_.empty()) {
+      file_io::DeleteFile(temp_file_path_).IgnoreError();
+    }
   }
 
   static StatusOr<std::unique_ptr<DynamicLibrary>> Load(
@@ -46,6 +50,30 @@ class DynamicLibraryWin : public DynamicLibrary {
            << "Unable to open dynamic library, not found on search paths";
   }
 
+  static StatusOr<std::unique_ptr<DynamicLibrary>> LoadFromMemory(
+      absl::string_view file_name, absl::Span<const uint8_t> buffer) {
+    IREE_TRACE_SCOPE0("DynamicLibraryWin::LoadFromMemory");
+
+    // LoadLibrary only works with files and the file cannot be deleted while
+    // the library is loaded, so we hold on to it until destruction.
+    IREE_ASSIGN_OR_RETURN(std::string temp_path,
+                          file_io::GetTempFile(file_name));
+    temp_path += ".dll";
+    IREE_RETURN_IF_ERROR(file_io::SetFileContents(
+        temp_path, absl::string_view(reinterpret_cast<const char*>(buffer.data()),
+                                     buffer.size())));
+    HMODULE library = ::LoadLibraryA(temp_path.c_str());
+    if (!library) {
+      file_io::DeleteFile(temp_path).IgnoreError();
+      return UnavailableErrorBuilder(IREE_LOC)
+             << "Unable to open in-memory dynamic library";
+    }
+    auto dynamic_library = absl::WrapUnique(
+        new DynamicLibraryWin(std::string(file_name), library));
+    dynamic_library->temp_file_path_ = std::move(temp_path);
+    return std::move(dynamic_library);
+  }
+
   void* GetSymbol(const char* symbol_name) const override {
     return reinterpret_cast<void*>(::GetProcAddress(library_, symbol_name));
   }
@@ -55,6 +83,7 @@ class DynamicLibraryWin : public DynamicLibrary {
       : DynamicLibrary(file_name), library_(library) {}
 
   HMODULE library_;
+  std::string temp_file_path_;
 };
 
 // static
@@ -63,6 +92,12 @@ StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::Load(
   return DynamicLibraryWin::Load(search_file_names);
 }
 
+// static
+StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::LoadFromMemory(
+    absl::string_view file_name, absl::Span<const uint8_t> buffer) {
+  return DynamicLibraryWin::LoadFromMemory(file_name, buffer);
+}
+
 }  // namespace iree
 
 #endif  // IREE_PLATFORM_*
@@ -136,7 +136,10 @@ StatusOr<std::string> GetTempFile(absl::string_view base_name) {
   std::string template_path =
       file_path::JoinPaths(temp_path, base_name) + "XXXXXX";
 
-  if (::mkstemp(&template_path[0]) != -1) {
+  int fd = ::mkstemp(&template_path[0]);
+  if (fd != -1) {
+    // Only the name is returned; the file stays behind as a placeholder.
+    ::close(fd);
     return template_path;  // Should have been modified by mkstemp.
   } else {
     return ErrnoToCanonicalStatusBuilder(errno, IREE_LOC)
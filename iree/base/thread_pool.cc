@@ -0,0 +1,155 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/base/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "iree/base/tracing.h"
+
+namespace iree {
+
+namespace {
+
+// Number of chunks each participant gets on average in a ParallelFor. More
+// than one allows participants that finish early (or start late) to balance
+// the load.
+constexpr size_t kChunksPerParticipant = 4;
+
+}  // namespace
+
+// static
+ref_ptr<ThreadPool> ThreadPool::Create(int worker_count) {
+  return assign_ref(new ThreadPool(worker_count));
+}
+
+ThreadPool::ThreadPool(int worker_count) {
+  IREE_TRACE_SCOPE0("ThreadPool::ctor");
+  if (worker_count < 0) {
+    worker_count =
+        std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0);
+  }
+  workers_.reserve(worker_count);
+  for (int i = 0; i < worker_count; ++i) {
+    workers_.emplace_back([this, i]() { ThreadMain(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  IREE_TRACE_SCOPE0("ThreadPool::dtor");
+  {
+    absl::MutexLock lock(&mutex_);
+    shutdown_ = true;
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::ThreadMain(int worker_index) {
+  IREE_TRACE_SET_THREAD_NAME("pool-worker");
+
+  uint64_t last_generation = 0;
+  while (true) {
+    const absl::FunctionRef<void(int)>* job = nullptr;
+    {
+      // Block until a new job is published or we are asked to exit.
+      struct WakeState {
+        ThreadPool* pool;
+        uint64_t last_generation;
+      } wake_state = {this, last_generation};
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(
+          +[](WakeState* state) {
+            state->pool->mutex_.AssertHeld();
+            return state->pool->shutdown_ ||
+                   state->pool->job_generation_ != state->last_generation;
+          },
+          &wake_state));
+      if (shutdown_) return;
+      last_generation = job_generation_;
+      // The job may have already been retired if we woke up late.
+      job = job_;
+      if (job) ++job_participants_;
+    }
+    if (!job) continue;
+
+    (*job)(worker_index);
+
+    absl::MutexLock lock(&mutex_);
+    --job_participants_;
+  }
+}
+
+void ThreadPool::Run(absl::FunctionRef<void(int participant_index)> fn) {
+  int caller_index = worker_count();
+
+  // Run only on the caller if there are no workers or another job (possibly
+  // the one that called us) already owns them.
+  if (workers_.empty() || !dispatch_mutex_.TryLock()) {
+    fn(caller_index);
+    return;
+  }
+  IREE_TRACE_SCOPE0("ThreadPool::Run");
+
+  // Publish the job to the workers; the caller participates as well.
+  {
+    absl::MutexLock lock(&mutex_);
+    job_ = &fn;
+    ++job_generation_;
+  }
+
+  fn(caller_index);
+
+  // Retire the job and wait for all workers that joined it to leave. Once
+  // they have there is nothing still executing.
+  {
+    absl::MutexLock lock(&mutex_);
+    job_ = nullptr;
+    mutex_.Await(absl::Condition(
+        +[](int* participants) { return *participants == 0; },
+        &job_participants_));
+  }
+  dispatch_mutex_.Unlock();
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain,
+                             absl::FunctionRef<void(size_t, size_t)> fn) {
+  if (count == 0) return;
+  size_t participant_count = concurrency();
+  size_t chunk_size =
+      std::max(std::max(grain, size_t{1}),
+               (count + participant_count * kChunksPerParticipant - 1) /
+                   (participant_count * kChunksPerParticipant));
+  if (workers_.empty() || chunk_size >= count) {
+    fn(0, count);
+    return;
+  }
+
+  // Participants claim chunks until none remain.
+  size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+  std::atomic<size_t> next_chunk{0};
+  Run([&](int participant_index) {
+    while (true) {
+      size_t chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+      if (chunk >= chunk_count) return;
+      size_t begin = chunk * chunk_size;
+      size_t end = std::min(begin + chunk_size, count);
+      fn(begin, end);
+    }
+  });
+}
+
+}  // namespace iree
@@ -0,0 +1,91 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_BASE_THREAD_POOL_H_
+#define IREE_BASE_THREAD_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/ref_ptr.h"
+
+namespace iree {
+
+// A pool of worker threads that run jobs alongside the calling thread.
+// Used both to spread the tiles of host dispatches across threads and to split
+// large VMLA kernels into chunks.
+//
+// Only one job runs on the pool at a time. Jobs started while the pool is
+// busy, either from another thread or nested within a job, run only on the
+// calling thread so that callers never deadlock waiting on themselves. Jobs
+// must therefore be able to complete with any number of participants, such as
+// by having each claim work from shared state until none remains.
+//
+// Thread-safe.
+class ThreadPool final : public RefObject<ThreadPool> {
+ public:
+  // Creates a pool with |worker_count| threads in addition to the calling
+  // thread. When |worker_count| is negative one worker is created for each
+  // hardware thread beyond the first.
+  static ref_ptr<ThreadPool> Create(int worker_count);
+
+  ~ThreadPool();
+
+  // Total number of worker threads owned by the pool.
+  int worker_count() const { return static_cast<int>(workers_.size()); }
+
+  // Maximum number of threads that participate in a job, including the
+  // calling thread.
+  int concurrency() const { return worker_count() + 1; }
+
+  // Calls |fn| on the calling thread and on each worker that joins the job,
+  // passing each participant a distinct index in [0, concurrency()). The
+  // calling thread always takes the last index while workers take their own.
+  // Blocks until all participants have returned. Workers that are slow to
+  // wake may not join at all.
+  void Run(absl::FunctionRef<void(int participant_index)> fn);
+
+  // Calls |fn| with disjoint [begin, end) ranges covering [0, |count|) and
+  // blocks until all have completed. Ranges hold at least |grain| items
+  // (except possibly the last) so that each chunk amortizes the cost of
+  // waking a worker.
+  void ParallelFor(size_t count, size_t grain,
+                   absl::FunctionRef<void(size_t, size_t)> fn);
+
+ private:
+  explicit ThreadPool(int worker_count);
+
+  // Thread entry point for worker |worker_index|.
+  void ThreadMain(int worker_index);
+
+  std::vector<std::thread> workers_;
+
+  // Held by the thread running a job on the workers.
+  absl::Mutex dispatch_mutex_;
+
+  absl::Mutex mutex_;
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  uint64_t job_generation_ ABSL_GUARDED_BY(mutex_) = 0;
+  const absl::FunctionRef<void(int)>* job_ ABSL_GUARDED_BY(mutex_) = nullptr;
+  int job_participants_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace iree
+
+#endif  // IREE_BASE_THREAD_POOL_H_
@@ -0,0 +1,143 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/base/thread_pool.h"
+
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace {
+
+// Runs a ParallelFor over |count| items and checks each is visited once.
+void ExpectCoversRange(ThreadPool* pool, size_t count, size_t grain) {
+  std::vector<std::atomic<int>> visits(count);
+  for (auto& visit : visits) visit.store(0);
+  pool->ParallelFor(count, grain, [&](size_t begin, size_t end) {
+    EXPECT_LT(begin, end);
+    EXPECT_LE(end, count);
+    if (end != count) EXPECT_GE(end - begin, grain);
+    for (size_t i = begin; i < end; ++i) ++visits[i];
+  });
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(visits[i].load(), 1) << "item " << i;
+  }
+}
+
+TEST(ThreadPoolTest, RunGivesDistinctParticipantIndices) {
+  auto pool = ThreadPool::Create(3);
+  for (int i = 0; i < 50; ++i) {
+    std::vector<std::atomic<int>> visits(pool->concurrency());
+    for (auto& visit : visits) visit.store(0);
+    std::thread::id caller_id = std::this_thread::get_id();
+    pool->Run([&](int participant_index) {
+      ASSERT_GE(participant_index, 0);
+      ASSERT_LT(participant_index, pool->concurrency());
+      // The caller always takes the last index.
+      EXPECT_EQ(participant_index == pool->concurrency() - 1,
+                std::this_thread::get_id() == caller_id);
+      ++visits[participant_index];
+    });
+    EXPECT_EQ(visits.back().load(), 1);
+    for (auto& visit : visits) EXPECT_LE(visit.load(), 1);
+  }
+}
+
+TEST(ThreadPoolTest, NestedRunOnlyOnCaller) {
+  auto pool = ThreadPool::Create(2);
+  std::atomic<int> inner_calls{0};
+  pool->Run([&](int participant_index) {
+    pool->Run([&](int inner_participant_index) {
+      EXPECT_EQ(inner_participant_index, pool->concurrency() - 1);
+      ++inner_calls;
+    });
+  });
+  // Each outer participant ran the inner job by itself.
+  EXPECT_GE(inner_calls.load(), 1);
+  EXPECT_LE(inner_calls.load(), pool->concurrency());
+}
+
+TEST(ThreadPoolTest, CoversRange) {
+  auto pool = ThreadPool::Create(3);
+  EXPECT_EQ(pool->concurrency(), 4);
+  ExpectCoversRange(pool.get(), 0, 1);
+  ExpectCoversRange(pool.get(), 1, 1);
+  ExpectCoversRange(pool.get(), 7, 1);
+  ExpectCoversRange(pool.get(), 1000, 1);
+  ExpectCoversRange(pool.get(), 1000, 64);
+  ExpectCoversRange(pool.get(), 1000, 5000);
+}
+
+TEST(ThreadPoolTest, NoWorkers) {
+  auto pool = ThreadPool::Create(0);
+  EXPECT_EQ(pool->concurrency(), 1);
+  int call_count = 0;
+  pool->ParallelFor(100, 1, [&](size_t begin, size_t end) {
+    EXPECT_EQ(begin, 0);
+    EXPECT_EQ(end, 100);
+    ++call_count;
+  });
+  EXPECT_EQ(call_count, 1);
+}
+
+TEST(ThreadPoolTest, UsesWorkers) {
+  auto pool = ThreadPool::Create(2);
+  std::atomic<int> running{0};
+  std::atomic<bool> overlapped{false};
+  pool->ParallelFor(3, 1, [&](size_t begin, size_t end) {
+    // Wait a bit for another participant to show up.
+    ++running;
+    for (int i = 0; i < 1000 && !overlapped; ++i) {
+      if (running.load() > 1) overlapped = true;
+      std::this_thread::yield();
+    }
+  });
+  EXPECT_TRUE(overlapped.load());
+}
+
+TEST(ThreadPoolTest, NestedRunsInline) {
+  auto pool = ThreadPool::Create(2);
+  std::atomic<int> total{0};
+  pool->ParallelFor(8, 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      pool->ParallelFor(16, 1, [&](size_t inner_begin, size_t inner_end) {
+        total += static_cast<int>(inner_end - inner_begin);
+      });
+    }
+  });
+  EXPECT_EQ(total.load(), 8 * 16);
+}
+
+TEST(ThreadPoolTest, ConcurrentCallers) {
+  auto pool = ThreadPool::Create(2);
+  std::atomic<int> total{0};
+  std::vector<std::thread> callers;
+  for (int i = 0; i < 4; ++i) {
+    callers.emplace_back([&]() {
+      for (int j = 0; j < 50; ++j) {
+        pool->ParallelFor(64, 4, [&](size_t begin, size_t end) {
+          total += static_cast<int>(end - begin);
+        });
+      }
+    });
+  }
+  for (auto& caller : callers) caller.join();
+  EXPECT_EQ(total.load(), 4 * 50 * 64);
+}
+
+}  // namespace
+}  // namespace iree
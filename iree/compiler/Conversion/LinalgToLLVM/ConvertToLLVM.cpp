@@ -137,10 +137,13 @@ bool operator<(IREE::HAL::InterfaceBindingOp aOp,
 }
 
 // Change signature of entry function to func
-// entry_func(%packed_buffers_arg_ptr:
-// !<llvm.int8**>, %push_constant: !<llvm.int64*>) and lower IREE and HAL ops to
-// corresponding LLVMIR ops to construct memref descriptors and load
-// push_constant values.
+// entry_func(%packed_buffers_arg_ptr: !<llvm.int8**>,
+//            %push_constant: !<llvm.int32*>,
+//            %workgroup_id: !<llvm.int32*>,
+//            %workgroup_count: !<llvm.int32*>)
+// and lower IREE and HAL ops to corresponding LLVMIR ops to construct memref
+// descriptors and load push_constant values and the XYZ workgroup id/count of
+// the tile being dispatched.
 class ConvertFuncWithHALInterface : public ConvertToLLVMPattern {
  public:
   explicit ConvertFuncWithHALInterface(MLIRContext *context,
@@ -163,6 +166,8 @@ class ConvertFuncWithHALInterface : public ConvertToLLVMPattern {
     // Get interface buffers from all the blocks.
     SmallVector<IREE::PlaceholderOp, 8> bufferOps;
     SmallVector<IREE::HAL::InterfaceLoadConstantOp, 8> loadOps;
+    SmallVector<IREE::HAL::InterfaceWorkgroupIDOp, 3> workgroupIdOps;
+    SmallVector<IREE::HAL::InterfaceWorkgroupCountOp, 3> workgroupCountOps;
     for (Block &block : funcOp.getBlocks()) {
       for (Operation &op : block) {
         if (auto phOp = dyn_cast<IREE::PlaceholderOp>(op))
@@ -170,6 +175,12 @@ class ConvertFuncWithHALInterface : public ConvertToLLVMPattern {
         if (auto phOp = dyn_cast<IREE::HAL::InterfaceLoadConstantOp>(op)) {
           loadOps.push_back(phOp);
         }
+        if (auto idOp = dyn_cast<IREE::HAL::InterfaceWorkgroupIDOp>(op)) {
+          workgroupIdOps.push_back(idOp);
+        }
+        if (auto countOp = dyn_cast<IREE::HAL::InterfaceWorkgroupCountOp>(op)) {
+          workgroupCountOps.push_back(countOp);
+        }
       }
     }
 
@@ -218,21 +229,33 @@ class ConvertFuncWithHALInterface : public ConvertToLLVMPattern {
 
     TypeConverter::SignatureConversion signatureConverter(/*numOrigInputs=*/0);
 
-    // func foo(%packed_buffer_args: !llvm<i8**>, %push_constant: !llvm<i32*>)
+    // func foo(%packed_buffer_args: !llvm<i8**>, %push_constant: !llvm<i32*>,
+    //          %workgroup_id: !llvm<i32*>, %workgroup_count: !llvm<i32*>)
     MLIRContext *context = rewriter.getContext();
     auto packedBuffersArgsTy =
         LLVM::LLVMType::getInt8PtrTy(context).getPointerTo();
     auto pushConstantArgTy = LLVM::LLVMType::getInt32Ty(context).getPointerTo();
+    auto workgroupArgTy = LLVM::LLVMType::getInt32Ty(context).getPointerTo();
     signatureConverter.addInputs(packedBuffersArgsTy);
     signatureConverter.addInputs(pushConstantArgTy);
+    signatureConverter.addInputs(workgroupArgTy);
+    signatureConverter.addInputs(workgroupArgTy);
 
-    // Create the new function's signature.
+    // Create the new function's signature. The workgroup count computed
+    // during tiling is kept so that the target can use it when recording the
+    // dispatch.
     Location loc = funcOp.getLoc();
+    SmallVector<NamedAttribute, 1> funcAttrs;
+    if (Attribute workgroupCountAttr =
+            funcOp.getAttr(getLLVMWorkgroupCountAttrName())) {
+      funcAttrs.push_back(rewriter.getNamedAttr(
+          getLLVMWorkgroupCountAttrName(), workgroupCountAttr));
+    }
     auto newFuncOp = rewriter.create<FuncOp>(
         loc, funcOp.getName(),
         rewriter.getFunctionType(signatureConverter.getConvertedTypes(),
                                  llvm::None),
-        ArrayRef<NamedAttribute>());
+        funcAttrs);
 
     // Move all ops in the old function's region to the new function.
     rewriter.inlineRegionBefore(funcOp.getBody(), newFuncOp.getBody(),
@@ -284,6 +307,28 @@ class ConvertFuncWithHALInterface : public ConvertToLLVMPattern {
       rewriter.replaceOp(loadOp, dimConstantCasted);
     }
 
+    // Lower hal.interface.workgroup.id/count ops into loads from the
+    // corresponding XYZ argument arrays.
+    auto loadWorkgroupValue = [&](Operation *op, const APInt &dimension,
+                                  Value arrayArg) {
+      Value index = builder.create<LLVM::ConstantOp>(
+          loc, LLVM::LLVMType::getInt64Ty(context),
+          builder.getI64IntegerAttr(dimension.getZExtValue()));
+      Value valuePtr = builder.create<LLVM::GEPOp>(
+          loc, workgroupArgTy, arrayArg, ArrayRef<Value>({index}));
+      Value value = builder.create<LLVM::LoadOp>(loc, valuePtr);
+      Value valueCasted = builder.create<LLVM::ZExtOp>(
+          loc, typeConverter.convertType(op->getResult(0).getType()), value);
+      rewriter.replaceOp(op, valueCasted);
+    };
+    for (auto idOp : workgroupIdOps) {
+      loadWorkgroupValue(idOp, idOp.dimension(), newFuncOp.getArgument(2));
+    }
+    for (auto countOp : workgroupCountOps) {
+      loadWorkgroupValue(countOp, countOp.dimension(),
+                         newFuncOp.getArgument(3));
+    }
+
     rewriter.eraseOp(funcOp);
     return success();
   }
@@ -0,0 +1,426 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//===- LinalgTileAndDistributePass.cpp - Distribute Linalg to workgroups --===//
+//
+// Tiles Linalg operations and distributes the tiles across the workgroups of
+// the dispatch grid. Each workgroup is then only responsible for its own slice
+// of the iteration space.
+//
+//===----------------------------------------------------------------------===//
+
+#include "iree/compiler/Conversion/LinalgToLLVM/Passes.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "mlir/Dialect/Linalg/IR/LinalgOps.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/Linalg/Utils/Utils.h"
+#include "mlir/Dialect/SCF/SCF.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
+#include "mlir/IR/Function.h"
+#include "mlir/IR/Identifier.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+/// Maximum number of dispatch grid dimensions (XYZ).
+static constexpr unsigned kNumWorkgroupDims = 3;
+
+/// Marker set on Linalg ops once they have been tiled at the workgroup level.
+static StringRef getWorkgroupTiledMarker() { return "workgroup_tiled"; }
+
+/// Returns true if the linalg op has padding attribute, and that it has
+/// non-zero entries.
+template <typename OpTy>
+static bool hasPadding(OpTy op) {
+  Optional<DenseIntElementsAttr> padding = op.padding();
+  if (!padding) return false;
+  return llvm::any_of(padding.getValue(),
+                      [](APInt v) -> bool { return !v.isNullValue(); });
+}
+
+/// Returns true if `op` is a convolution or pooling op with padding. Linalg
+/// only supports tiling these along the batch dimension (the first loop).
+static bool isPaddedConvOrPool(Operation *op) {
+  if (auto convOp = dyn_cast<linalg::ConvOp>(op)) return hasPadding(convOp);
+  if (auto poolOp = dyn_cast<linalg::PoolingMaxOp>(op))
+    return hasPadding(poolOp);
+  if (auto poolOp = dyn_cast<linalg::PoolingMinOp>(op))
+    return hasPadding(poolOp);
+  if (auto poolOp = dyn_cast<linalg::PoolingSumOp>(op))
+    return hasPadding(poolOp);
+  return false;
+}
+
+/// Returns the buffer that `view` is a view of, looking through subviews and
+/// reshapes.
+static Value getBaseBuffer(Value view) {
+  while (Operation *defOp = view.getDefiningOp()) {
+    if (auto subViewOp = dyn_cast<SubViewOp>(defOp)) {
+      view = subViewOp.source();
+    } else if (auto reshapeOp = dyn_cast<linalg::ReshapeOp>(defOp)) {
+      view = reshapeOp.src();
+    } else {
+      break;
+    }
+  }
+  return view;
+}
+
+/// Returns true if any of `views` is a view of the same buffer as `view`.
+static bool isAliasedBy(Value view, ValueRange views) {
+  Value baseBuffer = getBaseBuffer(view);
+  return llvm::any_of(
+      views, [&](Value other) { return getBaseBuffer(other) == baseBuffer; });
+}
+
+/// Returns the workgroup ID and count to use for each of the
+/// `parallelLoopRanges`. The innermost distributed loop maps to X, the next to
+/// Y and the outermost to Z. At most `kNumWorkgroupDims` loops are ever tiled
+/// (see `getDefaultTileSizes`) so each loop gets its own grid dimension.
+static SmallVector<linalg::ProcInfo, 2> getWorkgroupIdsAndCounts(
+    OpBuilder &builder, Location loc,
+    ArrayRef<SubViewOp::Range> parallelLoopRanges) {
+  unsigned numDims = parallelLoopRanges.size();
+  assert(numDims <= kNumWorkgroupDims &&
+         "more distributed loops than workgroup dimensions");
+  SmallVector<linalg::ProcInfo, 2> procInfo(numDims);
+  for (unsigned dim = 0; dim < numDims; ++dim) {
+    procInfo[numDims - 1 - dim] = {
+        builder.create<IREE::HAL::InterfaceWorkgroupIDOp>(
+            loc, builder.getIndexType(), builder.getIndexAttr(dim)),
+        builder.create<IREE::HAL::InterfaceWorkgroupCountOp>(
+            loc, builder.getIndexType(), builder.getIndexAttr(dim))};
+  }
+  return procInfo;
+}
+
+/// Cyclic distribution is used so that any workgroup count chosen at dispatch
+/// time produces correct results; workgroups without a tile to process simply
+/// skip the loop.
+static linalg::LinalgLoopDistributionOptions workgroupDistributionOptions = {
+    getWorkgroupIdsAndCounts,
+    {linalg::DistributionMethod::Cyclic, linalg::DistributionMethod::Cyclic,
+     linalg::DistributionMethod::Cyclic}};
+
+/// Tile sizes, one per loop, of the ops to tile and distribute. A tile size of
+/// 0 leaves the loop untiled.
+using TileSizesMap = DenseMap<Operation *, SmallVector<int64_t, 4>>;
+
+/// Returns the tile sizes of an op that does not need to match the tiling of
+/// another op: the outermost parallel loops are tiled, one per entry of
+/// `workgroupTileSizes`. Padded convolution and pooling ops are only tiled
+/// along the batch dimension.
+static SmallVector<int64_t, 4> getDefaultTileSizes(
+    linalg::LinalgOp linalgOp, ArrayRef<int64_t> workgroupTileSizes) {
+  SmallVector<int64_t, 4> sizes(linalgOp.getNumLoops(), 0);
+  if (isPaddedConvOrPool(linalgOp.getOperation())) {
+    sizes.front() = workgroupTileSizes.front();
+    return sizes;
+  }
+  unsigned numTiledLoops = 0;
+  for (auto iteratorType : llvm::enumerate(linalgOp.iterator_types())) {
+    if (numTiledLoops == workgroupTileSizes.size()) break;
+    if (linalg::isParallelIteratorType(iteratorType.value())) {
+      sizes[iteratorType.index()] = workgroupTileSizes[numTiledLoops++];
+    }
+  }
+  return sizes;
+}
+
+/// Returns the tile sizes for `linalgOp`, a linalg.fill or linalg.copy
+/// initializing the `outputIndex`-th output of `consumer`, such that each
+/// workgroup initializes exactly the tiles of the buffer the consumer then
+/// updates within that same workgroup. The loops of both ops must be tiled by
+/// the same amount and distributed along the same workgroup dimensions for
+/// this to hold. Returns llvm::None if the consumer output indexing does not
+/// allow it.
+static Optional<SmallVector<int64_t, 4>> getTileSizesFromConsumer(
+    linalg::LinalgOp linalgOp, linalg::LinalgOp consumer, unsigned outputIndex,
+    ArrayRef<int64_t> consumerTileSizes) {
+  if (linalgOp.getNumOutputs() != 1 ||
+      !linalgOp.getOutputIndexingMap(0).isIdentity()) {
+    return llvm::None;
+  }
+  AffineMap consumerMap = consumer.getOutputIndexingMap(outputIndex);
+  if (consumerMap.getNumResults() != linalgOp.getNumLoops()) return llvm::None;
+
+  SmallVector<int64_t, 4> sizes(linalgOp.getNumLoops(), 0);
+  unsigned numTiledLoops = 0;
+  Optional<unsigned> lastTiledLoop;
+  for (auto result : llvm::enumerate(consumerMap.getResults())) {
+    auto dimExpr = result.value().dyn_cast<AffineDimExpr>();
+    if (!dimExpr) return llvm::None;
+    unsigned loop = dimExpr.getPosition();
+    if (consumerTileSizes[loop] == 0) continue;
+    // Distributed loops are assigned workgroup dimensions in order, so the
+    // tiled loops must appear in the same order in both ops.
+    if (lastTiledLoop && loop <= *lastTiledLoop) return llvm::None;
+    lastTiledLoop = loop;
+    sizes[result.index()] = consumerTileSizes[loop];
+    ++numTiledLoops;
+  }
+  // Every tiled loop of the consumer has to index its output, otherwise
+  // several workgroups update the same tile.
+  if (numTiledLoops != llvm::count_if(consumerTileSizes,
+                                      [](int64_t size) { return size != 0; })) {
+    return llvm::None;
+  }
+  return sizes;
+}
+
+/// Computes the tile sizes of all the Linalg ops in `funcOp`. Fails if any op
+/// cannot be distributed without racing with another workgroup: ops that
+/// cannot be tiled at all, ops accessing buffers written by previous ops (the
+/// producing tile may live in another workgroup) unless they are updating the
+/// output initialized by a linalg.fill or linalg.copy they can be tiled exactly
+/// like, and ops overwriting buffers read by previous ops.
+static LogicalResult computeTileSizes(FuncOp funcOp,
+                                      ArrayRef<int64_t> workgroupTileSizes,
+                                      TileSizesMap &tileSizesMap) {
+  SmallVector<linalg::LinalgOp, 4> linalgOps;
+  funcOp.walk(
+      [&](linalg::LinalgOp linalgOp) { linalgOps.push_back(linalgOp); });
+
+  // Visit the ops in reverse so that the tile sizes of consumers are known by
+  // the time the ops initializing their outputs are visited.
+  for (int i = linalgOps.size() - 1; i >= 0; --i) {
+    linalg::LinalgOp linalgOp = linalgOps[i];
+    Operation *op = linalgOp.getOperation();
+    if (!isa<linalg::MatmulOp, linalg::BatchMatmulOp, linalg::GenericOp,
+             linalg::IndexedGenericOp, linalg::ConvOp, linalg::PoolingMaxOp,
+             linalg::PoolingMinOp, linalg::PoolingSumOp, linalg::FillOp,
+             linalg::CopyOp>(op)) {
+      return failure();
+    }
+
+    SmallVector<int64_t, 4> sizes;
+    for (linalg::LinalgOp laterOp :
+         llvm::makeArrayRef(linalgOps).drop_front(i + 1)) {
+      for (Value output : linalgOp.getOutputBuffers()) {
+        if (isAliasedBy(output, laterOp.getInputs())) return failure();
+      }
+      for (Value input : linalgOp.getInputs()) {
+        if (isAliasedBy(input, laterOp.getOutputBuffers())) return failure();
+      }
+      // Only the first op updating the outputs needs to be looked at, the
+      // following ones are checked when visiting that op.
+      if (!sizes.empty()) continue;
+      auto laterOutputs = llvm::to_vector<2>(laterOp.getOutputBuffers());
+      auto it = llvm::find_if(laterOutputs, [&](Value laterOutput) {
+        return isAliasedBy(laterOutput, linalgOp.getOutputBuffers());
+      });
+      if (it == laterOutputs.end()) continue;
+
+      Optional<SmallVector<int64_t, 4>> consumerSizes;
+      if (isa<linalg::FillOp, linalg::CopyOp>(op) &&
+          linalgOp.getOutputBuffer(0) == *it) {
+        consumerSizes = getTileSizesFromConsumer(
+            linalgOp, laterOp, std::distance(laterOutputs.begin(), it),
+            tileSizesMap[laterOp.getOperation()]);
+      }
+      if (!consumerSizes) return failure();
+      sizes = std::move(*consumerSizes);
+    }
+    if (sizes.empty()) {
+      sizes = getDefaultTileSizes(linalgOp, workgroupTileSizes);
+    }
+
+    // Ops that are not tiled at all would be run by every workgroup.
+    if (llvm::all_of(sizes, [](int64_t size) { return size == 0; })) {
+      return failure();
+    }
+    tileSizesMap[op] = std::move(sizes);
+  }
+  return success();
+}
+
+/// Returns the trip count of the `loop`-th loop of `linalgOp` if it is known
+/// statically from the shape of an operand it indexes.
+static Optional<int64_t> getStaticLoopRange(linalg::LinalgOp linalgOp,
+                                            unsigned loop) {
+  for (unsigned i = 0, e = linalgOp.getNumInputsAndOutputs(); i < e; ++i) {
+    AffineMap map = linalgOp.getIndexingMap(i);
+    ShapedType type = linalgOp.getShapedType(i);
+    for (auto result : llvm::enumerate(map.getResults())) {
+      auto dimExpr = result.value().dyn_cast<AffineDimExpr>();
+      if (!dimExpr || dimExpr.getPosition() != loop) continue;
+      if (!type.isDynamicDim(result.index())) {
+        return type.getDimSize(result.index());
+      }
+    }
+  }
+  return llvm::None;
+}
+
+/// Returns the number of workgroups along X, Y and Z needed to cover all the
+/// tiles of the distributed loops, or llvm::None if any of these loops has a
+/// dynamic trip count.
+static Optional<SmallVector<int64_t, kNumWorkgroupDims>> getWorkgroupCount(
+    FuncOp funcOp, const TileSizesMap &tileSizesMap) {
+  SmallVector<int64_t, kNumWorkgroupDims> workgroupCount(kNumWorkgroupDims, 1);
+  WalkResult walkResult = funcOp.walk([&](linalg::LinalgOp linalgOp) {
+    SmallVector<int64_t, 4> sizes =
+        tileSizesMap.lookup(linalgOp.getOperation());
+    SmallVector<unsigned, kNumWorkgroupDims> tiledLoops;
+    for (auto size : llvm::enumerate(sizes)) {
+      if (size.value() != 0) tiledLoops.push_back(size.index());
+    }
+    // Same assignment of loops to workgroup dimensions as in
+    // `getWorkgroupIdsAndCounts`.
+    for (auto loop : llvm::enumerate(tiledLoops)) {
+      Optional<int64_t> range = getStaticLoopRange(linalgOp, loop.value());
+      if (!range) return WalkResult::interrupt();
+      int64_t tileSize = sizes[loop.value()];
+      int64_t &count = workgroupCount[tiledLoops.size() - 1 - loop.index()];
+      count = std::max(count, (*range + tileSize - 1) / tileSize);
+    }
+    return WalkResult::advance();
+  });
+  if (walkResult.wasInterrupted()) return llvm::None;
+  return workgroupCount;
+}
+
+namespace {
+
+/// Pattern tiling a Linalg op with the tile sizes computed for it ahead of
+/// time and distributing the resulting tiles across workgroups.
+template <typename OpTy>
+struct TileAndDistributePattern : public linalg::LinalgTilingPattern<OpTy> {
+  using Base = linalg::LinalgTilingPattern<OpTy>;
+  TileAndDistributePattern(MLIRContext *context,
+                           linalg::LinalgTilingOptions options,
+                           const TileSizesMap &tileSizesMap,
+                           PatternBenefit benefit = 1)
+      : Base(context,
+             options.setDistributionOptions(workgroupDistributionOptions),
+             linalg::LinalgMarker(
+                 ArrayRef<Identifier>(),
+                 Identifier::get(getWorkgroupTiledMarker(), context)),
+             benefit),
+        tileSizesMap(tileSizesMap) {}
+
+  LogicalResult matchAndRewrite(Operation *op,
+                                PatternRewriter &rewriter) const override {
+    if (!tileSizesMap.count(op)) return failure();
+    return Base::matchAndRewrite(op, rewriter);
+  }
+
+ private:
+  const TileSizesMap &tileSizesMap;
+};
+
+struct LinalgTileAndDistributePass
+    : public PassWrapper<LinalgTileAndDistributePass, FunctionPass> {
+  LinalgTileAndDistributePass() = default;
+  LinalgTileAndDistributePass(const LinalgTileAndDistributePass &pass) {}
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<linalg::LinalgDialect, scf::SCFDialect>();
+  }
+
+  void runOnFunction() override;
+
+ private:
+  ListOption<int64_t> tileSizes{
+      *this, "tile-sizes",
+      llvm::cl::desc("Tile sizes for the outermost parallel loops, at most one "
+                     "per workgroup dimension; defaults to 32 for each"),
+      llvm::cl::ZeroOrMore, llvm::cl::MiscFlags::CommaSeparated};
+};
+
+}  // namespace
+
+void LinalgTileAndDistributePass::runOnFunction() {
+  MLIRContext *context = &getContext();
+  FuncOp funcOp = getFunction();
+  Builder builder(context);
+
+  // Each distributed loop gets its own workgroup dimension; loops beyond the
+  // outermost three are left to run within the workgroup.
+  if (tileSizes.size() > kNumWorkgroupDims) {
+    funcOp.emitError("expected at most ")
+        << kNumWorkgroupDims << " workgroup tile sizes, got "
+        << tileSizes.size();
+    return signalPassFailure();
+  }
+  SmallVector<int64_t, kNumWorkgroupDims> workgroupTileSizes(
+      tileSizes.begin(), tileSizes.end());
+  if (workgroupTileSizes.empty()) {
+    workgroupTileSizes.assign(kNumWorkgroupDims, kDefaultWorkgroupTileSize);
+  }
+
+  // When some op cannot be distributed the whole function has to run within a
+  // single workgroup.
+  TileSizesMap tileSizesMap;
+  if (failed(computeTileSizes(funcOp, workgroupTileSizes, tileSizesMap))) {
+    funcOp.setAttr(getLLVMWorkgroupCountAttrName(),
+                   builder.getI64ArrayAttr({1, 1, 1}));
+    return;
+  }
+  if (Optional<SmallVector<int64_t, kNumWorkgroupDims>> workgroupCount =
+          getWorkgroupCount(funcOp, tileSizesMap)) {
+    funcOp.setAttr(getLLVMWorkgroupCountAttrName(),
+                   builder.getI64ArrayAttr(*workgroupCount));
+  }
+
+  auto tileSizeFn = [&tileSizesMap](OpBuilder &builder,
+                                    Operation *op) -> SmallVector<Value, 4> {
+    SmallVector<Value, 4> sizes;
+    for (int64_t size : tileSizesMap.lookup(op)) {
+      sizes.push_back(builder.create<ConstantIndexOp>(op->getLoc(), size));
+    }
+    return sizes;
+  };
+
+  OwningRewritePatternList patterns;
+  patterns.insert<TileAndDistributePattern<linalg::MatmulOp>,
+                  TileAndDistributePattern<linalg::BatchMatmulOp>,
+                  TileAndDistributePattern<linalg::GenericOp>,
+                  TileAndDistributePattern<linalg::IndexedGenericOp>,
+                  TileAndDistributePattern<linalg::ConvOp>,
+                  TileAndDistributePattern<linalg::PoolingMaxOp>,
+                  TileAndDistributePattern<linalg::PoolingMinOp>,
+                  TileAndDistributePattern<linalg::PoolingSumOp>,
+                  TileAndDistributePattern<linalg::FillOp>,
+                  TileAndDistributePattern<linalg::CopyOp>>(
+      context,
+      linalg::LinalgTilingOptions()
+          .setTileSizeComputationFunction(tileSizeFn)
+          .setLoopType(linalg::LinalgTilingLoopType::ParallelLoops),
+      tileSizesMap);
+  applyPatternsAndFoldGreedily(funcOp, patterns);
+
+  // Drop the markers so that later transformations see the tiled ops as fresh
+  // ops to operate on.
+  funcOp.walk([](linalg::LinalgOp linalgOp) {
+    linalgOp.getOperation()->removeAttr(
+        linalg::LinalgTransforms::kLinalgTransformMarker);
+  });
+}
+
+std::unique_ptr<FunctionPass> createLinalgTileAndDistributePass() {
+  return std::make_unique<LinalgTileAndDistributePass>();
+}
+
+static PassRegistration<LinalgTileAndDistributePass> pass(
+    "iree-codegen-llvm-linalg-tile-and-distribute",
+    "Tile and distribute Linalg operations across the dispatch workgroups",
+    [] { return std::make_unique<LinalgTileAndDistributePass>(); });
+
+}  // namespace iree_compiler
+}  // namespace mlir
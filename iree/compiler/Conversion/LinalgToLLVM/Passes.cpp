@@ -26,6 +26,9 @@ namespace mlir {
 namespace iree_compiler {
 
 void addLinalgToLLVMPasses(OpPassManager &passManager) {
+  // Distribute linalg op tiles across the workgroup grid.
+  passManager.addPass(createLinalgTileAndDistributePass());
+  passManager.addPass(createCanonicalizerPass());
   // Linalg -> Vectors Ops.
   passManager.addPass(createMatMulTileAndVectorizePass());
   // Linalg -> SCF
@@ -20,6 +20,21 @@
 namespace mlir {
 namespace iree_compiler {
 
+/// Default tile size used for each of the loops distributed across the
+/// dispatch workgroups.
+static constexpr int64_t kDefaultWorkgroupTileSize = 32;
+
+/// Returns the name of the attribute set on entry point functions holding the
+/// number of workgroups along X, Y and Z needed to cover all the tiles of the
+/// distributed loops. It is only set when the count is known statically, in
+/// which case it is the count the dispatch must be recorded with.
+inline llvm::StringRef getLLVMWorkgroupCountAttrName() {
+  return "iree.workgroup_count";
+}
+
+/// Tiles Linalg ops and distributes the tiles across the dispatch workgroups.
+std::unique_ptr<FunctionPass> createLinalgTileAndDistributePass();
+
 /// Converts linalg::MatmulOp into LLVM dialect
 std::unique_ptr<FunctionPass> createMatMulTileAndVectorizePass();
 
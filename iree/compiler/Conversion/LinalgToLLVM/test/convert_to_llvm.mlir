@@ -14,7 +14,7 @@ func @convert_dynamic_shape() -> f32 {
 hal.interface @legacy_io attributes {push_constants = 2 : i32, sym_visibility = "private"} {
     hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
 }
-// CHECK: llvm.func @convert_dynamic_shape(%[[ARG0:.+]]: !llvm.ptr<ptr<i8>>, %[[ARG1:.+]]: !llvm.ptr<i32>)
+// CHECK: llvm.func @convert_dynamic_shape(%[[ARG0:.+]]: !llvm.ptr<ptr<i8>>, %[[ARG1:.+]]: !llvm.ptr<i32>, %[[ARG2:.+]]: !llvm.ptr<i32>, %[[ARG3:.+]]: !llvm.ptr<i32>)
 // CHECK: %[[PACKED_ARGS_PTR:.+]] = llvm.bitcast %[[ARG0]] : !llvm.ptr<ptr<i8>> to !llvm.ptr<struct<(ptr<float>)>>
 // CHECK: %[[PACKED_ARGS:.+]] = llvm.load %[[PACKED_ARGS_PTR]] : !llvm.ptr<struct<(ptr<float>)>>
 // CHECK: %[[MEMREF0_DATA_PTR:.+]] = llvm.extractvalue %[[PACKED_ARGS]][0] : !llvm.struct<(ptr<float>)>
@@ -52,7 +52,7 @@ hal.interface @legacy_io2 attributes {push_constants = 1 : i32, sym_visibility =
     hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
 }
 
-// CHECK: llvm.func @convert_dynamic_shape2(%[[ARG0:.+]]: !llvm.ptr<ptr<i8>>, %[[ARG1:.+]]: !llvm.ptr<i32>)
+// CHECK: llvm.func @convert_dynamic_shape2(%[[ARG0:.+]]: !llvm.ptr<ptr<i8>>, %[[ARG1:.+]]: !llvm.ptr<i32>, %[[ARG2:.+]]: !llvm.ptr<i32>, %[[ARG3:.+]]: !llvm.ptr<i32>)
 // CHECK: %[[PACKED_ARGS_PTR:.+]] = llvm.bitcast %[[ARG0]] : !llvm.ptr<ptr<i8>> to !llvm.ptr<struct<(ptr<float>)>>
 // CHECK: %[[PACKED_ARGS:.+]] = llvm.load %[[PACKED_ARGS_PTR]] : !llvm.ptr<struct<(ptr<float>)>>
 // CHECK: %[[MEMREF0_DATA_PTR:.+]] = llvm.extractvalue %[[PACKED_ARGS]][0] : !llvm.struct<(ptr<float>)>
@@ -84,3 +84,30 @@ hal.interface @legacy_io2 attributes {push_constants = 1 : i32, sym_visibility =
 // CHECK: %[[GET_PTR:.+]] = llvm.getelementptr %[[EXTRACT1:.+]][%[[ADD2:.+]]] : (!llvm.ptr<float>, !llvm.i64) -> !llvm.ptr<float>
 // CHECK: %[[LOAD:.+]] = llvm.load %[[GET_PTR:.+]] : !llvm.ptr<float>
 
+
+// -----
+
+// CHECK_LABEL: @convert_workgroup_info
+func @convert_workgroup_info() {
+  %0 = iree.placeholder for "interface buffer" {binding = @legacy_io3::@arg0} : memref<4xi32>
+  %1 = hal.interface.workgroup.id[0] : index
+  %2 = hal.interface.workgroup.count[1] : index
+  %3 = index_cast %1 : index to i32
+  %4 = index_cast %2 : index to i32
+  store %3, %0[%1] : memref<4xi32>
+  store %4, %0[%2] : memref<4xi32>
+  return
+}
+hal.interface @legacy_io3 attributes {sym_visibility = "private"} {
+    hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Write"
+}
+
+// CHECK: llvm.func @convert_workgroup_info(%[[ARG0:.+]]: !llvm.ptr<ptr<i8>>, %[[ARG1:.+]]: !llvm.ptr<i32>, %[[ARG2:.+]]: !llvm.ptr<i32>, %[[ARG3:.+]]: !llvm.ptr<i32>)
+// CHECK: %[[ID_INDEX:.+]] = llvm.mlir.constant(0 : i64) : !llvm.i64
+// CHECK: %[[ID_PTR:.+]] = llvm.getelementptr %[[ARG2]][%[[ID_INDEX]]] : (!llvm.ptr<i32>, !llvm.i64) -> !llvm.ptr<i32>
+// CHECK: %[[ID:.+]] = llvm.load %[[ID_PTR]] : !llvm.ptr<i32>
+// CHECK: llvm.zext %[[ID]] : !llvm.i32 to !llvm.i64
+// CHECK: %[[COUNT_INDEX:.+]] = llvm.mlir.constant(1 : i64) : !llvm.i64
+// CHECK: %[[COUNT_PTR:.+]] = llvm.getelementptr %[[ARG3]][%[[COUNT_INDEX]]] : (!llvm.ptr<i32>, !llvm.i64) -> !llvm.ptr<i32>
+// CHECK: %[[COUNT:.+]] = llvm.load %[[COUNT_PTR]] : !llvm.ptr<i32>
+// CHECK: llvm.zext %[[COUNT]] : !llvm.i32 to !llvm.i64
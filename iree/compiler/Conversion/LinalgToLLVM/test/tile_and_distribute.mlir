@@ -0,0 +1,70 @@
+// RUN: iree-opt -split-input-file -iree-codegen-llvm-linalg-tile-and-distribute -cse %s | IreeFileCheck %s
+
+func @matmul(%arg0 : memref<?x?xf32>, %arg1 : memref<?x?xf32>,
+             %arg2 : memref<?x?xf32>) {
+  linalg.matmul %arg0, %arg1, %arg2 :
+    (memref<?x?xf32>, memref<?x?xf32>, memref<?x?xf32>)
+  return
+}
+// CHECK-LABEL: func @matmul
+//   CHECK-DAG:   %[[ID_X:.+]] = hal.interface.workgroup.id[0] : index
+//   CHECK-DAG:   %[[COUNT_X:.+]] = hal.interface.workgroup.count[0] : index
+//   CHECK-DAG:   %[[ID_Y:.+]] = hal.interface.workgroup.id[1] : index
+//   CHECK-DAG:   %[[COUNT_Y:.+]] = hal.interface.workgroup.count[1] : index
+//       CHECK:   scf.parallel
+//       CHECK:     linalg.matmul
+//   CHECK-NOT:       __internal_linalg_transform__
+
+// -----
+
+func @conv_padding(%arg0 : memref<?x?x?x?xf32>, %arg1 : memref<?x?x?x?xf32>,
+                   %arg2 : memref<?x?x?x?xf32>) {
+  linalg.conv(%arg0, %arg1, %arg2)
+    {dilations = [1, 1],
+     padding = dense<[[1, 1], [0, 1]]> : tensor<2x2xi64>, strides = [1, 1]} :
+    memref<?x?x?x?xf32>, memref<?x?x?x?xf32>, memref<?x?x?x?xf32>
+  return
+}
+// CHECK-LABEL: func @conv_padding
+//   CHECK-DAG:   %[[ID_X:.+]] = hal.interface.workgroup.id[0] : index
+//   CHECK-DAG:   %[[COUNT_X:.+]] = hal.interface.workgroup.count[0] : index
+//   CHECK-NOT:   hal.interface.workgroup.id[1]
+//       CHECK:   scf.parallel (%{{.+}}) =
+//       CHECK:     linalg.conv
+
+// -----
+
+func @fill_matmul(%arg0 : memref<64x48xf32>, %arg1 : memref<48x96xf32>,
+                  %arg2 : memref<64x96xf32>) {
+  %zero = constant 0.0 : f32
+  linalg.fill(%arg2, %zero) : memref<64x96xf32>, f32
+  linalg.matmul %arg0, %arg1, %arg2 :
+    (memref<64x48xf32>, memref<48x96xf32>, memref<64x96xf32>)
+  return
+}
+// CHECK-LABEL: func @fill_matmul
+//  CHECK-SAME:   iree.workgroup_count = [3, 2, 1]
+//       CHECK:   scf.parallel (%{{.+}}, %{{.+}}) = (%[[LB_Y:[a-z0-9_]+]], %[[LB_X:[a-z0-9_]+]]) to (%[[UB_Y:[a-z0-9_]+]], %[[UB_X:[a-z0-9_]+]]) step (%[[STEP_Y:[a-z0-9_]+]], %[[STEP_X:[a-z0-9_]+]])
+//       CHECK:     linalg.fill
+//       CHECK:   scf.parallel (%{{.+}}, %{{.+}}) = (%[[LB_Y]], %[[LB_X]]) to (%[[UB_Y]], %[[UB_X]]) step (%[[STEP_Y]], %[[STEP_X]])
+//       CHECK:     linalg.matmul
+
+// -----
+
+func @fill_copy_subview(%arg0 : memref<4x4xf32>, %arg1 : memref<6x6xf32>) {
+  %zero = constant 0.0 : f32
+  %c1 = constant 1 : index
+  %c4 = constant 4 : index
+  linalg.fill(%arg1, %zero) : memref<6x6xf32>, f32
+  %0 = subview %arg1[%c1, %c1] [%c4, %c4] [%c1, %c1] :
+    memref<6x6xf32> to memref<?x?xf32, offset: ?, strides: [?, ?]>
+  linalg.copy(%arg0, %0) :
+    memref<4x4xf32>, memref<?x?xf32, offset: ?, strides: [?, ?]>
+  return
+}
+// Both ops write to the same buffer with different tilings, so the function
+// is left to a single workgroup.
+// CHECK-LABEL: func @fill_copy_subview
+//  CHECK-SAME:   iree.workgroup_count = [1, 1, 1]
+//   CHECK-NOT:   hal.interface.workgroup.id
+//   CHECK-NOT:   scf.parallel
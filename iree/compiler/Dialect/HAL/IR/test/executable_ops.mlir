@@ -17,6 +17,17 @@ func @interface_io() {
 
 // -----
 
+// CHECK-LABEL: @interface_workgroup_info
+func @interface_workgroup_info() {
+  // CHECK: %[[ID_X:.+]] = hal.interface.workgroup.id[0] : index
+  %0 = hal.interface.workgroup.id[0] : index
+  // CHECK: %[[COUNT_Z:.+]] = hal.interface.workgroup.count[2] : index
+  %1 = hal.interface.workgroup.count[2] : index
+  return
+}
+
+// -----
+
 // CHECK-LABEL: @ex
 hal.executable @ex {
   // CHECK-DAG: hal.executable.entry_point @entry0 attributes {
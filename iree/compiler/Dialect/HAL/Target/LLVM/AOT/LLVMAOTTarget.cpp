@@ -18,6 +18,7 @@
 
 #include "iree/compiler/Conversion/LinalgToLLVM/Passes.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/AOT/LLVMAOTTargetLinker.h"
+#include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMBaseTarget.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMIRPasses.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/schemas/dylib_executable_def_generated.h"
@@ -37,7 +38,7 @@ namespace iree_compiler {
 namespace IREE {
 namespace HAL {
 
-class LLVMAOTTargetBackend final : public TargetBackend {
+class LLVMAOTTargetBackend final : public LLVMBaseTargetBackend {
  public:
   LLVMAOTTargetBackend(LLVMTargetOptions options)
       : options_(std::move(options)) {}
@@ -147,15 +148,6 @@ class LLVMAOTTargetBackend final : public TargetBackend {
     return success();
   }
 
-  std::array<Value, 3> calculateDispatchWorkgroupCount(
-      Location loc, IREE::HAL::ExecutableOp executableOp,
-      IREE::HAL::ExecutableEntryPointOp entryPointOp, Value workload,
-      OpBuilder& builder) override {
-    // For now we are not tiling and just dispatch everything as 1,1,1.
-    auto constantOne = builder.createOrFold<mlir::ConstantIndexOp>(loc, 1);
-    return {constantOne, constantOne, constantOne};
-  }
-
  private:
   LLVMTargetOptions options_;
 };
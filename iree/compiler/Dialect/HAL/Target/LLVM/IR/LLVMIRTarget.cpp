@@ -15,9 +15,11 @@
 #include "iree/compiler/Dialect/HAL/Target/LLVM/IR/LLVMIRTarget.h"
 
 #include "iree/compiler/Conversion/LinalgToLLVM/Passes.h"
+#include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMBaseTarget.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMIRPasses.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/schemas/llvmir_executable_def_generated.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Support/Mutex.h"
@@ -34,7 +36,7 @@ namespace iree_compiler {
 namespace IREE {
 namespace HAL {
 
-class LLVMIRTargetBackend final : public TargetBackend {
+class LLVMIRTargetBackend final : public LLVMBaseTargetBackend {
  public:
   LLVMIRTargetBackend(LLVMTargetOptions options)
       : options_(std::move(options)) {}
@@ -94,10 +96,15 @@ class LLVMIRTargetBackend final : public TargetBackend {
           "Can't build LLVMIR opt passes for ExecutableOp module");
     }
 
-    // Serialize LLVM module.
+    // Serialize LLVM module. Bitcode is both smaller and much faster to load
+    // than textual IR.
     std::string bufferString;
     llvm::raw_string_ostream ostream(bufferString);
-    llvmModule->print(ostream, nullptr);
+    if (options_.emitTextualIR) {
+      llvmModule->print(ostream, nullptr);
+    } else {
+      llvm::WriteBitcodeToFile(*llvmModule, ostream);
+    }
     ostream.flush();
 
     // Creates executable bytes.
@@ -121,15 +128,6 @@ class LLVMIRTargetBackend final : public TargetBackend {
     return success();
   }
 
-  std::array<Value, 3> calculateDispatchWorkgroupCount(
-      Location loc, IREE::HAL::ExecutableOp executableOp,
-      IREE::HAL::ExecutableEntryPointOp entryPointOp, Value workload,
-      OpBuilder& builder) override {
-    // For now we are not tiling and just dispatch everything as 1,1,1.
-    auto constantOne = builder.createOrFold<mlir::ConstantIndexOp>(loc, 1);
-    return {constantOne, constantOne, constantOne};
-  }
-
  private:
   LLVMTargetOptions options_;
 };
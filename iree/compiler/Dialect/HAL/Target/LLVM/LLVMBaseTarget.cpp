@@ -0,0 +1,64 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMBaseTarget.h"
+
+#include "iree/compiler/Conversion/LinalgToLLVM/Passes.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+std::array<Value, 3> LLVMBaseTargetBackend::calculateDispatchWorkgroupCount(
+    Location loc, IREE::HAL::ExecutableOp executableOp,
+    IREE::HAL::ExecutableEntryPointOp entryPointOp, Value workload,
+    OpBuilder& builder) {
+  auto targetOp = entryPointOp.getOperation()
+                      ->getParentOfType<IREE::HAL::ExecutableTargetOp>();
+  auto funcOp = targetOp.getInnerModule().lookupSymbol<LLVM::LLVMFuncOp>(
+      entryPointOp.sym_name());
+  auto workgroupCountAttr =
+      funcOp ? funcOp.getAttrOfType<ArrayAttr>(getLLVMWorkgroupCountAttrName())
+             : ArrayAttr();
+  if (workgroupCountAttr) {
+    std::array<Value, 3> workgroupCount;
+    for (int i = 0; i < 3; ++i) {
+      workgroupCount[i] = builder.createOrFold<mlir::ConstantIndexOp>(
+          loc, workgroupCountAttr.getValue()[i].cast<IntegerAttr>().getInt());
+    }
+    return workgroupCount;
+  }
+
+  constexpr int64_t kElementsPerWorkgroup =
+      kDefaultWorkgroupTileSize * kDefaultWorkgroupTileSize;
+  auto constantOne = builder.createOrFold<mlir::ConstantIndexOp>(loc, 1);
+  auto elementsPerWorkgroup =
+      builder.createOrFold<mlir::ConstantIndexOp>(loc, kElementsPerWorkgroup);
+  auto workgroupCountX = builder.createOrFold<mlir::UnsignedDivIOp>(
+      loc,
+      builder.createOrFold<mlir::AddIOp>(
+          loc, workload,
+          builder.createOrFold<mlir::ConstantIndexOp>(
+              loc, kElementsPerWorkgroup - 1)),
+      elementsPerWorkgroup);
+  return {workgroupCountX, constantOne, constantOne};
+}
+
+}  // namespace HAL
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
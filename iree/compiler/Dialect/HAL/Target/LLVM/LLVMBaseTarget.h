@@ -0,0 +1,44 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_LLVMBASETARGET_H_
+#define IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_LLVMBASETARGET_H_
+
+#include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+// Base target for the backends lowering through the LinalgToLLVM pipeline,
+// which tiles and distributes the dispatch region across workgroups.
+class LLVMBaseTargetBackend : public TargetBackend {
+ public:
+  // Uses the workgroup count computed while distributing the entry point when
+  // it is known statically (one workgroup per tile of each distributed loop).
+  // Otherwise workgroups are cyclically distributed so any count is valid and
+  // one workgroup per tile worth of the linearized workload is used.
+  std::array<Value, 3> calculateDispatchWorkgroupCount(
+      Location loc, IREE::HAL::ExecutableOp executableOp,
+      IREE::HAL::ExecutableEntryPointOp entryPointOp, Value workload,
+      OpBuilder& builder) override;
+};
+
+}  // namespace HAL
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
+
+#endif  // IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_LLVMBASETARGET_H_
@@ -51,8 +51,14 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
       llvm::cl::desc("LLVM target codegen enables soft float abi e.g "
                      "-mfloat-abi=softfp"),
       llvm::cl::init(false));
+  static llvm::cl::opt<bool> clEmitTextualIR(
+      "iree-llvm-ir-emit-text",
+      llvm::cl::desc("Embeds textual LLVM IR instead of bitcode in llvm-ir "
+                     "executables; much slower to load, useful for debugging"),
+      llvm::cl::init(false));
 
   llvmTargetOptions.targetTriple = clTargetTriple;
+  llvmTargetOptions.emitTextualIR = clEmitTextualIR;
   if (clSoftFloat) {
     llvmTargetOptions.options.FloatABIType = llvm::FloatABI::Soft;
   }
@@ -28,6 +28,8 @@ struct LLVMTargetOptions {
   llvm::PassBuilder::OptimizationLevel optLevel;
   llvm::TargetOptions options;
   std::string targetTriple;
+  // Embeds textual LLVM IR instead of bitcode in llvm-ir executables.
+  bool emitTextualIR = false;
 };
 
 // Returns LLVMTargetOptions struct intialized with the
@@ -172,6 +172,18 @@ class ConstantOpConversion : public OpConversionPattern<ConstantOp> {
   LogicalResult matchAndRewrite(
       ConstantOp srcOp, ArrayRef<Value> operands,
       ConversionPatternRewriter &rewriter) const override {
+    if (auto floatAttr = srcOp.getValue().dyn_cast<FloatAttr>()) {
+      if (!floatAttr.getType().isF32()) {
+        return srcOp.emitRemark()
+               << "unsupported const floating-point bit width for dialect";
+      }
+      if (floatAttr.getValue().isPosZero()) {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstF32ZeroOp>(srcOp);
+      } else {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstF32Op>(srcOp, floatAttr);
+      }
+      return success();
+    }
     auto integerAttr = srcOp.getValue().dyn_cast<IntegerAttr>();
     if (!integerAttr) {
       return srcOp.emitRemark() << "unsupported const type for dialect";
@@ -260,6 +272,62 @@ class CmpIOpConversion : public OpConversionPattern<CmpIOp> {
   }
 };
 
+class CmpFOpConversion : public OpConversionPattern<CmpFOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      CmpFOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    CmpFOp::Adaptor srcAdapter(operands);
+    if (!srcAdapter.lhs().getType().isF32()) return failure();
+    auto returnType = rewriter.getIntegerType(32);
+    switch (srcOp.getPredicate()) {
+      case CmpFPredicate::OEQ:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpEQF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::UNE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpNEF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OLT:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OLE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OGT:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpGTF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OGE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpGTEF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      default:
+        // TODO(benvanik): the remaining unordered predicates.
+        return failure();
+    }
+  }
+};
+
+template <typename SrcOpTy, typename DstOpTy>
+class UnaryArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      SrcOpTy srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    typename SrcOpTy::Adaptor srcAdapter(operands);
+
+    rewriter.replaceOpWithNewOp<DstOpTy>(
+        srcOp, srcAdapter.operand().getType(), srcAdapter.operand());
+    return success();
+  }
+};
+
 template <typename SrcOpTy, typename DstOpTy>
 class BinaryArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
   using OpConversionPattern<SrcOpTy>::OpConversionPattern;
@@ -327,7 +395,8 @@ class SelectI32OpConversion : public OpConversionPattern<SelectOp> {
     // (Otherwise, the dialect converter may report the error as a failure to
     // legalize the select op depending on order of resolution).
     auto actualType = srcAdaptor.true_value().getType();
-    if (actualType != requiredType && actualType.isa<IndexType>()) {
+    if (actualType != requiredType &&
+        (actualType.isa<IndexType>() || actualType.isa<FloatType>())) {
       return failure();
     }
 
@@ -338,6 +407,33 @@ class SelectI32OpConversion : public OpConversionPattern<SelectOp> {
   }
 };
 
+class SelectF32OpConversion : public OpConversionPattern<SelectOp> {
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult matchAndRewrite(
+      SelectOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    SelectOp::Adaptor srcAdaptor(operands);
+    auto actualType = srcAdaptor.true_value().getType();
+    if (!actualType.isF32()) return failure();
+    rewriter.replaceOpWithNewOp<IREE::VM::SelectF32Op>(
+        srcOp, actualType, srcAdaptor.condition(), srcAdaptor.true_value(),
+        srcAdaptor.false_value());
+    return success();
+  }
+};
+
+class SIToFPOpConversion : public OpConversionPattern<SIToFPOp> {
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult matchAndRewrite(
+      SIToFPOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    if (!srcOp.getType().isF32()) return failure();
+    rewriter.replaceOpWithNewOp<IREE::VM::CastSI32F32Op>(
+        srcOp, srcOp.getType(), operands[0]);
+    return success();
+  }
+};
+
 class BranchOpConversion : public OpConversionPattern<BranchOp> {
   using OpConversionPattern::OpConversionPattern;
 
@@ -400,6 +496,8 @@ void populateStandardToVMPatterns(MLIRContext *context,
                   ReturnOpConversion, CastingOpConversion<IndexCastOp>,
                   CastingOpConversion<TruncateIOp>, SelectI32OpConversion>(
       typeConverter, context);
+  patterns.insert<CmpFOpConversion, SelectF32OpConversion, SIToFPOpConversion>(
+      typeConverter, context);
   // TODO(#2878): pass typeConverter here.
   patterns.insert<ConstantOpConversion>(context);
 
@@ -417,6 +515,22 @@ void populateStandardToVMPatterns(MLIRContext *context,
               BinaryArithmeticOpConversion<XOrOp, IREE::VM::XorI32Op>>(
           typeConverter, context);
 
+  // Floating-point arithmetic ops
+  patterns.insert<BinaryArithmeticOpConversion<AddFOp, IREE::VM::AddF32Op>,
+                  BinaryArithmeticOpConversion<SubFOp, IREE::VM::SubF32Op>,
+                  BinaryArithmeticOpConversion<MulFOp, IREE::VM::MulF32Op>,
+                  BinaryArithmeticOpConversion<DivFOp, IREE::VM::DivF32Op>,
+                  BinaryArithmeticOpConversion<RemFOp, IREE::VM::RemF32Op>,
+                  UnaryArithmeticOpConversion<AbsFOp, IREE::VM::AbsF32Op>,
+                  UnaryArithmeticOpConversion<NegFOp, IREE::VM::NegF32Op>,
+                  UnaryArithmeticOpConversion<CeilFOp, IREE::VM::CeilF32Op>,
+                  UnaryArithmeticOpConversion<SqrtOp, IREE::VM::SqrtF32Op>,
+                  UnaryArithmeticOpConversion<RsqrtOp, IREE::VM::RsqrtF32Op>,
+                  UnaryArithmeticOpConversion<ExpOp, IREE::VM::ExpF32Op>,
+                  UnaryArithmeticOpConversion<LogOp, IREE::VM::LogF32Op>,
+                  UnaryArithmeticOpConversion<TanhOp, IREE::VM::TanhF32Op>>(
+      typeConverter, context);
+
   // Shift ops
   // TODO(laurenzo): The standard dialect is missing shr ops. Add once in place.
   patterns.insert<ShiftArithmeticOpConversion<ShiftLeftOp, IREE::VM::ShlI32Op>>(
@@ -0,0 +1,73 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='test-iree-convert-std-to-vm' -iree-vm-target-extensions=f32 %s | IreeFileCheck %s
+
+// -----
+// CHECK-LABEL: @t001_addf
+module @t001_addf {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1: f32) -> (f32) {
+    // CHECK: %[[ADD:.+]] = vm.add.f32 %[[ARG0]], %[[ARG1]]
+    %0 = addf %arg0, %arg1 : f32
+    // CHECK: %[[MUL:.+]] = vm.mul.f32 %[[ADD]], %[[ARG1]]
+    %1 = mulf %0, %arg1 : f32
+    // CHECK: vm.neg.f32 %[[MUL]]
+    %2 = negf %1 : f32
+    return %2 : f32
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t002_constf
+module @t002_constf {
+
+module {
+  func @my_fn() -> (f32, f32) {
+    // CHECK: vm.const.f32.zero : f32
+    %0 = constant 0.0 : f32
+    // CHECK: vm.const.f32 2.500000e+00 : f32
+    %1 = constant 2.5 : f32
+    return %0, %1 : f32, f32
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t003_cmpf
+module @t003_cmpf {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1: f32) -> (f32) {
+    // CHECK: %[[CMP:.+]] = vm.cmp.lt.f32 %[[ARG0]], %[[ARG1]]
+    %0 = cmpf "olt", %arg0, %arg1 : f32
+    // CHECK: vm.select.f32 %[[CMP]], %[[ARG0]], %[[ARG1]]
+    %1 = select %0, %arg0, %arg1 : f32
+    return %1 : f32
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t004_sitofp
+module @t004_sitofp {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: i32) -> (f32) {
+    // CHECK: vm.cast.si32.f32 %[[ARG0]] : i32 -> f32
+    %0 = sitofp %arg0 : i32 to f32
+    return %0 : f32
+  }
+}
+
+}
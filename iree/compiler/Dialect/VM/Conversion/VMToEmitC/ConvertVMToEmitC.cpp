@@ -14,6 +14,8 @@
 
 #include "iree/compiler/Dialect/VM/Conversion/VMToEmitC/ConvertVMToEmitC.h"
 
+#include <algorithm>
+
 #include "emitc/Dialect/EmitC/EmitCDialect.h"
 #include "iree/compiler/Dialect/VM/IR/VMOps.h"
 #include "mlir/IR/Matchers.h"
@@ -25,45 +27,152 @@ namespace iree_compiler {
 
 namespace {
 
-// Taken over from StandardToVM.
-// We need to replace the Op depending on the operand.
-// We could start with a conversion for IREE::VM::AddI32Op
-template <typename SrcOpTy, typename DstOpTy>
-class BinaryArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
-  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+// Returns the name of the iree/vm/ops.h function implementing |opName|.
+// Example: `vm.add.i32` -> `vm_add_i32`.
+std::string getCalleeName(StringRef opName) {
+  std::string calleeName = opName.str();
+  std::replace(calleeName.begin(), calleeName.end(), '.', '_');
+  return calleeName;
+}
 
+// Converts a primitive VM op into a call to its iree/vm/ops.h implementation.
+// All operands are passed through in order.
+template <typename SrcOpTy>
+class CallOpConversion : public OpConversionPattern<SrcOpTy> {
  public:
-  BinaryArithmeticOpConversion(MLIRContext *context, StringRef funcName)
-      : OpConversionPattern<SrcOpTy>(context), funcName(funcName) {}
+  explicit CallOpConversion(MLIRContext *context)
+      : OpConversionPattern<SrcOpTy>(context),
+        funcName(getCalleeName(SrcOpTy::getOperationName())) {}
+
+ protected:
+  // Appends any non-operand arguments (such as attributes) to |args|.
+  virtual void appendAttributeArgs(SrcOpTy srcOp,
+                                   SmallVectorImpl<Attribute> &args) const {}
 
  private:
   LogicalResult matchAndRewrite(
       SrcOpTy srcOp, ArrayRef<Value> operands,
       ConversionPatternRewriter &rewriter) const override {
-    typename SrcOpTy::Adaptor srcAdapter(operands);
-
     StringAttr callee = rewriter.getStringAttr(funcName);
-    ArrayAttr args =
-        rewriter.getArrayAttr({IntegerAttr::get(rewriter.getIndexType(), 0),
-                               IntegerAttr::get(rewriter.getIndexType(), 1)});
-    ValueRange dstOperands{srcAdapter.lhs(), srcAdapter.rhs()};
+    SmallVector<Attribute, 4> args;
+    for (unsigned i = 0; i < operands.size(); ++i) {
+      args.push_back(IntegerAttr::get(rewriter.getIndexType(), i));
+    }
+    appendAttributeArgs(srcOp, args);
 
-    rewriter.replaceOpWithNewOp<DstOpTy>(srcOp, srcAdapter.lhs().getType(),
-                                         callee, args, dstOperands);
+    rewriter.replaceOpWithNewOp<mlir::emitc::CallOp>(
+        srcOp, srcOp.getOperation()->getResult(0).getType(), callee,
+        rewriter.getArrayAttr(args), operands);
 
     return success();
   }
 
-  StringRef funcName;
+  std::string funcName;
+};
+
+// Shifts carry their amount as an attribute that is passed as a literal.
+template <typename SrcOpTy>
+class ShiftOpConversion : public CallOpConversion<SrcOpTy> {
+ public:
+  using CallOpConversion<SrcOpTy>::CallOpConversion;
+
+ protected:
+  void appendAttributeArgs(SrcOpTy srcOp,
+                           SmallVectorImpl<Attribute> &args) const override {
+    args.push_back(srcOp.amountAttr());
+  }
 };
 
 }  // namespace
 
 void populateVMToCPatterns(MLIRContext *context,
                            OwningRewritePatternList &patterns) {
-  patterns.insert<
-      BinaryArithmeticOpConversion<IREE::VM::AddI32Op, mlir::emitc::CallOp>>(
-      context, "vm_add_i32");
+  // Conditional assignment ops.
+  patterns.insert<CallOpConversion<IREE::VM::SelectI32Op>,
+                  CallOpConversion<IREE::VM::SelectI64Op>,
+                  CallOpConversion<IREE::VM::SelectF32Op>>(context);
+
+  // Native integer arithmetic ops.
+  patterns.insert<CallOpConversion<IREE::VM::AddI32Op>,
+                  CallOpConversion<IREE::VM::SubI32Op>,
+                  CallOpConversion<IREE::VM::MulI32Op>,
+                  CallOpConversion<IREE::VM::DivI32SOp>,
+                  CallOpConversion<IREE::VM::DivI32UOp>,
+                  CallOpConversion<IREE::VM::RemI32SOp>,
+                  CallOpConversion<IREE::VM::RemI32UOp>,
+                  CallOpConversion<IREE::VM::NotI32Op>,
+                  CallOpConversion<IREE::VM::AndI32Op>,
+                  CallOpConversion<IREE::VM::OrI32Op>,
+                  CallOpConversion<IREE::VM::XorI32Op>>(context);
+  patterns.insert<CallOpConversion<IREE::VM::AddI64Op>,
+                  CallOpConversion<IREE::VM::SubI64Op>,
+                  CallOpConversion<IREE::VM::MulI64Op>,
+                  CallOpConversion<IREE::VM::DivI64SOp>,
+                  CallOpConversion<IREE::VM::DivI64UOp>,
+                  CallOpConversion<IREE::VM::RemI64SOp>,
+                  CallOpConversion<IREE::VM::RemI64UOp>,
+                  CallOpConversion<IREE::VM::NotI64Op>,
+                  CallOpConversion<IREE::VM::AndI64Op>,
+                  CallOpConversion<IREE::VM::OrI64Op>,
+                  CallOpConversion<IREE::VM::XorI64Op>>(context);
+
+  // Native bitwise shift ops.
+  patterns.insert<ShiftOpConversion<IREE::VM::ShlI32Op>,
+                  ShiftOpConversion<IREE::VM::ShrI32SOp>,
+                  ShiftOpConversion<IREE::VM::ShrI32UOp>,
+                  ShiftOpConversion<IREE::VM::ShlI64Op>,
+                  ShiftOpConversion<IREE::VM::ShrI64SOp>,
+                  ShiftOpConversion<IREE::VM::ShrI64UOp>>(context);
+
+  // Native floating-point arithmetic ops.
+  patterns.insert<CallOpConversion<IREE::VM::AddF32Op>,
+                  CallOpConversion<IREE::VM::SubF32Op>,
+                  CallOpConversion<IREE::VM::MulF32Op>,
+                  CallOpConversion<IREE::VM::DivF32Op>,
+                  CallOpConversion<IREE::VM::RemF32Op>,
+                  CallOpConversion<IREE::VM::AbsF32Op>,
+                  CallOpConversion<IREE::VM::NegF32Op>,
+                  CallOpConversion<IREE::VM::CeilF32Op>,
+                  CallOpConversion<IREE::VM::FloorF32Op>,
+                  CallOpConversion<IREE::VM::SqrtF32Op>,
+                  CallOpConversion<IREE::VM::RsqrtF32Op>,
+                  CallOpConversion<IREE::VM::ExpF32Op>,
+                  CallOpConversion<IREE::VM::LogF32Op>,
+                  CallOpConversion<IREE::VM::TanhF32Op>>(context);
+
+  // Casting and type conversion/emulation ops.
+  patterns.insert<CallOpConversion<IREE::VM::TruncI32I8Op>,
+                  CallOpConversion<IREE::VM::TruncI32I16Op>,
+                  CallOpConversion<IREE::VM::TruncI64I32Op>,
+                  CallOpConversion<IREE::VM::ExtI8I32SOp>,
+                  CallOpConversion<IREE::VM::ExtI8I32UOp>,
+                  CallOpConversion<IREE::VM::ExtI16I32SOp>,
+                  CallOpConversion<IREE::VM::ExtI16I32UOp>,
+                  CallOpConversion<IREE::VM::ExtI32I64SOp>,
+                  CallOpConversion<IREE::VM::ExtI32I64UOp>,
+                  CallOpConversion<IREE::VM::CastSI32F32Op>,
+                  CallOpConversion<IREE::VM::CastUI32F32Op>,
+                  CallOpConversion<IREE::VM::CastF32SI32Op>,
+                  CallOpConversion<IREE::VM::CastF32UI32Op>,
+                  CallOpConversion<IREE::VM::BitcastI32F32Op>,
+                  CallOpConversion<IREE::VM::BitcastF32I32Op>>(context);
+
+  // Comparison ops.
+  patterns.insert<CallOpConversion<IREE::VM::CmpEQI32Op>,
+                  CallOpConversion<IREE::VM::CmpNEI32Op>,
+                  CallOpConversion<IREE::VM::CmpLTI32SOp>,
+                  CallOpConversion<IREE::VM::CmpLTI32UOp>,
+                  CallOpConversion<IREE::VM::CmpNZI32Op>,
+                  CallOpConversion<IREE::VM::CmpEQI64Op>,
+                  CallOpConversion<IREE::VM::CmpNEI64Op>,
+                  CallOpConversion<IREE::VM::CmpLTI64SOp>,
+                  CallOpConversion<IREE::VM::CmpLTI64UOp>,
+                  CallOpConversion<IREE::VM::CmpNZI64Op>,
+                  CallOpConversion<IREE::VM::CmpEQF32Op>,
+                  CallOpConversion<IREE::VM::CmpNEF32Op>,
+                  CallOpConversion<IREE::VM::CmpLTF32Op>,
+                  CallOpConversion<IREE::VM::CmpLTEF32Op>,
+                  CallOpConversion<IREE::VM::CmpNZF32Op>>(context);
 }
 
 namespace IREE {
@@ -86,8 +195,35 @@ class ConvertVMToEmitCPass
     populateVMToCPatterns(&getContext(), patterns);
 
     target.addLegalDialect<mlir::emitc::EmitCDialect>();
-    target.addLegalDialect<IREE::VM::VMDialect>();
-    target.addIllegalOp<IREE::VM::AddI32Op>();
+
+    // Structural and control flow ops are emitted directly by the C module
+    // target; everything else must have been converted to emitc.call ops.
+    target.addIllegalDialect<IREE::VM::VMDialect>();
+    target.addLegalOp<
+        IREE::VM::ModuleOp, IREE::VM::ModuleTerminatorOp, IREE::VM::FuncOp,
+        IREE::VM::ExportOp, IREE::VM::ImportOp, IREE::VM::GlobalI32Op,
+        IREE::VM::GlobalI64Op, IREE::VM::GlobalF32Op, IREE::VM::GlobalRefOp,
+        IREE::VM::RodataOp, IREE::VM::GlobalAddressOp, IREE::VM::GlobalLoadI32Op,
+        IREE::VM::GlobalLoadI64Op, IREE::VM::GlobalLoadF32Op,
+        IREE::VM::GlobalStoreI32Op, IREE::VM::GlobalStoreI64Op,
+        IREE::VM::GlobalStoreF32Op, IREE::VM::GlobalLoadIndirectI32Op,
+        IREE::VM::GlobalLoadIndirectI64Op, IREE::VM::GlobalLoadIndirectF32Op,
+        IREE::VM::GlobalStoreIndirectI32Op, IREE::VM::GlobalStoreIndirectI64Op,
+        IREE::VM::GlobalStoreIndirectF32Op, IREE::VM::GlobalLoadRefOp,
+        IREE::VM::GlobalStoreRefOp, IREE::VM::ConstI32Op,
+        IREE::VM::ConstI64Op, IREE::VM::ConstF32Op, IREE::VM::ConstI32ZeroOp,
+        IREE::VM::ConstI64ZeroOp, IREE::VM::ConstF32ZeroOp,
+        IREE::VM::ConstRefZeroOp, IREE::VM::ConstRefRodataOp,
+        IREE::VM::ListAllocOp, IREE::VM::ListReserveOp, IREE::VM::ListSizeOp,
+        IREE::VM::ListResizeOp, IREE::VM::ListGetI32Op, IREE::VM::ListGetI64Op,
+        IREE::VM::ListGetF32Op, IREE::VM::ListSetI32Op, IREE::VM::ListSetI64Op,
+        IREE::VM::ListSetF32Op, IREE::VM::ListGetRefOp, IREE::VM::ListSetRefOp,
+        IREE::VM::SelectRefOp, IREE::VM::SwitchI32Op, IREE::VM::SwitchI64Op,
+        IREE::VM::SwitchRefOp, IREE::VM::CmpEQRefOp, IREE::VM::CmpNERefOp,
+        IREE::VM::CmpNZRefOp, IREE::VM::BranchOp, IREE::VM::CondBranchOp,
+        IREE::VM::CallOp, IREE::VM::ReturnOp, IREE::VM::FailOp,
+        IREE::VM::YieldOp, IREE::VM::TraceOp, IREE::VM::PrintOp,
+        IREE::VM::BreakOp, IREE::VM::CondBreakOp>();
 
     if (failed(applyFullConversion(getOperation(), target, patterns))) {
       return signalPassFailure();
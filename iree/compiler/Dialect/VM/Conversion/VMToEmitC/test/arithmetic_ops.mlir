@@ -0,0 +1,29 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='iree-convert-vm-to-emitc' %s | IreeFileCheck %s
+
+// CHECK-LABEL: vm.func @arithmetic_i32
+vm.module @arithmetic_module {
+  vm.func @arithmetic_i32(%arg0: i32, %arg1: i32) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_div_i32_s"(%arg0, %arg1) {args = [0 : index, 1 : index]} : (i32, i32) -> i32
+    %0 = vm.div.i32.s %arg0, %arg1 : i32
+    // CHECK-NEXT: %1 = emitc.call "vm_not_i32"(%0) {args = [0 : index]} : (i32) -> i32
+    %1 = vm.not.i32 %0 : i32
+    // CHECK-NEXT: %2 = emitc.call "vm_shl_i32"(%1) {args = [0 : index, 2 : i8]} : (i32) -> i32
+    %2 = vm.shl.i32 %1, 2 : i32
+    // CHECK-NEXT: vm.return %2 : i32
+    vm.return %2 : i32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: vm.func @arithmetic_f32
+vm.module @arithmetic_module {
+  vm.func @arithmetic_f32(%arg0: f32, %arg1: i32) -> f32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_cast_si32_f32"(%arg1) {args = [0 : index]} : (i32) -> f32
+    %0 = vm.cast.si32.f32 %arg1 : i32 -> f32
+    // CHECK-NEXT: %1 = emitc.call "vm_mul_f32"(%arg0, %0) {args = [0 : index, 1 : index]} : (f32, f32) -> f32
+    %1 = vm.mul.f32 %arg0, %0 : f32
+    // CHECK-NEXT: vm.return %1 : f32
+    vm.return %1 : f32
+  }
+}
@@ -0,0 +1,23 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='iree-convert-vm-to-emitc' %s | IreeFileCheck %s
+
+// CHECK-LABEL: vm.func @cmp_lt_i64_u
+vm.module @comparison_module {
+  vm.func @cmp_lt_i64_u(%arg0: i64, %arg1: i64) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_cmp_lt_i64_u"(%arg0, %arg1) {args = [0 : index, 1 : index]} : (i64, i64) -> i32
+    %0 = vm.cmp.lt.i64.u %arg0, %arg1 : i64
+    // CHECK-NEXT: vm.return %0 : i32
+    vm.return %0 : i32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: vm.func @select_i32
+vm.module @comparison_module {
+  vm.func @select_i32(%arg0: i32, %arg1: i32, %arg2: i32) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_select_i32"(%arg0, %arg1, %arg2) {args = [0 : index, 1 : index, 2 : index]} : (i32, i32, i32) -> i32
+    %0 = vm.select.i32 %arg0, %arg1, %arg2 : i32
+    // CHECK-NEXT: vm.return %0 : i32
+    vm.return %0 : i32
+  }
+}
@@ -60,16 +60,21 @@ struct VMOpAsmInterface : public OpAsmDialectInterface {
     }
     if (auto globalLoadOp = dyn_cast<GlobalLoadI32Op>(op)) {
       os << globalLoadOp.global();
+    } else if (auto globalLoadOp = dyn_cast<GlobalLoadF32Op>(op)) {
+      os << globalLoadOp.global();
     } else if (auto globalLoadOp = dyn_cast<GlobalLoadRefOp>(op)) {
       os << globalLoadOp.global();
     } else if (isa<ConstRefZeroOp>(op)) {
       os << "null";
-    } else if (isa<ConstI32ZeroOp>(op) || isa<ConstI64ZeroOp>(op)) {
+    } else if (isa<ConstI32ZeroOp>(op) || isa<ConstI64ZeroOp>(op) ||
+               isa<ConstF32ZeroOp>(op)) {
       os << "zero";
     } else if (auto constOp = dyn_cast<ConstI32Op>(op)) {
       getIntegerName(constOp.value().dyn_cast<IntegerAttr>(), os);
     } else if (auto constOp = dyn_cast<ConstI64Op>(op)) {
       getIntegerName(constOp.value().dyn_cast<IntegerAttr>(), os);
+    } else if (isa<ConstF32Op>(op)) {
+      os << "cst";
     } else if (auto rodataOp = dyn_cast<ConstRefRodataOp>(op)) {
       os << rodataOp.rodata();
     } else if (auto refType =
@@ -101,6 +106,20 @@ struct VMOpAsmInterface : public OpAsmDialectInterface {
       os << "ugte";
     } else if (isa<CmpNZI32Op>(op) || isa<CmpNZI64Op>(op)) {
       os << "nz";
+    } else if (isa<CmpEQF32Op>(op)) {
+      os << "feq";
+    } else if (isa<CmpNEF32Op>(op)) {
+      os << "fne";
+    } else if (isa<CmpLTF32Op>(op)) {
+      os << "flt";
+    } else if (isa<CmpLTEF32Op>(op)) {
+      os << "flte";
+    } else if (isa<CmpGTF32Op>(op)) {
+      os << "fgt";
+    } else if (isa<CmpGTEF32Op>(op)) {
+      os << "fgte";
+    } else if (isa<CmpNZF32Op>(op)) {
+      os << "fnz";
     } else if (isa<CmpEQRefOp>(op)) {
       os << "req";
     } else if (isa<CmpNERefOp>(op)) {
@@ -280,6 +299,12 @@ Operation *VMDialect::materializeConstant(OpBuilder &builder, Attribute value,
       return builder.create<VM::ConstI64ZeroOp>(loc);
     }
     return builder.create<VM::ConstI64Op>(loc, convertedValue);
+  } else if (ConstF32Op::isBuildableWith(value, type)) {
+    auto convertedValue = ConstF32Op::convertConstValue(value);
+    if (convertedValue.cast<FloatAttr>().getValue().isPosZero()) {
+      return builder.create<VM::ConstF32ZeroOp>(loc);
+    }
+    return builder.create<VM::ConstF32Op>(loc, convertedValue);
   } else if (type.isa<IREE::VM::RefType>()) {
     // The only constant type we support for ref_ptrs is null so we can just
     // emit that here.
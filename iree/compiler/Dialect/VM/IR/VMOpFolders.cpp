@@ -16,6 +16,7 @@
 
 #include "iree/compiler/Dialect/VM/IR/VMDialect.h"
 #include "iree/compiler/Dialect/VM/IR/VMOps.h"
+#include "llvm/ADT/APSInt.h"
 #include "llvm/ADT/StringExtras.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
@@ -58,6 +59,13 @@ Attribute oneOfType(Type type) {
   return {};
 }
 
+/// Returns true if |value| is a constant floating-point scalar equal to 1.0.
+bool isConstantFloatOne(Value value) {
+  FloatAttr attr;
+  return matchPattern(value, m_Constant(&attr)) &&
+         attr.getValue().isExactlyValue(1.0);
+}
+
 }  // namespace
 
 //===----------------------------------------------------------------------===//
@@ -105,8 +113,14 @@ struct DropDefaultConstGlobalOpInitializer : public OpRewritePattern<T> {
   LogicalResult matchAndRewrite(T op,
                                 PatternRewriter &rewriter) const override {
     if (!op.initial_value().hasValue()) return failure();
-    auto value = op.initial_valueAttr().template cast<IntegerAttr>();
-    if (value.getValue() != 0) return failure();
+    auto value = op.initial_valueAttr();
+    if (auto intValue = value.template dyn_cast<IntegerAttr>()) {
+      if (intValue.getValue() != 0) return failure();
+    } else if (auto floatValue = value.template dyn_cast<FloatAttr>()) {
+      if (!floatValue.getValue().isPosZero()) return failure();
+    } else {
+      return failure();
+    }
     rewriter.replaceOpWithNewOp<T>(op, op.sym_name(), op.is_mutable(),
                                    op.type(),
                                    llvm::to_vector<4>(op.getDialectAttrs()));
@@ -128,6 +142,12 @@ void GlobalI64Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
                  DropDefaultConstGlobalOpInitializer<GlobalI64Op>>(context);
 }
 
+void GlobalF32Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<InlineConstGlobalOpInitializer<GlobalF32Op>,
+                 DropDefaultConstGlobalOpInitializer<GlobalF32Op>>(context);
+}
+
 void GlobalRefOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                               MLIRContext *context) {
   results.insert<InlineConstGlobalOpInitializer<GlobalRefOp>>(context);
@@ -174,6 +194,13 @@ void GlobalLoadI64Op::getCanonicalizationPatterns(
       context);
 }
 
+void GlobalLoadF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<InlineConstGlobalLoadIntegerOp<GlobalLoadF32Op, GlobalF32Op,
+                                                ConstF32Op, ConstF32ZeroOp>>(
+      context);
+}
+
 namespace {
 
 /// Inlines immutable global constants into their loads.
@@ -234,6 +261,13 @@ void GlobalLoadIndirectI64Op::getCanonicalizationPatterns(
       context);
 }
 
+void GlobalLoadIndirectF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<
+      PropagateGlobalLoadAddress<GlobalLoadIndirectF32Op, GlobalLoadF32Op>>(
+      context);
+}
+
 void GlobalLoadIndirectRefOp::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
   results.insert<
@@ -275,6 +309,13 @@ void GlobalStoreIndirectI64Op::getCanonicalizationPatterns(
       context);
 }
 
+void GlobalStoreIndirectF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<
+      PropagateGlobalStoreAddress<GlobalStoreIndirectF32Op, GlobalStoreF32Op>>(
+      context);
+}
+
 void GlobalStoreIndirectRefOp::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
   results.insert<
@@ -298,6 +339,12 @@ OpFoldResult ConstI64ZeroOp::fold(ArrayRef<Attribute> operands) {
   return IntegerAttr::get(getResult().getType(), 0);
 }
 
+OpFoldResult ConstF32Op::fold(ArrayRef<Attribute> operands) { return value(); }
+
+OpFoldResult ConstF32ZeroOp::fold(ArrayRef<Attribute> operands) {
+  return FloatAttr::get(getResult().getType(), 0.0);
+}
+
 OpFoldResult ConstRefZeroOp::fold(ArrayRef<Attribute> operands) {
   // TODO(b/144027097): relace unit attr with a proper null ref_ptr attr.
   return UnitAttr::get(getContext());
@@ -334,6 +381,10 @@ OpFoldResult SelectI64Op::fold(ArrayRef<Attribute> operands) {
   return foldSelectOp(*this);
 }
 
+OpFoldResult SelectF32Op::fold(ArrayRef<Attribute> operands) {
+  return foldSelectOp(*this);
+}
+
 OpFoldResult SelectRefOp::fold(ArrayRef<Attribute> operands) {
   return foldSelectOp(*this);
 }
@@ -746,6 +797,70 @@ OpFoldResult ShrI64UOp::fold(ArrayRef<Attribute> operands) {
   return foldShrUOp(*this, operands);
 }
 
+//===----------------------------------------------------------------------===//
+// Native floating-point arithmetic
+//===----------------------------------------------------------------------===//
+// NOTE: identities like x + 0 = x do not hold for all IEEE values (-0 + 0 is
+// +0 and NaN payloads may change) so we only fold fully constant operands and
+// the exact identities x * 1 and x / 1.
+
+OpFoldResult AddF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(operands, [](APFloat a, APFloat b) {
+    a.add(b, APFloat::rmNearestTiesToEven);
+    return a;
+  });
+}
+
+OpFoldResult SubF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(operands, [](APFloat a, APFloat b) {
+    a.subtract(b, APFloat::rmNearestTiesToEven);
+    return a;
+  });
+}
+
+OpFoldResult MulF32Op::fold(ArrayRef<Attribute> operands) {
+  if (isConstantFloatOne(rhs())) {
+    // x * 1 = x or 1 * y = y (commutative)
+    return lhs();
+  }
+  return constFoldBinaryOp<FloatAttr>(operands, [](APFloat a, APFloat b) {
+    a.multiply(b, APFloat::rmNearestTiesToEven);
+    return a;
+  });
+}
+
+OpFoldResult DivF32Op::fold(ArrayRef<Attribute> operands) {
+  if (isConstantFloatOne(rhs())) {
+    // x / 1 = x
+    return lhs();
+  }
+  return constFoldBinaryOp<FloatAttr>(operands, [](APFloat a, APFloat b) {
+    a.divide(b, APFloat::rmNearestTiesToEven);
+    return a;
+  });
+}
+
+OpFoldResult RemF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(operands, [](APFloat a, APFloat b) {
+    a.mod(b);
+    return a;
+  });
+}
+
+OpFoldResult AbsF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryOp<FloatAttr>(operands,
+                                     [](APFloat a) { return llvm::abs(a); });
+}
+
+OpFoldResult NegF32Op::fold(ArrayRef<Attribute> operands) {
+  if (auto negOp = dyn_cast_or_null<NegF32Op>(operand().getDefiningOp())) {
+    // -(-x) = x
+    return negOp.operand();
+  }
+  return constFoldUnaryOp<FloatAttr>(operands,
+                                     [](APFloat a) { return llvm::neg(a); });
+}
+
 //===----------------------------------------------------------------------===//
 // Casting and type conversion/emulation
 //===----------------------------------------------------------------------===//
@@ -854,6 +969,51 @@ OpFoldResult ExtI32I64UOp::fold(ArrayRef<Attribute> operands) {
       [&](APInt a) { return a.zext(64); });
 }
 
+/// Folds an integer to floating-point cast of a constant operand.
+static Attribute constFoldIntToFloatOp(Type resultType,
+                                       ArrayRef<Attribute> operands,
+                                       bool isSigned) {
+  auto operand = operands[0].dyn_cast_or_null<IntegerAttr>();
+  if (!operand) return {};
+  APFloat result(resultType.cast<FloatType>().getFloatSemantics());
+  result.convertFromAPInt(operand.getValue(), isSigned,
+                          APFloat::rmNearestTiesToEven);
+  return FloatAttr::get(resultType, result);
+}
+
+/// Folds a floating-point to integer cast of a constant operand. Values that
+/// cannot be represented in the result type saturate and NaN folds to 0 to
+/// match the runtime.
+static Attribute constFoldFloatToIntOp(Type resultType,
+                                       ArrayRef<Attribute> operands,
+                                       bool isSigned) {
+  auto operand = operands[0].dyn_cast_or_null<FloatAttr>();
+  if (!operand) return {};
+  if (operand.getValue().isNaN()) return IntegerAttr::get(resultType, 0);
+  llvm::APSInt result(resultType.getIntOrFloatBitWidth(), !isSigned);
+  bool isExact = false;
+  // On overflow APFloat sets the result to the min/max of the integer type.
+  (void)operand.getValue().convertToInteger(result, APFloat::rmTowardZero,
+                                            &isExact);
+  return IntegerAttr::get(resultType, result);
+}
+
+OpFoldResult CastSI32F32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldIntToFloatOp(getType(), operands, /*isSigned=*/true);
+}
+
+OpFoldResult CastUI32F32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldIntToFloatOp(getType(), operands, /*isSigned=*/false);
+}
+
+OpFoldResult CastF32SI32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldFloatToIntOp(getType(), operands, /*isSigned=*/true);
+}
+
+OpFoldResult CastF32UI32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldFloatToIntOp(getType(), operands, /*isSigned=*/false);
+}
+
 namespace {
 
 template <typename SRC_OP, typename OP_A, int SZ_T, typename OP_B>
@@ -1319,6 +1479,75 @@ OpFoldResult CmpNZI64Op::fold(ArrayRef<Attribute> operands) {
       operands, [&](APInt a) { return APInt(64, a.getBoolValue()); });
 }
 
+/// Performs const folding of a floating-point comparison where `predicate`
+/// returns whether the given ordering satisfies the comparison.
+/// NOTE: x == x cannot be folded as NaN is never equal to itself.
+template <typename PredicateT>
+static Attribute constFoldCmpF32Op(Type resultType,
+                                   ArrayRef<Attribute> operands,
+                                   const PredicateT &predicate) {
+  auto lhs = operands[0].dyn_cast_or_null<FloatAttr>();
+  auto rhs = operands[1].dyn_cast_or_null<FloatAttr>();
+  if (!lhs || !rhs) return {};
+  bool result = predicate(lhs.getValue().compare(rhs.getValue()));
+  return IntegerAttr::get(resultType, result ? 1 : 0);
+}
+
+OpFoldResult CmpEQF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpF32Op(getType(), operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpEqual;
+  });
+}
+
+OpFoldResult CmpNEF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpF32Op(getType(), operands, [](APFloat::cmpResult r) {
+    return r != APFloat::cmpEqual;
+  });
+}
+
+OpFoldResult CmpLTF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpF32Op(getType(), operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpLessThan;
+  });
+}
+
+OpFoldResult CmpLTEF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpF32Op(getType(), operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpLessThan || r == APFloat::cmpEqual;
+  });
+}
+
+OpFoldResult CmpGTF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpF32Op(getType(), operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpGreaterThan;
+  });
+}
+
+void CmpGTF32Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                             MLIRContext *context) {
+  // NOTE: we can't use SwapInvertedCmpOps as !(a > b) != (a <= b) with NaNs.
+  results.insert<RewritePseudoCmpGTToLT<CmpGTF32Op, CmpLTF32Op>>(context);
+}
+
+OpFoldResult CmpGTEF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpF32Op(getType(), operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpGreaterThan || r == APFloat::cmpEqual;
+  });
+}
+
+void CmpGTEF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  // rhs <= lhs
+  results.insert<RewritePseudoCmpGTToLT<CmpGTEF32Op, CmpLTEF32Op>>(context);
+}
+
+OpFoldResult CmpNZF32Op::fold(ArrayRef<Attribute> operands) {
+  if (auto operand = operands[0].dyn_cast_or_null<FloatAttr>()) {
+    return IntegerAttr::get(getType(), operand.getValue().isZero() ? 0 : 1);
+  }
+  return {};
+}
+
 OpFoldResult CmpEQRefOp::fold(ArrayRef<Attribute> operands) {
   if (lhs() == rhs()) {
     // x == x = true
@@ -1699,7 +1928,7 @@ namespace {
 
 /// Rewrites a check op to a cmp and a cond_fail.
 template <typename CheckOp, typename CmpI32Op, typename CmpI64Op,
-          typename CmpRefOp>
+          typename CmpF32Op, typename CmpRefOp>
 struct RewriteCheckToCondFail : public OpRewritePattern<CheckOp> {
   using OpRewritePattern<CheckOp>::OpRewritePattern;
   LogicalResult matchAndRewrite(CheckOp op,
@@ -1719,6 +1948,10 @@ struct RewriteCheckToCondFail : public OpRewritePattern<CheckOp> {
       condValue = rewriter.template createOrFold<CmpI32Op>(
           op.getLoc(), ArrayRef<Type>{condType},
           op.getOperation()->getOperands());
+    } else if (operandType.isF32()) {
+      condValue = rewriter.template createOrFold<CmpF32Op>(
+          op.getLoc(), ArrayRef<Type>{condType},
+          op.getOperation()->getOperands());
     } else {
       return failure();
     }
@@ -1738,22 +1971,22 @@ struct RewriteCheckToCondFail : public OpRewritePattern<CheckOp> {
 void CheckEQOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                             MLIRContext *context) {
   results.insert<
-      RewriteCheckToCondFail<CheckEQOp, CmpEQI32Op, CmpEQI64Op, CmpEQRefOp>>(
-      context);
+      RewriteCheckToCondFail<CheckEQOp, CmpEQI32Op, CmpEQI64Op, CmpEQF32Op,
+                             CmpEQRefOp>>(context);
 }
 
 void CheckNEOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                             MLIRContext *context) {
   results.insert<
-      RewriteCheckToCondFail<CheckNEOp, CmpNEI32Op, CmpNEI64Op, CmpNERefOp>>(
-      context);
+      RewriteCheckToCondFail<CheckNEOp, CmpNEI32Op, CmpNEI64Op, CmpNEF32Op,
+                             CmpNERefOp>>(context);
 }
 
 void CheckNZOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                             MLIRContext *context) {
   results.insert<
-      RewriteCheckToCondFail<CheckNZOp, CmpNZI32Op, CmpNZI64Op, CmpNZRefOp>>(
-      context);
+      RewriteCheckToCondFail<CheckNZOp, CmpNZI32Op, CmpNZI64Op, CmpNZF32Op,
+                             CmpNZRefOp>>(context);
 }
 
 //===----------------------------------------------------------------------===//
@@ -368,7 +368,7 @@ static void printGlobalOp(OpAsmPrinter &p, Operation *op) {
     p.printSymbolName(initializer.getValue());
     p << ')';
   }
-  if (auto initialValue = op->getAttrOfType<IntegerAttr>("initial_value")) {
+  if (auto initialValue = op->getAttr("initial_value")) {
     p << ' ';
     p.printAttribute(initialValue);
   } else {
@@ -591,6 +591,93 @@ void ConstI64Op::build(OpBuilder &builder, OperationState &result,
   return build(builder, result, builder.getI64IntegerAttr(value));
 }
 
+template <typename T>
+static ParseResult parseConstFloatOp(OpAsmParser &parser,
+                                     OperationState *result) {
+  Attribute valueAttr;
+  NamedAttrList dummyAttrs;
+  if (failed(parser.parseAttribute(valueAttr, "value", dummyAttrs))) {
+    return parser.emitError(parser.getCurrentLocation())
+           << "Invalid attribute encoding";
+  }
+  if (!T::isBuildableWith(valueAttr, valueAttr.getType())) {
+    return parser.emitError(parser.getCurrentLocation())
+           << "Incompatible type or invalid type value formatting";
+  }
+  valueAttr = T::convertConstValue(valueAttr);
+  result->addAttribute("value", valueAttr);
+  if (failed(parser.parseOptionalAttrDict(result->attributes))) {
+    return parser.emitError(parser.getCurrentLocation())
+           << "Failed to parse optional attribute dict";
+  }
+  return parser.addTypeToList(valueAttr.getType(), result->types);
+}
+
+template <typename T>
+static void printConstFloatOp(OpAsmPrinter &p, T &op) {
+  p << op.getOperationName() << ' ';
+  p.printAttribute(op.value());
+  p.printOptionalAttrDict(op.getAttrs(), /*elidedAttrs=*/{"value"});
+}
+
+template <int SZ>
+static bool isConstFloatBuildableWith(Attribute value, Type type) {
+  // The attribute must have the same type as 'type'.
+  if (value.getType() != type) {
+    return false;
+  }
+  if (auto floatAttr = value.dyn_cast<FloatAttr>()) {
+    return floatAttr.getType().isF32() && SZ == 32;
+  } else if (auto elementsAttr = value.dyn_cast<ElementsAttr>()) {
+    return elementsAttr.getType().getElementType().isF32() && SZ == 32;
+  }
+  return false;
+}
+
+template <int SZ>
+static Attribute convertConstFloatValue(Attribute value) {
+  assert(isConstFloatBuildableWith<SZ>(value, value.getType()));
+  Builder builder(value.getContext());
+  auto floatType = builder.getF32Type();
+  int32_t dims = 1;
+  if (auto v = value.dyn_cast<FloatAttr>()) {
+    return FloatAttr::get(floatType, v.getValue());
+  } else if (auto v = value.dyn_cast<ElementsAttr>()) {
+    dims = v.getNumElements();
+    ShapedType adjustedType = VectorType::get({dims}, floatType);
+    if (auto elements = v.dyn_cast<SplatElementsAttr>()) {
+      return SplatElementsAttr::get(adjustedType, elements.getSplatValue());
+    } else {
+      return DenseElementsAttr::get(
+          adjustedType, llvm::to_vector<4>(v.getValues<Attribute>()));
+    }
+  }
+  llvm_unreachable("unexpected attribute type");
+  return Attribute();
+}
+
+// static
+bool ConstF32Op::isBuildableWith(Attribute value, Type type) {
+  return isConstFloatBuildableWith<32>(value, type);
+}
+
+// static
+Attribute ConstF32Op::convertConstValue(Attribute value) {
+  return convertConstFloatValue<32>(value);
+}
+
+void ConstF32Op::build(OpBuilder &builder, OperationState &result,
+                       Attribute value) {
+  Attribute newValue = convertConstValue(value);
+  result.addAttribute("value", newValue);
+  result.addTypes(newValue.getType());
+}
+
+void ConstF32Op::build(OpBuilder &builder, OperationState &result,
+                       float value) {
+  return build(builder, result, builder.getF32FloatAttr(value));
+}
+
 void ConstI32ZeroOp::build(OpBuilder &builder, OperationState &result) {
   result.addTypes(builder.getIntegerType(32));
 }
@@ -599,6 +686,10 @@ void ConstI64ZeroOp::build(OpBuilder &builder, OperationState &result) {
   result.addTypes(builder.getIntegerType(64));
 }
 
+void ConstF32ZeroOp::build(OpBuilder &builder, OperationState &result) {
+  result.addTypes(builder.getF32Type());
+}
+
 void ConstRefZeroOp::build(OpBuilder &builder, OperationState &result,
                            Type objectType) {
   result.addTypes(objectType);
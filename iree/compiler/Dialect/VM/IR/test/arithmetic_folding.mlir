@@ -370,3 +370,44 @@ vm.module @shr_i32_u_folds {
     vm.return %0 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @arithmetic_f32_folds
+vm.module @arithmetic_f32_folds {
+  // CHECK-LABEL: @add_f32_const
+  vm.func @add_f32_const() -> f32 {
+    // CHECK: %cst = vm.const.f32 5.000000e+00 : f32
+    // CHECK-NEXT: vm.return %cst : f32
+    %c1 = vm.const.f32 1.5 : f32
+    %c4 = vm.const.f32 3.5 : f32
+    %0 = vm.add.f32 %c1, %c4 : f32
+    vm.return %0 : f32
+  }
+
+  // CHECK-LABEL: @add_f32_x_0
+  vm.func @add_f32_x_0(%arg0 : f32) -> f32 {
+    // -0.0 + 0.0 = +0.0 so this cannot be folded away.
+    // CHECK: %[[ADD:.+]] = vm.add.f32
+    // CHECK-NEXT: vm.return %[[ADD]] : f32
+    %zero = vm.const.f32.zero : f32
+    %0 = vm.add.f32 %arg0, %zero : f32
+    vm.return %0 : f32
+  }
+
+  // CHECK-LABEL: @mul_f32_x_1
+  vm.func @mul_f32_x_1(%arg0 : f32) -> f32 {
+    // CHECK: vm.return %arg0 : f32
+    %c1 = vm.const.f32 1.0 : f32
+    %0 = vm.mul.f32 %arg0, %c1 : f32
+    vm.return %0 : f32
+  }
+
+  // CHECK-LABEL: @neg_f32_neg
+  vm.func @neg_f32_neg(%arg0 : f32) -> f32 {
+    // CHECK: vm.return %arg0 : f32
+    %0 = vm.neg.f32 %arg0 : f32
+    %1 = vm.neg.f32 %0 : f32
+    vm.return %1 : f32
+  }
+}
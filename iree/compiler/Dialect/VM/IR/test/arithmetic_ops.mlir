@@ -153,3 +153,40 @@ vm.module @my_module {
     vm.return %0 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @arithmetic_f32
+vm.module @my_module {
+  vm.func @arithmetic_f32(%arg0 : f32, %arg1 : f32) -> f32 {
+    // CHECK: %0 = vm.add.f32 %arg0, %arg1 : f32
+    %0 = vm.add.f32 %arg0, %arg1 : f32
+    // CHECK-NEXT: %1 = vm.sub.f32 %0, %arg1 : f32
+    %1 = vm.sub.f32 %0, %arg1 : f32
+    // CHECK-NEXT: %2 = vm.mul.f32 %1, %arg1 : f32
+    %2 = vm.mul.f32 %1, %arg1 : f32
+    // CHECK-NEXT: %3 = vm.div.f32 %2, %arg1 : f32
+    %3 = vm.div.f32 %2, %arg1 : f32
+    // CHECK-NEXT: %4 = vm.rem.f32 %3, %arg1 : f32
+    %4 = vm.rem.f32 %3, %arg1 : f32
+    // CHECK-NEXT: %5 = vm.abs.f32 %4 : f32
+    %5 = vm.abs.f32 %4 : f32
+    // CHECK-NEXT: %6 = vm.neg.f32 %5 : f32
+    %6 = vm.neg.f32 %5 : f32
+    // CHECK-NEXT: %7 = vm.ceil.f32 %6 : f32
+    %7 = vm.ceil.f32 %6 : f32
+    // CHECK-NEXT: %8 = vm.floor.f32 %7 : f32
+    %8 = vm.floor.f32 %7 : f32
+    // CHECK-NEXT: %9 = vm.sqrt.f32 %8 : f32
+    %9 = vm.sqrt.f32 %8 : f32
+    // CHECK-NEXT: %10 = vm.rsqrt.f32 %9 : f32
+    %10 = vm.rsqrt.f32 %9 : f32
+    // CHECK-NEXT: %11 = vm.exp.f32 %10 : f32
+    %11 = vm.exp.f32 %10 : f32
+    // CHECK-NEXT: %12 = vm.log.f32 %11 : f32
+    %12 = vm.log.f32 %11 : f32
+    // CHECK-NEXT: %13 = vm.tanh.f32 %12 : f32
+    %13 = vm.tanh.f32 %12 : f32
+    vm.return %13 : f32
+  }
+}
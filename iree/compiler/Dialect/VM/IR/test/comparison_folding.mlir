@@ -450,3 +450,43 @@ vm.module @cmp_nz_ref_folds {
     vm.return %ne : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @cmp_f32_folds
+vm.module @cmp_f32_folds {
+  // CHECK-LABEL: @const_lt
+  vm.func @const_lt() -> i32 {
+    // CHECK: %c1 = vm.const.i32 1 : i32
+    // CHECK-NEXT: vm.return %c1 : i32
+    %c1 = vm.const.f32 1.0 : f32
+    %c2 = vm.const.f32 2.0 : f32
+    %cmp = vm.cmp.lt.f32 %c1, %c2 : f32
+    vm.return %cmp : i32
+  }
+
+  // CHECK-LABEL: @self_eq
+  vm.func @self_eq(%arg0 : f32) -> i32 {
+    // NaN != NaN so this cannot be folded to true.
+    // CHECK: %feq = vm.cmp.eq.f32 %arg0, %arg0 : f32
+    // CHECK-NEXT: vm.return %feq : i32
+    %eq = vm.cmp.eq.f32 %arg0, %arg0 : f32
+    vm.return %eq : i32
+  }
+
+  // CHECK-LABEL: @gt_to_lt
+  vm.func @gt_to_lt(%arg0 : f32, %arg1 : f32) -> i32 {
+    // CHECK: %flt = vm.cmp.lt.f32 %arg1, %arg0 : f32
+    // CHECK-NEXT: vm.return %flt : i32
+    %cmp = vm.cmp.gt.f32 %arg0, %arg1 : f32
+    vm.return %cmp : i32
+  }
+
+  // CHECK-LABEL: @gte_to_lte
+  vm.func @gte_to_lte(%arg0 : f32, %arg1 : f32) -> i32 {
+    // CHECK: %flte = vm.cmp.lte.f32 %arg1, %arg0 : f32
+    // CHECK-NEXT: vm.return %flte : i32
+    %cmp = vm.cmp.gte.f32 %arg0, %arg1 : f32
+    vm.return %cmp : i32
+  }
+}
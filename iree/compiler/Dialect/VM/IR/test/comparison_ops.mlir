@@ -155,3 +155,26 @@ vm.module @my_module {
     vm.return %rnz : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @cmp_f32
+vm.module @my_module {
+  vm.func @cmp_f32(%arg0 : f32, %arg1 : f32) {
+    // CHECK: %feq = vm.cmp.eq.f32 %arg0, %arg1 : f32
+    %feq = vm.cmp.eq.f32 %arg0, %arg1 : f32
+    // CHECK-NEXT: %fne = vm.cmp.ne.f32 %arg0, %arg1 : f32
+    %fne = vm.cmp.ne.f32 %arg0, %arg1 : f32
+    // CHECK-NEXT: %flt = vm.cmp.lt.f32 %arg0, %arg1 : f32
+    %flt = vm.cmp.lt.f32 %arg0, %arg1 : f32
+    // CHECK-NEXT: %flte = vm.cmp.lte.f32 %arg0, %arg1 : f32
+    %flte = vm.cmp.lte.f32 %arg0, %arg1 : f32
+    // CHECK-NEXT: %fgt = vm.cmp.gt.f32 %arg0, %arg1 : f32
+    %fgt = vm.cmp.gt.f32 %arg0, %arg1 : f32
+    // CHECK-NEXT: %fgte = vm.cmp.gte.f32 %arg0, %arg1 : f32
+    %fgte = vm.cmp.gte.f32 %arg0, %arg1 : f32
+    // CHECK-NEXT: %fnz = vm.cmp.nz.f32 %arg0 : f32
+    %fnz = vm.cmp.nz.f32 %arg0 : f32
+    vm.return
+  }
+}
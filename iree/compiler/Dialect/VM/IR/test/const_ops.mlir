@@ -44,3 +44,16 @@ vm.module @my_module {
     vm.return %buf0 : !vm.ref<!iree.byte_buffer>
   }
 }
+
+// -----
+
+vm.module @my_module {
+  // CHECK-LABEL: @const_f32
+  vm.func @const_f32() -> (f32, f32) {
+    // CHECK: %zero = vm.const.f32.zero : f32
+    %zero = vm.const.f32.zero : f32
+    // CHECK: %cst = vm.const.f32 1.500000e+00 : f32
+    %cst = vm.const.f32 1.5 : f32
+    vm.return %zero, %cst : f32, f32
+  }
+}
@@ -139,3 +139,40 @@ vm.module @ext_folds_i64 {
     vm.return %0 : i64
   }
 }
+
+// -----
+
+// CHECK-LABEL: @cast_folds_f32
+vm.module @cast_folds_f32 {
+  // CHECK-LABEL: @cast_f32_si32_const
+  vm.func @cast_f32_si32_const() -> i32 {
+    // CHECK: vm.const.i32 -3 : i32
+    %c = vm.const.f32 -3.75 : f32
+    %0 = vm.cast.f32.si32 %c : f32 -> i32
+    vm.return %0 : i32
+  }
+
+  // CHECK-LABEL: @cast_f32_si32_saturate
+  vm.func @cast_f32_si32_saturate() -> (i32, i32) {
+    // CHECK-DAG: %[[MAX:.+]] = vm.const.i32 2147483647 : i32
+    // CHECK-DAG: %[[MIN:.+]] = vm.const.i32 -2147483648 : i32
+    %c0 = vm.const.f32 3.0e9 : f32
+    %0 = vm.cast.f32.si32 %c0 : f32 -> i32
+    %c1 = vm.const.f32 -3.0e9 : f32
+    %1 = vm.cast.f32.si32 %c1 : f32 -> i32
+    // CHECK: vm.return %[[MAX]], %[[MIN]] : i32, i32
+    vm.return %0, %1 : i32, i32
+  }
+
+  // CHECK-LABEL: @cast_f32_ui32_saturate
+  vm.func @cast_f32_ui32_saturate() -> (i32, i32) {
+    // CHECK-DAG: %[[MAX:.+]] = vm.const.i32 -1 : i32
+    // CHECK-DAG: %[[ZERO:.+]] = vm.const.i32.zero : i32
+    %c0 = vm.const.f32 5.0e9 : f32
+    %0 = vm.cast.f32.ui32 %c0 : f32 -> i32
+    %c1 = vm.const.f32 -1.5 : f32
+    %1 = vm.cast.f32.ui32 %c1 : f32 -> i32
+    // CHECK: vm.return %[[MAX]], %[[ZERO]] : i32, i32
+    vm.return %0, %1 : i32, i32
+  }
+}
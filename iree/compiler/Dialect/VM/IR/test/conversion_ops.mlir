@@ -65,3 +65,24 @@ vm.module @my_module {
     vm.return %5 : i64
   }
 }
+
+// -----
+
+// CHECK-LABEL: @cast_f32
+vm.module @my_module {
+  vm.func @cast_f32(%arg0 : i32, %arg1 : f32) {
+    // CHECK-NEXT: %0 = vm.cast.si32.f32 %arg0 : i32 -> f32
+    %0 = vm.cast.si32.f32 %arg0 : i32 -> f32
+    // CHECK-NEXT: %1 = vm.cast.ui32.f32 %arg0 : i32 -> f32
+    %1 = vm.cast.ui32.f32 %arg0 : i32 -> f32
+    // CHECK-NEXT: %2 = vm.cast.f32.si32 %arg1 : f32 -> i32
+    %2 = vm.cast.f32.si32 %arg1 : f32 -> i32
+    // CHECK-NEXT: %3 = vm.cast.f32.ui32 %arg1 : f32 -> i32
+    %3 = vm.cast.f32.ui32 %arg1 : f32 -> i32
+    // CHECK-NEXT: %4 = vm.bitcast.i32.f32 %arg0 : i32 -> f32
+    %4 = vm.bitcast.i32.f32 %arg0 : i32 -> f32
+    // CHECK-NEXT: %5 = vm.bitcast.f32.i32 %arg1 : f32 -> i32
+    %5 = vm.bitcast.f32.i32 %arg1 : f32 -> i32
+    vm.return
+  }
+}
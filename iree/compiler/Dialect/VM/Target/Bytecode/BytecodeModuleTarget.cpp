@@ -30,6 +30,7 @@
 #include "iree/compiler/Dialect/VM/Transforms/Passes.h"
 #include "iree/schemas/bytecode_module_def_generated.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/Module.h"
@@ -222,6 +223,7 @@ static Optional<Offset<Vector<T>>> createOptionalVector(
 //
 // Examples:
 //  i32              -> i
+//  f32              -> f
 //  !vm.ref<...>     -> r
 //  tuple<i32, i64>  -> iI
 static LogicalResult encodeCallingConventionType(Operation *op, Type type,
@@ -239,6 +241,15 @@ static LogicalResult encodeCallingConventionType(Operation *op, Type type,
         s.push_back('I');
         return success();
     }
+  } else if (auto floatType = type.dyn_cast<FloatType>()) {
+    switch (floatType.getWidth()) {
+      case 32:
+        s.push_back('f');
+        return success();
+      default:
+        return op->emitError()
+               << "unsupported external calling convention type " << type;
+    }
   } else if (auto tupleType = type.dyn_cast<TupleType>()) {
     // Flatten tuple (so tuple<i32, i64> -> `...iI...`).
     SmallVector<Type, 4> flattenedTypes;
@@ -460,7 +471,8 @@ static Offset<iree::vm::BytecodeModuleDef> buildFlatBufferModule(
   rodataContentOffsets.reserve(rodataOps.size());
   for (auto rodataOp : rodataOps) {
     auto dataOffset =
-        serializeConstant(rodataOp.getLoc(), rodataOp.value(), fbb);
+        serializeConstant(rodataOp.getLoc(), rodataOp.value(),
+                          targetOptions.rodataAlignment, fbb);
     if (dataOffset.IsNull()) {
       rodataOp.emitOpError() << "failed to encode";
       return {};
@@ -609,6 +621,13 @@ static Offset<iree::vm::BytecodeModuleDef> buildFlatBufferModule(
 LogicalResult translateModuleToBytecode(IREE::VM::ModuleOp moduleOp,
                                         BytecodeTargetOptions targetOptions,
                                         llvm::raw_ostream &output) {
+  if (targetOptions.rodataAlignment <= 0 ||
+      !llvm::isPowerOf2_32(targetOptions.rodataAlignment)) {
+    return moduleOp.emitError()
+           << "rodata alignment must be a power of two; got "
+           << targetOptions.rodataAlignment;
+  }
+
   if (failed(canonicalizeModule(targetOptions, moduleOp))) {
     return moduleOp.emitError()
            << "failed to canonicalize vm.module to a serializable form";
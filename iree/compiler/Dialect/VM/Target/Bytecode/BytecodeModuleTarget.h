@@ -53,6 +53,12 @@ struct BytecodeTargetOptions {
   bool stripSourceMap = false;
   // Strips vm ops with the VM_DebugOnly trait.
   bool stripDebugOps = false;
+
+  // Byte alignment of the contents of each rodata segment relative to the
+  // start of the module. Must be a power of two. When the module is loaded at
+  // an address with at least this alignment (such as when memory-mapped) the
+  // runtime can use rodata in-place as typed or SIMD-aligned storage.
+  int rodataAlignment = 64;
 };
 
 // Translates a vm.module to a bytecode module flatbuffer.
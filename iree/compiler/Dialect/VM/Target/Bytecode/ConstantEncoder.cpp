@@ -81,6 +81,19 @@ static Offset<Vector<uint8_t>> serializeConstantI64Array(
   return byteVector;
 }
 
+// Serializes 16-bit floats (f16 or bf16) by their raw bit patterns.
+static Offset<Vector<uint8_t>> serializeConstantF16Array(
+    DenseFPElementsAttr attr, FlatBufferBuilder &fbb) {
+  uint8_t *bytePtr = nullptr;
+  auto byteVector =
+      fbb.CreateUninitializedVector(attr.getNumElements() * 2, &bytePtr);
+  uint16_t *nativePtr = reinterpret_cast<uint16_t *>(bytePtr);
+  for (const APFloat &value : attr.getFloatValues()) {
+    *(nativePtr++) = value.bitcastToAPInt().extractBitsAsZExtValue(16, 0);
+  }
+  return byteVector;
+}
+
 static Offset<Vector<uint8_t>> serializeConstantF32Array(
     DenseFPElementsAttr attr, FlatBufferBuilder &fbb) {
   uint8_t *bytePtr = nullptr;
@@ -107,7 +120,17 @@ static Offset<Vector<uint8_t>> serializeConstantF64Array(
 
 Offset<Vector<uint8_t>> serializeConstant(Location loc,
                                           ElementsAttr elementsAttr,
+                                          size_t alignment,
                                           FlatBufferBuilder &fbb) {
+  // Pad ahead of the vector so that its contents (following the length prefix)
+  // start at the requested alignment. FlatBuffers are built back to front and
+  // the finished buffer is padded to the largest alignment used so this holds
+  // relative to the start of the final buffer as well.
+  int64_t elementByteWidth =
+      (elementsAttr.getType().getElementTypeBitWidth() + 7) / 8;
+  fbb.ForceVectorAlignment(elementsAttr.getNumElements() * elementByteWidth,
+                           sizeof(uint8_t), alignment);
+
   if (auto attr = elementsAttr.dyn_cast<DenseIntElementsAttr>()) {
     switch (attr.getType().getElementTypeBitWidth()) {
       case 8:
@@ -125,6 +148,8 @@ Offset<Vector<uint8_t>> serializeConstant(Location loc,
     }
   } else if (auto attr = elementsAttr.dyn_cast<DenseFPElementsAttr>()) {
     switch (attr.getType().getElementTypeBitWidth()) {
+      case 16:
+        return serializeConstantF16Array(attr, fbb);
       case 32:
         return serializeConstantF32Array(attr, fbb);
       case 64:
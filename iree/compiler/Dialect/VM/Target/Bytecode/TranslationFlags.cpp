@@ -66,6 +66,13 @@ static llvm::cl::opt<bool> stripDebugOpsFlag{
     llvm::cl::init(false),
 };
 
+static llvm::cl::opt<int> rodataAlignmentFlag{
+    "iree-vm-bytecode-module-rodata-alignment",
+    llvm::cl::desc("Byte alignment of rodata segment contents (such as 64 for "
+                   "cache lines/SIMD or 4096 for pages)"),
+    llvm::cl::init(64),
+};
+
 BytecodeTargetOptions getBytecodeTargetOptionsFromFlags() {
   BytecodeTargetOptions targetOptions;
   targetOptions.outputFormat = outputFormatFlag;
@@ -73,6 +80,7 @@ BytecodeTargetOptions getBytecodeTargetOptionsFromFlags() {
   targetOptions.stripSymbols = stripSymbolsFlag;
   targetOptions.stripSourceMap = stripSourceMapFlag;
   targetOptions.stripDebugOps = stripDebugOpsFlag;
+  targetOptions.rodataAlignment = rodataAlignmentFlag;
   return targetOptions;
 }
 
@@ -0,0 +1,7 @@
+// RUN: iree-translate -iree-vm-ir-to-bytecode-module -iree-vm-bytecode-module-rodata-alignment=48 -verify-diagnostics %s
+// RUN: iree-translate -iree-vm-ir-to-bytecode-module -iree-vm-bytecode-module-rodata-alignment=0 -verify-diagnostics %s
+
+// expected-error @+1 {{rodata alignment must be a power of two}}
+vm.module @rodata_alignment {
+  vm.rodata @buffer dense<[1, 2, 3]> : tensor<3xi8>
+}
@@ -14,32 +14,1421 @@
 
 #include "iree/compiler/Dialect/VM/Target/C/CModuleTarget.h"
 
+#include <algorithm>
+
+#include "emitc/Dialect/EmitC/EmitCDialect.h"
+#include "iree/compiler/Dialect/IREE/IR/IREEOps.h"
+#include "iree/compiler/Dialect/IREE/IR/IREETypes.h"
+#include "iree/compiler/Dialect/IREE/Transforms/Passes.h"
 #include "iree/compiler/Dialect/VM/Conversion/VMToEmitC/ConvertVMToEmitC.h"
+#include "iree/compiler/Dialect/VM/IR/VMDialect.h"
+#include "iree/compiler/Dialect/VM/Transforms/Passes.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Format.h"
+#include "mlir/IR/SymbolTable.h"
 #include "mlir/Pass/PassManager.h"
+#include "mlir/Transforms/DialectConversion.h"
+#include "mlir/Transforms/Passes.h"
 
 namespace mlir {
 namespace iree_compiler {
 namespace IREE {
 namespace VM {
 
-LogicalResult translateModuleToC(IREE::VM::ModuleOp moduleOp,
-                                 llvm::raw_ostream &output) {
-  // TODO: implement translation
-  output << "// c module stub\n";
+namespace {
 
-  return success();
+bool isRefType(Type type) { return type.isa<IREE::VM::RefType>(); }
+
+// Maps a VM value type to the C type used to hold it.
+Optional<StringRef> getCType(Type type) {
+  if (isRefType(type)) {
+    return StringRef("iree_vm_ref_t");
+  } else if (auto integerType = type.dyn_cast<IntegerType>()) {
+    switch (integerType.getWidth()) {
+      case 32:
+        return StringRef("int32_t");
+      case 64:
+        return StringRef("int64_t");
+      default:
+        return None;
+    }
+  } else if (type.isF32()) {
+    return StringRef("float");
+  } else if (type.isa<IREE::PtrType>()) {
+    // Global addresses are byte offsets into the module rwdata.
+    return StringRef("int32_t");
+  }
+  return None;
 }
 
-LogicalResult translateModuleToC(mlir::ModuleOp outerModuleOp,
-                                 llvm::raw_ostream &output) {
-  PassManager pm(outerModuleOp.getContext());
+// Returns the calling convention character used for |type| (see
+// iree/vm/module.h).
+Optional<char> getCallingConventionChar(Type type) {
+  if (isRefType(type)) {
+    return 'r';
+  } else if (auto integerType = type.dyn_cast<IntegerType>()) {
+    switch (integerType.getWidth()) {
+      case 32:
+        return 'i';
+      case 64:
+        return 'I';
+      default:
+        return None;
+    }
+  } else if (type.isF32()) {
+    return 'f';
+  }
+  return None;
+}
+
+// Returns a calling convention string (like `0ii.i`) for |functionType|.
+Optional<std::string> makeCallingConventionString(FunctionType functionType) {
+  if (functionType.getNumInputs() == 0 && functionType.getNumResults() == 0) {
+    return std::string{};  // Valid but empty.
+  }
+  std::string s = "0";
+  for (auto type : functionType.getInputs()) {
+    auto c = getCallingConventionChar(type);
+    if (!c.hasValue()) return None;
+    s.push_back(c.getValue());
+  }
+  if (functionType.getNumResults() > 0) {
+    s.push_back('.');
+    for (auto type : functionType.getResults()) {
+      auto c = getCallingConventionChar(type);
+      if (!c.hasValue()) return None;
+      s.push_back(c.getValue());
+    }
+  }
+  return s;
+}
+
+// Returns the number of bytes the primitive |type| occupies in a packed
+// argument or result buffer.
+size_t getCallingConventionSize(Type type) {
+  return type.isInteger(64) ? sizeof(int64_t) : sizeof(int32_t);
+}
+
+// A byte offset (or size) within a packed argument or result buffer.
+// Refs are counted separately as sizeof(iree_vm_ref_t) depends on the target
+// the generated C is compiled for.
+struct AbiOffset {
+  void advance(Type type) {
+    if (isRefType(type)) {
+      ++refs;
+    } else {
+      bytes += getCallingConventionSize(type);
+    }
+  }
+  bool empty() const { return !bytes && !refs; }
+
+  size_t bytes = 0;
+  size_t refs = 0;
+};
+
+llvm::raw_ostream &operator<<(llvm::raw_ostream &os, const AbiOffset &offset) {
+  os << offset.bytes;
+  if (offset.refs) os << " + " << offset.refs << " * sizeof(iree_vm_ref_t)";
+  return os;
+}
+
+// Returns |name| with all characters that are invalid in C identifiers
+// replaced by underscores.
+std::string makeCIdentifier(StringRef name) {
+  std::string result = name.str();
+  for (auto &c : result) {
+    if (!llvm::isAlnum(c)) c = '_';
+  }
+  return result;
+}
+
+// Returns the name of the iree/vm/ops.h function implementing |op|.
+std::string getOpsCalleeName(Operation *op) {
+  return makeCIdentifier(op->getName().getStringRef());
+}
+
+// Prints |value| as a quoted C string literal.
+void printCStringLiteral(StringRef value, llvm::raw_ostream &output) {
+  output << '"';
+  output.write_escaped(value, /*UseHexEscapes=*/true);
+  output << '"';
+}
+
+// Prints |value| as a constant iree_string_view_t initializer. Unlike
+// iree_make_cstring_view this can be used in static tables.
+void printCStringView(StringRef value, llvm::raw_ostream &output) {
+  output << '{';
+  printCStringLiteral(value, output);
+  output << ", " << value.size() << '}';
+}
+
+// Prints a C literal for the integer or float constant |attr|.
+LogicalResult printCLiteral(Operation *op, Attribute attr,
+                            llvm::raw_ostream &output) {
+  if (auto integerAttr = attr.dyn_cast<IntegerAttr>()) {
+    int64_t value = integerAttr.getValue().getSExtValue();
+    if (integerAttr.getType().isInteger(64)) {
+      if (value == INT64_MIN) {
+        output << "INT64_MIN";
+      } else {
+        output << "INT64_C(" << value << ")";
+      }
+    } else if (value == INT32_MIN) {
+      output << "INT32_MIN";
+    } else {
+      output << value;
+    }
+    return success();
+  } else if (auto floatAttr = attr.dyn_cast<FloatAttr>()) {
+    APFloat value = floatAttr.getValue();
+    if (!value.isFinite()) {
+      // Non-finite values are passed through their bit pattern so that we
+      // don't depend on <math.h> macros and preserve NaN payloads.
+      output << "vm_bitcast_i32_f32((int32_t)"
+             << llvm::format_hex(
+                    value.bitcastToAPInt().getZExtValue(), /*Width=*/10)
+             << "u)";
+      return success();
+    }
+    // 9 significant digits are enough to round-trip any f32.
+    SmallString<32> str;
+    llvm::raw_svector_ostream(str)
+        << llvm::format("%.9g", value.convertToFloat());
+    if (str.find_first_of(".e") == StringRef::npos) str += ".0";
+    output << str << "f";
+    return success();
+  }
+  return op->emitOpError() << "unsupported constant value " << attr;
+}
+
+// Serializes the contents of |rodataOp| in the same host byte order the
+// bytecode target uses for its rodata segments.
+LogicalResult serializeRodata(IREE::VM::RodataOp rodataOp,
+                              std::vector<uint8_t> &bytes) {
+  ElementsAttr elementsAttr = rodataOp.value();
+  unsigned bitWidth = elementsAttr.getType().getElementTypeBitWidth();
+  if (bitWidth != 8 && bitWidth != 16 && bitWidth != 32 && bitWidth != 64) {
+    return rodataOp.emitOpError() << "unhandled element bitwidth " << bitWidth;
+  }
+  auto appendValue = [&](const APInt &value) {
+    for (unsigned i = 0; i < bitWidth / 8; ++i) {
+      bytes.push_back(value.extractBitsAsZExtValue(8, i * 8));
+    }
+  };
+  if (auto attr = elementsAttr.dyn_cast<DenseIntElementsAttr>()) {
+    for (const APInt &value : attr.getIntValues()) appendValue(value);
+    return success();
+  } else if (auto attr = elementsAttr.dyn_cast<DenseFPElementsAttr>()) {
+    for (const APFloat &value : attr.getFloatValues()) {
+      appendValue(value.bitcastToAPInt());
+    }
+    return success();
+  }
+  return rodataOp.emitOpError()
+         << "unimplemented attribute encoding: " << elementsAttr.getType();
+}
+
+// Returns the name |type| is registered with in the runtime ref type registry
+// (see iree_vm_ref_lookup_registered_type).
+std::string getRefTypeName(IREE::VM::RefType refType) {
+  Type objectType = refType.getObjectType();
+  if (objectType.isa<IREE::VM::ListType>()) {
+    // Lists are registered once regardless of their element type.
+    return "vm.list";
+  }
+  std::string name;
+  llvm::raw_string_ostream stream(name);
+  objectType.print(stream);
+  stream.flush();
+  return StringRef(name).ltrim('!').str();
+}
+
+// Emits the C source for a single vm.module that has been canonicalized and
+// converted to the EmitC dialect.
+//
+// The output is a native module built on iree/vm/native_module.h that shares
+// the per-op semantics of the bytecode interpreter via iree/vm/ops.h.
+class CModuleEmitter {
+ public:
+  CModuleEmitter(IREE::VM::ModuleOp moduleOp, llvm::raw_ostream &output)
+      : moduleOp(moduleOp),
+        symbolTable(moduleOp),
+        output(output),
+        moduleName(makeCIdentifier(moduleOp.getName())) {}
+
+  LogicalResult emit() {
+    // Gather structural ops and module-level storage requirements.
+    for (auto &op : moduleOp.getBlock().getOperations()) {
+      if (auto funcOp = dyn_cast<IREE::VM::FuncOp>(op)) {
+        funcOps.push_back(funcOp);
+      } else if (auto exportOp = dyn_cast<IREE::VM::ExportOp>(op)) {
+        exportOps.push_back(exportOp);
+      } else if (auto importOp = dyn_cast<IREE::VM::ImportOp>(op)) {
+        importOps.push_back(importOp);
+      } else if (auto rodataOp = dyn_cast<IREE::VM::RodataOp>(op)) {
+        rodataOps.push_back(rodataOp);
+      } else if (auto globalOp = dyn_cast<IREE::VM::GlobalRefOp>(op)) {
+        // Ref globals are allocated ordinals separate from the rwdata bytes.
+        refGlobalCount =
+            std::max(refGlobalCount, (size_t)globalOp.getOrdinal() + 1);
+      } else if (auto globalOp = dyn_cast<VMGlobalOp>(op)) {
+        globalBytes =
+            std::max(globalBytes,
+                     globalOp.getOrdinal() + globalOp.getStorageSize());
+      } else if (!isa<IREE::VM::ModuleTerminatorOp>(op)) {
+        return op.emitOpError() << "not supported by the C module target";
+      }
+    }
+    // Imports and exports are looked up with a binary search so they must be
+    // sorted by name. Imports are resolved into state->imports in this order.
+    llvm::sort(importOps, [](IREE::VM::ImportOp lhs, IREE::VM::ImportOp rhs) {
+      return lhs.getName() < rhs.getName();
+    });
+    llvm::sort(exportOps, [](IREE::VM::ExportOp lhs, IREE::VM::ExportOp rhs) {
+      return lhs.export_name() < rhs.export_name();
+    });
+    // Rodata is indexed by the ordinal assigned during ordinal allocation.
+    llvm::sort(rodataOps, [](IREE::VM::RodataOp lhs, IREE::VM::RodataOp rhs) {
+      return lhs.ordinal().getValue().getLimitedValue() <
+             rhs.ordinal().getValue().getLimitedValue();
+    });
+    // Ref types (such as those of list elements) are resolved by name when the
+    // module state is allocated.
+    for (auto funcOp : funcOps) {
+      funcOp.walk([&](IREE::VM::ListAllocOp listAllocOp) {
+        auto elementType = listAllocOp.result()
+                               .getType()
+                               .cast<IREE::VM::RefType>()
+                               .getObjectType()
+                               .cast<IREE::VM::ListType>()
+                               .getElementType();
+        auto refType = elementType.dyn_cast_or_null<IREE::VM::RefType>();
+        if (refType &&
+            !refType.getObjectType().isa<IREE::VM::OpaqueType>()) {
+          getRefTypeOrdinal(refType);
+        }
+      });
+    }
+
+    emitPrologue();
+    emitStorageTypes();
+    if (failed(emitRodata())) return failure();
+    for (auto funcOp : funcOps) {
+      if (failed(emitFunctionSignature(funcOp))) return failure();
+      output << ";\n";
+    }
+    output << "\n";
+    if (!importOps.empty()) emitImportCallHelper();
+    for (auto funcOp : funcOps) {
+      if (failed(emitFunction(funcOp))) return failure();
+    }
+    for (auto exportOp : exportOps) {
+      if (failed(emitExportShim(exportOp))) return failure();
+    }
+    if (failed(emitDescriptor())) return failure();
+    emitModuleInterface();
+    output.flush();
+    return success();
+  }
+
+ private:
+  std::string getFunctionName(StringRef symbolName) {
+    return moduleName + "_" + makeCIdentifier(symbolName);
+  }
+
+  void emitPrologue() {
+    output << "// Native VM module generated from vm.module @"
+           << moduleOp.getName() << ".\n"
+           << "// Exposes `iree_status_t " << moduleName
+           << "_create(iree_allocator_t, iree_vm_module_t**)`.\n\n"
+           << "#include \"iree/base/alignment.h\"\n"
+           << "#include \"iree/vm/api.h\"\n"
+           << "#include \"iree/vm/native_module.h\"\n"
+           << "#include \"iree/vm/ops.h\"\n\n";
+  }
+
+  void emitStorageTypes() {
+    // Shared module storage; nothing beyond the allocator is required as all
+    // mutable data lives in the per-context state.
+    output << "typedef struct {\n"
+           << "  iree_allocator_t allocator;\n"
+           << "} " << moduleName << "_t;\n\n";
+
+    output << "typedef struct {\n"
+           << "  iree_allocator_t allocator;\n";
+    if (globalBytes) {
+      output << "  uint8_t rwdata[" << globalBytes << "];\n";
+    }
+    if (refGlobalCount) {
+      output << "  iree_vm_ref_t refs[" << refGlobalCount << "];\n";
+    }
+    if (!rodataOps.empty()) {
+      output << "  iree_vm_ro_byte_buffer_t rodata[" << rodataOps.size()
+             << "];\n";
+    }
+    if (!refTypeNames.empty()) {
+      output << "  iree_vm_type_def_t types[" << refTypeNames.size() << "];\n";
+    }
+    if (!importOps.empty()) {
+      output << "  iree_vm_function_t imports[" << importOps.size() << "];\n";
+    }
+    output << "} " << moduleName << "_state_t;\n\n";
+  }
+
+  std::string getRodataName(int ordinal) {
+    return moduleName + "_rodata_" + std::to_string(ordinal) + "_";
+  }
+
+  // Emits the contents of each vm.rodata as a static array. The module state
+  // wraps these in iree_vm_ro_byte_buffer_t refs without copying them.
+  LogicalResult emitRodata() {
+    for (auto rodataOp : llvm::enumerate(rodataOps)) {
+      std::vector<uint8_t> bytes;
+      if (failed(serializeRodata(rodataOp.value(), bytes))) return failure();
+      rodataLengths.push_back(bytes.size());
+      // Match the default bytecode rodata alignment so consumers that map the
+      // data directly see the same alignment from either target. Zero-length
+      // arrays are not valid C so empty rodata gets a single padding byte.
+      if (bytes.empty()) bytes.push_back(0);
+      output << "static iree_alignas(64) const uint8_t "
+             << getRodataName(rodataOp.index()) << "[" << bytes.size()
+             << "] = {";
+      for (auto byte : llvm::enumerate(bytes)) {
+        output << (byte.index() % 16 ? " " : "\n    ")
+               << llvm::format_hex(byte.value(), /*Width=*/4) << ",";
+      }
+      output << "\n};\n\n";
+    }
+    return success();
+  }
+
+  int getRefTypeOrdinal(IREE::VM::RefType refType) {
+    auto name = getRefTypeName(refType);
+    auto it = llvm::find(refTypeNames, name);
+    if (it != refTypeNames.end()) return it - refTypeNames.begin();
+    refTypeNames.push_back(name);
+    return refTypeNames.size() - 1;
+  }
+
+  LogicalResult emitFunctionSignature(IREE::VM::FuncOp funcOp) {
+    output << "static iree_status_t " << getFunctionName(funcOp.getName())
+           << "(iree_vm_stack_t* stack, " << moduleName
+           << "_state_t* state";
+    auto functionType = funcOp.getType();
+    for (auto input : llvm::enumerate(functionType.getInputs())) {
+      auto cType = getCType(input.value());
+      if (!cType.hasValue()) {
+        return funcOp.emitOpError()
+               << "argument type " << input.value()
+               << " not supported by the C module target";
+      }
+      // Ref arguments are borrowed from the caller.
+      output << ", " << cType.getValue() << (isRefType(input.value()) ? "*" : "")
+             << " arg" << input.index();
+    }
+    for (auto result : llvm::enumerate(functionType.getResults())) {
+      auto cType = getCType(result.value());
+      if (!cType.hasValue()) {
+        return funcOp.emitOpError()
+               << "result type " << result.value()
+               << " not supported by the C module target";
+      }
+      output << ", " << cType.getValue() << "* out_ret" << result.index();
+    }
+    output << ")";
+    return success();
+  }
+
+  // Emits a helper that calls an import with packed argument/result buffers.
+  void emitImportCallHelper() {
+    output << "static iree_status_t " << moduleName
+           << "_call_import(iree_vm_stack_t* stack,\n"
+           << "    const iree_vm_function_t* import, iree_byte_span_t "
+              "arguments,\n"
+           << "    iree_byte_span_t results) {\n"
+           << "  iree_vm_function_call_t call;\n"
+           << "  call.function = *import;\n"
+           << "  call.arguments = arguments;\n"
+           << "  call.results = results;\n"
+           << "  iree_vm_execution_result_t result;\n"
+           << "  memset(&result, 0, sizeof(result));\n"
+           << "  IREE_RETURN_IF_ERROR(import->module->begin_call(\n"
+           << "      import->module->self, stack, &call, &result));\n"
+           << "  if (IREE_UNLIKELY(result.flags & "
+              "IREE_VM_EXECUTION_RESULT_FLAG_YIELDED)) {\n"
+           << "    // Native functions cannot suspend so the import would "
+              "need to be\n"
+           << "    // resumed from here until it completes.\n"
+           << "    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,\n"
+           << "                            \"yielding within imported "
+              "functions is not \"\n"
+           << "                            \"supported\");\n"
+           << "  }\n"
+           << "  return iree_ok_status();\n"
+           << "}\n\n";
+  }
+
+  LogicalResult emitFunction(IREE::VM::FuncOp funcOp) {
+    valueNames.clear();
+    blockNames.clear();
+    refLocals.clear();
+
+    if (failed(emitFunctionSignature(funcOp))) return failure();
+    output << " {\n";
+
+    // Name all values and declare locals up-front so that gotos never jump
+    // past an initialization.
+    int nextValue = 0;
+    int nextBlock = 0;
+    for (auto &block : funcOp.getBlocks()) {
+      if (block.isEntryBlock()) {
+        for (auto arg : llvm::enumerate(block.getArguments())) {
+          auto name = "arg" + std::to_string(arg.index());
+          valueNames[arg.value()] =
+              isRefType(arg.value().getType()) ? "(*" + name + ")" : name;
+        }
+      } else {
+        blockNames[&block] = "bb" + std::to_string(++nextBlock);
+        for (auto arg : block.getArguments()) {
+          if (failed(declareLocal(funcOp, arg, nextValue))) return failure();
+        }
+      }
+      for (auto &op : block.getOperations()) {
+        for (auto result : op.getResults()) {
+          if (failed(declareLocal(&op, result, nextValue))) return failure();
+        }
+      }
+    }
+    // Ref locals hold references that must be released on every exit so all
+    // returns funnel through a common cleanup block.
+    if (!refLocals.empty()) {
+      output << "  iree_status_t status = iree_ok_status();\n";
+    }
+
+    for (auto &block : funcOp.getBlocks()) {
+      if (!block.isEntryBlock()) {
+        output << blockNames[&block] << ":\n";
+      }
+      for (auto &op : block.getOperations()) {
+        if (failed(emitOp(&op))) return failure();
+      }
+    }
+
+    if (!refLocals.empty()) {
+      output << "cleanup:\n";
+      for (auto &name : refLocals) {
+        output << "  iree_vm_ref_release(&" << name << ");\n";
+      }
+      output << "  return status;\n";
+    }
+    output << "}\n\n";
+    return success();
+  }
+
+  // Emits a return of the iree_status_t |expr| from the current function.
+  void emitReturnStatus(StringRef expr, StringRef indent) {
+    if (refLocals.empty()) {
+      output << indent << "return " << expr << ";\n";
+    } else {
+      output << indent << "status = " << expr << ";\n"
+             << indent << "goto cleanup;\n";
+    }
+  }
 
-  pm.addPass(createConvertVMToEmitCPass());
+  // Emits |expr| and returns its iree_status_t from the current function if
+  // it fails.
+  void emitCheckedStatus(StringRef expr, StringRef indent = "  ") {
+    if (refLocals.empty()) {
+      output << indent << "IREE_RETURN_IF_ERROR(" << expr << ");\n";
+    } else {
+      output << indent << "status = " << expr << ";\n"
+             << indent << "if (!iree_status_is_ok(status)) goto cleanup;\n";
+    }
+  }
+
+  LogicalResult declareLocal(Operation *op, Value value, int &nextValue) {
+    auto cType = getCType(value.getType());
+    if (!cType.hasValue()) {
+      return op->emitOpError() << "value type " << value.getType()
+                               << " not supported by the C module target";
+    }
+    auto name = "v" + std::to_string(nextValue++);
+    if (isRefType(value.getType())) {
+      output << "  " << cType.getValue() << " " << name << " = {0};\n";
+      refLocals.push_back(name);
+    } else {
+      output << "  " << cType.getValue() << " " << name << ";\n";
+    }
+    valueNames[value] = name;
+    return success();
+  }
+
+  StringRef getName(Value value) { return valueNames[value]; }
+
+  // Returns a C expression of the address of the ref |value|.
+  std::string getRefAddress(Value value) {
+    return "&" + getName(value).str();
+  }
+
+  LogicalResult getGlobalOrdinal(Operation *op, StringRef globalName,
+                                 int &ordinal) {
+    auto globalOp =
+        dyn_cast_or_null<VMGlobalOp>(symbolTable.lookup(globalName));
+    if (!globalOp) {
+      return op->emitOpError() << "global " << globalName << " not found";
+    }
+    ordinal = globalOp.getOrdinal();
+    return success();
+  }
+
+  // Emits a bounds check for indirect accesses through a global address.
+  LogicalResult emitGlobalBoundsCheck(Operation *op, Value address,
+                                      Type valueType) {
+    if (!globalBytes) {
+      return op->emitOpError()
+             << "indirect global access in a module with no globals";
+    }
+    output << "  if (IREE_UNLIKELY((uint64_t)(uint32_t)" << getName(address)
+           << " + " << getCallingConventionSize(valueType) << " > "
+           << globalBytes << ")) {\n";
+    emitReturnStatus(
+        "iree_make_status(IREE_STATUS_OUT_OF_RANGE,\n"
+        "                            \"global byte offset out of range\")",
+        "    ");
+    output << "  }\n";
+    return success();
+  }
+
+  // Assigns |operands| to the block arguments of |dest| and jumps to it.
+  // Values are staged through temporaries as the operands may themselves be
+  // arguments of |dest|.
+  void emitBranch(Block *dest, OperandRange operands, StringRef indent) {
+    if (!operands.empty()) {
+      output << indent << "{\n";
+      for (auto operand : llvm::enumerate(operands)) {
+        if (isRefType(operand.value().getType())) {
+          output << indent << "  iree_vm_ref_t t" << operand.index()
+                 << " = {0};\n"
+                 << indent << "  vm_ref_retain("
+                 << getRefAddress(operand.value()) << ", &t"
+                 << operand.index() << ");\n";
+        } else {
+          output << indent << "  "
+                 << getCType(operand.value().getType()).getValue() << " t"
+                 << operand.index() << " = " << getName(operand.value())
+                 << ";\n";
+        }
+      }
+      for (auto operand : llvm::enumerate(operands)) {
+        Value arg = dest->getArgument(operand.index());
+        if (isRefType(arg.getType())) {
+          output << indent << "  iree_vm_ref_move(&t" << operand.index()
+                 << ", " << getRefAddress(arg) << ");\n";
+        } else {
+          output << indent << "  " << getName(arg) << " = t" << operand.index()
+                 << ";\n";
+        }
+      }
+      output << indent << "}\n";
+    }
+    output << indent << "goto " << blockNames[dest] << ";\n";
+  }
+
+  LogicalResult emitOp(Operation *op) {
+    if (auto callOp = dyn_cast<mlir::emitc::CallOp>(op)) {
+      return emitCallOp(callOp);
+    }
+
+    // Constants.
+    if (isa<IREE::VM::ConstI32Op>(op) || isa<IREE::VM::ConstI64Op>(op) ||
+        isa<IREE::VM::ConstF32Op>(op)) {
+      output << "  " << getName(op->getResult(0)) << " = ";
+      if (failed(printCLiteral(op, op->getAttr("value"), output))) {
+        return failure();
+      }
+      output << ";\n";
+      return success();
+    } else if (isa<IREE::VM::ConstI32ZeroOp>(op) ||
+               isa<IREE::VM::ConstI64ZeroOp>(op) ||
+               isa<IREE::VM::ConstF32ZeroOp>(op)) {
+      output << "  " << getName(op->getResult(0)) << " = 0;\n";
+      return success();
+    } else if (auto constOp = dyn_cast<IREE::VM::ConstRefZeroOp>(op)) {
+      output << "  vm_const_ref_zero(" << getRefAddress(constOp.result())
+             << ");\n";
+      return success();
+    } else if (auto constOp = dyn_cast<IREE::VM::ConstRefRodataOp>(op)) {
+      auto rodataOp =
+          symbolTable.lookup<IREE::VM::RodataOp>(constOp.rodata());
+      if (!rodataOp) {
+        return op->emitOpError()
+               << "rodata " << constOp.rodata() << " not found";
+      }
+      emitCheckedStatus("vm_const_ref_rodata(&state->rodata[" +
+                        std::to_string(rodataOp.ordinal()
+                                           .getValue()
+                                           .getLimitedValue()) +
+                        "], " + getRefAddress(constOp.value()) + ")");
+      return success();
+    }
+
+    // Globals.
+    if (auto addressOp = dyn_cast<IREE::VM::GlobalAddressOp>(op)) {
+      int ordinal = 0;
+      if (failed(getGlobalOrdinal(op, addressOp.global(), ordinal))) {
+        return failure();
+      }
+      output << "  " << getName(addressOp.result()) << " = " << ordinal
+             << ";\n";
+      return success();
+    } else if (isa<IREE::VM::GlobalLoadI32Op>(op) ||
+               isa<IREE::VM::GlobalLoadI64Op>(op) ||
+               isa<IREE::VM::GlobalLoadF32Op>(op)) {
+      int ordinal = 0;
+      if (failed(getGlobalOrdinal(
+              op, op->getAttrOfType<FlatSymbolRefAttr>("global").getValue(),
+              ordinal))) {
+        return failure();
+      }
+      output << "  " << getName(op->getResult(0)) << " = "
+             << makeCIdentifier(op->getName().getStringRef())
+             << "(state->rwdata, " << ordinal << ");\n";
+      return success();
+    } else if (isa<IREE::VM::GlobalStoreI32Op>(op) ||
+               isa<IREE::VM::GlobalStoreI64Op>(op) ||
+               isa<IREE::VM::GlobalStoreF32Op>(op)) {
+      int ordinal = 0;
+      if (failed(getGlobalOrdinal(
+              op, op->getAttrOfType<FlatSymbolRefAttr>("global").getValue(),
+              ordinal))) {
+        return failure();
+      }
+      output << "  " << makeCIdentifier(op->getName().getStringRef())
+             << "(state->rwdata, " << ordinal << ", "
+             << getName(op->getOperand(0)) << ");\n";
+      return success();
+    } else if (auto loadOp = dyn_cast<IREE::VM::GlobalLoadRefOp>(op)) {
+      int ordinal = 0;
+      if (failed(getGlobalOrdinal(op, loadOp.global(), ordinal))) {
+        return failure();
+      }
+      output << "  vm_global_load_ref(&state->refs[" << ordinal << "], "
+             << getRefAddress(loadOp.value()) << ");\n";
+      return success();
+    } else if (auto storeOp = dyn_cast<IREE::VM::GlobalStoreRefOp>(op)) {
+      int ordinal = 0;
+      if (failed(getGlobalOrdinal(op, storeOp.global(), ordinal))) {
+        return failure();
+      }
+      output << "  vm_global_store_ref(&state->refs[" << ordinal << "], "
+             << getRefAddress(storeOp.value()) << ");\n";
+      return success();
+    } else if (isa<IREE::VM::GlobalLoadIndirectI32Op>(op) ||
+               isa<IREE::VM::GlobalLoadIndirectI64Op>(op) ||
+               isa<IREE::VM::GlobalLoadIndirectF32Op>(op)) {
+      Value address = op->getOperand(0);
+      Value result = op->getResult(0);
+      if (failed(emitGlobalBoundsCheck(op, address, result.getType()))) {
+        return failure();
+      }
+      return emitIndirectGlobalAccess(op, address, result, /*isStore=*/false);
+    } else if (isa<IREE::VM::GlobalStoreIndirectI32Op>(op) ||
+               isa<IREE::VM::GlobalStoreIndirectI64Op>(op) ||
+               isa<IREE::VM::GlobalStoreIndirectF32Op>(op)) {
+      Value value = op->getOperand(0);
+      Value address = op->getOperand(1);
+      if (failed(emitGlobalBoundsCheck(op, address, value.getType()))) {
+        return failure();
+      }
+      return emitIndirectGlobalAccess(op, address, value, /*isStore=*/true);
+    }
+
+    // Lists.
+    if (auto allocOp = dyn_cast<IREE::VM::ListAllocOp>(op)) {
+      auto elementType = allocOp.result()
+                             .getType()
+                             .cast<IREE::VM::RefType>()
+                             .getObjectType()
+                             .cast<IREE::VM::ListType>()
+                             .getElementType();
+      emitCheckedStatus("vm_list_alloc(" + getTypeDef(elementType) + ", " +
+                        getName(allocOp.initial_capacity()).str() +
+                        ", state->allocator, " +
+                        getRefAddress(allocOp.result()) + ")");
+      return success();
+    } else if (isa<IREE::VM::ListReserveOp>(op) ||
+               isa<IREE::VM::ListResizeOp>(op) ||
+               isa<IREE::VM::ListSetI32Op>(op) ||
+               isa<IREE::VM::ListSetI64Op>(op) ||
+               isa<IREE::VM::ListSetF32Op>(op) ||
+               isa<IREE::VM::ListSizeOp>(op) ||
+               isa<IREE::VM::ListGetI32Op>(op) ||
+               isa<IREE::VM::ListGetI64Op>(op) ||
+               isa<IREE::VM::ListGetF32Op>(op) ||
+               isa<IREE::VM::ListGetRefOp>(op) ||
+               isa<IREE::VM::ListSetRefOp>(op)) {
+      // The list is always the first operand and results are returned
+      // through out parameters.
+      std::string call = getOpsCalleeName(op) + "(";
+      llvm::raw_string_ostream stream(call);
+      llvm::interleaveComma(op->getOperands(), stream, [&](Value operand) {
+        if (isRefType(operand.getType())) {
+          stream << getRefAddress(operand);
+        } else {
+          stream << getName(operand);
+        }
+      });
+      for (auto result : op->getResults()) {
+        stream << ", &" << getName(result);
+      }
+      stream << ")";
+      emitCheckedStatus(stream.str());
+      return success();
+    }
+
+    // Conditional assignment.
+    if (auto selectOp = dyn_cast<IREE::VM::SelectRefOp>(op)) {
+      output << "  vm_select_ref(" << getName(selectOp.condition()) << ", "
+             << getRefAddress(selectOp.true_value()) << ", "
+             << getRefAddress(selectOp.false_value()) << ", "
+             << getRefAddress(selectOp.result()) << ");\n";
+      return success();
+    } else if (auto switchOp = dyn_cast<IREE::VM::SwitchRefOp>(op)) {
+      std::string result = getRefAddress(switchOp.result());
+      output << "  switch (" << getName(switchOp.index()) << ") {\n";
+      for (auto value : llvm::enumerate(switchOp.values())) {
+        output << "    case " << value.index() << ":\n"
+               << "      vm_ref_retain(" << getRefAddress(value.value())
+               << ", " << result << ");\n"
+               << "      break;\n";
+      }
+      output << "    default:\n"
+             << "      vm_ref_retain("
+             << getRefAddress(switchOp.default_value()) << ", " << result
+             << ");\n"
+             << "      break;\n"
+             << "  }\n";
+      return success();
+    } else if (isa<IREE::VM::SwitchI32Op>(op) ||
+               isa<IREE::VM::SwitchI64Op>(op)) {
+      StringRef result = getName(op->getResult(0));
+      output << "  switch (" << getName(op->getOperand(0)) << ") {\n";
+      for (auto value : llvm::enumerate(op->getOperands().drop_front(2))) {
+        output << "    case " << value.index() << ":\n"
+               << "      " << result << " = " << getName(value.value())
+               << ";\n"
+               << "      break;\n";
+      }
+      output << "    default:\n"
+             << "      " << result << " = " << getName(op->getOperand(1))
+             << ";\n"
+             << "      break;\n"
+             << "  }\n";
+      return success();
+    }
+
+    // Ref comparison.
+    if (isa<IREE::VM::CmpEQRefOp>(op) || isa<IREE::VM::CmpNERefOp>(op) ||
+        isa<IREE::VM::CmpNZRefOp>(op)) {
+      output << "  " << getName(op->getResult(0)) << " = "
+             << getOpsCalleeName(op) << "(";
+      llvm::interleaveComma(op->getOperands(), output, [&](Value operand) {
+        output << getRefAddress(operand);
+      });
+      output << ");\n";
+      return success();
+    }
 
-  if (failed(pm.run(outerModuleOp))) {
-    return failure();
+    // Control flow.
+    if (auto branchOp = dyn_cast<IREE::VM::BranchOp>(op)) {
+      emitBranch(branchOp.getDest(), branchOp.getOperands(), "  ");
+      return success();
+    } else if (auto condBranchOp = dyn_cast<IREE::VM::CondBranchOp>(op)) {
+      output << "  if (" << getName(condBranchOp.condition()) << ") {\n";
+      emitBranch(condBranchOp.getTrueDest(), condBranchOp.trueDestOperands(),
+                 "    ");
+      output << "  } else {\n";
+      emitBranch(condBranchOp.getFalseDest(),
+                 condBranchOp.falseDestOperands(), "    ");
+      output << "  }\n";
+      return success();
+    } else if (auto callOp = dyn_cast<IREE::VM::CallOp>(op)) {
+      return emitVMCallOp(callOp);
+    } else if (auto returnOp = dyn_cast<IREE::VM::ReturnOp>(op)) {
+      for (auto operand : llvm::enumerate(returnOp.getOperands())) {
+        if (isRefType(operand.value().getType())) {
+          output << "  vm_ref_retain(" << getRefAddress(operand.value())
+                 << ", out_ret" << operand.index() << ");\n";
+        } else {
+          output << "  *out_ret" << operand.index() << " = "
+                 << getName(operand.value()) << ";\n";
+        }
+      }
+      if (refLocals.empty()) {
+        output << "  return iree_ok_status();\n";
+      } else {
+        output << "  goto cleanup;\n";
+      }
+      return success();
+    } else if (auto failOp = dyn_cast<IREE::VM::FailOp>(op)) {
+      std::string status;
+      llvm::raw_string_ostream stream(status);
+      stream << "iree_status_allocate((iree_status_code_t)"
+             << getName(failOp.status()) << ", \"<vm>\", 0,\n"
+             << "                              iree_make_cstring_view(";
+      printCStringLiteral(failOp.message().getValueOr(""), stream);
+      stream << ")";
+      emitReturnStatus(stream.str(), "  ");
+      return success();
+    } else if (isa<IREE::VM::YieldOp>(op)) {
+      // Native functions run to completion and cannot suspend; a yield is only
+      // a scheduling hint and there is nothing to resume from.
+      return success();
+    }
+
+    // Debugging; these match the (currently no-op) interpreter behavior.
+    if (isa<IREE::VM::TraceOp>(op) || isa<IREE::VM::PrintOp>(op)) {
+      return success();
+    } else if (auto breakOp = dyn_cast<IREE::VM::BreakOp>(op)) {
+      emitBranch(breakOp.getDest(), breakOp.getOperands(), "  ");
+      return success();
+    } else if (auto condBreakOp = dyn_cast<IREE::VM::CondBreakOp>(op)) {
+      emitBranch(condBreakOp.getDest(), condBreakOp.destOperands(), "  ");
+      return success();
+    }
+
+    return op->emitOpError() << "not supported by the C module target";
+  }
+
+  // Returns a C expression of the iree_vm_type_def_t for list elements of
+  // |type|.
+  std::string getTypeDef(Type type) {
+    if (auto integerType = type.dyn_cast_or_null<IntegerType>()) {
+      return "iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_I" +
+             std::to_string(integerType.getWidth()) + ")";
+    } else if (type && type.isF32()) {
+      return "iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_F32)";
+    } else if (type && type.isF64()) {
+      return "iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_F64)";
+    } else if (auto refType = type.dyn_cast_or_null<IREE::VM::RefType>()) {
+      // Lists of !vm.ref<?> may hold any ref type.
+      if (refType.getObjectType().isa<IREE::VM::OpaqueType>()) {
+        return "iree_vm_type_def_make_variant_type()";
+      }
+      return "state->types[" + std::to_string(getRefTypeOrdinal(refType)) +
+             "]";
+    }
+    return "iree_vm_type_def_make_variant_type()";
+  }
+
+  LogicalResult emitIndirectGlobalAccess(Operation *op, Value address,
+                                         Value value, bool isStore) {
+    StringRef suffix = value.getType().isF32()
+                           ? "f32"
+                           : value.getType().isInteger(64) ? "i64" : "i32";
+    if (isStore) {
+      output << "  vm_global_store_" << suffix << "(state->rwdata, (uint32_t)"
+             << getName(address) << ", " << getName(value) << ");\n";
+    } else {
+      output << "  " << getName(value) << " = vm_global_load_" << suffix
+             << "(state->rwdata, (uint32_t)" << getName(address) << ");\n";
+    }
+    return success();
+  }
+
+  LogicalResult emitCallOp(mlir::emitc::CallOp callOp) {
+    output << "  ";
+    if (callOp.getNumResults() == 1) {
+      output << getName(callOp.getResult(0)) << " = ";
+    }
+    output << callOp.callee() << "(";
+    if (auto args = callOp.args()) {
+      llvm::interleaveComma(*args, output, [&](Attribute arg) {
+        auto integerAttr = arg.dyn_cast<IntegerAttr>();
+        if (integerAttr && integerAttr.getType().isIndex()) {
+          output << getName(callOp.getOperand(integerAttr.getInt()));
+        } else {
+          (void)printCLiteral(callOp, arg, output);
+        }
+      });
+    } else {
+      llvm::interleaveComma(callOp.getOperands(), output,
+                            [&](Value operand) { output << getName(operand); });
+    }
+    output << ");\n";
+    return success();
+  }
+
+  LogicalResult emitVMCallOp(IREE::VM::CallOp callOp) {
+    auto *calleeOp = symbolTable.lookup(callOp.callee());
+    if (auto funcOp = dyn_cast_or_null<IREE::VM::FuncOp>(calleeOp)) {
+      std::string call = getFunctionName(funcOp.getName()) + "(stack, state";
+      llvm::raw_string_ostream stream(call);
+      for (auto operand : callOp.getOperands()) {
+        stream << ", "
+               << (isRefType(operand.getType()) ? getRefAddress(operand)
+                                                : getName(operand).str());
+      }
+      for (auto result : callOp.getResults()) {
+        stream << ", &" << getName(result);
+      }
+      stream << ")";
+      emitCheckedStatus(stream.str());
+      return success();
+    }
+
+    auto importOp = dyn_cast_or_null<IREE::VM::ImportOp>(calleeOp);
+    if (!importOp) {
+      return callOp.emitOpError()
+             << "callee " << callOp.callee() << " not found";
+    }
+    if (!makeCallingConventionString(importOp.getType()).hasValue()) {
+      return callOp.emitOpError()
+             << "import signature not supported by the C module target";
+    }
+
+    // Pack arguments and results into buffers per the VM calling convention.
+    // The callee takes ownership of ref arguments and returns ref results
+    // retained.
+    AbiOffset argumentsSize;
+    for (auto operand : callOp.getOperands()) {
+      argumentsSize.advance(operand.getType());
+    }
+    AbiOffset resultsSize;
+    for (auto result : callOp.getResults()) {
+      resultsSize.advance(result.getType());
+    }
+    output << "  {\n";
+    if (!argumentsSize.empty()) {
+      output << "    uint8_t arguments[" << argumentsSize << "];\n";
+    }
+    if (!resultsSize.empty()) {
+      output << "    uint8_t results[" << resultsSize << "];\n";
+    }
+    if (resultsSize.refs) {
+      output << "    memset(results, 0, sizeof(results));\n";
+    }
+    AbiOffset offset;
+    for (auto operand : llvm::enumerate(callOp.getOperands())) {
+      if (isRefType(operand.value().getType())) {
+        output << "    {\n"
+               << "      iree_vm_ref_t arg = {0};\n"
+               << "      vm_ref_retain(" << getRefAddress(operand.value())
+               << ", &arg);\n"
+               << "      memcpy(arguments + " << offset
+               << ", &arg, sizeof(arg));\n"
+               << "    }\n";
+      } else {
+        output << "    memcpy(arguments + " << offset << ", &"
+               << getName(operand.value()) << ", sizeof("
+               << getName(operand.value()) << "));\n";
+      }
+      offset.advance(operand.value().getType());
+    }
+    std::string call;
+    llvm::raw_string_ostream stream(call);
+    stream << moduleName << "_call_import(\n"
+           << "        stack, &state->imports["
+           << llvm::find(importOps, importOp) - importOps.begin() << "],\n"
+           << "        "
+           << (!argumentsSize.empty()
+                   ? "iree_make_byte_span(arguments, sizeof(arguments))"
+                   : "iree_make_byte_span(NULL, 0)")
+           << ",\n"
+           << "        "
+           << (!resultsSize.empty()
+                   ? "iree_make_byte_span(results, sizeof(results))"
+                   : "iree_make_byte_span(NULL, 0)")
+           << ")";
+    emitCheckedStatus(stream.str(), "    ");
+    offset = AbiOffset();
+    for (auto result : callOp.getResults()) {
+      if (isRefType(result.getType())) {
+        output << "    {\n"
+               << "      iree_vm_ref_t ret;\n"
+               << "      memcpy(&ret, results + " << offset
+               << ", sizeof(ret));\n"
+               << "      iree_vm_ref_move(&ret, " << getRefAddress(result)
+               << ");\n"
+               << "    }\n";
+      } else {
+        output << "    memcpy(&" << getName(result) << ", results + "
+               << offset << ", sizeof(" << getName(result) << "));\n";
+      }
+      offset.advance(result.getType());
+    }
+    output << "  }\n";
+    return success();
   }
 
+  // Emits the shim that unpacks VM ABI buffers and calls an exported function.
+  LogicalResult emitExportShim(IREE::VM::ExportOp exportOp) {
+    auto funcOp = symbolTable.lookup<IREE::VM::FuncOp>(exportOp.function_ref());
+    if (!funcOp) {
+      return exportOp.emitOpError()
+             << "exported function " << exportOp.function_ref()
+             << " not found";
+    }
+    auto functionType = funcOp.getType();
+    AbiOffset argumentsSize;
+    for (auto type : functionType.getInputs()) argumentsSize.advance(type);
+    AbiOffset resultsSize;
+    for (auto type : functionType.getResults()) resultsSize.advance(type);
+    bool hasRefs = argumentsSize.refs || resultsSize.refs;
+
+    output << "static iree_status_t " << getShimName(exportOp)
+           << "(iree_vm_stack_t* stack,\n"
+           << "    const iree_vm_function_call_t* call,\n"
+           << "    iree_vm_native_function_target_t target_fn, void* module,\n"
+           << "    void* module_state, iree_vm_execution_result_t* "
+              "out_result) {\n";
+    output << "  if (IREE_UNLIKELY(call->arguments.data_length < "
+           << argumentsSize << " ||\n"
+           << "                    call->results.data_length < "
+           << resultsSize << ")) {\n"
+           << "    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,\n"
+           << "                            \"argument/result buffers too "
+              "small\");\n"
+           << "  }\n";
+    // Ref arguments are moved out of the argument buffer as the callee takes
+    // ownership of them.
+    AbiOffset offset;
+    for (auto type : llvm::enumerate(functionType.getInputs())) {
+      output << "  " << getCType(type.value()).getValue() << " arg"
+             << type.index()
+             << ";\n"
+             << "  memcpy(&arg" << type.index() << ", call->arguments.data + "
+             << offset << ", sizeof(arg" << type.index() << "));\n";
+      if (isRefType(type.value())) {
+        output << "  memset(call->arguments.data + " << offset
+               << ", 0, sizeof(arg" << type.index() << "));\n";
+      }
+      offset.advance(type.value());
+    }
+    for (auto type : llvm::enumerate(functionType.getResults())) {
+      output << "  " << getCType(type.value()).getValue() << " ret"
+             << type.index()
+             << (isRefType(type.value()) ? " = {0}" : "") << ";\n";
+    }
+    std::string call;
+    llvm::raw_string_ostream stream(call);
+    stream << getFunctionName(funcOp.getName()) << "(\n"
+           << "      stack, (" << moduleName << "_state_t*)module_state";
+    for (auto type : llvm::enumerate(functionType.getInputs())) {
+      stream << (isRefType(type.value()) ? ", &arg" : ", arg") << type.index();
+    }
+    for (unsigned i = 0; i < functionType.getNumResults(); ++i) {
+      stream << ", &ret" << i;
+    }
+    stream << ")";
+    if (hasRefs) {
+      output << "  iree_status_t status = " << stream.str() << ";\n";
+      for (auto type : llvm::enumerate(functionType.getInputs())) {
+        if (!isRefType(type.value())) continue;
+        output << "  iree_vm_ref_release(&arg" << type.index() << ");\n";
+      }
+      output << "  if (!iree_status_is_ok(status)) {\n";
+      for (auto type : llvm::enumerate(functionType.getResults())) {
+        if (!isRefType(type.value())) continue;
+        output << "    iree_vm_ref_release(&ret" << type.index() << ");\n";
+      }
+      output << "    return status;\n"
+             << "  }\n";
+    } else {
+      output << "  IREE_RETURN_IF_ERROR(" << stream.str() << ");\n";
+    }
+    // Ref results are moved into the result buffer.
+    offset = AbiOffset();
+    for (auto type : llvm::enumerate(functionType.getResults())) {
+      output << "  memcpy(call->results.data + " << offset << ", &ret"
+             << type.index() << ", sizeof(ret" << type.index() << "));\n";
+      offset.advance(type.value());
+    }
+    output << "  return iree_ok_status();\n"
+           << "}\n\n";
+    return success();
+  }
+
+  std::string getShimName(IREE::VM::ExportOp exportOp) {
+    return getFunctionName(exportOp.export_name()) + "_shim";
+  }
+
+  LogicalResult emitDescriptor() {
+    if (!importOps.empty()) {
+      output << "static const iree_vm_native_import_descriptor_t "
+             << moduleName << "_imports_[] = {\n";
+      for (auto importOp : importOps) {
+        output << "    {";
+        printCStringView(importOp.getName(), output);
+        output << "},\n";
+      }
+      output << "};\n\n";
+    }
+
+    for (auto exportOp : exportOps) {
+      auto funcOp =
+          symbolTable.lookup<IREE::VM::FuncOp>(exportOp.function_ref());
+      auto reflectionAttrs =
+          funcOp.getAttrOfType<DictionaryAttr>("iree.reflection");
+      if (!reflectionAttrs || reflectionAttrs.empty()) continue;
+      output << "static const iree_vm_reflection_attr_t "
+             << getFunctionName(exportOp.export_name()) << "_attrs_[] = {\n";
+      for (auto reflectionAttr : reflectionAttrs) {
+        auto key = reflectionAttr.first.strref();
+        auto value = reflectionAttr.second.dyn_cast<StringAttr>();
+        if (!value || key.empty()) continue;
+        output << "    {";
+        printCStringView(key, output);
+        output << ", ";
+        printCStringView(value.getValue(), output);
+        output << "},\n";
+      }
+      output << "};\n";
+    }
+
+    if (!exportOps.empty()) {
+      output << "static const iree_vm_native_export_descriptor_t "
+             << moduleName << "_exports_[] = {\n";
+      for (auto exportOp : exportOps) {
+        auto funcOp =
+            symbolTable.lookup<IREE::VM::FuncOp>(exportOp.function_ref());
+        auto cconv = makeCallingConventionString(funcOp.getType());
+        if (!cconv.hasValue()) {
+          return funcOp.emitOpError()
+                 << "signature not supported by the C module target";
+        }
+        output << "    {";
+        printCStringView(exportOp.export_name(), output);
+        output << ", ";
+        printCStringView(cconv.getValue(), output);
+        output << ", ";
+        auto reflectionAttrs =
+            funcOp.getAttrOfType<DictionaryAttr>("iree.reflection");
+        if (reflectionAttrs && !reflectionAttrs.empty()) {
+          auto attrsName = getFunctionName(exportOp.export_name()) + "_attrs_";
+          output << "IREE_ARRAYSIZE(" << attrsName << "), " << attrsName;
+        } else {
+          output << "0, NULL";
+        }
+        output << "},\n";
+      }
+      output << "};\n";
+
+      output << "static const iree_vm_native_function_ptr_t " << moduleName
+             << "_funcs_[] = {\n";
+      for (auto exportOp : exportOps) {
+        output << "    {(iree_vm_native_function_shim_t)"
+               << getShimName(exportOp) << ",\n"
+               << "     (iree_vm_native_function_target_t)"
+               << getFunctionName(exportOp.function_ref()) << "},\n";
+      }
+      output << "};\n\n";
+    }
+
+    output << "static const iree_vm_native_module_descriptor_t " << moduleName
+           << "_descriptor_ = {\n"
+           << "    ";
+    printCStringView(moduleOp.getName(), output);
+    output << ",\n";
+    if (importOps.empty()) {
+      output << "    0,\n    NULL,\n";
+    } else {
+      output << "    IREE_ARRAYSIZE(" << moduleName << "_imports_),\n"
+             << "    " << moduleName << "_imports_,\n";
+    }
+    if (exportOps.empty()) {
+      output << "    0,\n    NULL,\n    0,\n    NULL,\n";
+    } else {
+      output << "    IREE_ARRAYSIZE(" << moduleName << "_exports_),\n"
+             << "    " << moduleName << "_exports_,\n"
+             << "    IREE_ARRAYSIZE(" << moduleName << "_funcs_),\n"
+             << "    " << moduleName << "_funcs_,\n";
+    }
+    output << "    0,\n    NULL,\n"
+           << "};\n\n";
+    return success();
+  }
+
+  void emitModuleInterface() {
+    const std::string &m = moduleName;
+    output << "static void IREE_API_PTR " << m << "_destroy(void* self) {\n"
+           << "  " << m << "_t* module = (" << m << "_t*)self;\n"
+           << "  iree_allocator_free(module->allocator, module);\n"
+           << "}\n\n";
+
+    output << "static iree_status_t IREE_API_PTR " << m
+           << "_alloc_state(\n"
+           << "    void* self, iree_allocator_t allocator,\n"
+           << "    iree_vm_module_state_t** out_module_state) {\n"
+           << "  " << m << "_state_t* state = NULL;\n"
+           << "  IREE_RETURN_IF_ERROR(\n"
+           << "      iree_allocator_malloc(allocator, sizeof(*state), "
+              "(void**)&state));\n"
+           << "  memset(state, 0, sizeof(*state));\n"
+           << "  state->allocator = allocator;\n";
+    for (auto length : llvm::enumerate(rodataLengths)) {
+      output << "  vm_rodata_initialize(&state->rodata[" << length.index()
+             << "], " << getRodataName(length.index()) << ", "
+             << length.value() << ");\n";
+    }
+    for (auto name : llvm::enumerate(refTypeNames)) {
+      output << "  {\n"
+             << "    const iree_vm_ref_type_descriptor_t* descriptor =\n"
+             << "        iree_vm_ref_lookup_registered_type(\n"
+             << "            iree_make_cstring_view(";
+      printCStringLiteral(name.value(), output);
+      output << "));\n"
+             << "    if (!descriptor) {\n"
+             << "      iree_allocator_free(allocator, state);\n"
+             << "      return iree_make_status(IREE_STATUS_NOT_FOUND,\n"
+             << "                              \"no type registered with "
+                "name '%s'\",\n"
+             << "                              ";
+      printCStringLiteral(name.value(), output);
+      output << ");\n"
+             << "    }\n"
+             << "    state->types[" << name.index()
+             << "] = iree_vm_type_def_make_ref_type(descriptor->type);\n"
+             << "  }\n";
+    }
+    output << "  *out_module_state = (iree_vm_module_state_t*)state;\n"
+           << "  return iree_ok_status();\n"
+           << "}\n\n";
+
+    output << "static void IREE_API_PTR " << m << "_free_state(\n"
+           << "    void* self, iree_vm_module_state_t* module_state) {\n"
+           << "  " << m << "_state_t* state = (" << m
+           << "_state_t*)module_state;\n";
+    if (refGlobalCount) {
+      output << "  for (int i = 0; i < " << refGlobalCount << "; ++i) {\n"
+             << "    iree_vm_ref_release(&state->refs[i]);\n"
+             << "  }\n";
+    }
+    output << "  iree_allocator_free(state->allocator, state);\n"
+           << "}\n\n";
+
+    if (!importOps.empty()) {
+      output << "static iree_status_t IREE_API_PTR " << m
+             << "_resolve_import(\n"
+             << "    void* self, iree_vm_module_state_t* module_state,\n"
+             << "    iree_host_size_t ordinal, const iree_vm_function_t* "
+                "function,\n"
+             << "    const iree_vm_function_signature_t* signature) {\n"
+             << "  " << m << "_state_t* state = (" << m
+             << "_state_t*)module_state;\n"
+             << "  state->imports[ordinal] = *function;\n"
+             << "  return iree_ok_status();\n"
+             << "}\n\n";
+    }
+
+    output << "iree_status_t " << m
+           << "_create(iree_allocator_t allocator,\n"
+           << "    iree_vm_module_t** out_module) {\n"
+           << "  " << m << "_t* module = NULL;\n"
+           << "  IREE_RETURN_IF_ERROR(\n"
+           << "      iree_allocator_malloc(allocator, sizeof(*module), "
+              "(void**)&module));\n"
+           << "  memset(module, 0, sizeof(*module));\n"
+           << "  module->allocator = allocator;\n\n"
+           << "  iree_vm_module_t interface;\n"
+           << "  iree_status_t status = iree_vm_module_initialize(&interface, "
+              "module);\n"
+           << "  if (!iree_status_is_ok(status)) {\n"
+           << "    iree_allocator_free(allocator, module);\n"
+           << "    return status;\n"
+           << "  }\n"
+           << "  interface.destroy = " << m << "_destroy;\n"
+           << "  interface.alloc_state = " << m << "_alloc_state;\n"
+           << "  interface.free_state = " << m << "_free_state;\n";
+    if (!importOps.empty()) {
+      output << "  interface.resolve_import = " << m << "_resolve_import;\n";
+    }
+    output << "  return iree_vm_native_module_create(&interface, &" << m
+           << "_descriptor_,\n"
+           << "                                      allocator, out_module);\n"
+           << "}\n";
+  }
+
+  IREE::VM::ModuleOp moduleOp;
+  SymbolTable symbolTable;
+  llvm::raw_ostream &output;
+  std::string moduleName;
+
+  SmallVector<IREE::VM::FuncOp, 8> funcOps;
+  SmallVector<IREE::VM::ExportOp, 8> exportOps;
+  SmallVector<IREE::VM::ImportOp, 8> importOps;
+  SmallVector<IREE::VM::RodataOp, 4> rodataOps;
+  SmallVector<size_t, 4> rodataLengths;
+  SmallVector<std::string, 4> refTypeNames;
+  size_t globalBytes = 0;
+  size_t refGlobalCount = 0;
+
+  llvm::DenseMap<Value, std::string> valueNames;
+  llvm::DenseMap<Block *, std::string> blockNames;
+  SmallVector<std::string, 8> refLocals;
+};
+
+}  // namespace
+
+// Canonicalizes the module to its final form prior to emission and lowers
+// all primitive ops to EmitC calls.
+// This mirrors the bytecode target such that both produce modules with
+// identical behavior.
+static LogicalResult canonicalizeModule(IREE::VM::ModuleOp moduleOp) {
+  OwningRewritePatternList patterns;
+  ConversionTarget target(*moduleOp.getContext());
+  target.addLegalDialect<IREE::VM::VMDialect>();
+  target.addLegalOp<IREE::DoNotOptimizeOp>();
+
+  // Add all VM canonicalization patterns and mark pseudo-ops illegal.
+  auto *context = moduleOp.getContext();
+  for (auto *op : context->getRegisteredOperations()) {
+    if (op->hasTrait<OpTrait::IREE::VM::PseudoOp>()) {
+      op->getCanonicalizationPatterns(patterns, context);
+      target.setOpAction(OperationName(op->name, context),
+                         ConversionTarget::LegalizationAction::Illegal);
+    }
+  }
+
+  if (failed(applyFullConversion(moduleOp, target, patterns))) {
+    return moduleOp.emitError() << "unable to fully apply conversion to module";
+  }
+
+  PassManager passManager(context);
+  mlir::applyPassManagerCLOptions(passManager);
+  auto &modulePasses = passManager.nest<IREE::VM::ModuleOp>();
+  modulePasses.addPass(mlir::createInlinerPass());
+  modulePasses.addPass(mlir::createCSEPass());
+  modulePasses.addPass(mlir::createCanonicalizerPass());
+  modulePasses.addPass(createDropCompilerHintsPass());
+
+  // Global storage is assigned byte offsets that the C code indexes with.
+  modulePasses.addPass(IREE::VM::createOrdinalAllocationPass());
+
+  // No more VM-level modifications after this point; primitive ops become
+  // calls into iree/vm/ops.h.
+  modulePasses.addPass(createConvertVMToEmitCPass());
+
+  if (failed(passManager.run(moduleOp.getParentOfType<mlir::ModuleOp>()))) {
+    return moduleOp.emitError() << "failed during transform passes";
+  }
+
+  return success();
+}
+
+LogicalResult translateModuleToC(IREE::VM::ModuleOp moduleOp,
+                                 llvm::raw_ostream &output) {
+  if (failed(canonicalizeModule(moduleOp))) {
+    return moduleOp.emitError()
+           << "failed to canonicalize vm.module to a C-compatible form";
+  }
+  return CModuleEmitter(moduleOp, output).emit();
+}
+
+LogicalResult translateModuleToC(mlir::ModuleOp outerModuleOp,
+                                 llvm::raw_ostream &output) {
   auto moduleOps = outerModuleOp.getOps<IREE::VM::ModuleOp>();
   if (moduleOps.empty()) {
     return outerModuleOp.emitError()
@@ -0,0 +1,34 @@
+// RUN: iree-translate -iree-vm-ir-to-c-module %s | IreeFileCheck %s
+
+// CHECK: } add_module_t;
+// CHECK: typedef struct {
+// CHECK-NEXT: iree_allocator_t allocator;
+// CHECK-NEXT: uint8_t rwdata[4];
+// CHECK-NEXT: } add_module_state_t;
+vm.module @add_module {
+  vm.global.i32 @counter mutable : i32
+
+  // CHECK: static iree_status_t add_module_add_i32(iree_vm_stack_t* stack, add_module_state_t* state, int32_t arg0, int32_t arg1, int32_t* out_ret0) {
+  // CHECK-NEXT: int32_t v0;
+  // CHECK-NEXT: v0 = vm_add_i32(arg0, arg1);
+  // CHECK-NEXT: vm_global_store_i32(state->rwdata, 0, v0);
+  // CHECK-NEXT: *out_ret0 = v0;
+  // CHECK-NEXT: return iree_ok_status();
+  // CHECK-NEXT: }
+  vm.func @add_i32(%arg0: i32, %arg1: i32) -> i32 {
+    %0 = vm.add.i32 %arg0, %arg1 : i32
+    vm.global.store.i32 %0, @counter
+    vm.return %0 : i32
+  }
+  vm.export @add_i32
+
+  // CHECK: static iree_status_t add_module_add_i32_shim(iree_vm_stack_t* stack,
+  // CHECK: memcpy(&arg0, call->arguments.data + 0, sizeof(arg0));
+  // CHECK: memcpy(&arg1, call->arguments.data + 4, sizeof(arg1));
+  // CHECK: add_module_add_i32(
+  // CHECK-NEXT: stack, (add_module_state_t*)module_state, arg0, arg1, &ret0));
+  // CHECK-NEXT: memcpy(call->results.data + 0, &ret0, sizeof(ret0));
+
+  // CHECK: static const iree_vm_native_export_descriptor_t add_module_exports_[] = {
+  // CHECK-NEXT: "add_i32", 7}, {"0ii.i", 5}, 0, NULL},
+}
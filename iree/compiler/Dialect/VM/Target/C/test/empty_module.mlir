@@ -1,5 +1,13 @@
 // RUN: iree-translate -iree-vm-ir-to-c-module %s | IreeFileCheck %s
 
-// CHECK: // c module stub
+// CHECK: #include "iree/vm/api.h"
+// CHECK: #include "iree/vm/native_module.h"
+// CHECK: #include "iree/vm/ops.h"
+// CHECK: } empty_module_t;
+// CHECK: } empty_module_state_t;
+// CHECK: static const iree_vm_native_module_descriptor_t empty_module_descriptor_ = {
+// CHECK-NEXT: {"empty_module", 12},
+// CHECK: iree_status_t empty_module_create(iree_allocator_t allocator,
+// CHECK: return iree_vm_native_module_create(&interface, &empty_module_descriptor_,
 vm.module @empty_module {
 }
@@ -0,0 +1,89 @@
+// RUN: iree-translate -iree-vm-ir-to-c-module %s | IreeFileCheck %s
+
+// CHECK: } ref_module_t;
+// CHECK: typedef struct {
+// CHECK-NEXT: iree_allocator_t allocator;
+// CHECK-NEXT: iree_vm_ref_t refs[1];
+// CHECK-NEXT: iree_vm_ro_byte_buffer_t rodata[1];
+// CHECK-NEXT: iree_vm_type_def_t types[1];
+// CHECK-NEXT: iree_vm_function_t imports[1];
+// CHECK-NEXT: } ref_module_state_t;
+
+// CHECK: static iree_alignas(64) const uint8_t ref_module_rodata_0_[3] = {
+// CHECK-NEXT: 0x01, 0x02, 0x03,
+// CHECK-NEXT: };
+vm.module @ref_module {
+  vm.rodata @data dense<[1, 2, 3]> : tensor<3xi8>
+  vm.global.ref @g0 mutable : !vm.ref<!iree.byte_buffer>
+  vm.import @other.consume(%ref : !vm.ref<!iree.byte_buffer>) -> !vm.ref<!iree.byte_buffer>
+
+  // CHECK: static iree_status_t ref_module_call_import(
+  // CHECK: IREE_RETURN_IF_ERROR(import->module->begin_call(
+  // CHECK: if (IREE_UNLIKELY(result.flags & IREE_VM_EXECUTION_RESULT_FLAG_YIELDED)) {
+  // CHECK: return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+
+  // CHECK: static iree_status_t ref_module_roundtrip(iree_vm_stack_t* stack, ref_module_state_t* state, iree_vm_ref_t* arg0, iree_vm_ref_t* out_ret0) {
+  // CHECK-NEXT: iree_vm_ref_t v0 = {0};
+  // CHECK-NEXT: iree_status_t status = iree_ok_status();
+  // CHECK-NEXT: vm_global_store_ref(&state->refs[0], &(*arg0));
+  // CHECK-NEXT: vm_global_load_ref(&state->refs[0], &v0);
+  // CHECK-NEXT: vm_ref_retain(&v0, out_ret0);
+  // CHECK-NEXT: goto cleanup;
+  // CHECK-NEXT: cleanup:
+  // CHECK-NEXT: iree_vm_ref_release(&v0);
+  // CHECK-NEXT: return status;
+  // CHECK-NEXT: }
+  vm.func @roundtrip(%arg0 : !vm.ref<!iree.byte_buffer>) -> !vm.ref<!iree.byte_buffer> {
+    vm.global.store.ref %arg0, @g0 : !vm.ref<!iree.byte_buffer>
+    %0 = vm.global.load.ref @g0 : !vm.ref<!iree.byte_buffer>
+    vm.return %0 : !vm.ref<!iree.byte_buffer>
+  }
+  vm.export @roundtrip
+
+  // CHECK: static iree_status_t ref_module_rodata(
+  // CHECK: status = vm_const_ref_rodata(&state->rodata[0], &v0);
+  // CHECK-NEXT: if (!iree_status_is_ok(status)) goto cleanup;
+  vm.func @rodata() -> !vm.ref<!iree.byte_buffer> {
+    %0 = vm.const.ref.rodata @data : !vm.ref<!iree.byte_buffer>
+    vm.return %0 : !vm.ref<!iree.byte_buffer>
+  }
+  vm.export @rodata
+
+  // CHECK: static iree_status_t ref_module_list_size(
+  // CHECK: status = vm_list_alloc(state->types[0], arg0, state->allocator, &v0);
+  // CHECK: status = vm_list_size(&v0, &v1);
+  vm.func @list_size(%arg0 : i32) -> i32 {
+    %list = vm.list.alloc %arg0 : (i32) -> !vm.list<!vm.ref<!iree.byte_buffer>>
+    %0 = vm.list.size %list : (!vm.list<!vm.ref<!iree.byte_buffer>>) -> i32
+    vm.return %0 : i32
+  }
+  vm.export @list_size
+
+  // CHECK: static iree_status_t ref_module_consume(
+  // CHECK: uint8_t arguments[0 + 1 * sizeof(iree_vm_ref_t)];
+  // CHECK-NEXT: uint8_t results[0 + 1 * sizeof(iree_vm_ref_t)];
+  // CHECK-NEXT: memset(results, 0, sizeof(results));
+  // CHECK: vm_ref_retain(&(*arg0), &arg);
+  // CHECK: iree_vm_ref_move(&ret, &v0);
+  vm.func @consume(%arg0 : !vm.ref<!iree.byte_buffer>) -> !vm.ref<!iree.byte_buffer> {
+    %0 = vm.call @other.consume(%arg0) : (!vm.ref<!iree.byte_buffer>) -> !vm.ref<!iree.byte_buffer>
+    vm.return %0 : !vm.ref<!iree.byte_buffer>
+  }
+  vm.export @consume
+
+  // CHECK: static iree_status_t ref_module_roundtrip_shim(
+  // CHECK: memcpy(&arg0, call->arguments.data + 0, sizeof(arg0));
+  // CHECK-NEXT: memset(call->arguments.data + 0, 0, sizeof(arg0));
+  // CHECK-NEXT: iree_vm_ref_t ret0 = {0};
+  // CHECK-NEXT: iree_status_t status = ref_module_roundtrip(
+  // CHECK-NEXT: stack, (ref_module_state_t*)module_state, &arg0, &ret0);
+  // CHECK-NEXT: iree_vm_ref_release(&arg0);
+
+  // CHECK: static iree_status_t IREE_API_PTR ref_module_alloc_state(
+  // CHECK: vm_rodata_initialize(&state->rodata[0], ref_module_rodata_0_, 3);
+  // CHECK: iree_make_cstring_view("iree.byte_buffer"));
+  // CHECK: state->types[0] = iree_vm_type_def_make_ref_type(descriptor->type);
+
+  // CHECK: static void IREE_API_PTR ref_module_free_state(
+  // CHECK: iree_vm_ref_release(&state->refs[i]);
+}
@@ -143,6 +143,17 @@ class GlobalInitializationPass
         default:
           return {failure(), {}};
       }
+    } else if (auto floatValue = value.dyn_cast<FloatAttr>()) {
+      if (floatValue.getValue().isPosZero()) {
+        // Globals are zero-initialized by default.
+        return {success(), {}};
+      }
+      switch (floatValue.getType().getIntOrFloatBitWidth()) {
+        case 32:
+          return {success(), builder.createOrFold<ConstF32Op>(loc, floatValue)};
+        default:
+          return {failure(), {}};
+      }
     }
     return {failure(), {}};
   }
@@ -161,6 +172,14 @@ class GlobalInitializationPass
         default:
           return failure();
       }
+    } else if (auto floatType = value.getType().dyn_cast<FloatType>()) {
+      switch (floatType.getWidth()) {
+        case 32:
+          builder.create<GlobalStoreF32Op>(loc, value, symName);
+          return success();
+        default:
+          return failure();
+      }
     }
     return failure();
   }
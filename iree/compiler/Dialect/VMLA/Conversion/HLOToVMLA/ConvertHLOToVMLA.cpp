@@ -49,6 +49,12 @@ void populateHLODotToVMLAPatterns(MLIRContext *context,
 void populateHLOReductionToVMLAPatterns(MLIRContext *context,
                                         OwningRewritePatternList &patterns,
                                         TypeConverter &typeConverter);
+void populateHLOSortToVMLAPatterns(MLIRContext *context,
+                                   OwningRewritePatternList &patterns,
+                                   TypeConverter &typeConverter);
+void populateHLOQuantizedToVMLAPatterns(MLIRContext *context,
+                                        OwningRewritePatternList &patterns,
+                                        TypeConverter &typeConverter);
 
 namespace {
 
@@ -722,6 +728,21 @@ struct ConvertOpConversion : public OpConversionPattern<mhlo::ConvertOp> {
           .matchAndRewrite(srcOp, rawOperands, rewriter);
     }
 
+    // 16-bit floats are only converted to and from f32 at runtime; other
+    // conversions go through f32.
+    auto isHalfType = [](Type type) { return type.isF16() || type.isBF16(); };
+    if ((isHalfType(srcType.getElementType()) &&
+         !dstType.getElementType().isF32()) ||
+        (isHalfType(dstType.getElementType()) &&
+         !srcType.getElementType().isF32())) {
+      auto f32Type =
+          RankedTensorType::get(srcType.getShape(), rewriter.getF32Type());
+      auto f32Value = rewriter.create<mhlo::ConvertOp>(
+          srcOp.getLoc(), f32Type, srcOp.operand());
+      rewriter.replaceOpWithNewOp<mhlo::ConvertOp>(srcOp, dstType, f32Value);
+      return success();
+    }
+
     // VMLA does not support tensors of i1. tensor<*xi1> will be converted to
     // tensor<*xi8>.
     if (srcType.getElementTypeBitWidth() == 1 &&
@@ -755,6 +776,12 @@ void populateHLOToVMLAPatterns(MLIRContext *context,
   // mhlo.reduce and mhlo.reduce_window.
   populateHLOReductionToVMLAPatterns(context, patterns, typeConverter);
 
+  // mhlo.sort.
+  populateHLOSortToVMLAPatterns(context, patterns, typeConverter);
+
+  // Quantized mhlo ops in quant.dcast/quant.qcast form.
+  populateHLOQuantizedToVMLAPatterns(context, patterns, typeConverter);
+
   // vmla.batch.matmul.pseudo
   patterns.insert<VMLAOpConversion<IREE::VMLA::BatchMatMulPseudoOp,
                                    IREE::VMLA::BatchMatMulOp>>(context,
@@ -0,0 +1,644 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Lowers quantized computations to the VMLA quantized ops.
+//
+// HLO has no quantized types so quantized models are expressed in the
+// "dequantize -> float op -> quantize" (QDQ) form using the quant dialect
+// casts. A float op whose operands are all produced by quant.dcast and whose
+// only user is a quant.qcast is lowered to a quantized VMLA op computing on the
+// int8 storage directly, and the casts around it are elided. Any remaining
+// casts are lowered to vmla.quantize/vmla.dequantize.
+
+#include <cmath>
+
+#include "iree/compiler/Dialect/IREE/IR/IREETypes.h"
+#include "iree/compiler/Dialect/Shape/IR/ShapeOps.h"
+#include "iree/compiler/Dialect/VMLA/Conversion/ConversionTarget.h"
+#include "iree/compiler/Dialect/VMLA/Conversion/HLOToVMLA/ConvertHLOToVMLA.h"
+#include "iree/compiler/Dialect/VMLA/Conversion/TypeConverter.h"
+#include "iree/compiler/Dialect/VMLA/IR/VMLADialect.h"
+#include "iree/compiler/Dialect/VMLA/IR/VMLAOps.h"
+#include "iree/compiler/Dialect/VMLA/IR/VMLATypes.h"
+#include "mlir/Dialect/Quant/QuantOps.h"
+#include "mlir/Dialect/Quant/QuantTypes.h"
+#include "mlir/Dialect/Quant/QuantizeUtils.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Function.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/Module.h"
+#include "mlir/IR/StandardTypes.h"
+#include "mlir/Transforms/DialectConversion.h"
+#include "tensorflow/compiler/mlir/hlo/include/mlir-hlo/Dialect/mhlo/IR/hlo_ops.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+namespace {
+
+// Must match kernels::QuantizedAdd::kLeftShift in the runtime.
+constexpr int kQuantizedAddLeftShift = 20;
+
+// Fixed-point representation of a real multiplier as used by the runtime
+// kernels: real = multiplier * 2^(exponent - 31).
+struct QuantizedMultiplier {
+  int32_t multiplier = 0;
+  int32_t exponent = 0;
+};
+
+static QuantizedMultiplier getQuantizedMultiplier(double real) {
+  QuantizedMultiplier result;
+  if (real == 0.0) return result;
+  int exponent = 0;
+  double mantissa = std::frexp(real, &exponent);
+  auto multiplier = static_cast<int64_t>(std::round(mantissa * (1ll << 31)));
+  if (multiplier == (1ll << 31)) {
+    multiplier /= 2;
+    ++exponent;
+  }
+  result.multiplier = static_cast<int32_t>(multiplier);
+  result.exponent = exponent;
+  return result;
+}
+
+// Returns the quantized element type of |value| if it is a tensor of signed
+// 8-bit quantized values of type T.
+template <typename T = quant::UniformQuantizedType>
+static T getInt8QuantizedType(Value value) {
+  if (!value) return nullptr;
+  auto quantizedType =
+      value.getType().cast<ShapedType>().getElementType().dyn_cast<T>();
+  if (!quantizedType || !quantizedType.isSigned() ||
+      quantizedType.getStorageTypeIntegralWidth() != 8) {
+    return nullptr;
+  }
+  return quantizedType;
+}
+
+// Returns the int8 quantized value that |value| was dequantized from, if any.
+static Value getDequantizedSource(Value value) {
+  auto dcastOp = value.getDefiningOp<quant::DequantizeCastOp>();
+  if (!dcastOp || !getInt8QuantizedType<quant::QuantizedType>(dcastOp.arg())) {
+    return nullptr;
+  }
+  return dcastOp.arg();
+}
+
+// Returns the int8 quantize cast that is the only user of |value|, if any.
+static quant::QuantizeCastOp getQuantizedResult(Value value) {
+  if (!value.hasOneUse()) return nullptr;
+  auto qcastOp = dyn_cast<quant::QuantizeCastOp>(*value.getUsers().begin());
+  if (!qcastOp || !getInt8QuantizedType(qcastOp.getResult())) return nullptr;
+  return qcastOp;
+}
+
+static bool haveSameQuantization(Value lhs, Value rhs) {
+  auto lhsType = getInt8QuantizedType(lhs);
+  auto rhsType = getInt8QuantizedType(rhs);
+  return lhsType && rhsType && lhsType.getScale() == rhsType.getScale() &&
+         lhsType.getZeroPoint() == rhsType.getZeroPoint();
+}
+
+static bool isSequence(DenseIntElementsAttr attr, int64_t first,
+                       int64_t count) {
+  if (attr.getNumElements() != count) return false;
+  for (auto value : llvm::enumerate(attr.getIntValues())) {
+    if (value.value().getSExtValue() != first + value.index()) return false;
+  }
+  return true;
+}
+
+// Returns true if |op| is a 2D convolution of an NHWC input with an HWIO
+// filter into an NHWC output.
+static bool isNHWCConv2D(mhlo::ConvOp op) {
+  if (op.lhs().getType().cast<ShapedType>().getRank() != 4) return false;
+  if (!op.dimension_numbers()) return true;
+  auto dimensionNumbers = op.dimension_numbers();
+  return dimensionNumbers.input_batch_dimension().getInt() == 0 &&
+         dimensionNumbers.input_feature_dimension().getInt() == 3 &&
+         isSequence(dimensionNumbers.input_spatial_dimensions(), 1, 2) &&
+         dimensionNumbers.kernel_input_feature_dimension().getInt() == 2 &&
+         dimensionNumbers.kernel_output_feature_dimension().getInt() == 3 &&
+         isSequence(dimensionNumbers.kernel_spatial_dimensions(), 0, 2) &&
+         dimensionNumbers.output_batch_dimension().getInt() == 0 &&
+         dimensionNumbers.output_feature_dimension().getInt() == 3 &&
+         isSequence(dimensionNumbers.output_spatial_dimensions(), 1, 2);
+}
+
+// Returns the per output channel scales of a symmetrically quantized HWIO
+// filter, or an empty list if the filter is not supported.
+static SmallVector<double, 4> getSymmetricFilterScales(Value filter) {
+  if (auto perTensorType = getInt8QuantizedType(filter)) {
+    if (perTensorType.getZeroPoint() != 0) return {};
+    return {perTensorType.getScale()};
+  }
+  auto perAxisType =
+      getInt8QuantizedType<quant::UniformQuantizedPerAxisType>(filter);
+  if (!perAxisType || perAxisType.getQuantizedDimension() != 3 ||
+      llvm::any_of(perAxisType.getZeroPoints(),
+                   [](int64_t zeroPoint) { return zeroPoint != 0; })) {
+    return {};
+  }
+  return llvm::to_vector<4>(perAxisType.getScales());
+}
+
+static bool isAllOnes(Optional<DenseIntElementsAttr> attr) {
+  return !attr.hasValue() ||
+         llvm::all_of(attr.getValue().getIntValues(),
+                      [](const APInt &value) { return value == 1; });
+}
+
+static bool isAllZeros(Optional<DenseIntElementsAttr> attr) {
+  return !attr.hasValue() ||
+         llvm::all_of(attr.getValue().getIntValues(),
+                      [](const APInt &value) { return value == 0; });
+}
+
+// Returns the value of |value| if it is a splat floating-point constant.
+static Optional<double> getSplatFloatConstant(Value value) {
+  DenseFPElementsAttr attr;
+  if (!matchPattern(value, m_Constant(&attr)) || !attr.isSplat()) {
+    return llvm::None;
+  }
+  return attr.getSplatValue<FloatAttr>().getValueAsDouble();
+}
+
+// Returns the op computing the body of |op| if it is a single op.
+static Operation *getReduceWindowComputeOp(mhlo::ReduceWindowOp op) {
+  if (op.body().getBlocks().size() != 1) return nullptr;
+  auto &block = op.body().front();
+  return block.getOperations().size() == 2 ? &block.front() : nullptr;
+}
+
+static bool isQuantizedConv(mhlo::ConvOp op) {
+  auto qcastOp = getQuantizedResult(op.getResult());
+  return qcastOp && getInt8QuantizedType(getDequantizedSource(op.lhs())) &&
+         !getSymmetricFilterScales(getDequantizedSource(op.rhs())).empty() &&
+         isNHWCConv2D(op) && isAllOnes(op.lhs_dilation()) &&
+         op.batch_group_count() == 1;
+}
+
+// Max pooling commutes with quantization when the input and output share
+// their parameters.
+static bool isQuantizedMaxPooling(mhlo::ReduceWindowOp op) {
+  auto qcastOp = getQuantizedResult(op.getResult());
+  auto *computeOp = getReduceWindowComputeOp(op);
+  if (!qcastOp || !computeOp || !isa<mhlo::MaxOp>(computeOp)) return false;
+  auto source = getDequantizedSource(op.operand());
+  if (!haveSameQuantization(source, qcastOp.getResult())) return false;
+  // The initial value must not exceed any representable value.
+  auto sourceType = getInt8QuantizedType(source);
+  auto initValue = getSplatFloatConstant(op.init_value());
+  return initValue.hasValue() &&
+         initValue.getValue() <=
+             sourceType.getScale() * (sourceType.getStorageTypeMin() -
+                                      sourceType.getZeroPoint());
+}
+
+// Returns the window sum of an unpadded average pooling expressed as a window
+// sum divided by the window size.
+static mhlo::ReduceWindowOp getAveragePoolingSum(mhlo::DivOp op) {
+  auto sumOp = op.lhs().getDefiningOp<mhlo::ReduceWindowOp>();
+  if (!sumOp || !sumOp.getResult().hasOneUse() ||
+      !isAllZeros(sumOp.padding())) {
+    return nullptr;
+  }
+  auto *computeOp = getReduceWindowComputeOp(sumOp);
+  if (!computeOp ||
+      !(isa<mhlo::AddOp>(computeOp) || isa<mlir::AddFOp>(computeOp))) {
+    return nullptr;
+  }
+  auto initValue = getSplatFloatConstant(sumOp.init_value());
+  auto divisor = getSplatFloatConstant(op.rhs());
+  if (!initValue.hasValue() || initValue.getValue() != 0.0 ||
+      !divisor.hasValue()) {
+    return nullptr;
+  }
+  int64_t windowSize = 1;
+  for (const auto &dim : sumOp.window_dimensions().getIntValues()) {
+    windowSize *= dim.getSExtValue();
+  }
+  return divisor.getValue() == windowSize ? sumOp : nullptr;
+}
+
+static bool isQuantizedAveragePooling(mhlo::DivOp op) {
+  auto qcastOp = getQuantizedResult(op.getResult());
+  auto sumOp = getAveragePoolingSum(op);
+  return qcastOp && sumOp &&
+         haveSameQuantization(getDequantizedSource(sumOp.operand()),
+                              qcastOp.getResult());
+}
+
+// Returns true if |op| is lowered to a VMLA quantized op producing the result
+// of the quant.qcast that uses it.
+static bool isFusedQuantizedOp(Operation *op) {
+  if (isa<mhlo::AddOp>(op) || isa<mhlo::MulOp>(op)) {
+    return getQuantizedResult(op->getResult(0)) &&
+           getInt8QuantizedType(getDequantizedSource(op->getOperand(0))) &&
+           getInt8QuantizedType(getDequantizedSource(op->getOperand(1)));
+  } else if (auto convOp = dyn_cast<mhlo::ConvOp>(op)) {
+    return isQuantizedConv(convOp);
+  } else if (auto reduceWindowOp = dyn_cast<mhlo::ReduceWindowOp>(op)) {
+    return isQuantizedMaxPooling(reduceWindowOp);
+  } else if (auto divOp = dyn_cast<mhlo::DivOp>(op)) {
+    return isQuantizedAveragePooling(divOp);
+  }
+  return false;
+}
+
+// Returns true if |op| is subsumed by a fused op that uses it.
+static bool isFusedQuantizedOpInterior(Operation *op) {
+  auto sumOp = dyn_cast<mhlo::ReduceWindowOp>(op);
+  if (!sumOp || !sumOp.getResult().hasOneUse()) return false;
+  auto divOp = dyn_cast<mhlo::DivOp>(*sumOp.getResult().getUsers().begin());
+  return divOp && isQuantizedAveragePooling(divOp);
+}
+
+static Value createI32Buffer(Location loc, ArrayRef<int32_t> values,
+                             ConversionPatternRewriter &rewriter) {
+  auto type = RankedTensorType::get({static_cast<int64_t>(values.size())},
+                                    rewriter.getIntegerType(32));
+  return rewriter.create<IREE::VMLA::ConstantOp>(
+      loc, DenseElementsAttr::get(type, values));
+}
+
+// Returns the window attributes of a reduce_window as VMLA pooling expects.
+static void getWindowAttrs(mhlo::ReduceWindowOp op, Builder &builder,
+                           DenseIntElementsAttr &windowDimensions,
+                           DenseIntElementsAttr &windowStrides,
+                           DenseIntElementsAttr &padding) {
+  SmallVector<int32_t, 4> dimensions;
+  for (const auto &value : op.window_dimensions().getIntValues()) {
+    dimensions.push_back(value.getSExtValue());
+  }
+  int rank = dimensions.size();
+  SmallVector<int32_t, 4> strides(rank, 1);
+  SmallVector<int32_t, 4> padLow(rank, 0);
+  for (unsigned i = 0; i < rank; ++i) {
+    if (op.window_strides()) {
+      strides[i] = op.window_stridesAttr().getValue<int64_t>(i);
+    }
+    if (op.padding()) {
+      padLow[i] = op.paddingAttr().getValue<int64_t>({i, 0});
+    }
+  }
+  windowDimensions = builder.getI32VectorAttr(dimensions);
+  windowStrides = builder.getI32VectorAttr(strides);
+  padding = builder.getI32VectorAttr(padLow);
+}
+
+struct QuantizeCastOpConversion
+    : public OpConversionPattern<quant::QuantizeCastOp> {
+  QuantizeCastOpConversion(MLIRContext *context, TypeConverter &typeConverter)
+      : OpConversionPattern(context), typeConverter(typeConverter) {}
+
+  LogicalResult matchAndRewrite(
+      quant::QuantizeCastOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto *definingOp = srcOp.arg().getDefiningOp();
+    if (definingOp && isFusedQuantizedOp(definingOp)) {
+      // The fused op already produced the quantized result.
+      rewriter.replaceOp(srcOp, operands[0]);
+      return success();
+    }
+
+    // Constants, such as weights, are quantized at compile time.
+    Attribute realValue;
+    if (matchPattern(srcOp.arg(), m_Constant(&realValue))) {
+      auto elementType = getInt8QuantizedType<quant::QuantizedType>(
+          srcOp.getResult());
+      Type storageType;
+      auto storageValue =
+          elementType ? quant::quantizeAttr(realValue, elementType, storageType)
+                            .dyn_cast_or_null<ElementsAttr>()
+                      : nullptr;
+      if (storageValue) {
+        rewriter.replaceOpWithNewOp<IREE::VMLA::ConstantOp>(srcOp,
+                                                            storageValue);
+        return success();
+      }
+    }
+
+    auto quantizedType = getInt8QuantizedType(srcOp.getResult());
+    if (!quantizedType) return failure();
+    auto multiplier = getQuantizedMultiplier(1.0 / quantizedType.getScale());
+    auto dst = VMLAConversionTarget::allocateOutputBuffer(
+        srcOp.getLoc(), srcOp.getResult(), typeConverter, rewriter);
+    rewriter.create<IREE::VMLA::QuantizeOp>(
+        srcOp.getLoc(), operands[0], dst,
+        rewriter.getI32IntegerAttr(quantizedType.getZeroPoint()),
+        rewriter.getI32IntegerAttr(multiplier.multiplier),
+        rewriter.getI32IntegerAttr(multiplier.exponent),
+        TypeAttr::get(quantizedType.getStorageType()));
+    rewriter.replaceOp(srcOp, {dst});
+    return success();
+  }
+
+  TypeConverter &typeConverter;
+};
+
+struct DequantizeCastOpConversion
+    : public OpConversionPattern<quant::DequantizeCastOp> {
+  DequantizeCastOpConversion(MLIRContext *context,
+                             TypeConverter &typeConverter)
+      : OpConversionPattern(context), typeConverter(typeConverter) {}
+
+  LogicalResult matchAndRewrite(
+      quant::DequantizeCastOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    if (!srcOp.getResult().use_empty() &&
+        llvm::all_of(srcOp.getResult().getUsers(), [](Operation *user) {
+          return isFusedQuantizedOp(user) || isFusedQuantizedOpInterior(user);
+        })) {
+      // All users read the quantized source directly.
+      rewriter.replaceOp(srcOp, operands[0]);
+      return success();
+    }
+    auto quantizedType = getInt8QuantizedType(srcOp.arg());
+    if (!quantizedType) return failure();
+    auto multiplier = getQuantizedMultiplier(quantizedType.getScale());
+    auto dst = VMLAConversionTarget::allocateOutputBuffer(
+        srcOp.getLoc(), srcOp.getResult(), typeConverter, rewriter);
+    rewriter.create<IREE::VMLA::DequantizeOp>(
+        srcOp.getLoc(), operands[0], dst,
+        rewriter.getI32IntegerAttr(quantizedType.getZeroPoint()),
+        rewriter.getI32IntegerAttr(multiplier.multiplier),
+        rewriter.getI32IntegerAttr(multiplier.exponent),
+        TypeAttr::get(quantizedType.getStorageType()));
+    rewriter.replaceOp(srcOp, {dst});
+    return success();
+  }
+
+  TypeConverter &typeConverter;
+};
+
+struct QuantizedAddOpConversion : public OpConversionPattern<mhlo::AddOp> {
+  QuantizedAddOpConversion(MLIRContext *context, TypeConverter &typeConverter)
+      : OpConversionPattern(context, /*benefit=*/2000),
+        typeConverter(typeConverter) {}
+
+  LogicalResult matchAndRewrite(
+      mhlo::AddOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    if (!isFusedQuantizedOp(srcOp)) return failure();
+    auto lhs = getDequantizedSource(srcOp.lhs());
+    auto rhs = getDequantizedSource(srcOp.rhs());
+    auto result = getQuantizedResult(srcOp.getResult()).getResult();
+    auto lhsType = getInt8QuantizedType(lhs);
+    auto rhsType = getInt8QuantizedType(rhs);
+    auto dstType = getInt8QuantizedType(result);
+
+    // Both inputs are rescaled to twice the larger input scale, leaving
+    // headroom for the sum, and the sum to the output scale.
+    double sumScale = 2.0 * std::max(lhsType.getScale(), rhsType.getScale());
+    auto lhsMultiplier = getQuantizedMultiplier(lhsType.getScale() / sumScale);
+    auto rhsMultiplier = getQuantizedMultiplier(rhsType.getScale() / sumScale);
+    auto dstMultiplier = getQuantizedMultiplier(
+        sumScale / (std::ldexp(1.0, kQuantizedAddLeftShift) *
+                    dstType.getScale()));
+
+    auto dst = VMLAConversionTarget::allocateOutputBuffer(
+        srcOp.getLoc(), result, typeConverter, rewriter);
+    rewriter.create<IREE::VMLA::QuantizedAddOp>(
+        srcOp.getLoc(), rewriter.getRemappedValue(lhs),
+        rewriter.getRemappedValue(rhs), dst,
+        rewriter.getI32IntegerAttr(lhsType.getZeroPoint()),
+        rewriter.getI32IntegerAttr(lhsMultiplier.multiplier),
+        rewriter.getI32IntegerAttr(lhsMultiplier.exponent),
+        rewriter.getI32IntegerAttr(rhsType.getZeroPoint()),
+        rewriter.getI32IntegerAttr(rhsMultiplier.multiplier),
+        rewriter.getI32IntegerAttr(rhsMultiplier.exponent),
+        rewriter.getI32IntegerAttr(dstType.getZeroPoint()),
+        rewriter.getI32IntegerAttr(dstMultiplier.multiplier),
+        rewriter.getI32IntegerAttr(dstMultiplier.exponent),
+        TypeAttr::get(dstType.getStorageType()));
+    rewriter.replaceOp(srcOp, {dst});
+    return success();
+  }
+
+  TypeConverter &typeConverter;
+};
+
+struct QuantizedMulOpConversion : public OpConversionPattern<mhlo::MulOp> {
+  QuantizedMulOpConversion(MLIRContext *context, TypeConverter &typeConverter)
+      : OpConversionPattern(context, /*benefit=*/2000),
+        typeConverter(typeConverter) {}
+
+  LogicalResult matchAndRewrite(
+      mhlo::MulOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    if (!isFusedQuantizedOp(srcOp)) return failure();
+    auto lhs = getDequantizedSource(srcOp.lhs());
+    auto rhs = getDequantizedSource(srcOp.rhs());
+    auto result = getQuantizedResult(srcOp.getResult()).getResult();
+    auto lhsType = getInt8QuantizedType(lhs);
+    auto rhsType = getInt8QuantizedType(rhs);
+    auto dstType = getInt8QuantizedType(result);
+    auto multiplier = getQuantizedMultiplier(
+        lhsType.getScale() * rhsType.getScale() / dstType.getScale());
+
+    auto dst = VMLAConversionTarget::allocateOutputBuffer(
+        srcOp.getLoc(), result, typeConverter, rewriter);
+    rewriter.create<IREE::VMLA::QuantizedMulOp>(
+        srcOp.getLoc(), rewriter.getRemappedValue(lhs),
+        rewriter.getRemappedValue(rhs), dst,
+        rewriter.getI32IntegerAttr(lhsType.getZeroPoint()),
+        rewriter.getI32IntegerAttr(rhsType.getZeroPoint()),
+        rewriter.getI32IntegerAttr(dstType.getZeroPoint()),
+        rewriter.getI32IntegerAttr(multiplier.multiplier),
+        rewriter.getI32IntegerAttr(multiplier.exponent),
+        TypeAttr::get(dstType.getStorageType()));
+    rewriter.replaceOp(srcOp, {dst});
+    return success();
+  }
+
+  TypeConverter &typeConverter;
+};
+
+struct QuantizedConvOpConversion : public OpConversionPattern<mhlo::ConvOp> {
+  QuantizedConvOpConversion(MLIRContext *context, TypeConverter &typeConverter)
+      : OpConversionPattern(context, /*benefit=*/2000),
+        typeConverter(typeConverter) {}
+
+  LogicalResult matchAndRewrite(
+      mhlo::ConvOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    if (!isFusedQuantizedOp(srcOp)) return failure();
+    auto loc = srcOp.getLoc();
+    auto input = getDequantizedSource(srcOp.lhs());
+    auto filter = getDequantizedSource(srcOp.rhs());
+    auto result = getQuantizedResult(srcOp.getResult()).getResult();
+    auto inputType = getInt8QuantizedType(input);
+    auto dstType = getInt8QuantizedType(result);
+
+    // Accumulators have a scale of input_scale * filter_scale[c].
+    SmallVector<int32_t, 4> multiplierMantissa;
+    SmallVector<int32_t, 4> multiplierExponent;
+    for (double filterScale : getSymmetricFilterScales(filter)) {
+      auto multiplier = getQuantizedMultiplier(
+          inputType.getScale() * filterScale / dstType.getScale());
+      multiplierMantissa.push_back(multiplier.multiplier);
+      multiplierExponent.push_back(multiplier.exponent);
+    }
+    auto outputChannels = result.getType().cast<ShapedType>().getDimSize(3);
+    SmallVector<int32_t, 4> bias(outputChannels, 0);
+
+    SmallVector<int32_t, 4> windowStrides{1, 1};
+    SmallVector<int32_t, 4> padding{0, 0, 0, 0};
+    SmallVector<int32_t, 4> dilation{1, 1};
+    auto fillOptional = [](Optional<DenseIntElementsAttr> attr,
+                           SmallVector<int32_t, 4> &values) {
+      if (!attr.hasValue()) return;
+      int index = 0;
+      for (const auto &value : attr.getValue().getIntValues()) {
+        values[index++] = value.getSExtValue();
+      }
+    };
+    fillOptional(srcOp.window_strides(), windowStrides);
+    fillOptional(srcOp.padding(), padding);
+    fillOptional(srcOp.rhs_dilation(), dilation);
+
+    auto dst = VMLAConversionTarget::allocateOutputBuffer(
+        loc, result, typeConverter, rewriter);
+    rewriter.create<IREE::VMLA::QuantizedConvOp>(
+        loc, rewriter.getRemappedValue(input),
+        VMLAConversionTarget::getTensorShape(loc, input, typeConverter,
+                                             rewriter),
+        rewriter.getRemappedValue(filter),
+        VMLAConversionTarget::getTensorShape(loc, filter, typeConverter,
+                                             rewriter),
+        createI32Buffer(loc, bias, rewriter),
+        createI32Buffer(loc, multiplierMantissa, rewriter),
+        createI32Buffer(loc, multiplierExponent, rewriter), dst,
+        VMLAConversionTarget::getTensorShape(loc, result, typeConverter,
+                                             rewriter),
+        rewriter.getI32VectorAttr(windowStrides),
+        rewriter.getI32VectorAttr(padding), rewriter.getI32VectorAttr(dilation),
+        rewriter.getI32IntegerAttr(srcOp.feature_group_count()),
+        rewriter.getI32IntegerAttr(inputType.getZeroPoint()),
+        rewriter.getI32IntegerAttr(dstType.getZeroPoint()),
+        TypeAttr::get(dstType.getStorageType()));
+    rewriter.replaceOp(srcOp, {dst});
+    return success();
+  }
+
+  TypeConverter &typeConverter;
+};
+
+// Lowers quantized max pooling and elides the window sum of quantized average
+// pooling, which is lowered along with the division that uses it.
+struct QuantizedPoolingOpConversion
+    : public OpConversionPattern<mhlo::ReduceWindowOp> {
+  QuantizedPoolingOpConversion(MLIRContext *context,
+                               TypeConverter &typeConverter)
+      : OpConversionPattern(context, /*benefit=*/2000),
+        typeConverter(typeConverter) {}
+
+  LogicalResult matchAndRewrite(
+      mhlo::ReduceWindowOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    if (isFusedQuantizedOpInterior(srcOp)) {
+      rewriter.replaceOp(srcOp, operands[0]);
+      return success();
+    }
+    if (!isFusedQuantizedOp(srcOp)) return failure();
+    auto loc = srcOp.getLoc();
+    auto src = getDequantizedSource(srcOp.operand());
+    auto result = getQuantizedResult(srcOp.getResult()).getResult();
+    auto quantizedType = getInt8QuantizedType(result);
+    auto storageType = quantizedType.getStorageType();
+
+    // Start from the smallest representable value.
+    int8_t initValue = quantizedType.getStorageTypeMin();
+    auto init = rewriter.create<IREE::VMLA::ConstantOp>(
+        loc, DenseElementsAttr::get(RankedTensorType::get({}, storageType),
+                                    llvm::makeArrayRef(initValue)));
+
+    DenseIntElementsAttr windowDimensions, windowStrides, padding;
+    getWindowAttrs(srcOp, rewriter, windowDimensions, windowStrides, padding);
+    auto dst = VMLAConversionTarget::allocateOutputBuffer(
+        loc, result, typeConverter, rewriter);
+    rewriter.create<IREE::VMLA::PoolingMaxOp>(
+        loc, rewriter.getRemappedValue(src),
+        VMLAConversionTarget::getTensorShape(loc, src, typeConverter,
+                                             rewriter),
+        init,
+        VMLAConversionTarget::getTensorShape(loc, srcOp.init_value(),
+                                             typeConverter, rewriter),
+        dst,
+        VMLAConversionTarget::getTensorShape(loc, result, typeConverter,
+                                             rewriter),
+        TypeAttr::get(storageType), windowDimensions, windowStrides, padding);
+    rewriter.replaceOp(srcOp, {dst});
+    return success();
+  }
+
+  TypeConverter &typeConverter;
+};
+
+struct QuantizedAveragePoolingOpConversion
+    : public OpConversionPattern<mhlo::DivOp> {
+  QuantizedAveragePoolingOpConversion(MLIRContext *context,
+                                      TypeConverter &typeConverter)
+      : OpConversionPattern(context, /*benefit=*/2000),
+        typeConverter(typeConverter) {}
+
+  LogicalResult matchAndRewrite(
+      mhlo::DivOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    if (!isFusedQuantizedOp(srcOp)) return failure();
+    auto loc = srcOp.getLoc();
+    auto sumOp = getAveragePoolingSum(srcOp);
+    auto src = getDequantizedSource(sumOp.operand());
+    auto result = getQuantizedResult(srcOp.getResult()).getResult();
+    auto quantizedType = getInt8QuantizedType(result);
+
+    DenseIntElementsAttr windowDimensions, windowStrides, padding;
+    getWindowAttrs(sumOp, rewriter, windowDimensions, windowStrides, padding);
+    auto dst = VMLAConversionTarget::allocateOutputBuffer(
+        loc, result, typeConverter, rewriter);
+    rewriter.create<IREE::VMLA::PoolingAvgOp>(
+        loc, rewriter.getRemappedValue(src),
+        VMLAConversionTarget::getTensorShape(loc, src, typeConverter,
+                                             rewriter),
+        dst,
+        VMLAConversionTarget::getTensorShape(loc, result, typeConverter,
+                                             rewriter),
+        TypeAttr::get(quantizedType.getStorageType()), windowDimensions,
+        windowStrides, padding);
+    rewriter.replaceOp(srcOp, {dst});
+    return success();
+  }
+
+  TypeConverter &typeConverter;
+};
+
+}  // namespace
+
+void populateHLOQuantizedToVMLAPatterns(MLIRContext *context,
+                                        OwningRewritePatternList &patterns,
+                                        TypeConverter &typeConverter) {
+  patterns.insert<QuantizeCastOpConversion>(context, typeConverter);
+  patterns.insert<DequantizeCastOpConversion>(context, typeConverter);
+  patterns.insert<QuantizedAddOpConversion>(context, typeConverter);
+  patterns.insert<QuantizedMulOpConversion>(context, typeConverter);
+  patterns.insert<QuantizedConvOpConversion>(context, typeConverter);
+  patterns.insert<QuantizedPoolingOpConversion>(context, typeConverter);
+  patterns.insert<QuantizedAveragePoolingOpConversion>(context, typeConverter);
+}
+
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -0,0 +1,345 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/compiler/Dialect/IREE/IR/IREETypes.h"
+#include "iree/compiler/Dialect/Shape/IR/ShapeOps.h"
+#include "iree/compiler/Dialect/VMLA/Conversion/ConversionTarget.h"
+#include "iree/compiler/Dialect/VMLA/Conversion/HLOToVMLA/ConvertHLOToVMLA.h"
+#include "iree/compiler/Dialect/VMLA/Conversion/TypeConverter.h"
+#include "iree/compiler/Dialect/VMLA/IR/VMLADialect.h"
+#include "iree/compiler/Dialect/VMLA/IR/VMLAOps.h"
+#include "iree/compiler/Dialect/VMLA/IR/VMLATypes.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Function.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/Module.h"
+#include "mlir/IR/StandardTypes.h"
+#include "mlir/Transforms/DialectConversion.h"
+#include "tensorflow/compiler/mlir/hlo/include/mlir-hlo/Dialect/mhlo/IR/hlo_ops.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+namespace {
+
+// A single key of a sort comparator: the operand compared and the order.
+struct SortKey {
+  unsigned operandIndex;
+  IREE::VMLA::CmpPredicate predicate;
+};
+
+// Matches an mhlo.compare between the two comparator arguments of the same
+// operand (arg 2i and arg 2i+1) and returns the direction as if the arguments
+// were in order.
+static bool matchArgumentCompare(Value value, Block &block,
+                                 unsigned &operandIndex,
+                                 StringRef &direction) {
+  auto compareOp = value.getDefiningOp<mhlo::CompareOp>();
+  if (!compareOp) return false;
+  auto lhs = compareOp.lhs().dyn_cast<BlockArgument>();
+  auto rhs = compareOp.rhs().dyn_cast<BlockArgument>();
+  if (!lhs || !rhs || lhs.getOwner() != &block || rhs.getOwner() != &block) {
+    return false;
+  }
+  unsigned lhsIndex = lhs.getArgNumber();
+  unsigned rhsIndex = rhs.getArgNumber();
+  if (lhsIndex / 2 != rhsIndex / 2 || lhsIndex == rhsIndex) return false;
+  operandIndex = lhsIndex / 2;
+  direction = compareOp.comparison_direction();
+  if (lhsIndex % 2 == 1) {
+    // Swapped arguments: a > b is the same order as b < a.
+    direction = llvm::StringSwitch<StringRef>(direction)
+                    .Case("LT", "GT")
+                    .Case("GT", "LT")
+                    .Case("LE", "GE")
+                    .Case("GE", "LE")
+                    .Default(direction);
+  }
+  return true;
+}
+
+// Matches a strict ordering of a single operand: compare(a, b, LT|GT).
+static bool matchKeyCompare(Value value, Block &block, SortKey &key) {
+  StringRef direction;
+  if (!matchArgumentCompare(value, block, key.operandIndex, direction)) {
+    return false;
+  }
+  if (direction == "LT") {
+    key.predicate = IREE::VMLA::CmpPredicate::LT;
+  } else if (direction == "GT") {
+    key.predicate = IREE::VMLA::CmpPredicate::GT;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Matches a comparator that orders lexicographically by one or more keys and
+// appends the keys from the most to the least significant. Supported forms
+// are a single key compare and, recursively,
+//   or(key_compare(x), and(compare(x_lhs, x_rhs, EQ), rest))
+// with any operand order for the or/and ops.
+static bool matchComparator(Value value, Block &block,
+                            SmallVectorImpl<SortKey> &keys) {
+  SortKey key;
+  if (matchKeyCompare(value, block, key)) {
+    keys.push_back(key);
+    return true;
+  }
+  auto orOp = value.getDefiningOp<mhlo::OrOp>();
+  if (!orOp) return false;
+  for (auto orOperands : {std::make_pair(orOp.lhs(), orOp.rhs()),
+                          std::make_pair(orOp.rhs(), orOp.lhs())}) {
+    if (!matchKeyCompare(orOperands.first, block, key)) continue;
+    auto andOp = orOperands.second.getDefiningOp<mhlo::AndOp>();
+    if (!andOp) continue;
+    for (auto andOperands : {std::make_pair(andOp.lhs(), andOp.rhs()),
+                             std::make_pair(andOp.rhs(), andOp.lhs())}) {
+      unsigned eqOperandIndex;
+      StringRef direction;
+      if (!matchArgumentCompare(andOperands.first, block, eqOperandIndex,
+                                direction) ||
+          direction != "EQ" || eqOperandIndex != key.operandIndex) {
+        continue;
+      }
+      keys.push_back(key);
+      return matchComparator(andOperands.second, block, keys);
+    }
+  }
+  return false;
+}
+
+// Returns true if |value| is an i32 iota along |dimension|, either as an
+// mhlo.iota or a constant, in which case sorting it yields the sort
+// permutation itself.
+static bool isIndexIota(Value value, int dimension) {
+  auto type = value.getType().cast<ShapedType>();
+  if (!type.getElementType().isInteger(32)) return false;
+  if (auto iotaOp = value.getDefiningOp<mhlo::IotaOp>()) {
+    return iotaOp.iota_dimension().getSExtValue() == dimension;
+  }
+  DenseIntElementsAttr attr;
+  if (!type.hasStaticShape() || !matchPattern(value, m_Constant(&attr))) {
+    return false;
+  }
+  int64_t stride = 1;
+  for (int i = dimension + 1; i < type.getRank(); ++i) {
+    stride *= type.getDimSize(i);
+  }
+  int64_t dimSize = type.getDimSize(dimension);
+  int64_t offset = 0;
+  for (const auto &element : attr.getIntValues()) {
+    if (element.getSExtValue() != (offset++ / stride) % dimSize) return false;
+  }
+  return true;
+}
+
+// Allocates a buffer with the shape of |tensorValue| for elements of
+// |elementType|, which may differ from that of the tensor.
+static Value allocateBuffer(Location loc, Value tensorValue, Type elementType,
+                            TypeConverter &typeConverter,
+                            ConversionPatternRewriter &rewriter) {
+  auto shape = VMLAConversionTarget::getTensorShape(loc, tensorValue,
+                                                     typeConverter, rewriter);
+  if (!shape) return nullptr;
+  auto dims =
+      rewriter.create<Shape::RankedDimsOp>(loc, rewriter.getIndexType(), shape);
+  Value length = rewriter.createOrFold<mlir::ConstantIndexOp>(
+      loc, VMLATypeConverter::getRoundedElementByteWidth(elementType));
+  for (auto dim : dims.getResults()) {
+    length = rewriter.createOrFold<mlir::MulIOp>(loc, length, dim);
+  }
+  return rewriter.createOrFold<IREE::VMLA::BufferAllocOp>(
+      loc, IREE::VMLA::BufferType::get(rewriter.getContext()), length);
+}
+
+// Converts an mhlo.sort with a lexicographic comparator into vmla.sort of the
+// least significant key followed by a vmla.sort.refine for each more
+// significant key. Because each pass is stable the final permutation orders
+// by all keys. The permutation is then applied to each operand with
+// vmla.take_along_axis.
+//
+// When every result is only consumed by identical slices keeping the first k
+// elements along the sorted dimension and there is a single key the sort is
+// instead converted to vmla.topk, which avoids ordering elements that are
+// discarded.
+struct SortOpConversion : public OpConversionPattern<mhlo::SortOp> {
+  SortOpConversion(MLIRContext *context, TypeConverter &typeConverter)
+      : OpConversionPattern(context), typeConverter(typeConverter) {}
+
+  LogicalResult matchAndRewrite(
+      mhlo::SortOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    if (srcOp.comparator().getBlocks().size() != 1) {
+      srcOp.emitRemark() << "control flow in sort comparators not supported";
+      return failure();
+    }
+    auto &block = srcOp.comparator().front();
+    auto returnOp = dyn_cast<mhlo::ReturnOp>(block.getTerminator());
+    SmallVector<SortKey, 2> keys;
+    if (!returnOp || returnOp.getNumOperands() != 1 ||
+        !matchComparator(returnOp.getOperand(0), block, keys)) {
+      srcOp.emitRemark() << "unsupported sort comparator; only lexicographic "
+                            "LT/GT comparisons of operands are supported";
+      return failure();
+    }
+
+    auto operandType = srcOp.operands()[0].getType().cast<ShapedType>();
+    int dimension = srcOp.dimensionAttr().getInt();
+    if (dimension < 0) dimension += operandType.getRank();
+
+    if (succeeded(rewriteAsTopK(srcOp, operands, keys, dimension, rewriter))) {
+      return success();
+    }
+
+    auto loc = srcOp.getLoc();
+    auto shape = VMLAConversionTarget::getTensorShape(
+        loc, srcOp.operands()[0], typeConverter, rewriter);
+    auto indices = allocateBuffer(loc, srcOp.operands()[0],
+                                  rewriter.getIntegerType(32), typeConverter,
+                                  rewriter);
+    for (auto it = keys.rbegin(); it != keys.rend(); ++it) {
+      unsigned i = it->operandIndex;
+      auto elementType =
+          srcOp.operands()[i].getType().cast<ShapedType>().getElementType();
+      if (it == keys.rbegin()) {
+        rewriter.create<IREE::VMLA::SortOp>(
+            loc, operands[i], shape, rewriter.getI32IntegerAttr(dimension),
+            it->predicate, indices, TypeAttr::get(elementType));
+      } else {
+        rewriter.create<IREE::VMLA::SortRefineOp>(
+            loc, operands[i], shape, rewriter.getI32IntegerAttr(dimension),
+            it->predicate, indices, TypeAttr::get(elementType));
+      }
+    }
+
+    SmallVector<Value, 4> results;
+    for (unsigned i = 0; i < operands.size(); ++i) {
+      auto srcOperand = srcOp.operands()[i];
+      if (isIndexIota(srcOperand, dimension)) {
+        results.push_back(indices);
+        continue;
+      }
+      auto dst = VMLAConversionTarget::allocateOutputBuffer(
+          loc, srcOp.getResult(i), typeConverter, rewriter);
+      auto elementType =
+          srcOperand.getType().cast<ShapedType>().getElementType();
+      rewriter.create<IREE::VMLA::TakeAlongAxisOp>(
+          loc, operands[i], shape, indices, shape,
+          rewriter.getI32IntegerAttr(dimension), dst,
+          TypeAttr::get(elementType));
+      results.push_back(dst);
+    }
+    rewriter.replaceOp(srcOp, results);
+    return success();
+  }
+
+  // Converts a single key sort whose results are all sliced to the same first
+  // k elements along |dimension| into vmla.topk. The slices are replaced as
+  // well as the sort.
+  LogicalResult rewriteAsTopK(mhlo::SortOp srcOp, ArrayRef<Value> operands,
+                              ArrayRef<SortKey> keys, int dimension,
+                              ConversionPatternRewriter &rewriter) const {
+    if (keys.size() != 1) return failure();
+    auto operandType = srcOp.operands()[0].getType().cast<ShapedType>();
+    if (!operandType.hasStaticShape()) return failure();
+
+    SmallVector<mhlo::SliceOp, 4> sliceOps;
+    Optional<int64_t> k;
+    for (auto result : srcOp.getResults()) {
+      for (auto *user : result.getUsers()) {
+        auto sliceOp = dyn_cast<mhlo::SliceOp>(user);
+        if (!sliceOp) return failure();
+        for (int i = 0; i < operandType.getRank(); ++i) {
+          uint64_t ui = static_cast<uint64_t>(i);
+          if (sliceOp.start_indices().getValue<int64_t>({ui}) != 0 ||
+              sliceOp.strides().getValue<int64_t>({ui}) != 1) {
+            return failure();
+          }
+          int64_t limit = sliceOp.limit_indices().getValue<int64_t>({ui});
+          if (i != dimension) {
+            if (limit != operandType.getDimSize(i)) return failure();
+          } else if (!k.hasValue()) {
+            k = limit;
+          } else if (limit != k.getValue()) {
+            return failure();
+          }
+        }
+        sliceOps.push_back(sliceOp);
+      }
+    }
+    if (sliceOps.empty() || k.getValue() == operandType.getDimSize(dimension)) {
+      // A full sort gains nothing from selection.
+      return failure();
+    }
+
+    auto loc = srcOp.getLoc();
+    const auto &key = keys.front();
+    auto keyType =
+        srcOp.operands()[key.operandIndex].getType().cast<ShapedType>();
+    auto srcShape = VMLAConversionTarget::getTensorShape(
+        loc, srcOp.operands()[0], typeConverter, rewriter);
+    auto sliceResult = sliceOps.front().getResult();
+    auto dstShape = VMLAConversionTarget::getTensorShape(
+        loc, sliceResult, typeConverter, rewriter);
+    auto values = allocateBuffer(loc, sliceResult, keyType.getElementType(),
+                                 typeConverter, rewriter);
+    auto indices = allocateBuffer(loc, sliceResult,
+                                  rewriter.getIntegerType(32), typeConverter,
+                                  rewriter);
+    rewriter.create<IREE::VMLA::TopKOp>(
+        loc, operands[key.operandIndex], srcShape,
+        rewriter.getI32IntegerAttr(dimension), key.predicate, values, indices,
+        dstShape, TypeAttr::get(keyType.getElementType()));
+
+    for (auto sliceOp : sliceOps) {
+      unsigned i = sliceOp.operand().cast<OpResult>().getResultNumber();
+      auto srcOperand = srcOp.operands()[i];
+      if (i == key.operandIndex) {
+        rewriter.replaceOp(sliceOp, {values});
+        continue;
+      } else if (isIndexIota(srcOperand, dimension)) {
+        rewriter.replaceOp(sliceOp, {indices});
+        continue;
+      }
+      auto dst = VMLAConversionTarget::allocateOutputBuffer(
+          loc, sliceOp.getResult(), typeConverter, rewriter);
+      auto elementType =
+          srcOperand.getType().cast<ShapedType>().getElementType();
+      rewriter.create<IREE::VMLA::TakeAlongAxisOp>(
+          loc, operands[i], srcShape, indices, dstShape,
+          rewriter.getI32IntegerAttr(dimension), dst,
+          TypeAttr::get(elementType));
+      rewriter.replaceOp(sliceOp, {dst});
+    }
+    rewriter.eraseOp(srcOp);
+    return success();
+  }
+
+  TypeConverter &typeConverter;
+};
+
+}  // namespace
+
+void populateHLOSortToVMLAPatterns(MLIRContext *context,
+                                   OwningRewritePatternList &patterns,
+                                   TypeConverter &typeConverter) {
+  patterns.insert<SortOpConversion>(context, typeConverter);
+}
+
+}  // namespace iree_compiler
+}  // namespace mlir
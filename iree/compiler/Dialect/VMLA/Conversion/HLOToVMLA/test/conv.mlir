@@ -28,3 +28,53 @@ func @conv(%arg0: tensor<1x4x5x2xf32>, %arg1: tensor<3x2x2x1xf32>) -> tensor<1x2
         window_strides = dense<1> : tensor<2xi64>} : (tensor<1x4x5x2xf32>, tensor<3x2x2x1xf32>) -> tensor<1x2x3x1xf32>
  return %2: tensor<1x2x3x1xf32>
 }
+
+// -----
+
+// CHECK-LABEL: @conv_f16
+func @conv_f16(%arg0: tensor<1x4x5x2xf16>, %arg1: tensor<3x2x2x1xf16>) -> tensor<1x2x3x1xf16> attributes { sym_visibility = "private" } {
+  // CHECK: vmla.conv %arg0({{.+}}) : f16, %arg1({{.+}}) : f16, out %{{.+}}({{.+}}) : f16
+  %2 = "mhlo.convolution"(%arg0, %arg1) {
+        batch_group_count = 1 : i64,
+        dimension_numbers = {
+          input_batch_dimension = 0 : i64,
+          input_feature_dimension = 3 : i64,
+          input_spatial_dimensions = dense<[1, 2]> : tensor<2xi64>,
+          kernel_input_feature_dimension = 2 : i64,
+          kernel_output_feature_dimension = 3 : i64,
+          kernel_spatial_dimensions = dense<[0, 1]> : tensor<2xi64>,
+          output_batch_dimension = 0 : i64,
+          output_feature_dimension = 3 : i64,
+          output_spatial_dimensions = dense<[1, 2]> : tensor<2xi64>},
+        feature_group_count = 1 : i64,
+        rhs_dilation = dense<1> : tensor<2xi64>,
+        lhs_dilation = dense<1> : tensor<2xi64>,
+        padding = dense<[[1, 2],[2, 2]]> : tensor<2x2xi64>,
+        window_strides = dense<1> : tensor<2xi64>} : (tensor<1x4x5x2xf16>, tensor<3x2x2x1xf16>) -> tensor<1x2x3x1xf16>
+ return %2: tensor<1x2x3x1xf16>
+}
+
+// -----
+
+// CHECK-LABEL: @conv_bf16
+func @conv_bf16(%arg0: tensor<1x4x5x2xbf16>, %arg1: tensor<3x2x2x1xbf16>) -> tensor<1x2x3x1xbf16> attributes { sym_visibility = "private" } {
+  // CHECK: vmla.conv %arg0({{.+}}) : bf16, %arg1({{.+}}) : bf16, out %{{.+}}({{.+}}) : bf16
+  %2 = "mhlo.convolution"(%arg0, %arg1) {
+        batch_group_count = 1 : i64,
+        dimension_numbers = {
+          input_batch_dimension = 0 : i64,
+          input_feature_dimension = 3 : i64,
+          input_spatial_dimensions = dense<[1, 2]> : tensor<2xi64>,
+          kernel_input_feature_dimension = 2 : i64,
+          kernel_output_feature_dimension = 3 : i64,
+          kernel_spatial_dimensions = dense<[0, 1]> : tensor<2xi64>,
+          output_batch_dimension = 0 : i64,
+          output_feature_dimension = 3 : i64,
+          output_spatial_dimensions = dense<[1, 2]> : tensor<2xi64>},
+        feature_group_count = 1 : i64,
+        rhs_dilation = dense<1> : tensor<2xi64>,
+        lhs_dilation = dense<1> : tensor<2xi64>,
+        padding = dense<[[1, 2],[2, 2]]> : tensor<2x2xi64>,
+        window_strides = dense<1> : tensor<2xi64>} : (tensor<1x4x5x2xbf16>, tensor<3x2x2x1xbf16>) -> tensor<1x2x3x1xbf16>
+ return %2: tensor<1x2x3x1xbf16>
+}
@@ -13,3 +13,11 @@ func @noop(%arg0 : tensor<?xf32>) -> (tensor<5xf32>) attributes { sym_visibility
   %0 = "mhlo.convert"(%arg0) : (tensor<?xf32>) -> tensor<5xf32>
   return %0 : tensor<5xf32>
 }
+
+// CHECK-LABEL: func @bf16_through_f32
+func @bf16_through_f32(%arg0 : tensor<5xi32>) -> (tensor<5xbf16>) attributes { sym_visibility = "private" } {
+  // CHECK: vmla.convert %arg0, out %[[F32:.+]] : i32 -> f32
+  // CHECK: vmla.convert %[[F32]], out %{{.+}} : f32 -> bf16
+  %0 = "mhlo.convert"(%arg0) : (tensor<5xi32>) -> tensor<5xbf16>
+  return %0 : tensor<5xbf16>
+}
@@ -0,0 +1,26 @@
+// RUN: iree-opt -split-input-file -iree-vmla-pre-conversion-lowering -iree-vmla-conversion -canonicalize %s | IreeFileCheck %s
+
+// CHECK-LABEL: @dot_f32
+func @dot_f32(%arg0: tensor<3x4xf32>, %arg1: tensor<4x5xf32>) -> tensor<3x5xf32> attributes { sym_visibility = "private" } {
+  // CHECK: vmla.batch.matmul %{{.+}}({{.+}}) : f32, %{{.+}}({{.+}}) : f32, out %{{.+}}({{.+}}) : f32
+  %0 = "mhlo.dot"(%arg0, %arg1) : (tensor<3x4xf32>, tensor<4x5xf32>) -> tensor<3x5xf32>
+  return %0 : tensor<3x5xf32>
+}
+
+// -----
+
+// CHECK-LABEL: @dot_f16
+func @dot_f16(%arg0: tensor<3x4xf16>, %arg1: tensor<4x5xf16>) -> tensor<3x5xf16> attributes { sym_visibility = "private" } {
+  // CHECK: vmla.batch.matmul %{{.+}}({{.+}}) : f16, %{{.+}}({{.+}}) : f16, out %{{.+}}({{.+}}) : f16
+  %0 = "mhlo.dot"(%arg0, %arg1) : (tensor<3x4xf16>, tensor<4x5xf16>) -> tensor<3x5xf16>
+  return %0 : tensor<3x5xf16>
+}
+
+// -----
+
+// CHECK-LABEL: @dot_bf16
+func @dot_bf16(%arg0: tensor<3x4xbf16>, %arg1: tensor<4x5xbf16>) -> tensor<3x5xbf16> attributes { sym_visibility = "private" } {
+  // CHECK: vmla.batch.matmul %{{.+}}({{.+}}) : bf16, %{{.+}}({{.+}}) : bf16, out %{{.+}}({{.+}}) : bf16
+  %0 = "mhlo.dot"(%arg0, %arg1) : (tensor<3x4xbf16>, tensor<4x5xbf16>) -> tensor<3x5xbf16>
+  return %0 : tensor<3x5xbf16>
+}
@@ -0,0 +1,128 @@
+// RUN: iree-opt -split-input-file -iree-vmla-conversion -cse %s | IreeFileCheck %s
+
+// CHECK-LABEL: @quantized_add
+func @quantized_add(%arg0: tensor<4xf32>, %arg1: tensor<4xf32>) -> tensor<4xf32> attributes { sym_visibility = "private" } {
+  //      CHECK: %[[LHS:.+]] = vmla.buffer.alloc
+  // CHECK-NEXT: vmla.quantize %arg0, out %[[LHS]] {exponent = 2 : i32, multiplier = 1073741824 : i32, zero_point = -3 : i32} : i8
+  //      CHECK: %[[RHS:.+]] = vmla.buffer.alloc
+  // CHECK-NEXT: vmla.quantize %arg1, out %[[RHS]] {exponent = 3 : i32, multiplier = 1073741824 : i32, zero_point = 5 : i32} : i8
+  //      CHECK: %[[SUM:.+]] = vmla.buffer.alloc
+  // CHECK-NEXT: vmla.quantized.add %[[LHS]], %[[RHS]], out %[[SUM]] {dst_exponent = -19 : i32, dst_multiplier = 1073741824 : i32, dst_zero_point = 0 : i32, lhs_exponent = 0 : i32, lhs_multiplier = 1073741824 : i32, lhs_zero_point = -3 : i32, rhs_exponent = -1 : i32, rhs_multiplier = 1073741824 : i32, rhs_zero_point = 5 : i32} : i8
+  //      CHECK: %[[DST:.+]] = vmla.buffer.alloc
+  // CHECK-NEXT: vmla.dequantize %[[SUM]], out %[[DST]] {exponent = 1 : i32, multiplier = 1073741824 : i32, zero_point = 0 : i32} : i8
+  %0 = "quant.qcast"(%arg0) : (tensor<4xf32>) -> tensor<4x!quant.uniform<i8:f32, 0.5:-3>>
+  %1 = "quant.dcast"(%0) : (tensor<4x!quant.uniform<i8:f32, 0.5:-3>>) -> tensor<4xf32>
+  %2 = "quant.qcast"(%arg1) : (tensor<4xf32>) -> tensor<4x!quant.uniform<i8:f32, 0.25:5>>
+  %3 = "quant.dcast"(%2) : (tensor<4x!quant.uniform<i8:f32, 0.25:5>>) -> tensor<4xf32>
+  %4 = mhlo.add %1, %3 : tensor<4xf32>
+  %5 = "quant.qcast"(%4) : (tensor<4xf32>) -> tensor<4x!quant.uniform<i8:f32, 1.0>>
+  %6 = "quant.dcast"(%5) : (tensor<4x!quant.uniform<i8:f32, 1.0>>) -> tensor<4xf32>
+  // CHECK: return %[[DST]]
+  return %6 : tensor<4xf32>
+}
+
+// -----
+
+// CHECK-LABEL: @quantized_mul
+func @quantized_mul(%arg0: tensor<4xf32>, %arg1: tensor<4xf32>) -> tensor<4xf32> attributes { sym_visibility = "private" } {
+  // CHECK: vmla.quantized.mul %{{.+}}, %{{.+}}, out %{{.+}} {dst_zero_point = 0 : i32, exponent = -2 : i32, lhs_zero_point = -3 : i32, multiplier = 1073741824 : i32, rhs_zero_point = 5 : i32} : i8
+  %0 = "quant.qcast"(%arg0) : (tensor<4xf32>) -> tensor<4x!quant.uniform<i8:f32, 0.5:-3>>
+  %1 = "quant.dcast"(%0) : (tensor<4x!quant.uniform<i8:f32, 0.5:-3>>) -> tensor<4xf32>
+  %2 = "quant.qcast"(%arg1) : (tensor<4xf32>) -> tensor<4x!quant.uniform<i8:f32, 0.25:5>>
+  %3 = "quant.dcast"(%2) : (tensor<4x!quant.uniform<i8:f32, 0.25:5>>) -> tensor<4xf32>
+  %4 = mhlo.multiply %1, %3 : tensor<4xf32>
+  %5 = "quant.qcast"(%4) : (tensor<4xf32>) -> tensor<4x!quant.uniform<i8:f32, 1.0>>
+  %6 = "quant.dcast"(%5) : (tensor<4x!quant.uniform<i8:f32, 1.0>>) -> tensor<4xf32>
+  return %6 : tensor<4xf32>
+}
+
+// -----
+
+// CHECK-LABEL: @quantized_conv
+func @quantized_conv(%arg0: tensor<1x4x4x2xf32>) -> tensor<1x4x4x3xf32> attributes { sym_visibility = "private" } {
+  // Weights are quantized at compile time and the per-channel multipliers are
+  // input_scale * filter_scale[c] / dst_scale = [0.2, 0.4, 0.8].
+  //  CHECK-DAG: %[[FILTER:.+]] = vmla.constant dense<{{.+}}> : tensor<3x3x2x3xi8>
+  //  CHECK-DAG: %[[BIAS:.+]] = vmla.constant dense<0> : tensor<3xi32>
+  //  CHECK-DAG: %[[MANTISSA:.+]] = vmla.constant dense<1717986918> : tensor<3xi32>
+  //  CHECK-DAG: %[[EXPONENT:.+]] = vmla.constant dense<[-2, -1, 0]> : tensor<3xi32>
+  //      CHECK: vmla.quantized.conv %{{.+}}(%{{.+}} : !shapex.ranked_shape<[1,4,4,2]>), %[[FILTER]](%{{.+}} : !shapex.ranked_shape<[3,3,2,3]>), %[[BIAS]], %[[MANTISSA]], %[[EXPONENT]], out %{{.+}}(%{{.+}} : !shapex.ranked_shape<[1,4,4,3]>)
+  // CHECK-SAME: dilation = dense<1> : vector<2xi32>
+  // CHECK-SAME: dst_zero_point = -2 : i32
+  // CHECK-SAME: feature_group_count = 1 : i32
+  // CHECK-SAME: input_zero_point = 1 : i32
+  // CHECK-SAME: padding = dense<1> : vector<4xi32>
+  // CHECK-SAME: window_strides = dense<1> : vector<2xi32>
+  // CHECK-SAME: : i8
+  //  CHECK-NOT: vmla.conv
+  %weights = constant dense<0.5> : tensor<3x3x2x3xf32>
+  %0 = "quant.qcast"(%weights) : (tensor<3x3x2x3xf32>) -> tensor<3x3x2x3x!quant.uniform<i8:f32:3, {0.1,0.2,0.4}>>
+  %1 = "quant.dcast"(%0) : (tensor<3x3x2x3x!quant.uniform<i8:f32:3, {0.1,0.2,0.4}>>) -> tensor<3x3x2x3xf32>
+  %2 = "quant.qcast"(%arg0) : (tensor<1x4x4x2xf32>) -> tensor<1x4x4x2x!quant.uniform<i8:f32, 0.5:1>>
+  %3 = "quant.dcast"(%2) : (tensor<1x4x4x2x!quant.uniform<i8:f32, 0.5:1>>) -> tensor<1x4x4x2xf32>
+  %4 = "mhlo.convolution"(%3, %1) {
+        batch_group_count = 1 : i64,
+        dimension_numbers = {
+          input_batch_dimension = 0 : i64,
+          input_feature_dimension = 3 : i64,
+          input_spatial_dimensions = dense<[1, 2]> : tensor<2xi64>,
+          kernel_input_feature_dimension = 2 : i64,
+          kernel_output_feature_dimension = 3 : i64,
+          kernel_spatial_dimensions = dense<[0, 1]> : tensor<2xi64>,
+          output_batch_dimension = 0 : i64,
+          output_feature_dimension = 3 : i64,
+          output_spatial_dimensions = dense<[1, 2]> : tensor<2xi64>},
+        feature_group_count = 1 : i64,
+        padding = dense<1> : tensor<2x2xi64>,
+        window_strides = dense<1> : tensor<2xi64>} : (tensor<1x4x4x2xf32>, tensor<3x3x2x3xf32>) -> tensor<1x4x4x3xf32>
+  %5 = "quant.qcast"(%4) : (tensor<1x4x4x3xf32>) -> tensor<1x4x4x3x!quant.uniform<i8:f32, 0.25:-2>>
+  %6 = "quant.dcast"(%5) : (tensor<1x4x4x3x!quant.uniform<i8:f32, 0.25:-2>>) -> tensor<1x4x4x3xf32>
+  return %6 : tensor<1x4x4x3xf32>
+}
+
+// -----
+
+// CHECK-LABEL: @quantized_avg_pool
+func @quantized_avg_pool(%arg0: tensor<1x4x4x8xf32>) -> tensor<1x2x2x8xf32> attributes { sym_visibility = "private" } {
+  //      CHECK: vmla.pooling.avg %{{.+}}(%{{.+}} : !shapex.ranked_shape<[1,4,4,8]>), out %{{.+}}(%{{.+}} : !shapex.ranked_shape<[1,2,2,8]>)
+  // CHECK-SAME: : i8
+  //  CHECK-NOT: vmla.pooling.sum
+  //  CHECK-NOT: vmla.div
+  %0 = "quant.qcast"(%arg0) : (tensor<1x4x4x8xf32>) -> tensor<1x4x4x8x!quant.uniform<i8:f32, 0.5:-3>>
+  %1 = "quant.dcast"(%0) : (tensor<1x4x4x8x!quant.uniform<i8:f32, 0.5:-3>>) -> tensor<1x4x4x8xf32>
+  %cst = constant dense<0.0> : tensor<f32>
+  %2 = "mhlo.reduce_window"(%1, %cst) ( {
+  ^bb0(%arg1: tensor<f32>, %arg2: tensor<f32>):  // no predecessors
+    %3 = mhlo.add %arg1, %arg2 : tensor<f32>
+    "mhlo.return"(%3) : (tensor<f32>) -> ()
+  }) {window_dimensions = dense<[1, 2, 2, 1]> : tensor<4xi64>,
+      window_strides = dense<[1, 2, 2, 1]> : tensor<4xi64>
+  } : (tensor<1x4x4x8xf32>, tensor<f32>) -> tensor<1x2x2x8xf32>
+  %count = constant dense<4.0> : tensor<1x2x2x8xf32>
+  %4 = mhlo.divide %2, %count : tensor<1x2x2x8xf32>
+  %5 = "quant.qcast"(%4) : (tensor<1x2x2x8xf32>) -> tensor<1x2x2x8x!quant.uniform<i8:f32, 0.5:-3>>
+  %6 = "quant.dcast"(%5) : (tensor<1x2x2x8x!quant.uniform<i8:f32, 0.5:-3>>) -> tensor<1x2x2x8xf32>
+  return %6 : tensor<1x2x2x8xf32>
+}
+
+// -----
+
+// CHECK-LABEL: @quantized_max_pool
+func @quantized_max_pool(%arg0: tensor<1x4x4x8xf32>) -> tensor<1x2x2x8xf32> attributes { sym_visibility = "private" } {
+  //      CHECK: %[[INIT:.+]] = vmla.constant dense<-128> : tensor<i8>
+  //      CHECK: vmla.pooling.max %{{.+}}(%{{.+}} : !shapex.ranked_shape<[1,4,4,8]>), %[[INIT]](%{{.+}} : !shapex.ranked_shape<[]>), out %{{.+}}(%{{.+}} : !shapex.ranked_shape<[1,2,2,8]>)
+  // CHECK-SAME: : i8
+  %0 = "quant.qcast"(%arg0) : (tensor<1x4x4x8xf32>) -> tensor<1x4x4x8x!quant.uniform<i8:f32, 0.5:-3>>
+  %1 = "quant.dcast"(%0) : (tensor<1x4x4x8x!quant.uniform<i8:f32, 0.5:-3>>) -> tensor<1x4x4x8xf32>
+  %cst = constant dense<0xFF800000> : tensor<f32>
+  %2 = "mhlo.reduce_window"(%1, %cst) ( {
+  ^bb0(%arg1: tensor<f32>, %arg2: tensor<f32>):  // no predecessors
+    %3 = mhlo.maximum %arg1, %arg2 : tensor<f32>
+    "mhlo.return"(%3) : (tensor<f32>) -> ()
+  }) {window_dimensions = dense<[1, 2, 2, 1]> : tensor<4xi64>,
+      window_strides = dense<[1, 2, 2, 1]> : tensor<4xi64>
+  } : (tensor<1x4x4x8xf32>, tensor<f32>) -> tensor<1x2x2x8xf32>
+  %4 = "quant.qcast"(%2) : (tensor<1x2x2x8xf32>) -> tensor<1x2x2x8x!quant.uniform<i8:f32, 0.5:-3>>
+  %5 = "quant.dcast"(%4) : (tensor<1x2x2x8x!quant.uniform<i8:f32, 0.5:-3>>) -> tensor<1x2x2x8xf32>
+  return %5 : tensor<1x2x2x8xf32>
+}
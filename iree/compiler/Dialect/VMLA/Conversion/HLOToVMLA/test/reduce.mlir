@@ -55,3 +55,37 @@ func @multi_reduction(%arg0 : tensor<4x8xf32>, %arg1 : tensor<4x8xf32>) -> (tens
   // CHECK-NEXT: return %[[RET0]], %[[RET1]] : !vmla.buffer, !vmla.buffer
   return %2, %3 : tensor<4xf32>, tensor<4xf32>
 }
+
+// -----
+
+// CHECK-LABEL: @reduction_f16
+func @reduction_f16(%arg0: tensor<4x8xf16>) -> tensor<4xf16> attributes { sym_visibility = "private" } {
+  // CHECK-DAG: %[[INIT:.+]] = vmla.constant dense<0.000000e+00> : tensor<f16> -> !vmla.buffer
+  %cst = constant dense<0.000000e+00> : tensor<f16>
+  // CHECK: vmla.reduce.sum
+  // CHECK-SAME: %[[INIT]]
+  // CHECK-SAME: {dimension = 1 : i32} : f16
+  %0 = "mhlo.reduce"(%arg0, %cst) ( {
+  ^bb0(%arg1: tensor<f16>, %arg2: tensor<f16>):  // no predecessors
+    %1 = mhlo.add %arg1, %arg2 : tensor<f16>
+    "mhlo.return"(%1) : (tensor<f16>) -> ()
+  }) {dimensions = dense<1> : tensor<1xi64>} : (tensor<4x8xf16>, tensor<f16>) -> tensor<4xf16>
+  return %0 : tensor<4xf16>
+}
+
+// -----
+
+// CHECK-LABEL: @reduction_bf16
+func @reduction_bf16(%arg0: tensor<4x8xbf16>) -> tensor<4xbf16> attributes { sym_visibility = "private" } {
+  // CHECK-DAG: %[[INIT:.+]] = vmla.constant dense<0xFF80> : tensor<bf16> -> !vmla.buffer
+  %cst = constant dense<0xFF80> : tensor<bf16>
+  // CHECK: vmla.reduce.max
+  // CHECK-SAME: %[[INIT]]
+  // CHECK-SAME: {dimension = 1 : i32} : bf16
+  %0 = "mhlo.reduce"(%arg0, %cst) ( {
+  ^bb0(%arg1: tensor<bf16>, %arg2: tensor<bf16>):  // no predecessors
+    %1 = mhlo.maximum %arg1, %arg2 : tensor<bf16>
+    "mhlo.return"(%1) : (tensor<bf16>) -> ()
+  }) {dimensions = dense<1> : tensor<1xi64>} : (tensor<4x8xbf16>, tensor<bf16>) -> tensor<4xbf16>
+  return %0 : tensor<4xbf16>
+}
@@ -0,0 +1,64 @@
+// RUN: iree-opt -split-input-file -iree-vmla-conversion -cse %s | IreeFileCheck %s
+
+// CHECK-LABEL: @sort_single_key
+func @sort_single_key(%arg0: tensor<4x8xf32>, %arg1: tensor<4x8xi32>) -> (tensor<4x8xf32>, tensor<4x8xi32>) attributes { sym_visibility = "private" } {
+  //  CHECK-DAG: %[[SHAPE:.+]] = shapex.const_ranked_shape : !shapex.ranked_shape<[4,8]>
+  //  CHECK-DAG: %[[INDICES:.+]] = vmla.buffer.alloc
+  //      CHECK: vmla.sort "GT", %arg0(%[[SHAPE]] : !shapex.ranked_shape<[4,8]>), out %[[INDICES]] {dimension = 1 : i32} : f32
+  //      CHECK: %[[VALUES:.+]] = vmla.buffer.alloc
+  // CHECK-NEXT: vmla.take_along_axis %arg0(%[[SHAPE]] : !shapex.ranked_shape<[4,8]>), %[[INDICES]](%[[SHAPE]] : !shapex.ranked_shape<[4,8]>), out %[[VALUES]] {dimension = 1 : i32} : f32
+  //      CHECK: %[[PAYLOAD:.+]] = vmla.buffer.alloc
+  // CHECK-NEXT: vmla.take_along_axis %arg1(%[[SHAPE]] : !shapex.ranked_shape<[4,8]>), %[[INDICES]](%[[SHAPE]] : !shapex.ranked_shape<[4,8]>), out %[[PAYLOAD]] {dimension = 1 : i32} : i32
+  %0:2 = "mhlo.sort"(%arg0, %arg1) ( {
+  ^bb0(%a: tensor<f32>, %b: tensor<f32>, %c: tensor<i32>, %d: tensor<i32>):
+    %1 = "mhlo.compare"(%a, %b) {comparison_direction = "GT"} : (tensor<f32>, tensor<f32>) -> tensor<i1>
+    "mhlo.return"(%1) : (tensor<i1>) -> ()
+  }) {dimension = 1 : i64, is_stable = true} : (tensor<4x8xf32>, tensor<4x8xi32>) -> (tensor<4x8xf32>, tensor<4x8xi32>)
+  // CHECK: return %[[VALUES]], %[[PAYLOAD]]
+  return %0#0, %0#1 : tensor<4x8xf32>, tensor<4x8xi32>
+}
+
+// -----
+
+// CHECK-LABEL: @sort_multi_key
+func @sort_multi_key(%arg0: tensor<16xi32>, %arg1: tensor<16xf32>) -> tensor<16xi32> attributes { sym_visibility = "private" } {
+  // The least significant key is sorted first and then refined by the more
+  // significant key. Sorting an iota yields the permutation directly.
+  //      CHECK: %[[INDICES:.+]] = vmla.buffer.alloc
+  //      CHECK: vmla.sort "GT", %arg1({{.+}}), out %[[INDICES]] {dimension = 0 : i32} : f32
+  //      CHECK: vmla.sort.refine "LT", %arg0({{.+}}), out %[[INDICES]] {dimension = 0 : i32} : i32
+  %iota = constant dense<[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15]> : tensor<16xi32>
+  %0:3 = "mhlo.sort"(%arg0, %arg1, %iota) ( {
+  ^bb0(%a: tensor<i32>, %b: tensor<i32>, %c: tensor<f32>, %d: tensor<f32>, %e: tensor<i32>, %f: tensor<i32>):
+    %lt = "mhlo.compare"(%a, %b) {comparison_direction = "LT"} : (tensor<i32>, tensor<i32>) -> tensor<i1>
+    %eq = "mhlo.compare"(%a, %b) {comparison_direction = "EQ"} : (tensor<i32>, tensor<i32>) -> tensor<i1>
+    %gt = "mhlo.compare"(%d, %c) {comparison_direction = "LT"} : (tensor<f32>, tensor<f32>) -> tensor<i1>
+    %and = mhlo.and %eq, %gt : tensor<i1>
+    %or = mhlo.or %lt, %and : tensor<i1>
+    "mhlo.return"(%or) : (tensor<i1>) -> ()
+  }) {dimension = 0 : i64, is_stable = true} : (tensor<16xi32>, tensor<16xf32>, tensor<16xi32>) -> (tensor<16xi32>, tensor<16xf32>, tensor<16xi32>)
+  // CHECK: return %[[INDICES]]
+  return %0#2 : tensor<16xi32>
+}
+
+// -----
+
+// CHECK-LABEL: @sort_then_slice_to_topk
+func @sort_then_slice_to_topk(%arg0: tensor<2x8xf32>) -> (tensor<2x3xf32>, tensor<2x3xi32>) attributes { sym_visibility = "private" } {
+  //  CHECK-DAG: %[[SRC_SHAPE:.+]] = shapex.const_ranked_shape : !shapex.ranked_shape<[2,8]>
+  //  CHECK-DAG: %[[DST_SHAPE:.+]] = shapex.const_ranked_shape : !shapex.ranked_shape<[2,3]>
+  //  CHECK-DAG: %[[VALUES:.+]] = vmla.buffer.alloc
+  //  CHECK-DAG: %[[INDICES:.+]] = vmla.buffer.alloc
+  //      CHECK: vmla.topk "GT", %arg0(%[[SRC_SHAPE]] : !shapex.ranked_shape<[2,8]>), out %[[VALUES]], %[[INDICES]](%[[DST_SHAPE]] : !shapex.ranked_shape<[2,3]>) {dimension = 1 : i32} : f32
+  //  CHECK-NOT: vmla.sort
+  %iota = constant dense<[[0, 1, 2, 3, 4, 5, 6, 7], [0, 1, 2, 3, 4, 5, 6, 7]]> : tensor<2x8xi32>
+  %0:2 = "mhlo.sort"(%arg0, %iota) ( {
+  ^bb0(%a: tensor<f32>, %b: tensor<f32>, %c: tensor<i32>, %d: tensor<i32>):
+    %1 = "mhlo.compare"(%a, %b) {comparison_direction = "GT"} : (tensor<f32>, tensor<f32>) -> tensor<i1>
+    "mhlo.return"(%1) : (tensor<i1>) -> ()
+  }) {dimension = -1 : i64, is_stable = true} : (tensor<2x8xf32>, tensor<2x8xi32>) -> (tensor<2x8xf32>, tensor<2x8xi32>)
+  %2 = "mhlo.slice"(%0#0) {start_indices = dense<0> : tensor<2xi64>, limit_indices = dense<[2, 3]> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>} : (tensor<2x8xf32>) -> tensor<2x3xf32>
+  %3 = "mhlo.slice"(%0#1) {start_indices = dense<0> : tensor<2xi64>, limit_indices = dense<[2, 3]> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>} : (tensor<2x8xi32>) -> tensor<2x3xi32>
+  // CHECK: return %[[VALUES]], %[[INDICES]]
+  return %2, %3 : tensor<2x3xf32>, tensor<2x3xi32>
+}
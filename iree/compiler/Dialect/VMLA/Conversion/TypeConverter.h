@@ -15,6 +15,7 @@
 #ifndef IREE_COMPILER_DIALECT_VMLA_CONVERSION_TYPECONVERTER_H_
 #define IREE_COMPILER_DIALECT_VMLA_CONVERSION_TYPECONVERTER_H_
 
+#include "mlir/Dialect/Quant/QuantTypes.h"
 #include "mlir/Transforms/DialectConversion.h"
 
 namespace mlir {
@@ -26,7 +27,11 @@ class VMLATypeConverter : public TypeConverter {
 
   // Returns the number of bytes an element of the given type occupies
   // post-conversion. For example, the size of i1 would be '1 byte'.
+  // Quantized types occupy the size of their storage type.
   static int32_t getRoundedElementByteWidth(Type type) {
+    if (auto quantizedType = type.dyn_cast<quant::QuantizedType>()) {
+      type = quantizedType.getStorageType();
+    }
     return (type.getIntOrFloatBitWidth() + 8 - 1) / 8;
   }
 
@@ -116,7 +116,9 @@ class VMLAImportOpConversion : public OpConversionPattern<T> {
     }
 
     std::string typePrefix = "x";
-    if (elementType.isa<FloatType>()) {
+    if (elementType.isBF16()) {
+      return "bf16";
+    } else if (elementType.isa<FloatType>()) {
       typePrefix = "f";
     } else if (elementType.isSignlessInteger()) {
       typePrefix = forceUnsigned ? "u" : "i";
@@ -284,6 +286,7 @@ void populateVMLAToVMPatterns(MLIRContext *context,
   VMLA_SIZED_IMPORT_OP(IREE::VMLA::ReverseOp, "vmla.reverse");
   VMLA_SIZED_IMPORT_OP(IREE::VMLA::PadOp, "vmla.pad");
   VMLA_SIZED_IMPORT_OP(IREE::VMLA::GatherOp, "vmla.gather");
+  VMLA_SIZED_IMPORT_OP(IREE::VMLA::TakeAlongAxisOp, "vmla.take_along_axis");
   VMLA_SIZED_IMPORT_OP(IREE::VMLA::ScatterOp, "vmla.scatter");
   VMLA_SIZED_IMPORT_OP(IREE::VMLA::BroadcastOp, "vmla.broadcast");
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::IotaOp, "vmla.iota");
@@ -318,6 +321,7 @@ void populateVMLAToVMPatterns(MLIRContext *context,
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::ClampOp, "vmla.clamp");
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::FloorOp, "vmla.floor");
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::CeilOp, "vmla.ceil");
+  VMLA_TYPED_IMPORT_OP(IREE::VMLA::ElementwiseOp, "vmla.elementwise");
 
   patterns.insert<VMLAConvertImportOpConversion>(context, importSymbols,
                                                  typeConverter, "vmla.convert");
@@ -326,6 +330,12 @@ void populateVMLAToVMPatterns(MLIRContext *context,
   patterns.insert<VMLAConvImportOpConversion>(context, importSymbols,
                                               typeConverter, "vmla.conv");
 
+  VMLA_TYPED_IMPORT_OP(IREE::VMLA::QuantizeOp, "vmla.quantize");
+  VMLA_TYPED_IMPORT_OP(IREE::VMLA::DequantizeOp, "vmla.dequantize");
+  VMLA_TYPED_IMPORT_OP(IREE::VMLA::QuantizedAddOp, "vmla.quantized.add");
+  VMLA_TYPED_IMPORT_OP(IREE::VMLA::QuantizedMulOp, "vmla.quantized.mul");
+  VMLA_TYPED_IMPORT_OP(IREE::VMLA::QuantizedConvOp, "vmla.quantized.conv");
+
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::ReduceSumOp, "vmla.reduce.sum");
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::ReduceMinOp, "vmla.reduce.min");
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::ReduceMaxOp, "vmla.reduce.max");
@@ -333,6 +343,11 @@ void populateVMLAToVMPatterns(MLIRContext *context,
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::PoolingSumOp, "vmla.pooling.sum");
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::PoolingMinOp, "vmla.pooling.min");
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::PoolingMaxOp, "vmla.pooling.max");
+  VMLA_TYPED_IMPORT_OP(IREE::VMLA::PoolingAvgOp, "vmla.pooling.avg");
+
+  VMLA_TYPED_IMPORT_OP(IREE::VMLA::SortOp, "vmla.sort");
+  VMLA_TYPED_IMPORT_OP(IREE::VMLA::SortRefineOp, "vmla.sort.refine");
+  VMLA_TYPED_IMPORT_OP(IREE::VMLA::TopKOp, "vmla.topk");
 
   VMLA_IMPORT_OP(IREE::VMLA::InterfaceConstOp, "vmla.interface.const");
   VMLA_IMPORT_OP(IREE::VMLA::InterfaceBindingOp, "vmla.interface.binding");
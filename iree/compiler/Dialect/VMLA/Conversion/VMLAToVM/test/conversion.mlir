@@ -58,6 +58,15 @@ func @shapeExpansion(%arg0 : !vmla.buffer, %arg1 : index, %arg2 : !vmla.buffer,
 
 // -----
 
+// CHECK-LABEL: vm.func @elementwise
+func @elementwise(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer, %arg2 : !vmla.buffer) {
+  // CHECK: vm.call.variadic @vmla.elementwise.f32([{{.+}}], [%arg0, %arg1], %arg2) : (i32 ..., !vm.ref<!vmla.buffer> ..., !vm.ref<!vmla.buffer>)
+  vmla.elementwise(%arg0, %arg1), out %arg2 {program = dense<[2, 2, 0, 1]> : tensor<4xi32>} : f32
+  return
+}
+
+// -----
+
 // CHECK-LABEL: vm.func @convert
 func @convert(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer) {
   // CHECK-NEXT:  vm.call @vmla.convert.f32.i8(%arg0, %arg1)
@@ -83,3 +92,44 @@ func @batch_matmul(
                     out %dst(%dst_shape : !shapex.ranked_shape<[3,4,4]>) : f32
   return
 }
+
+// -----
+
+// CHECK-LABEL: vm.func @sort
+func @sort(%src : !vmla.buffer, %dst : !vmla.buffer) {
+  %shape = shapex.const_ranked_shape : !shapex.ranked_shape<[2,8]>
+  // CHECK-DAG: %c1 = vm.const.i32 1 : i32
+  // CHECK-DAG: %c4 = vm.const.i32 4 : i32
+  // CHECK: vm.call.variadic @vmla.sort.f32(%arg0, [%c2, %c8], %c1, %c4, %arg1)
+  vmla.sort "GT", %src(%shape : !shapex.ranked_shape<[2,8]>), out %dst {dimension = 1 : i32} : f32
+  return
+}
+
+// -----
+
+// CHECK-LABEL: vm.func @quantized_add
+func @quantized_add(%lhs : !vmla.buffer, %rhs : !vmla.buffer, %dst : !vmla.buffer) {
+  //  CHECK-DAG: %[[LHS_ZP:.+]] = vm.const.i32 -3 : i32
+  //  CHECK-DAG: %[[RHS_ZP:.+]] = vm.const.i32 5 : i32
+  //  CHECK-DAG: %[[MULT:.+]] = vm.const.i32 1073741824 : i32
+  //  CHECK-DAG: %[[EXP:.+]] = vm.const.i32 -1 : i32
+  //  CHECK-DAG: %[[DST_ZP:.+]] = vm.const.i32 -7 : i32
+  //  CHECK-DAG: %[[DST_MULT:.+]] = vm.const.i32 1717986918 : i32
+  //  CHECK-DAG: %[[DST_EXP:.+]] = vm.const.i32 -18 : i32
+  //      CHECK: vm.call @vmla.quantized.add.i8(%arg0, %[[LHS_ZP]], %[[MULT]], %[[EXP]], %arg1, %[[RHS_ZP]], %[[MULT]], %[[EXP]], %arg2, %[[DST_ZP]], %[[DST_MULT]], %[[DST_EXP]])
+  vmla.quantized.add %lhs, %rhs, out %dst {
+    lhs_zero_point = -3 : i32, lhs_multiplier = 1073741824 : i32, lhs_exponent = -1 : i32,
+    rhs_zero_point = 5 : i32, rhs_multiplier = 1073741824 : i32, rhs_exponent = -1 : i32,
+    dst_zero_point = -7 : i32, dst_multiplier = 1717986918 : i32, dst_exponent = -18 : i32
+  } : i8
+  return
+}
+
+// -----
+
+// CHECK-LABEL: vm.func @bfloat16Import
+func @bfloat16Import(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer) {
+  // CHECK-NEXT: vm.call @vmla.add.bf16(%arg0, %arg0, %arg1) : (!vm.ref<!vmla.buffer>, !vm.ref<!vmla.buffer>, !vm.ref<!vmla.buffer>) -> ()
+  vmla.add %arg0, %arg0, out %arg1 : bf16
+  return
+}
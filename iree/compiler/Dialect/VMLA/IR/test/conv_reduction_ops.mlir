@@ -95,3 +95,48 @@ func @vmla_pooling(%src : !vmla.buffer,
                     window_strides = dense<[2,2]> : tensor<2xi32>} : f16
   return
 }
+
+// -----
+
+// CHECK-LABEL: @vmla_quantized_conv
+func @vmla_quantized_conv(%input : !vmla.buffer,
+                          %filter : !vmla.buffer,
+                          %bias : !vmla.buffer,
+                          %mantissa : !vmla.buffer,
+                          %exponent : !vmla.buffer,
+                          %dst : !vmla.buffer) {
+  %input_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[1,4,5,2]>
+  %filter_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[3,2,2,4]>
+  %dst_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[1,4,5,4]>
+  // CHECK: vmla.quantized.conv %arg0(%{{.+}} : !shapex.ranked_shape<[1,4,5,2]>), %arg1(%{{.+}} : !shapex.ranked_shape<[3,2,2,4]>), %arg2, %arg3, %arg4, out %arg5(%{{.+}} : !shapex.ranked_shape<[1,4,5,4]>)
+  // CHECK-SAME: dst_zero_point = -4 : i32
+  // CHECK-SAME: input_zero_point = 3 : i32
+  // CHECK-SAME: : i8
+  vmla.quantized.conv %input(%input_shape : !shapex.ranked_shape<[1,4,5,2]>),
+                      %filter(%filter_shape : !shapex.ranked_shape<[3,2,2,4]>),
+                      %bias, %mantissa, %exponent,
+                      out %dst(%dst_shape : !shapex.ranked_shape<[1,4,5,4]>)
+                      {dilation = dense<1> : vector<2xi32>,
+                       dst_zero_point = -4 : i32,
+                       feature_group_count = 1 : i32,
+                       input_zero_point = 3 : i32,
+                       padding = dense<[1, 1, 0, 1]> : vector<4xi32>,
+                       window_strides = dense<1> : vector<2xi32>} : i8
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @pooling_avg
+func @pooling_avg(%src : !vmla.buffer, %dst : !vmla.buffer) {
+  %src_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[4,8]>
+  %dst_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[2,4]>
+  // CHECK: vmla.pooling.avg %arg0(%{{.+}} : !shapex.ranked_shape<[4,8]>), out %arg1(%{{.+}} : !shapex.ranked_shape<[2,4]>)
+  // CHECK-SAME: : i8
+  vmla.pooling.avg %src(%src_shape : !shapex.ranked_shape<[4,8]>),
+                   out %dst(%dst_shape : !shapex.ranked_shape<[2,4]>)
+                   {padding = dense<0> : tensor<2xi32>,
+                    window_dimensions = dense<[2,2]> : tensor<2xi32>,
+                    window_strides = dense<[2,2]> : tensor<2xi32>} : i8
+  return
+}
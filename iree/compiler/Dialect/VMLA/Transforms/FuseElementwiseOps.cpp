@@ -0,0 +1,315 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+
+#include "iree/compiler/Dialect/VMLA/IR/VMLADialect.h"
+#include "iree/compiler/Dialect/VMLA/IR/VMLAOps.h"
+#include "iree/compiler/Dialect/VMLA/Transforms/Passes.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallVector.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/StandardTypes.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace VMLA {
+
+namespace {
+
+// Opcodes of the vmla.elementwise program encoding.
+// NOTE: these are part of the runtime ABI and must be kept in sync with
+// kernels::Elementwise in iree/hal/vmla/op_kernels.h.
+enum ElementwiseOpcode : int32_t {
+  kAdd = 0,
+  kSub = 1,
+  kMul = 2,
+  kDiv = 3,
+  kMin = 4,
+  kMax = 5,
+  kPow = 6,
+  kAtan2 = 7,
+  kAbs = 16,
+  kNeg = 17,
+  kExp = 18,
+  kLog = 19,
+  kRsqrt = 20,
+  kSqrt = 21,
+  kCos = 22,
+  kSin = 23,
+  kTanh = 24,
+  kFloor = 25,
+  kCeil = 26,
+};
+
+// Words per instruction: [opcode, result register, lhs register, rhs register].
+constexpr int kInstructionSize = 4;
+
+// Bounds the number of temporaries the runtime needs per chunk.
+constexpr int kMaxFusedOps = 16;
+
+// Returns the program opcode for |op| if it is a unary or binary elementwise
+// op the runtime can evaluate as part of a vmla.elementwise op.
+Optional<int32_t> getElementwiseOpcode(Operation *op) {
+  if (isa<AddOp>(op)) return kAdd;
+  if (isa<SubOp>(op)) return kSub;
+  if (isa<MulOp>(op)) return kMul;
+  if (isa<DivOp>(op)) return kDiv;
+  if (isa<MinOp>(op)) return kMin;
+  if (isa<MaxOp>(op)) return kMax;
+  if (isa<PowOp>(op)) return kPow;
+  if (isa<Atan2Op>(op)) return kAtan2;
+  if (isa<AbsOp>(op)) return kAbs;
+  if (isa<NegOp>(op)) return kNeg;
+  if (isa<ExpOp>(op)) return kExp;
+  if (isa<LogOp>(op)) return kLog;
+  if (isa<RsqrtOp>(op)) return kRsqrt;
+  if (isa<SqrtOp>(op)) return kSqrt;
+  if (isa<CosOp>(op)) return kCos;
+  if (isa<SinOp>(op)) return kSin;
+  if (isa<TanhOp>(op)) return kTanh;
+  if (isa<FloorOp>(op)) return kFloor;
+  if (isa<CeilOp>(op)) return kCeil;
+  return llvm::None;
+}
+
+// Returns true if |op| is an elementwise op that can be fused. Only f32 is
+// supported by the runtime today.
+bool isFusableOp(Operation *op) {
+  if (!getElementwiseOpcode(op).hasValue()) return false;
+  if (op->getAttr("forceUnsigned")) return false;
+  auto elementType = op->getAttrOfType<TypeAttr>("element_type");
+  return elementType && elementType.getValue().isF32();
+}
+
+// All unary and binary elementwise ops take their sources first followed by
+// the dst buffer.
+Operation::operand_range getSources(Operation *op) {
+  return op->getOperands().drop_back();
+}
+Value getDest(Operation *op) { return op->getOperands().back(); }
+
+// Returns the buffer that |buffer| is a view into, if any.
+Value getRootBuffer(Value buffer) {
+  while (auto viewOp =
+             dyn_cast_or_null<BufferViewOp>(buffer.getDefiningOp())) {
+    buffer = viewOp.src();
+  }
+  return buffer;
+}
+
+// Returns true if |op| may write to |buffer| or to a view aliasing it.
+bool mayWriteBuffer(Operation *op, Value buffer) {
+  if (MemoryEffectOpInterface::hasNoEffect(op)) return false;
+  Value rootBuffer = getRootBuffer(buffer);
+  auto aliasesBuffer = [&](Value operand) {
+    return operand.getType().isa<BufferType>() &&
+           getRootBuffer(operand) == rootBuffer;
+  };
+  if (getElementwiseOpcode(op).hasValue()) return aliasesBuffer(getDest(op));
+  return llvm::any_of(op->getOperands(), aliasesBuffer);
+}
+
+// A chain of elementwise ops that will be replaced by one vmla.elementwise op
+// at the position of the last op.
+struct FusionGroup {
+  // Member ops in a valid evaluation order; the last op is the root.
+  SmallVector<Operation *, 8> ops;
+  // Buffers read by the group that are not produced within it.
+  llvm::SetVector<Value> inputs;
+  // Set when the group has been merged into a consumer group.
+  bool merged = false;
+};
+
+// Returns the single elementwise consumer of |op|'s dst buffer if the buffer
+// is a transient allocation only used to pass the value along to it.
+Operation *getIntermediateConsumer(Operation *op) {
+  Value dst = getDest(op);
+  auto allocOp = dyn_cast_or_null<BufferAllocOp>(dst.getDefiningOp());
+  if (!allocOp || allocOp.getOperation()->getBlock() != op->getBlock()) {
+    return nullptr;
+  }
+  Operation *consumer = nullptr;
+  for (auto &use : dst.getUses()) {
+    Operation *user = use.getOwner();
+    if (user == op) {
+      if (use.getOperandNumber() != op->getNumOperands() - 1) return nullptr;
+      continue;
+    }
+    if (consumer && consumer != user) return nullptr;
+    consumer = user;
+  }
+  if (!consumer || consumer->getBlock() != op->getBlock() ||
+      !op->isBeforeInBlock(consumer) || !isFusableOp(consumer) ||
+      getDest(consumer) == dst) {
+    return nullptr;
+  }
+  return consumer;
+}
+
+// Returns true if |producer| can be evaluated at the position of |consumer|.
+// This is only unsafe if one of the producer inputs is written in between.
+bool canMoveToConsumer(const FusionGroup &producer, Operation *consumer) {
+  Operation *firstOp = producer.ops.front();
+  for (auto *op : producer.ops) {
+    if (op->isBeforeInBlock(firstOp)) firstOp = op;
+  }
+  for (Operation *op = firstOp->getNextNode(); op != consumer;
+       op = op->getNextNode()) {
+    if (llvm::is_contained(producer.ops, op)) continue;
+    for (Value input : producer.inputs) {
+      if (mayWriteBuffer(op, input)) return false;
+    }
+  }
+  return true;
+}
+
+// Encodes |group| as a program, assigning registers [0, inputs) to the inputs
+// and reusing temporary registers once their last reader has executed.
+SmallVector<int32_t, 16> buildProgram(const FusionGroup &group) {
+  llvm::DenseMap<Value, size_t> lastUses;
+  for (auto op : llvm::enumerate(group.ops)) {
+    for (Value source : getSources(op.value())) {
+      lastUses[source] = op.index();
+    }
+  }
+
+  llvm::DenseMap<Value, int32_t> registers;
+  for (auto input : llvm::enumerate(group.inputs)) {
+    registers[input.value()] = input.index();
+  }
+  int32_t registerCount = group.inputs.size();
+  SmallVector<int32_t, 4> freeRegisters;
+
+  SmallVector<int32_t, 16> program;
+  program.reserve(group.ops.size() * kInstructionSize);
+  for (auto op : llvm::enumerate(group.ops)) {
+    auto sources = getSources(op.value());
+    int32_t lhs = registers[sources.front()];
+    int32_t rhs = registers[sources.back()];
+    for (Value source : sources) {
+      if (group.inputs.count(source) || lastUses[source] != op.index()) {
+        continue;
+      }
+      int32_t reg = registers[source];
+      if (!llvm::is_contained(freeRegisters, reg)) {
+        freeRegisters.push_back(reg);
+      }
+    }
+    int32_t result;
+    if (freeRegisters.empty()) {
+      result = registerCount++;
+    } else {
+      result = freeRegisters.pop_back_val();
+    }
+    registers[getDest(op.value())] = result;
+    program.append(
+        {getElementwiseOpcode(op.value()).getValue(), result, lhs, rhs});
+  }
+  return program;
+}
+
+// Replaces the ops in |group| with a single vmla.elementwise op.
+void fuseGroup(const FusionGroup &group) {
+  Operation *rootOp = group.ops.back();
+  OpBuilder builder(rootOp);
+  auto program = buildProgram(group);
+  auto programType = RankedTensorType::get(
+      {static_cast<int64_t>(program.size())}, builder.getIntegerType(32));
+  SmallVector<Location, 8> locs;
+  for (auto *op : group.ops) locs.push_back(op->getLoc());
+  builder.create<ElementwiseOp>(
+      builder.getFusedLoc(locs), group.inputs.getArrayRef(), getDest(rootOp),
+      DenseIntElementsAttr::get(programType, program),
+      TypeAttr::get(builder.getF32Type()));
+
+  SmallVector<Operation *, 8> deadAllocs;
+  for (auto *op : llvm::reverse(group.ops)) {
+    if (op != rootOp) deadAllocs.push_back(getDest(op).getDefiningOp());
+    op->erase();
+  }
+  for (auto *allocOp : deadAllocs) allocOp->erase();
+}
+
+void fuseElementwiseOps(Block &block) {
+  std::vector<std::unique_ptr<FusionGroup>> groups;
+  // Maps intermediate buffers to the group producing them and the op that will
+  // consume them.
+  llvm::DenseMap<Value, std::pair<FusionGroup *, Operation *>> producers;
+
+  for (auto &op : block) {
+    if (!isFusableOp(&op)) continue;
+    auto group = std::make_unique<FusionGroup>();
+    llvm::SetVector<Value> sources;
+    sources.insert(getSources(&op).begin(), getSources(&op).end());
+    for (Value source : sources) {
+      auto it = producers.find(source);
+      if (it == producers.end() || it->second.second != &op) {
+        group->inputs.insert(source);
+        continue;
+      }
+      FusionGroup *producer = it->second.first;
+      if (group->ops.size() + producer->ops.size() + 1 > kMaxFusedOps ||
+          !canMoveToConsumer(*producer, &op)) {
+        group->inputs.insert(source);
+        continue;
+      }
+      group->ops.append(producer->ops.begin(), producer->ops.end());
+      group->inputs.insert(producer->inputs.begin(), producer->inputs.end());
+      producer->merged = true;
+    }
+    group->ops.push_back(&op);
+    if (auto *consumer = getIntermediateConsumer(&op)) {
+      producers[getDest(&op)] = {group.get(), consumer};
+    }
+    groups.push_back(std::move(group));
+  }
+
+  for (auto &group : groups) {
+    if (!group->merged && group->ops.size() > 1) fuseGroup(*group);
+  }
+}
+
+}  // namespace
+
+// Fuses chains of elementwise ops communicating through transient buffers
+// into vmla.elementwise ops that the runtime evaluates in a single pass.
+class FuseElementwiseOpsPass
+    : public PassWrapper<FuseElementwiseOpsPass, FunctionPass> {
+ public:
+  void runOnFunction() override {
+    for (auto &block : getFunction()) {
+      fuseElementwiseOps(block);
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<FuncOp>> createFuseElementwiseOpsPass() {
+  return std::make_unique<FuseElementwiseOpsPass>();
+}
+
+static PassRegistration<FuseElementwiseOpsPass> pass(
+    "iree-vmla-fuse-elementwise-ops",
+    "Fuses chains of elementwise VMLA ops into single-pass kernels.");
+
+}  // namespace VMLA
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -99,6 +99,17 @@ void buildVMLATransformPassPipeline(OpPassManager &passManager) {
   passManager.addNestedPass<FuncOp>(createCSEPass());
   passManager.addPass(createConversionPass());
 
+  // ---------------------------------------------------------------------------
+  // VMLA-level optimization.
+  // Fuses elementwise op chains so that intermediate values stay in cache
+  // instead of each op streaming a full buffer through memory.
+  // ---------------------------------------------------------------------------
+  passManager.addNestedPass<FuncOp>(createFuseElementwiseOpsPass());
+
+  // Reuse transient buffers once they are dead and carve them all out of a
+  // single allocation. Must run after fusion as that removes buffers.
+  passManager.addNestedPass<FuncOp>(createPlanBufferAllocationsPass());
+
   // ---------------------------------------------------------------------------
   // Cleanup identity ops that clutter up the IR and canonicalize.
   // ---------------------------------------------------------------------------
@@ -64,6 +64,18 @@ std::unique_ptr<OperationPass<FuncOp>> createPreConversionLoweringPass();
 // Converts from various dialects (standard, HLO, etc) to the VMLA dialect.
 std::unique_ptr<OperationPass<mlir::ModuleOp>> createConversionPass();
 
+//===----------------------------------------------------------------------===//
+// VMLA optimization
+//===----------------------------------------------------------------------===//
+
+// Fuses chains of elementwise ops into vmla.elementwise ops that evaluate the
+// whole chain in a single pass over the buffers.
+std::unique_ptr<OperationPass<FuncOp>> createFuseElementwiseOpsPass();
+
+// Assigns transient buffers with static sizes to reusable slots based on their
+// liveness and allocates the slots from a single arena per invocation.
+std::unique_ptr<OperationPass<FuncOp>> createPlanBufferAllocationsPass();
+
 //===----------------------------------------------------------------------===//
 // Register all Passes
 //===----------------------------------------------------------------------===//
@@ -73,6 +85,8 @@ inline void registerVMLAPasses() {
   createUnrollReductionsPass();
   createConversionPass();
   createPreConversionLoweringPass();
+  createFuseElementwiseOpsPass();
+  createPlanBufferAllocationsPass();
 }
 
 }  // namespace VMLA
@@ -0,0 +1,309 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include "iree/compiler/Dialect/VMLA/IR/VMLADialect.h"
+#include "iree/compiler/Dialect/VMLA/IR/VMLAOps.h"
+#include "iree/compiler/Dialect/VMLA/Transforms/Passes.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/MathExtras.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Interfaces/CallInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace VMLA {
+
+namespace {
+
+// Alignment of each slot within the arena. Matches a cache line so that
+// kernels never share lines between unrelated buffers.
+constexpr int64_t kSlotAlignment = 64;
+
+// A transient allocation whose lifetime is fully contained in its block.
+struct LiveRange {
+  BufferAllocOp allocOp;
+  int64_t byteLength;
+  // Indices of the first and last ops in the block touching the buffer.
+  // The alloc itself does not touch memory and is excluded.
+  int start;
+  int end;
+};
+
+// Returns true for ops that read and write buffers of the same element type
+// strictly elementwise so that dst may exactly alias a source.
+bool isInPlaceSafeOp(Operation *op) {
+  return isa<NotOp, AndOp, OrOp, XorOp, ShlOp, ShrOp, AddOp, SubOp, AbsOp,
+             NegOp, MulOp, DivOp, RemOp, PowOp, ExpOp, LogOp, RsqrtOp, SqrtOp,
+             CosOp, SinOp, TanhOp, Atan2Op, MinOp, MaxOp, ClampOp, FloorOp,
+             CeilOp, ElementwiseOp>(op);
+}
+
+// Computes the live range of |allocOp| within its block or returns None if
+// the buffer has a dynamic size or may be used outside of the block.
+Optional<LiveRange> computeLiveRange(
+    BufferAllocOp allocOp, const llvm::DenseMap<Operation *, int> &opIndices) {
+  APInt byteLength;
+  if (!matchPattern(allocOp.byte_length(), m_ConstantInt(&byteLength)) ||
+      byteLength.isNullValue()) {
+    return llvm::None;
+  }
+
+  LiveRange range{allocOp, byteLength.getSExtValue(),
+                  std::numeric_limits<int>::max(), -1};
+  // Views and other ops producing buffers from the allocation alias it, so
+  // their uses extend the live range.
+  SmallVector<Value, 4> worklist{allocOp.result()};
+  while (!worklist.empty()) {
+    Value value = worklist.pop_back_val();
+    for (Operation *user : value.getUsers()) {
+      auto it = opIndices.find(user);
+      if (it == opIndices.end() || user->isKnownTerminator() ||
+          isa<CallOpInterface>(user)) {
+        return llvm::None;
+      }
+      range.start = std::min(range.start, it->second);
+      range.end = std::max(range.end, it->second);
+      for (Value result : user->getResults()) {
+        if (result.getType().isa<BufferType>()) worklist.push_back(result);
+      }
+    }
+  }
+  if (range.end < 0) return llvm::None;
+  return range;
+}
+
+// Returns the buffer that |buffer| is a view into, if any.
+Value getRootBuffer(Value buffer) {
+  while (auto viewOp =
+             dyn_cast_or_null<BufferViewOp>(buffer.getDefiningOp())) {
+    buffer = viewOp.src();
+  }
+  return buffer;
+}
+
+// Returns true if |range| may start in a slot last used by |lastRange| at the
+// same op: the op must consume the previous buffer directly as a source and
+// write the new buffer directly as its dst.
+bool canReuseInPlace(Operation *op, const LiveRange &lastRange,
+                     const LiveRange &range) {
+  if (!isInPlaceSafeOp(op)) return false;
+  Value src = lastRange.allocOp.result();
+  Value dst = range.allocOp.result();
+  if (op->getOperands().back() != dst) return false;
+  if (!llvm::is_contained(op->getOperands().drop_back(), src)) return false;
+  // Views into either buffer may be read at a different offset than the one
+  // being written.
+  return llvm::none_of(op->getOperands(), [&](Value operand) {
+    if (operand == src || operand == dst) return false;
+    Value rootBuffer = getRootBuffer(operand);
+    return rootBuffer == src || rootBuffer == dst;
+  });
+}
+
+// A region of the arena shared by buffers with disjoint live ranges.
+struct Slot {
+  int64_t byteLength = 0;
+  int64_t byteOffset = 0;
+  // Range of the buffer most recently assigned to the slot.
+  const LiveRange *lastRange = nullptr;
+};
+
+// Assigns each range to a slot, preferring the smallest free slot that fits
+// and otherwise growing the largest free slot. Returns the bytes required to
+// hold all slots.
+int64_t assignSlots(Block &block, ArrayRef<LiveRange> ranges,
+                    SmallVectorImpl<Slot> &slots,
+                    SmallVectorImpl<int> &rangeSlots) {
+  SmallVector<Operation *, 32> ops;
+  for (auto &op : block) ops.push_back(&op);
+
+  SmallVector<int, 16> order(ranges.size());
+  for (int i = 0; i < order.size(); ++i) order[i] = i;
+  llvm::stable_sort(order, [&](int lhs, int rhs) {
+    return ranges[lhs].start < ranges[rhs].start;
+  });
+
+  rangeSlots.resize(ranges.size());
+  for (int rangeIndex : order) {
+    const auto &range = ranges[rangeIndex];
+    int bestSlot = -1;
+    for (int i = 0; i < slots.size(); ++i) {
+      const auto &slot = slots[i];
+      bool isFree =
+          slot.lastRange->end < range.start ||
+          (slot.lastRange->end == range.start &&
+           canReuseInPlace(ops[range.start], *slot.lastRange, range));
+      if (!isFree) continue;
+      if (bestSlot == -1) {
+        bestSlot = i;
+        continue;
+      }
+      const auto &best = slots[bestSlot];
+      bool fits = slot.byteLength >= range.byteLength;
+      bool bestFits = best.byteLength >= range.byteLength;
+      if ((fits && (!bestFits || slot.byteLength < best.byteLength)) ||
+          (!fits && !bestFits && slot.byteLength > best.byteLength)) {
+        bestSlot = i;
+      }
+    }
+    if (bestSlot == -1) {
+      bestSlot = slots.size();
+      slots.push_back({});
+    }
+    auto &slot = slots[bestSlot];
+    slot.byteLength =
+        std::max(slot.byteLength, static_cast<int64_t>(llvm::alignTo(
+                                      range.byteLength, kSlotAlignment)));
+    slot.lastRange = &range;
+    rangeSlots[rangeIndex] = bestSlot;
+  }
+
+  int64_t byteOffset = 0;
+  for (auto &slot : slots) {
+    slot.byteOffset = byteOffset;
+    byteOffset += slot.byteLength;
+  }
+  return byteOffset;
+}
+
+// Returns true if |op| writes every byte of |buffer| before reading any of it.
+// vmla.buffer.alloc zeroes its contents while views into the arena hold
+// whatever the slot was last used for, so any other first use needs the view
+// to be cleared first.
+bool isFullyOverwrittenBy(Operation *op, Value buffer) {
+  if (!isInPlaceSafeOp(op) || op->getOperands().back() != buffer) return false;
+  return llvm::none_of(op->getOperands().drop_back(), [&](Value operand) {
+    return getRootBuffer(operand) == buffer;
+  });
+}
+
+// Block-local transient allocations and their assigned arena offsets.
+struct BlockPlan {
+  // Ops of the block in order; LiveRange indices refer to these.
+  SmallVector<Operation *, 32> ops;
+  SmallVector<LiveRange, 16> ranges;
+  SmallVector<int64_t, 16> byteOffsets;
+  SmallVector<bool, 16> needsZeroing;
+};
+
+// Replaces transient vmla.buffer.alloc ops in |funcOp| with views into a
+// single arena allocated on entry. Live ranges are computed per block and the
+// blocks share the arena as no planned buffer outlives its block.
+void planBufferAllocations(FuncOp funcOp) {
+  SmallVector<BlockPlan, 4> plans;
+  int64_t arenaLength = 0;
+  int rangeCount = 0;
+  for (auto &block : funcOp) {
+    BlockPlan plan;
+    llvm::DenseMap<Operation *, int> opIndices;
+    for (auto op : llvm::enumerate(block)) {
+      opIndices[&op.value()] = op.index();
+      plan.ops.push_back(&op.value());
+    }
+
+    for (auto allocOp : block.getOps<BufferAllocOp>()) {
+      if (auto range = computeLiveRange(allocOp, opIndices)) {
+        plan.ranges.push_back(*range);
+        plan.needsZeroing.push_back(
+            !isFullyOverwrittenBy(plan.ops[range->start], allocOp.result()));
+      }
+    }
+    if (plan.ranges.empty()) continue;
+
+    SmallVector<Slot, 8> slots;
+    SmallVector<int, 16> rangeSlots;
+    arenaLength = std::max(arenaLength,
+                           assignSlots(block, plan.ranges, slots, rangeSlots));
+    for (int slotIndex : rangeSlots) {
+      plan.byteOffsets.push_back(slots[slotIndex].byteOffset);
+    }
+    rangeCount += plan.ranges.size();
+    plans.push_back(std::move(plan));
+  }
+  // Swapping a single allocation for an arena plus a view gains nothing.
+  if (rangeCount < 2) return;
+
+  auto builder = OpBuilder::atBlockBegin(&funcOp.front());
+  auto arenaOp = builder.create<BufferAllocOp>(
+      funcOp.getLoc(), BufferType::get(builder.getContext()),
+      builder.create<ConstantIndexOp>(funcOp.getLoc(), arenaLength));
+  // Single byte fill value used to zero views; fills of one byte are memsets.
+  Value zeroValue;
+  for (auto &plan : plans) {
+    for (int i = 0; i < plan.ranges.size(); ++i) {
+      const auto &range = plan.ranges[i];
+      auto allocOp = range.allocOp;
+      builder.setInsertionPoint(allocOp);
+      auto viewOp = builder.create<BufferViewOp>(
+          allocOp.getLoc(), BufferType::get(builder.getContext()),
+          arenaOp.result(),
+          builder.create<ConstantIndexOp>(allocOp.getLoc(),
+                                          plan.byteOffsets[i]),
+          allocOp.byte_length());
+      if (plan.needsZeroing[i]) {
+        if (!zeroValue) {
+          OpBuilder::InsertionGuard guard(builder);
+          builder.setInsertionPointAfter(arenaOp);
+          zeroValue = builder.create<ConstantOp>(
+              funcOp.getLoc(),
+              builder
+                  .getZeroAttr(
+                      RankedTensorType::get({}, builder.getIntegerType(8)))
+                  .cast<ElementsAttr>());
+        }
+        // The previous occupant of the slot may still be in use at the alloc
+        // so the fill must wait until just before the first use.
+        OpBuilder::InsertionGuard guard(builder);
+        builder.setInsertionPoint(plan.ops[range.start]);
+        builder.create<BufferFillOp>(allocOp.getLoc(), zeroValue,
+                                     viewOp.result());
+      }
+      allocOp.result().replaceAllUsesWith(viewOp.result());
+      allocOp.erase();
+    }
+  }
+}
+
+}  // namespace
+
+// Plans transient VMLA buffers into a single arena allocation per invocation.
+class PlanBufferAllocationsPass
+    : public PassWrapper<PlanBufferAllocationsPass, FunctionPass> {
+ public:
+  void runOnFunction() override { planBufferAllocations(getFunction()); }
+};
+
+std::unique_ptr<OperationPass<FuncOp>> createPlanBufferAllocationsPass() {
+  return std::make_unique<PlanBufferAllocationsPass>();
+}
+
+static PassRegistration<PlanBufferAllocationsPass> pass(
+    "iree-vmla-plan-buffer-allocations",
+    "Reuses transient VMLA buffers based on liveness and allocates them from "
+    "a single arena per invocation.");
+
+}  // namespace VMLA
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -0,0 +1,98 @@
+// RUN: iree-opt -split-input-file -iree-vmla-fuse-elementwise-ops %s | IreeFileCheck %s
+
+// CHECK-LABEL: func @fuseChain
+func @fuseChain(%a : !vmla.buffer, %b : !vmla.buffer, %c : !vmla.buffer) -> !vmla.buffer {
+  %c16 = constant 16 : index
+  // CHECK-NEXT: %c16 = constant 16 : index
+  // CHECK-NEXT: %[[DST:.+]] = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  // CHECK-NEXT: vmla.elementwise(%arg0, %arg1, %arg2), out %[[DST]]
+  // CHECK-SAME: program = dense<[2, 3, 0, 1, 0, 3, 3, 2, 24, 3, 3, 3]> : tensor<12xi32>
+  // CHECK-SAME: : f32
+  // CHECK-NEXT: return %[[DST]]
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.mul %a, %b, out %0 : f32
+  %1 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.add %0, %c, out %1 : f32
+  %2 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.tanh %1, out %2 : f32
+  return %2 : !vmla.buffer
+}
+
+// -----
+
+// CHECK-LABEL: func @fuseTree
+func @fuseTree(%a : !vmla.buffer, %b : !vmla.buffer) -> !vmla.buffer {
+  %c16 = constant 16 : index
+  // CHECK: %[[DST:.+]] = vmla.buffer.alloc
+  // CHECK-NEXT: vmla.elementwise(%arg0, %arg1), out %[[DST]]
+  // CHECK-SAME: program = dense<[18, 2, 0, 0, 18, 3, 1, 1, 1, 3, 2, 3]> : tensor<12xi32>
+  // CHECK-NEXT: return %[[DST]]
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.exp %a, out %0 : f32
+  %1 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.exp %b, out %1 : f32
+  %2 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.sub %0, %1, out %2 : f32
+  return %2 : !vmla.buffer
+}
+
+// -----
+
+// CHECK-LABEL: func @singleOpUnchanged
+func @singleOpUnchanged(%a : !vmla.buffer) -> !vmla.buffer {
+  %c16 = constant 16 : index
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  // CHECK: vmla.exp
+  // CHECK-NOT: vmla.elementwise
+  vmla.exp %a, out %0 : f32
+  return %0 : !vmla.buffer
+}
+
+// -----
+
+// CHECK-LABEL: func @intermediateEscapes
+func @intermediateEscapes(%a : !vmla.buffer) -> (!vmla.buffer, !vmla.buffer) {
+  %c16 = constant 16 : index
+  // CHECK: vmla.exp
+  // CHECK: vmla.neg
+  // CHECK-NOT: vmla.elementwise
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.exp %a, out %0 : f32
+  %1 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.neg %0, out %1 : f32
+  return %0, %1 : !vmla.buffer, !vmla.buffer
+}
+
+// -----
+
+// CHECK-LABEL: func @unsupportedType
+func @unsupportedType(%a : !vmla.buffer) -> !vmla.buffer {
+  %c16 = constant 16 : index
+  // CHECK: vmla.abs
+  // CHECK: vmla.neg
+  // CHECK-NOT: vmla.elementwise
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.abs %a, out %0 : i32
+  %1 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.neg %0, out %1 : i32
+  return %1 : !vmla.buffer
+}
+
+// -----
+
+// CHECK-LABEL: func @inputWrittenBetween
+func @inputWrittenBetween(%a : !vmla.buffer, %b : !vmla.buffer) -> !vmla.buffer {
+  %c0 = constant 0 : index
+  %c16 = constant 16 : index
+  // CHECK: vmla.exp
+  // CHECK: vmla.buffer.copy
+  // CHECK: vmla.neg
+  // CHECK-NOT: vmla.elementwise
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.exp %a, out %0 : f32
+  %view = vmla.buffer.view %a[%c0], byte_length = %c16 : !vmla.buffer
+  vmla.buffer.copy %b[%c0], out %view[%c0], byte_length = %c16
+  %1 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.neg %0, out %1 : f32
+  return %1 : !vmla.buffer
+}
@@ -0,0 +1,90 @@
+// RUN: iree-opt -split-input-file -iree-vmla-plan-buffer-allocations -cse %s | IreeFileCheck %s
+
+// CHECK-LABEL: func @inPlaceChain
+func @inPlaceChain(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer) {
+  // CHECK-NEXT: %c64 = constant 64 : index
+  // CHECK-NEXT: %[[ARENA:.+]] = vmla.buffer.alloc byte_length = %c64 : !vmla.buffer
+  %c0 = constant 0 : index
+  %c16 = constant 16 : index
+  // CHECK: %[[T0:.+]] = vmla.buffer.view %[[ARENA]][%c0], byte_length = %c16 : !vmla.buffer
+  // CHECK-NEXT: vmla.exp %arg0, out %[[T0]] : f32
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.exp %arg0, out %0 : f32
+  // CHECK-NEXT: vmla.neg %[[T0]], out %[[T0]] : f32
+  %1 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.neg %0, out %1 : f32
+  // CHECK-NEXT: vmla.buffer.copy %[[T0]][%c0], out %arg1[%c0], byte_length = %c16
+  vmla.buffer.copy %1[%c0], out %arg1[%c0], byte_length = %c16
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @disjointRanges
+func @disjointRanges(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer) {
+  // CHECK-NEXT: %c128 = constant 128 : index
+  // CHECK-NEXT: %[[ARENA:.+]] = vmla.buffer.alloc byte_length = %c128 : !vmla.buffer
+  // CHECK-NEXT: %[[ZERO:.+]] = vmla.constant dense<0> : tensor<i8> -> !vmla.buffer
+  %c0 = constant 0 : index
+  %c16 = constant 16 : index
+  // CHECK: %[[T0:.+]] = vmla.buffer.view %[[ARENA]][%c0], byte_length = %c16 : !vmla.buffer
+  // CHECK-NEXT: vmla.exp %arg0, out %[[T0]] : f32
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.exp %arg0, out %0 : f32
+  // The copy cannot run in-place so its dst needs a second slot. Views are not
+  // zeroed like allocations are and the copy may not write all of it.
+  // CHECK-NEXT: %c64 = constant 64 : index
+  // CHECK-NEXT: %[[T1:.+]] = vmla.buffer.view %[[ARENA]][%c64], byte_length = %c16 : !vmla.buffer
+  // CHECK-NEXT: vmla.buffer.fill %[[ZERO]], out %[[T1]]
+  // CHECK-NEXT: vmla.buffer.copy %[[T0]][%c0], out %[[T1]][%c0], byte_length = %c16
+  %1 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.buffer.copy %0[%c0], out %1[%c0], byte_length = %c16
+  // The first slot is dead by now and gets reused.
+  // CHECK-NEXT: vmla.neg %[[T1]], out %[[T0]] : f32
+  %2 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.neg %1, out %2 : f32
+  // CHECK-NEXT: vmla.buffer.copy %[[T0]][%c0], out %arg1[%c0], byte_length = %c16
+  vmla.buffer.copy %2[%c0], out %arg1[%c0], byte_length = %c16
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @escapingAndDynamic
+func @escapingAndDynamic(%arg0 : !vmla.buffer, %arg1 : index) -> !vmla.buffer {
+  // CHECK-NOT: vmla.buffer.view
+  %c16 = constant 16 : index
+  // CHECK: vmla.buffer.alloc byte_length = %arg1
+  %0 = vmla.buffer.alloc byte_length = %arg1 : !vmla.buffer
+  vmla.exp %arg0, out %0 : f32
+  // CHECK: vmla.buffer.alloc byte_length = %c16
+  %1 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.neg %0, out %1 : f32
+  return %1 : !vmla.buffer
+}
+
+// -----
+
+// CHECK-LABEL: func @hoistedAlloc
+func @hoistedAlloc(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer) {
+  // CHECK-NEXT: %c64 = constant 64 : index
+  // CHECK-NEXT: %[[ARENA:.+]] = vmla.buffer.alloc byte_length = %c64 : !vmla.buffer
+  // CHECK-NEXT: %[[ZERO:.+]] = vmla.constant dense<0> : tensor<i8> -> !vmla.buffer
+  %c0 = constant 0 : index
+  %c16 = constant 16 : index
+  // Both buffers share a slot even though %1 is allocated while %0 is live.
+  // CHECK: %[[T0:.+]] = vmla.buffer.view %[[ARENA]][%c0], byte_length = %c16 : !vmla.buffer
+  // CHECK-NEXT: vmla.exp %arg0, out %[[T0]] : f32
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  %1 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.exp %arg0, out %0 : f32
+  // CHECK-NEXT: vmla.buffer.copy %[[T0]][%c0], out %arg1[%c0], byte_length = %c16
+  vmla.buffer.copy %0[%c0], out %arg1[%c0], byte_length = %c16
+  // The zero fill must come after the last use of %0 and not at the alloc.
+  // CHECK-NEXT: vmla.buffer.fill %[[ZERO]], out %[[T0]]
+  // CHECK-NEXT: vmla.buffer.copy %arg0[%c0], out %[[T0]][%c0], byte_length = %c16
+  vmla.buffer.copy %arg0[%c0], out %1[%c0], byte_length = %c16
+  // CHECK-NEXT: vmla.buffer.copy %[[T0]][%c0], out %arg1[%c0], byte_length = %c16
+  vmla.buffer.copy %1[%c0], out %arg1[%c0], byte_length = %c16
+  return
+}
@@ -90,12 +90,16 @@ vm.import @cmp.i8(%predicate : i32, %lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref
 vm.import @cmp.i16(%predicate : i32, %lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @cmp.i32(%predicate : i32, %lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @cmp.f32(%predicate : i32, %lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @cmp.f16(%predicate : i32, %lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @cmp.bf16(%predicate : i32, %lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 
 vm.import @select.x8(%cond : !vm.ref<!vmla.buffer>, %lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @select.x16(%cond : !vm.ref<!vmla.buffer>, %lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @select.x32(%cond : !vm.ref<!vmla.buffer>, %lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 
 vm.import @finite.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @finite.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @finite.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 
 //===----------------------------------------------------------------------===//
 // VMLA Ops: shape/structure
@@ -191,6 +195,25 @@ vm.import @gather.x32(
   %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
   %dim : i32, %batch_dims : i32
 )
+vm.import @take_along_axis.x8(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %indices : !vm.ref<!vmla.buffer>, %indices_shape : i32 ...,
+  %dimension : i32,
+  %dst : !vm.ref<!vmla.buffer>
+)
+vm.import @take_along_axis.x16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %indices : !vm.ref<!vmla.buffer>, %indices_shape : i32 ...,
+  %dimension : i32,
+  %dst : !vm.ref<!vmla.buffer>
+)
+vm.import @take_along_axis.x32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %indices : !vm.ref<!vmla.buffer>, %indices_shape : i32 ...,
+  %dimension : i32,
+  %dst : !vm.ref<!vmla.buffer>
+)
+
   vm.import @scatter.x8(
   %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
   %indices : !vm.ref<!vmla.buffer>, %indices_shape : i32 ...,
@@ -271,22 +294,32 @@ vm.import @add.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %d
 vm.import @add.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @add.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @add.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @add.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @add.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @sub.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @sub.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @sub.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @sub.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @sub.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @sub.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @abs.i8(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @abs.i16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @abs.i32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @abs.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @abs.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @abs.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @neg.i8(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @neg.i16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @neg.i32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @neg.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @neg.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @neg.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @mul.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @mul.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @mul.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @mul.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @mul.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @mul.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @div.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @div.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @div.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
@@ -294,6 +327,8 @@ vm.import @div.u8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %d
 vm.import @div.u16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @div.u32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @div.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @div.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @div.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @rem.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @rem.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @rem.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
@@ -301,30 +336,66 @@ vm.import @rem.u8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %d
 vm.import @rem.u16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @rem.u32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @rem.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @rem.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @rem.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @pow.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @pow.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @pow.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @exp.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @exp.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @exp.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @log.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @log.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @log.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @rsqrt.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @rsqrt.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @rsqrt.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @sqrt.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @sqrt.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @sqrt.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @cos.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @cos.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @cos.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @sin.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @sin.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @sin.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @tanh.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @tanh.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @tanh.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @atan2.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @atan2.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @atan2.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 
 vm.import @min.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @min.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @min.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @min.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @min.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @min.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @max.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @max.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @max.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @max.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @max.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @max.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @clamp.i8(%min : !vm.ref<!vmla.buffer>, %value : !vm.ref<!vmla.buffer>, %max : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @clamp.i16(%min : !vm.ref<!vmla.buffer>, %value : !vm.ref<!vmla.buffer>, %max : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @clamp.i32(%min : !vm.ref<!vmla.buffer>, %value : !vm.ref<!vmla.buffer>, %max : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @clamp.f32(%min : !vm.ref<!vmla.buffer>, %value : !vm.ref<!vmla.buffer>, %max : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @clamp.f16(%min : !vm.ref<!vmla.buffer>, %value : !vm.ref<!vmla.buffer>, %max : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @clamp.bf16(%min : !vm.ref<!vmla.buffer>, %value : !vm.ref<!vmla.buffer>, %max : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @floor.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @floor.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @floor.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @ceil.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @ceil.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @ceil.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+
+vm.import @elementwise.f32(
+  %program : i32 ...,
+  %srcs : !vm.ref<!vmla.buffer> ...,
+  %dst : !vm.ref<!vmla.buffer>
+)
 
 //===----------------------------------------------------------------------===//
 // VMLA Ops: conversion
@@ -342,6 +413,10 @@ vm.import @convert.i32.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.bu
 vm.import @convert.f32.i8(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @convert.f32.i16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @convert.f32.i32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @convert.f16.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @convert.f32.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @convert.bf16.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @convert.f32.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 
 //===----------------------------------------------------------------------===//
 // VMLA Ops: Convolution
@@ -358,6 +433,69 @@ vm.import @conv.f32f32.f32(
   %feature_group_count: i32,
   %batch_group_count: i32
 )
+vm.import @conv.f16f16.f16(
+  %input: !vm.ref<!vmla.buffer>, %input_shape: i32 ...,
+  %filter: !vm.ref<!vmla.buffer>, %filter_shape: i32 ...,
+  %dst: !vm.ref<!vmla.buffer>, %dst_shape: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...,
+  %lhs_dilation: i32 ...,
+  %rhs_dilation: i32 ...,
+  %feature_group_count: i32,
+  %batch_group_count: i32
+)
+vm.import @conv.bf16bf16.bf16(
+  %input: !vm.ref<!vmla.buffer>, %input_shape: i32 ...,
+  %filter: !vm.ref<!vmla.buffer>, %filter_shape: i32 ...,
+  %dst: !vm.ref<!vmla.buffer>, %dst_shape: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...,
+  %lhs_dilation: i32 ...,
+  %rhs_dilation: i32 ...,
+  %feature_group_count: i32,
+  %batch_group_count: i32
+)
+
+//===----------------------------------------------------------------------===//
+// VMLA Ops: quantization
+//===----------------------------------------------------------------------===//
+
+vm.import @quantize.i8(
+  %src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>,
+  %zero_point : i32, %multiplier : i32, %exponent : i32
+)
+vm.import @dequantize.i8(
+  %src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>,
+  %zero_point : i32, %multiplier : i32, %exponent : i32
+)
+vm.import @quantized.add.i8(
+  %lhs : !vm.ref<!vmla.buffer>,
+  %lhs_zero_point : i32, %lhs_multiplier : i32, %lhs_exponent : i32,
+  %rhs : !vm.ref<!vmla.buffer>,
+  %rhs_zero_point : i32, %rhs_multiplier : i32, %rhs_exponent : i32,
+  %dst : !vm.ref<!vmla.buffer>,
+  %dst_zero_point : i32, %dst_multiplier : i32, %dst_exponent : i32
+)
+vm.import @quantized.mul.i8(
+  %lhs : !vm.ref<!vmla.buffer>, %lhs_zero_point : i32,
+  %rhs : !vm.ref<!vmla.buffer>, %rhs_zero_point : i32,
+  %dst : !vm.ref<!vmla.buffer>, %dst_zero_point : i32,
+  %multiplier : i32, %exponent : i32
+)
+vm.import @quantized.conv.i8(
+  %input: !vm.ref<!vmla.buffer>, %input_shape: i32 ...,
+  %filter: !vm.ref<!vmla.buffer>, %filter_shape: i32 ...,
+  %bias: !vm.ref<!vmla.buffer>,
+  %multiplier_mantissa: !vm.ref<!vmla.buffer>,
+  %multiplier_exponent: !vm.ref<!vmla.buffer>,
+  %dst: !vm.ref<!vmla.buffer>, %dst_shape: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...,
+  %dilation: i32 ...,
+  %feature_group_count: i32,
+  %input_zero_point: i32,
+  %dst_zero_point: i32
+)
 
 //===----------------------------------------------------------------------===//
 // VMLA Ops: GEMM/GEMV
@@ -368,6 +506,16 @@ vm.import @batch.matmul.f32f32.f32(
   %rhs : !vm.ref<!vmla.buffer>, %rhs_shape : i32 ...,
   %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
 )
+vm.import @batch.matmul.f16f16.f16(
+  %lhs : !vm.ref<!vmla.buffer>, %lhs_shape : i32 ...,
+  %rhs : !vm.ref<!vmla.buffer>, %rhs_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
+)
+vm.import @batch.matmul.bf16bf16.bf16(
+  %lhs : !vm.ref<!vmla.buffer>, %lhs_shape : i32 ...,
+  %rhs : !vm.ref<!vmla.buffer>, %rhs_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
+)
 
 //===----------------------------------------------------------------------===//
 // VMLA Ops: reduction
@@ -397,6 +545,18 @@ vm.import @reduce.sum.f32(
   %dimension : i32,
   %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
 )
+vm.import @reduce.sum.f16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dimension : i32,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
+)
+vm.import @reduce.sum.bf16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dimension : i32,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
+)
 
 vm.import @reduce.min.i8(
   %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
@@ -422,6 +582,18 @@ vm.import @reduce.min.f32(
   %dimension : i32,
   %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
 )
+vm.import @reduce.min.f16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dimension : i32,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
+)
+vm.import @reduce.min.bf16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dimension : i32,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
+)
 
 vm.import @reduce.max.i8(
   %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
@@ -447,6 +619,18 @@ vm.import @reduce.max.f32(
   %dimension : i32,
   %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
 )
+vm.import @reduce.max.f16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dimension : i32,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
+)
+vm.import @reduce.max.bf16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dimension : i32,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
+)
 
 vm.import @pooling.sum.i8(
   %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
@@ -480,6 +664,22 @@ vm.import @pooling.sum.f32(
   %window_strides: i32 ...,
   %padding: i32 ...
 )
+vm.import @pooling.sum.f16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...
+)
+vm.import @pooling.sum.bf16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...
+)
 
 vm.import @pooling.min.i8(
   %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
@@ -513,6 +713,22 @@ vm.import @pooling.min.f32(
   %window_strides: i32 ...,
   %padding: i32 ...
 )
+vm.import @pooling.min.f16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...
+)
+vm.import @pooling.min.bf16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...
+)
 
 vm.import @pooling.max.i8(
   %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
@@ -546,5 +762,135 @@ vm.import @pooling.max.f32(
   %window_strides: i32 ...,
   %padding: i32 ...
 )
+vm.import @pooling.max.f16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...
+)
+vm.import @pooling.max.bf16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %init : !vm.ref<!vmla.buffer>, %init_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...
+)
+
+vm.import @pooling.avg.i8(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...
+)
+vm.import @pooling.avg.i16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...
+)
+vm.import @pooling.avg.i32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...
+)
+vm.import @pooling.avg.f32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...
+)
+vm.import @pooling.avg.f16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...
+)
+vm.import @pooling.avg.bf16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %window_dimensions: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...
+)
+
+//===----------------------------------------------------------------------===//
+// VMLA Ops: sorting
+//===----------------------------------------------------------------------===//
+
+vm.import @sort.i8(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dimension : i32, %predicate : i32,
+  %dst : !vm.ref<!vmla.buffer>
+)
+vm.import @sort.i16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dimension : i32, %predicate : i32,
+  %dst : !vm.ref<!vmla.buffer>
+)
+vm.import @sort.i32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dimension : i32, %predicate : i32,
+  %dst : !vm.ref<!vmla.buffer>
+)
+vm.import @sort.f32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dimension : i32, %predicate : i32,
+  %dst : !vm.ref<!vmla.buffer>
+)
+
+vm.import @sort.refine.i8(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dimension : i32, %predicate : i32,
+  %dst : !vm.ref<!vmla.buffer>
+)
+vm.import @sort.refine.i16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dimension : i32, %predicate : i32,
+  %dst : !vm.ref<!vmla.buffer>
+)
+vm.import @sort.refine.i32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dimension : i32, %predicate : i32,
+  %dst : !vm.ref<!vmla.buffer>
+)
+vm.import @sort.refine.f32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dimension : i32, %predicate : i32,
+  %dst : !vm.ref<!vmla.buffer>
+)
+
+vm.import @topk.i8(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dimension : i32, %predicate : i32,
+  %dst : !vm.ref<!vmla.buffer>, %dst_indices : !vm.ref<!vmla.buffer>,
+  %dst_shape : i32 ...
+)
+vm.import @topk.i16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dimension : i32, %predicate : i32,
+  %dst : !vm.ref<!vmla.buffer>, %dst_indices : !vm.ref<!vmla.buffer>,
+  %dst_shape : i32 ...
+)
+vm.import @topk.i32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dimension : i32, %predicate : i32,
+  %dst : !vm.ref<!vmla.buffer>, %dst_indices : !vm.ref<!vmla.buffer>,
+  %dst_shape : i32 ...
+)
+vm.import @topk.f32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dimension : i32, %predicate : i32,
+  %dst : !vm.ref<!vmla.buffer>, %dst_indices : !vm.ref<!vmla.buffer>,
+  %dst_shape : i32 ...
+)
 
 }  // module
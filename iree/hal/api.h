@@ -316,6 +316,12 @@ enum iree_hal_executable_caching_mode_e {
   // Device must support the DeviceFeature::kProfiling feature and executables
   // must support the ExecutableFeature::kProfiling feature.
   IREE_HAL_EXECUTABLE_CACHING_MODE_ENABLE_PROFILING = 1u << 5,
+  // Allows the cache to defer compiling individual entry points until they are
+  // first dispatched. This reduces preparation time for executables with many
+  // entry points at the cost of a one-time stall on the first dispatch of each.
+  // Caches that do not compile (or compile everything ahead of time) ignore
+  // this.
+  IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_LAZY_COMPILATION = 1u << 6,
   // Default caching mode.
   IREE_HAL_EXECUTABLE_CACHING_MODE_DEFAULT =
       IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING |
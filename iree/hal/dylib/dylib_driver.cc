@@ -16,9 +16,14 @@
 
 #include <memory>
 
+#include "absl/flags/flag.h"
 #include "iree/hal/device_info.h"
 #include "iree/hal/dylib/dylib_device.h"
-#include "iree/hal/host/serial/serial_scheduling_model.h"
+#include "iree/hal/host/threaded/threaded_scheduling_model.h"
+
+ABSL_FLAG(int, dylib_worker_count, -1,
+          "Number of worker threads used to process dispatch tiles in addition "
+          "to the queue thread. -1 uses all available hardware threads.");
 
 namespace iree {
 namespace hal {
@@ -56,7 +61,8 @@ StatusOr<ref_ptr<Device>> DyLibDriver::CreateDefaultDevice() {
 
 StatusOr<ref_ptr<Device>> DyLibDriver::CreateDevice(DriverDeviceID device_id) {
   // Only one device, ignore device_id.
-  auto scheduling_model = std::make_unique<host::SerialSchedulingModel>();
+  auto scheduling_model = std::make_unique<host::ThreadedSchedulingModel>(
+      absl::GetFlag(FLAGS_dylib_worker_count));
   return make_ref<DyLibDevice>(GetDefaultDeviceInfo(),
                                std::move(scheduling_model));
 }
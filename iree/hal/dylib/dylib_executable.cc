@@ -14,8 +14,11 @@
 
 #include "iree/hal/dylib/dylib_executable.h"
 
+#include <algorithm>
+
+#include "absl/types/span.h"
 #include "flatbuffers/flatbuffers.h"
-#include "iree/base/file_io.h"
+#include "iree/base/arena.h"
 #include "iree/base/tracing.h"
 #include "iree/schemas/dylib_executable_def_generated.h"
 
@@ -35,9 +38,6 @@ DyLibExecutable::DyLibExecutable() = default;
 DyLibExecutable::~DyLibExecutable() {
   IREE_TRACE_SCOPE0("DyLibExecutable::dtor");
   executable_library_.reset();
-  if (!executable_library_temp_path_.empty()) {
-    file_io::DeleteFile(executable_library_temp_path_).IgnoreError();
-  }
 }
 
 Status DyLibExecutable::Initialize(ExecutableSpec spec) {
@@ -55,30 +55,14 @@ Status DyLibExecutable::Initialize(ExecutableSpec spec) {
     return InvalidArgumentErrorBuilder(IREE_LOC) << "No embedded library";
   }
 
-  // Write the embedded library out to a temp file, since all of the dynamic
-  // library APIs work with files. We could instead use in-memory files on
-  // platforms where that is convenient.
-  std::string base_name = "dylib_executable";
-  IREE_ASSIGN_OR_RETURN(executable_library_temp_path_,
-                        file_io::GetTempFile(base_name));
-  // Add platform-specific file extensions so opinionated dynamic library
-  // loaders are more likely to find the file:
-#if defined(IREE_PLATFORM_WINDOWS)
-  executable_library_temp_path_ += ".dll";
-#else
-  executable_library_temp_path_ += ".so";
-#endif
-
-  absl::string_view embedded_library_data(
-      reinterpret_cast<const char*>(
-          dylib_executable_def->library_embedded()->data()),
-      dylib_executable_def->library_embedded()->size());
-  IREE_RETURN_IF_ERROR(file_io::SetFileContents(executable_library_temp_path_,
-                                                embedded_library_data));
-
+  // Load the embedded library directly from memory; on platforms where that
+  // is supported this avoids any filesystem traffic during startup.
   IREE_ASSIGN_OR_RETURN(
       executable_library_,
-      DynamicLibrary::Load(executable_library_temp_path_.c_str()));
+      DynamicLibrary::LoadFromMemory(
+          "dylib_executable",
+          absl::MakeConstSpan(dylib_executable_def->library_embedded()->data(),
+                              dylib_executable_def->library_embedded()->size())));
 
   const auto& entry_points = *dylib_executable_def->entry_points();
   entry_functions_.resize(entry_points.size());
@@ -97,12 +81,13 @@ Status DyLibExecutable::Initialize(ExecutableSpec spec) {
 struct DyLibDispatchState : public HostExecutable::DispatchState {
   DyLibDispatchState() = default;
   void* entry_function = nullptr;
-  absl::InlinedVector<void*, 4> args;
-  absl::InlinedVector<int32_t, 4> push_constant;
+  absl::Span<void*> args;
+  absl::Span<int32_t> push_constant;
+  std::array<uint32_t, 3> workgroup_count;
 };
 
-StatusOr<ref_ptr<HostExecutable::DispatchState>>
-DyLibExecutable::PrepareDispatch(const DispatchParams& params) {
+StatusOr<HostExecutable::DispatchStatePtr> DyLibExecutable::PrepareDispatch(
+    const DispatchParams& params, Arena* arena) {
   IREE_TRACE_SCOPE0("DyLibExecutable::PrepareDispatch");
 
   if (params.entry_point >= entry_functions_.size()) {
@@ -110,27 +95,29 @@ DyLibExecutable::PrepareDispatch(const DispatchParams& params) {
            << "Invalid entry point ordinal " << params.entry_point;
   }
 
-  auto dispatch_state = make_ref<DyLibDispatchState>();
+  DispatchStatePtr dispatch_state_ptr(arena->Allocate<DyLibDispatchState>());
+  auto* dispatch_state =
+      static_cast<DyLibDispatchState*>(dispatch_state_ptr.get());
   dispatch_state->entry_function = entry_functions_[params.entry_point];
+  dispatch_state->workgroup_count = params.workgroup_count;
 
-  for (size_t set = 0; set < params.set_bindings.size(); ++set) {
-    for (size_t binding = 0; binding < params.set_bindings[set].size();
-         ++binding) {
-      const auto& io_binding = params.set_bindings[set][binding];
-      IREE_ASSIGN_OR_RETURN(auto memory,
-                            io_binding.buffer->MapMemory<uint8_t>(
-                                MemoryAccessBitfield::kWrite, io_binding.offset,
-                                io_binding.length));
-      auto data = memory.mutable_data();
-
-      dispatch_state->args.push_back(data);
-    }
+  // Flatten the bindings from all sets into the argument list.
+  size_t binding_count = 0;
+  for (const auto& set_ptrs : params.set_binding_ptrs) {
+    binding_count += set_ptrs.size();
   }
-  for (int i = 0; i < params.push_constants->values.size(); ++i) {
-    dispatch_state->push_constant.push_back(params.push_constants->values[i]);
+  dispatch_state->args = arena->AllocateSpan<void*>(binding_count);
+  auto* arg = dispatch_state->args.data();
+  for (const auto& set_ptrs : params.set_binding_ptrs) {
+    arg = std::copy(set_ptrs.begin(), set_ptrs.end(), arg);
   }
 
-  return std::move(dispatch_state);
+  dispatch_state->push_constant =
+      arena->AllocateSpan<int32_t>(params.push_constants.size());
+  std::copy(params.push_constants.begin(), params.push_constants.end(),
+            dispatch_state->push_constant.begin());
+
+  return std::move(dispatch_state_ptr);
 }
 
 Status DyLibExecutable::DispatchTile(DispatchState* state,
@@ -138,10 +125,13 @@ Status DyLibExecutable::DispatchTile(DispatchState* state,
   IREE_TRACE_SCOPE0("DyLibExecutable::DispatchTile");
   auto* dispatch_state = static_cast<DyLibDispatchState*>(state);
 
-  auto entry_function =
-      (void (*)(void**, int32_t*))dispatch_state->entry_function;
+  // Each tile processes the slice of the iteration space selected by its
+  // workgroup ID; see LinalgTileAndDistributePass in the compiler.
+  auto entry_function = (void (*)(void**, int32_t*, uint32_t*,
+                                  uint32_t*))dispatch_state->entry_function;
   entry_function(dispatch_state->args.data(),
-                 dispatch_state->push_constant.data());
+                 dispatch_state->push_constant.data(), workgroup_xyz.data(),
+                 dispatch_state->workgroup_count.data());
 
   return OkStatus();
 }
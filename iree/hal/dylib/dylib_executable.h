@@ -39,15 +39,14 @@ class DyLibExecutable final : public HostExecutable {
 
   bool supports_debugging() const override { return false; }
 
-  StatusOr<ref_ptr<DispatchState>> PrepareDispatch(
-      const DispatchParams& params) override;
+  StatusOr<DispatchStatePtr> PrepareDispatch(const DispatchParams& params,
+                                              Arena* arena) override;
   Status DispatchTile(DispatchState* state,
                       std::array<uint32_t, 3> workgroup_xyz) override;
 
  private:
   Status Initialize(ExecutableSpec spec);
 
-  std::string executable_library_temp_path_;
   std::unique_ptr<DynamicLibrary> executable_library_;
   absl::InlinedVector<void*, 4> entry_functions_;
 };
@@ -70,6 +70,13 @@ enum class ExecutableCachingMode : uint32_t {
   // must support the ExecutableFeature::kProfiling feature.
   kEnableProfiling = 1 << 5,
 
+  // Allows the cache to defer compiling individual entry points until they are
+  // first dispatched. This reduces preparation time for executables with many
+  // entry points at the cost of a one-time stall on the first dispatch of each.
+  // Caches that do not compile (or compile everything ahead of time) ignore
+  // this.
+  kAllowLazyCompilation = 1 << 6,
+
   // Default caching mode.
   kDefault = kAllowPersistentCaching | kAllowOptimization,
 };
@@ -0,0 +1,135 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/host_binding_state.h"
+
+#include "iree/hal/buffer.h"
+#include "iree/hal/host/host_descriptor_set.h"
+#include "iree/hal/host/host_executable_layout.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+Status HostBindingState::PushConstants(ExecutableLayout* executable_layout,
+                                       size_t offset,
+                                       absl::Span<const uint32_t> values) {
+  UpdateExecutableLayout(executable_layout);
+  if (offset + values.size() > push_constants_.values.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Push constants out of range";
+  }
+  for (int i = 0; i < values.size(); ++i) {
+    push_constants_.values[offset + i] = values[i];
+  }
+  return OkStatus();
+}
+
+Status HostBindingState::PushDescriptorSet(
+    ExecutableLayout* executable_layout, int32_t set,
+    absl::Span<const DescriptorSet::Binding> bindings) {
+  UpdateExecutableLayout(executable_layout);
+  if (set < 0 || set >= descriptor_sets_.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Set " << set << " out of range (" << descriptor_sets_.size()
+           << ")";
+  }
+
+  auto& set_bindings = descriptor_sets_[set];
+  set_bindings = {bindings.begin(), bindings.end()};
+
+  return ResolveDescriptorSet(set);
+}
+
+Status HostBindingState::BindDescriptorSet(
+    ExecutableLayout* executable_layout, int32_t set,
+    DescriptorSet* descriptor_set,
+    absl::Span<const device_size_t> dynamic_offsets) {
+  auto* host_executable_layout =
+      static_cast<HostExecutableLayout*>(executable_layout);
+  UpdateExecutableLayout(executable_layout);
+  if (set < 0 || set >= descriptor_sets_.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Set " << set << " out of range (" << descriptor_sets_.size()
+           << ")";
+  }
+
+  auto* host_descriptor_set = static_cast<HostDescriptorSet*>(descriptor_set);
+  auto* set_bindings = &descriptor_sets_[set];
+  *set_bindings = {host_descriptor_set->bindings().begin(),
+                   host_descriptor_set->bindings().end()};
+  if (!dynamic_offsets.empty()) {
+    auto dynamic_binding_map =
+        host_executable_layout->GetDynamicBindingMap(set);
+    if (dynamic_offsets.size() != dynamic_binding_map.size()) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Dynamic offset count mismatch (provided "
+             << dynamic_offsets.size() << " but expected "
+             << dynamic_binding_map.size() << ")";
+    }
+    for (int i = 0; i < dynamic_binding_map.size(); ++i) {
+      (*set_bindings)[dynamic_binding_map[i]].offset += dynamic_offsets[i];
+    }
+  }
+
+  return ResolveDescriptorSet(set);
+}
+
+HostExecutable::DispatchParams HostBindingState::GetDispatchParams(
+    int32_t entry_point, std::array<uint32_t, 3> workgroup_count) {
+  HostExecutable::DispatchParams params;
+  params.entry_point = entry_point;
+  params.workgroup_count = workgroup_count;
+  params.push_constants =
+      absl::MakeConstSpan(push_constants_.values.data(), push_constant_count_);
+
+  descriptor_set_spans_.resize(descriptor_sets_.size());
+  descriptor_set_ptr_spans_.resize(descriptor_sets_.size());
+  for (int i = 0; i < descriptor_sets_.size(); ++i) {
+    descriptor_set_spans_[i] = absl::MakeConstSpan(descriptor_sets_[i]);
+    descriptor_set_ptr_spans_[i] = absl::MakeConstSpan(descriptor_set_ptrs_[i]);
+  }
+  params.set_bindings = descriptor_set_spans_;
+  params.set_binding_ptrs = descriptor_set_ptr_spans_;
+  return params;
+}
+
+void HostBindingState::UpdateExecutableLayout(
+    ExecutableLayout* executable_layout) {
+  auto* host_executable_layout =
+      static_cast<HostExecutableLayout*>(executable_layout);
+  push_constant_count_ = host_executable_layout->push_constants();
+  descriptor_sets_.resize(host_executable_layout->set_count());
+  descriptor_set_ptrs_.resize(host_executable_layout->set_count());
+}
+
+Status HostBindingState::ResolveDescriptorSet(int32_t set) {
+  const auto& set_bindings = descriptor_sets_[set];
+  auto& set_ptrs = descriptor_set_ptrs_[set];
+  set_ptrs.resize(set_bindings.size());
+  for (int i = 0; i < set_bindings.size(); ++i) {
+    const auto& binding = set_bindings[i];
+    // Host buffers are always accessible so the pointer remains valid after
+    // the mapping is released.
+    IREE_ASSIGN_OR_RETURN(auto memory, binding.buffer->MapMemory<uint8_t>(
+                                           MemoryAccessBitfield::kWrite,
+                                           binding.offset, binding.length));
+    set_ptrs[i] = memory.mutable_data();
+  }
+  return OkStatus();
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
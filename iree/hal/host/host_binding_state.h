@@ -0,0 +1,81 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_HOST_BINDING_STATE_H_
+#define IREE_HAL_HOST_HOST_BINDING_STATE_H_
+
+#include <array>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/types/span.h"
+#include "iree/base/status.h"
+#include "iree/hal/descriptor_set.h"
+#include "iree/hal/executable_layout.h"
+#include "iree/hal/host/host_executable.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Tracks the push constants and descriptor sets bound by a command stream and
+// produces the HostExecutable::DispatchParams for dispatches issued against
+// them. Binding host pointers are resolved when a set is pushed or bound so
+// that any number of dispatches may share them.
+//
+// Thread-compatible.
+class HostBindingState {
+ public:
+  HostBindingState() = default;
+
+  Status PushConstants(ExecutableLayout* executable_layout, size_t offset,
+                       absl::Span<const uint32_t> values);
+
+  Status PushDescriptorSet(ExecutableLayout* executable_layout, int32_t set,
+                           absl::Span<const DescriptorSet::Binding> bindings);
+
+  Status BindDescriptorSet(ExecutableLayout* executable_layout, int32_t set,
+                           DescriptorSet* descriptor_set,
+                           absl::Span<const device_size_t> dynamic_offsets);
+
+  // Returns dispatch parameters referencing the current bindings. The returned
+  // value is only valid until the next change to the binding state.
+  HostExecutable::DispatchParams GetDispatchParams(
+      int32_t entry_point, std::array<uint32_t, 3> workgroup_count);
+
+ private:
+  // Resizes the descriptor set tables to match |executable_layout| and
+  // records the number of push constants it declares.
+  void UpdateExecutableLayout(ExecutableLayout* executable_layout);
+
+  // Resolves the host pointers for all bindings in |set| so that dispatches
+  // don't need to map the buffers again.
+  Status ResolveDescriptorSet(int32_t set);
+
+  PushConstantBlock push_constants_;
+  size_t push_constant_count_ = 0;
+  absl::InlinedVector<absl::InlinedVector<DescriptorSet::Binding, 8>, 2>
+      descriptor_sets_;
+  absl::InlinedVector<absl::InlinedVector<void*, 8>, 2> descriptor_set_ptrs_;
+
+  // Span tables referenced by the DispatchParams returned to callers.
+  absl::InlinedVector<absl::Span<const DescriptorSet::Binding>, 2>
+      descriptor_set_spans_;
+  absl::InlinedVector<absl::Span<void* const>, 2> descriptor_set_ptr_spans_;
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_HOST_BINDING_STATE_H_
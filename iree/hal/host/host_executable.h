@@ -15,6 +15,9 @@
 #ifndef IREE_HAL_HOST_HOST_EXECUTABLE_H_
 #define IREE_HAL_HOST_HOST_EXECUTABLE_H_
 
+#include <memory>
+
+#include "iree/base/arena.h"
 #include "iree/base/status.h"
 #include "iree/hal/descriptor_set.h"
 #include "iree/hal/executable.h"
@@ -46,22 +49,35 @@ class HostExecutable : public Executable {
     // Total workgroup XYZ count for the grid.
     std::array<uint32_t, 3> workgroup_count;
 
-    // Push constants populated by the command buffer.
-    const PushConstantBlock* push_constants = nullptr;
+    // Push constants populated by the command buffer. Only the constants
+    // declared by the executable layout are included.
+    absl::Span<const uint32_t> push_constants;
 
     // Descriptor set bindings organized by set and binding ordinal.
     absl::Span<const absl::Span<const DescriptorSet::Binding>> set_bindings;
+
+    // Host pointers to the contents of each binding in |set_bindings| with the
+    // binding offset applied. Resolved once when the descriptor set is bound.
+    absl::Span<const absl::Span<void* const>> set_binding_ptrs;
   };
 
-  struct DispatchState : public RefObject<DispatchState> {
+  // Per-dispatch state allocated from an arena. Destructors are run when the
+  // owning DispatchStatePtr is released but the memory is only reclaimed when
+  // the arena is reset.
+  struct DispatchState {
     virtual ~DispatchState() = default;
   };
+  struct DispatchStateDeleter {
+    void operator()(DispatchState* state) const { state->~DispatchState(); }
+  };
+  using DispatchStatePtr = std::unique_ptr<DispatchState, DispatchStateDeleter>;
 
   // Begins processing a grid dispatch with the given parameters.
-  // May be called from any thread. Returns dispatch state that will be passed
-  // to all DispatchTile calls from the same dispatch operation.
-  virtual StatusOr<ref_ptr<DispatchState>> PrepareDispatch(
-      const DispatchParams& params) = 0;
+  // May be called from any thread. Returns dispatch state allocated from
+  // |arena| that will be passed to all DispatchTile calls from the same
+  // dispatch operation. |arena| must outlive the returned state.
+  virtual StatusOr<DispatchStatePtr> PrepareDispatch(
+      const DispatchParams& params, Arena* arena) = 0;
 
   // Processes a single tile within the grid.
   // |workgroup_xyz| is the tile coordinates in the grid as defined during
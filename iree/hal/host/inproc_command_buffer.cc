@@ -15,6 +15,7 @@
 #include "iree/hal/host/inproc_command_buffer.h"
 
 #include "iree/base/tracing.h"
+#include "iree/hal/host/host_binding_state.h"
 
 namespace iree {
 namespace hal {
@@ -36,6 +37,24 @@ Status InProcCommandBuffer::Begin() {
 Status InProcCommandBuffer::End() {
   IREE_TRACE_SCOPE0("InProcCommandBuffer::End");
   is_recording_ = false;
+  if (!AllBitsSet(mode(), CommandBufferMode::kOneShot)) {
+    // If the plan can't be built we fall back to processing the recorded
+    // commands on each submission, which also reports any errors at the same
+    // point a one-shot command buffer would.
+    auto plan_status = BuildPlan();
+    has_plan_ = plan_status.ok();
+    if (!has_plan_) {
+      if (IsUnimplemented(plan_status)) {
+        VLOG(1) << "Command buffer not prepared: " << plan_status;
+      } else {
+        LOG(WARNING) << "Failed to prepare command buffer; falling back to "
+                        "processing recorded commands: "
+                     << plan_status;
+      }
+      plan_.clear();
+      plan_arena_.Reset();
+    }
+  }
   return OkStatus();
 }
 
@@ -200,6 +219,11 @@ void InProcCommandBuffer::Reset() {
   auto* cmd_list = &current_cmd_list_;
   cmd_list->head = cmd_list->tail = nullptr;
   cmd_list->arena.Reset();
+
+  // Dispatch states must be released before their backing arena.
+  has_plan_ = false;
+  plan_.clear();
+  plan_arena_.Reset();
 }
 
 InProcCommandBuffer::CmdHeader* InProcCommandBuffer::AppendCmdHeader(
@@ -230,9 +254,17 @@ void* InProcCommandBuffer::AppendCmdData(const void* source_buffer,
   return allocated_bytes;
 }
 
-Status InProcCommandBuffer::Process(CommandBuffer* command_processor) const {
+Status InProcCommandBuffer::Process(CommandBuffer* command_processor,
+                                    TileDispatcher* tile_dispatcher) const {
   IREE_TRACE_SCOPE0("InProcCommandBuffer::Process");
 
+  // Prepared dispatches bypass the command processor and as such its
+  // capabilities must be checked up-front.
+  if (has_plan_ && AnyBitSet(command_processor->command_categories() &
+                             CommandCategory::kDispatch)) {
+    return ProcessPlan(command_processor, tile_dispatcher);
+  }
+
   IREE_RETURN_IF_ERROR(command_processor->Begin());
 
   // Process each command in the order they were recorded.
@@ -253,6 +285,105 @@ Status InProcCommandBuffer::Process(CommandBuffer* command_processor) const {
   return OkStatus();
 }
 
+Status InProcCommandBuffer::BuildPlan() {
+  IREE_TRACE_SCOPE0("InProcCommandBuffer::BuildPlan");
+
+  HostBindingState binding_state;
+  auto* cmd_list = &current_cmd_list_;
+  for (CmdHeader* cmd_header = cmd_list->head; cmd_header != nullptr;
+       cmd_header = cmd_header->next) {
+    switch (cmd_header->type) {
+      case CmdType::kPushConstants: {
+        auto* cmd = reinterpret_cast<PushConstantsCmd*>(cmd_header + 1);
+        IREE_RETURN_IF_ERROR(binding_state.PushConstants(
+            cmd->executable_layout, cmd->offset, cmd->values));
+        break;
+      }
+      case CmdType::kPushDescriptorSet: {
+        auto* cmd = reinterpret_cast<PushDescriptorSetCmd*>(cmd_header + 1);
+        IREE_RETURN_IF_ERROR(binding_state.PushDescriptorSet(
+            cmd->executable_layout, cmd->set, cmd->bindings));
+        break;
+      }
+      case CmdType::kBindDescriptorSet: {
+        auto* cmd = reinterpret_cast<BindDescriptorSetCmd*>(cmd_header + 1);
+        IREE_RETURN_IF_ERROR(binding_state.BindDescriptorSet(
+            cmd->executable_layout, cmd->set, cmd->descriptor_set,
+            cmd->dynamic_offsets));
+        break;
+      }
+      case CmdType::kDispatch: {
+        auto* cmd = reinterpret_cast<DispatchCmd*>(cmd_header + 1);
+        PlanStep step;
+        step.executable = reinterpret_cast<HostExecutable*>(cmd->executable);
+        step.workgroup_count = cmd->workgroups;
+        IREE_ASSIGN_OR_RETURN(
+            step.dispatch_state,
+            step.executable->PrepareDispatch(
+                binding_state.GetDispatchParams(cmd->entry_point,
+                                                cmd->workgroups),
+                &plan_arena_));
+        plan_.push_back(std::move(step));
+        break;
+      }
+      case CmdType::kDispatchIndirect:
+        // The workgroup count isn't known until the command buffer executes.
+        return UnimplementedErrorBuilder(IREE_LOC)
+               << "Indirect dispatches cannot be prepared ahead of time";
+      default: {
+        PlanStep step;
+        step.cmd = cmd_header;
+        plan_.push_back(std::move(step));
+        break;
+      }
+    }
+  }
+  return OkStatus();
+}
+
+Status InProcCommandBuffer::ProcessPlan(CommandBuffer* command_processor,
+                                        TileDispatcher* tile_dispatcher) const {
+  IREE_TRACE_SCOPE0("InProcCommandBuffer::ProcessPlan");
+  absl::MutexLock lock(&plan_mutex_);
+
+  IREE_RETURN_IF_ERROR(command_processor->Begin());
+
+  for (const auto& step : plan_) {
+    Status command_status;
+    if (step.cmd) {
+      command_status = ProcessCmd(step.cmd, command_processor);
+    } else if (tile_dispatcher) {
+      command_status = tile_dispatcher->DispatchGrid(
+          step.executable, step.dispatch_state.get(), step.workgroup_count);
+    } else {
+      command_status = DispatchTiles(step);
+    }
+    if (!command_status.ok()) {
+      LOG(ERROR) << "DeviceQueue failure while executing command; permanently "
+                    "failing all future commands: "
+                 << command_status;
+      return command_status;
+    }
+  }
+
+  IREE_RETURN_IF_ERROR(command_processor->End());
+
+  return OkStatus();
+}
+
+Status InProcCommandBuffer::DispatchTiles(const PlanStep& step) const {
+  const auto& workgroup_count = step.workgroup_count;
+  for (uint32_t z = 0; z < workgroup_count[2]; ++z) {
+    for (uint32_t y = 0; y < workgroup_count[1]; ++y) {
+      for (uint32_t x = 0; x < workgroup_count[0]; ++x) {
+        IREE_RETURN_IF_ERROR(step.executable->DispatchTile(
+            step.dispatch_state.get(), {x, y, z}));
+      }
+    }
+  }
+  return OkStatus();
+}
+
 Status InProcCommandBuffer::ProcessCmd(CmdHeader* cmd_header,
                                        CommandBuffer* command_processor) const {
   switch (cmd_header->type) {
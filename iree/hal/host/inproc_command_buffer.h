@@ -15,10 +15,16 @@
 #ifndef IREE_HAL_HOST_INPROC_COMMAND_BUFFER_H_
 #define IREE_HAL_HOST_INPROC_COMMAND_BUFFER_H_
 
+#include <array>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
 #include "iree/base/arena.h"
 #include "iree/base/intrusive_list.h"
 #include "iree/base/status.h"
 #include "iree/hal/command_buffer.h"
+#include "iree/hal/host/host_executable.h"
+#include "iree/hal/host/tile_dispatcher.h"
 
 namespace iree {
 namespace hal {
@@ -30,6 +36,14 @@ namespace host {
 // implementation use Process to call each command method as it was originally
 // recorded.
 //
+// Command buffers that may be submitted more than once (those without
+// CommandBufferMode::kOneShot) are additionally compiled into an execution plan
+// on End(). Bindings and push constants are resolved and each dispatch is
+// prepared against its HostExecutable once so that resubmission only needs to
+// run the tiles. The prepared dispatch states are mutable (executables may keep
+// scratch state in them) so submissions of the same plan are serialized: a
+// command buffer submitted to multiple queues at once runs one at a time.
+//
 // Thread-compatible (as with CommandBuffer itself).
 class InProcCommandBuffer final : public CommandBuffer {
  public:
@@ -95,7 +109,12 @@ class InProcCommandBuffer final : public CommandBuffer {
 
   // Processes all commands in the buffer using the given |command_processor|.
   // The commands are issued in the order they were recorded.
-  Status Process(CommandBuffer* command_processor) const;
+  //
+  // If an execution plan was built on End() then dispatches bypass
+  // |command_processor| and are issued directly using their prepared state,
+  // handing each grid to |tile_dispatcher| if provided.
+  Status Process(CommandBuffer* command_processor,
+                 TileDispatcher* tile_dispatcher = nullptr) const;
 
  private:
   // Type of Cmd, used by CmdHeader to identify the command payload.
@@ -253,9 +272,31 @@ class InProcCommandBuffer final : public CommandBuffer {
     device_size_t workgroups_offset;
   };
 
+  // A single step of the execution plan. Binding commands are folded into the
+  // prepared dispatch state and do not appear in the plan.
+  struct PlanStep {
+    // Recorded command to issue to the command processor, or nullptr if this
+    // step is a prepared dispatch.
+    CmdHeader* cmd = nullptr;
+    HostExecutable* executable = nullptr;
+    HostExecutable::DispatchStatePtr dispatch_state;
+    std::array<uint32_t, 3> workgroup_count;
+  };
+
   // Resets the command list.
   void Reset();
 
+  // Builds |plan_| from the current command list. Fails if any command cannot
+  // be resolved ahead of submission (such as indirect dispatches).
+  Status BuildPlan();
+
+  // Processes the prepared |plan_|.
+  Status ProcessPlan(CommandBuffer* command_processor,
+                     TileDispatcher* tile_dispatcher) const;
+
+  // Runs all tiles of a prepared dispatch |step| on the calling thread.
+  Status DispatchTiles(const PlanStep& step) const;
+
   // Allocates a command and appends it to the current command list.
   // The caller must populate the fields in the returned pointer.
   template <typename T>
@@ -291,6 +332,16 @@ class InProcCommandBuffer final : public CommandBuffer {
 
   // NOTE: not synchronized. Expected to be used from a single thread.
   CmdList current_cmd_list_;
+
+  // Execution plan built on End() if the command buffer is reusable.
+  // The prepared dispatch states are allocated from |plan_arena_|.
+  bool has_plan_ = false;
+  Arena plan_arena_;
+  std::vector<PlanStep> plan_;
+
+  // Held while |plan_| is processed so that concurrent submissions don't share
+  // the prepared dispatch states.
+  mutable absl::Mutex plan_mutex_;
 };
 
 }  // namespace host
@@ -0,0 +1,215 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/inproc_command_buffer.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "iree/base/arena.h"
+#include "iree/base/status.h"
+#include "iree/hal/host/host_executable.h"
+#include "iree/hal/host/host_executable_layout.h"
+#include "iree/hal/host/host_local_allocator.h"
+#include "iree/hal/testing/mock_command_buffer.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+using ::testing::_;
+using ::testing::Return;
+
+// Executable that records how it was prepared and how many tiles it ran.
+// Fails if a prepared dispatch state is used by two tiles at once.
+class RecordingExecutable final : public HostExecutable {
+ public:
+  struct RecordingDispatchState : public DispatchState {
+    uint32_t push_constant;
+    void* binding_ptr;
+    std::atomic<bool> in_use{false};
+  };
+
+  bool supports_debugging() const override { return false; }
+
+  StatusOr<DispatchStatePtr> PrepareDispatch(const DispatchParams& params,
+                                             Arena* arena) override {
+    ++prepare_count;
+    auto* state = arena->Allocate<RecordingDispatchState>();
+    state->push_constant = params.push_constants[0];
+    state->binding_ptr = params.set_binding_ptrs[0][0];
+    return DispatchStatePtr(state);
+  }
+
+  Status DispatchTile(DispatchState* state,
+                      std::array<uint32_t, 3> workgroup_xyz) override {
+    auto* recording_state = static_cast<RecordingDispatchState*>(state);
+    if (recording_state->in_use.exchange(true)) {
+      return FailedPreconditionErrorBuilder(IREE_LOC)
+             << "Dispatch state used concurrently";
+    }
+    last_push_constant = recording_state->push_constant;
+    last_binding_ptr = recording_state->binding_ptr;
+    ++tile_count;
+    recording_state->in_use.store(false);
+    return OkStatus();
+  }
+
+  int prepare_count = 0;
+  int tile_count = 0;
+  uint32_t last_push_constant = 0;
+  void* last_binding_ptr = nullptr;
+};
+
+class InProcCommandBufferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK_AND_ASSIGN(
+        buffer_, allocator_.Allocate(
+                     MemoryType::kHostLocal | MemoryType::kDeviceVisible,
+                     BufferUsage::kAll, 64));
+    DescriptorSetLayout::Binding layout_binding;
+    set_layout_ = make_ref<HostDescriptorSetLayout>(
+        DescriptorSetLayout::UsageType::kPushOnly,
+        absl::MakeConstSpan(&layout_binding, 1));
+    DescriptorSetLayout* set_layouts[] = {set_layout_.get()};
+    executable_layout_ = make_ref<HostExecutableLayout>(set_layouts, 1);
+  }
+
+  // Records a push constant, a descriptor set, a fill and a 2x2 dispatch.
+  Status Record(InProcCommandBuffer* command_buffer) {
+    IREE_RETURN_IF_ERROR(command_buffer->Begin());
+    uint32_t push_constant = 42;
+    IREE_RETURN_IF_ERROR(command_buffer->PushConstants(
+        executable_layout_.get(), 0, absl::MakeConstSpan(&push_constant, 1)));
+    DescriptorSet::Binding binding;
+    binding.buffer = buffer_.get();
+    binding.offset = 16;
+    binding.length = 16;
+    IREE_RETURN_IF_ERROR(command_buffer->PushDescriptorSet(
+        executable_layout_.get(), 0, absl::MakeConstSpan(&binding, 1)));
+    uint32_t pattern = 0;
+    IREE_RETURN_IF_ERROR(
+        command_buffer->FillBuffer(buffer_.get(), 0, 16, &pattern, 4));
+    IREE_RETURN_IF_ERROR(command_buffer->Dispatch(&executable_, 0, {2, 2, 1}));
+    return command_buffer->End();
+  }
+
+  void* BindingPtr() {
+    auto mapping = buffer_->MapMemory<uint8_t>(MemoryAccess::kRead).value();
+    return const_cast<uint8_t*>(mapping.data()) + 16;
+  }
+
+  HostLocalAllocator allocator_;
+  ref_ptr<Buffer> buffer_;
+  ref_ptr<HostDescriptorSetLayout> set_layout_;
+  ref_ptr<HostExecutableLayout> executable_layout_;
+  RecordingExecutable executable_;
+};
+
+TEST_F(InProcCommandBufferTest, ReusablePreparesOnce) {
+  InProcCommandBuffer command_buffer(CommandBufferMode(0),
+                                     CommandCategory::kDispatch);
+  IREE_ASSERT_OK(Record(&command_buffer));
+  EXPECT_EQ(1, executable_.prepare_count);
+
+  // Only the commands that were not folded into the plan reach the processor.
+  testing::MockCommandBuffer command_processor(CommandBufferMode::kOneShot,
+                                               CommandCategory::kDispatch);
+  EXPECT_CALL(command_processor, Begin())
+      .Times(3)
+      .WillRepeatedly(Return(OkStatus()));
+  EXPECT_CALL(command_processor, FillBuffer(buffer_.get(), 0, 16, _, 4))
+      .Times(3)
+      .WillRepeatedly(Return(OkStatus()));
+  EXPECT_CALL(command_processor, End())
+      .Times(3)
+      .WillRepeatedly(Return(OkStatus()));
+  for (int i = 0; i < 3; ++i) {
+    IREE_ASSERT_OK(command_buffer.Process(&command_processor));
+  }
+
+  EXPECT_EQ(1, executable_.prepare_count);
+  EXPECT_EQ(3 * 4, executable_.tile_count);
+  EXPECT_EQ(42, executable_.last_push_constant);
+  EXPECT_EQ(BindingPtr(), executable_.last_binding_ptr);
+}
+
+TEST_F(InProcCommandBufferTest, ReusableReRecord) {
+  InProcCommandBuffer command_buffer(CommandBufferMode(0),
+                                     CommandCategory::kDispatch);
+  IREE_ASSERT_OK(Record(&command_buffer));
+  IREE_ASSERT_OK(Record(&command_buffer));
+  EXPECT_EQ(2, executable_.prepare_count);
+}
+
+TEST_F(InProcCommandBufferTest, ReusableConcurrentSubmissions) {
+  InProcCommandBuffer command_buffer(CommandBufferMode(0),
+                                     CommandCategory::kDispatch);
+  IREE_ASSERT_OK(Record(&command_buffer));
+
+  // Submissions from multiple queues share the prepared dispatch state and
+  // must not overlap.
+  constexpr int kIterations = 100;
+  auto submit = [&]() {
+    testing::MockCommandBuffer command_processor(CommandBufferMode::kOneShot,
+                                                 CommandCategory::kDispatch);
+    EXPECT_CALL(command_processor, Begin())
+        .WillRepeatedly(Return(OkStatus()));
+    EXPECT_CALL(command_processor, FillBuffer(buffer_.get(), 0, 16, _, 4))
+        .WillRepeatedly(Return(OkStatus()));
+    EXPECT_CALL(command_processor, End()).WillRepeatedly(Return(OkStatus()));
+    for (int i = 0; i < kIterations; ++i) {
+      IREE_EXPECT_OK(command_buffer.Process(&command_processor));
+    }
+  };
+  std::thread thread(submit);
+  submit();
+  thread.join();
+
+  EXPECT_EQ(1, executable_.prepare_count);
+  EXPECT_EQ(2 * kIterations * 4, executable_.tile_count);
+}
+
+TEST_F(InProcCommandBufferTest, OneShotForwardsAllCommands) {
+  InProcCommandBuffer command_buffer(CommandBufferMode::kOneShot,
+                                     CommandCategory::kDispatch);
+  IREE_ASSERT_OK(Record(&command_buffer));
+  EXPECT_EQ(0, executable_.prepare_count);
+
+  testing::MockCommandBuffer command_processor(CommandBufferMode::kOneShot,
+                                               CommandCategory::kDispatch);
+  EXPECT_CALL(command_processor, Begin()).WillOnce(Return(OkStatus()));
+  EXPECT_CALL(command_processor, PushConstants(executable_layout_.get(), 0, _))
+      .WillOnce(Return(OkStatus()));
+  EXPECT_CALL(command_processor,
+              PushDescriptorSet(executable_layout_.get(), 0, _))
+      .WillOnce(Return(OkStatus()));
+  EXPECT_CALL(command_processor, FillBuffer(buffer_.get(), 0, 16, _, 4))
+      .WillOnce(Return(OkStatus()));
+  EXPECT_CALL(command_processor, Dispatch(&executable_, 0, _))
+      .WillOnce(Return(OkStatus()));
+  EXPECT_CALL(command_processor, End()).WillOnce(Return(OkStatus()));
+  IREE_ASSERT_OK(command_buffer.Process(&command_processor));
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
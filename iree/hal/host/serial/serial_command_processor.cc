@@ -16,16 +16,17 @@
 
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
-#include "iree/hal/host/host_descriptor_set.h"
-#include "iree/hal/host/host_executable_layout.h"
 
 namespace iree {
 namespace hal {
 namespace host {
 
 SerialCommandProcessor::SerialCommandProcessor(
-    CommandCategoryBitfield command_categories)
-    : CommandBuffer(CommandBufferMode::kOneShot, command_categories) {}
+    CommandCategoryBitfield command_categories, Arena* dispatch_arena,
+    TileDispatcher* tile_dispatcher)
+    : CommandBuffer(CommandBufferMode::kOneShot, command_categories),
+      tile_dispatcher_(tile_dispatcher),
+      dispatch_arena_(dispatch_arena) {}
 
 SerialCommandProcessor::~SerialCommandProcessor() = default;
 
@@ -115,14 +116,7 @@ Status SerialCommandProcessor::PushConstants(
     ExecutableLayout* executable_layout, size_t offset,
     absl::Span<const uint32_t> values) {
   IREE_TRACE_SCOPE0("SerialCommandProcessor::PushConstants");
-  if (offset + values.size() > push_constants_.values.size()) {
-    return InvalidArgumentErrorBuilder(IREE_LOC)
-           << "Push constants out of range";
-  }
-  for (int i = 0; i < values.size(); ++i) {
-    push_constants_.values[offset + i] = values[i];
-  }
-  return OkStatus();
+  return binding_state_.PushConstants(executable_layout, offset, values);
 }
 
 Status SerialCommandProcessor::PushDescriptorSet(
@@ -133,20 +127,7 @@ Status SerialCommandProcessor::PushDescriptorSet(
     return FailedPreconditionErrorBuilder(IREE_LOC)
            << "Command processor does not support dispatch operations";
   }
-
-  auto* host_executable_layout =
-      static_cast<HostExecutableLayout*>(executable_layout);
-  descriptor_sets_.resize(host_executable_layout->set_count());
-  if (set < 0 || set >= descriptor_sets_.size()) {
-    return InvalidArgumentErrorBuilder(IREE_LOC)
-           << "Set " << set << " out of range (" << descriptor_sets_.size()
-           << ")";
-  }
-
-  auto& set_bindings = descriptor_sets_[set];
-  set_bindings = {bindings.begin(), bindings.end()};
-
-  return OkStatus();
+  return binding_state_.PushDescriptorSet(executable_layout, set, bindings);
 }
 
 Status SerialCommandProcessor::BindDescriptorSet(
@@ -158,35 +139,8 @@ Status SerialCommandProcessor::BindDescriptorSet(
     return FailedPreconditionErrorBuilder(IREE_LOC)
            << "Command processor does not support dispatch operations";
   }
-
-  auto* host_executable_layout =
-      static_cast<HostExecutableLayout*>(executable_layout);
-  descriptor_sets_.resize(host_executable_layout->set_count());
-  if (set < 0 || descriptor_sets_.size() >= set) {
-    return InvalidArgumentErrorBuilder(IREE_LOC)
-           << "Set " << set << " out of range (" << descriptor_sets_.size()
-           << ")";
-  }
-
-  auto* host_descriptor_set = static_cast<HostDescriptorSet*>(descriptor_set);
-  auto* set_bindings = &descriptor_sets_[set];
-  *set_bindings = {host_descriptor_set->bindings().begin(),
-                   host_descriptor_set->bindings().end()};
-  if (!dynamic_offsets.empty()) {
-    auto dynamic_binding_map =
-        host_executable_layout->GetDynamicBindingMap(set);
-    if (dynamic_offsets.size() != dynamic_binding_map.size()) {
-      return InvalidArgumentErrorBuilder(IREE_LOC)
-             << "Dynamic offset count mismatch (provided "
-             << dynamic_offsets.size() << " but expected "
-             << dynamic_binding_map.size() << ")";
-    }
-    for (int i = 0; i < dynamic_binding_map.size(); ++i) {
-      (*set_bindings)[dynamic_binding_map[i]].offset += dynamic_offsets[i];
-    }
-  }
-
-  return OkStatus();
+  return binding_state_.BindDescriptorSet(executable_layout, set,
+                                          descriptor_set, dynamic_offsets);
 }
 
 Status SerialCommandProcessor::Dispatch(Executable* executable,
@@ -211,21 +165,19 @@ Status SerialCommandProcessor::DispatchIndirect(
 Status SerialCommandProcessor::DispatchGrid(
     Executable* executable, int32_t entry_point,
     std::array<uint32_t, 3> workgroup_count) {
-  HostExecutable::DispatchParams params;
-  params.entry_point = entry_point;
-  params.workgroup_count = workgroup_count;
-  params.push_constants = &push_constants_;
-
-  absl::InlinedVector<absl::Span<const DescriptorSet::Binding>, 2>
-      descriptor_sets(descriptor_sets_.size());
-  for (int i = 0; i < descriptor_sets_.size(); ++i) {
-    descriptor_sets[i] = absl::MakeConstSpan(descriptor_sets_[i]);
-  }
-  params.set_bindings = descriptor_sets;
+  // Only one dispatch is in-flight at a time so any state from the previous
+  // dispatch can be dropped.
+  dispatch_arena_->Reset();
+
+  auto params = binding_state_.GetDispatchParams(entry_point, workgroup_count);
 
   auto* host_executable = reinterpret_cast<HostExecutable*>(executable);
-  IREE_ASSIGN_OR_RETURN(auto dispatch_state,
-                        host_executable->PrepareDispatch(params));
+  IREE_ASSIGN_OR_RETURN(auto dispatch_state, host_executable->PrepareDispatch(
+                                                 params, dispatch_arena_));
+  if (tile_dispatcher_) {
+    return tile_dispatcher_->DispatchGrid(
+        host_executable, dispatch_state.get(), params.workgroup_count);
+  }
   for (uint32_t z = 0; z < params.workgroup_count[2]; ++z) {
     for (uint32_t y = 0; y < params.workgroup_count[1]; ++y) {
       for (uint32_t x = 0; x < params.workgroup_count[0]; ++x) {
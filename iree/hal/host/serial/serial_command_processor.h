@@ -15,9 +15,11 @@
 #ifndef IREE_HAL_HOST_SERIAL_SERIAL_COMMAND_PROCESSOR_H_
 #define IREE_HAL_HOST_SERIAL_SERIAL_COMMAND_PROCESSOR_H_
 
-#include "absl/container/inlined_vector.h"
+#include "iree/base/arena.h"
 #include "iree/hal/command_buffer.h"
+#include "iree/hal/host/host_binding_state.h"
 #include "iree/hal/host/host_executable.h"
+#include "iree/hal/host/tile_dispatcher.h"
 
 namespace iree {
 namespace hal {
@@ -28,12 +30,22 @@ namespace host {
 // This assumes that all buffers are host-visible (if not local) and that all
 // buffers can be mapped for access.
 //
-// Uses HostExecutable to perform tiled dispatch processing.
+// Uses HostExecutable to perform tiled dispatch processing. Tiles are processed
+// in-order on the calling thread unless a |tile_dispatcher| is provided, in
+// which case each grid is handed off to it and the processor blocks until the
+// grid completes (preserving the in-order semantics of the command buffer).
+//
+// Per-dispatch state is allocated from |dispatch_arena|, which is reset before
+// each dispatch. The arena is owned by the caller (usually the queue) so that
+// its blocks are reused across submissions instead of being reallocated by
+// each short-lived processor.
 //
 // Thread-compatible (as with CommandBuffer itself).
 class SerialCommandProcessor final : public CommandBuffer {
  public:
-  explicit SerialCommandProcessor(CommandCategoryBitfield command_categories);
+  SerialCommandProcessor(CommandCategoryBitfield command_categories,
+                         Arena* dispatch_arena,
+                         TileDispatcher* tile_dispatcher = nullptr);
   ~SerialCommandProcessor() override;
 
   bool is_recording() const override { return is_recording_; }
@@ -96,11 +108,13 @@ class SerialCommandProcessor final : public CommandBuffer {
   Status DispatchGrid(Executable* executable, int32_t entry_point,
                       std::array<uint32_t, 3> workgroup_count);
 
+  TileDispatcher* tile_dispatcher_ = nullptr;
   bool is_recording_ = false;
 
-  PushConstantBlock push_constants_;
-  absl::InlinedVector<absl::InlinedVector<DescriptorSet::Binding, 8>, 2>
-      descriptor_sets_;
+  // Backing storage for dispatch state; reset on each dispatch.
+  Arena* dispatch_arena_;
+
+  HostBindingState binding_state_;
 };
 
 }  // namespace host
@@ -14,6 +14,7 @@
 
 #include "iree/hal/host/serial/serial_scheduling_model.h"
 
+#include "iree/base/arena.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/host/condvar_semaphore.h"
 #include "iree/hal/host/inproc_command_buffer.h"
@@ -72,11 +73,18 @@ class UnsynchronizedCommandQueue final : public CommandQueue {
     for (auto* command_buffer : command_buffers) {
       auto* inproc_command_buffer =
           static_cast<InProcCommandBuffer*>(command_buffer->impl());
-      SerialCommandProcessor command_processor(supported_categories());
+      dispatch_arena_.Reset();
+      SerialCommandProcessor command_processor(supported_categories(),
+                                               &dispatch_arena_);
       IREE_RETURN_IF_ERROR(inproc_command_buffer->Process(&command_processor));
     }
     return OkStatus();
   }
+
+  // Backing storage for the dispatch state of the command buffer being
+  // processed. Submissions are serialized by the wrapping queue so a single
+  // arena can be reset and reused for each one.
+  Arena dispatch_arena_;
 };
 
 }  // namespace
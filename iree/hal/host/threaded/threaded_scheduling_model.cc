@@ -0,0 +1,136 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/threaded/threaded_scheduling_model.h"
+
+#include "iree/base/arena.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/host/condvar_semaphore.h"
+#include "iree/hal/host/inproc_command_buffer.h"
+#include "iree/hal/host/nop_event.h"
+#include "iree/hal/host/serial/async_command_queue.h"
+#include "iree/hal/host/serial/serial_command_processor.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+// A CommandQueue that performs no synchronization (semaphores/fences) and
+// executes command buffers inline, handing each dispatch grid to a shared
+// TileDispatcher.
+//
+// This is meant to be wrapped by AsyncCommandQueue which handles all of the
+// semaphore synchronization and threading of the submissions themselves.
+class TiledCommandQueue final : public CommandQueue {
+ public:
+  TiledCommandQueue(std::string name,
+                    CommandCategoryBitfield supported_categories,
+                    TileDispatcher* tile_dispatcher)
+      : CommandQueue(std::move(name), supported_categories),
+        tile_dispatcher_(tile_dispatcher) {}
+  ~TiledCommandQueue() override = default;
+
+  Status Submit(absl::Span<const SubmissionBatch> batches) override {
+    IREE_TRACE_SCOPE0("TiledCommandQueue::Submit");
+    for (auto& batch : batches) {
+      DCHECK(batch.wait_semaphores.empty() && batch.signal_semaphores.empty())
+          << "Semaphores must be handled by the wrapping queue";
+      for (auto* command_buffer : batch.command_buffers) {
+        auto* inproc_command_buffer =
+            static_cast<InProcCommandBuffer*>(command_buffer->impl());
+        dispatch_arena_.Reset();
+        SerialCommandProcessor command_processor(
+            supported_categories(), &dispatch_arena_, tile_dispatcher_);
+        IREE_RETURN_IF_ERROR(inproc_command_buffer->Process(
+            &command_processor, tile_dispatcher_));
+      }
+    }
+    return OkStatus();
+  }
+
+  Status WaitIdle(Time deadline_ns) override {
+    // No-op; all work is completed inline within Submit.
+    return OkStatus();
+  }
+
+ private:
+  TileDispatcher* tile_dispatcher_;
+
+  // Backing storage for the dispatch state of the command buffer being
+  // processed. Submissions are serialized by the wrapping queue so a single
+  // arena can be reset and reused for each one.
+  Arena dispatch_arena_;
+};
+
+}  // namespace
+
+ThreadedSchedulingModel::ThreadedSchedulingModel(int worker_count)
+    : tile_dispatcher_(
+          absl::make_unique<WorkStealingTileDispatcher>(worker_count)) {
+  // We currently only expose a single command queue. Its dispatches fan out
+  // across the tile workers.
+  auto command_queue = absl::make_unique<TiledCommandQueue>(
+      "cpu0", CommandCategory::kTransfer | CommandCategory::kDispatch,
+      tile_dispatcher_.get());
+
+  // Wrap in the simple async command queue.
+  auto async_command_queue =
+      absl::make_unique<AsyncCommandQueue>(std::move(command_queue));
+  command_queues_.push_back(std::move(async_command_queue));
+}
+
+ThreadedSchedulingModel::~ThreadedSchedulingModel() {
+  // Drain the queues before the tile dispatcher they use is destroyed.
+  command_queues_.clear();
+  tile_dispatcher_.reset();
+}
+
+StatusOr<ref_ptr<CommandBuffer>> ThreadedSchedulingModel::CreateCommandBuffer(
+    CommandBufferModeBitfield mode,
+    CommandCategoryBitfield command_categories) {
+  return make_ref<InProcCommandBuffer>(mode, command_categories);
+}
+
+StatusOr<ref_ptr<Event>> ThreadedSchedulingModel::CreateEvent() {
+  return make_ref<NopEvent>();
+}
+
+StatusOr<ref_ptr<Semaphore>> ThreadedSchedulingModel::CreateSemaphore(
+    uint64_t initial_value) {
+  return make_ref<CondVarSemaphore>(initial_value);
+}
+
+Status ThreadedSchedulingModel::WaitAllSemaphores(
+    absl::Span<const SemaphoreValue> semaphores, Time deadline_ns) {
+  return CondVarSemaphore::WaitForSemaphores(semaphores, /*wait_all=*/true,
+                                             deadline_ns);
+}
+
+StatusOr<int> ThreadedSchedulingModel::WaitAnySemaphore(
+    absl::Span<const SemaphoreValue> semaphores, Time deadline_ns) {
+  return CondVarSemaphore::WaitForSemaphores(semaphores, /*wait_all=*/false,
+                                             deadline_ns);
+}
+
+Status ThreadedSchedulingModel::WaitIdle(Time deadline_ns) {
+  for (auto& command_queue : command_queues_) {
+    IREE_RETURN_IF_ERROR(command_queue->WaitIdle(deadline_ns));
+  }
+  return OkStatus();
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
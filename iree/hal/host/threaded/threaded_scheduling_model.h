@@ -0,0 +1,79 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_THREADED_THREADED_SCHEDULING_MODEL_H_
+#define IREE_HAL_HOST_THREADED_THREADED_SCHEDULING_MODEL_H_
+
+#include <memory>
+
+#include "absl/container/inlined_vector.h"
+#include "iree/base/memory.h"
+#include "iree/hal/host/scheduling_model.h"
+#include "iree/hal/host/threaded/work_stealing_tile_dispatcher.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Performs host-local scheduling with in-order queues whose dispatches are
+// spread across a pool of worker threads.
+//
+// Submissions and commands are processed in-order as with the
+// SerialSchedulingModel, however the tiles of each dispatch grid are executed
+// in parallel by a WorkStealingTileDispatcher. Each dispatch completes before
+// the next command is processed and as such barriers and events recorded in
+// command buffers continue to hold.
+//
+// Executables used with this model must support DispatchTile being called
+// concurrently from multiple threads.
+class ThreadedSchedulingModel final : public SchedulingModel {
+ public:
+  // Creates a scheduling model with |worker_count| tile worker threads.
+  // See WorkStealingTileDispatcher for how |worker_count| is interpreted.
+  explicit ThreadedSchedulingModel(int worker_count);
+  ~ThreadedSchedulingModel() override;
+
+  absl::Span<CommandQueue*> dispatch_queues() const override {
+    return RawPtrSpan(absl::MakeSpan(command_queues_));
+  }
+
+  absl::Span<CommandQueue*> transfer_queues() const override {
+    return RawPtrSpan(absl::MakeSpan(command_queues_));
+  }
+
+  StatusOr<ref_ptr<CommandBuffer>> CreateCommandBuffer(
+      CommandBufferModeBitfield mode,
+      CommandCategoryBitfield command_categories) override;
+
+  StatusOr<ref_ptr<Event>> CreateEvent() override;
+
+  StatusOr<ref_ptr<Semaphore>> CreateSemaphore(uint64_t initial_value) override;
+
+  Status WaitAllSemaphores(absl::Span<const SemaphoreValue> semaphores,
+                           Time deadline_ns) override;
+  StatusOr<int> WaitAnySemaphore(absl::Span<const SemaphoreValue> semaphores,
+                                 Time deadline_ns) override;
+  Status WaitIdle(Time deadline_ns) override;
+
+ private:
+  // Must outlive the command queues that reference it.
+  std::unique_ptr<WorkStealingTileDispatcher> tile_dispatcher_;
+  mutable absl::InlinedVector<std::unique_ptr<CommandQueue>, 4> command_queues_;
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_THREADED_THREADED_SCHEDULING_MODEL_H_
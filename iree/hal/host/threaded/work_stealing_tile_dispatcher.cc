@@ -0,0 +1,188 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/threaded/work_stealing_tile_dispatcher.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "absl/memory/memory.h"
+
+#include "iree/base/status.h"
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+inline uint64_t PackRange(uint32_t begin, uint32_t end) {
+  return (static_cast<uint64_t>(end) << 32) | begin;
+}
+
+inline uint32_t RangeBegin(uint64_t range) {
+  return static_cast<uint32_t>(range);
+}
+
+inline uint32_t RangeEnd(uint64_t range) {
+  return static_cast<uint32_t>(range >> 32);
+}
+
+}  // namespace
+
+// State for a single in-flight grid shared by all participants.
+struct WorkStealingTileDispatcher::Grid {
+  HostExecutable* executable = nullptr;
+  HostExecutable::DispatchState* dispatch_state = nullptr;
+  std::array<uint32_t, 3> workgroup_count;
+
+  // Set when any tile fails so that participants stop processing early.
+  std::atomic<bool> failed{false};
+  absl::Mutex status_mutex;
+  Status status ABSL_GUARDED_BY(status_mutex);
+
+  void RunTile(uint32_t tile_index) {
+    std::array<uint32_t, 3> workgroup_xyz;
+    workgroup_xyz[0] = tile_index % workgroup_count[0];
+    tile_index /= workgroup_count[0];
+    workgroup_xyz[1] = tile_index % workgroup_count[1];
+    workgroup_xyz[2] = tile_index / workgroup_count[1];
+    auto tile_status = executable->DispatchTile(dispatch_state, workgroup_xyz);
+    if (!tile_status.ok()) {
+      absl::MutexLock lock(&status_mutex);
+      if (status.ok()) status = std::move(tile_status);
+      failed.store(true, std::memory_order_release);
+    }
+  }
+};
+
+WorkStealingTileDispatcher::WorkStealingTileDispatcher(int worker_count)
+    : WorkStealingTileDispatcher(ThreadPool::Create(worker_count)) {}
+
+WorkStealingTileDispatcher::WorkStealingTileDispatcher(
+    ref_ptr<ThreadPool> thread_pool)
+    : thread_pool_(std::move(thread_pool)) {
+  tile_ranges_ = absl::make_unique<TileRange[]>(thread_pool_->concurrency());
+}
+
+WorkStealingTileDispatcher::~WorkStealingTileDispatcher() = default;
+
+Status WorkStealingTileDispatcher::DispatchGrid(
+    HostExecutable* executable, HostExecutable::DispatchState* dispatch_state,
+    std::array<uint32_t, 3> workgroup_count) {
+  IREE_TRACE_SCOPE0("WorkStealingTileDispatcher::DispatchGrid");
+
+  uint64_t tile_count = static_cast<uint64_t>(workgroup_count[0]) *
+                        workgroup_count[1] * workgroup_count[2];
+  if (tile_count == 0) return OkStatus();
+  if (tile_count > std::numeric_limits<uint32_t>::max()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Workgroup count " << workgroup_count[0] << "x"
+           << workgroup_count[1] << "x" << workgroup_count[2]
+           << " exceeds the maximum tile count";
+  }
+
+  absl::MutexLock dispatch_lock(&dispatch_mutex_);
+
+  Grid grid;
+  grid.executable = executable;
+  grid.dispatch_state = dispatch_state;
+  grid.workgroup_count = workgroup_count;
+
+  // Fast path for grids that would gain nothing from being distributed.
+  if (worker_count() == 0 || tile_count == 1) {
+    for (uint32_t i = 0; i < tile_count && !grid.failed.load(); ++i) {
+      grid.RunTile(i);
+    }
+    absl::MutexLock lock(&grid.status_mutex);
+    return std::move(grid.status);
+  }
+
+  // Evenly split the tiles across all participants. The caller takes the last
+  // slot and participates in processing.
+  int slot_count = thread_pool_->concurrency();
+  uint32_t tiles_per_slot = static_cast<uint32_t>(tile_count / slot_count);
+  uint32_t tiles_remainder = static_cast<uint32_t>(tile_count % slot_count);
+  uint32_t tile_begin = 0;
+  for (int i = 0; i < slot_count; ++i) {
+    uint32_t tile_end =
+        tile_begin + tiles_per_slot + (i < tiles_remainder ? 1 : 0);
+    tile_ranges_[i].value.store(PackRange(tile_begin, tile_end),
+                                std::memory_order_relaxed);
+    tile_begin = tile_end;
+  }
+
+  // Returns once all participants that joined have left the grid, at which
+  // point there are no tiles still executing.
+  thread_pool_->Run([&](int slot) { ProcessGrid(&grid, slot); });
+
+  absl::MutexLock lock(&grid.status_mutex);
+  return std::move(grid.status);
+}
+
+void WorkStealingTileDispatcher::ProcessGrid(Grid* grid, int slot) {
+  IREE_TRACE_SCOPE0("WorkStealingTileDispatcher::ProcessGrid");
+  do {
+    uint32_t tile_index = 0;
+    while (PopTile(slot, &tile_index)) {
+      if (grid->failed.load(std::memory_order_acquire)) return;
+      grid->RunTile(tile_index);
+    }
+  } while (StealTiles(slot));
+}
+
+bool WorkStealingTileDispatcher::PopTile(int slot, uint32_t* out_tile_index) {
+  auto& range = tile_ranges_[slot].value;
+  uint64_t value = range.load(std::memory_order_acquire);
+  while (true) {
+    uint32_t begin = RangeBegin(value);
+    uint32_t end = RangeEnd(value);
+    if (begin >= end) return false;
+    if (range.compare_exchange_weak(value, PackRange(begin + 1, end),
+                                    std::memory_order_acq_rel,
+                                    std::memory_order_acquire)) {
+      *out_tile_index = begin;
+      return true;
+    }
+  }
+}
+
+bool WorkStealingTileDispatcher::StealTiles(int slot) {
+  int slot_count = thread_pool_->concurrency();
+  for (int i = 1; i < slot_count; ++i) {
+    auto& victim = tile_ranges_[(slot + i) % slot_count].value;
+    uint64_t value = victim.load(std::memory_order_acquire);
+    while (true) {
+      uint32_t begin = RangeBegin(value);
+      uint32_t end = RangeEnd(value);
+      if (begin >= end) break;
+      // Take the back half (rounding up so single tiles can be stolen).
+      uint32_t mid = begin + (end - begin) / 2;
+      if (victim.compare_exchange_weak(value, PackRange(begin, mid),
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+        // Our own range is empty (we only steal once it is) so no other
+        // participant can be modifying it; thieves only CAS non-empty ranges.
+        tile_ranges_[slot].value.store(PackRange(mid, end),
+                                       std::memory_order_release);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,99 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_THREADED_WORK_STEALING_TILE_DISPATCHER_H_
+#define IREE_HAL_HOST_THREADED_WORK_STEALING_TILE_DISPATCHER_H_
+
+#include <atomic>
+#include <memory>
+
+#include "absl/synchronization/mutex.h"
+#include "iree/base/ref_ptr.h"
+#include "iree/base/thread_pool.h"
+#include "iree/hal/host/tile_dispatcher.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// A TileDispatcher that spreads the tiles of each grid across the threads of
+// a ThreadPool with work stealing.
+//
+// Each grid is linearized into a contiguous range of tile indices that is
+// split evenly across all pool participants (the workers plus the calling
+// thread). Participants pop tiles from the front of their own range and when
+// it runs dry steal the back half of the range of another participant. Ranges
+// are packed into a single 64-bit word so both popping and stealing are a
+// single compare-and-swap. Participants that never join (such as when the pool
+// is busy with another job) have their ranges stolen by those that do.
+//
+// Grids are processed one at a time: DispatchGrid blocks until every
+// participant has left the grid, which is what allows command processors to
+// treat each dispatch as a full execution barrier.
+//
+// Thread-safe.
+class WorkStealingTileDispatcher final : public TileDispatcher {
+ public:
+  // Creates a dispatcher with its own pool of |worker_count| threads.
+  // See ThreadPool::Create for how |worker_count| is interpreted. A
+  // |worker_count| of 0 processes all tiles on the calling thread.
+  explicit WorkStealingTileDispatcher(int worker_count);
+
+  // Creates a dispatcher running tiles on |thread_pool|, which may be shared
+  // with other users.
+  explicit WorkStealingTileDispatcher(ref_ptr<ThreadPool> thread_pool);
+
+  ~WorkStealingTileDispatcher() override;
+
+  // Total number of worker threads used by the dispatcher.
+  int worker_count() const { return thread_pool_->worker_count(); }
+
+  Status DispatchGrid(HostExecutable* executable,
+                      HostExecutable::DispatchState* dispatch_state,
+                      std::array<uint32_t, 3> workgroup_count) override;
+
+ private:
+  struct Grid;
+
+  // A [begin, end) range of linearized tile indices.
+  // Cache line aligned to avoid false sharing between participants.
+  struct alignas(64) TileRange {
+    std::atomic<uint64_t> value{0};
+  };
+
+  // Processes tiles from |grid| as participant |slot| until no more tiles can
+  // be found in any participant range.
+  void ProcessGrid(Grid* grid, int slot);
+
+  // Pops the next tile from the front of the range owned by |slot|.
+  bool PopTile(int slot, uint32_t* out_tile_index);
+
+  // Steals the back half of another participant's range into |slot|.
+  // Returns false if all ranges were empty.
+  bool StealTiles(int slot);
+
+  ref_ptr<ThreadPool> thread_pool_;
+
+  // One range per pool participant.
+  std::unique_ptr<TileRange[]> tile_ranges_;
+
+  // Serializes DispatchGrid calls as only one grid may use the tile ranges.
+  absl::Mutex dispatch_mutex_;
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_THREADED_WORK_STEALING_TILE_DISPATCHER_H_
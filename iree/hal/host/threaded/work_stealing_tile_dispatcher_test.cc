@@ -0,0 +1,158 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/threaded/work_stealing_tile_dispatcher.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "iree/base/arena.h"
+#include "iree/base/status.h"
+#include "iree/base/thread_pool.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+// Executable that counts how many times each tile in the grid was executed.
+class CountingExecutable final : public HostExecutable {
+ public:
+  struct CountingDispatchState : public DispatchState {
+    explicit CountingDispatchState(std::array<uint32_t, 3> workgroup_count)
+        : workgroup_count(workgroup_count),
+          tile_counts(workgroup_count[0] * workgroup_count[1] *
+                      workgroup_count[2]) {}
+    std::array<uint32_t, 3> workgroup_count;
+    std::vector<std::atomic<int>> tile_counts;
+  };
+
+  bool supports_debugging() const override { return false; }
+
+  StatusOr<DispatchStatePtr> PrepareDispatch(const DispatchParams& params,
+                                              Arena* arena) override {
+    return DispatchStatePtr(
+        arena->Allocate<CountingDispatchState>(params.workgroup_count));
+  }
+
+  Status DispatchTile(DispatchState* state,
+                      std::array<uint32_t, 3> workgroup_xyz) override {
+    auto* counting_state = static_cast<CountingDispatchState*>(state);
+    const auto& count = counting_state->workgroup_count;
+    if (workgroup_xyz[0] >= count[0] || workgroup_xyz[1] >= count[1] ||
+        workgroup_xyz[2] >= count[2]) {
+      return OutOfRangeErrorBuilder(IREE_LOC) << "Tile out of range";
+    }
+    if (fail_tile_ >= 0 && workgroup_xyz[0] == fail_tile_) {
+      return InternalErrorBuilder(IREE_LOC) << "Requested tile failure";
+    }
+    int tile_index = workgroup_xyz[0] +
+                     count[0] * (workgroup_xyz[1] + count[1] * workgroup_xyz[2]);
+    counting_state->tile_counts[tile_index].fetch_add(1);
+    return OkStatus();
+  }
+
+  void set_fail_tile(int fail_tile) { fail_tile_ = fail_tile; }
+
+ private:
+  int fail_tile_ = -1;
+};
+
+void ExpectAllTilesRunOnce(WorkStealingTileDispatcher* dispatcher,
+                           std::array<uint32_t, 3> workgroup_count) {
+  CountingExecutable executable;
+  Arena arena;
+  HostExecutable::DispatchParams params;
+  params.workgroup_count = workgroup_count;
+  IREE_ASSERT_OK_AND_ASSIGN(auto state,
+                            executable.PrepareDispatch(params, &arena));
+  IREE_ASSERT_OK(
+      dispatcher->DispatchGrid(&executable, state.get(), workgroup_count));
+  auto* counting_state =
+      static_cast<CountingExecutable::CountingDispatchState*>(state.get());
+  for (const auto& tile_count : counting_state->tile_counts) {
+    EXPECT_EQ(1, tile_count.load());
+  }
+}
+
+// Tests that all tiles run on the calling thread when there are no workers.
+TEST(WorkStealingTileDispatcherTest, NoWorkers) {
+  WorkStealingTileDispatcher dispatcher(0);
+  EXPECT_EQ(0, dispatcher.worker_count());
+  ExpectAllTilesRunOnce(&dispatcher, {7, 3, 2});
+}
+
+// Tests that empty grids are a no-op.
+TEST(WorkStealingTileDispatcherTest, EmptyGrid) {
+  WorkStealingTileDispatcher dispatcher(4);
+  ExpectAllTilesRunOnce(&dispatcher, {0, 1, 1});
+  ExpectAllTilesRunOnce(&dispatcher, {1, 1, 1});
+}
+
+// Tests grids with fewer tiles than there are workers.
+TEST(WorkStealingTileDispatcherTest, FewerTilesThanWorkers) {
+  WorkStealingTileDispatcher dispatcher(8);
+  ExpectAllTilesRunOnce(&dispatcher, {3, 1, 1});
+}
+
+// Tests that large grids have every tile executed exactly once.
+TEST(WorkStealingTileDispatcherTest, LargeGrid) {
+  WorkStealingTileDispatcher dispatcher(4);
+  ExpectAllTilesRunOnce(&dispatcher, {129, 17, 5});
+}
+
+// Tests that many dispatches can be issued back-to-back on the same pool.
+TEST(WorkStealingTileDispatcherTest, RepeatedDispatches) {
+  WorkStealingTileDispatcher dispatcher(3);
+  for (int i = 0; i < 100; ++i) {
+    ExpectAllTilesRunOnce(&dispatcher, {static_cast<uint32_t>(i + 1), 2, 1});
+  }
+}
+
+// Tests that dispatching while a shared pool is busy runs every tile on the
+// calling thread by stealing the ranges of the participants that never join.
+TEST(WorkStealingTileDispatcherTest, SharedBusyPool) {
+  auto thread_pool = ThreadPool::Create(3);
+  WorkStealingTileDispatcher dispatcher(add_ref(thread_pool));
+  EXPECT_EQ(3, dispatcher.worker_count());
+  ExpectAllTilesRunOnce(&dispatcher, {33, 2, 1});
+  thread_pool->ParallelFor(4, 1, [&](size_t begin, size_t end) {
+    if (begin == 0) ExpectAllTilesRunOnce(&dispatcher, {33, 2, 1});
+  });
+}
+
+// Tests that tile failures are propagated to the caller.
+TEST(WorkStealingTileDispatcherTest, TileFailure) {
+  WorkStealingTileDispatcher dispatcher(2);
+  CountingExecutable executable;
+  executable.set_fail_tile(5);
+  Arena arena;
+  HostExecutable::DispatchParams params;
+  params.workgroup_count = {64, 1, 1};
+  IREE_ASSERT_OK_AND_ASSIGN(auto state,
+                            executable.PrepareDispatch(params, &arena));
+  EXPECT_TRUE(IsInternal(dispatcher.DispatchGrid(&executable, state.get(),
+                                                 params.workgroup_count)));
+
+  // The dispatcher must remain usable after a failure.
+  ExpectAllTilesRunOnce(&dispatcher, {64, 1, 1});
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
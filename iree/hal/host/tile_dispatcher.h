@@ -0,0 +1,52 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_TILE_DISPATCHER_H_
+#define IREE_HAL_HOST_TILE_DISPATCHER_H_
+
+#include <array>
+#include <cstdint>
+
+#include "iree/base/status.h"
+#include "iree/hal/host/host_executable.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Distributes the tiles of a workgroup grid across some set of execution
+// resources (such as a pool of worker threads). Command processors use this to
+// parallelize dispatches while still retaining in-order command semantics.
+//
+// Thread-safe; multiple command processors may share a single dispatcher.
+class TileDispatcher {
+ public:
+  virtual ~TileDispatcher() = default;
+
+  // Processes every tile in the |workgroup_count| grid of |executable| using
+  // the prepared |dispatch_state|. Blocks the caller until all tiles have
+  // completed such that any subsequent command observes their side-effects.
+  //
+  // Tiles may execute in any order and on any thread. If any tile fails the
+  // remaining tiles may be skipped and one of the failures is returned.
+  virtual Status DispatchGrid(HostExecutable* executable,
+                              HostExecutable::DispatchState* dispatch_state,
+                              std::array<uint32_t, 3> workgroup_count) = 0;
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_TILE_DISPATCHER_H_
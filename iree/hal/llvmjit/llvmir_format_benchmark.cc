@@ -0,0 +1,167 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares load time and size of textual LLVM IR against bitcode for modules
+// shaped like those produced by the llvm-ir compiler target.
+
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+namespace {
+
+// Builds a module with |function_count| entry points using the dispatch ABI
+// (void**, i32*, i32*, i32*), each performing a small elementwise computation
+// over a loop so the IR has a realistic mix of instructions.
+std::unique_ptr<llvm::Module> BuildModule(llvm::LLVMContext& context,
+                                          int function_count) {
+  auto module = std::make_unique<llvm::Module>("benchmark", context);
+  llvm::IRBuilder<> builder(context);
+  auto* i8_ptr_ty = builder.getInt8PtrTy();
+  auto* i32_ptr_ty = builder.getInt32Ty()->getPointerTo();
+  auto* f32_ptr_ty = builder.getFloatTy()->getPointerTo();
+  auto* fn_ty = llvm::FunctionType::get(
+      builder.getVoidTy(),
+      {i8_ptr_ty->getPointerTo(), i32_ptr_ty, i32_ptr_ty, i32_ptr_ty},
+      /*isVarArg=*/false);
+  for (int i = 0; i < function_count; ++i) {
+    auto* fn = llvm::Function::Create(fn_ty, llvm::Function::ExternalLinkage,
+                                      "dispatch_" + std::to_string(i), *module);
+    auto* entry = llvm::BasicBlock::Create(context, "entry", fn);
+    auto* loop = llvm::BasicBlock::Create(context, "loop", fn);
+    auto* exit = llvm::BasicBlock::Create(context, "exit", fn);
+
+    builder.SetInsertPoint(entry);
+    auto* args = fn->getArg(0);
+    auto load_binding = [&](int ordinal) {
+      auto* binding_ptr =
+          builder.CreateConstGEP1_32(i8_ptr_ty, args, ordinal);
+      return builder.CreatePointerCast(
+          builder.CreateLoad(i8_ptr_ty, binding_ptr), f32_ptr_ty);
+    };
+    auto* lhs = load_binding(0);
+    auto* rhs = load_binding(1);
+    auto* out = load_binding(2);
+    builder.CreateBr(loop);
+
+    builder.SetInsertPoint(loop);
+    auto* iv = builder.CreatePHI(builder.getInt64Ty(), 2);
+    iv->addIncoming(builder.getInt64(0), entry);
+    auto* f32_ty = builder.getFloatTy();
+    llvm::Value* value =
+        builder.CreateLoad(f32_ty, builder.CreateGEP(f32_ty, lhs, iv));
+    llvm::Value* other =
+        builder.CreateLoad(f32_ty, builder.CreateGEP(f32_ty, rhs, iv));
+    for (int j = 0; j < 16; ++j) {
+      value = builder.CreateFAdd(builder.CreateFMul(value, other), other);
+    }
+    builder.CreateStore(value, builder.CreateGEP(f32_ty, out, iv));
+    auto* next = builder.CreateAdd(iv, builder.getInt64(1));
+    iv->addIncoming(next, loop);
+    builder.CreateCondBr(builder.CreateICmpULT(next, builder.getInt64(1024)),
+                         loop, exit);
+
+    builder.SetInsertPoint(exit);
+    builder.CreateRetVoid();
+  }
+  return module;
+}
+
+std::string SerializeText(const llvm::Module& module) {
+  std::string buffer;
+  llvm::raw_string_ostream os(buffer);
+  module.print(os, nullptr);
+  os.flush();
+  return buffer;
+}
+
+std::string SerializeBitcode(const llvm::Module& module) {
+  std::string buffer;
+  llvm::raw_string_ostream os(buffer);
+  llvm::WriteBitcodeToFile(module, os);
+  os.flush();
+  return buffer;
+}
+
+void BM_LoadTextualIR(benchmark::State& state) {
+  llvm::LLVMContext build_context;
+  std::string data =
+      SerializeText(*BuildModule(build_context, state.range(0)));
+  for (auto _ : state) {
+    // Matches the runtime: text needs a null terminated copy to parse.
+    llvm::LLVMContext context;
+    auto mem_buffer = llvm::MemoryBuffer::getMemBufferCopy(data, "llvm-ir");
+    llvm::SMDiagnostic sm_diagnostic;
+    auto module = llvm::parseAssembly(*mem_buffer, sm_diagnostic, context);
+    benchmark::DoNotOptimize(module);
+  }
+  state.counters["bytes"] = data.size();
+}
+BENCHMARK(BM_LoadTextualIR)->Arg(1)->Arg(16)->Arg(128);
+
+void BM_LoadBitcode(benchmark::State& state) {
+  llvm::LLVMContext build_context;
+  std::string data =
+      SerializeBitcode(*BuildModule(build_context, state.range(0)));
+  for (auto _ : state) {
+    llvm::LLVMContext context;
+    auto module_or = llvm::parseBitcodeFile(
+        llvm::MemoryBufferRef(data, "llvm-bc"), context);
+    benchmark::DoNotOptimize(module_or);
+    llvm::consumeError(module_or.takeError());
+  }
+  state.counters["bytes"] = data.size();
+}
+BENCHMARK(BM_LoadBitcode)->Arg(1)->Arg(16)->Arg(128);
+
+void BM_LoadBitcodeLazy(benchmark::State& state) {
+  llvm::LLVMContext build_context;
+  std::string data =
+      SerializeBitcode(*BuildModule(build_context, state.range(0)));
+  for (auto _ : state) {
+    // Only materializes the first entry point, as done when compiling entry
+    // points on demand.
+    llvm::LLVMContext context;
+    auto module_or = llvm::getLazyBitcodeModule(
+        llvm::MemoryBufferRef(data, "llvm-bc"), context);
+    if (!module_or) {
+      llvm::consumeError(module_or.takeError());
+      state.SkipWithError("failed to load bitcode");
+      break;
+    }
+    auto* fn = (*module_or)->getFunction("dispatch_0");
+    llvm::consumeError(fn->materialize());
+    benchmark::DoNotOptimize(fn);
+  }
+  state.counters["bytes"] = data.size();
+}
+BENCHMARK(BM_LoadBitcodeLazy)->Arg(1)->Arg(16)->Arg(128);
+
+}  // namespace
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
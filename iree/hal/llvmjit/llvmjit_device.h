@@ -15,6 +15,8 @@
 #ifndef IREE_HAL_LLVMJIT_LLVMJIT_DEVICE_H_
 #define IREE_HAL_LLVMJIT_LLVMJIT_DEVICE_H_
 
+#include <string>
+
 #include "iree/hal/host/host_local_device.h"
 
 namespace iree {
@@ -23,11 +25,17 @@ namespace llvmjit {
 
 class LLVMJITDevice final : public host::HostLocalDevice {
  public:
+  // |object_cache_dir| is passed on to executable caches created from this
+  // device; see LLVMJITExecutableCache.
   LLVMJITDevice(DeviceInfo device_info,
-                std::unique_ptr<host::SchedulingModel> scheduling_model);
+                std::unique_ptr<host::SchedulingModel> scheduling_model,
+                std::string object_cache_dir = "");
   ~LLVMJITDevice() override;
 
   ref_ptr<ExecutableCache> CreateExecutableCache() override;
+
+ private:
+  std::string object_cache_dir_;
 };
 
 }  // namespace llvmjit
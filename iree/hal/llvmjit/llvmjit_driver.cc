@@ -15,11 +15,20 @@
 #include "iree/hal/llvmjit/llvmjit_driver.h"
 
 #include <memory>
+#include <string>
 
+#include "absl/flags/flag.h"
 #include "iree/hal/device_info.h"
-#include "iree/hal/host/serial/serial_scheduling_model.h"
+#include "iree/hal/host/threaded/threaded_scheduling_model.h"
 #include "iree/hal/llvmjit/llvmjit_device.h"
 
+ABSL_FLAG(int, llvmjit_worker_count, -1,
+          "Number of worker threads used to process dispatch tiles in addition "
+          "to the queue thread. -1 uses all available hardware threads.");
+ABSL_FLAG(std::string, llvmjit_object_cache_dir, "",
+          "Directory used to persist JIT compiled executables across runs. "
+          "Empty disables the persistent cache.");
+
 namespace iree {
 namespace hal {
 namespace llvmjit {
@@ -54,9 +63,11 @@ StatusOr<ref_ptr<Device>> LLVMJITDriver::CreateDefaultDevice() {
 
 StatusOr<ref_ptr<Device>> LLVMJITDriver::CreateDevice(
     DriverDeviceID device_id) {
-  auto scheduling_model = std::make_unique<host::SerialSchedulingModel>();
-  return make_ref<LLVMJITDevice>(GetDefaultDeviceInfo(),
-                                 std::move(scheduling_model));
+  auto scheduling_model = std::make_unique<host::ThreadedSchedulingModel>(
+      absl::GetFlag(FLAGS_llvmjit_worker_count));
+  return make_ref<LLVMJITDevice>(
+      GetDefaultDeviceInfo(), std::move(scheduling_model),
+      absl::GetFlag(FLAGS_llvmjit_object_cache_dir));
 }
 
 }  // namespace llvmjit
@@ -14,18 +14,30 @@
 
 #include "iree/hal/llvmjit/llvmjit_executable.h"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 
+#include "absl/types/span.h"
 #include "flatbuffers/flatbuffers.h"
+#include "iree/base/arena.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/buffer.h"
 #include "iree/hal/executable.h"
 #include "iree/schemas/llvmir_executable_def_generated.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/AsmParser/Parser.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -35,41 +47,197 @@ namespace iree {
 namespace hal {
 namespace llvmjit {
 
-// static
-StatusOr<ref_ptr<LLVMJITExecutable>> LLVMJITExecutable::Load(
-    ExecutableSpec spec, bool allow_aliasing_data) {
-  IREE_TRACE_SCOPE0("LLVMJITExecutable::Load");
+namespace {
 
-  auto module_def =
-      ::flatbuffers::GetRoot<LLVMIRExecutableDef>(spec.executable_data.data());
-  auto data =
-      reinterpret_cast<const char*>(module_def->llvmir_module()->data());
-  const int size = module_def->llvmir_module()->size();
-  auto mem_buffer = llvm::MemoryBuffer::getMemBufferCopy(
-      llvm::StringRef(data, size), "llvm-ir");
-  auto llvm_context = std::make_unique<llvm::LLVMContext>();
+// Parses the module embedded in the executable. Bitcode is read directly out
+// of the flatbuffer; textual IR (only emitted for debugging) must be copied so
+// that the parser gets the null terminator it requires.
+StatusOr<std::unique_ptr<llvm::Module>> ParseModule(
+    llvm::StringRef module_data, llvm::LLVMContext* llvm_context) {
+  IREE_TRACE_SCOPE0("LLVMJITExecutable::ParseModule");
+  if (llvm::isBitcode(module_data.bytes_begin(), module_data.bytes_end())) {
+    auto module_or = llvm::parseBitcodeFile(
+        llvm::MemoryBufferRef(module_data, "llvm-bc"), *llvm_context);
+    if (!module_or) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Can't parse LLVM bitcode module: "
+             << llvm::toString(module_or.takeError());
+    }
+    return std::move(module_or.get());
+  }
+
+  auto mem_buffer =
+      llvm::MemoryBuffer::getMemBufferCopy(module_data, "llvm-ir");
   llvm::SMDiagnostic sm_diagnostic;
   auto module = llvm::parseAssembly(*mem_buffer, sm_diagnostic, *llvm_context);
   if (!module) {
     return InvalidArgumentErrorBuilder(IREE_LOC)
            << "Can't parse LLVMIR Module: " << sm_diagnostic.getMessage().str();
   }
-  auto dataLayout = module->getDataLayout();
-  const auto entry_points = module_def->entry_points();
+  return std::move(module);
+}
+
+// Creates a JIT that compiles the entire module as soon as any symbol is looked
+// up. If |object_cache| is provided then compiled objects are persisted to it
+// and |cached_object| (if any) is used instead of compiling.
+StatusOr<std::unique_ptr<llvm::orc::LLJIT>> CreateJIT(
+    llvm::StringRef module_data, LLVMJITObjectCache* object_cache,
+    std::unique_ptr<llvm::MemoryBuffer> cached_object,
+    const std::string& cache_key) {
+  llvm::orc::LLJITBuilder ll_jit_builder;
+  if (object_cache) {
+    // Route compilation through the object cache so newly compiled objects
+    // are persisted for future runs.
+    ll_jit_builder.setCompileFunctionCreator(
+        [object_cache](llvm::orc::JITTargetMachineBuilder jtmb)
+            -> llvm::Expected<
+                std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+          return std::make_unique<llvm::orc::ConcurrentIRCompiler>(
+              std::move(jtmb), object_cache);
+        });
+  }
+  auto ll_jit_or = ll_jit_builder.create();
+  if (!ll_jit_or) {
+    return UnavailableErrorBuilder(IREE_LOC)
+           << "Can't create LLJIT: " << llvm::toString(ll_jit_or.takeError());
+  }
+  auto ll_jit = std::move(ll_jit_or.get());
+
+  if (cached_object) {
+    IREE_TRACE_SCOPE0("LLVMJITExecutable::Load#cached");
+    llvm::Error err = ll_jit->addObjectFile(std::move(cached_object));
+    if (err) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Can't add cached object to executable LLJIT"
+             << llvm::toString(std::move(err));
+    }
+    return std::move(ll_jit);
+  }
+
+  auto llvm_context = std::make_unique<llvm::LLVMContext>();
+  IREE_ASSIGN_OR_RETURN(auto module,
+                        ParseModule(module_data, llvm_context.get()));
+  // The object cache stores compiled objects by module identifier.
+  if (object_cache) module->setModuleIdentifier(cache_key);
   llvm::orc::ThreadSafeModule thread_safe_module(std::move(module),
                                                  std::move(llvm_context));
-  auto ll_jit = llvm::cantFail(llvm::orc::LLJITBuilder().create());
-
   llvm::Error err = ll_jit->addIRModule(std::move(thread_safe_module));
   if (err) {
     return InvalidArgumentErrorBuilder(IREE_LOC)
            << "Can't add executable module to executable LLJIT"
            << llvm::toString(std::move(err));
   }
+  return std::move(ll_jit);
+}
+
+// Set on the calling thread by LazyCompileFailure and checked after each tile.
+thread_local bool lazy_compile_failed = false;
+
+// Called in place of a lazily compiled function that failed to compile or link;
+// without a handler ORC would jump to address 0. Entry points are compiled
+// together with everything they reference before they are dispatched (see
+// PartitionWithCallees) so this is not expected to be reached. If it is, the
+// failure is recorded and the tile that hit it fails; its results are
+// undefined.
+void LazyCompileFailure() { lazy_compile_failed = true; }
+
+// Extends the functions requested from the compile-on-demand layer with every
+// function they reference, directly or transitively. An entry point and its
+// callees are then compiled and linked in one piece when the entry point is
+// resolved, so any failure is reported by ResolveEntryPoint and no call made
+// during a dispatch goes through a stub that still has to compile.
+llvm::Optional<llvm::orc::CompileOnDemandLayer::GlobalValueSet>
+PartitionWithCallees(
+    llvm::orc::CompileOnDemandLayer::GlobalValueSet requested) {
+  llvm::orc::CompileOnDemandLayer::GlobalValueSet partition = requested;
+  llvm::SmallVector<const llvm::Value*, 16> worklist(requested.begin(),
+                                                     requested.end());
+  llvm::SmallPtrSet<const llvm::Value*, 16> visited;
+  while (!worklist.empty()) {
+    const llvm::Value* value = worklist.pop_back_val();
+    if (!visited.insert(value).second) continue;
+    if (const auto* function = llvm::dyn_cast<llvm::Function>(value)) {
+      if (function->isDeclaration()) continue;
+      partition.insert(function);
+      for (const auto& inst : llvm::instructions(function)) {
+        for (const auto& operand : inst.operands()) {
+          worklist.push_back(operand.get());
+        }
+      }
+    } else if (const auto* global =
+                   llvm::dyn_cast<llvm::GlobalVariable>(value)) {
+      // Functions referenced from initializers (such as function tables) may
+      // be called indirectly.
+      if (global->hasInitializer()) worklist.push_back(global->getInitializer());
+    } else if (const auto* constant = llvm::dyn_cast<llvm::Constant>(value)) {
+      for (const auto& operand : constant->operands()) {
+        worklist.push_back(operand.get());
+      }
+    }
+  }
+  return partition;
+}
+
+// Creates a JIT that hands out stubs for each function and only compiles a
+// function (and whatever it references) the first time it is needed.
+StatusOr<std::unique_ptr<llvm::orc::LLJIT>> CreateLazyJIT(
+    llvm::StringRef module_data) {
+  llvm::orc::LLLazyJITBuilder ll_jit_builder;
+  ll_jit_builder.setLazyCompileFailureAddr(
+      llvm::pointerToJITTargetAddress(&LazyCompileFailure));
+  auto ll_jit_or = ll_jit_builder.create();
+  if (!ll_jit_or) {
+    return UnavailableErrorBuilder(IREE_LOC)
+           << "Can't create LLLazyJIT: "
+           << llvm::toString(ll_jit_or.takeError());
+  }
+  auto ll_jit = std::move(ll_jit_or.get());
+  // By default the whole module is compiled on first use of any function;
+  // partition per entry point instead so unused entry points are never
+  // compiled.
+  ll_jit->setPartitionFunction(PartitionWithCallees);
+
+  auto llvm_context = std::make_unique<llvm::LLVMContext>();
+  IREE_ASSIGN_OR_RETURN(auto module,
+                        ParseModule(module_data, llvm_context.get()));
+  llvm::orc::ThreadSafeModule thread_safe_module(std::move(module),
+                                                 std::move(llvm_context));
+  llvm::Error err = ll_jit->addLazyIRModule(std::move(thread_safe_module));
+  if (err) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Can't add executable module to executable LLLazyJIT"
+           << llvm::toString(std::move(err));
+  }
+  return std::unique_ptr<llvm::orc::LLJIT>(std::move(ll_jit));
+}
+
+// Creates the JIT for |module_data| and resolves all |entry_points| into
+// |out_symbols|. With lazy compilation these resolve to stubs that compile the
+// function on first call; otherwise this compiles (or loads |cached_object|
+// for) the whole module.
+StatusOr<std::unique_ptr<llvm::orc::LLJIT>> CreateAndLinkJIT(
+    llvm::StringRef module_data,
+    const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>&
+        entry_points,
+    LLVMJITObjectCache* object_cache,
+    std::unique_ptr<llvm::MemoryBuffer> cached_object,
+    const std::string& cache_key, bool allow_lazy_compilation,
+    llvm::SmallVectorImpl<llvm::JITEvaluatedSymbol>* out_symbols) {
+  // Lazy compilation only pays off when we actually have to compile; when
+  // persisting objects we want the whole module compiled so that it can be
+  // stored in one piece.
+  std::unique_ptr<llvm::orc::LLJIT> ll_jit;
+  if (allow_lazy_compilation && !object_cache) {
+    IREE_ASSIGN_OR_RETURN(ll_jit, CreateLazyJIT(module_data));
+  } else {
+    IREE_ASSIGN_OR_RETURN(
+        ll_jit, CreateJIT(module_data, object_cache, std::move(cached_object),
+                          cache_key));
+  }
 
   auto dylib_serarch_generator =
       llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
-          dataLayout.getGlobalPrefix());
+          ll_jit->getDataLayout().getGlobalPrefix());
   if (!dylib_serarch_generator) {
     return UnavailableErrorBuilder(IREE_LOC)
            << "Can't resolve symbols in current process: "
@@ -79,19 +247,71 @@ StatusOr<ref_ptr<LLVMJITExecutable>> LLVMJITExecutable::Load(
   auto& main_jitdylib = ll_jit->getMainJITDylib();
   main_jitdylib.addGenerator(std::move(dylib_serarch_generator.get()));
 
-  auto executable =
-      make_ref<LLVMJITExecutable>(spec, std::move(ll_jit), allow_aliasing_data);
-
-  for (const auto func_name : *entry_points) {
-    auto func_symbol = executable->ll_jit_->lookup(func_name->str());
+  for (const auto func_name : entry_points) {
+    auto func_symbol = ll_jit->lookup(func_name->str());
     if (!func_symbol) {
       return NotFoundErrorBuilder(IREE_LOC)
-             << "Can't JIT compile function '" << func_name
+             << "Can't JIT compile function '" << func_name->str()
              << "': " << llvm::toString(func_symbol.takeError());
     }
-    executable->symbols_.push_back(func_symbol.get());
+    out_symbols->push_back(func_symbol.get());
   }
 
+  return std::move(ll_jit);
+}
+
+}  // namespace
+
+// static
+StatusOr<ref_ptr<LLVMJITExecutable>> LLVMJITExecutable::Load(
+    ExecutableSpec spec, bool allow_aliasing_data,
+    LLVMJITObjectCache* object_cache, bool allow_lazy_compilation) {
+  IREE_TRACE_SCOPE0("LLVMJITExecutable::Load");
+
+  auto module_def =
+      ::flatbuffers::GetRoot<LLVMIRExecutableDef>(spec.executable_data.data());
+  auto data =
+      reinterpret_cast<const char*>(module_def->llvmir_module()->data());
+  const int size = module_def->llvmir_module()->size();
+  llvm::StringRef module_data(data, size);
+  const auto entry_points = module_def->entry_points();
+
+  // Try to find a previously compiled object; if present we can skip parsing
+  // and codegen entirely.
+  std::string cache_key;
+  std::unique_ptr<llvm::MemoryBuffer> cached_object;
+  if (object_cache) {
+    cache_key = LLVMJITObjectCache::ComputeKey(module_data);
+    cached_object = object_cache->LookupObject(cache_key);
+  }
+  bool has_cached_object = cached_object != nullptr;
+
+  llvm::SmallVector<llvm::JITEvaluatedSymbol, 4> symbols;
+  auto ll_jit_or =
+      CreateAndLinkJIT(module_data, *entry_points, object_cache,
+                       std::move(cached_object), cache_key,
+                       allow_lazy_compilation, &symbols);
+  if (!ll_jit_or.ok() && has_cached_object) {
+    // The cached object is well-formed but can't be used in this process
+    // (e.g. it references symbols we don't provide). Drop it and compile from
+    // IR, which also replaces the entry.
+    object_cache->RemoveObject(cache_key);
+    symbols.clear();
+    ll_jit_or = CreateAndLinkJIT(module_data, *entry_points, object_cache,
+                                 /*cached_object=*/nullptr, cache_key,
+                                 allow_lazy_compilation, &symbols);
+  }
+  IREE_ASSIGN_OR_RETURN(auto ll_jit, std::move(ll_jit_or));
+
+  auto executable =
+      make_ref<LLVMJITExecutable>(spec, std::move(ll_jit), allow_aliasing_data);
+  for (const auto func_name : *entry_points) {
+    executable->entry_point_names_.push_back(func_name->str());
+  }
+  bool resolved = !allow_lazy_compilation || object_cache;
+  absl::MutexLock lock(&executable->symbols_mutex_);
+  executable->symbols_ = std::move(symbols);
+  executable->symbols_resolved_.assign(executable->symbols_.size(), resolved);
   return executable;
 }
 
@@ -109,44 +329,77 @@ LLVMJITExecutable::LLVMJITExecutable(ExecutableSpec spec,
 
 LLVMJITExecutable::~LLVMJITExecutable() = default;
 
+StatusOr<llvm::JITEvaluatedSymbol> LLVMJITExecutable::ResolveEntryPoint(
+    int entry_point) {
+  absl::MutexLock lock(&symbols_mutex_);
+  if (symbols_resolved_[entry_point]) return symbols_[entry_point];
+
+  IREE_TRACE_SCOPE0("LLVMJITExecutable::ResolveEntryPoint#compile");
+  // The stub only compiles the function when it is called and has no way to
+  // report failures to us. The compile-on-demand layer places the function
+  // bodies in a separate "<main>.impl" dylib; looking the function up there
+  // compiles it along with all of its callees now and returns any compile or
+  // link errors.
+  const auto& func_name = entry_point_names_[entry_point];
+  auto* impl_jitdylib = ll_jit_->getExecutionSession().getJITDylibByName(
+      ll_jit_->getMainJITDylib().getName() + ".impl");
+  if (!impl_jitdylib) {
+    return InternalErrorBuilder(IREE_LOC)
+           << "Lazily compiled functions not found for '" << func_name << "'";
+  }
+  auto func_symbol = ll_jit_->lookup(*impl_jitdylib, func_name);
+  if (!func_symbol) {
+    return NotFoundErrorBuilder(IREE_LOC)
+           << "Can't JIT compile function '" << func_name
+           << "': " << llvm::toString(func_symbol.takeError());
+  }
+  symbols_[entry_point] = func_symbol.get();
+  symbols_resolved_[entry_point] = true;
+  return symbols_[entry_point];
+}
+
 struct LLVMJITDispatchState : public HostExecutable::DispatchState {
   LLVMJITDispatchState() = default;
 
   llvm::JITEvaluatedSymbol symbol;
-  llvm::SmallVector<void*, 4> args;
-  llvm::SmallVector<int32_t, 4> push_constant;
+  absl::Span<void*> args;
+  absl::Span<int32_t> push_constant;
+  std::array<uint32_t, 3> workgroup_count;
 };
 
-StatusOr<ref_ptr<HostExecutable::DispatchState>>
-LLVMJITExecutable::PrepareDispatch(const DispatchParams& params) {
+StatusOr<HostExecutable::DispatchStatePtr> LLVMJITExecutable::PrepareDispatch(
+    const DispatchParams& params, Arena* arena) {
   IREE_TRACE_SCOPE0("LLVMJITExecutable::PrepareDispatch");
 
-  if (params.entry_point >= symbols_.size()) {
+  if (params.entry_point >= entry_point_names_.size()) {
     return InvalidArgumentErrorBuilder(IREE_LOC)
            << "Invalid entry point ordinal " << params.entry_point;
   }
+  IREE_ASSIGN_OR_RETURN(auto symbol, ResolveEntryPoint(params.entry_point));
 
-  auto dispatch_state = make_ref<LLVMJITDispatchState>();
-  dispatch_state->symbol = symbols_[params.entry_point];
+  DispatchStatePtr dispatch_state_ptr(arena->Allocate<LLVMJITDispatchState>());
+  auto* dispatch_state =
+      static_cast<LLVMJITDispatchState*>(dispatch_state_ptr.get());
+  dispatch_state->symbol = symbol;
+  dispatch_state->workgroup_count = params.workgroup_count;
 
-  for (size_t set = 0; set < params.set_bindings.size(); ++set) {
-    for (size_t binding = 0; binding < params.set_bindings[set].size();
-         ++binding) {
-      const auto& io_binding = params.set_bindings[set][binding];
-      IREE_ASSIGN_OR_RETURN(auto memory,
-                            io_binding.buffer->MapMemory<uint8_t>(
-                                MemoryAccessBitfield::kWrite, io_binding.offset,
-                                io_binding.length));
-      auto data = memory.mutable_data();
-      dispatch_state->args.push_back(data);
-    }
+  // Flatten the bindings from all sets into the argument list.
+  size_t binding_count = 0;
+  for (const auto& set_ptrs : params.set_binding_ptrs) {
+    binding_count += set_ptrs.size();
   }
-  // TODO(ataei): Consider moving this casting to codegen side ?!
-  for (int i = 0; i < params.push_constants->values.size(); ++i) {
-    dispatch_state->push_constant.push_back(params.push_constants->values[i]);
+  dispatch_state->args = arena->AllocateSpan<void*>(binding_count);
+  auto* arg = dispatch_state->args.data();
+  for (const auto& set_ptrs : params.set_binding_ptrs) {
+    arg = std::copy(set_ptrs.begin(), set_ptrs.end(), arg);
   }
 
-  return std::move(dispatch_state);
+  dispatch_state->push_constant =
+      arena->AllocateSpan<int32_t>(params.push_constants.size());
+  std::copy(params.push_constants.begin(), params.push_constants.end(),
+            dispatch_state->push_constant.begin());
+
+  return std::move(dispatch_state_ptr);
 }
 
 Status LLVMJITExecutable::DispatchTile(DispatchState* state,
@@ -154,10 +407,18 @@ Status LLVMJITExecutable::DispatchTile(DispatchState* state,
   IREE_TRACE_SCOPE0("LLVMJITExecutable::DispatchTile");
   auto* dispatch_state = static_cast<LLVMJITDispatchState*>(state);
 
-  auto func_ptr =
-      (void (*)(void**, int32_t*))dispatch_state->symbol.getAddress();
-  func_ptr(dispatch_state->args.data(), dispatch_state->push_constant.data());
+  // Each tile processes the slice of the iteration space selected by its
+  // workgroup ID; see LinalgTileAndDistributePass in the compiler.
+  auto func_ptr = (void (*)(void**, int32_t*, uint32_t*,
+                            uint32_t*))dispatch_state->symbol.getAddress();
+  func_ptr(dispatch_state->args.data(), dispatch_state->push_constant.data(),
+           workgroup_xyz.data(), dispatch_state->workgroup_count.data());
 
+  if (lazy_compile_failed) {
+    lazy_compile_failed = false;
+    return InternalErrorBuilder(IREE_LOC)
+           << "Lazy compilation of a function called by the executable failed";
+  }
   return OkStatus();
 }
 
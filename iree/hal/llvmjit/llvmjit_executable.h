@@ -15,11 +15,14 @@
 #ifndef IREE_HAL_LLVMJIT_LLVMJIT_EXECUTABLE_H_
 #define IREE_HAL_LLVMJIT_LLVMJIT_EXECUTABLE_H_
 
+#include <string>
 #include <vector>
 
+#include "absl/synchronization/mutex.h"
 #include "iree/base/status.h"
 #include "iree/hal/executable_spec.h"
 #include "iree/hal/host/host_executable.h"
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
 #include "iree/schemas/llvmir_executable_def_generated.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
@@ -32,8 +35,14 @@ struct MemrefType;
 
 class LLVMJITExecutable final : public HostExecutable {
  public:
-  static StatusOr<ref_ptr<LLVMJITExecutable>> Load(ExecutableSpec spec,
-                                                   bool allow_aliasing_data);
+  // Loads and JITs the executable. If |object_cache| is provided compiled
+  // objects are looked up in and stored to it. Otherwise, if
+  // |allow_lazy_compilation| is set, each entry point is only compiled the
+  // first time it is prepared for dispatch.
+  static StatusOr<ref_ptr<LLVMJITExecutable>> Load(
+      ExecutableSpec spec, bool allow_aliasing_data,
+      LLVMJITObjectCache* object_cache = nullptr,
+      bool allow_lazy_compilation = false);
 
   LLVMJITExecutable(ExecutableSpec spec,
                     std::unique_ptr<llvm::orc::LLJIT> ll_jit,
@@ -42,16 +51,27 @@ class LLVMJITExecutable final : public HostExecutable {
 
   bool supports_debugging() const override { return false; }
 
-  StatusOr<ref_ptr<DispatchState>> PrepareDispatch(
-      const DispatchParams& params) override;
+  StatusOr<DispatchStatePtr> PrepareDispatch(const DispatchParams& params,
+                                              Arena* arena) override;
   Status DispatchTile(DispatchState* state,
                       std::array<uint32_t, 3> workgroup_xyz) override;
 
  private:
+  // Returns the address of the compiled |entry_point|, compiling it first if
+  // it was loaded lazily and this is its first use.
+  StatusOr<llvm::JITEvaluatedSymbol> ResolveEntryPoint(int entry_point);
+
   ExecutableSpec spec_;
   std::vector<uint8_t> cloned_executable_data_;
   std::unique_ptr<llvm::orc::LLJIT> ll_jit_;
-  llvm::SmallVector<llvm::JITEvaluatedSymbol, 4> symbols_;
+  std::vector<std::string> entry_point_names_;
+
+  absl::Mutex symbols_mutex_;
+  // Entry point addresses. When loaded lazily these start out as call-through
+  // stubs and are replaced by the compiled functions on first use.
+  llvm::SmallVector<llvm::JITEvaluatedSymbol, 4> symbols_
+      ABSL_GUARDED_BY(symbols_mutex_);
+  llvm::SmallVector<bool, 4> symbols_resolved_ ABSL_GUARDED_BY(symbols_mutex_);
 };
 
 }  // namespace llvmjit
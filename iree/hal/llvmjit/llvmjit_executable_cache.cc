@@ -23,7 +23,12 @@ namespace iree {
 namespace hal {
 namespace llvmjit {
 
-LLVMJITExecutableCache::LLVMJITExecutableCache() = default;
+LLVMJITExecutableCache::LLVMJITExecutableCache(std::string object_cache_dir) {
+  if (!object_cache_dir.empty()) {
+    object_cache_ =
+        std::make_unique<LLVMJITObjectCache>(std::move(object_cache_dir));
+  }
+}
 
 LLVMJITExecutableCache::~LLVMJITExecutableCache() = default;
 
@@ -39,8 +44,16 @@ StatusOr<ref_ptr<Executable>> LLVMJITExecutableCache::PrepareExecutable(
   // Wrap the data (or copy it).
   bool allow_aliasing_data =
       AllBitsSet(mode, ExecutableCachingMode::kAliasProvidedData);
-  IREE_ASSIGN_OR_RETURN(auto executable,
-                        LLVMJITExecutable::Load(spec, !allow_aliasing_data));
+  LLVMJITObjectCache* object_cache =
+      AllBitsSet(mode, ExecutableCachingMode::kAllowPersistentCaching)
+          ? object_cache_.get()
+          : nullptr;
+  bool allow_lazy_compilation =
+      AllBitsSet(mode, ExecutableCachingMode::kAllowLazyCompilation);
+  IREE_ASSIGN_OR_RETURN(
+      auto executable,
+      LLVMJITExecutable::Load(spec, !allow_aliasing_data, object_cache,
+                              allow_lazy_compilation));
 
   return executable;
 }
@@ -15,8 +15,12 @@
 #ifndef IREE_HAL_LLVMJIT_EXECUTABLE_CACHE_H_
 #define IREE_HAL_LLVMJIT_EXECUTABLE_CACHE_H_
 
+#include <memory>
+#include <string>
+
 #include "iree/hal/executable.h"
 #include "iree/hal/executable_cache.h"
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
 
 namespace iree {
 namespace hal {
@@ -24,7 +28,10 @@ namespace llvmjit {
 
 class LLVMJITExecutableCache final : public ExecutableCache {
  public:
-  LLVMJITExecutableCache();
+  // |object_cache_dir| is a directory used to persist compiled objects across
+  // runs for executables prepared with
+  // ExecutableCachingMode::kAllowPersistentCaching. Empty disables persistence.
+  explicit LLVMJITExecutableCache(std::string object_cache_dir = "");
   ~LLVMJITExecutableCache() override;
 
   bool CanPrepareFormat(ExecutableFormat format) const override;
@@ -32,6 +39,9 @@ class LLVMJITExecutableCache final : public ExecutableCache {
   StatusOr<ref_ptr<Executable>> PrepareExecutable(
       ExecutableLayout* executable_layout, ExecutableCachingModeBitfield mode,
       const ExecutableSpec& spec) override;
+
+ private:
+  std::unique_ptr<LLVMJITObjectCache> object_cache_;
 };
 
 }  // namespace llvmjit
@@ -0,0 +1,208 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/llvmjit/llvmjit_executable.h"
+
+#include <cstring>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "flatbuffers/flatbuffers.h"
+#include "iree/base/arena.h"
+#include "iree/base/status.h"
+#include "iree/schemas/llvmir_executable_def_generated.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "llvm/Support/TargetSelect.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+namespace {
+
+// Entry points using the dispatch calling convention. The ones calling
+// (directly or through a helper) a symbol that does not exist fail to link if
+// they are ever compiled.
+constexpr char kModuleIR[] = R"(
+declare void @iree_llvmjit_test_undefined_symbol()
+
+define void @store_42(i8** %args, i32* %push_constants, i32* %workgroup_id,
+                      i32* %workgroup_count) {
+  %ptr = load i8*, i8** %args
+  %out = bitcast i8* %ptr to i32*
+  store i32 42, i32* %out
+  ret void
+}
+
+define void @call_undefined(i8** %args, i32* %push_constants,
+                            i32* %workgroup_id, i32* %workgroup_count) {
+  call void @iree_llvmjit_test_undefined_symbol()
+  ret void
+}
+
+define void @store_42_helper(i8** %args) {
+  %ptr = load i8*, i8** %args
+  %out = bitcast i8* %ptr to i32*
+  store i32 42, i32* %out
+  ret void
+}
+
+define void @store_42_via_helper(i8** %args, i32* %push_constants,
+                                 i32* %workgroup_id, i32* %workgroup_count) {
+  call void @store_42_helper(i8** %args)
+  ret void
+}
+
+define void @call_undefined_helper() {
+  call void @iree_llvmjit_test_undefined_symbol()
+  ret void
+}
+
+define void @call_undefined_via_helper(i8** %args, i32* %push_constants,
+                                       i32* %workgroup_id,
+                                       i32* %workgroup_count) {
+  call void @call_undefined_helper()
+  ret void
+}
+)";
+
+class LLVMJITExecutableTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+  }
+
+  void SetUp() override {
+    iree::LLVMIRExecutableDefT executable_def;
+    executable_def.entry_points = {"store_42", "call_undefined",
+                                   "store_42_via_helper",
+                                   "call_undefined_via_helper"};
+    executable_def.llvmir_module.resize(std::strlen(kModuleIR));
+    std::memcpy(executable_def.llvmir_module.data(), kModuleIR,
+                executable_def.llvmir_module.size());
+    ::flatbuffers::FlatBufferBuilder fbb;
+    iree::FinishLLVMIRExecutableDefBuffer(
+        fbb, iree::LLVMIRExecutableDef::Pack(fbb, &executable_def));
+    executable_data_.assign(fbb.GetBufferPointer(),
+                            fbb.GetBufferPointer() + fbb.GetSize());
+  }
+
+  ExecutableSpec spec() const {
+    ExecutableSpec spec;
+    spec.executable_data = absl::MakeConstSpan(executable_data_);
+    return spec;
+  }
+
+  std::vector<uint8_t> executable_data_;
+};
+
+TEST_F(LLVMJITExecutableTest, EagerCompilationFailsOnUnresolvedSymbols) {
+  // Looking up entry points compiles the whole module, including the entry
+  // point calling an undefined function.
+  auto executable_or =
+      LLVMJITExecutable::Load(spec(), /*allow_aliasing_data=*/true,
+                              /*object_cache=*/nullptr,
+                              /*allow_lazy_compilation=*/false);
+  EXPECT_FALSE(executable_or.ok());
+}
+
+TEST_F(LLVMJITExecutableTest, LazyCompilation) {
+  // Only the dispatched entry point gets compiled so the one calling an
+  // undefined function is never linked.
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto executable,
+      LLVMJITExecutable::Load(spec(), /*allow_aliasing_data=*/true,
+                              /*object_cache=*/nullptr,
+                              /*allow_lazy_compilation=*/true));
+
+  int32_t value = 0;
+  void* binding_ptrs[] = {&value};
+  absl::Span<void* const> set_binding_ptrs[] = {
+      absl::MakeConstSpan(binding_ptrs)};
+  HostExecutable::DispatchParams params;
+  params.entry_point = 0;
+  params.workgroup_count = {1, 1, 1};
+  params.set_binding_ptrs = absl::MakeConstSpan(set_binding_ptrs);
+  Arena arena;
+  IREE_ASSERT_OK_AND_ASSIGN(auto dispatch_state,
+                            executable->PrepareDispatch(params, &arena));
+  // Preparing the dispatch compiled the entry point; all tiles reuse it.
+  IREE_ASSERT_OK(executable->DispatchTile(dispatch_state.get(), {0, 0, 0}));
+  EXPECT_EQ(42, value);
+  value = 0;
+  IREE_ASSERT_OK(executable->DispatchTile(dispatch_state.get(), {0, 0, 0}));
+  EXPECT_EQ(42, value);
+}
+
+TEST_F(LLVMJITExecutableTest, LazyCompilationFailure) {
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto executable,
+      LLVMJITExecutable::Load(spec(), /*allow_aliasing_data=*/true,
+                              /*object_cache=*/nullptr,
+                              /*allow_lazy_compilation=*/true));
+
+  // Preparing the entry point calling an undefined function compiles it and
+  // reports the link error instead of leaving it for the first tile.
+  HostExecutable::DispatchParams params;
+  params.entry_point = 1;
+  params.workgroup_count = {1, 1, 1};
+  Arena arena;
+  EXPECT_FALSE(executable->PrepareDispatch(params, &arena).ok());
+
+  // The other entry point is unaffected.
+  int32_t value = 0;
+  void* binding_ptrs[] = {&value};
+  absl::Span<void* const> set_binding_ptrs[] = {
+      absl::MakeConstSpan(binding_ptrs)};
+  params.entry_point = 0;
+  params.set_binding_ptrs = absl::MakeConstSpan(set_binding_ptrs);
+  IREE_ASSERT_OK_AND_ASSIGN(auto dispatch_state,
+                            executable->PrepareDispatch(params, &arena));
+  IREE_ASSERT_OK(executable->DispatchTile(dispatch_state.get(), {0, 0, 0}));
+  EXPECT_EQ(42, value);
+}
+
+TEST_F(LLVMJITExecutableTest, LazyCompilationIncludesCallees) {
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto executable,
+      LLVMJITExecutable::Load(spec(), /*allow_aliasing_data=*/true,
+                              /*object_cache=*/nullptr,
+                              /*allow_lazy_compilation=*/true));
+
+  // Functions called by the entry point are compiled with it, so a callee
+  // that fails to link is reported when preparing the dispatch instead of
+  // when a tile first calls it.
+  HostExecutable::DispatchParams params;
+  params.entry_point = 3;
+  params.workgroup_count = {1, 1, 1};
+  Arena arena;
+  EXPECT_FALSE(executable->PrepareDispatch(params, &arena).ok());
+
+  int32_t value = 0;
+  void* binding_ptrs[] = {&value};
+  absl::Span<void* const> set_binding_ptrs[] = {
+      absl::MakeConstSpan(binding_ptrs)};
+  params.entry_point = 2;
+  params.set_binding_ptrs = absl::MakeConstSpan(set_binding_ptrs);
+  IREE_ASSERT_OK_AND_ASSIGN(auto dispatch_state,
+                            executable->PrepareDispatch(params, &arena));
+  IREE_ASSERT_OK(executable->DispatchTile(dispatch_state.get(), {0, 0, 0}));
+  EXPECT_EQ(42, value);
+}
+
+}  // namespace
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,156 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "iree/base/tracing.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+
+// Bump when the JIT configuration changes in a way that makes previously
+// cached objects incompatible (calling convention, code model, etc).
+static constexpr char kObjectCacheVersion[] = "1";
+
+LLVMJITObjectCache::LLVMJITObjectCache(std::string cache_dir)
+    : cache_dir_(std::move(cache_dir)) {}
+
+LLVMJITObjectCache::~LLVMJITObjectCache() = default;
+
+// static
+std::string LLVMJITObjectCache::ComputeKey(llvm::StringRef module_data) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::ComputeKey");
+
+  // The JIT targets the host CPU, so the object depends on the exact CPU and
+  // feature set in addition to the triple.
+  llvm::SHA1 hasher;
+  hasher.update(kObjectCacheVersion);
+  hasher.update(llvm::sys::getProcessTriple());
+  hasher.update(llvm::sys::getHostCPUName());
+  llvm::StringMap<bool> host_features;
+  if (llvm::sys::getHostCPUFeatures(host_features)) {
+    // StringMap iteration order is unspecified; sort for a stable key.
+    std::vector<std::string> features;
+    for (const auto& feature : host_features) {
+      features.push_back((feature.getValue() ? "+" : "-") +
+                         feature.getKey().str());
+    }
+    std::sort(features.begin(), features.end());
+    for (const auto& feature : features) hasher.update(feature);
+  }
+  hasher.update(module_data);
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+// Returns true if |object| parses as an object file and all of its section
+// contents lie within the file.
+static bool IsValidObject(llvm::MemoryBufferRef object) {
+  auto object_file_or = llvm::object::ObjectFile::createObjectFile(object);
+  if (!object_file_or) {
+    llvm::consumeError(object_file_or.takeError());
+    return false;
+  }
+  for (const auto& section : object_file_or.get()->sections()) {
+    auto contents_or = section.getContents();
+    if (!contents_or) {
+      llvm::consumeError(contents_or.takeError());
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string LLVMJITObjectCache::GetObjectPath(llvm::StringRef key) const {
+  llvm::SmallString<256> path(cache_dir_);
+  llvm::sys::path::append(path, key + ".o");
+  return path.str().str();
+}
+
+std::unique_ptr<llvm::MemoryBuffer> LLVMJITObjectCache::LookupObject(
+    llvm::StringRef key) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::LookupObject");
+  auto buffer_or = llvm::MemoryBuffer::getFile(
+      GetObjectPath(key), /*FileSize=*/-1, /*RequiresNullTerminator=*/false);
+  if (!buffer_or) return nullptr;
+  auto buffer = std::move(buffer_or.get());
+  if (!IsValidObject(buffer->getMemBufferRef())) {
+    RemoveObject(key);
+    return nullptr;
+  }
+  return buffer;
+}
+
+void LLVMJITObjectCache::RemoveObject(llvm::StringRef key) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::RemoveObject");
+  llvm::sys::fs::remove(GetObjectPath(key));
+}
+
+void LLVMJITObjectCache::notifyObjectCompiled(const llvm::Module* module,
+                                              llvm::MemoryBufferRef object) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::notifyObjectCompiled");
+  llvm::StringRef key = module->getModuleIdentifier();
+  if (key.empty()) return;
+
+  // Failures to persist are not fatal: the object has already been compiled
+  // and will be loaded from memory; we'll just try again next run.
+  if (llvm::sys::fs::create_directories(cache_dir_)) return;
+
+  // Write to a unique temporary file and rename it into place so that readers
+  // (possibly in other processes) never observe partial objects.
+  std::string object_path = GetObjectPath(key);
+  llvm::SmallString<256> temp_path;
+  int temp_fd = -1;
+  if (llvm::sys::fs::createUniqueFile(object_path + ".tmp-%%%%%%%%", temp_fd,
+                                      temp_path)) {
+    return;
+  }
+  {
+    llvm::raw_fd_ostream os(temp_fd, /*shouldClose=*/true);
+    os << object.getBuffer();
+    os.close();
+    if (os.has_error()) {
+      os.clear_error();
+      llvm::sys::fs::remove(temp_path);
+      return;
+    }
+  }
+  if (llvm::sys::fs::rename(temp_path, object_path)) {
+    llvm::sys::fs::remove(temp_path);
+  }
+}
+
+std::unique_ptr<llvm::MemoryBuffer> LLVMJITObjectCache::getObject(
+    const llvm::Module* module) {
+  llvm::StringRef key = module->getModuleIdentifier();
+  if (key.empty()) return nullptr;
+  return LookupObject(key);
+}
+
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
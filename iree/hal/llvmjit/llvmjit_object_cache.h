@@ -0,0 +1,73 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
+#define IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+
+// Persistent on-disk cache of JIT compiled object files.
+//
+// Objects are keyed by a content hash of the executable LLVM IR and the host
+// target it was compiled for (see ComputeKey). Modules compiled through a JIT
+// using this cache must have their module identifier set to that key so that
+// the compiled object can be stored under it.
+//
+// Thread-safe; multiple processes may share the same cache directory as
+// objects are written to a temporary file and atomically renamed into place.
+class LLVMJITObjectCache final : public llvm::ObjectCache {
+ public:
+  explicit LLVMJITObjectCache(std::string cache_dir);
+  ~LLVMJITObjectCache() override;
+
+  // Returns a key uniquely identifying the object produced by compiling
+  // |module_data| for the host target.
+  static std::string ComputeKey(llvm::StringRef module_data);
+
+  // Returns the cached object for |key| or nullptr if not present.
+  // Entries that are not valid object files (truncated writes, corruption) are
+  // removed so that the next compilation replaces them.
+  std::unique_ptr<llvm::MemoryBuffer> LookupObject(llvm::StringRef key);
+
+  // Removes the cached object for |key|, if any. Used when an object that
+  // passed validation still fails to load or link.
+  void RemoveObject(llvm::StringRef key);
+
+  // llvm::ObjectCache:
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef object) override;
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module* module) override;
+
+ private:
+  std::string GetObjectPath(llvm::StringRef key) const;
+
+  std::string cache_dir_;
+};
+
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
@@ -0,0 +1,201 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "iree/testing/gtest.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+namespace {
+
+constexpr char kModuleIR[] = R"(
+define i32 @times_three(i32 %value) {
+  %result = mul i32 %value, 3
+  ret i32 %result
+}
+)";
+
+class LLVMJITObjectCacheTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+  }
+
+  void SetUp() override {
+    llvm::SmallString<256> cache_dir;
+    ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("llvmjit_object_cache",
+                                                      cache_dir));
+    cache_dir_ = cache_dir.str().str();
+  }
+
+  void TearDown() override { llvm::sys::fs::remove_directories(cache_dir_); }
+
+  // Returns a new JIT compiling modules through |object_cache|, as done by
+  // LLVMJITExecutable when persistent caching is allowed.
+  static std::unique_ptr<llvm::orc::LLJIT> CreateJIT(
+      LLVMJITObjectCache* object_cache) {
+    llvm::orc::LLJITBuilder ll_jit_builder;
+    ll_jit_builder.setCompileFunctionCreator(
+        [object_cache](llvm::orc::JITTargetMachineBuilder jtmb)
+            -> llvm::Expected<
+                std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+          return std::make_unique<llvm::orc::ConcurrentIRCompiler>(
+              std::move(jtmb), object_cache);
+        });
+    auto ll_jit_or = ll_jit_builder.create();
+    EXPECT_TRUE(!!ll_jit_or) << llvm::toString(ll_jit_or.takeError());
+    return std::move(ll_jit_or.get());
+  }
+
+  // Calls the times_three function of the module loaded into |ll_jit|.
+  static int CallTimesThree(llvm::orc::LLJIT* ll_jit, int value) {
+    auto symbol_or = ll_jit->lookup("times_three");
+    EXPECT_TRUE(!!symbol_or) << llvm::toString(symbol_or.takeError());
+    auto times_three_fn = reinterpret_cast<int (*)(int)>(
+        static_cast<uintptr_t>(symbol_or->getAddress()));
+    return times_three_fn(value);
+  }
+
+  // Returns true if the cache directory contains the object file for |key|.
+  bool HasCachedFile(llvm::StringRef key) const {
+    llvm::SmallString<256> path(cache_dir_);
+    llvm::sys::path::append(path, key + ".o");
+    return llvm::sys::fs::exists(path);
+  }
+
+  // Compiles kModuleIR through |object_cache|, which stores its object.
+  static void CompileModule(LLVMJITObjectCache* object_cache,
+                            llvm::StringRef key) {
+    auto ll_jit = CreateJIT(object_cache);
+    auto context = std::make_unique<llvm::LLVMContext>();
+    llvm::SMDiagnostic diagnostic;
+    auto module = llvm::parseAssemblyString(kModuleIR, diagnostic, *context);
+    ASSERT_NE(nullptr, module) << diagnostic.getMessage().str();
+    module->setModuleIdentifier(key);
+    llvm::Error err = ll_jit->addIRModule(
+        llvm::orc::ThreadSafeModule(std::move(module), std::move(context)));
+    ASSERT_FALSE(!!err) << llvm::toString(std::move(err));
+    EXPECT_EQ(369, CallTimesThree(ll_jit.get(), 123));
+  }
+
+  std::string cache_dir_;
+};
+
+TEST_F(LLVMJITObjectCacheTest, ComputeKey) {
+  std::string key = LLVMJITObjectCache::ComputeKey(kModuleIR);
+  EXPECT_FALSE(key.empty());
+  EXPECT_EQ(key, LLVMJITObjectCache::ComputeKey(kModuleIR));
+  EXPECT_NE(key, LLVMJITObjectCache::ComputeKey("some other module"));
+}
+
+TEST_F(LLVMJITObjectCacheTest, LookupMissingObject) {
+  LLVMJITObjectCache object_cache(cache_dir_);
+  EXPECT_EQ(nullptr, object_cache.LookupObject(
+                         LLVMJITObjectCache::ComputeKey(kModuleIR)));
+}
+
+TEST_F(LLVMJITObjectCacheTest, RemoveInvalidObject) {
+  LLVMJITObjectCache object_cache(cache_dir_);
+  std::string key = LLVMJITObjectCache::ComputeKey(kModuleIR);
+  llvm::LLVMContext context;
+  llvm::Module module(key, context);
+  object_cache.notifyObjectCompiled(
+      &module, llvm::MemoryBufferRef("not really an object", "object"));
+  ASSERT_TRUE(HasCachedFile(key));
+
+  // Entries that are not object files are never returned and get removed.
+  EXPECT_EQ(nullptr, object_cache.LookupObject(key));
+  EXPECT_FALSE(HasCachedFile(key));
+  EXPECT_EQ(nullptr, object_cache.getObject(&module));
+}
+
+TEST_F(LLVMJITObjectCacheTest, IgnoreModulesWithoutKey) {
+  LLVMJITObjectCache object_cache(cache_dir_);
+  llvm::LLVMContext context;
+  llvm::Module module("", context);
+  object_cache.notifyObjectCompiled(
+      &module, llvm::MemoryBufferRef("not really an object", "object"));
+  EXPECT_EQ(nullptr, object_cache.getObject(&module));
+
+  std::error_code error;
+  llvm::sys::fs::directory_iterator it(cache_dir_, error);
+  EXPECT_FALSE(error);
+  EXPECT_EQ(llvm::sys::fs::directory_iterator(), it);
+}
+
+TEST_F(LLVMJITObjectCacheTest, WarmRestartFromDisk) {
+  std::string key = LLVMJITObjectCache::ComputeKey(kModuleIR);
+
+  // Compile the module, which stores the object in the cache.
+  {
+    LLVMJITObjectCache object_cache(cache_dir_);
+    CompileModule(&object_cache, key);
+  }
+
+  // A new cache on the same directory, as after a process restart, finds the
+  // object and the JIT can use it without any IR.
+  LLVMJITObjectCache object_cache(cache_dir_);
+  auto object = object_cache.LookupObject(key);
+  ASSERT_NE(nullptr, object);
+  auto ll_jit = CreateJIT(&object_cache);
+  llvm::Error err = ll_jit->addObjectFile(std::move(object));
+  ASSERT_FALSE(!!err) << llvm::toString(std::move(err));
+  EXPECT_EQ(369, CallTimesThree(ll_jit.get(), 123));
+}
+
+TEST_F(LLVMJITObjectCacheTest, RemoveTruncatedObject) {
+  std::string key = LLVMJITObjectCache::ComputeKey(kModuleIR);
+  LLVMJITObjectCache object_cache(cache_dir_);
+  CompileModule(&object_cache, key);
+  auto object = object_cache.LookupObject(key);
+  ASSERT_NE(nullptr, object);
+
+  // Simulate a write that was cut short.
+  llvm::SmallString<256> path(cache_dir_);
+  llvm::sys::path::append(path, key + ".o");
+  {
+    std::error_code error;
+    llvm::raw_fd_ostream stream(path, error);
+    ASSERT_FALSE(error);
+    stream << object->getBuffer().take_front(object->getBufferSize() / 2);
+  }
+  EXPECT_EQ(nullptr, object_cache.LookupObject(key));
+  EXPECT_FALSE(HasCachedFile(key));
+
+  // Compiling again replaces the entry.
+  CompileModule(&object_cache, key);
+  EXPECT_NE(nullptr, object_cache.LookupObject(key));
+}
+
+}  // namespace
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
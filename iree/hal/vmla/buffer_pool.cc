@@ -0,0 +1,208 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/vmla/buffer_pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+
+namespace {
+
+constexpr size_t kMinBlockSize = 64;
+
+// Marks blocks that are too large to be pooled.
+constexpr uint32_t kUnpooledSizeClass = ~0u;
+
+// Returns the byte size of blocks in the given size class. Class 0 holds
+// kMinBlockSize and each following power of two is split into four classes.
+constexpr size_t SizeClassBlockSize(int size_class) {
+  return size_class == 0
+             ? kMinBlockSize
+             : (kMinBlockSize << ((size_class - 1) / 4)) +
+                   ((size_class - 1) % 4 + 1) *
+                       ((kMinBlockSize << ((size_class - 1) / 4)) / 4);
+}
+
+}  // namespace
+
+// Prefixes every block handed out by the pool. Padded so that the user data
+// keeps the alignment of the underlying allocator.
+struct alignas(16) BufferPool::BlockHeader {
+  // Next block in the free list while cached.
+  BlockHeader* next;
+  uint32_t size_class;
+  // Byte length of the block excluding the header.
+  size_t block_size;
+};
+
+static_assert(BufferPool::kMaxPooledBlockSize ==
+                  SizeClassBlockSize(BufferPool::kSizeClassCount - 1),
+              "kSizeClassCount must cover kMaxPooledBlockSize");
+
+// static
+ref_ptr<BufferPool> BufferPool::Create(iree_allocator_t block_allocator) {
+  return Create(block_allocator, Options{});
+}
+
+// static
+ref_ptr<BufferPool> BufferPool::Create(iree_allocator_t block_allocator,
+                                       Options options) {
+  return assign_ref(new BufferPool(block_allocator, options));
+}
+
+BufferPool::BufferPool(iree_allocator_t block_allocator, Options options)
+    : block_allocator_(block_allocator), options_(options) {
+  free_lists_.fill(nullptr);
+  IREE_TRACE_SET_PLOT_TYPE("VMLA pool bytes reserved",
+                           IREE_TRACING_PLOT_TYPE_MEMORY);
+  IREE_TRACE_SET_PLOT_TYPE("VMLA pool bytes cached",
+                           IREE_TRACING_PLOT_TYPE_MEMORY);
+}
+
+BufferPool::~BufferPool() { Trim(); }
+
+iree_allocator_t BufferPool::allocator() {
+  iree_allocator_t allocator;
+  allocator.self = this;
+  allocator.alloc = AllocateThunk;
+  allocator.free = FreeThunk;
+  return allocator;
+}
+
+// static
+iree_status_t BufferPool::AllocateThunk(void* self,
+                                        iree_allocation_mode_t mode,
+                                        iree_host_size_t byte_length,
+                                        void** out_ptr) {
+  return reinterpret_cast<BufferPool*>(self)->Allocate(mode, byte_length,
+                                                       out_ptr);
+}
+
+// static
+void BufferPool::FreeThunk(void* self, void* ptr) {
+  reinterpret_cast<BufferPool*>(self)->Free(ptr);
+}
+
+iree_status_t BufferPool::Allocate(iree_allocation_mode_t mode,
+                                   size_t byte_length, void** out_ptr) {
+  if (byte_length == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "allocations must be >0 bytes");
+  }
+  if ((mode & IREE_ALLOCATION_MODE_TRY_REUSE_EXISTING) && *out_ptr) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "buffer pool does not support reallocation");
+  }
+
+  uint32_t size_class = kUnpooledSizeClass;
+  size_t block_size = byte_length;
+  if (byte_length <= kMaxPooledBlockSize) {
+    static const auto* kBlockSizes = []() {
+      auto* block_sizes = new std::array<size_t, kSizeClassCount>();
+      for (int i = 0; i < kSizeClassCount; ++i) {
+        (*block_sizes)[i] = SizeClassBlockSize(i);
+      }
+      return block_sizes;
+    }();
+    size_class = std::lower_bound(kBlockSizes->begin(), kBlockSizes->end(),
+                                  byte_length) -
+                 kBlockSizes->begin();
+    block_size = (*kBlockSizes)[size_class];
+  }
+
+  ++stats_.allocation_count;
+  BlockHeader* block = nullptr;
+  if (size_class != kUnpooledSizeClass && free_lists_[size_class]) {
+    block = free_lists_[size_class];
+    free_lists_[size_class] = block->next;
+    ++stats_.reuse_count;
+    stats_.bytes_cached -= block_size;
+  }
+
+  if (block) {
+    if (mode & IREE_ALLOCATION_MODE_ZERO_CONTENTS) {
+      std::memset(block + 1, 0, byte_length);
+    }
+  } else {
+    void* ptr = nullptr;
+    iree_status_t status = block_allocator_.alloc(
+        block_allocator_.self, mode, sizeof(BlockHeader) + block_size, &ptr);
+    if (!iree_status_is_ok(status)) return status;
+    block = reinterpret_cast<BlockHeader*>(ptr);
+    block->size_class = size_class;
+    block->block_size = block_size;
+
+    ++stats_.block_allocation_count;
+    stats_.bytes_reserved += block_size;
+    stats_.peak_bytes_reserved =
+        std::max(stats_.peak_bytes_reserved, stats_.bytes_reserved);
+    PlotStats();
+  }
+  block->next = nullptr;
+
+  // Outstanding blocks keep the pool alive so they can be returned to it.
+  AddReference();
+  *out_ptr = block + 1;
+  return iree_ok_status();
+}
+
+void BufferPool::Free(void* ptr) {
+  auto* block = reinterpret_cast<BlockHeader*>(ptr) - 1;
+  if (block->size_class != kUnpooledSizeClass &&
+      stats_.bytes_cached + block->block_size <= options_.max_cached_bytes) {
+    block->next = free_lists_[block->size_class];
+    free_lists_[block->size_class] = block;
+    stats_.bytes_cached += block->block_size;
+  } else {
+    FreeBlock(block);
+  }
+  PlotStats();
+  ReleaseReference();
+}
+
+void BufferPool::Trim() {
+  IREE_TRACE_SCOPE0("BufferPool::Trim");
+  for (auto& free_list : free_lists_) {
+    while (free_list) {
+      BlockHeader* block = free_list;
+      free_list = block->next;
+      stats_.bytes_cached -= block->block_size;
+      FreeBlock(block);
+    }
+  }
+  PlotStats();
+}
+
+BufferPool::Stats BufferPool::stats() const { return stats_; }
+
+void BufferPool::FreeBlock(BlockHeader* block) {
+  ++stats_.block_free_count;
+  stats_.bytes_reserved -= block->block_size;
+  block_allocator_.free(block_allocator_.self, block);
+}
+
+void BufferPool::PlotStats() const {
+  IREE_TRACE_PLOT_VALUE_I64("VMLA pool bytes reserved", stats_.bytes_reserved);
+  IREE_TRACE_PLOT_VALUE_I64("VMLA pool bytes cached", stats_.bytes_cached);
+}
+
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,125 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_VMLA_BUFFER_POOL_H_
+#define IREE_HAL_VMLA_BUFFER_POOL_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "iree/base/api.h"
+#include "iree/base/ref_ptr.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+
+// A size-class caching allocator for transient vmla.buffer storage.
+// Freed blocks are kept on per-size-class free lists and handed back out to
+// later allocations of a similar size, so repeatedly invoking the same
+// executable reaches a steady state in which no blocks are requested from the
+// underlying allocator.
+//
+// Size classes are spaced at quarter powers of two (64, 80, 96, 112, 128, 160,
+// ...) bounding the internal fragmentation to 25%. Allocations larger than
+// kMaxPooledBlockSize bypass the free lists.
+//
+// Each allocation retains the pool so that blocks may safely outlive the
+// owner of the pool; cached blocks are released when the last reference is
+// dropped.
+//
+// Thread-compatible. The pool is owned by a single VMLAModuleState and, like
+// the rest of the state, must only be used by one thread at a time. This keeps
+// the free lists effectively thread-local without any locking on the
+// allocation path.
+class BufferPool final : public RefObject<BufferPool> {
+ public:
+  // Largest block size that will be cached.
+  static constexpr size_t kMaxPooledBlockSize = 16 * 1024 * 1024;
+
+  // Number of quarter-power-of-two size classes between the minimum block
+  // size of 64B and kMaxPooledBlockSize.
+  static constexpr int kSizeClassCount = 73;
+
+  struct Options {
+    // Maximum total bytes held in free lists. Blocks released while the pool is
+    // at the limit are returned to the underlying allocator.
+    size_t max_cached_bytes = 64 * 1024 * 1024;
+  };
+
+  struct Stats {
+    // Total number of allocations made from the pool.
+    int64_t allocation_count = 0;
+    // Allocations that were satisfied from a free list.
+    int64_t reuse_count = 0;
+    // Blocks requested from and released to the underlying allocator.
+    int64_t block_allocation_count = 0;
+    int64_t block_free_count = 0;
+    // Bytes currently held by the pool, both in use and cached.
+    int64_t bytes_reserved = 0;
+    int64_t peak_bytes_reserved = 0;
+    // Bytes currently held in free lists.
+    int64_t bytes_cached = 0;
+  };
+
+  // Creates a pool allocating its blocks from |block_allocator|.
+  static ref_ptr<BufferPool> Create(iree_allocator_t block_allocator);
+  static ref_ptr<BufferPool> Create(iree_allocator_t block_allocator,
+                                    Options options);
+
+  ~BufferPool();
+
+  // Returns an allocator routing allocations through the pool.
+  // The allocator is valid for as long as the pool is; outstanding
+  // allocations keep the pool alive.
+  iree_allocator_t allocator();
+
+  // Returns all cached blocks to the underlying allocator.
+  void Trim();
+
+  // Returns a snapshot of the pool statistics.
+  Stats stats() const;
+
+ private:
+  struct BlockHeader;
+
+  BufferPool(iree_allocator_t block_allocator, Options options);
+
+  static iree_status_t AllocateThunk(void* self, iree_allocation_mode_t mode,
+                                     iree_host_size_t byte_length,
+                                     void** out_ptr);
+  static void FreeThunk(void* self, void* ptr);
+
+  iree_status_t Allocate(iree_allocation_mode_t mode, size_t byte_length,
+                         void** out_ptr);
+  void Free(void* ptr);
+
+  // Releases |block| to the underlying allocator.
+  void FreeBlock(BlockHeader* block);
+
+  void PlotStats() const;
+
+  iree_allocator_t block_allocator_;
+  Options options_;
+
+  std::array<BlockHeader*, kSizeClassCount> free_lists_;
+  Stats stats_;
+};
+
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_VMLA_BUFFER_POOL_H_
@@ -0,0 +1,91 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/hal/vmla/buffer_pool.h"
+
+namespace {
+
+using iree::hal::vmla::BufferPool;
+
+// Transient buffer sizes allocated by a single invocation of a small MLP, in
+// allocation order.
+static constexpr std::array<size_t, 12> kModelBufferSizes = {
+    4 * 784,  4 * 784 * 128, 4 * 128, 4 * 128, 4 * 128 * 64, 4 * 64,
+    4 * 64,   4 * 64 * 10,   4 * 10,  4 * 10,  4 * 10,       4,
+};
+
+// Transient buffer sizes allocated by a single workgroup tile of an
+// elementwise-heavy dispatch, including the vmla.buffer.view wrappers.
+static constexpr std::array<size_t, 16> kTileBufferSizes = {
+    4 * 16, 96, 4 * 16, 96, 4 * 16, 4 * 64, 96, 4 * 64,
+    4 * 16, 96, 4 * 64, 96, 4 * 16, 4 * 16, 96, 4,
+};
+
+// Runs the allocation pattern of one invocation against |allocator|. Each
+// buffer is written as a kernel would and released two allocations later to
+// model intermediates that are only live across a couple of ops.
+template <size_t N>
+static void RunInvocation(const std::array<size_t, N>& buffer_sizes,
+                          iree_allocator_t allocator) {
+  std::array<void*, N> ptrs;
+  for (size_t i = 0; i < N; ++i) {
+    ptrs[i] = nullptr;
+    IREE_CHECK_OK(iree_allocator_malloc(allocator, buffer_sizes[i], &ptrs[i]));
+    std::memset(ptrs[i], 1, buffer_sizes[i]);
+    benchmark::DoNotOptimize(ptrs[i]);
+    if (i >= 2) iree_allocator_free(allocator, ptrs[i - 2]);
+  }
+  iree_allocator_free(allocator, ptrs[N - 2]);
+  iree_allocator_free(allocator, ptrs[N - 1]);
+}
+
+template <size_t N>
+static void BM_SystemAllocator(benchmark::State& state,
+                               const std::array<size_t, N>& buffer_sizes) {
+  iree_allocator_t allocator = iree_allocator_system();
+  for (auto _ : state) {
+    RunInvocation(buffer_sizes, allocator);
+  }
+  state.SetItemsProcessed(state.iterations() * N);
+}
+
+template <size_t N>
+static void BM_BufferPool(benchmark::State& state,
+                          const std::array<size_t, N>& buffer_sizes) {
+  auto pool = BufferPool::Create(iree_allocator_system());
+  // Warm the pool as the first invocation of a model would.
+  RunInvocation(buffer_sizes, pool->allocator());
+  auto warm_stats = pool->stats();
+  for (auto _ : state) {
+    RunInvocation(buffer_sizes, pool->allocator());
+  }
+  state.SetItemsProcessed(state.iterations() * N);
+  // Should be zero: all steady-state allocations are served from the pool.
+  state.counters["block_allocations"] =
+      pool->stats().block_allocation_count - warm_stats.block_allocation_count;
+}
+
+BENCHMARK_CAPTURE(BM_SystemAllocator, model, kModelBufferSizes);
+BENCHMARK_CAPTURE(BM_BufferPool, model, kModelBufferSizes);
+BENCHMARK_CAPTURE(BM_SystemAllocator, tile, kTileBufferSizes);
+BENCHMARK_CAPTURE(BM_BufferPool, tile, kTileBufferSizes);
+
+}  // namespace
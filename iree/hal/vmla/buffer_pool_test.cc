@@ -0,0 +1,154 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/vmla/buffer_pool.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace {
+
+// Forwards to the system allocator while counting live blocks.
+struct CountingAllocator {
+  int live_count = 0;
+  int total_count = 0;
+
+  iree_allocator_t allocator() {
+    iree_allocator_t allocator;
+    allocator.self = this;
+    allocator.alloc = +[](void* self, iree_allocation_mode_t mode,
+                          iree_host_size_t byte_length, void** out_ptr) {
+      auto* counter = reinterpret_cast<CountingAllocator*>(self);
+      ++counter->live_count;
+      ++counter->total_count;
+      return iree_allocator_system_allocate(nullptr, mode, byte_length,
+                                            out_ptr);
+    };
+    allocator.free = +[](void* self, void* ptr) {
+      --reinterpret_cast<CountingAllocator*>(self)->live_count;
+      iree_allocator_system_free(nullptr, ptr);
+    };
+    return allocator;
+  }
+};
+
+void* Allocate(iree_allocator_t allocator, size_t byte_length) {
+  void* ptr = nullptr;
+  iree_status_t status = iree_allocator_malloc(allocator, byte_length, &ptr);
+  EXPECT_TRUE(iree_status_is_ok(status));
+  iree_status_ignore(status);
+  return ptr;
+}
+
+TEST(BufferPoolTest, ReusesFreedBlocks) {
+  CountingAllocator counter;
+  auto pool = BufferPool::Create(counter.allocator());
+  auto allocator = pool->allocator();
+
+  // Simulates repeated invocations allocating the same set of buffers.
+  const std::vector<size_t> sizes = {16, 4096, 4000, 100, 1 << 20};
+  for (int i = 0; i < 4; ++i) {
+    std::vector<void*> ptrs;
+    for (size_t size : sizes) {
+      auto* ptr = reinterpret_cast<uint8_t*>(Allocate(allocator, size));
+      ASSERT_NE(ptr, nullptr);
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 16, 0);
+      for (size_t j = 0; j < size; ++j) EXPECT_EQ(ptr[j], 0);
+      std::memset(ptr, 0xCD, size);
+      ptrs.push_back(ptr);
+    }
+    for (void* ptr : ptrs) iree_allocator_free(allocator, ptr);
+  }
+
+  int64_t size_count = sizes.size();
+  auto stats = pool->stats();
+  EXPECT_EQ(stats.allocation_count, 4 * size_count);
+  EXPECT_EQ(stats.block_allocation_count, size_count);
+  EXPECT_EQ(stats.reuse_count, 3 * size_count);
+  EXPECT_EQ(stats.block_free_count, 0);
+  EXPECT_EQ(stats.bytes_cached, stats.bytes_reserved);
+  EXPECT_EQ(counter.total_count, size_count);
+
+  pool->Trim();
+  EXPECT_EQ(counter.live_count, 0);
+  EXPECT_EQ(pool->stats().bytes_reserved, 0);
+  EXPECT_EQ(pool->stats().bytes_cached, 0);
+}
+
+TEST(BufferPoolTest, SizeClasses) {
+  CountingAllocator counter;
+  auto pool = BufferPool::Create(counter.allocator());
+  auto allocator = pool->allocator();
+
+  // Sizes within the same quarter-power-of-two class share blocks.
+  iree_allocator_free(allocator, Allocate(allocator, 1025));
+  iree_allocator_free(allocator, Allocate(allocator, 1280));
+  EXPECT_EQ(pool->stats().block_allocation_count, 1);
+  EXPECT_EQ(pool->stats().bytes_reserved, 1280);
+
+  // The next class up needs a new block.
+  iree_allocator_free(allocator, Allocate(allocator, 1281));
+  EXPECT_EQ(pool->stats().block_allocation_count, 2);
+  EXPECT_EQ(pool->stats().bytes_reserved, 1280 + 1536);
+}
+
+TEST(BufferPoolTest, LargeBlocksBypassPool) {
+  CountingAllocator counter;
+  auto pool = BufferPool::Create(counter.allocator());
+  auto allocator = pool->allocator();
+
+  void* ptr = Allocate(allocator, BufferPool::kMaxPooledBlockSize + 1);
+  EXPECT_EQ(counter.live_count, 1);
+  iree_allocator_free(allocator, ptr);
+  EXPECT_EQ(counter.live_count, 0);
+  EXPECT_EQ(pool->stats().bytes_cached, 0);
+}
+
+TEST(BufferPoolTest, TrimsToMaxCachedBytes) {
+  CountingAllocator counter;
+  BufferPool::Options options;
+  options.max_cached_bytes = 1024;
+  auto pool = BufferPool::Create(counter.allocator(), options);
+  auto allocator = pool->allocator();
+
+  void* ptr0 = Allocate(allocator, 1024);
+  void* ptr1 = Allocate(allocator, 1024);
+  iree_allocator_free(allocator, ptr0);
+  iree_allocator_free(allocator, ptr1);
+  EXPECT_EQ(counter.live_count, 1);
+  EXPECT_EQ(pool->stats().bytes_cached, 1024);
+  EXPECT_EQ(pool->stats().block_free_count, 1);
+}
+
+TEST(BufferPoolTest, BlocksOutliveOwner) {
+  CountingAllocator counter;
+  auto pool = BufferPool::Create(counter.allocator());
+  auto allocator = pool->allocator();
+  void* ptr = Allocate(allocator, 128);
+  pool.reset();
+  EXPECT_EQ(counter.live_count, 1);
+  iree_allocator_free(allocator, ptr);
+  EXPECT_EQ(counter.live_count, 0);
+}
+
+}  // namespace
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
@@ -26,6 +26,10 @@
 // handles to be shared while kernels that require transient storage to be safe
 // to use from multiple fibers concurrently.
 //
+// Kernels that can split their work accept an optional ThreadPool and use
+// ParallelFor to distribute it once it is large enough to be worth waking
+// workers for. A null pool runs everything on the calling thread.
+//
 // All kernels are templated to enable specialization of particular types or
 // type combinations. By default the op_kernels_generic.h will provide C++
 // semantics as reference and platform-specific versions can be implemented
@@ -34,10 +38,18 @@
 #ifndef IREE_HAL_VMLA_OP_KERNELS_H_
 #define IREE_HAL_VMLA_OP_KERNELS_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
 
+#include "absl/functional/function_ref.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
+#include "iree/base/ref_ptr.h"
 #include "iree/base/status.h"
+#include "iree/base/thread_pool.h"
 #include "iree/base/tracing.h"
 
 namespace iree {
@@ -55,6 +67,124 @@ inline size_t GetElementCount(ShapeSpan shape) {
   return count;
 }
 
+// Approximate number of element operations below which splitting a kernel
+// across threads costs more than it saves.
+constexpr size_t kMinParallelWork = 32 * 1024;
+
+// Runs |fn| over disjoint ranges covering [0, |count|), using |thread_pool|
+// when provided, with each range holding at least |grain| items. Returns the
+// first failure of any range.
+inline Status ParallelFor(ThreadPool* thread_pool, size_t count, size_t grain,
+                          absl::FunctionRef<Status(size_t, size_t)> fn) {
+  if (!thread_pool || count <= grain) {
+    return count > 0 ? fn(0, count) : OkStatus();
+  }
+  absl::Mutex status_mutex;
+  Status status;
+  thread_pool->ParallelFor(count, grain, [&](size_t begin, size_t end) {
+    auto range_status = fn(begin, end);
+    if (!range_status.ok()) {
+      absl::MutexLock lock(&status_mutex);
+      if (status.ok()) status = std::move(range_status);
+    }
+  });
+  return status;
+}
+
+// Returns a ParallelFor grain covering at least kMinParallelWork element
+// operations when each item costs |work_per_item|.
+inline size_t GetParallelGrain(size_t work_per_item) {
+  return work_per_item >= kMinParallelWork
+             ? 1
+             : kMinParallelWork / (work_per_item ? work_per_item : 1);
+}
+
+// 16-bit floating point storage types. Widening to float is exact and
+// implicit while narrowing rounds to nearest even and must be explicit. Kernels
+// do not compute in these types: arithmetic and accumulation are performed on
+// the values widened to float (see Widened).
+
+// IEEE 754 binary16.
+struct Half {
+  Half() = default;
+  explicit Half(float value) : bits(FromFloat(value)) {}
+  operator float() const { return ToFloat(bits); }
+
+  static uint16_t FromFloat(float value) {
+    uint32_t f;
+    std::memcpy(&f, &value, sizeof(f));
+    const uint16_t sign = (f >> 16) & 0x8000u;
+    f &= 0x7FFFFFFFu;
+    if (f >= 0x47800000u) {
+      // Inf, NaN (quieted) or beyond the rounding range of the largest half.
+      return sign | (f > 0x7F800000u ? 0x7E00u : 0x7C00u);
+    } else if (f < 0x38800000u) {
+      // Subnormal or zero: adding 0.5 aligns the half subnormal mantissa with
+      // the low bits of the float mantissa and rounds to nearest even.
+      float magnitude;
+      std::memcpy(&magnitude, &f, sizeof(f));
+      magnitude += 0.5f;
+      std::memcpy(&f, &magnitude, sizeof(f));
+      return sign | static_cast<uint16_t>(f - 0x3F000000u);
+    }
+    // Rebias the exponent and round to nearest even; rounding may carry into
+    // the exponent up to infinity.
+    const uint32_t mantissa_odd = (f >> 13) & 1;
+    f += 0xC8000FFFu + mantissa_odd;
+    return sign | static_cast<uint16_t>(f >> 13);
+  }
+
+  static float ToFloat(uint16_t bits) {
+    uint32_t f = static_cast<uint32_t>(bits & 0x7FFFu) << 13;
+    const uint32_t exponent = f & 0x0F800000u;
+    f += 0x38000000u;
+    if (exponent == 0x0F800000u) {
+      // Inf or NaN.
+      f += 0x38000000u;
+    } else if (exponent == 0) {
+      // Subnormal or zero: renormalize through float arithmetic.
+      f += 0x00800000u;
+      float value;
+      std::memcpy(&value, &f, sizeof(f));
+      value -= 6.103515625e-05f;  // 2^-14
+      std::memcpy(&f, &value, sizeof(f));
+    }
+    f |= static_cast<uint32_t>(bits & 0x8000u) << 16;
+    float result;
+    std::memcpy(&result, &f, sizeof(f));
+    return result;
+  }
+
+  uint16_t bits;
+};
+
+// bfloat16: the upper half of an IEEE 754 binary32.
+struct BFloat16 {
+  BFloat16() = default;
+  explicit BFloat16(float value) : bits(FromFloat(value)) {}
+  operator float() const { return ToFloat(bits); }
+
+  static uint16_t FromFloat(float value) {
+    uint32_t f;
+    std::memcpy(&f, &value, sizeof(f));
+    if ((f & 0x7FFFFFFFu) > 0x7F800000u) {
+      // Quiet NaNs so that truncation cannot produce an infinity.
+      return static_cast<uint16_t>((f | 0x00400000u) >> 16);
+    }
+    f += 0x7FFFu + ((f >> 16) & 1);
+    return static_cast<uint16_t>(f >> 16);
+  }
+
+  static float ToFloat(uint16_t bits) {
+    const uint32_t f = static_cast<uint32_t>(bits) << 16;
+    float result;
+    std::memcpy(&result, &f, sizeof(f));
+    return result;
+  }
+
+  uint16_t bits;
+};
+
 struct CompareEQ {
   template <typename T>
   static Status Execute(absl::Span<const T> lhs_buffer,
@@ -92,16 +222,6 @@ struct CompareGE {
                         absl::Span<uint8_t> dst_buffer);
 };
 
-struct Conv2D {
-  template <typename T>
-  static Status Execute(absl::Span<const T> input_buffer, ShapeSpan input_shape,
-                        absl::Span<const T> filter_buffer,
-                        ShapeSpan filter_shape, absl::Span<T> dst_buffer,
-                        ShapeSpan dst_shape, ShapeSpan strides, ShapeSpan pad_h,
-                        ShapeSpan pad_w, ShapeSpan dilation,
-                        const int32_t groups);
-};
-
 struct Copy {
   template <int element_size>
   static Status Execute(absl::Span<const uint8_t> src_buffer,
@@ -130,7 +250,8 @@ struct Transpose {
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<T> dst_buffer, ShapeSpan src_shape,
-                        absl::Span<const int32_t> perm);
+                        absl::Span<const int32_t> perm,
+                        ThreadPool* thread_pool = nullptr);
 };
 
 struct Pad {
@@ -150,7 +271,22 @@ struct Gather {
                         absl::Span<const int32_t> indices_buffer,
                         absl::Span<T> dst_buffer, ShapeSpan src_shape,
                         ShapeSpan indices_shape, ShapeSpan dst_shape,
-                        const int32_t dim, const int32_t batch_dims);
+                        const int32_t dim, const int32_t batch_dims,
+                        ThreadPool* thread_pool = nullptr);
+};
+
+// Gathers elements of |src_buffer| along |dimension| at the positions given by
+// |indices_buffer|, which has the same shape as the destination and matches
+// |src_shape| in all other dimensions:
+//   dst[o, j, i] = src[o, indices[o, j, i], i]
+// Used to apply the permutations produced by Sort to the sorted operands.
+struct TakeAlongAxis {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<const int32_t> indices_buffer,
+                        absl::Span<T> dst_buffer, ShapeSpan src_shape,
+                        ShapeSpan indices_shape, int32_t dimension,
+                        ThreadPool* thread_pool = nullptr);
 };
 
 struct Scatter {
@@ -364,16 +500,151 @@ struct Ceil {
                         absl::Span<T> dst_buffer);
 };
 
+// Evaluates a fused chain of elementwise ops in a single pass over the buffers.
+// |program| is a sequence of instructions of kInstructionSize words each:
+//   [opcode, result register, lhs register, rhs register]
+// Registers [0, src_buffers.size()) alias the source buffers and all higher
+// registers are temporaries holding a single chunk of kChunkSize elements.
+// Unary ops ignore their rhs register. The result of the last instruction is
+// written to |dst_buffer|.
+//
+// Each instruction is evaluated with the same kernel as the equivalent
+// standalone op so fused and unfused results are bitwise identical.
+struct Elementwise {
+  // NOTE: these values are encoded into compiled modules and must be kept in
+  // sync with iree/compiler/Dialect/VMLA/Transforms/FuseElementwiseOps.cpp.
+  enum Opcode : int32_t {
+    kAdd = 0,
+    kSub = 1,
+    kMul = 2,
+    kDiv = 3,
+    kMin = 4,
+    kMax = 5,
+    kPow = 6,
+    kAtan2 = 7,
+    kAbs = 16,
+    kNeg = 17,
+    kExp = 18,
+    kLog = 19,
+    kRsqrt = 20,
+    kSqrt = 21,
+    kCos = 22,
+    kSin = 23,
+    kTanh = 24,
+    kFloor = 25,
+    kCeil = 26,
+  };
+
+  enum : int {
+    kInstructionSize = 4,
+    // Sized so that a handful of temporaries fit in L1 alongside the sources.
+    kChunkSize = 512,
+  };
+
+  template <typename T>
+  static Status Execute(absl::Span<const int32_t> program,
+                        absl::Span<const absl::Span<const T>> src_buffers,
+                        absl::Span<T> dst_buffer);
+};
+
 struct Convert {
   template <typename SRC, typename DST>
   static Status Execute(absl::Span<const SRC> src_buffer,
                         absl::Span<DST> dst_buffer);
 };
 
+// Evaluates the float implementation of the elementwise KERNEL on Half or
+// BFloat16 buffers. Sources are widened a chunk of kChunkSize elements at a
+// time and the results narrowed back, so storage stays 16-bit.
+template <typename KERNEL>
+struct Widened {
+  enum : int {
+    kChunkSize = 512,
+  };
+
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<T> dst_buffer);
+
+  template <typename T>
+  static Status Execute(absl::Span<const T> lhs_buffer,
+                        absl::Span<const T> rhs_buffer,
+                        absl::Span<T> dst_buffer);
+
+  template <typename T>
+  static Status Execute(absl::Span<const T> a_buffer,
+                        absl::Span<const T> b_buffer,
+                        absl::Span<const T> c_buffer,
+                        absl::Span<T> dst_buffer);
+};
+
+// A real multiplier in the fixed-point form used for requantization:
+//   multiplier * 2^(exponent - 31)
+// with |multiplier| in [2^30, 2^31) (or 0). This matches the encoding of
+// ruy::MulParams::multiplier_fixedpoint/multiplier_exponent and TFLite.
+struct QuantizedMultiplier {
+  int32_t multiplier = 0;
+  int32_t exponent = 0;
+};
+
+// Quantized values represent real = scale * (value - zero_point). Zero points
+// are applied by the kernels and the scales are folded into fixed-point
+// multipliers by the compiler. Results saturate to the range of T.
+
+// Converts real values to quantized with |multiplier| = 1 / scale, rounding
+// half away from zero.
+struct Quantize {
+  template <typename T>
+  static Status Execute(absl::Span<const float> src_buffer,
+                        absl::Span<T> dst_buffer, int32_t zero_point,
+                        QuantizedMultiplier multiplier);
+};
+
+// Converts quantized values to real with |multiplier| = scale.
+struct Dequantize {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<float> dst_buffer, int32_t zero_point,
+                        QuantizedMultiplier multiplier);
+};
+
+// Adds two quantized tensors with independent quantization parameters.
+// Each input is offset, shifted left by kLeftShift for headroom and rescaled
+// by its multiplier to a common scale, and the sum is rescaled by
+// |dst_multiplier| to the output scale. With s = 2 * max(lhs_scale, rhs_scale)
+// the multipliers are lhs_scale / s, rhs_scale / s and
+// s / (2^kLeftShift * dst_scale).
+struct QuantizedAdd {
+  // NOTE: the compiler derives the multipliers using the same shift and the
+  // two must be kept in sync.
+  static constexpr int kLeftShift = 20;
+
+  template <typename T>
+  static Status Execute(absl::Span<const T> lhs_buffer, int32_t lhs_zero_point,
+                        QuantizedMultiplier lhs_multiplier,
+                        absl::Span<const T> rhs_buffer, int32_t rhs_zero_point,
+                        QuantizedMultiplier rhs_multiplier,
+                        absl::Span<T> dst_buffer, int32_t dst_zero_point,
+                        QuantizedMultiplier dst_multiplier);
+};
+
+// Multiplies two quantized tensors. |dst_multiplier| is
+// lhs_scale * rhs_scale / dst_scale.
+struct QuantizedMul {
+  template <typename T>
+  static Status Execute(absl::Span<const T> lhs_buffer, int32_t lhs_zero_point,
+                        absl::Span<const T> rhs_buffer, int32_t rhs_zero_point,
+                        absl::Span<T> dst_buffer, int32_t dst_zero_point,
+                        QuantizedMultiplier dst_multiplier);
+};
+
 struct MatMul {
   struct RuntimeState;
 
-  static std::unique_ptr<RuntimeState> CreateRuntimeState();
+  // Creates the GEMM backend state. When |thread_pool| is provided GEMMs use
+  // up to its concurrency in threads.
+  static std::unique_ptr<RuntimeState> CreateRuntimeState(
+      ThreadPool* thread_pool = nullptr);
 
   template <typename T, typename ACC>
   struct Buffers {
@@ -399,9 +670,111 @@ struct MatMul {
                         const Buffers<T, ACC>& buffers);
 };
 
+// 2D convolution of a single HWC input example with an HWIO filter producing an
+// HWC output.
+struct Conv2D {
+  enum class Algorithm {
+    // Direct convolution loop. Supports all attributes.
+    kDirect,
+    // 1x1 stride-1 unpadded convolution performed as a single GEMM.
+    kGemm1x1,
+    // Input patches are gathered (im2col) and multiplied with the filter.
+    kIm2Col,
+    // Winograd F(2x2, 3x3) for 3x3 stride-1 convolutions.
+    kWinograd,
+  };
+
+  // Returns the algorithm best suited to the given convolution shape.
+  static Algorithm SelectAlgorithm(ShapeSpan input_shape,
+                                   ShapeSpan filter_shape, ShapeSpan strides,
+                                   ShapeSpan pad_h, ShapeSpan pad_w,
+                                   ShapeSpan dilation, const int32_t groups);
+
+  // Reference direct convolution.
+  template <typename T>
+  static Status Execute(absl::Span<const T> input_buffer, ShapeSpan input_shape,
+                        absl::Span<const T> filter_buffer,
+                        ShapeSpan filter_shape, absl::Span<T> dst_buffer,
+                        ShapeSpan dst_shape, ShapeSpan strides, ShapeSpan pad_h,
+                        ShapeSpan pad_w, ShapeSpan dilation,
+                        const int32_t groups,
+                        ThreadPool* thread_pool = nullptr);
+
+  // Returns |filter_buffer| in the layout used by |algorithm| or an empty
+  // vector if the algorithm uses the filter as-is. Only kWinograd transforms
+  // the filter. The result only depends on the filter so callers may compute
+  // it once and reuse it across batch elements and invocations.
+  template <typename T>
+  static std::vector<T> TransformFilter(Algorithm algorithm,
+                                        absl::Span<const T> filter_buffer,
+                                        ShapeSpan filter_shape);
+
+  // Performs the convolution using |algorithm|, which must support the given
+  // attributes (as returned by SelectAlgorithm). GEMMs run on the MatMul
+  // runtime state and the direct loop is split across its thread pool.
+  // |transformed_filter| is the result of TransformFilter; if empty the filter
+  // is transformed on each call.
+  template <typename T>
+  static Status Execute(MatMul::RuntimeState* runtime_state,
+                        Algorithm algorithm, absl::Span<const T> input_buffer,
+                        ShapeSpan input_shape,
+                        absl::Span<const T> filter_buffer,
+                        ShapeSpan filter_shape, absl::Span<T> dst_buffer,
+                        ShapeSpan dst_shape, ShapeSpan strides, ShapeSpan pad_h,
+                        ShapeSpan pad_w, ShapeSpan dilation,
+                        const int32_t groups,
+                        absl::Span<const T> transformed_filter = {});
+};
+
+// Quantized 2D convolution of a single HWC input example with an HWIO filter
+// producing an HWC output. The filter is symmetrically quantized (zero point
+// 0) as in the TFLite int8 specification, while the input and output have
+// arbitrary zero points. Products are accumulated in int32 with the bias and
+// then requantized with either one multiplier or one per output channel, where
+// each is input_scale * filter_scale[c] / dst_scale.
+struct QuantizedConv2D {
+  struct Params {
+    int32_t input_zero_point = 0;
+    int32_t dst_zero_point = 0;
+    // Accumulator bias per output channel, with scale input_scale *
+    // filter_scale[c]. May be empty.
+    absl::Span<const int32_t> bias;
+    // Single or per-channel requantization multipliers.
+    absl::Span<const int32_t> multiplier_mantissa;
+    absl::Span<const int32_t> multiplier_exponent;
+  };
+
+  // Reference direct convolution. Supports grouped convolutions.
+  template <typename T>
+  static Status Execute(absl::Span<const T> input_buffer, ShapeSpan input_shape,
+                        absl::Span<const T> filter_buffer,
+                        ShapeSpan filter_shape, absl::Span<T> dst_buffer,
+                        ShapeSpan dst_shape, const Params& params,
+                        ShapeSpan strides, ShapeSpan pad_h, ShapeSpan pad_w,
+                        ShapeSpan dilation, const int32_t groups,
+                        ThreadPool* thread_pool = nullptr);
+
+  // Performs ungrouped convolutions as im2col GEMMs on the MatMul runtime
+  // state, requantizing in the GEMM epilogue. Grouped convolutions use the
+  // direct loop.
+  template <typename T>
+  static Status Execute(MatMul::RuntimeState* runtime_state,
+                        absl::Span<const T> input_buffer, ShapeSpan input_shape,
+                        absl::Span<const T> filter_buffer,
+                        ShapeSpan filter_shape, absl::Span<T> dst_buffer,
+                        ShapeSpan dst_shape, const Params& params,
+                        ShapeSpan strides, ShapeSpan pad_h, ShapeSpan pad_w,
+                        ShapeSpan dilation, const int32_t groups);
+};
+
 struct RuntimeState {
-  std::unique_ptr<MatMul::RuntimeState> mat_mul_state =
-      MatMul::CreateRuntimeState();
+  explicit RuntimeState(ref_ptr<ThreadPool> thread_pool = {})
+      : thread_pool(std::move(thread_pool)),
+        mat_mul_state(MatMul::CreateRuntimeState(this->thread_pool.get())) {}
+
+  // Pool used to parallelize large kernels, if any.
+  ref_ptr<ThreadPool> thread_pool;
+  std::unique_ptr<MatMul::RuntimeState> mat_mul_state;
 };
 
 struct ReduceSum {
@@ -409,7 +782,8 @@ struct ReduceSum {
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<const T> init_buffer,
                         absl::Span<T> dst_buffer, int32_t dimension,
-                        ShapeSpan src_shape, ShapeSpan dst_shape);
+                        ShapeSpan src_shape, ShapeSpan dst_shape,
+                        ThreadPool* thread_pool = nullptr);
 };
 
 struct ReduceMin {
@@ -417,7 +791,8 @@ struct ReduceMin {
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<const T> init_buffer,
                         absl::Span<T> dst_buffer, int32_t dimension,
-                        ShapeSpan src_shape, ShapeSpan dst_shape);
+                        ShapeSpan src_shape, ShapeSpan dst_shape,
+                        ThreadPool* thread_pool = nullptr);
 };
 
 struct ReduceMax {
@@ -425,7 +800,8 @@ struct ReduceMax {
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<const T> init_buffer,
                         absl::Span<T> dst_buffer, int32_t dimension,
-                        ShapeSpan src_shape, ShapeSpan dst_shape);
+                        ShapeSpan src_shape, ShapeSpan dst_shape,
+                        ThreadPool* thread_pool = nullptr);
 };
 
 struct PoolingSum {
@@ -455,6 +831,47 @@ struct PoolingMax {
                         ShapeSpan strides, ShapeSpan pad_low);
 };
 
+// Averages each window over the elements that lie within |src_buffer|,
+// excluding any padding. Integer averages are rounded half away from zero so
+// quantized inputs and outputs may share their quantization parameters.
+struct PoolingAvg {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<T> dst_buffer, ShapeSpan src_shape,
+                        ShapeSpan dst_shape, ShapeSpan window_dimensions,
+                        ShapeSpan strides, ShapeSpan pad_low);
+};
+
+// Computes the permutation that stably sorts |src_buffer| along |dimension|
+// into ascending (or |descending|) order and writes it to |dst_buffer| as
+// indices along that dimension. NaNs are ordered after all other values.
+//
+// When |refine| is set |dst_buffer| must already hold such a permutation, for
+// example from sorting by another key, and it is reordered by |src_buffer|
+// keeping the existing order of equal elements. Sorting by each key from the
+// least to the most significant yields a multi-key sort.
+struct Sort {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<int32_t> dst_buffer, ShapeSpan src_shape,
+                        int32_t dimension, bool descending, bool refine,
+                        ThreadPool* thread_pool = nullptr);
+};
+
+// Selects the first k elements of |src_buffer| along |dimension| in the same
+// order as Sort, where k is the extent of |dst_shape| along |dimension|, and
+// writes their values and indices. Equivalent to a stable sort followed by a
+// slice but only keeps the k selected elements ordered.
+struct TopK {
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<T> dst_values_buffer,
+                        absl::Span<int32_t> dst_indices_buffer,
+                        ShapeSpan src_shape, ShapeSpan dst_shape,
+                        int32_t dimension, bool descending,
+                        ThreadPool* thread_pool = nullptr);
+};
+
 }  // namespace kernels
 }  // namespace vmla
 }  // namespace hal
@@ -462,5 +879,6 @@ struct PoolingMax {
 
 #include "iree/hal/vmla/op_kernels_generic.h"  // IWYU pragma: export
 #include "iree/hal/vmla/op_kernels_ruy.h"  // IWYU pragma: export
+#include "iree/hal/vmla/op_kernels_simd.h"  // IWYU pragma: export
 
 #endif  // IREE_HAL_VMLA_OP_KERNELS_H_
@@ -0,0 +1,258 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "benchmark/benchmark.h"
+#include "iree/base/logging.h"
+#include "iree/hal/vmla/op_kernels.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace {
+
+using Shape = absl::InlinedVector<int32_t, 4>;
+
+template <typename T>
+void RunTranspose(benchmark::State& state, Shape src_shape, Shape perm) {
+  size_t element_count = 1;
+  for (int32_t dim : src_shape) element_count *= dim;
+  std::vector<T> src_buffer(element_count, 1);
+  std::vector<T> dst_buffer(element_count);
+  for (auto _ : state) {
+    IREE_CHECK_OK(Transpose::Execute<T>(
+        src_buffer, absl::MakeSpan(dst_buffer), src_shape, perm));
+    benchmark::DoNotOptimize(dst_buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * element_count * sizeof(T));
+}
+
+void BM_TransposeF32(benchmark::State& state, Shape src_shape, Shape perm) {
+  RunTranspose<float>(state, src_shape, perm);
+}
+
+void BM_TransposeI16(benchmark::State& state, Shape src_shape, Shape perm) {
+  RunTranspose<uint16_t>(state, src_shape, perm);
+}
+
+// Square matrix transpose.
+BENCHMARK_CAPTURE(BM_TransposeF32, 2d, Shape{1024, 1024}, Shape{1, 0});
+BENCHMARK_CAPTURE(BM_TransposeI16, 2d, Shape{1024, 1024}, Shape{1, 0});
+
+// Layout conversions between NHWC and NCHW.
+BENCHMARK_CAPTURE(BM_TransposeF32, nhwc_to_nchw, Shape{1, 56, 56, 64},
+                  Shape{0, 3, 1, 2});
+BENCHMARK_CAPTURE(BM_TransposeF32, nchw_to_nhwc, Shape{1, 64, 56, 56},
+                  Shape{0, 2, 3, 1});
+BENCHMARK_CAPTURE(BM_TransposeI16, nhwc_to_nchw, Shape{1, 56, 56, 64},
+                  Shape{0, 3, 1, 2});
+
+// Splitting attention heads, which only moves whole rows.
+BENCHMARK_CAPTURE(BM_TransposeF32, split_heads, Shape{1, 128, 12, 64},
+                  Shape{0, 2, 1, 3});
+
+// Full reversal of a 3D tensor.
+BENCHMARK_CAPTURE(BM_TransposeF32, reverse_3d, Shape{64, 64, 64},
+                  Shape{2, 1, 0});
+
+template <typename ReduceOp>
+void RunReduceF32(benchmark::State& state, Shape src_shape,
+                  int32_t dimension) {
+  Shape dst_shape = src_shape;
+  dst_shape.erase(dst_shape.begin() + dimension);
+  size_t element_count = 1;
+  for (int32_t dim : src_shape) element_count *= dim;
+  std::vector<float> src_buffer(element_count, 1.0f);
+  std::vector<float> init_buffer(1, 0.0f);
+  std::vector<float> dst_buffer(element_count / src_shape[dimension]);
+  for (auto _ : state) {
+    IREE_CHECK_OK(ReduceOp::template Execute<float>(
+        src_buffer, init_buffer, absl::MakeSpan(dst_buffer), dimension,
+        src_shape, dst_shape));
+    benchmark::DoNotOptimize(dst_buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * element_count * sizeof(float));
+}
+
+void BM_ReduceSumF32(benchmark::State& state, Shape src_shape,
+                     int32_t dimension) {
+  RunReduceF32<ReduceSum>(state, src_shape, dimension);
+}
+
+void BM_ReduceMaxF32(benchmark::State& state, Shape src_shape,
+                     int32_t dimension) {
+  RunReduceF32<ReduceMax>(state, src_shape, dimension);
+}
+
+// Softmax-style reductions over the innermost dimension.
+BENCHMARK_CAPTURE(BM_ReduceSumF32, inner, Shape{128, 4096}, 1);
+BENCHMARK_CAPTURE(BM_ReduceMaxF32, inner, Shape{128, 4096}, 1);
+
+// Batch-norm-style reductions over all but the channel dimension.
+BENCHMARK_CAPTURE(BM_ReduceSumF32, outer, Shape{3136, 64}, 0);
+BENCHMARK_CAPTURE(BM_ReduceMaxF32, outer, Shape{3136, 64}, 0);
+
+// Reducing a middle dimension with a short inner run.
+BENCHMARK_CAPTURE(BM_ReduceSumF32, middle, Shape{64, 256, 3}, 1);
+
+// Pseudo-random scores for the top-k benchmarks, shaped [batch, count].
+std::vector<float> MakeScores(int32_t batch, int32_t count) {
+  std::vector<float> scores(batch * count);
+  uint32_t state = 1;
+  for (float& score : scores) {
+    state = state * 1664525u + 1013904223u;
+    score = static_cast<float>(state >> 8) / (1 << 24);
+  }
+  return scores;
+}
+
+// Selects the top k of each row directly.
+void BM_TopKF32(benchmark::State& state, int32_t batch, int32_t count,
+                int32_t k) {
+  auto src_buffer = MakeScores(batch, count);
+  std::vector<float> values(batch * k);
+  std::vector<int32_t> indices(batch * k);
+  for (auto _ : state) {
+    IREE_CHECK_OK(TopK::Execute<float>(
+        src_buffer, absl::MakeSpan(values), absl::MakeSpan(indices),
+        Shape{batch, count}, Shape{batch, k}, 1, /*descending=*/true));
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * src_buffer.size());
+}
+
+// Fully sorts each row and then slices out the top k, as mhlo.sort does.
+void BM_SortThenSliceF32(benchmark::State& state, int32_t batch,
+                         int32_t count, int32_t k) {
+  auto src_buffer = MakeScores(batch, count);
+  std::vector<int32_t> order(src_buffer.size());
+  std::vector<float> values(batch * k);
+  std::vector<int32_t> indices(batch * k);
+  for (auto _ : state) {
+    IREE_CHECK_OK(Sort::Execute<float>(src_buffer, absl::MakeSpan(order),
+                                       Shape{batch, count}, 1,
+                                       /*descending=*/true, /*refine=*/false));
+    for (int32_t b = 0; b < batch; ++b) {
+      std::copy_n(&order[b * count], k, &indices[b * k]);
+    }
+    IREE_CHECK_OK(TakeAlongAxis::Execute<float>(
+        src_buffer, indices, absl::MakeSpan(values), Shape{batch, count},
+        Shape{batch, k}, 1));
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * src_buffer.size());
+}
+
+// Classification logits.
+BENCHMARK_CAPTURE(BM_TopKF32, logits_k5, 16, 1000, 5);
+BENCHMARK_CAPTURE(BM_SortThenSliceF32, logits_k5, 16, 1000, 5);
+// Detection candidates ahead of NMS.
+BENCHMARK_CAPTURE(BM_TopKF32, boxes_k100, 4, 20000, 100);
+BENCHMARK_CAPTURE(BM_SortThenSliceF32, boxes_k100, 4, 20000, 100);
+// Beam search over a vocabulary.
+BENCHMARK_CAPTURE(BM_TopKF32, beams_k8, 8, 32000, 8);
+BENCHMARK_CAPTURE(BM_SortThenSliceF32, beams_k8, 8, 32000, 8);
+
+// 3x3 stride-1 same-padded convolution over a 28x28x64 input, as used in
+// image classifiers. Both variants use the im2col GEMM.
+void BM_Conv2DF32(benchmark::State& state) {
+  const Shape input_shape = {28, 28, 64};
+  const Shape filter_shape = {3, 3, 64, 64};
+  const Shape dst_shape = {28, 28, 64};
+  const Shape strides = {1, 1};
+  const Shape padding = {1, 1};
+  const Shape dilation = {1, 1};
+  std::vector<float> input_buffer(28 * 28 * 64, 0.5f);
+  std::vector<float> filter_buffer(3 * 3 * 64 * 64, 0.25f);
+  std::vector<float> dst_buffer(28 * 28 * 64);
+  RuntimeState runtime_state;
+  for (auto _ : state) {
+    IREE_CHECK_OK(Conv2D::Execute<float>(
+        runtime_state.mat_mul_state.get(), Conv2D::Algorithm::kIm2Col,
+        input_buffer, input_shape, filter_buffer, filter_shape,
+        absl::MakeSpan(dst_buffer), dst_shape, strides, padding, padding,
+        dilation, 1));
+    benchmark::DoNotOptimize(dst_buffer.data());
+  }
+  state.SetItemsProcessed(state.iterations() * dst_buffer.size());
+}
+BENCHMARK(BM_Conv2DF32);
+
+void BM_QuantizedConv2DI8(benchmark::State& state) {
+  const Shape input_shape = {28, 28, 64};
+  const Shape filter_shape = {3, 3, 64, 64};
+  const Shape dst_shape = {28, 28, 64};
+  const Shape strides = {1, 1};
+  const Shape padding = {1, 1};
+  const Shape dilation = {1, 1};
+  std::vector<int8_t> input_buffer(28 * 28 * 64, 12);
+  std::vector<int8_t> filter_buffer(3 * 3 * 64 * 64, -3);
+  std::vector<int8_t> dst_buffer(28 * 28 * 64);
+  std::vector<int32_t> bias(64, 100);
+  std::vector<int32_t> multiplier_mantissa(64, 1 << 30);
+  std::vector<int32_t> multiplier_exponent(64, -8);
+  QuantizedConv2D::Params params;
+  params.input_zero_point = -5;
+  params.dst_zero_point = 3;
+  params.bias = bias;
+  params.multiplier_mantissa = multiplier_mantissa;
+  params.multiplier_exponent = multiplier_exponent;
+  RuntimeState runtime_state;
+  for (auto _ : state) {
+    IREE_CHECK_OK(QuantizedConv2D::Execute<int8_t>(
+        runtime_state.mat_mul_state.get(), input_buffer, input_shape,
+        filter_buffer, filter_shape, absl::MakeSpan(dst_buffer), dst_shape,
+        params, strides, padding, padding, dilation, 1));
+    benchmark::DoNotOptimize(dst_buffer.data());
+  }
+  state.SetItemsProcessed(state.iterations() * dst_buffer.size());
+}
+BENCHMARK(BM_QuantizedConv2DI8);
+
+// Evaluates Op over 64K positive elements using the SimdLevel given by the
+// benchmark argument, skipping levels the CPU doesn't support.
+template <typename Op>
+void BM_UnaryMath(benchmark::State& state) {
+  auto level = static_cast<impl::SimdLevel>(state.range(0));
+  if (level > impl::GetSimdLevel()) {
+    state.SkipWithError("SIMD level not supported");
+    return;
+  }
+  std::vector<float> src_buffer(64 * 1024);
+  for (size_t i = 0; i < src_buffer.size(); ++i) {
+    src_buffer[i] = 0.001f * (i + 1);
+  }
+  std::vector<float> dst_buffer(src_buffer.size());
+  for (auto _ : state) {
+    impl::MapUnary<Op>(level, src_buffer.data(), dst_buffer.data(),
+                       src_buffer.size());
+    benchmark::DoNotOptimize(dst_buffer.data());
+  }
+  state.SetItemsProcessed(state.iterations() * src_buffer.size());
+}
+BENCHMARK_TEMPLATE(BM_UnaryMath, impl::ExpOp)->DenseRange(0, 2);
+BENCHMARK_TEMPLATE(BM_UnaryMath, impl::LogOp)->DenseRange(0, 2);
+BENCHMARK_TEMPLATE(BM_UnaryMath, impl::TanhOp)->DenseRange(0, 2);
+BENCHMARK_TEMPLATE(BM_UnaryMath, impl::SinOp)->DenseRange(0, 2);
+
+}  // namespace
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
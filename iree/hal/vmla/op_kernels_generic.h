@@ -15,7 +15,11 @@
 #ifndef IREE_HAL_VMLA_OP_KERNELS_GENERIC_H_
 #define IREE_HAL_VMLA_OP_KERNELS_GENERIC_H_
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
@@ -163,7 +167,7 @@ Status Conv2D::Execute(absl::Span<const T> input_buffer, ShapeSpan input_shape,
                        ShapeSpan filter_shape, absl::Span<T> dst_buffer,
                        ShapeSpan dst_shape, ShapeSpan window_strides,
                        ShapeSpan pad_h, ShapeSpan pad_w, ShapeSpan dilation,
-                       const int32_t groups) {
+                       const int32_t groups, ThreadPool* thread_pool) {
   const std::array<int32_t, 3> input_strides = {input_shape[1] * input_shape[2],
                                                 input_shape[2], 1};
   const std::array<int32_t, 4> filter_strides = {
@@ -173,41 +177,161 @@ Status Conv2D::Execute(absl::Span<const T> input_buffer, ShapeSpan input_shape,
                                               dst_shape[2], 1};
   // Direct 2d (grouped) convolution slow implementation. ref:
   // https://www.tensorflow.org/versions/r2.0/api_docs/python/tf/nn/convolution)
-  // TODO(ataei): Implement tiled GEMM based implementation.
+  // See op_kernels_ruy.h for the GEMM-based implementations.
   const int output_group_size = dst_shape[2] / groups;
   const int input_group_size = input_shape[2] / groups;
-  for (int ho = 0; ho < dst_shape[0]; ho++) {
-    for (int wo = 0; wo < dst_shape[1]; wo++) {
-      for (int g = 0; g < groups; ++g) {
-        for (int kh = 0; kh < filter_shape[0]; kh++) {
-          const int ih = ho * window_strides[0] + kh - pad_h[0];
-          // left-right padding condition.
-          if (ih < 0 || ih >= input_shape[0]) continue;
-          for (int kw = 0; kw < filter_shape[1]; kw++) {
-            // top-bottom padding condition.
-            const int iw = wo * window_strides[1] + kw - pad_w[0];
-            if (iw < 0 || iw >= input_shape[1]) continue;
-            for (int co = 0; co < output_group_size; co++) {
-              const int cg_o = g * output_group_size + co;
-              const int y_i = ho * dst_strides[0] + wo * dst_strides[1] + cg_o;
-              T dst_value = T(0);
-              for (int ci = 0; ci < input_group_size; ci++) {
-                const int cg_i = g * input_group_size + ci;
-                const int w_i = kh * dilation[0] * filter_strides[0] +
-                                kw * dilation[1] * filter_strides[1] +
-                                cg_i * filter_strides[2] + co;
-                const int x_i =
-                    ih * input_strides[0] + iw * input_strides[1] + cg_i;
-                dst_value += input_buffer[x_i] * filter_buffer[w_i];
+  // Output rows are independent and split across threads.
+  const size_t row_work = static_cast<size_t>(dst_strides[0]) *
+                          filter_shape[0] * filter_shape[1] * input_group_size;
+  return ParallelFor(
+      thread_pool, dst_shape[0], GetParallelGrain(row_work),
+      [&](size_t ho_begin, size_t ho_end) {
+        std::fill(dst_buffer.begin() + ho_begin * dst_strides[0],
+                  dst_buffer.begin() + ho_end * dst_strides[0], T(0));
+        for (int ho = ho_begin; ho < ho_end; ho++) {
+          for (int wo = 0; wo < dst_shape[1]; wo++) {
+            for (int g = 0; g < groups; ++g) {
+              for (int kh = 0; kh < filter_shape[0]; kh++) {
+                const int ih = ho * window_strides[0] + kh - pad_h[0];
+                // left-right padding condition.
+                if (ih < 0 || ih >= input_shape[0]) continue;
+                for (int kw = 0; kw < filter_shape[1]; kw++) {
+                  // top-bottom padding condition.
+                  const int iw = wo * window_strides[1] + kw - pad_w[0];
+                  if (iw < 0 || iw >= input_shape[1]) continue;
+                  for (int co = 0; co < output_group_size; co++) {
+                    const int cg_o = g * output_group_size + co;
+                    const int y_i =
+                        ho * dst_strides[0] + wo * dst_strides[1] + cg_o;
+                    T dst_value = T(0);
+                    for (int ci = 0; ci < input_group_size; ci++) {
+                      const int cg_i = g * input_group_size + ci;
+                      const int w_i = kh * dilation[0] * filter_strides[0] +
+                                      kw * dilation[1] * filter_strides[1] +
+                                      cg_i * filter_strides[2] + co;
+                      const int x_i =
+                          ih * input_strides[0] + iw * input_strides[1] + cg_i;
+                      dst_value += input_buffer[x_i] * filter_buffer[w_i];
+                    }
+                    dst_buffer[y_i] += dst_value;
+                  }
+                }
               }
-              dst_buffer[y_i] += dst_value;
             }
           }
         }
-      }
-    }
+        return OkStatus();
+      });
+}
+
+namespace impl {
+
+// Returns the high 32 bits of 2 * a * b, rounded to nearest.
+inline int32_t SaturatingRoundingDoublingHighMul(int32_t a, int32_t b) {
+  if (a == b && a == std::numeric_limits<int32_t>::min()) {
+    return std::numeric_limits<int32_t>::max();
   }
-  return OkStatus();
+  int64_t ab = static_cast<int64_t>(a) * static_cast<int64_t>(b);
+  int64_t nudge = ab >= 0 ? (1 << 30) : (1 - (1 << 30));
+  return static_cast<int32_t>((ab + nudge) / (int64_t{1} << 31));
+}
+
+// Returns x / 2^exponent rounded to nearest with ties away from zero.
+inline int32_t RoundingDivideByPOT(int32_t x, int exponent) {
+  if (exponent == 0) return x;
+  const int32_t mask = static_cast<int32_t>((int64_t{1} << exponent) - 1);
+  const int32_t remainder = x & mask;
+  const int32_t threshold = (mask >> 1) + (x < 0 ? 1 : 0);
+  return (x >> exponent) + (remainder > threshold ? 1 : 0);
+}
+
+// Returns |x| scaled by |multiplier| using only integer arithmetic.
+inline int32_t MultiplyByQuantizedMultiplier(int32_t x,
+                                             QuantizedMultiplier multiplier) {
+  const int left_shift = std::max(multiplier.exponent, 0);
+  const int right_shift = std::max(-multiplier.exponent, 0);
+  return RoundingDivideByPOT(
+      SaturatingRoundingDoublingHighMul(x * (1 << left_shift),
+                                        multiplier.multiplier),
+      right_shift);
+}
+
+// Returns the real value of |multiplier|.
+inline double QuantizedMultiplierToDouble(QuantizedMultiplier multiplier) {
+  return std::ldexp(static_cast<double>(multiplier.multiplier),
+                    multiplier.exponent - 31);
+}
+
+template <typename T>
+T SaturateCast(int64_t value) {
+  return static_cast<T>(std::min<int64_t>(
+      std::max<int64_t>(value, std::numeric_limits<T>::min()),
+      std::numeric_limits<T>::max()));
+}
+
+// Returns the requantization multiplier for output channel |channel|.
+inline QuantizedMultiplier GetChannelMultiplier(
+    const QuantizedConv2D::Params& params, int channel) {
+  const size_t i = params.multiplier_mantissa.size() == 1 ? 0 : channel;
+  return {params.multiplier_mantissa[i], params.multiplier_exponent[i]};
+}
+
+}  // namespace impl
+
+template <typename T>
+Status QuantizedConv2D::Execute(
+    absl::Span<const T> input_buffer, ShapeSpan input_shape,
+    absl::Span<const T> filter_buffer, ShapeSpan filter_shape,
+    absl::Span<T> dst_buffer, ShapeSpan dst_shape, const Params& params,
+    ShapeSpan strides, ShapeSpan pad_h, ShapeSpan pad_w, ShapeSpan dilation,
+    const int32_t groups, ThreadPool* thread_pool) {
+  const int input_h = input_shape[0];
+  const int input_w = input_shape[1];
+  const int input_c = input_shape[2];
+  const int kernel_h = filter_shape[0];
+  const int kernel_w = filter_shape[1];
+  const int output_w = dst_shape[1];
+  const int output_c = dst_shape[2];
+  const int input_group_size = input_c / groups;
+  const int output_group_size = output_c / groups;
+  const size_t row_work = static_cast<size_t>(output_w) * output_c * kernel_h *
+                          kernel_w * input_group_size;
+  return ParallelFor(
+      thread_pool, dst_shape[0], GetParallelGrain(row_work),
+      [&](size_t ho_begin, size_t ho_end) {
+        for (int ho = ho_begin; ho < ho_end; ++ho) {
+          for (int wo = 0; wo < output_w; ++wo) {
+            for (int co = 0; co < output_c; ++co) {
+              const int g = co / output_group_size;
+              int32_t acc = params.bias.empty() ? 0 : params.bias[co];
+              for (int kh = 0; kh < kernel_h; ++kh) {
+                const int ih = ho * strides[0] + kh * dilation[0] - pad_h[0];
+                if (ih < 0 || ih >= input_h) continue;
+                for (int kw = 0; kw < kernel_w; ++kw) {
+                  const int iw = wo * strides[1] + kw * dilation[1] - pad_w[0];
+                  if (iw < 0 || iw >= input_w) continue;
+                  const T* input = input_buffer.data() +
+                                   (ih * input_w + iw) * input_c +
+                                   g * input_group_size;
+                  const T* filter =
+                      filter_buffer.data() +
+                      (kh * kernel_w + kw) * input_group_size * output_c + co;
+                  for (int ci = 0; ci < input_group_size; ++ci) {
+                    acc += (input[ci] - params.input_zero_point) *
+                           filter[ci * output_c];
+                  }
+                }
+              }
+              const int32_t value = impl::MultiplyByQuantizedMultiplier(
+                  acc, impl::GetChannelMultiplier(params, co));
+              dst_buffer[(ho * output_w + wo) * output_c + co] =
+                  impl::SaturateCast<T>(int64_t{value} +
+                                        params.dst_zero_point);
+            }
+          }
+        }
+        return OkStatus();
+      });
 }
 
 template <typename T>
@@ -230,35 +354,6 @@ Status Finite::Execute(absl::Span<const T> src_buffer,
   return OkStatus();
 }
 
-template <typename T>
-Status Transpose::Execute(absl::Span<const T> src_buffer,
-                          absl::Span<T> dst_buffer, ShapeSpan src_shape,
-                          absl::Span<const int32_t> perm) {
-  // This implementation is .... not fast.
-  int rank = src_shape.size();
-  absl::InlinedVector<int, 8> src_strides(rank);
-  absl::InlinedVector<int, 8> dst_strides(rank);
-  size_t src_stride = 1;
-  size_t dst_stride = 1;
-  for (int dim_i = rank - 1; dim_i >= 0; --dim_i) {
-    src_strides[dim_i] = src_stride;
-    dst_strides[dim_i] = dst_stride;
-    src_stride *= src_shape[dim_i];
-    dst_stride *= src_shape[perm[dim_i]];
-  }
-  for (size_t dst_i = 0; dst_i < dst_buffer.size(); ++dst_i) {
-    size_t src_i = 0;
-    size_t t = dst_i;
-    for (int dim_i = 0; dim_i < rank; ++dim_i) {
-      size_t ratio = t / dst_strides[dim_i];
-      t -= ratio * dst_strides[dim_i];
-      src_i += ratio * src_strides[perm[dim_i]];
-    }
-    dst_buffer[dst_i] = src_buffer[src_i];
-  }
-  return OkStatus();
-}
-
 namespace impl {
 inline void IncrementShapeIndex(absl::Span<int32_t> indices, ShapeSpan shape) {
   for (int i = indices.size() - 1; i >= 0; --i) {
@@ -331,7 +426,8 @@ Status Gather::Execute(absl::Span<const T> src_buffer,
                        absl::Span<const int32_t> indices_buffer,
                        absl::Span<T> dst_buffer, ShapeSpan src_shape,
                        ShapeSpan indices_shape, ShapeSpan dst_shape,
-                       const int32_t dim, const int32_t batch_dims) {
+                       const int32_t dim, const int32_t batch_dims,
+                       ThreadPool* thread_pool) {
   std::vector<int32_t> output_strides(dst_shape.size(), 1);
   std::vector<int32_t> input_strides(src_shape.size(), 1);
   std::vector<int32_t> indices_strides(indices_shape.size(), 1);
@@ -369,18 +465,97 @@ Status Gather::Execute(absl::Span<const T> src_buffer,
   // see:https://www.tensorflow.org/api_docs/python/tf/gather
   // TODO(ataei): Shrink inner loop by scanning indices_buffer for
   // contiguous indices and collide the copy of these slices.
-  for (size_t i = 0; i < outer_size; ++i) {
-    const int batch_offset =
-        batch_dims == 0 ? 0 : (i / batch_stride) * indices_strides[batch_dims];
-    for (size_t j = 0; j < indices_size; ++j) {
-      const size_t dst_offset = i * output_stride + j * slize_size;
-      const size_t src_offset =
-          i * input_stride + indices_buffer[batch_offset + j] * slize_size;
-      std::memcpy(dst_buffer.data() + dst_offset,
-                  src_buffer.data() + src_offset, sizeof(T) * slize_size);
+  // Each (outer, index) pair copies one independent slice.
+  return ParallelFor(
+      thread_pool, outer_size * indices_size, GetParallelGrain(slize_size),
+      [&](size_t begin, size_t end) {
+        for (size_t n = begin; n < end; ++n) {
+          const size_t i = n / indices_size;
+          const size_t j = n % indices_size;
+          const int batch_offset =
+              batch_dims == 0
+                  ? 0
+                  : (i / batch_stride) * indices_strides[batch_dims];
+          const size_t dst_offset = i * output_stride + j * slize_size;
+          const size_t src_offset =
+              i * input_stride + indices_buffer[batch_offset + j] * slize_size;
+          std::memcpy(dst_buffer.data() + dst_offset,
+                      src_buffer.data() + src_offset, sizeof(T) * slize_size);
+        }
+        return OkStatus();
+      });
+}
+
+namespace impl {
+
+// Extents of a shape collapsed to [outer, axis, inner] around one dimension.
+struct AxisExtents {
+  size_t outer = 1;
+  size_t axis = 1;
+  size_t inner = 1;
+};
+
+inline AxisExtents CollapseAroundAxis(ShapeSpan shape, int32_t dimension) {
+  AxisExtents extents;
+  for (int i = 0; i < dimension; ++i) extents.outer *= shape[i];
+  extents.axis = shape[dimension];
+  for (int i = dimension + 1; i < shape.size(); ++i) extents.inner *= shape[i];
+  return extents;
+}
+
+}  // namespace impl
+
+template <typename T>
+Status TakeAlongAxis::Execute(absl::Span<const T> src_buffer,
+                              absl::Span<const int32_t> indices_buffer,
+                              absl::Span<T> dst_buffer, ShapeSpan src_shape,
+                              ShapeSpan indices_shape, int32_t dimension,
+                              ThreadPool* thread_pool) {
+  if (dimension < 0 || dimension >= src_shape.size() ||
+      indices_shape.size() != src_shape.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Take dimension " << dimension << " invalid for source rank "
+           << src_shape.size() << " and indices rank " << indices_shape.size();
+  }
+  for (int i = 0; i < src_shape.size(); ++i) {
+    if (i != dimension && src_shape[i] != indices_shape[i]) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Indices shape must match the source shape outside of "
+                "dimension "
+             << dimension;
     }
   }
-  return OkStatus();
+  const auto src = impl::CollapseAroundAxis(src_shape, dimension);
+  const auto dst = impl::CollapseAroundAxis(indices_shape, dimension);
+  const size_t slice_size = dst.axis * dst.inner;
+  if (src_buffer.size() < src.outer * src.axis * src.inner ||
+      indices_buffer.size() < dst.outer * slice_size ||
+      dst_buffer.size() < dst.outer * slice_size) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Take buffers too small for the given shapes";
+  }
+
+  return ParallelFor(
+      thread_pool, dst.outer, GetParallelGrain(slice_size),
+      [&](size_t begin, size_t end) -> Status {
+        for (size_t o = begin; o < end; ++o) {
+          const T* src_slice = src_buffer.data() + o * src.axis * src.inner;
+          const int32_t* indices = indices_buffer.data() + o * slice_size;
+          T* dst_slice = dst_buffer.data() + o * slice_size;
+          for (size_t j = 0; j < dst.axis; ++j) {
+            for (size_t i = 0; i < dst.inner; ++i) {
+              const int32_t index = indices[j * dst.inner + i];
+              if (index < 0 || static_cast<size_t>(index) >= src.axis) {
+                return OutOfRangeErrorBuilder(IREE_LOC)
+                       << "Take index " << index
+                       << " out of range for dimension of size " << src.axis;
+              }
+              dst_slice[j * dst.inner + i] = src_slice[index * src.inner + i];
+            }
+          }
+        }
+        return OkStatus();
+      });
 }
 
 namespace impl {
@@ -798,6 +973,120 @@ Status Ceil::Execute(absl::Span<const T> src_buffer, absl::Span<T> dst_buffer) {
   return OkStatus();
 }
 
+namespace impl {
+template <typename T>
+Status ExecuteElementwiseInstruction(int32_t opcode, const T* lhs,
+                                     const T* rhs, T* result, size_t length) {
+  auto lhs_buffer = absl::MakeConstSpan(lhs, length);
+  auto rhs_buffer = absl::MakeConstSpan(rhs, length);
+  auto result_buffer = absl::MakeSpan(result, length);
+  switch (opcode) {
+    case Elementwise::kAdd:
+      return Add::Execute<T>(lhs_buffer, rhs_buffer, result_buffer);
+    case Elementwise::kSub:
+      return Sub::Execute<T>(lhs_buffer, rhs_buffer, result_buffer);
+    case Elementwise::kMul:
+      return Mul::Execute<T>(lhs_buffer, rhs_buffer, result_buffer);
+    case Elementwise::kDiv:
+      return Div::Execute<T>(lhs_buffer, rhs_buffer, result_buffer);
+    case Elementwise::kMin:
+      return Min::Execute<T>(lhs_buffer, rhs_buffer, result_buffer);
+    case Elementwise::kMax:
+      return Max::Execute<T>(lhs_buffer, rhs_buffer, result_buffer);
+    case Elementwise::kPow:
+      return Pow::Execute<T>(lhs_buffer, rhs_buffer, result_buffer);
+    case Elementwise::kAtan2:
+      return Atan2::Execute<T>(lhs_buffer, rhs_buffer, result_buffer);
+    case Elementwise::kAbs:
+      return Abs::Execute<T>(lhs_buffer, result_buffer);
+    case Elementwise::kNeg:
+      return Neg::Execute<T>(lhs_buffer, result_buffer);
+    case Elementwise::kExp:
+      return Exp::Execute<T>(lhs_buffer, result_buffer);
+    case Elementwise::kLog:
+      return Log::Execute<T>(lhs_buffer, result_buffer);
+    case Elementwise::kRsqrt:
+      return Rsqrt::Execute<T>(lhs_buffer, result_buffer);
+    case Elementwise::kSqrt:
+      return Sqrt::Execute<T>(lhs_buffer, result_buffer);
+    case Elementwise::kCos:
+      return Cos::Execute<T>(lhs_buffer, result_buffer);
+    case Elementwise::kSin:
+      return Sin::Execute<T>(lhs_buffer, result_buffer);
+    case Elementwise::kTanh:
+      return Tanh::Execute<T>(lhs_buffer, result_buffer);
+    case Elementwise::kFloor:
+      return Floor::Execute<T>(lhs_buffer, result_buffer);
+    case Elementwise::kCeil:
+      return Ceil::Execute<T>(lhs_buffer, result_buffer);
+    default:
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Unknown elementwise opcode " << opcode;
+  }
+}
+}  // namespace impl
+
+template <typename T>
+Status Elementwise::Execute(absl::Span<const int32_t> program,
+                            absl::Span<const absl::Span<const T>> src_buffers,
+                            absl::Span<T> dst_buffer) {
+  if (program.empty() || program.size() % kInstructionSize != 0) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Malformed elementwise program of " << program.size()
+           << " words";
+  }
+  for (const auto& src_buffer : src_buffers) {
+    if (src_buffer.size() != dst_buffer.size()) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Elementwise source buffer has " << src_buffer.size()
+             << " elements but the destination has " << dst_buffer.size();
+    }
+  }
+
+  // Verify that all instructions only read registers that have been defined
+  // and never overwrite a source buffer.
+  const int src_count = src_buffers.size();
+  int register_count = src_count;
+  for (size_t pc = 0; pc < program.size(); pc += kInstructionSize) {
+    int32_t result = program[pc + 1];
+    int32_t lhs = program[pc + 2];
+    int32_t rhs = program[pc + 3];
+    if (result < src_count || lhs < 0 || lhs >= register_count || rhs < 0 ||
+        rhs >= register_count) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Elementwise instruction " << pc / kInstructionSize
+             << " references an invalid register";
+    }
+    register_count = std::max(register_count, result + 1);
+  }
+
+  absl::InlinedVector<T, 2 * kChunkSize> temps((register_count - src_count) *
+                                           kChunkSize);
+  absl::InlinedVector<const T*, 16> registers(register_count);
+  for (int i = src_count; i < register_count; ++i) {
+    registers[i] = temps.data() + (i - src_count) * kChunkSize;
+  }
+
+  const size_t last_pc = program.size() - kInstructionSize;
+  for (size_t offset = 0; offset < dst_buffer.size(); offset += kChunkSize) {
+    size_t length =
+        std::min(static_cast<size_t>(kChunkSize), dst_buffer.size() - offset);
+    for (int i = 0; i < src_count; ++i) {
+      registers[i] = src_buffers[i].data() + offset;
+    }
+    for (size_t pc = 0; pc < program.size(); pc += kInstructionSize) {
+      int32_t result = program[pc + 1];
+      T* result_ptr = pc == last_pc
+                          ? dst_buffer.data() + offset
+                          : temps.data() + (result - src_count) * kChunkSize;
+      IREE_RETURN_IF_ERROR(impl::ExecuteElementwiseInstruction<T>(
+          program[pc], registers[program[pc + 2]], registers[program[pc + 3]],
+          result_ptr, length));
+    }
+  }
+  return OkStatus();
+}
+
 template <typename SRC, typename DST>
 Status Convert::Execute(absl::Span<const SRC> src_buffer,
                         absl::Span<DST> dst_buffer) {
@@ -810,6 +1099,162 @@ Status Convert::Execute(absl::Span<const SRC> src_buffer,
 
 namespace impl {
 
+template <typename T>
+Status WidenChunk(absl::Span<const T> src_buffer, float* dst) {
+  return Convert::Execute<T, float>(src_buffer,
+                                    absl::MakeSpan(dst, src_buffer.size()));
+}
+
+template <typename T>
+Status NarrowChunk(const float* src, absl::Span<T> dst_buffer) {
+  return Convert::Execute<float, T>(
+      absl::MakeConstSpan(src, dst_buffer.size()), dst_buffer);
+}
+
+}  // namespace impl
+
+template <typename KERNEL>
+template <typename T>
+Status Widened<KERNEL>::Execute(absl::Span<const T> src_buffer,
+                                absl::Span<T> dst_buffer) {
+  float src[kChunkSize];
+  float dst[kChunkSize];
+  for (size_t offset = 0; offset < dst_buffer.size(); offset += kChunkSize) {
+    const size_t length =
+        std::min(static_cast<size_t>(kChunkSize), dst_buffer.size() - offset);
+    IREE_RETURN_IF_ERROR(
+        impl::WidenChunk(src_buffer.subspan(offset, length), src));
+    IREE_RETURN_IF_ERROR(KERNEL::template Execute<float>(
+        absl::MakeConstSpan(src, length), absl::MakeSpan(dst, length)));
+    IREE_RETURN_IF_ERROR(
+        impl::NarrowChunk(dst, dst_buffer.subspan(offset, length)));
+  }
+  return OkStatus();
+}
+
+template <typename KERNEL>
+template <typename T>
+Status Widened<KERNEL>::Execute(absl::Span<const T> lhs_buffer,
+                                absl::Span<const T> rhs_buffer,
+                                absl::Span<T> dst_buffer) {
+  float lhs[kChunkSize];
+  float rhs[kChunkSize];
+  float dst[kChunkSize];
+  for (size_t offset = 0; offset < dst_buffer.size(); offset += kChunkSize) {
+    const size_t length =
+        std::min(static_cast<size_t>(kChunkSize), dst_buffer.size() - offset);
+    IREE_RETURN_IF_ERROR(
+        impl::WidenChunk(lhs_buffer.subspan(offset, length), lhs));
+    IREE_RETURN_IF_ERROR(
+        impl::WidenChunk(rhs_buffer.subspan(offset, length), rhs));
+    IREE_RETURN_IF_ERROR(KERNEL::template Execute<float>(
+        absl::MakeConstSpan(lhs, length), absl::MakeConstSpan(rhs, length),
+        absl::MakeSpan(dst, length)));
+    IREE_RETURN_IF_ERROR(
+        impl::NarrowChunk(dst, dst_buffer.subspan(offset, length)));
+  }
+  return OkStatus();
+}
+
+template <typename KERNEL>
+template <typename T>
+Status Widened<KERNEL>::Execute(absl::Span<const T> a_buffer,
+                                absl::Span<const T> b_buffer,
+                                absl::Span<const T> c_buffer,
+                                absl::Span<T> dst_buffer) {
+  float a[kChunkSize];
+  float b[kChunkSize];
+  float c[kChunkSize];
+  float dst[kChunkSize];
+  for (size_t offset = 0; offset < dst_buffer.size(); offset += kChunkSize) {
+    const size_t length =
+        std::min(static_cast<size_t>(kChunkSize), dst_buffer.size() - offset);
+    IREE_RETURN_IF_ERROR(
+        impl::WidenChunk(a_buffer.subspan(offset, length), a));
+    IREE_RETURN_IF_ERROR(
+        impl::WidenChunk(b_buffer.subspan(offset, length), b));
+    IREE_RETURN_IF_ERROR(
+        impl::WidenChunk(c_buffer.subspan(offset, length), c));
+    IREE_RETURN_IF_ERROR(KERNEL::template Execute<float>(
+        absl::MakeConstSpan(a, length), absl::MakeConstSpan(b, length),
+        absl::MakeConstSpan(c, length), absl::MakeSpan(dst, length)));
+    IREE_RETURN_IF_ERROR(
+        impl::NarrowChunk(dst, dst_buffer.subspan(offset, length)));
+  }
+  return OkStatus();
+}
+
+template <typename T>
+Status Quantize::Execute(absl::Span<const float> src_buffer,
+                         absl::Span<T> dst_buffer, int32_t zero_point,
+                         QuantizedMultiplier multiplier) {
+  const float inverse_scale =
+      static_cast<float>(impl::QuantizedMultiplierToDouble(multiplier));
+  const float min_value = std::numeric_limits<T>::min();
+  const float max_value = std::numeric_limits<T>::max();
+  for (size_t i = 0; i < dst_buffer.size(); ++i) {
+    // Clamping before the conversion keeps out-of-range (and NaN) values from
+    // overflowing the intermediate integer.
+    float value = std::round(src_buffer[i] * inverse_scale) + zero_point;
+    value = std::isnan(value) ? zero_point
+                              : std::min(std::max(value, min_value), max_value);
+    dst_buffer[i] = static_cast<T>(value);
+  }
+  return OkStatus();
+}
+
+template <typename T>
+Status Dequantize::Execute(absl::Span<const T> src_buffer,
+                           absl::Span<float> dst_buffer, int32_t zero_point,
+                           QuantizedMultiplier multiplier) {
+  const float scale =
+      static_cast<float>(impl::QuantizedMultiplierToDouble(multiplier));
+  for (size_t i = 0; i < dst_buffer.size(); ++i) {
+    dst_buffer[i] = (static_cast<int32_t>(src_buffer[i]) - zero_point) * scale;
+  }
+  return OkStatus();
+}
+
+template <typename T>
+Status QuantizedAdd::Execute(
+    absl::Span<const T> lhs_buffer, int32_t lhs_zero_point,
+    QuantizedMultiplier lhs_multiplier, absl::Span<const T> rhs_buffer,
+    int32_t rhs_zero_point, QuantizedMultiplier rhs_multiplier,
+    absl::Span<T> dst_buffer, int32_t dst_zero_point,
+    QuantizedMultiplier dst_multiplier) {
+  static_assert(sizeof(T) <= 2, "headroom only sufficient for 8/16-bit types");
+  for (size_t i = 0; i < dst_buffer.size(); ++i) {
+    const int32_t lhs_value = impl::MultiplyByQuantizedMultiplier(
+        (lhs_buffer[i] - lhs_zero_point) * (1 << kLeftShift), lhs_multiplier);
+    const int32_t rhs_value = impl::MultiplyByQuantizedMultiplier(
+        (rhs_buffer[i] - rhs_zero_point) * (1 << kLeftShift), rhs_multiplier);
+    const int32_t sum = impl::MultiplyByQuantizedMultiplier(
+        lhs_value + rhs_value, dst_multiplier);
+    dst_buffer[i] = impl::SaturateCast<T>(int64_t{sum} + dst_zero_point);
+  }
+  return OkStatus();
+}
+
+template <typename T>
+Status QuantizedMul::Execute(absl::Span<const T> lhs_buffer,
+                             int32_t lhs_zero_point,
+                             absl::Span<const T> rhs_buffer,
+                             int32_t rhs_zero_point, absl::Span<T> dst_buffer,
+                             int32_t dst_zero_point,
+                             QuantizedMultiplier dst_multiplier) {
+  static_assert(sizeof(T) <= 2, "product must fit in an int32 accumulator");
+  for (size_t i = 0; i < dst_buffer.size(); ++i) {
+    const int32_t product = (lhs_buffer[i] - lhs_zero_point) *
+                            (rhs_buffer[i] - rhs_zero_point);
+    const int32_t value =
+        impl::MultiplyByQuantizedMultiplier(product, dst_multiplier);
+    dst_buffer[i] = impl::SaturateCast<T>(int64_t{value} + dst_zero_point);
+  }
+  return OkStatus();
+}
+
+namespace impl {
+
 struct SumKernel {
   template <typename T>
   inline void operator()(T* value0, const T value1) {
@@ -831,98 +1276,206 @@ struct MaxKernel {
   }
 };
 
+// Accumulates |count| contiguous elements into |*value|.
+// Specialized in op_kernels_simd.h with horizontal vector accumulation.
 template <typename T, typename KernelImpl>
-inline void ReduceDimension(absl::Span<const T> src_buffer,
-                            absl::Span<T> dst_buffer, ShapeSpan src_shape,
-                            absl::Span<const int32_t> reduce_dims,
-                            absl::Span<const int> dst_strides, int dim,
-                            absl::Span<int> src_indices, size_t flat_src_i,
-                            size_t src_stride) {
-  if (dim < 0) {
-    // Base case of the recursion - figure out which elements should be acted
-    // upon and apply the reduction kernel to them.
-
-    // Derive destination indices from source indices.
-    // For example,
-    //     reduce_dims: [1, 2]
-    //     src_indices: [2, 1, 3, 0]
-    //                      ^  ^
-    //                      |  |
-    //                      |----- remove these dimensions
-    //     dst_indices: [2, 0]
-    //
-    // TODO(scotttodd): Clean this up somehow, share across recursion levels?
-    size_t dst_size = src_shape.size() - reduce_dims.size();
-    absl::InlinedVector<int, 8> dst_indices;
-    for (size_t i = 0; i < src_indices.size(); ++i) {
-      if (std::find(std::begin(reduce_dims), std::end(reduce_dims), i) ==
-          std::end(reduce_dims)) {
-        dst_indices.push_back(src_indices[i]);
-      }
-    }
-    // Compute the flattened index into dst_buffer at [dst_indices].
-    size_t dst_i = 0;
-    for (size_t i = 0; i < dst_indices.size(); ++i) {
-      dst_i += dst_indices[i] * dst_strides[dst_size - 1 - i];
+struct ReduceInnermost {
+  static void Run(const T* src, size_t count, T* value) {
+    for (size_t i = 0; i < count; ++i) {
+      KernelImpl()(value, src[i]);
     }
+  }
+};
 
-    // Flattened src and dst indices have been computed, invoke the kernel.
-    KernelImpl()(&dst_buffer[dst_i], src_buffer[flat_src_i]);
-    return;
+// Accumulates |rows| rows of |inner| elements, each |stride| elements apart,
+// into the |inner| elements of |dst|, streaming through the rows in memory
+// order. Specialized in op_kernels_simd.h with row-wise vector accumulation.
+template <typename T, typename KernelImpl>
+struct ReduceRows {
+  static void Run(const T* src, size_t rows, size_t inner, size_t stride,
+                  T* dst) {
+    for (size_t r = 0; r < rows; ++r) {
+      const T* src_row = src + r * stride;
+      for (size_t i = 0; i < inner; ++i) {
+        KernelImpl()(&dst[i], src_row[i]);
+      }
+    }
   }
+};
 
-  // Iterate through the current dimension in the source shape, recursing
-  // down one dimension at a time.
-  //
-  // This touches each element in the source buffer once, tracking complete
-  // dimensions within the shaped source buffer and using them to compute
-  // the corresponding indices (shaped and flattened) within the destination
-  // buffer. Each element in the destination buffer will be touched multiple
-  // times.
-  //
-  // Note that cache coherency isn't considered here, and some computations
-  // are redundant, so this could be optimized substantially.
-  for (size_t dim_i = 0; dim_i < src_shape[dim]; ++dim_i) {
-    src_indices[dim] = dim_i;
+// Type that values of T are accumulated in. Half and BFloat16 accumulate in
+// float, widening their sources a block at a time within the kernels.
+template <typename T>
+struct Accumulator {
+  using type = T;
+};
+template <>
+struct Accumulator<Half> {
+  using type = float;
+};
+template <>
+struct Accumulator<BFloat16> {
+  using type = float;
+};
 
-    // Recurse down to the next dimension (e.g. 2 -> 1 -> 0 -> base case)
-    //   * Add the current stride to flat_src_i
-    //   * Multiply src_stride by this dimension's shape
-    ReduceDimension<T, KernelImpl>(src_buffer, dst_buffer, src_shape,
-                                   reduce_dims, dst_strides, dim - 1,
-                                   src_indices, flat_src_i + dim_i * src_stride,
-                                   src_stride * src_shape[dim]);
+// Number of elements widened at a time by 16-bit float reductions.
+constexpr size_t kWidenedReduceBlock = 4096;
+
+// Widens |count| 16-bit floats a block at a time and accumulates them with
+// the float implementation.
+template <typename T, typename KernelImpl>
+struct WidenedReduceInnermost {
+  static void Run(const T* src, size_t count, float* value) {
+    float block[kWidenedReduceBlock];
+    for (size_t i = 0; i < count; i += kWidenedReduceBlock) {
+      const size_t length = std::min(kWidenedReduceBlock, count - i);
+      WidenChunk(absl::MakeConstSpan(src + i, length), block).IgnoreError();
+      ReduceInnermost<float, KernelImpl>::Run(block, length, value);
+    }
   }
-}
+};
+template <typename KernelImpl>
+struct ReduceInnermost<Half, KernelImpl>
+    : public WidenedReduceInnermost<Half, KernelImpl> {};
+template <typename KernelImpl>
+struct ReduceInnermost<BFloat16, KernelImpl>
+    : public WidenedReduceInnermost<BFloat16, KernelImpl> {};
+
+// Reduces |rows| rows of |columns| elements, each |stride| elements apart,
+// into the |columns| elements of |dst| starting from |init_value|.
+template <typename T, typename KernelImpl>
+struct ReduceColumns {
+  static void Run(const T* src, size_t rows, size_t columns, size_t stride,
+                  T init_value, T* dst) {
+    std::fill_n(dst, columns, init_value);
+    ReduceRows<T, KernelImpl>::Run(src, rows, columns, stride, dst);
+  }
+};
+
+// Widens as many rows at a time as fit in a block and accumulates them into
+// float columns with the float implementation, narrowing once at the end.
+// |columns| must not exceed kWidenedReduceBlock.
+template <typename T, typename KernelImpl>
+struct WidenedReduceColumns {
+  static void Run(const T* src, size_t rows, size_t columns, size_t stride,
+                  T init_value, T* dst) {
+    float block[kWidenedReduceBlock];
+    float acc[kWidenedReduceBlock];
+    std::fill_n(acc, columns, static_cast<float>(init_value));
+    const size_t block_rows = kWidenedReduceBlock / columns;
+    for (size_t r = 0; r < rows; r += block_rows) {
+      const size_t length = std::min(block_rows, rows - r);
+      for (size_t i = 0; i < length; ++i) {
+        WidenChunk(absl::MakeConstSpan(src + (r + i) * stride, columns),
+                   block + i * columns)
+            .IgnoreError();
+      }
+      ReduceRows<float, KernelImpl>::Run(block, length, columns, columns, acc);
+    }
+    NarrowChunk(acc, absl::MakeSpan(dst, columns)).IgnoreError();
+  }
+};
+template <typename KernelImpl>
+struct ReduceColumns<Half, KernelImpl>
+    : public WidenedReduceColumns<Half, KernelImpl> {};
+template <typename KernelImpl>
+struct ReduceColumns<BFloat16, KernelImpl>
+    : public WidenedReduceColumns<BFloat16, KernelImpl> {};
 
 template <typename T, typename KernelImpl>
 Status GenericReduce(absl::Span<const T> src_buffer,
                      absl::Span<const T> init_buffer, absl::Span<T> dst_buffer,
                      int32_t dimension, ShapeSpan src_shape,
-                     ShapeSpan dst_shape) {
-  // Initialize using init_buffer, which is expected to be a scalar.
-  std::fill_n(dst_buffer.data(), dst_buffer.size(), init_buffer[0]);
-
-  // Precompute destination strides.
-  int dst_rank = dst_shape.size();
-  absl::InlinedVector<int, 8> dst_strides;
-  size_t dst_stride = 1;
-  for (int dim_i = dst_rank - 1; dim_i >= 0; --dim_i) {
-    dst_strides.push_back(dst_stride);
-    dst_stride *= dst_shape[dim_i];
+                     ShapeSpan dst_shape, ThreadPool* thread_pool) {
+  if (dimension < 0 || dimension >= src_shape.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Reduction dimension " << dimension << " out of range for rank "
+           << src_shape.size();
+  }
+
+  // Collapse the source shape to [outer, reduce, inner] around the reduced
+  // dimension; the destination is then [outer, inner].
+  size_t outer = 1;
+  for (int i = 0; i < dimension; ++i) outer *= src_shape[i];
+  size_t reduce = src_shape[dimension];
+  size_t inner = 1;
+  for (int i = dimension + 1; i < src_shape.size(); ++i) inner *= src_shape[i];
+  if (src_buffer.size() < outer * reduce * inner ||
+      dst_buffer.size() < outer * inner) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Reduction buffers too small for the source shape";
+  }
+
+  // Outputs start from init_buffer, which is expected to be a scalar, and
+  // accumulate in ACC.
+  using ACC = typename Accumulator<T>::type;
+  const T init_value = init_buffer[0];
+
+  if (inner > 1) {
+    // Outer slices and blocks of columns within them are reduced
+    // independently.
+    constexpr size_t kColumnBlock = 256;
+    const size_t column_blocks = (inner + kColumnBlock - 1) / kColumnBlock;
+    return ParallelFor(
+        thread_pool, outer * column_blocks,
+        GetParallelGrain(reduce * std::min(inner, kColumnBlock)),
+        [&](size_t begin, size_t end) {
+          for (size_t n = begin; n < end; ++n) {
+            const size_t o = n / column_blocks;
+            const size_t c = (n % column_blocks) * kColumnBlock;
+            ReduceColumns<T, KernelImpl>::Run(
+                src_buffer.data() + o * reduce * inner + c, reduce,
+                std::min(kColumnBlock, inner - c), inner, init_value,
+                dst_buffer.data() + o * inner + c);
+          }
+          return OkStatus();
+        });
+  }
+
+  // Long rows are split into segments reduced into partial values that are
+  // then combined in order. Each segment starts from its first element as
+  // there is no identity value to start from.
+  size_t segments = 1;
+  if (thread_pool && thread_pool->concurrency() > 1 &&
+      reduce >= 2 * kMinParallelWork) {
+    segments = std::min<size_t>((reduce + kMinParallelWork - 1) /
+                                    kMinParallelWork,
+                                thread_pool->concurrency());
+  }
+  if (segments == 1) {
+    return ParallelFor(thread_pool, outer, GetParallelGrain(reduce),
+                       [&](size_t begin, size_t end) {
+                         for (size_t o = begin; o < end; ++o) {
+                           ACC value = init_value;
+                           ReduceInnermost<T, KernelImpl>::Run(
+                               src_buffer.data() + o * reduce, reduce, &value);
+                           dst_buffer[o] = T(value);
+                         }
+                         return OkStatus();
+                       });
+  }
+  const size_t segment_size = (reduce + segments - 1) / segments;
+  segments = (reduce + segment_size - 1) / segment_size;
+  std::vector<ACC> partials(outer * segments);
+  IREE_RETURN_IF_ERROR(ParallelFor(
+      thread_pool, outer * segments, 1, [&](size_t begin, size_t end) {
+        for (size_t n = begin; n < end; ++n) {
+          const size_t o = n / segments;
+          const size_t s = (n % segments) * segment_size;
+          const T* src = src_buffer.data() + o * reduce + s;
+          partials[n] = src[0];
+          ReduceInnermost<T, KernelImpl>::Run(
+              src + 1, std::min(segment_size, reduce - s) - 1, &partials[n]);
+        }
+        return OkStatus();
+      }));
+  for (size_t o = 0; o < outer; ++o) {
+    ACC value = init_value;
+    for (size_t n = 0; n < segments; ++n) {
+      KernelImpl()(&value, partials[o * segments + n]);
+    }
+    dst_buffer[o] = T(value);
   }
-
-  // Call the helper (recursive) function, starting with:
-  //   * source index [0, 0, ..., 0]
-  //   * the innermost dimension (last in the shape)
-  //   * flat_src_i of 0 (corresponds to [0, 0, ..., 0] above)
-  //   * source stride 1
-  absl::InlinedVector<int, 8> src_indices(src_shape.size(), 0);
-  ReduceDimension<T, KernelImpl>(src_buffer, dst_buffer, src_shape, {dimension},
-                                 absl::MakeSpan(dst_strides),
-                                 src_shape.size() - 1,
-                                 absl::MakeSpan(src_indices), 0, 1);
-
   return OkStatus();
 }
 
@@ -932,52 +1485,85 @@ template <typename T>
 Status ReduceSum::Execute(absl::Span<const T> src_buffer,
                           absl::Span<const T> init_buffer,
                           absl::Span<T> dst_buffer, int32_t dimension,
-                          ShapeSpan src_shape, ShapeSpan dst_shape) {
-  return impl::GenericReduce<T, impl::SumKernel>(
-      src_buffer, init_buffer, dst_buffer, dimension, src_shape, dst_shape);
+                          ShapeSpan src_shape, ShapeSpan dst_shape,
+                          ThreadPool* thread_pool) {
+  return impl::GenericReduce<T, impl::SumKernel>(src_buffer, init_buffer,
+                                          dst_buffer, dimension, src_shape,
+                                          dst_shape, thread_pool);
 }
 
 template <typename T>
 Status ReduceMin::Execute(absl::Span<const T> src_buffer,
                           absl::Span<const T> init_buffer,
                           absl::Span<T> dst_buffer, int32_t dimension,
-                          ShapeSpan src_shape, ShapeSpan dst_shape) {
-  return impl::GenericReduce<T, impl::MinKernel>(
-      src_buffer, init_buffer, dst_buffer, dimension, src_shape, dst_shape);
+                          ShapeSpan src_shape, ShapeSpan dst_shape,
+                          ThreadPool* thread_pool) {
+  return impl::GenericReduce<T, impl::MinKernel>(src_buffer, init_buffer,
+                                          dst_buffer, dimension, src_shape,
+                                          dst_shape, thread_pool);
 }
 
 template <typename T>
 Status ReduceMax::Execute(absl::Span<const T> src_buffer,
                           absl::Span<const T> init_buffer,
                           absl::Span<T> dst_buffer, int32_t dimension,
-                          ShapeSpan src_shape, ShapeSpan dst_shape) {
-  return impl::GenericReduce<T, impl::MaxKernel>(
-      src_buffer, init_buffer, dst_buffer, dimension, src_shape, dst_shape);
+                          ShapeSpan src_shape, ShapeSpan dst_shape,
+                          ThreadPool* thread_pool) {
+  return impl::GenericReduce<T, impl::MaxKernel>(src_buffer, init_buffer,
+                                          dst_buffer, dimension, src_shape,
+                                          dst_shape, thread_pool);
 }
 
 namespace impl {
 
-template <typename T, typename KernelImpl>
+// Reduces the window starting at |src_indices| (which may lie in the padding)
+// into |dst_value|. Each run of the window along the innermost dimension is
+// contiguous in the source and is reduced with ReduceInnermost; elements in
+// the padding contribute |init_value|.
+template <typename T, typename KernelImpl,
+          typename ACC = typename Accumulator<T>::type>
 void ComputePoolingWindow(absl::Span<const T> src_buffer,
                           absl::Span<const int> src_indices,
-                          ShapeSpan src_shape, T init_value,
-                          ShapeSpan window_dimensions, T* dst_value) {
+                          ShapeSpan src_shape, ACC init_value,
+                          ShapeSpan window_dimensions, ACC* dst_value) {
+  *dst_value = init_value;
   int rank = src_shape.size();
+  int inner_dim = rank - 1;
+  int window_inner = window_dimensions[inner_dim];
+  if (window_inner == 0) return;
+  int inner_begin = std::max(src_indices[inner_dim], 0);
+  int inner_end =
+      std::min(src_indices[inner_dim] + window_inner, src_shape[inner_dim]);
+  int inner_valid = std::max(inner_end - inner_begin, 0);
+
   absl::InlinedVector<int, 8> window_indices(rank, 0);
-  auto getSrcValue = [&]() -> T {
-    int flat_idx = 0;
-    for (int i = 0; i < rank; ++i) {
-      int idx = src_indices[i] + window_indices[i];
-      if (idx < 0 || idx >= src_shape[i]) return init_value;
-      flat_idx = flat_idx * src_shape[i] + idx;
+  for (int i = 0, e = GetElementCount(window_dimensions) / window_inner; i < e;
+       ++i) {
+    size_t flat_row = 0;
+    bool in_bounds = inner_valid > 0;
+    for (int j = 0; j < inner_dim && in_bounds; ++j) {
+      int idx = src_indices[j] + window_indices[j];
+      in_bounds = idx >= 0 && idx < src_shape[j];
+      flat_row = flat_row * src_shape[j] + idx;
     }
-    return src_buffer[flat_idx];
-  };
-
-  *dst_value = init_value;
-  for (int i = 0, e = GetElementCount(window_dimensions); i < e; ++i) {
-    KernelImpl()(dst_value, getSrcValue());
-    IncrementShapeIndex(absl::MakeSpan(window_indices), window_dimensions);
+    if (in_bounds) {
+      for (int j = src_indices[inner_dim]; j < inner_begin; ++j) {
+        KernelImpl()(dst_value, init_value);
+      }
+      ReduceInnermost<T, KernelImpl>::Run(
+          src_buffer.data() + flat_row * src_shape[inner_dim] + inner_begin,
+          inner_valid, dst_value);
+      for (int j = inner_end; j < src_indices[inner_dim] + window_inner; ++j) {
+        KernelImpl()(dst_value, init_value);
+      }
+    } else {
+      for (int j = 0; j < window_inner; ++j) {
+        KernelImpl()(dst_value, init_value);
+      }
+    }
+    // Advance over all but the innermost window dimension.
+    IncrementShapeIndex(absl::MakeSpan(window_indices).first(inner_dim),
+                        window_dimensions.first(inner_dim));
   }
 }
 
@@ -987,16 +1573,25 @@ Status GenericPooling(absl::Span<const T> src_buffer,
                       ShapeSpan src_shape, ShapeSpan dst_shape,
                       ShapeSpan window_dimensions, ShapeSpan strides,
                       ShapeSpan pad_low) {
+  using ACC = typename Accumulator<T>::type;
+  const ACC init_value = init_buffer[0];
   int rank = src_shape.size();
+  if (rank == 0) {
+    ACC value = init_value;
+    KernelImpl()(&value, static_cast<ACC>(src_buffer[0]));
+    dst_buffer[0] = T(value);
+    return OkStatus();
+  }
   absl::InlinedVector<int, 8> src_indices(rank, 0);
   absl::InlinedVector<int, 8> dst_indices(rank, 0);
   for (int i = 0, e = GetElementCount(dst_shape); i < e; ++i) {
     for (int j = 0; j < rank; ++j) {
       src_indices[j] = dst_indices[j] * strides[j] - pad_low[j];
     }
+    ACC value;
     ComputePoolingWindow<T, KernelImpl>(src_buffer, src_indices, src_shape,
-                                        init_buffer[0], window_dimensions,
-                                        &dst_buffer[i]);
+                                        init_value, window_dimensions, &value);
+    dst_buffer[i] = T(value);
     IncrementShapeIndex(absl::MakeSpan(dst_indices), dst_shape);
   }
   return OkStatus();
@@ -1037,6 +1632,248 @@ Status PoolingMax::Execute(absl::Span<const T> src_buffer,
       window_dimensions, strides, pad_low);
 }
 
+namespace impl {
+
+// Integer averages round half away from zero; float averages are exact.
+template <typename T>
+T RoundedAverage(int64_t sum, int64_t count) {
+  return static_cast<T>(sum >= 0 ? (sum + count / 2) / count
+                                 : (sum - count / 2) / count);
+}
+template <typename T>
+T RoundedAverage(double sum, int64_t count) {
+  return static_cast<T>(sum / count);
+}
+
+template <typename T>
+using PoolingAvgAccumulator =
+    typename std::conditional<
+        std::is_floating_point<typename Accumulator<T>::type>::value, double,
+        int64_t>::type;
+
+}  // namespace impl
+
+template <typename T>
+Status PoolingAvg::Execute(absl::Span<const T> src_buffer,
+                           absl::Span<T> dst_buffer, ShapeSpan src_shape,
+                           ShapeSpan dst_shape, ShapeSpan window_dimensions,
+                           ShapeSpan strides, ShapeSpan pad_low) {
+  const int rank = src_shape.size();
+  if (rank == 0) {
+    dst_buffer[0] = src_buffer[0];
+    return OkStatus();
+  }
+  const size_t window_size = GetElementCount(window_dimensions);
+  absl::InlinedVector<int32_t, 8> dst_indices(rank, 0);
+  absl::InlinedVector<int32_t, 8> window_indices(rank, 0);
+  for (size_t i = 0, e = GetElementCount(dst_shape); i < e; ++i) {
+    impl::PoolingAvgAccumulator<T> sum = 0;
+    int64_t count = 0;
+    for (size_t w = 0; w < window_size; ++w) {
+      size_t src_offset = 0;
+      bool in_bounds = true;
+      for (int j = 0; j < rank && in_bounds; ++j) {
+        const int idx =
+            dst_indices[j] * strides[j] - pad_low[j] + window_indices[j];
+        in_bounds = idx >= 0 && idx < src_shape[j];
+        src_offset = src_offset * src_shape[j] + idx;
+      }
+      if (in_bounds) {
+        sum += src_buffer[src_offset];
+        ++count;
+      }
+      impl::IncrementShapeIndex(absl::MakeSpan(window_indices),
+                                window_dimensions);
+    }
+    dst_buffer[i] = count ? impl::RoundedAverage<T>(sum, count) : T(0);
+    impl::IncrementShapeIndex(absl::MakeSpan(dst_indices), dst_shape);
+  }
+  return OkStatus();
+}
+
+namespace impl {
+
+// Strict weak ordering of sort keys placing NaNs after all other values.
+// The NaN checks fold away for integer keys.
+template <typename T>
+struct SortOrder {
+  bool descending;
+  bool operator()(T lhs, T rhs) const {
+    if (rhs != rhs) return lhs == lhs;
+    if (lhs != lhs) return false;
+    return descending ? rhs < lhs : lhs < rhs;
+  }
+};
+
+// A key and its position along the sorted dimension.
+template <typename T>
+struct SortEntry {
+  T key;
+  int32_t position;
+};
+
+// Orders entries by key, breaking ties by position. This is a total order so
+// that unstable algorithms produce the same result as a stable sort.
+template <typename T>
+struct SortEntryOrder {
+  SortOrder<T> order;
+  bool operator()(const SortEntry<T>& lhs, const SortEntry<T>& rhs) const {
+    if (order(lhs.key, rhs.key)) return true;
+    if (order(rhs.key, lhs.key)) return false;
+    return lhs.position < rhs.position;
+  }
+};
+
+// Selections of up to 1/kTopKHeapFraction of the elements stream through the
+// source keeping a heap of the best k; larger ones partition all elements.
+constexpr size_t kTopKHeapFraction = 16;
+
+// Selects the first |k| of the |count| keys in |src|, each |stride| elements
+// apart, into |entries| in order.
+template <typename T>
+void SelectTopK(const T* src, size_t count, size_t stride, size_t k,
+                const SortEntryOrder<T>& entry_order,
+                std::vector<SortEntry<T>>* entries) {
+  entries->clear();
+  if (k == 0) return;
+  if (k * kTopKHeapFraction > count) {
+    entries->resize(count);
+    for (size_t j = 0; j < count; ++j) {
+      (*entries)[j] = {src[j * stride], static_cast<int32_t>(j)};
+    }
+    std::nth_element(entries->begin(), entries->begin() + (k - 1),
+                     entries->end(), entry_order);
+    entries->resize(k);
+    std::sort(entries->begin(), entries->end(), entry_order);
+    return;
+  }
+
+  // The top of the heap is the last of the k entries selected so far.
+  for (size_t j = 0; j < k; ++j) {
+    entries->push_back({src[j * stride], static_cast<int32_t>(j)});
+  }
+  std::make_heap(entries->begin(), entries->end(), entry_order);
+  for (size_t j = k; j < count; ++j) {
+    // Later positions lose ties so only strictly earlier keys are selected.
+    const T key = src[j * stride];
+    if (!entry_order.order(key, entries->front().key)) continue;
+    std::pop_heap(entries->begin(), entries->end(), entry_order);
+    entries->back() = {key, static_cast<int32_t>(j)};
+    std::push_heap(entries->begin(), entries->end(), entry_order);
+  }
+  std::sort_heap(entries->begin(), entries->end(), entry_order);
+}
+
+}  // namespace impl
+
+template <typename T>
+Status Sort::Execute(absl::Span<const T> src_buffer,
+                     absl::Span<int32_t> dst_buffer, ShapeSpan src_shape,
+                     int32_t dimension, bool descending, bool refine,
+                     ThreadPool* thread_pool) {
+  if (dimension < 0 || dimension >= src_shape.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Sort dimension " << dimension << " out of range for rank "
+           << src_shape.size();
+  }
+  const auto extents = impl::CollapseAroundAxis(src_shape, dimension);
+  const size_t element_count = extents.outer * extents.axis * extents.inner;
+  if (src_buffer.size() < element_count || dst_buffer.size() < element_count) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Sort buffers too small for the source shape";
+  }
+
+  const impl::SortEntryOrder<T> entry_order{{descending}};
+  // Each line along the sorted dimension is sorted independently.
+  return ParallelFor(
+      thread_pool, extents.outer * extents.inner,
+      GetParallelGrain(extents.axis), [&](size_t begin, size_t end) -> Status {
+        std::vector<impl::SortEntry<T>> entries(extents.axis);
+        std::vector<int32_t> indices(refine ? extents.axis : 0);
+        for (size_t n = begin; n < end; ++n) {
+          const size_t base = (n / extents.inner) * extents.axis *
+                                  extents.inner +
+                              n % extents.inner;
+          const T* src = src_buffer.data() + base;
+          int32_t* dst = dst_buffer.data() + base;
+          for (size_t j = 0; j < extents.axis; ++j) {
+            int32_t index = static_cast<int32_t>(j);
+            if (refine) {
+              index = dst[j * extents.inner];
+              if (index < 0 || static_cast<size_t>(index) >= extents.axis) {
+                return OutOfRangeErrorBuilder(IREE_LOC)
+                       << "Sort index " << index
+                       << " out of range for dimension of size "
+                       << extents.axis;
+              }
+              indices[j] = index;
+            }
+            entries[j] = {src[index * extents.inner], static_cast<int32_t>(j)};
+          }
+          std::sort(entries.begin(), entries.end(), entry_order);
+          for (size_t j = 0; j < extents.axis; ++j) {
+            const int32_t position = entries[j].position;
+            dst[j * extents.inner] = refine ? indices[position] : position;
+          }
+        }
+        return OkStatus();
+      });
+}
+
+template <typename T>
+Status TopK::Execute(absl::Span<const T> src_buffer,
+                     absl::Span<T> dst_values_buffer,
+                     absl::Span<int32_t> dst_indices_buffer,
+                     ShapeSpan src_shape, ShapeSpan dst_shape,
+                     int32_t dimension, bool descending,
+                     ThreadPool* thread_pool) {
+  if (dimension < 0 || dimension >= src_shape.size() ||
+      dst_shape.size() != src_shape.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "TopK dimension " << dimension << " invalid for source rank "
+           << src_shape.size() << " and destination rank " << dst_shape.size();
+  }
+  for (int i = 0; i < src_shape.size(); ++i) {
+    if (i == dimension ? dst_shape[i] > src_shape[i]
+                       : dst_shape[i] != src_shape[i]) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "TopK destination shape must match the source shape with at "
+                "most as many elements along dimension "
+             << dimension;
+    }
+  }
+  const auto extents = impl::CollapseAroundAxis(src_shape, dimension);
+  const size_t k = dst_shape[dimension];
+  if (src_buffer.size() < extents.outer * extents.axis * extents.inner ||
+      dst_values_buffer.size() < extents.outer * k * extents.inner ||
+      dst_indices_buffer.size() < extents.outer * k * extents.inner) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "TopK buffers too small for the given shapes";
+  }
+
+  const impl::SortEntryOrder<T> entry_order{{descending}};
+  // Each line along the selected dimension is processed independently.
+  return ParallelFor(
+      thread_pool, extents.outer * extents.inner,
+      GetParallelGrain(extents.axis), [&](size_t begin, size_t end) {
+        std::vector<impl::SortEntry<T>> entries;
+        for (size_t n = begin; n < end; ++n) {
+          const size_t o = n / extents.inner;
+          const size_t i = n % extents.inner;
+          impl::SelectTopK(
+              src_buffer.data() + o * extents.axis * extents.inner + i,
+              extents.axis, extents.inner, k, entry_order, &entries);
+          const size_t dst_base = o * k * extents.inner + i;
+          for (size_t j = 0; j < k; ++j) {
+            dst_values_buffer[dst_base + j * extents.inner] = entries[j].key;
+            dst_indices_buffer[dst_base + j * extents.inner] =
+                entries[j].position;
+          }
+        }
+        return OkStatus();
+      });
+}
+
 }  // namespace kernels
 }  // namespace vmla
 }  // namespace hal
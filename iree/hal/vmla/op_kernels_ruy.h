@@ -15,7 +15,9 @@
 #ifndef IREE_HAL_VMLA_OP_KERNELS_RUY_H_
 #define IREE_HAL_VMLA_OP_KERNELS_RUY_H_
 
+#include <algorithm>
 #include <type_traits>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/memory/memory.h"
@@ -32,12 +34,21 @@ namespace kernels {
 // TODO(benvanik): something more clever for making this shareable.
 // Maybe a factory fn based on the impl selected?
 struct MatMul::RuntimeState {
-  // TODO(benvanik): share the thread pool but keep context per-fiber?
+  // ruy manages its own worker threads so it can't run on the pool directly;
+  // instead it is limited to the concurrency of the pool so that GEMMs and
+  // pool-parallel kernels (which never overlap) use the same number of cores.
   ruy::Context context;
+  // Pool for the non-GEMM parts of kernels built on MatMul.
+  ThreadPool* thread_pool = nullptr;
 };
 
-inline std::unique_ptr<MatMul::RuntimeState> MatMul::CreateRuntimeState() {
-  return absl::make_unique<RuntimeState>();
+inline std::unique_ptr<MatMul::RuntimeState> MatMul::CreateRuntimeState(
+    ThreadPool* thread_pool) {
+  auto runtime_state = absl::make_unique<RuntimeState>();
+  runtime_state->thread_pool = thread_pool;
+  runtime_state->context.set_max_num_threads(
+      thread_pool ? thread_pool->concurrency() : 1);
+  return runtime_state;
 }
 
 // Floating-point case.
@@ -116,6 +127,400 @@ Status MatMul::Execute(RuntimeState* runtime_state,
   return OkStatus();
 }
 
+// Computes |dst| = |lhs| * |rhs| where |lhs| is an m x k matrix, |rhs| is a
+// k x n matrix and |dst| is an m x n matrix, all row-major.
+template <typename T>
+void RowMajorGemm(MatMul::RuntimeState* runtime_state, int m, int k, int n,
+                  const T* lhs, const T* rhs, T* dst) {
+  ruy::Matrix<T> lhs_matrix;
+  lhs_matrix.set_data(lhs);
+  ruy::MakeSimpleLayout(m, k, ruy::Order::kRowMajor,
+                        lhs_matrix.mutable_layout());
+
+  ruy::Matrix<T> rhs_matrix;
+  rhs_matrix.set_data(rhs);
+  ruy::MakeSimpleLayout(k, n, ruy::Order::kRowMajor,
+                        rhs_matrix.mutable_layout());
+
+  ruy::Matrix<T> dst_matrix;
+  dst_matrix.set_data(dst);
+  ruy::MakeSimpleLayout(m, n, ruy::Order::kRowMajor,
+                        dst_matrix.mutable_layout());
+
+  ruy::MulParams<T, T> mul_params;
+  ruy::Mul(lhs_matrix, rhs_matrix, mul_params, &runtime_state->context,
+           &dst_matrix);
+}
+
+// Upper bound on the transient memory used by the GEMM-based convolutions.
+// Larger convolutions are processed in blocks of output pixels.
+constexpr size_t kConv2DScratchBytes = 1024 * 1024;
+
+// Winograd has a fixed transform overhead per tile and channel that only pays
+// off once there are enough channels to amortize it over.
+constexpr int32_t kConv2DWinogradMinChannels = 8;
+
+inline Conv2D::Algorithm Conv2D::SelectAlgorithm(
+    ShapeSpan input_shape, ShapeSpan filter_shape, ShapeSpan strides,
+    ShapeSpan pad_h, ShapeSpan pad_w, ShapeSpan dilation,
+    const int32_t groups) {
+  if (groups != 1 || dilation[0] != 1 || dilation[1] != 1) {
+    return Algorithm::kDirect;
+  }
+  const bool is_unit_stride = strides[0] == 1 && strides[1] == 1;
+  const bool is_padded = pad_h[0] != 0 || pad_h[1] != 0 || pad_w[0] != 0 ||
+                         pad_w[1] != 0;
+  if (filter_shape[0] == 1 && filter_shape[1] == 1 && is_unit_stride &&
+      !is_padded) {
+    return Algorithm::kGemm1x1;
+  }
+  if (filter_shape[0] == 3 && filter_shape[1] == 3 && is_unit_stride &&
+      filter_shape[2] >= kConv2DWinogradMinChannels &&
+      filter_shape[3] >= kConv2DWinogradMinChannels) {
+    return Algorithm::kWinograd;
+  }
+  return Algorithm::kIm2Col;
+}
+
+// Gathers the input patch of each output pixel into a row of a matrix such that
+// the convolution becomes a GEMM with the [KH * KW * Ci, Co] filter.
+template <typename T>
+Status Conv2DIm2Col(MatMul::RuntimeState* runtime_state,
+                    absl::Span<const T> input_buffer, ShapeSpan input_shape,
+                    absl::Span<const T> filter_buffer, ShapeSpan filter_shape,
+                    absl::Span<T> dst_buffer, ShapeSpan dst_shape,
+                    ShapeSpan strides, ShapeSpan pad_h, ShapeSpan pad_w) {
+  const int input_h = input_shape[0];
+  const int input_w = input_shape[1];
+  const int input_c = input_shape[2];
+  const int kernel_h = filter_shape[0];
+  const int kernel_w = filter_shape[1];
+  const int output_w = dst_shape[1];
+  const int output_c = dst_shape[2];
+  const int output_size = dst_shape[0] * dst_shape[1];
+  const int patch_size = kernel_h * kernel_w * input_c;
+
+  const int block_size = std::max<int>(
+      1, std::min<int>(output_size,
+                       kConv2DScratchBytes / (patch_size * sizeof(T))));
+  std::vector<T> patches(block_size * patch_size);
+  for (int block_begin = 0; block_begin < output_size;
+       block_begin += block_size) {
+    const int block_end = std::min(block_begin + block_size, output_size);
+    T* patch = patches.data();
+    for (int p = block_begin; p < block_end; ++p) {
+      const int ho = p / output_w;
+      const int wo = p % output_w;
+      for (int kh = 0; kh < kernel_h; ++kh) {
+        const int ih = ho * strides[0] + kh - pad_h[0];
+        for (int kw = 0; kw < kernel_w; ++kw) {
+          const int iw = wo * strides[1] + kw - pad_w[0];
+          if (ih < 0 || ih >= input_h || iw < 0 || iw >= input_w) {
+            std::fill_n(patch, input_c, T(0));
+          } else {
+            std::copy_n(input_buffer.data() + (ih * input_w + iw) * input_c,
+                        input_c, patch);
+          }
+          patch += input_c;
+        }
+      }
+    }
+    RowMajorGemm(runtime_state, block_end - block_begin, patch_size, output_c,
+                 patches.data(), filter_buffer.data(),
+                 dst_buffer.data() + block_begin * output_c);
+  }
+  return OkStatus();
+}
+
+// Computes the Winograd F(2x2, 3x3) filter transform U = G g G^T of the
+// [3, 3, Ci, Co] |filter_buffer| as 16 row-major [Ci, Co] matrices.
+template <typename T>
+void Conv2DWinogradTransformFilter(absl::Span<const T> filter_buffer,
+                                   const int input_c, const int output_c,
+                                   absl::Span<T> transformed_filter) {
+  for (int ci = 0; ci < input_c; ++ci) {
+    for (int co = 0; co < output_c; ++co) {
+      T g[3][3];
+      for (int kh = 0; kh < 3; ++kh) {
+        for (int kw = 0; kw < 3; ++kw) {
+          g[kh][kw] = filter_buffer[((kh * 3 + kw) * input_c + ci) * output_c +
+                                    co];
+        }
+      }
+      T gg[4][3];
+      for (int kw = 0; kw < 3; ++kw) {
+        gg[0][kw] = g[0][kw];
+        gg[1][kw] = (g[0][kw] + g[1][kw] + g[2][kw]) / T(2);
+        gg[2][kw] = (g[0][kw] - g[1][kw] + g[2][kw]) / T(2);
+        gg[3][kw] = g[2][kw];
+      }
+      for (int r = 0; r < 4; ++r) {
+        T* u = transformed_filter.data() + (r * 4 * input_c + ci) * output_c +
+               co;
+        const int stride = input_c * output_c;
+        u[0 * stride] = gg[r][0];
+        u[1 * stride] = (gg[r][0] + gg[r][1] + gg[r][2]) / T(2);
+        u[2 * stride] = (gg[r][0] - gg[r][1] + gg[r][2]) / T(2);
+        u[3 * stride] = gg[r][2];
+      }
+    }
+  }
+}
+
+// Winograd F(2x2, 3x3) convolution. Each 2x2 output tile is computed from a
+// 4x4 input tile as A^T [(G g G^T) * (B^T d B)] A where the elementwise product
+// over all channels becomes 16 independent [tiles, Ci] x [Ci, Co] GEMMs.
+// |transformed_filter| is the result of Conv2DWinogradTransformFilter.
+// ref: https://arxiv.org/abs/1509.09308
+template <typename T>
+Status Conv2DWinograd(MatMul::RuntimeState* runtime_state,
+                      absl::Span<const T> input_buffer, ShapeSpan input_shape,
+                      absl::Span<const T> transformed_filter,
+                      absl::Span<T> dst_buffer, ShapeSpan dst_shape,
+                      ShapeSpan pad_h, ShapeSpan pad_w) {
+  const int input_h = input_shape[0];
+  const int input_w = input_shape[1];
+  const int input_c = input_shape[2];
+  const int output_h = dst_shape[0];
+  const int output_w = dst_shape[1];
+  const int output_c = dst_shape[2];
+  const int tiles_w = (output_w + 1) / 2;
+  const int tile_count = ((output_h + 1) / 2) * tiles_w;
+
+  const size_t tile_scratch_bytes = 16 * (input_c + output_c) * sizeof(T);
+  const int block_size = std::max<int>(
+      1, std::min<int>(tile_count, kConv2DScratchBytes / tile_scratch_bytes));
+  std::vector<T> transformed_input(16 * block_size * input_c);
+  std::vector<T> transformed_output(16 * block_size * output_c);
+  for (int block_begin = 0; block_begin < tile_count;
+       block_begin += block_size) {
+    const int block_tiles = std::min(block_size, tile_count - block_begin);
+
+    // V = B^T d B, stored as 16 row-major [tiles, Ci] matrices.
+    for (int t = 0; t < block_tiles; ++t) {
+      const int tile = block_begin + t;
+      const int ih0 = (tile / tiles_w) * 2 - pad_h[0];
+      const int iw0 = (tile % tiles_w) * 2 - pad_w[0];
+      for (int ci = 0; ci < input_c; ++ci) {
+        T d[4][4];
+        for (int r = 0; r < 4; ++r) {
+          const int ih = ih0 + r;
+          for (int c = 0; c < 4; ++c) {
+            const int iw = iw0 + c;
+            d[r][c] = (ih < 0 || ih >= input_h || iw < 0 || iw >= input_w)
+                          ? T(0)
+                          : input_buffer[(ih * input_w + iw) * input_c + ci];
+          }
+        }
+        T bd[4][4];
+        for (int c = 0; c < 4; ++c) {
+          bd[0][c] = d[0][c] - d[2][c];
+          bd[1][c] = d[1][c] + d[2][c];
+          bd[2][c] = d[2][c] - d[1][c];
+          bd[3][c] = d[1][c] - d[3][c];
+        }
+        for (int r = 0; r < 4; ++r) {
+          T* v = transformed_input.data() + (r * 4 * block_size + t) * input_c +
+                 ci;
+          const int stride = block_size * input_c;
+          v[0 * stride] = bd[r][0] - bd[r][2];
+          v[1 * stride] = bd[r][1] + bd[r][2];
+          v[2 * stride] = bd[r][2] - bd[r][1];
+          v[3 * stride] = bd[r][1] - bd[r][3];
+        }
+      }
+    }
+
+    for (int i = 0; i < 16; ++i) {
+      RowMajorGemm(runtime_state, block_tiles, input_c, output_c,
+                   transformed_input.data() + i * block_size * input_c,
+                   transformed_filter.data() + i * input_c * output_c,
+                   transformed_output.data() + i * block_size * output_c);
+    }
+
+    // Y = A^T M A, clipped to the output bounds for partial edge tiles.
+    for (int t = 0; t < block_tiles; ++t) {
+      const int tile = block_begin + t;
+      const int ho0 = (tile / tiles_w) * 2;
+      const int wo0 = (tile % tiles_w) * 2;
+      for (int co = 0; co < output_c; ++co) {
+        T m[4][4];
+        for (int i = 0; i < 16; ++i) {
+          m[i / 4][i % 4] =
+              transformed_output[(i * block_size + t) * output_c + co];
+        }
+        T am[2][4];
+        for (int c = 0; c < 4; ++c) {
+          am[0][c] = m[0][c] + m[1][c] + m[2][c];
+          am[1][c] = m[1][c] - m[2][c] - m[3][c];
+        }
+        for (int r = 0; r < 2 && ho0 + r < output_h; ++r) {
+          T y[2] = {am[r][0] + am[r][1] + am[r][2],
+                    am[r][1] - am[r][2] - am[r][3]};
+          for (int c = 0; c < 2 && wo0 + c < output_w; ++c) {
+            dst_buffer[((ho0 + r) * output_w + wo0 + c) * output_c + co] = y[c];
+          }
+        }
+      }
+    }
+  }
+  return OkStatus();
+}
+
+// The Winograd transforms are fractional and only exact for floating-point.
+template <typename T>
+Conv2D::Algorithm GetSupportedConv2DAlgorithm(Conv2D::Algorithm algorithm) {
+  if (algorithm == Conv2D::Algorithm::kWinograd &&
+      !std::is_floating_point<T>::value) {
+    return Conv2D::Algorithm::kIm2Col;
+  }
+  return algorithm;
+}
+
+template <typename T>
+std::vector<T> Conv2D::TransformFilter(Algorithm algorithm,
+                                       absl::Span<const T> filter_buffer,
+                                       ShapeSpan filter_shape) {
+  if (GetSupportedConv2DAlgorithm<T>(algorithm) != Algorithm::kWinograd) {
+    return {};
+  }
+  const int input_c = filter_shape[2];
+  const int output_c = filter_shape[3];
+  std::vector<T> transformed_filter(16 * input_c * output_c);
+  Conv2DWinogradTransformFilter(filter_buffer, input_c, output_c,
+                                absl::MakeSpan(transformed_filter));
+  return transformed_filter;
+}
+
+template <typename T>
+Status Conv2D::Execute(MatMul::RuntimeState* runtime_state,
+                       Algorithm algorithm, absl::Span<const T> input_buffer,
+                       ShapeSpan input_shape, absl::Span<const T> filter_buffer,
+                       ShapeSpan filter_shape, absl::Span<T> dst_buffer,
+                       ShapeSpan dst_shape, ShapeSpan strides, ShapeSpan pad_h,
+                       ShapeSpan pad_w, ShapeSpan dilation,
+                       const int32_t groups,
+                       absl::Span<const T> transformed_filter) {
+  algorithm = GetSupportedConv2DAlgorithm<T>(algorithm);
+  switch (algorithm) {
+    case Algorithm::kDirect:
+      return Execute<T>(input_buffer, input_shape, filter_buffer, filter_shape,
+                        dst_buffer, dst_shape, strides, pad_h, pad_w, dilation,
+                        groups, runtime_state->thread_pool);
+    case Algorithm::kGemm1x1:
+      // The HWC input is already a row-major [H * W, Ci] matrix.
+      RowMajorGemm(runtime_state, input_shape[0] * input_shape[1],
+                   input_shape[2], dst_shape[2], input_buffer.data(),
+                   filter_buffer.data(), dst_buffer.data());
+      return OkStatus();
+    case Algorithm::kIm2Col:
+      return Conv2DIm2Col(runtime_state, input_buffer, input_shape,
+                          filter_buffer, filter_shape, dst_buffer, dst_shape,
+                          strides, pad_h, pad_w);
+    case Algorithm::kWinograd: {
+      std::vector<T> filter_storage;
+      if (transformed_filter.empty()) {
+        filter_storage = TransformFilter(algorithm, filter_buffer, filter_shape);
+        transformed_filter = absl::MakeConstSpan(filter_storage);
+      }
+      return Conv2DWinograd(runtime_state, input_buffer, input_shape,
+                            transformed_filter, dst_buffer, dst_shape, pad_h,
+                            pad_w);
+    }
+  }
+  return InvalidArgumentErrorBuilder(IREE_LOC)
+         << "Unknown convolution algorithm " << static_cast<int>(algorithm);
+}
+
+template <typename T>
+Status QuantizedConv2D::Execute(
+    MatMul::RuntimeState* runtime_state, absl::Span<const T> input_buffer,
+    ShapeSpan input_shape, absl::Span<const T> filter_buffer,
+    ShapeSpan filter_shape, absl::Span<T> dst_buffer, ShapeSpan dst_shape,
+    const Params& params, ShapeSpan strides, ShapeSpan pad_h, ShapeSpan pad_w,
+    ShapeSpan dilation, const int32_t groups) {
+  if (groups != 1) {
+    return Execute<T>(input_buffer, input_shape, filter_buffer, filter_shape,
+                      dst_buffer, dst_shape, params, strides, pad_h, pad_w,
+                      dilation, groups, runtime_state->thread_pool);
+  }
+  const int input_h = input_shape[0];
+  const int input_w = input_shape[1];
+  const int input_c = input_shape[2];
+  const int kernel_h = filter_shape[0];
+  const int kernel_w = filter_shape[1];
+  const int output_w = dst_shape[1];
+  const int output_c = dst_shape[2];
+  const int output_size = dst_shape[0] * dst_shape[1];
+  const int patch_size = kernel_h * kernel_w * input_c;
+
+  // The GEMM is computed transposed as [Co, K] x [K, pixels] so that output
+  // channels are the destination rows ruy applies per-channel multipliers to.
+  // All operands are then column-major views of the row-major buffers.
+  ruy::Matrix<T> filter_matrix;
+  filter_matrix.set_data(filter_buffer.data());
+  ruy::MakeSimpleLayout(output_c, patch_size, ruy::Order::kColMajor,
+                        filter_matrix.mutable_layout());
+
+  ruy::MulParams<int32_t, T> mul_params;
+  if (!params.bias.empty()) mul_params.set_bias(params.bias.data());
+  if (params.multiplier_mantissa.size() == 1) {
+    mul_params.set_multiplier_fixedpoint(params.multiplier_mantissa[0]);
+    mul_params.set_multiplier_exponent(params.multiplier_exponent[0]);
+  } else {
+    mul_params.set_multiplier_fixedpoint_perchannel(
+        params.multiplier_mantissa.data());
+    mul_params.set_multiplier_exponent_perchannel(
+        params.multiplier_exponent.data());
+  }
+
+  const int block_size = std::max<int>(
+      1, std::min<int>(output_size,
+                       kConv2DScratchBytes / (patch_size * sizeof(T))));
+  std::vector<T> patches(block_size * patch_size);
+  for (int block_begin = 0; block_begin < output_size;
+       block_begin += block_size) {
+    const int block_end = std::min(block_begin + block_size, output_size);
+    T* patch = patches.data();
+    for (int p = block_begin; p < block_end; ++p) {
+      const int ho = p / output_w;
+      const int wo = p % output_w;
+      for (int kh = 0; kh < kernel_h; ++kh) {
+        const int ih = ho * strides[0] + kh * dilation[0] - pad_h[0];
+        for (int kw = 0; kw < kernel_w; ++kw) {
+          const int iw = wo * strides[1] + kw * dilation[1] - pad_w[0];
+          if (ih < 0 || ih >= input_h || iw < 0 || iw >= input_w) {
+            // Padding must contribute zero after the zero point is removed.
+            std::fill_n(patch, input_c,
+                        static_cast<T>(params.input_zero_point));
+          } else {
+            std::copy_n(input_buffer.data() + (ih * input_w + iw) * input_c,
+                        input_c, patch);
+          }
+          patch += input_c;
+        }
+      }
+    }
+
+    ruy::Matrix<T> patch_matrix;
+    patch_matrix.set_data(patches.data());
+    patch_matrix.set_zero_point(static_cast<T>(params.input_zero_point));
+    ruy::MakeSimpleLayout(patch_size, block_end - block_begin,
+                          ruy::Order::kColMajor,
+                          patch_matrix.mutable_layout());
+
+    ruy::Matrix<T> dst_matrix;
+    dst_matrix.set_data(dst_buffer.data() + block_begin * output_c);
+    dst_matrix.set_zero_point(static_cast<T>(params.dst_zero_point));
+    ruy::MakeSimpleLayout(output_c, block_end - block_begin,
+                          ruy::Order::kColMajor, dst_matrix.mutable_layout());
+
+    ruy::Mul(filter_matrix, patch_matrix, mul_params, &runtime_state->context,
+             &dst_matrix);
+  }
+  return OkStatus();
+}
+
 }  // namespace kernels
 }  // namespace vmla
 }  // namespace hal
@@ -0,0 +1,1476 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Kernels with explicitly vectorized implementations. Each kernel has a
+// portable fallback that is used when the target ISA has no specialization.
+
+#ifndef IREE_HAL_VMLA_OP_KERNELS_SIMD_H_
+#define IREE_HAL_VMLA_OP_KERNELS_SIMD_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "absl/base/attributes.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/types/span.h"
+#include "iree/base/status.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // __SSE2__
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#endif  // __x86_64__ || __i386__
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+
+//===----------------------------------------------------------------------===//
+// Transpose
+//===----------------------------------------------------------------------===//
+
+namespace impl {
+
+// Transposes a |rows| x |cols| tile such that
+// dst[c * dst_stride + r] = src[r * src_stride + c].
+template <typename T>
+inline void TransposeTile(const T* src, size_t src_stride, T* dst,
+                          size_t dst_stride, int rows, int cols) {
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < cols; ++c) {
+      dst[c * dst_stride + r] = src[r * src_stride + c];
+    }
+  }
+}
+
+// Transposes a full 8x8 tile of elements of |kElementSize| bytes.
+template <size_t kElementSize>
+struct TransposeTile8x8 {
+  template <typename T>
+  static void Run(const T* src, size_t src_stride, T* dst, size_t dst_stride) {
+    TransposeTile(src, src_stride, dst, dst_stride, 8, 8);
+  }
+};
+
+#if defined(__SSE2__)
+
+template <>
+struct TransposeTile8x8<4> {
+  template <typename T>
+  static void Run(const T* src, size_t src_stride, T* dst, size_t dst_stride) {
+    // Four 4x4 transposes; the off-diagonal quadrants swap places.
+    for (int qr = 0; qr < 8; qr += 4) {
+      for (int qc = 0; qc < 8; qc += 4) {
+        const T* s = src + qr * src_stride + qc;
+        __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        __m128i r1 = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(s + 1 * src_stride));
+        __m128i r2 = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(s + 2 * src_stride));
+        __m128i r3 = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(s + 3 * src_stride));
+        __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+        __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+        __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+        __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+        T* d = dst + qc * dst_stride + qr;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d),
+                         _mm_unpacklo_epi64(t0, t1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 1 * dst_stride),
+                         _mm_unpackhi_epi64(t0, t1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 2 * dst_stride),
+                         _mm_unpacklo_epi64(t2, t3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 3 * dst_stride),
+                         _mm_unpackhi_epi64(t2, t3));
+      }
+    }
+  }
+};
+
+template <>
+struct TransposeTile8x8<2> {
+  template <typename T>
+  static void Run(const T* src, size_t src_stride, T* dst, size_t dst_stride) {
+    __m128i r[8];
+    for (int i = 0; i < 8; ++i) {
+      r[i] = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(src + i * src_stride));
+    }
+    // Interleave pairs of rows at 16, 32 and then 64 bits.
+    __m128i a[8];
+    for (int i = 0; i < 4; ++i) {
+      a[i * 2 + 0] = _mm_unpacklo_epi16(r[i * 2], r[i * 2 + 1]);
+      a[i * 2 + 1] = _mm_unpackhi_epi16(r[i * 2], r[i * 2 + 1]);
+    }
+    __m128i b[8];
+    for (int i = 0; i < 2; ++i) {
+      b[i * 4 + 0] = _mm_unpacklo_epi32(a[i * 4 + 0], a[i * 4 + 2]);
+      b[i * 4 + 1] = _mm_unpackhi_epi32(a[i * 4 + 0], a[i * 4 + 2]);
+      b[i * 4 + 2] = _mm_unpacklo_epi32(a[i * 4 + 1], a[i * 4 + 3]);
+      b[i * 4 + 3] = _mm_unpackhi_epi32(a[i * 4 + 1], a[i * 4 + 3]);
+    }
+    for (int i = 0; i < 4; ++i) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (i * 2) * dst_stride),
+                       _mm_unpacklo_epi64(b[i], b[i + 4]));
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i*>(dst + (i * 2 + 1) * dst_stride),
+          _mm_unpackhi_epi64(b[i], b[i + 4]));
+    }
+  }
+};
+
+#endif  // __SSE2__
+
+// Transposes a |rows| x |cols| plane in cache-sized blocks of 8x8 tiles.
+template <typename T>
+void TransposePlane(const T* src, size_t src_stride, T* dst, size_t dst_stride,
+                    int rows, int cols) {
+  constexpr int kTileSize = 8;
+  constexpr int kBlockSize = 64;
+  for (int r0 = 0; r0 < rows; r0 += kBlockSize) {
+    const int r1 = std::min(r0 + kBlockSize, rows);
+    for (int c0 = 0; c0 < cols; c0 += kBlockSize) {
+      const int c1 = std::min(c0 + kBlockSize, cols);
+      int r = r0;
+      for (; r + kTileSize <= r1; r += kTileSize) {
+        int c = c0;
+        for (; c + kTileSize <= c1; c += kTileSize) {
+          TransposeTile8x8<sizeof(T)>::Run(src + r * src_stride + c,
+                                           src_stride, dst + c * dst_stride + r,
+                                           dst_stride);
+        }
+        TransposeTile(src + r * src_stride + c, src_stride,
+                      dst + c * dst_stride + r, dst_stride, kTileSize, c1 - c);
+      }
+      TransposeTile(src + r * src_stride + c0, src_stride,
+                    dst + c0 * dst_stride + r, dst_stride, r1 - r, c1 - c0);
+    }
+  }
+}
+
+// Removes unit dimensions and merges dimensions that remain adjacent and in
+// order after the permutation. Any transpose reduces to one with no two
+// consecutive destination dimensions mapping to consecutive source dimensions.
+inline void CollapseTransposeDims(ShapeSpan src_shape,
+                                  absl::Span<const int32_t> perm,
+                                  absl::InlinedVector<int32_t, 8>* shape,
+                                  absl::InlinedVector<int32_t, 8>* new_perm) {
+  // Runs of source dimensions that stay contiguous, in destination order.
+  struct Run {
+    int32_t first_dim;
+    int32_t size;
+  };
+  absl::InlinedVector<Run, 8> runs;
+  int32_t last_dim = -2;
+  for (int32_t dim : perm) {
+    if (src_shape[dim] == 1) continue;
+    // Unit dimensions between two source dimensions don't prevent a merge.
+    bool is_adjacent = !runs.empty() && dim > last_dim;
+    for (int32_t i = last_dim + 1; is_adjacent && i < dim; ++i) {
+      is_adjacent = src_shape[i] == 1;
+    }
+    if (is_adjacent) {
+      runs.back().size *= src_shape[dim];
+    } else {
+      runs.push_back({dim, src_shape[dim]});
+    }
+    last_dim = dim;
+  }
+
+  // Collapsed source dimensions are ordered by their first source dimension.
+  absl::InlinedVector<int32_t, 8> order(runs.size());
+  for (int i = 0; i < order.size(); ++i) order[i] = i;
+  std::sort(order.begin(), order.end(), [&](int32_t lhs, int32_t rhs) {
+    return runs[lhs].first_dim < runs[rhs].first_dim;
+  });
+  shape->resize(runs.size());
+  new_perm->resize(runs.size());
+  for (int i = 0; i < order.size(); ++i) {
+    (*shape)[i] = runs[order[i]].size;
+    (*new_perm)[order[i]] = i;
+  }
+}
+
+}  // namespace impl
+
+template <typename T>
+Status Transpose::Execute(absl::Span<const T> src_buffer,
+                          absl::Span<T> dst_buffer, ShapeSpan src_shape,
+                          absl::Span<const int32_t> perm,
+                          ThreadPool* thread_pool) {
+  absl::InlinedVector<int32_t, 8> shape;
+  absl::InlinedVector<int32_t, 8> collapsed_perm;
+  impl::CollapseTransposeDims(src_shape, perm, &shape, &collapsed_perm);
+  const int rank = shape.size();
+  if (rank <= 1) {
+    // Identity permutation.
+    std::memcpy(dst_buffer.data(), src_buffer.data(),
+                dst_buffer.size() * sizeof(T));
+    return OkStatus();
+  }
+
+  // Strides of each source dimension in the source and destination.
+  absl::InlinedVector<size_t, 8> src_strides(rank);
+  absl::InlinedVector<size_t, 8> dst_strides(rank);
+  size_t src_stride = 1;
+  size_t dst_stride = 1;
+  for (int i = rank - 1; i >= 0; --i) {
+    src_strides[i] = src_stride;
+    src_stride *= shape[i];
+    dst_strides[collapsed_perm[i]] = dst_stride;
+    dst_stride *= shape[collapsed_perm[i]];
+  }
+
+  // The innermost source dimension and the source dimension that becomes
+  // innermost in the destination form the plane that is transposed. If they
+  // are the same the transpose only moves whole rows.
+  const int inner_dim = rank - 1;
+  const int dst_inner_dim = collapsed_perm[rank - 1];
+  const bool moves_rows = inner_dim == dst_inner_dim;
+
+  // Remaining dimensions are iterated in destination order.
+  absl::InlinedVector<int32_t, 8> outer_dims;
+  size_t outer_count = 1;
+  for (int i = 0; i < rank; ++i) {
+    const int dim = collapsed_perm[i];
+    if (dim == inner_dim || dim == dst_inner_dim) continue;
+    outer_dims.push_back(dim);
+    outer_count *= shape[dim];
+  }
+
+  // Work is split into bands of plane rows so that even a single large plane
+  // can be spread across threads.
+  constexpr int kBandRows = 64;
+  const int plane_rows = moves_rows ? 1 : shape[dst_inner_dim];
+  const size_t band_count = (plane_rows + kBandRows - 1) / kBandRows;
+  const size_t band_size =
+      static_cast<size_t>(std::min(plane_rows, kBandRows)) * shape[inner_dim];
+  auto transpose_bands = [&](size_t begin, size_t end) {
+    // Position the outer index at the first band.
+    absl::InlinedVector<int32_t, 8> index(outer_dims.size(), 0);
+    size_t src_offset = 0;
+    size_t dst_offset = 0;
+    size_t n = begin / band_count;
+    for (int i = outer_dims.size() - 1; i >= 0; --i) {
+      const int dim = outer_dims[i];
+      index[i] = n % shape[dim];
+      n /= shape[dim];
+      src_offset += index[i] * src_strides[dim];
+      dst_offset += index[i] * dst_strides[dim];
+    }
+    for (size_t band = begin; band < end; ++band) {
+      if (moves_rows) {
+        std::memcpy(dst_buffer.data() + dst_offset,
+                    src_buffer.data() + src_offset,
+                    shape[inner_dim] * sizeof(T));
+      } else {
+        const int r0 = (band % band_count) * kBandRows;
+        const size_t src_row_stride = src_strides[dst_inner_dim];
+        impl::TransposePlane(src_buffer.data() + src_offset +
+                                 r0 * src_row_stride,
+                             src_row_stride,
+                             dst_buffer.data() + dst_offset + r0,
+                             dst_strides[inner_dim],
+                             std::min(kBandRows, plane_rows - r0),
+                             shape[inner_dim]);
+        if ((band + 1) % band_count != 0) continue;
+      }
+      for (int i = outer_dims.size() - 1; i >= 0; --i) {
+        const int dim = outer_dims[i];
+        src_offset += src_strides[dim];
+        dst_offset += dst_strides[dim];
+        if (++index[i] < shape[dim]) break;
+        src_offset -= src_strides[dim] * shape[dim];
+        dst_offset -= dst_strides[dim] * shape[dim];
+        index[i] = 0;
+      }
+    }
+    return OkStatus();
+  };
+  return ParallelFor(thread_pool, outer_count * band_count,
+                     GetParallelGrain(band_size), transpose_bands);
+}
+
+//===----------------------------------------------------------------------===//
+// Transcendental functions
+//===----------------------------------------------------------------------===//
+//
+// f32 Exp, Log, Rsqrt, Sin, Cos, Tanh, Pow and Atan2 are evaluated with
+// polynomial approximations written once against compiler vector extensions
+// and instantiated for each vector width the target may support. The widest
+// one available is selected at runtime from the CPU features. Lanes with
+// inputs outside of the approximated domain (NaN, infinities, zeros,
+// denormals, etc.) are recomputed with the C++ standard library so that the
+// special-case semantics match the generic kernels exactly.
+//
+// Maximum error versus the correctly rounded result, verified by
+// op_kernels_test.cc:
+//   Exp:   2 ULP        Rsqrt: 1 ULP
+//   Log:   2 ULP        Sin:   1 ULP
+//   Tanh:  3 ULP        Cos:   1 ULP
+//   Atan2: 3 ULP        Pow:   1 ULP
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+#define IREE_VMLA_HAVE_VECTOR_EXTENSIONS 1
+#if defined(__x86_64__) || defined(__i386__)
+#define IREE_VMLA_HAVE_X86_DISPATCH 1
+#define IREE_VMLA_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif  // __x86_64__ || __i386__
+#endif  // (__GNUC__ || __clang__) && !_MSC_VER
+
+namespace impl {
+
+// Vector instruction set used by the vectorized kernels.
+enum class SimdLevel {
+  // No vectorization; the generic C++ implementation is used.
+  kScalar = 0,
+  // 128-bit vectors of the baseline ISA (SSE2, NEON, etc).
+  kBaseline = 1,
+  // 256-bit AVX2 vectors with FMA.
+  kAvx2 = 2,
+};
+
+inline SimdLevel DetectSimdLevel() {
+#if defined(IREE_VMLA_HAVE_X86_DISPATCH)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SimdLevel::kAvx2;
+  }
+  return SimdLevel::kBaseline;
+#elif defined(IREE_VMLA_HAVE_VECTOR_EXTENSIONS)
+  return SimdLevel::kBaseline;
+#else
+  return SimdLevel::kScalar;
+#endif  // IREE_VMLA_HAVE_X86_DISPATCH
+}
+
+// Returns the widest SimdLevel supported by the current CPU.
+inline SimdLevel GetSimdLevel() {
+  static const SimdLevel level = DetectSimdLevel();
+  return level;
+}
+
+#if defined(IREE_VMLA_HAVE_VECTOR_EXTENSIONS)
+
+#define IREE_VMLA_SIMD_INLINE ABSL_ATTRIBUTE_ALWAYS_INLINE inline
+
+// N lanes of T. The native vector is wrapped in a struct so that it never
+// appears directly in a function signature, where its calling convention would
+// depend on the ISA each caller is compiled for.
+template <typename T, int N>
+struct Vec {
+  typedef T Native __attribute__((vector_size(N * sizeof(T))));
+  Native v;
+};
+
+template <typename T>
+struct IntOf;
+template <>
+struct IntOf<float> {
+  using type = int32_t;
+};
+template <>
+struct IntOf<double> {
+  using type = int64_t;
+};
+template <>
+struct IntOf<int32_t> {
+  using type = int32_t;
+};
+template <>
+struct IntOf<int64_t> {
+  using type = int64_t;
+};
+
+template <int N>
+using F32 = Vec<float, N>;
+template <int N>
+using F64 = Vec<double, N>;
+template <int N>
+using I32 = Vec<int32_t, N>;
+template <int N>
+using I64 = Vec<int64_t, N>;
+template <typename T, int N>
+using MaskOf = Vec<typename IntOf<T>::type, N>;
+
+// Prevents deduction of T from scalar operands so that literals of any type
+// may be mixed with vectors.
+template <typename T>
+struct Identity {
+  using type = T;
+};
+
+#define IREE_VMLA_VEC_BINARY_OP(op)                                          \
+  template <typename T, int N>                                               \
+  IREE_VMLA_SIMD_INLINE Vec<T, N> operator op(Vec<T, N> a, Vec<T, N> b) {    \
+    return {a.v op b.v};                                                     \
+  }                                                                          \
+  template <typename T, int N>                                               \
+  IREE_VMLA_SIMD_INLINE Vec<T, N> operator op(                               \
+      Vec<T, N> a, typename Identity<T>::type b) {                           \
+    return {a.v op b};                                                       \
+  }                                                                          \
+  template <typename T, int N>                                               \
+  IREE_VMLA_SIMD_INLINE Vec<T, N> operator op(typename Identity<T>::type a,  \
+                                              Vec<T, N> b) {                 \
+    return {a op b.v};                                                       \
+  }
+IREE_VMLA_VEC_BINARY_OP(+)
+IREE_VMLA_VEC_BINARY_OP(-)
+IREE_VMLA_VEC_BINARY_OP(*)
+IREE_VMLA_VEC_BINARY_OP(/)
+IREE_VMLA_VEC_BINARY_OP(&)
+IREE_VMLA_VEC_BINARY_OP(|)
+IREE_VMLA_VEC_BINARY_OP(^)
+IREE_VMLA_VEC_BINARY_OP(<<)
+IREE_VMLA_VEC_BINARY_OP(>>)
+#undef IREE_VMLA_VEC_BINARY_OP
+
+// Comparisons produce masks with all bits of each lane set when true.
+#define IREE_VMLA_VEC_COMPARE_OP(op)                                         \
+  template <typename T, int N>                                               \
+  IREE_VMLA_SIMD_INLINE MaskOf<T, N> operator op(Vec<T, N> a, Vec<T, N> b) { \
+    return {(typename MaskOf<T, N>::Native)(a.v op b.v)};                    \
+  }                                                                          \
+  template <typename T, int N>                                               \
+  IREE_VMLA_SIMD_INLINE MaskOf<T, N> operator op(                            \
+      Vec<T, N> a, typename Identity<T>::type b) {                           \
+    return {(typename MaskOf<T, N>::Native)(a.v op b)};                      \
+  }
+IREE_VMLA_VEC_COMPARE_OP(==)
+IREE_VMLA_VEC_COMPARE_OP(<)
+IREE_VMLA_VEC_COMPARE_OP(<=)
+IREE_VMLA_VEC_COMPARE_OP(>)
+IREE_VMLA_VEC_COMPARE_OP(>=)
+#undef IREE_VMLA_VEC_COMPARE_OP
+
+template <typename T, int N>
+IREE_VMLA_SIMD_INLINE Vec<T, N> operator~(Vec<T, N> a) {
+  return {~a.v};
+}
+
+template <typename T, int N>
+IREE_VMLA_SIMD_INLINE Vec<T, N> Splat(T value) {
+  typename Vec<T, N>::Native zero = {};
+  return {zero + value};
+}
+
+template <typename T, int N>
+IREE_VMLA_SIMD_INLINE Vec<T, N> Load(const T* ptr) {
+  Vec<T, N> result;
+  std::memcpy(&result.v, ptr, sizeof(result.v));
+  return result;
+}
+
+template <typename T, int N>
+IREE_VMLA_SIMD_INLINE void Store(Vec<T, N> value, T* ptr) {
+  std::memcpy(ptr, &value.v, sizeof(value.v));
+}
+
+// Reinterprets the bits of each lane as U, which must be the same size as T.
+template <typename U, typename T, int N>
+IREE_VMLA_SIMD_INLINE Vec<U, N> BitCast(Vec<T, N> a) {
+  static_assert(sizeof(U) == sizeof(T), "lane sizes must match");
+  return {(typename Vec<U, N>::Native)a.v};
+}
+
+// Converts the value of each lane to U.
+template <typename U, typename T, int N>
+IREE_VMLA_SIMD_INLINE Vec<U, N> Convert(Vec<T, N> a) {
+  return {__builtin_convertvector(a.v, typename Vec<U, N>::Native)};
+}
+
+template <typename T, int N>
+IREE_VMLA_SIMD_INLINE Vec<T, N> Select(MaskOf<T, N> mask, Vec<T, N> a,
+                                       Vec<T, N> b) {
+  using I = typename IntOf<T>::type;
+  return BitCast<T>((mask & BitCast<I>(a)) | (~mask & BitCast<I>(b)));
+}
+
+template <typename T, int N>
+IREE_VMLA_SIMD_INLINE Vec<T, N> Abs(Vec<T, N> a) {
+  using I = typename IntOf<T>::type;
+  return BitCast<T>(BitCast<I>(a) & std::numeric_limits<I>::max());
+}
+
+// Returns |magnitude| with the sign of |sign|.
+template <typename T, int N>
+IREE_VMLA_SIMD_INLINE Vec<T, N> CopySign(Vec<T, N> magnitude,
+                                         Vec<T, N> sign) {
+  using I = typename IntOf<T>::type;
+  const I sign_bit = std::numeric_limits<I>::min();
+  return BitCast<T>((BitCast<I>(magnitude) & ~sign_bit) |
+                    (BitCast<I>(sign) & sign_bit));
+}
+
+template <typename T, int N>
+IREE_VMLA_SIMD_INLINE bool AnyLane(Vec<T, N> mask) {
+  // Reduced in 64-bit words instead of lanes to avoid per-lane extraction.
+  constexpr int kWordCount = (sizeof(mask.v) + 7) / 8;
+  uint64_t words[kWordCount] = {};
+  std::memcpy(words, &mask.v, sizeof(mask.v));
+  uint64_t any = 0;
+  for (int i = 0; i < kWordCount; ++i) any |= words[i];
+  return any != 0;
+}
+
+// Rounds to the nearest integer (ties to even) for |x| < 2^22 by pushing the
+// fraction bits out of the significand.
+template <int N>
+IREE_VMLA_SIMD_INLINE F32<N> Round(F32<N> x) {
+  return (x + 12582912.0f) - 12582912.0f;
+}
+
+// Rounds to the nearest integer for |x| < 2^51 and also returns it as an
+// integer. Conversions between f64 and i64 lanes have no AVX2 instructions so
+// the integer is read directly from the low bits of the significand.
+template <int N>
+IREE_VMLA_SIMD_INLINE F64<N> Round(F64<N> x, I64<N>* integer) {
+  const double kMagic = 6755399441055744.0;  // 1.5 * 2^52
+  F64<N> shifted = x + kMagic;
+  *integer = BitCast<int64_t>(shifted) -
+             BitCast<int64_t>(Splat<double, N>(kMagic));
+  return shifted - kMagic;
+}
+
+// Converts small integers to f64 with the inverse of the Round trick.
+template <int N>
+IREE_VMLA_SIMD_INLINE F64<N> SmallIntToDouble(I64<N> value) {
+  const double kMagic = 6755399441055744.0;  // 1.5 * 2^52
+  return BitCast<double>(value + BitCast<int64_t>(Splat<double, N>(kMagic))) -
+         kMagic;
+}
+
+// exp(x) for x in [-87.3, 88.3].
+template <int N>
+IREE_VMLA_SIMD_INLINE F32<N> ExpInRange(F32<N> x) {
+  // exp(x) = 2^n * exp(r) with r = x - n * ln(2) split to remain exact.
+  F32<N> n = Round(x * 1.44269504088896341f);
+  F32<N> r = (x - n * 0.693359375f) - n * -2.12194440e-4f;
+  F32<N> p = 1.9875691500e-4f * r + 1.3981999507e-3f;
+  p = p * r + 8.3334519073e-3f;
+  p = p * r + 4.1665795894e-2f;
+  p = p * r + 1.6666665459e-1f;
+  p = p * r + 5.0000001201e-1f;
+  F32<N> y = p * (r * r) + r + 1.0f;
+  I32<N> scale = (Convert<int32_t>(n) + 127) << 23;
+  return y * BitCast<float>(scale);
+}
+
+template <int N>
+IREE_VMLA_SIMD_INLINE F32<N> ExpF32(F32<N> x, I32<N>* fixup) {
+  *fixup = ~((x >= -87.3f) & (x <= 88.3f));
+  return ExpInRange(Select(*fixup, Splat<float, N>(0.0f), x));
+}
+
+template <int N>
+IREE_VMLA_SIMD_INLINE F32<N> LogF32(F32<N> x, I32<N>* fixup) {
+  *fixup = ~((x >= std::numeric_limits<float>::min()) &
+             (x < std::numeric_limits<float>::infinity()));
+  x = Select(*fixup, Splat<float, N>(1.0f), x);
+
+  // x = 2^e * m with m in [sqrt(0.5), sqrt(2)).
+  I32<N> bits = BitCast<int32_t>(x);
+  I32<N> e = (bits >> 23) - 126;
+  F32<N> m = BitCast<float>((bits & 0x007fffff) | 0x3f000000);
+  I32<N> is_small = m < 0.707106781186547524f;
+  e = e + is_small;
+  m = m + Select(is_small, m, Splat<float, N>(0.0f)) - 1.0f;
+  F32<N> fe = Convert<float>(e);
+
+  F32<N> z = m * m;
+  F32<N> p = 7.0376836292e-2f * m - 1.1514610310e-1f;
+  p = p * m + 1.1676998740e-1f;
+  p = p * m - 1.2420140846e-1f;
+  p = p * m + 1.4249322787e-1f;
+  p = p * m - 1.6668057665e-1f;
+  p = p * m + 2.0000714765e-1f;
+  p = p * m - 2.4999993993e-1f;
+  p = p * m + 3.3333331174e-1f;
+  F32<N> y = p * m * z;
+  y = y + fe * -2.12194440e-4f;
+  y = y - z * 0.5f;
+  return (m + y) + fe * 0.693359375f;
+}
+
+template <int N>
+IREE_VMLA_SIMD_INLINE F32<N> RsqrtF32(F32<N> x, I32<N>* fixup) {
+  *fixup = ~((x > 0.0f) & (x < std::numeric_limits<float>::infinity()));
+  x = Select(*fixup, Splat<float, N>(1.0f), x);
+
+  // Newton-Raphson in f64 from an initial estimate within 3.5e-3; three steps
+  // leave an error far below f32 precision.
+  F64<N> d = Convert<double>(x);
+  F64<N> y = BitCast<double>(0x5fe6eb50c7b537a9 - (BitCast<int64_t>(d) >> 1));
+  F64<N> half_d = d * 0.5;
+  for (int i = 0; i < 3; ++i) {
+    y = y * (1.5 - half_d * y * y);
+  }
+  return Convert<float>(y);
+}
+
+// Reduces |x| to r in [-pi/4, pi/4] with |x| = quadrant * pi/2 + r. The
+// reduction is done in f64 so that r stays accurate near multiples of pi/2.
+template <int N>
+IREE_VMLA_SIMD_INLINE F32<N> ReduceQuadrant(F32<N> x, F32<N>* quadrant) {
+  F64<N> ax = Convert<double>(Abs(x));
+  I64<N> integer_q;
+  F64<N> q = Round(ax * 6.36619772367581382433e-01, &integer_q);
+  // pi/2 is split so that q * kPio2Hi is exact for q < 2^20.
+  const double kPio2Hi = 1.57079632673412561417e+00;
+  const double kPio2Lo = 6.07710050650619224932e-11;
+  *quadrant = Convert<float>(q);
+  return Convert<float>((ax - q * kPio2Hi) - q * kPio2Lo);
+}
+
+// Returns sin(r) and cos(r) for r in [-pi/4, pi/4].
+template <int N>
+IREE_VMLA_SIMD_INLINE void SinCosInRange(F32<N> r, F32<N>* sin_r,
+                                         F32<N>* cos_r) {
+  F32<N> z = r * r;
+  F32<N> s = -1.9515295891e-4f * z + 8.3321608736e-3f;
+  s = s * z - 1.6666654611e-1f;
+  *sin_r = s * z * r + r;
+  F32<N> c = 2.443315711809948e-5f * z - 1.388731625493765e-3f;
+  c = c * z + 4.166664568298827e-2f;
+  *cos_r = c * z * z - 0.5f * z + 1.0f;
+}
+
+// Returns |value| negated in lanes where |mask| is set.
+template <int N>
+IREE_VMLA_SIMD_INLINE F32<N> NegateIf(I32<N> mask, F32<N> value) {
+  return BitCast<float>(BitCast<int32_t>(value) ^
+                        (mask & std::numeric_limits<int32_t>::min()));
+}
+
+// Returns quadrant modulo 4 for integral quadrants in [0, 2^22).
+template <int N>
+IREE_VMLA_SIMD_INLINE F32<N> QuadrantMod4(F32<N> quadrant) {
+  return quadrant - 4.0f * Round(quadrant * 0.25f - 0.375f);
+}
+
+template <int N>
+IREE_VMLA_SIMD_INLINE F32<N> SinF32(F32<N> x, I32<N>* fixup) {
+  *fixup = ~(Abs(x) <= 65536.0f);
+  x = Select(*fixup, Splat<float, N>(0.0f), x);
+  F32<N> quadrant;
+  F32<N> sin_r, cos_r;
+  SinCosInRange(ReduceQuadrant(x, &quadrant), &sin_r, &cos_r);
+  // Quadrants 1 and 3 use cos(r) and quadrants 2 and 3 negate the result.
+  F32<N> k = QuadrantMod4(quadrant);
+  F32<N> y = Select((k == 1.0f) | (k == 3.0f), cos_r, sin_r);
+  y = NegateIf(k >= 2.0f, y);
+  // sin(-x) = -sin(x).
+  return NegateIf(BitCast<int32_t>(x) < 0, y);
+}
+
+template <int N>
+IREE_VMLA_SIMD_INLINE F32<N> CosF32(F32<N> x, I32<N>* fixup) {
+  *fixup = ~(Abs(x) <= 65536.0f);
+  x = Select(*fixup, Splat<float, N>(0.0f), x);
+  F32<N> quadrant;
+  F32<N> sin_r, cos_r;
+  SinCosInRange(ReduceQuadrant(x, &quadrant), &sin_r, &cos_r);
+  // Quadrants 1 and 3 use sin(r) and quadrants 1 and 2 negate the result.
+  F32<N> k = QuadrantMod4(quadrant);
+  F32<N> y = Select((k == 1.0f) | (k == 3.0f), sin_r, cos_r);
+  return NegateIf((k == 1.0f) | (k == 2.0f), y);
+}
+
+template <int N>
+IREE_VMLA_SIMD_INLINE F32<N> TanhF32(F32<N> x, I32<N>* fixup) {
+  *fixup = ~(x == x);
+  x = Select(*fixup, Splat<float, N>(0.0f), x);
+
+  // Odd polynomial near zero where 1 - 2 / (exp(2x) + 1) cancels badly.
+  F32<N> z = x * x;
+  F32<N> p = -5.70498872745e-3f * z + 2.06390887954e-2f;
+  p = p * z - 5.37397155531e-2f;
+  p = p * z + 1.33314422036e-1f;
+  p = p * z - 3.33332819422e-1f;
+  F32<N> small_y = p * z * x + x;
+
+  // tanh(x) rounds to 1 for |x| >= 10.
+  F32<N> ax = Abs(x);
+  ax = Select(ax < 10.0f, ax, Splat<float, N>(10.0f));
+  F32<N> large_y = 1.0f - 2.0f / (ExpInRange(ax + ax) + 1.0f);
+  return Select(ax < 0.625f, small_y, CopySign(large_y, x));
+}
+
+template <int N>
+IREE_VMLA_SIMD_INLINE F32<N> PowF32(F32<N> x, F32<N> y, I32<N>* fixup) {
+  const float kInfinity = std::numeric_limits<float>::infinity();
+  *fixup = ~((x > 0.0f) & (x < kInfinity) & (Abs(y) < kInfinity));
+  x = Select(*fixup, Splat<float, N>(1.0f), x);
+  y = Select(*fixup, Splat<float, N>(1.0f), y);
+
+  // log(x) in f64 so that y * log(x) keeps enough bits for any f32 result:
+  // x = 2^e * m with m in [sqrt(0.5), sqrt(2)) and
+  // log(m) = 2 * atanh(s) with s = (m - 1) / (m + 1), |s| < 0.172.
+  F64<N> d = Convert<double>(x);
+  I64<N> bits = BitCast<int64_t>(d);
+  I64<N> e = (bits >> 52) - 1023;
+  F64<N> m = BitCast<double>((bits & 0x000fffffffffffff) | 0x3ff0000000000000);
+  I64<N> is_large = m > 1.41421356237309504880;
+  e = e - is_large;
+  m = Select(is_large, m * 0.5, m);
+  F64<N> s = (m - 1.0) / (m + 1.0);
+  F64<N> s2 = s * s;
+  F64<N> p = 1.0 / 13 * s2 + 1.0 / 11;
+  p = p * s2 + 1.0 / 9;
+  p = p * s2 + 1.0 / 7;
+  p = p * s2 + 1.0 / 5;
+  p = p * s2 + 1.0 / 3;
+  p = p * s2 + 1.0;
+  F64<N> log_x = SmallIntToDouble(e) * 6.93147180559945286227e-01 + 2.0 * s * p;
+
+  // exp(t) in f64; results outside of the f32 range saturate to infinity or
+  // zero when converted back.
+  F64<N> t = Convert<double>(y) * log_x;
+  t = Select(t < 100.0, t, Splat<double, N>(100.0));
+  t = Select(t > -150.0, t, Splat<double, N>(-150.0));
+  I64<N> n;
+  F64<N> fn = Round(t * 1.44269504088896338700e+00, &n);
+  F64<N> r = (t - fn * 6.93147180369123816490e-01) -
+             fn * 1.90821492927058770002e-10;
+  F64<N> q = 1.0 / 3628800 * r + 1.0 / 362880;
+  q = q * r + 1.0 / 40320;
+  q = q * r + 1.0 / 5040;
+  q = q * r + 1.0 / 720;
+  q = q * r + 1.0 / 120;
+  q = q * r + 1.0 / 24;
+  q = q * r + 1.0 / 6;
+  q = q * r + 0.5;
+  q = q * r + 1.0;
+  q = q * r + 1.0;
+  return Convert<float>(q * BitCast<double>((n + 1023) << 52));
+}
+
+template <int N>
+IREE_VMLA_SIMD_INLINE F32<N> Atan2F32(F32<N> y, F32<N> x, I32<N>* fixup) {
+  const float kInfinity = std::numeric_limits<float>::infinity();
+  F32<N> ax = Abs(x);
+  F32<N> ay = Abs(y);
+  *fixup = ~((ax < kInfinity) & (ay < kInfinity) & ((ax > 0.0f) | (ay > 0.0f)));
+  ax = Select(*fixup, Splat<float, N>(1.0f), ax);
+  ay = Select(*fixup, Splat<float, N>(1.0f), ay);
+
+  // atan(a) for a = min / max in [0, 1], reduced further to |a| <= tan(pi/8)
+  // with atan(a) = pi/4 + atan((a - 1) / (a + 1)).
+  I32<N> is_steep = ay > ax;
+  F32<N> a = Select(is_steep, ax, ay) / Select(is_steep, ay, ax);
+  I32<N> is_large = a > 0.414213562373095f;
+  a = Select(is_large, (a - 1.0f) / (a + 1.0f), a);
+  F32<N> z = a * a;
+  F32<N> p = 8.05374449538e-2f * z - 1.38776856032e-1f;
+  p = p * z + 1.99777106478e-1f;
+  p = p * z - 3.33329491539e-1f;
+  F32<N> r = p * z * a + a;
+  r = r + Select(is_large, Splat<float, N>(0.785398163397448f),
+                 Splat<float, N>(0.0f));
+
+  // Map back to the octant and quadrant of (x, y).
+  r = Select(is_steep, 1.57079632679489662f - r, r);
+  r = Select(x < 0.0f, 3.14159265358979324f - r, r);
+  return CopySign(r, y);
+}
+
+#endif  // IREE_VMLA_HAVE_VECTOR_EXTENSIONS
+
+// Elementwise ops with the generic implementation as reference, also used for
+// lanes that need special case handling.
+#if defined(IREE_VMLA_HAVE_VECTOR_EXTENSIONS)
+#define IREE_VMLA_UNARY_MATH_OP(name, reference)                        \
+  struct name##Op {                                                     \
+    static float Reference(float x) { return reference; }               \
+    template <int N>                                                    \
+    IREE_VMLA_SIMD_INLINE static F32<N> Apply(F32<N> x, I32<N>* fixup) { \
+      return name##F32(x, fixup);                                       \
+    }                                                                   \
+  };
+#define IREE_VMLA_BINARY_MATH_OP(name, reference)                        \
+  struct name##Op {                                                      \
+    static float Reference(float a, float b) { return reference; }       \
+    template <int N>                                                     \
+    IREE_VMLA_SIMD_INLINE static F32<N> Apply(F32<N> a, F32<N> b,        \
+                                              I32<N>* fixup) {           \
+      return name##F32(a, b, fixup);                                     \
+    }                                                                    \
+  };
+#else
+#define IREE_VMLA_UNARY_MATH_OP(name, reference)          \
+  struct name##Op {                                       \
+    static float Reference(float x) { return reference; } \
+  };
+#define IREE_VMLA_BINARY_MATH_OP(name, reference)                  \
+  struct name##Op {                                                \
+    static float Reference(float a, float b) { return reference; } \
+  };
+#endif  // IREE_VMLA_HAVE_VECTOR_EXTENSIONS
+IREE_VMLA_UNARY_MATH_OP(Exp, std::exp(x));
+IREE_VMLA_UNARY_MATH_OP(Log, std::log(x));
+IREE_VMLA_UNARY_MATH_OP(Rsqrt, 1.0 / std::sqrt(x));
+IREE_VMLA_UNARY_MATH_OP(Sin, std::sin(x));
+IREE_VMLA_UNARY_MATH_OP(Cos, std::cos(x));
+IREE_VMLA_UNARY_MATH_OP(Tanh, std::tanh(x));
+IREE_VMLA_BINARY_MATH_OP(Pow, std::pow(a, b));
+IREE_VMLA_BINARY_MATH_OP(Atan2, std::atan2(a, b));
+#undef IREE_VMLA_UNARY_MATH_OP
+#undef IREE_VMLA_BINARY_MATH_OP
+
+#if defined(IREE_VMLA_HAVE_VECTOR_EXTENSIONS)
+
+// Applies Op to |count| elements using N-wide vectors, returning the number
+// of elements processed. Lanes flagged by the approximation are recomputed
+// with the reference implementation.
+template <typename Op, int N>
+IREE_VMLA_SIMD_INLINE size_t MapUnaryLanes(const float* src, float* dst,
+                                           size_t count) {
+  size_t i = 0;
+  for (; i + N <= count; i += N) {
+    F32<N> x = Load<float, N>(src + i);
+    I32<N> fixup;
+    F32<N> y = Op::template Apply<N>(x, &fixup);
+    Store(y, dst + i);
+    if (AnyLane(fixup)) {
+      for (int j = 0; j < N; ++j) {
+        if (fixup.v[j]) dst[i + j] = Op::Reference(x.v[j]);
+      }
+    }
+  }
+  return i;
+}
+
+template <typename Op, int N>
+IREE_VMLA_SIMD_INLINE size_t MapBinaryLanes(const float* lhs, const float* rhs,
+                                            float* dst, size_t count) {
+  size_t i = 0;
+  for (; i + N <= count; i += N) {
+    F32<N> a = Load<float, N>(lhs + i);
+    F32<N> b = Load<float, N>(rhs + i);
+    I32<N> fixup;
+    F32<N> y = Op::template Apply<N>(a, b, &fixup);
+    Store(y, dst + i);
+    if (AnyLane(fixup)) {
+      for (int j = 0; j < N; ++j) {
+        if (fixup.v[j]) dst[i + j] = Op::Reference(a.v[j], b.v[j]);
+      }
+    }
+  }
+  return i;
+}
+
+template <typename Op>
+void MapUnaryBaseline(const float* src, float* dst, size_t count) {
+  size_t i = MapUnaryLanes<Op, 4>(src, dst, count);
+  MapUnaryLanes<Op, 1>(src + i, dst + i, count - i);
+}
+
+template <typename Op>
+void MapBinaryBaseline(const float* lhs, const float* rhs, float* dst,
+                       size_t count) {
+  size_t i = MapBinaryLanes<Op, 4>(lhs, rhs, dst, count);
+  MapBinaryLanes<Op, 1>(lhs + i, rhs + i, dst + i, count - i);
+}
+
+#if defined(IREE_VMLA_HAVE_X86_DISPATCH)
+
+template <typename Op>
+IREE_VMLA_TARGET_AVX2 void MapUnaryAvx2(const float* src, float* dst,
+                                        size_t count) {
+  size_t i = MapUnaryLanes<Op, 8>(src, dst, count);
+  MapUnaryLanes<Op, 1>(src + i, dst + i, count - i);
+}
+
+template <typename Op>
+IREE_VMLA_TARGET_AVX2 void MapBinaryAvx2(const float* lhs, const float* rhs,
+                                         float* dst, size_t count) {
+  size_t i = MapBinaryLanes<Op, 8>(lhs, rhs, dst, count);
+  MapBinaryLanes<Op, 1>(lhs + i, rhs + i, dst + i, count - i);
+}
+
+#endif  // IREE_VMLA_HAVE_X86_DISPATCH
+
+#endif  // IREE_VMLA_HAVE_VECTOR_EXTENSIONS
+
+// Applies Op to each element using the vectors of |level|, which must be
+// supported by the current CPU.
+template <typename Op>
+void MapUnary(SimdLevel level, const float* src, float* dst, size_t count) {
+  switch (level) {
+#if defined(IREE_VMLA_HAVE_X86_DISPATCH)
+    case SimdLevel::kAvx2:
+      return MapUnaryAvx2<Op>(src, dst, count);
+#endif  // IREE_VMLA_HAVE_X86_DISPATCH
+#if defined(IREE_VMLA_HAVE_VECTOR_EXTENSIONS)
+    case SimdLevel::kBaseline:
+      return MapUnaryBaseline<Op>(src, dst, count);
+#endif  // IREE_VMLA_HAVE_VECTOR_EXTENSIONS
+    default:
+      for (size_t i = 0; i < count; ++i) dst[i] = Op::Reference(src[i]);
+      return;
+  }
+}
+
+template <typename Op>
+void MapBinary(SimdLevel level, const float* lhs, const float* rhs, float* dst,
+               size_t count) {
+  switch (level) {
+#if defined(IREE_VMLA_HAVE_X86_DISPATCH)
+    case SimdLevel::kAvx2:
+      return MapBinaryAvx2<Op>(lhs, rhs, dst, count);
+#endif  // IREE_VMLA_HAVE_X86_DISPATCH
+#if defined(IREE_VMLA_HAVE_VECTOR_EXTENSIONS)
+    case SimdLevel::kBaseline:
+      return MapBinaryBaseline<Op>(lhs, rhs, dst, count);
+#endif  // IREE_VMLA_HAVE_VECTOR_EXTENSIONS
+    default:
+      for (size_t i = 0; i < count; ++i) {
+        dst[i] = Op::Reference(lhs[i], rhs[i]);
+      }
+      return;
+  }
+}
+
+}  // namespace impl
+
+template <>
+inline Status Exp::Execute<float>(absl::Span<const float> src_buffer,
+                                  absl::Span<float> dst_buffer) {
+  impl::MapUnary<impl::ExpOp>(impl::GetSimdLevel(), src_buffer.data(),
+                            dst_buffer.data(), dst_buffer.size());
+  return OkStatus();
+}
+
+template <>
+inline Status Log::Execute<float>(absl::Span<const float> src_buffer,
+                                  absl::Span<float> dst_buffer) {
+  impl::MapUnary<impl::LogOp>(impl::GetSimdLevel(), src_buffer.data(),
+                            dst_buffer.data(), dst_buffer.size());
+  return OkStatus();
+}
+
+template <>
+inline Status Rsqrt::Execute<float>(absl::Span<const float> src_buffer,
+                                    absl::Span<float> dst_buffer) {
+  impl::MapUnary<impl::RsqrtOp>(impl::GetSimdLevel(), src_buffer.data(),
+                              dst_buffer.data(), dst_buffer.size());
+  return OkStatus();
+}
+
+template <>
+inline Status Sin::Execute<float>(absl::Span<const float> src_buffer,
+                                  absl::Span<float> dst_buffer) {
+  impl::MapUnary<impl::SinOp>(impl::GetSimdLevel(), src_buffer.data(),
+                            dst_buffer.data(), dst_buffer.size());
+  return OkStatus();
+}
+
+template <>
+inline Status Cos::Execute<float>(absl::Span<const float> src_buffer,
+                                  absl::Span<float> dst_buffer) {
+  impl::MapUnary<impl::CosOp>(impl::GetSimdLevel(), src_buffer.data(),
+                            dst_buffer.data(), dst_buffer.size());
+  return OkStatus();
+}
+
+template <>
+inline Status Tanh::Execute<float>(absl::Span<const float> src_buffer,
+                                   absl::Span<float> dst_buffer) {
+  impl::MapUnary<impl::TanhOp>(impl::GetSimdLevel(), src_buffer.data(),
+                             dst_buffer.data(), dst_buffer.size());
+  return OkStatus();
+}
+
+template <>
+inline Status Pow::Execute<float>(absl::Span<const float> lhs_buffer,
+                                  absl::Span<const float> rhs_buffer,
+                                  absl::Span<float> dst_buffer) {
+  impl::MapBinary<impl::PowOp>(impl::GetSimdLevel(), lhs_buffer.data(),
+                             rhs_buffer.data(), dst_buffer.data(),
+                             dst_buffer.size());
+  return OkStatus();
+}
+
+template <>
+inline Status Atan2::Execute<float>(absl::Span<const float> lhs_buffer,
+                                    absl::Span<const float> rhs_buffer,
+                                    absl::Span<float> dst_buffer) {
+  impl::MapBinary<impl::Atan2Op>(impl::GetSimdLevel(), lhs_buffer.data(),
+                               rhs_buffer.data(), dst_buffer.data(),
+                               dst_buffer.size());
+  return OkStatus();
+}
+
+//===----------------------------------------------------------------------===//
+// Reductions
+//===----------------------------------------------------------------------===//
+//
+// f32 reductions accumulate in vector lanes, both horizontally along the
+// innermost axis and row-wise when reducing an outer axis. Min and max match
+// the generic kernels exactly: NaN inputs are skipped and a NaN init value
+// propagates, as with std::min/std::max. Sums are evaluated pairwise, which
+// bounds the rounding error growth to O(log n) instead of the O(n) of
+// sequential accumulation at no cost in throughput.
+
+namespace impl {
+
+#if defined(IREE_VMLA_HAVE_VECTOR_EXTENSIONS)
+
+// Lane-wise equivalents of the scalar reduction kernels.
+template <typename KernelImpl>
+struct LaneKernel;
+
+template <>
+struct LaneKernel<SumKernel> {
+  template <int N>
+  IREE_VMLA_SIMD_INLINE static F32<N> Apply(F32<N> acc, F32<N> x) {
+    return acc + x;
+  }
+};
+
+template <>
+struct LaneKernel<MinKernel> {
+  template <int N>
+  IREE_VMLA_SIMD_INLINE static F32<N> Apply(F32<N> acc, F32<N> x) {
+    return Select(x < acc, x, acc);
+  }
+};
+
+template <>
+struct LaneKernel<MaxKernel> {
+  template <int N>
+  IREE_VMLA_SIMD_INLINE static F32<N> Apply(F32<N> acc, F32<N> x) {
+    return Select(acc < x, x, acc);
+  }
+};
+
+// Accumulates |count| elements of |src| into |dst| elementwise.
+template <typename KernelImpl, int N>
+IREE_VMLA_SIMD_INLINE void AccumulateRow(const float* src, float* dst,
+                                         size_t count) {
+  size_t i = 0;
+  for (; i + N <= count; i += N) {
+    Store(LaneKernel<KernelImpl>::template Apply<N>(Load<float, N>(dst + i),
+                                                    Load<float, N>(src + i)),
+          dst + i);
+  }
+  for (; i < count; ++i) KernelImpl()(&dst[i], src[i]);
+}
+
+// Upper bound on the number of partial sums live during pairwise summation.
+constexpr int kMaxPairwiseDepth = 64;
+
+// Reduces |count| contiguous elements into |*value| with independent lane
+// accumulators that are combined once at the end.
+template <typename KernelImpl, int N>
+struct ReduceInnermostLanes {
+  IREE_VMLA_SIMD_INLINE static void Run(const float* src, size_t count,
+                                        float* value) {
+    size_t i = 0;
+    if (count >= 4 * N) {
+      F32<N> acc[4];
+      for (int j = 0; j < 4; ++j) acc[j] = Splat<float, N>(*value);
+      for (; i + 4 * N <= count; i += 4 * N) {
+        for (int j = 0; j < 4; ++j) {
+          acc[j] = LaneKernel<KernelImpl>::template Apply<N>(
+              acc[j], Load<float, N>(src + i + j * N));
+        }
+      }
+      F32<N> lanes = LaneKernel<KernelImpl>::template Apply<N>(
+          LaneKernel<KernelImpl>::template Apply<N>(acc[0], acc[1]),
+          LaneKernel<KernelImpl>::template Apply<N>(acc[2], acc[3]));
+      for (int j = 0; j < N; ++j) KernelImpl()(value, lanes.v[j]);
+    }
+    for (; i < count; ++i) KernelImpl()(value, src[i]);
+  }
+};
+
+// Sums blocks of 16 vectors into lane partials and combines the partials of
+// equally sized runs of blocks as they complete, as in a binary counter. This
+// evaluates the pairwise summation tree iteratively in a single pass.
+template <int N>
+struct ReduceInnermostLanes<SumKernel, N> {
+  IREE_VMLA_SIMD_INLINE static void Run(const float* src, size_t count,
+                                        float* value) {
+    constexpr size_t kBlockSize = 16 * N;
+    F32<N> partials[kMaxPairwiseDepth];
+    int depth = 0;
+    uint64_t block_count = 0;
+    size_t i = 0;
+    for (; i + kBlockSize <= count; i += kBlockSize) {
+      F32<N> acc[4];
+      for (int j = 0; j < 4; ++j) acc[j] = Load<float, N>(src + i + j * N);
+      for (size_t k = 4 * N; k < kBlockSize; k += 4 * N) {
+        for (int j = 0; j < 4; ++j) {
+          acc[j] = acc[j] + Load<float, N>(src + i + k + j * N);
+        }
+      }
+      F32<N> block = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+      for (uint64_t carry = block_count++; carry & 1; carry >>= 1) {
+        block = partials[--depth] + block;
+      }
+      partials[depth++] = block;
+    }
+    float sum = 0.0f;
+    if (depth > 0) {
+      F32<N> total = partials[--depth];
+      while (depth > 0) total = partials[--depth] + total;
+      for (int width = N / 2; width > 0; width /= 2) {
+        for (int j = 0; j < width; ++j) total.v[j] += total.v[j + width];
+      }
+      sum = total.v[0];
+    }
+    float tail = 0.0f;
+    for (; i < count; ++i) tail += src[i];
+    *value += sum + tail;
+  }
+};
+
+// Number of columns reduced together when reducing an outer axis. Each row of
+// a tile is streamed contiguously while the destination stays in L1.
+constexpr size_t kReduceColumnTile = 512;
+
+template <typename KernelImpl, int N>
+struct ReduceRowsLanes {
+  IREE_VMLA_SIMD_INLINE static void Run(const float* src, size_t rows,
+                                        size_t inner, size_t stride,
+                                        float* dst) {
+    for (size_t c = 0; c < inner; c += kReduceColumnTile) {
+      size_t width = std::min(kReduceColumnTile, inner - c);
+      for (size_t r = 0; r < rows; ++r) {
+        AccumulateRow<KernelImpl, N>(src + r * stride + c, dst + c, width);
+      }
+    }
+  }
+};
+
+// Sums blocks of rows into partial rows combined pairwise as with
+// ReduceInnermostLanes<SumKernel>. |scratch| holds one partial row per level
+// of the summation tree.
+template <int N>
+struct ReduceRowsLanes<SumKernel, N> {
+  IREE_VMLA_SIMD_INLINE static void Run(const float* src, size_t rows,
+                                        size_t inner, size_t stride,
+                                        float* dst) {
+    constexpr size_t kBlockRows = 8;
+    int max_depth = 1;
+    for (size_t blocks = (rows + kBlockRows - 1) / kBlockRows; blocks > 1;
+         blocks /= 2) {
+      ++max_depth;
+    }
+    absl::InlinedVector<float, 4 * kReduceColumnTile> scratch(
+        max_depth * std::min(kReduceColumnTile, inner));
+    for (size_t c = 0; c < inner; c += kReduceColumnTile) {
+      size_t width = std::min(kReduceColumnTile, inner - c);
+      int depth = 0;
+      uint64_t block_count = 0;
+      for (size_t r = 0; r < rows; r += kBlockRows) {
+        float* block = scratch.data() + depth * width;
+        std::memcpy(block, src + r * stride + c, width * sizeof(float));
+        for (size_t br = r + 1; br < std::min(r + kBlockRows, rows); ++br) {
+          AccumulateRow<SumKernel, N>(src + br * stride + c, block, width);
+        }
+        for (uint64_t carry = block_count++; carry & 1; carry >>= 1) {
+          float* partial = scratch.data() + --depth * width;
+          AccumulateRow<SumKernel, N>(block, partial, width);
+          block = partial;
+        }
+        ++depth;
+      }
+      while (--depth > 0) {
+        AccumulateRow<SumKernel, N>(scratch.data() + depth * width,
+                                    scratch.data() + (depth - 1) * width,
+                                    width);
+      }
+      AccumulateRow<SumKernel, N>(scratch.data(), dst + c, width);
+    }
+  }
+};
+
+template <typename KernelImpl>
+void ReduceInnermostBaseline(const float* src, size_t count, float* value) {
+  ReduceInnermostLanes<KernelImpl, 4>::Run(src, count, value);
+}
+
+template <typename KernelImpl>
+void ReduceRowsBaseline(const float* src, size_t rows, size_t inner,
+                        size_t stride, float* dst) {
+  ReduceRowsLanes<KernelImpl, 4>::Run(src, rows, inner, stride, dst);
+}
+
+#if defined(IREE_VMLA_HAVE_X86_DISPATCH)
+
+template <typename KernelImpl>
+IREE_VMLA_TARGET_AVX2 void ReduceInnermostAvx2(const float* src, size_t count,
+                                               float* value) {
+  ReduceInnermostLanes<KernelImpl, 8>::Run(src, count, value);
+}
+
+template <typename KernelImpl>
+IREE_VMLA_TARGET_AVX2 void ReduceRowsAvx2(const float* src, size_t rows,
+                                          size_t inner, size_t stride,
+                                          float* dst) {
+  ReduceRowsLanes<KernelImpl, 8>::Run(src, rows, inner, stride, dst);
+}
+
+#endif  // IREE_VMLA_HAVE_X86_DISPATCH
+
+template <typename KernelImpl>
+struct ReduceInnermost<float, KernelImpl> {
+  static void Run(const float* src, size_t count, float* value) {
+    switch (GetSimdLevel()) {
+#if defined(IREE_VMLA_HAVE_X86_DISPATCH)
+      case SimdLevel::kAvx2:
+        return ReduceInnermostAvx2<KernelImpl>(src, count, value);
+#endif  // IREE_VMLA_HAVE_X86_DISPATCH
+      default:
+        return ReduceInnermostBaseline<KernelImpl>(src, count, value);
+    }
+  }
+};
+
+template <typename KernelImpl>
+struct ReduceRows<float, KernelImpl> {
+  static void Run(const float* src, size_t rows, size_t inner, size_t stride,
+                  float* dst) {
+    switch (GetSimdLevel()) {
+#if defined(IREE_VMLA_HAVE_X86_DISPATCH)
+      case SimdLevel::kAvx2:
+        return ReduceRowsAvx2<KernelImpl>(src, rows, inner, stride, dst);
+#endif  // IREE_VMLA_HAVE_X86_DISPATCH
+      default:
+        return ReduceRowsBaseline<KernelImpl>(src, rows, inner, stride, dst);
+    }
+  }
+};
+
+#endif  // IREE_VMLA_HAVE_VECTOR_EXTENSIONS
+
+}  // namespace impl
+
+//===----------------------------------------------------------------------===//
+// 16-bit float conversion
+//===----------------------------------------------------------------------===//
+
+// Conversions use F16C and AVX-512 BF16 when the CPU supports them and
+// otherwise SSE2 or the scalar Half/BFloat16 routines. All paths round to
+// nearest even and produce identical results on every CPU.
+
+#if defined(IREE_VMLA_HAVE_X86_DISPATCH)
+#define IREE_VMLA_TARGET_F16C __attribute__((target("avx,f16c")))
+#if (defined(__clang__) && __clang_major__ >= 9) || \
+    (!defined(__clang__) && __GNUC__ >= 10)
+#define IREE_VMLA_HAVE_AVX512BF16 1
+#define IREE_VMLA_TARGET_AVX512BF16 \
+  __attribute__((target("avx512f,avx512bf16")))
+#endif  // clang >= 9 || gcc >= 10
+#endif  // IREE_VMLA_HAVE_X86_DISPATCH
+
+namespace impl {
+
+#if defined(IREE_VMLA_HAVE_X86_DISPATCH)
+
+inline bool HasF16C() {
+  static const bool has_f16c = [] {
+    __builtin_cpu_init();
+    unsigned int eax, ebx, ecx, edx;
+    return __builtin_cpu_supports("avx") &&
+           __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_F16C) != 0;
+  }();
+  return has_f16c;
+}
+
+// Each routine converts the largest multiple of its vector width and returns
+// the number of elements converted.
+
+IREE_VMLA_TARGET_F16C inline size_t WidenHalfF16C(const Half* src, float* dst,
+                                                  size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+  }
+  return i;
+}
+
+IREE_VMLA_TARGET_F16C inline size_t NarrowHalfF16C(const float* src,
+                                                   Half* dst, size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i h =
+        _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+  }
+  return i;
+}
+
+#if defined(IREE_VMLA_HAVE_AVX512BF16)
+
+inline bool HasAvx512Bf16() {
+  static const bool has_avx512bf16 = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512bf16") != 0;
+  }();
+  return has_avx512bf16;
+}
+
+IREE_VMLA_TARGET_AVX512BF16 inline size_t NarrowBFloat16Avx512(
+    const float* src, BFloat16* dst, size_t count) {
+  const __m512i exponent_mask = _mm512_set1_epi32(0x7F800000);
+  const __m512i mantissa_mask = _mm512_set1_epi32(0x007FFFFF);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m512 f = _mm512_loadu_ps(src + i);
+    __m256bh h = _mm512_cvtneps_pbh(f);
+    std::memcpy(dst + i, &h, sizeof(h));
+    // The instruction flushes subnormal inputs to zero; redo those (rare)
+    // lanes with the scalar rounding so results don't depend on the CPU.
+    __m512i bits = _mm512_castps_si512(f);
+    __mmask16 subnormal = _mm512_testn_epi32_mask(bits, exponent_mask) &
+                          _mm512_test_epi32_mask(bits, mantissa_mask);
+    while (subnormal) {
+      const int lane = __builtin_ctz(subnormal);
+      dst[i + lane] = BFloat16(src[i + lane]);
+      subnormal &= subnormal - 1;
+    }
+  }
+  return i;
+}
+
+#endif  // IREE_VMLA_HAVE_AVX512BF16
+
+#endif  // IREE_VMLA_HAVE_X86_DISPATCH
+
+#if defined(__SSE2__)
+
+inline size_t WidenBFloat16Sse2(const BFloat16* src, float* dst,
+                                size_t count) {
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    // Interleaving zeros below each value shifts it into the upper half.
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_unpacklo_epi16(zero, h));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4),
+                     _mm_unpackhi_epi16(zero, h));
+  }
+  return i;
+}
+
+// Rounds 4 floats to bfloat16 as BFloat16::FromFloat, returning the results
+// sign extended to 32 bits.
+inline __m128i RoundToBFloat16Sse2(__m128i f) {
+  const __m128i lsb = _mm_and_si128(_mm_srli_epi32(f, 16), _mm_set1_epi32(1));
+  const __m128i rounded =
+      _mm_add_epi32(f, _mm_add_epi32(_mm_set1_epi32(0x7FFF), lsb));
+  const __m128i is_nan =
+      _mm_cmpgt_epi32(_mm_and_si128(f, _mm_set1_epi32(0x7FFFFFFF)),
+                      _mm_set1_epi32(0x7F800000));
+  const __m128i quiet_nan = _mm_or_si128(f, _mm_set1_epi32(0x00400000));
+  const __m128i result = _mm_or_si128(_mm_andnot_si128(is_nan, rounded),
+                                      _mm_and_si128(is_nan, quiet_nan));
+  return _mm_srai_epi32(result, 16);
+}
+
+inline size_t NarrowBFloat16Sse2(const float* src, BFloat16* dst,
+                                 size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i lo = RoundToBFloat16Sse2(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    __m128i hi = RoundToBFloat16Sse2(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4)));
+    // The sign extended values are in range so the saturating pack is exact.
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packs_epi32(lo, hi));
+  }
+  return i;
+}
+
+#endif  // __SSE2__
+
+}  // namespace impl
+
+template <>
+inline Status Convert::Execute<Half, float>(absl::Span<const Half> src_buffer,
+                                            absl::Span<float> dst_buffer) {
+  const size_t count = dst_buffer.size();
+  size_t i = 0;
+#if defined(IREE_VMLA_HAVE_X86_DISPATCH)
+  if (impl::HasF16C()) {
+    i = impl::WidenHalfF16C(src_buffer.data(), dst_buffer.data(), count);
+  }
+#endif  // IREE_VMLA_HAVE_X86_DISPATCH
+  for (; i < count; ++i) dst_buffer[i] = src_buffer[i];
+  return OkStatus();
+}
+
+template <>
+inline Status Convert::Execute<float, Half>(absl::Span<const float> src_buffer,
+                                            absl::Span<Half> dst_buffer) {
+  const size_t count = dst_buffer.size();
+  size_t i = 0;
+#if defined(IREE_VMLA_HAVE_X86_DISPATCH)
+  if (impl::HasF16C()) {
+    i = impl::NarrowHalfF16C(src_buffer.data(), dst_buffer.data(), count);
+  }
+#endif  // IREE_VMLA_HAVE_X86_DISPATCH
+  for (; i < count; ++i) dst_buffer[i] = Half(src_buffer[i]);
+  return OkStatus();
+}
+
+template <>
+inline Status Convert::Execute<BFloat16, float>(
+    absl::Span<const BFloat16> src_buffer, absl::Span<float> dst_buffer) {
+  const size_t count = dst_buffer.size();
+  size_t i = 0;
+#if defined(__SSE2__)
+  i = impl::WidenBFloat16Sse2(src_buffer.data(), dst_buffer.data(), count);
+#endif  // __SSE2__
+  for (; i < count; ++i) dst_buffer[i] = src_buffer[i];
+  return OkStatus();
+}
+
+template <>
+inline Status Convert::Execute<float, BFloat16>(
+    absl::Span<const float> src_buffer, absl::Span<BFloat16> dst_buffer) {
+  const size_t count = dst_buffer.size();
+  size_t i = 0;
+#if defined(IREE_VMLA_HAVE_AVX512BF16)
+  if (impl::HasAvx512Bf16()) {
+    i = impl::NarrowBFloat16Avx512(src_buffer.data(), dst_buffer.data(),
+                                   count);
+  }
+#endif  // IREE_VMLA_HAVE_AVX512BF16
+#if defined(__SSE2__)
+  i += impl::NarrowBFloat16Sse2(src_buffer.data() + i, dst_buffer.data() + i,
+                                count - i);
+#endif  // __SSE2__
+  for (; i < count; ++i) dst_buffer[i] = BFloat16(src_buffer[i]);
+  return OkStatus();
+}
+
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_VMLA_OP_KERNELS_SIMD_H_
@@ -14,6 +14,10 @@
 
 #include "iree/hal/vmla/op_kernels.h"
 
+#include <cmath>
+#include <cstring>
+#include <limits>
+
 #include "absl/container/inlined_vector.h"
 #include "iree/base/memory.h"
 #include "iree/testing/gtest.h"
@@ -377,6 +381,291 @@ TEST(Pad, HighRank) {
   EXPECT_EQ(dst_buffer, expected_dst);
 }
 
+// Transposes |src_buffer| one element at a time.
+template <typename T>
+std::vector<T> ReferenceTranspose(const std::vector<T>& src_buffer,
+                                  const Shape& src_shape, const Shape& perm) {
+  const int rank = src_shape.size();
+  Shape src_strides(rank);
+  for (int i = rank - 1, stride = 1; i >= 0; --i) {
+    src_strides[i] = stride;
+    stride *= src_shape[i];
+  }
+  std::vector<T> dst_buffer(src_buffer.size());
+  Shape dst_index(rank, 0);
+  for (size_t i = 0; i < dst_buffer.size(); ++i) {
+    size_t src_offset = 0;
+    for (int j = 0; j < rank; ++j) {
+      src_offset += dst_index[j] * src_strides[perm[j]];
+    }
+    dst_buffer[i] = src_buffer[src_offset];
+    for (int j = rank - 1; j >= 0; --j) {
+      if (++dst_index[j] < src_shape[perm[j]]) break;
+      dst_index[j] = 0;
+    }
+  }
+  return dst_buffer;
+}
+
+template <typename T>
+void ExpectTransposeMatchesReference(const Shape& src_shape,
+                                     const Shape& perm) {
+  auto src_buffer = MakeIota<T>(GetShapeElementCount(src_shape));
+  std::vector<T> dst_buffer(src_buffer.size(), 0);
+  IREE_EXPECT_OK(Transpose::Execute<T>(src_buffer, absl::MakeSpan(dst_buffer),
+                                       src_shape, perm));
+  EXPECT_EQ(dst_buffer, ReferenceTranspose(src_buffer, src_shape, perm));
+}
+
+template <typename T>
+void ExpectTransposesMatchReference() {
+  // 2D planes both smaller and larger than a tile, with partial tiles.
+  ExpectTransposeMatchesReference<T>({3, 5}, {1, 0});
+  ExpectTransposeMatchesReference<T>({16, 8}, {1, 0});
+  ExpectTransposeMatchesReference<T>({67, 130}, {1, 0});
+  // NHWC <-> NCHW.
+  ExpectTransposeMatchesReference<T>({2, 5, 7, 12}, {0, 3, 1, 2});
+  ExpectTransposeMatchesReference<T>({2, 12, 5, 7}, {0, 2, 3, 1});
+  // Inner dimension stays inner so only rows move.
+  ExpectTransposeMatchesReference<T>({2, 9, 3, 10}, {0, 2, 1, 3});
+  // Reversal of all dimensions.
+  ExpectTransposeMatchesReference<T>({3, 4, 5}, {2, 1, 0});
+  // Unit dimensions are dropped before collapsing.
+  ExpectTransposeMatchesReference<T>({1, 9, 1, 11}, {3, 2, 0, 1});
+  ExpectTransposeMatchesReference<T>({4, 1, 6}, {1, 0, 2});
+  // Identity.
+  ExpectTransposeMatchesReference<T>({4, 6, 3}, {0, 1, 2});
+}
+
+TEST(Transpose, Uint32) { ExpectTransposesMatchReference<uint32_t>(); }
+
+TEST(Transpose, Uint16) { ExpectTransposesMatchReference<uint16_t>(); }
+
+TEST(Transpose, Uint8) { ExpectTransposesMatchReference<uint8_t>(); }
+
+// Returns the number of representable floats between |a| and |b|, treating
+// all NaNs as equal.
+int64_t UlpDistance(float a, float b) {
+  if (std::isnan(a) || std::isnan(b)) {
+    return std::isnan(a) && std::isnan(b) ? 0
+                                          : std::numeric_limits<int64_t>::max();
+  }
+  auto to_ordered = [](float value) -> int64_t {
+    int32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits < 0 ? std::numeric_limits<int32_t>::min() - int64_t{bits}
+                    : bits;
+  };
+  return std::abs(to_ordered(a) - to_ordered(b));
+}
+
+// Returns |count| values evenly spaced in [min, max] and special values.
+std::vector<float> MakeLinearInputs(float min, float max, int count) {
+  std::vector<float> inputs = {
+      0.0f,
+      -0.0f,
+      std::numeric_limits<float>::denorm_min(),
+      std::numeric_limits<float>::min(),
+      std::numeric_limits<float>::max(),
+      -std::numeric_limits<float>::max(),
+      std::numeric_limits<float>::infinity(),
+      -std::numeric_limits<float>::infinity(),
+      std::numeric_limits<float>::quiet_NaN(),
+  };
+  for (int i = 0; i < count; ++i) {
+    inputs.push_back(min + (max - min) * i / (count - 1));
+  }
+  return inputs;
+}
+
+// Returns |count| positive values spread evenly over all float exponents and
+// the special values from MakeLinearInputs.
+std::vector<float> MakeExponentInputs(int count) {
+  std::vector<float> inputs = MakeLinearInputs(-1.0f, 1.0f, 2);
+  const uint32_t max_bits = 0x7f800000;
+  for (int i = 0; i < count; ++i) {
+    uint32_t bits = static_cast<uint32_t>(uint64_t{max_bits} * i / count);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    inputs.push_back(value);
+  }
+  return inputs;
+}
+
+template <typename Op, typename Reference>
+void ExpectUnaryWithinUlp(absl::Span<const float> inputs, Reference reference,
+                          int64_t max_ulp) {
+  std::vector<float> results(inputs.size());
+  for (int level = 0; level <= static_cast<int>(impl::GetSimdLevel());
+       ++level) {
+    impl::MapUnary<Op>(static_cast<impl::SimdLevel>(level), inputs.data(),
+                       results.data(), inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      float expected = static_cast<float>(reference(inputs[i]));
+      ASSERT_LE(UlpDistance(results[i], expected), max_ulp)
+          << "level " << level << " input " << inputs[i] << " result "
+          << results[i] << " expected " << expected;
+    }
+  }
+}
+
+template <typename Op, typename Reference>
+void ExpectBinaryWithinUlp(absl::Span<const float> lhs_values,
+                           absl::Span<const float> rhs_values,
+                           Reference reference, int64_t max_ulp) {
+  std::vector<float> lhs, rhs;
+  for (float lhs_value : lhs_values) {
+    for (float rhs_value : rhs_values) {
+      lhs.push_back(lhs_value);
+      rhs.push_back(rhs_value);
+    }
+  }
+  std::vector<float> results(lhs.size());
+  for (int level = 0; level <= static_cast<int>(impl::GetSimdLevel());
+       ++level) {
+    impl::MapBinary<Op>(static_cast<impl::SimdLevel>(level), lhs.data(),
+                        rhs.data(), results.data(), lhs.size());
+    for (size_t i = 0; i < lhs.size(); ++i) {
+      float expected = static_cast<float>(reference(lhs[i], rhs[i]));
+      ASSERT_LE(UlpDistance(results[i], expected), max_ulp)
+          << "level " << level << " inputs " << lhs[i] << ", " << rhs[i]
+          << " result " << results[i] << " expected " << expected;
+    }
+  }
+}
+
+TEST(Exp, WithinUlpBound) {
+  ExpectUnaryWithinUlp<impl::ExpOp>(MakeLinearInputs(-105.0f, 90.0f, 100001),
+                                    [](double x) { return std::exp(x); }, 2);
+}
+
+TEST(Log, WithinUlpBound) {
+  ExpectUnaryWithinUlp<impl::LogOp>(MakeExponentInputs(100001),
+                                    [](double x) { return std::log(x); }, 2);
+}
+
+TEST(Rsqrt, WithinUlpBound) {
+  ExpectUnaryWithinUlp<impl::RsqrtOp>(
+      MakeExponentInputs(100001),
+      [](double x) { return 1.0 / std::sqrt(x); }, 1);
+}
+
+TEST(Sin, WithinUlpBound) {
+  auto reference = [](double x) { return std::sin(x); };
+  ExpectUnaryWithinUlp<impl::SinOp>(MakeLinearInputs(-10.0f, 10.0f, 100001),
+                                    reference, 1);
+  ExpectUnaryWithinUlp<impl::SinOp>(
+      MakeLinearInputs(-100000.0f, 100000.0f, 100001), reference, 1);
+}
+
+TEST(Cos, WithinUlpBound) {
+  auto reference = [](double x) { return std::cos(x); };
+  ExpectUnaryWithinUlp<impl::CosOp>(MakeLinearInputs(-10.0f, 10.0f, 100001),
+                                    reference, 1);
+  ExpectUnaryWithinUlp<impl::CosOp>(
+      MakeLinearInputs(-100000.0f, 100000.0f, 100001), reference, 1);
+}
+
+TEST(Tanh, WithinUlpBound) {
+  auto reference = [](double x) { return std::tanh(x); };
+  ExpectUnaryWithinUlp<impl::TanhOp>(MakeLinearInputs(-12.0f, 12.0f, 100001),
+                                     reference, 3);
+  ExpectUnaryWithinUlp<impl::TanhOp>(MakeExponentInputs(100001), reference, 3);
+}
+
+TEST(Pow, WithinUlpBound) {
+  std::vector<float> x_values = MakeExponentInputs(1001);
+  for (float x : MakeLinearInputs(-4.0f, 4.0f, 17)) x_values.push_back(x);
+  std::vector<float> y_values = MakeLinearInputs(-40.0f, 40.0f, 321);
+  y_values.push_back(0.5f);
+  y_values.push_back(-1.5f);
+  ExpectBinaryWithinUlp<impl::PowOp>(
+      x_values, y_values, [](double x, double y) { return std::pow(x, y); },
+      1);
+}
+
+TEST(Atan2, WithinUlpBound) {
+  std::vector<float> values = MakeLinearInputs(-10.0f, 10.0f, 401);
+  for (float value : MakeExponentInputs(101)) {
+    values.push_back(value);
+    values.push_back(-value);
+  }
+  ExpectBinaryWithinUlp<impl::Atan2Op>(
+      values, values, [](double y, double x) { return std::atan2(y, x); }, 3);
+}
+
+TEST(Exp, MatchesReferenceForUnalignedSizes) {
+  std::vector<float> src_buffer = {-1.5f, 0.0f, 0.25f, 1.0f, 2.0f,
+                                   3.5f,  -8.0f, 10.0f, 0.5f, -0.5f,
+                                   88.0f, -87.0f, 100.0f};
+  std::vector<float> dst_buffer(src_buffer.size());
+  IREE_EXPECT_OK(Exp::Execute<float>(src_buffer, absl::MakeSpan(dst_buffer)));
+  for (size_t i = 0; i < src_buffer.size(); ++i) {
+    EXPECT_LE(UlpDistance(dst_buffer[i], std::exp(src_buffer[i])), 2)
+        << src_buffer[i];
+  }
+}
+
+TEST(Elementwise, MatchesUnfusedOps) {
+  // Spans several chunks with a partial chunk at the end.
+  const int count = 3 * Elementwise::kChunkSize + 17;
+  std::vector<float> a = MakeLinearInputs(-4.0f, 4.0f, count);
+  std::vector<float> b = MakeLinearInputs(1.0f, 2.0f, count);
+  std::vector<float> c = MakeLinearInputs(-1.0f, 0.5f, count);
+  const int size = a.size();
+
+  // tanh(a * b + c) - c
+  std::vector<float> mul(size), add(size), tanh(size), expected(size);
+  IREE_ASSERT_OK(Mul::Execute<float>(a, b, absl::MakeSpan(mul)));
+  IREE_ASSERT_OK(Add::Execute<float>(mul, c, absl::MakeSpan(add)));
+  IREE_ASSERT_OK(Tanh::Execute<float>(add, absl::MakeSpan(tanh)));
+  IREE_ASSERT_OK(Sub::Execute<float>(tanh, c, absl::MakeSpan(expected)));
+
+  std::vector<int32_t> program = {
+      Elementwise::kMul,  3, 0, 1,  //
+      Elementwise::kAdd,  3, 3, 2,  //
+      Elementwise::kTanh, 4, 3, 3,  //
+      Elementwise::kSub,  3, 4, 2,  //
+  };
+  absl::Span<const float> src_buffers[] = {a, b, c};
+  std::vector<float> dst_buffer(size);
+  IREE_ASSERT_OK(Elementwise::Execute<float>(program, src_buffers,
+                                             absl::MakeSpan(dst_buffer)));
+  for (int i = 0; i < size; ++i) {
+    float actual = dst_buffer[i];
+    if (std::isnan(expected[i])) {
+      EXPECT_TRUE(std::isnan(actual)) << i;
+    } else {
+      EXPECT_EQ(expected[i], actual) << i;
+    }
+  }
+}
+
+TEST(Elementwise, InvalidPrograms) {
+  std::vector<float> src(4), dst(4), short_dst(3);
+  absl::Span<const float> src_buffers[] = {src};
+  std::vector<int32_t> truncated = {Elementwise::kExp, 1, 0};
+  EXPECT_FALSE(Elementwise::Execute<float>(truncated, src_buffers,
+                                           absl::MakeSpan(dst))
+                   .ok());
+  std::vector<int32_t> undefined_register = {Elementwise::kAdd, 1, 0, 2};
+  EXPECT_FALSE(Elementwise::Execute<float>(undefined_register, src_buffers,
+                                           absl::MakeSpan(dst))
+                   .ok());
+  std::vector<int32_t> overwrites_source = {Elementwise::kNeg, 0, 0, 0};
+  EXPECT_FALSE(Elementwise::Execute<float>(overwrites_source, src_buffers,
+                                           absl::MakeSpan(dst))
+                   .ok());
+  std::vector<int32_t> unknown_opcode = {99, 1, 0, 0};
+  EXPECT_FALSE(Elementwise::Execute<float>(unknown_opcode, src_buffers,
+                                           absl::MakeSpan(dst))
+                   .ok());
+  std::vector<int32_t> valid = {Elementwise::kNeg, 1, 0, 0};
+  EXPECT_FALSE(Elementwise::Execute<float>(valid, src_buffers,
+                                           absl::MakeSpan(short_dst))
+                   .ok());
+}
+
 TEST(ReduceSum, Scalar) {
   Shape src_shape = {5};
   int32_t dimension = 0;
@@ -414,6 +703,110 @@ TEST(ReduceMin, TwoDimensionsToOne) {
   }
 }
 
+// Reduces |src| along |dimension| one element at a time in source order,
+// accumulating sums in double precision.
+template <typename T, typename KernelImpl>
+std::vector<T> ReduceReference(const std::vector<T>& src, T init,
+                               const Shape& src_shape, int32_t dimension) {
+  size_t outer = 1, inner = 1;
+  for (int i = 0; i < dimension; ++i) outer *= src_shape[i];
+  for (int i = dimension + 1; i < src_shape.size(); ++i) inner *= src_shape[i];
+  size_t reduce = src_shape[dimension];
+  std::vector<T> dst(outer * inner);
+  for (size_t o = 0; o < outer; ++o) {
+    for (size_t i = 0; i < inner; ++i) {
+      T value = init;
+      double sum = init;
+      for (size_t r = 0; r < reduce; ++r) {
+        T x = src[(o * reduce + r) * inner + i];
+        KernelImpl()(&value, x);
+        sum += x;
+      }
+      dst[o * inner + i] =
+          std::is_same<KernelImpl, impl::SumKernel>::value ? static_cast<T>(sum)
+                                                     : value;
+    }
+  }
+  return dst;
+}
+
+template <typename T, typename ReduceOp, typename KernelImpl>
+void ExpectReductionsMatchReference(T init) {
+  // Sizes straddle the 4/8-lane vector widths and the summation block sizes.
+  const std::vector<Shape> shapes = {
+      {1}, {7}, {33}, {1000}, {3, 129}, {67, 5}, {2, 300, 3}, {4, 17, 9, 2},
+  };
+  for (const auto& src_shape : shapes) {
+    std::vector<T> src(GetShapeElementCount(src_shape));
+    for (size_t i = 0; i < src.size(); ++i) {
+      src[i] = static_cast<T>(static_cast<int>((i * 7919) % 61) - 30);
+    }
+    for (int32_t dimension = 0; dimension < src_shape.size(); ++dimension) {
+      Shape dst_shape = src_shape;
+      dst_shape.erase(dst_shape.begin() + dimension);
+      std::vector<T> dst(GetShapeElementCount(dst_shape));
+      std::vector<T> init_buffer = {init};
+      IREE_EXPECT_OK(ReduceOp::template Execute<T>(
+          src, init_buffer, absl::MakeSpan(dst), dimension, src_shape,
+          dst_shape));
+      // All partial sums are exact integers so every order agrees.
+      EXPECT_EQ(dst, (ReduceReference<T, KernelImpl>(src, init, src_shape,
+                                                     dimension)));
+    }
+  }
+}
+
+TEST(ReduceSum, MatchesReference) {
+  ExpectReductionsMatchReference<float, ReduceSum, impl::SumKernel>(1.0f);
+  ExpectReductionsMatchReference<int32_t, ReduceSum, impl::SumKernel>(1);
+}
+
+TEST(ReduceMin, MatchesReference) {
+  ExpectReductionsMatchReference<float, ReduceMin, impl::MinKernel>(
+      std::numeric_limits<float>::max());
+  ExpectReductionsMatchReference<int32_t, ReduceMin, impl::MinKernel>(
+      std::numeric_limits<int32_t>::max());
+}
+
+TEST(ReduceMax, MatchesReference) {
+  ExpectReductionsMatchReference<float, ReduceMax, impl::MaxKernel>(-5.0f);
+  ExpectReductionsMatchReference<int8_t, ReduceMax, impl::MaxKernel>(-128);
+}
+
+TEST(ReduceSum, LongRowsStayAccurate) {
+  // Naively accumulating 0.1f 2^20 times in f32 is off by ~1%.
+  const int32_t kCount = 1 << 20;
+  const double expected = static_cast<double>(0.1f) * kCount;
+  std::vector<float> init_buffer = {0.0f};
+
+  Shape row_shape = {kCount};
+  std::vector<float> src(kCount, 0.1f);
+  std::vector<float> dst(1);
+  IREE_EXPECT_OK(ReduceSum::Execute<float>(
+      src, init_buffer, absl::MakeSpan(dst), 0, row_shape, Shape{1}));
+  EXPECT_NEAR(expected, dst[0], expected * 1e-6);
+
+  Shape column_shape = {kCount / 16, 16};
+  dst.resize(16);
+  IREE_EXPECT_OK(ReduceSum::Execute<float>(
+      src, init_buffer, absl::MakeSpan(dst), 0, column_shape, Shape{16}));
+  for (float value : dst) {
+    EXPECT_NEAR(expected / 16, value, expected / 16 * 1e-6);
+  }
+}
+
+TEST(ReduceMax, InvalidDimension) {
+  Shape src_shape = {2, 3};
+  std::vector<float> src(6), init_buffer(1), dst(3);
+  EXPECT_FALSE(ReduceMax::Execute<float>(src, init_buffer, absl::MakeSpan(dst),
+                                         2, src_shape, Shape{3})
+                   .ok());
+  EXPECT_FALSE(ReduceMax::Execute<float>(src, init_buffer,
+                                         absl::MakeSpan(dst).first(2), 0,
+                                         src_shape, Shape{3})
+                   .ok());
+}
+
 TEST(PoolingMax, NoOverlapping) {
   Shape src_shape = {1, 4, 6, 1};
   Shape dst_shape = {1, 2, 2, 1};
@@ -472,6 +865,86 @@ TEST(PoolingSum, Overlapping) {
   }
 }
 
+// Computes each pooling output by visiting every window element, padded ones
+// contributing |init|.
+template <typename T, typename KernelImpl>
+std::vector<T> PoolingReference(const std::vector<T>& src, T init,
+                                const Shape& src_shape, const Shape& dst_shape,
+                                const Shape& window_sizes, const Shape& strides,
+                                const Shape& pad_low) {
+  int rank = src_shape.size();
+  std::vector<T> dst(GetShapeElementCount(dst_shape));
+  Shape dst_index(rank, 0);
+  for (size_t d = 0; d < dst.size(); ++d) {
+    T value = init;
+    Shape window_index(rank, 0);
+    for (size_t w = 0; w < GetShapeElementCount(window_sizes); ++w) {
+      bool in_bounds = true;
+      size_t src_offset = 0;
+      for (int i = 0; i < rank; ++i) {
+        int32_t src_i =
+            dst_index[i] * strides[i] + window_index[i] - pad_low[i];
+        in_bounds &= src_i >= 0 && src_i < src_shape[i];
+        src_offset = src_offset * src_shape[i] + src_i;
+      }
+      KernelImpl()(&value, in_bounds ? src[src_offset] : init);
+      for (int i = rank - 1; i >= 0 && ++window_index[i] == window_sizes[i];
+           --i) {
+        window_index[i] = 0;
+      }
+    }
+    dst[d] = value;
+    for (int i = rank - 1; i >= 0 && ++dst_index[i] == dst_shape[i]; --i) {
+      dst_index[i] = 0;
+    }
+  }
+  return dst;
+}
+
+TEST(PoolingMax, StridedPaddedMatchesReference) {
+  Shape src_shape = {2, 9, 11, 3};
+  Shape window_sizes = {1, 3, 4, 2};
+  Shape strides = {1, 2, 3, 1};
+  Shape pad_low = {0, 1, 2, 1};
+  // Includes windows hanging off the high edge.
+  Shape dst_shape = {2, 5, 4, 3};
+  std::vector<int> src(GetShapeElementCount(src_shape));
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<int>((i * 7919) % 101);
+  }
+  std::vector<int> init_buffer = {-1};
+  std::vector<int> dst(GetShapeElementCount(dst_shape));
+  IREE_EXPECT_OK(PoolingMax::Execute<int>(src, init_buffer,
+                                          absl::MakeSpan(dst), src_shape,
+                                          dst_shape, window_sizes, strides,
+                                          pad_low));
+  EXPECT_EQ(dst, (PoolingReference<int, impl::MaxKernel>(src, -1, src_shape,
+                                                   dst_shape, window_sizes,
+                                                   strides, pad_low)));
+}
+
+TEST(PoolingSum, WideWindowsMatchReference) {
+  // Long innermost window rows take the vectorized path.
+  Shape src_shape = {5, 70};
+  Shape window_sizes = {3, 37};
+  Shape strides = {2, 5};
+  Shape pad_low = {1, 3};
+  Shape dst_shape = {3, 14};
+  std::vector<float> src(GetShapeElementCount(src_shape));
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<float>(static_cast<int>((i * 7919) % 61) - 30);
+  }
+  std::vector<float> init_buffer = {0.0f};
+  std::vector<float> dst(GetShapeElementCount(dst_shape));
+  IREE_EXPECT_OK(PoolingSum::Execute<float>(src, init_buffer,
+                                            absl::MakeSpan(dst), src_shape,
+                                            dst_shape, window_sizes, strides,
+                                            pad_low));
+  EXPECT_EQ(dst, (PoolingReference<float, impl::SumKernel>(src, 0.0f, src_shape,
+                                                     dst_shape, window_sizes,
+                                                     strides, pad_low)));
+}
+
 TEST(Conv2d, NoDilation) {
   Shape input_shape = {4, 5, 2};
   Shape filter_shape = {3, 2, 2, 1};
@@ -534,6 +1007,921 @@ TEST(Conv2d, DepthwiseConv) {
   }
 }
 
+// Runs the convolution with |algorithm| and compares the result against the
+// reference direct convolution.
+void ExpectConv2DMatchesDirect(Conv2D::Algorithm algorithm,
+                               const Shape& input_shape,
+                               const Shape& filter_shape,
+                               const Shape& dst_shape, const Shape& strides,
+                               const Shape& pad_h, const Shape& pad_w) {
+  const Shape dilation = {1, 1};
+  std::vector<float> input_buffer(GetShapeElementCount(input_shape));
+  std::vector<float> filter_buffer(GetShapeElementCount(filter_shape));
+  for (int i = 0; i < input_buffer.size(); ++i) {
+    input_buffer[i] = ((i * 7) % 13) / 13.0f - 0.5f;
+  }
+  for (int i = 0; i < filter_buffer.size(); ++i) {
+    filter_buffer[i] = ((i * 5) % 11) / 11.0f - 0.5f;
+  }
+
+  std::vector<float> expected_dst(GetShapeElementCount(dst_shape));
+  IREE_ASSERT_OK(Conv2D::Execute<float>(
+      input_buffer, input_shape, filter_buffer, filter_shape,
+      absl::MakeSpan(expected_dst), dst_shape, strides, pad_h, pad_w,
+      dilation, 1));
+
+  RuntimeState runtime_state;
+  std::vector<float> dst_buffer(GetShapeElementCount(dst_shape), NAN);
+  IREE_ASSERT_OK(Conv2D::Execute<float>(
+      runtime_state.mat_mul_state.get(), algorithm, input_buffer, input_shape,
+      filter_buffer, filter_shape, absl::MakeSpan(dst_buffer), dst_shape,
+      strides, pad_h, pad_w, dilation, 1));
+
+  for (int i = 0; i < dst_buffer.size(); ++i) {
+    EXPECT_NEAR(expected_dst[i], dst_buffer[i], 1e-4f) << "index " << i;
+  }
+
+  // Reusing a filter transformed ahead of time gives the same results.
+  auto transformed_filter =
+      Conv2D::TransformFilter<float>(algorithm, filter_buffer, filter_shape);
+  std::vector<float> reused_dst_buffer(dst_buffer.size(), NAN);
+  IREE_ASSERT_OK(Conv2D::Execute<float>(
+      runtime_state.mat_mul_state.get(), algorithm, input_buffer, input_shape,
+      filter_buffer, filter_shape, absl::MakeSpan(reused_dst_buffer),
+      dst_shape, strides, pad_h, pad_w, dilation, 1,
+      absl::MakeConstSpan(transformed_filter)));
+  EXPECT_EQ(dst_buffer, reused_dst_buffer);
+}
+
+TEST(Conv2d, SelectAlgorithm) {
+  const Shape unit = {1, 1};
+  const Shape no_pad = {0, 0};
+  const Shape pad = {1, 1};
+  EXPECT_EQ(Conv2D::Algorithm::kGemm1x1,
+            Conv2D::SelectAlgorithm({8, 8, 16}, {1, 1, 16, 16}, unit, no_pad,
+                                    no_pad, unit, 1));
+  EXPECT_EQ(Conv2D::Algorithm::kIm2Col,
+            Conv2D::SelectAlgorithm({8, 8, 16}, {1, 1, 16, 16}, {2, 2}, no_pad,
+                                    no_pad, unit, 1));
+  EXPECT_EQ(Conv2D::Algorithm::kWinograd,
+            Conv2D::SelectAlgorithm({8, 8, 16}, {3, 3, 16, 16}, unit, pad, pad,
+                                    unit, 1));
+  EXPECT_EQ(Conv2D::Algorithm::kIm2Col,
+            Conv2D::SelectAlgorithm({8, 8, 3}, {3, 3, 3, 16}, unit, pad, pad,
+                                    unit, 1));
+  EXPECT_EQ(Conv2D::Algorithm::kIm2Col,
+            Conv2D::SelectAlgorithm({8, 8, 16}, {5, 5, 16, 16}, unit, no_pad,
+                                    no_pad, unit, 1));
+  EXPECT_EQ(Conv2D::Algorithm::kDirect,
+            Conv2D::SelectAlgorithm({8, 8, 16}, {3, 3, 8, 16}, unit, pad, pad,
+                                    unit, 2));
+  EXPECT_EQ(Conv2D::Algorithm::kDirect,
+            Conv2D::SelectAlgorithm({8, 8, 16}, {3, 3, 16, 16}, unit, pad, pad,
+                                    {2, 2}, 1));
+}
+
+TEST(Conv2d, Gemm1x1) {
+  ExpectConv2DMatchesDirect(Conv2D::Algorithm::kGemm1x1, {5, 6, 8},
+                            {1, 1, 8, 4}, {5, 6, 4}, {1, 1}, {0, 0}, {0, 0});
+}
+
+TEST(Conv2d, Im2Col) {
+  ExpectConv2DMatchesDirect(Conv2D::Algorithm::kIm2Col, {4, 5, 2},
+                            {3, 2, 2, 3}, {2, 4, 3}, {1, 1}, {0, 0}, {0, 0});
+}
+
+TEST(Conv2d, Im2ColStridedPadded) {
+  ExpectConv2DMatchesDirect(Conv2D::Algorithm::kIm2Col, {7, 6, 3},
+                            {3, 2, 3, 5}, {4, 6, 5}, {2, 1}, {1, 1}, {0, 1});
+}
+
+TEST(Conv2d, Winograd) {
+  ExpectConv2DMatchesDirect(Conv2D::Algorithm::kWinograd, {6, 8, 8},
+                            {3, 3, 8, 8}, {4, 6, 8}, {1, 1}, {0, 0}, {0, 0});
+}
+
+TEST(Conv2d, WinogradPaddedOddOutput) {
+  ExpectConv2DMatchesDirect(Conv2D::Algorithm::kWinograd, {7, 5, 9},
+                            {3, 3, 9, 10}, {7, 5, 10}, {1, 1}, {1, 1}, {1, 1});
+}
+
+// Returns a deterministic small-integer test pattern. Sums of these are exact
+// in float so results don't depend on how the work is split.
+template <typename T>
+std::vector<T> MakePattern(size_t size) {
+  std::vector<T> v(size);
+  for (size_t i = 0; i < size; ++i) {
+    v[i] = static_cast<T>(static_cast<int>((i * 7919) % 61) - 30);
+  }
+  return v;
+}
+
+TEST(Parallel, TransposeMatchesSerial) {
+  auto thread_pool = ThreadPool::Create(3);
+  const std::vector<std::pair<Shape, Shape>> cases = {
+      {{1024, 96}, {1, 0}},
+      {{4, 130, 70}, {2, 0, 1}},
+      {{4, 130, 70}, {0, 2, 1}},
+      {{300, 40, 16}, {1, 0, 2}},
+  };
+  for (const auto& test_case : cases) {
+    const Shape& src_shape = test_case.first;
+    auto src = MakePattern<float>(GetShapeElementCount(src_shape));
+    std::vector<float> expected(src.size()), dst(src.size());
+    IREE_ASSERT_OK(Transpose::Execute<float>(src, absl::MakeSpan(expected),
+                                             src_shape, test_case.second));
+    IREE_ASSERT_OK(Transpose::Execute<float>(src, absl::MakeSpan(dst),
+                                             src_shape, test_case.second,
+                                             thread_pool.get()));
+    EXPECT_EQ(expected, dst);
+  }
+}
+
+TEST(Parallel, ReduceMatchesSerial) {
+  auto thread_pool = ThreadPool::Create(3);
+  const std::vector<std::pair<Shape, int32_t>> cases = {
+      {{3, 200000}, 1},  // Rows split into segments.
+      {{64, 3000}, 0},
+      {{64, 3000}, 1},
+      {{2, 1000, 300}, 1},
+  };
+  for (const auto& test_case : cases) {
+    const Shape& src_shape = test_case.first;
+    Shape dst_shape = src_shape;
+    dst_shape.erase(dst_shape.begin() + test_case.second);
+    auto src = MakePattern<float>(GetShapeElementCount(src_shape));
+    std::vector<float> init = {1.0f};
+    std::vector<float> expected(GetShapeElementCount(dst_shape));
+    std::vector<float> dst(expected.size());
+    IREE_ASSERT_OK(ReduceSum::Execute<float>(src, init,
+                                             absl::MakeSpan(expected),
+                                             test_case.second, src_shape,
+                                             dst_shape));
+    IREE_ASSERT_OK(ReduceSum::Execute<float>(
+        src, init, absl::MakeSpan(dst), test_case.second, src_shape,
+        dst_shape, thread_pool.get()));
+    EXPECT_EQ(expected, dst);
+    IREE_ASSERT_OK(ReduceMax::Execute<float>(src, init,
+                                             absl::MakeSpan(expected),
+                                             test_case.second, src_shape,
+                                             dst_shape));
+    IREE_ASSERT_OK(ReduceMax::Execute<float>(
+        src, init, absl::MakeSpan(dst), test_case.second, src_shape,
+        dst_shape, thread_pool.get()));
+    EXPECT_EQ(expected, dst);
+  }
+}
+
+TEST(Parallel, GatherMatchesSerial) {
+  auto thread_pool = ThreadPool::Create(3);
+  Shape src_shape = {1000, 64};
+  Shape indices_shape = {5000};
+  Shape dst_shape = {5000, 64};
+  auto src = MakePattern<int32_t>(GetShapeElementCount(src_shape));
+  std::vector<int32_t> indices(5000);
+  for (size_t i = 0; i < indices.size(); ++i) indices[i] = (i * 31) % 1000;
+  std::vector<int32_t> expected(GetShapeElementCount(dst_shape));
+  std::vector<int32_t> dst(expected.size());
+  IREE_ASSERT_OK(Gather::Execute<int32_t>(src, indices,
+                                          absl::MakeSpan(expected), src_shape,
+                                          indices_shape, dst_shape, 0, 0));
+  IREE_ASSERT_OK(Gather::Execute<int32_t>(src, indices, absl::MakeSpan(dst),
+                                          src_shape, indices_shape, dst_shape,
+                                          0, 0, thread_pool.get()));
+  EXPECT_EQ(expected, dst);
+}
+
+TEST(Parallel, Conv2DMatchesSerial) {
+  auto thread_pool = ThreadPool::Create(3);
+  Shape input_shape = {32, 32, 8};
+  Shape filter_shape = {3, 3, 8, 16};
+  Shape dst_shape = {32, 32, 16};
+  Shape strides = {1, 1};
+  Shape pad = {1, 1};
+  Shape dilation = {1, 1};
+  auto input = MakePattern<float>(GetShapeElementCount(input_shape));
+  auto filter = MakePattern<float>(GetShapeElementCount(filter_shape));
+  std::vector<float> expected(GetShapeElementCount(dst_shape));
+  std::vector<float> dst(expected.size(), NAN);
+  IREE_ASSERT_OK(Conv2D::Execute<float>(
+      input, input_shape, filter, filter_shape, absl::MakeSpan(expected),
+      dst_shape, strides, pad, pad, dilation, 1));
+  IREE_ASSERT_OK(Conv2D::Execute<float>(
+      input, input_shape, filter, filter_shape, absl::MakeSpan(dst), dst_shape,
+      strides, pad, pad, dilation, 1, thread_pool.get()));
+  EXPECT_EQ(expected, dst);
+}
+
+TEST(TakeAlongAxis, Innermost) {
+  Shape src_shape = {2, 4};
+  Shape indices_shape = {2, 3};
+  std::vector<int32_t> src = {10, 11, 12, 13, 20, 21, 22, 23};
+  std::vector<int32_t> indices = {3, 0, 0, 1, 2, 3};
+  std::vector<int32_t> dst(6);
+  IREE_EXPECT_OK(TakeAlongAxis::Execute<int32_t>(
+      src, indices, absl::MakeSpan(dst), src_shape, indices_shape, 1));
+  EXPECT_EQ(dst, std::vector<int32_t>({13, 10, 10, 21, 22, 23}));
+}
+
+TEST(TakeAlongAxis, Outer) {
+  Shape src_shape = {3, 2};
+  Shape indices_shape = {2, 2};
+  std::vector<uint8_t> src = {1, 2, 3, 4, 5, 6};
+  std::vector<int32_t> indices = {2, 0, 1, 1};
+  std::vector<uint8_t> dst(4);
+  IREE_EXPECT_OK(TakeAlongAxis::Execute<uint8_t>(
+      src, indices, absl::MakeSpan(dst), src_shape, indices_shape, 0));
+  EXPECT_EQ(dst, std::vector<uint8_t>({5, 2, 3, 4}));
+}
+
+TEST(TakeAlongAxis, IndexOutOfRange) {
+  Shape shape = {2};
+  std::vector<int32_t> src = {1, 2};
+  std::vector<int32_t> indices = {0, 2};
+  std::vector<int32_t> dst(2);
+  EXPECT_TRUE(IsOutOfRange(TakeAlongAxis::Execute<int32_t>(
+      src, indices, absl::MakeSpan(dst), shape, shape, 0)));
+}
+
+TEST(Sort, StableAscending) {
+  Shape shape = {2, 5};
+  std::vector<int32_t> src = {3, 1, 2, 1, 0, 5, 5, 4, 5, 4};
+  std::vector<int32_t> dst(10);
+  IREE_EXPECT_OK(Sort::Execute<int32_t>(src, absl::MakeSpan(dst), shape, 1,
+                                        /*descending=*/false,
+                                        /*refine=*/false));
+  EXPECT_EQ(dst, std::vector<int32_t>({4, 1, 3, 2, 0, 2, 4, 0, 1, 3}));
+}
+
+TEST(Sort, DescendingWithNaNsLast) {
+  Shape shape = {6};
+  std::vector<float> src = {1.0f, NAN, 3.0f, -2.0f, NAN, 3.0f};
+  std::vector<int32_t> dst(6);
+  IREE_EXPECT_OK(Sort::Execute<float>(src, absl::MakeSpan(dst), shape, 0,
+                                      /*descending=*/true, /*refine=*/false));
+  EXPECT_EQ(dst, std::vector<int32_t>({2, 5, 0, 3, 1, 4}));
+  IREE_EXPECT_OK(Sort::Execute<float>(src, absl::MakeSpan(dst), shape, 0,
+                                      /*descending=*/false, /*refine=*/false));
+  EXPECT_EQ(dst, std::vector<int32_t>({3, 0, 2, 5, 1, 4}));
+}
+
+TEST(Sort, OuterDimension) {
+  Shape shape = {3, 2};
+  std::vector<int8_t> src = {2, -1, 0, 7, 1, 3};
+  std::vector<int32_t> dst(6);
+  IREE_EXPECT_OK(Sort::Execute<int8_t>(src, absl::MakeSpan(dst), shape, 0,
+                                       /*descending=*/false,
+                                       /*refine=*/false));
+  EXPECT_EQ(dst, std::vector<int32_t>({1, 0, 2, 2, 0, 1}));
+}
+
+TEST(Sort, RefineByMoreSignificantKey) {
+  // Sorts by (primary ascending, secondary descending) from the least
+  // significant key to the most.
+  Shape shape = {6};
+  std::vector<int32_t> primary = {1, 0, 1, 0, 1, 0};
+  std::vector<float> secondary = {0.5f, 0.25f, 2.0f, 0.25f, 1.0f, 3.0f};
+  std::vector<int32_t> dst(6);
+  IREE_EXPECT_OK(Sort::Execute<float>(secondary, absl::MakeSpan(dst), shape,
+                                      0, /*descending=*/true,
+                                      /*refine=*/false));
+  IREE_EXPECT_OK(Sort::Execute<int32_t>(primary, absl::MakeSpan(dst), shape,
+                                        0, /*descending=*/false,
+                                        /*refine=*/true));
+  EXPECT_EQ(dst, std::vector<int32_t>({5, 1, 3, 2, 4, 0}));
+
+  dst[0] = 6;
+  EXPECT_TRUE(IsOutOfRange(Sort::Execute<int32_t>(
+      primary, absl::MakeSpan(dst), shape, 0, false, /*refine=*/true)));
+}
+
+// Returns the first |k| elements along the innermost dimension of |src| after
+// a full stable sort, as TopK should produce.
+template <typename T>
+void SortThenSlice(const std::vector<T>& src, Shape shape, int32_t k,
+                   bool descending, std::vector<T>* values,
+                   std::vector<int32_t>* indices) {
+  std::vector<int32_t> order(src.size());
+  IREE_ASSERT_OK(Sort::Execute<T>(src, absl::MakeSpan(order), shape,
+                                  shape.size() - 1, descending,
+                                  /*refine=*/false));
+  const size_t rows = src.size() / shape.back();
+  values->clear();
+  indices->clear();
+  for (size_t r = 0; r < rows; ++r) {
+    for (int32_t j = 0; j < k; ++j) {
+      const int32_t index = order[r * shape.back() + j];
+      indices->push_back(index);
+      values->push_back(src[r * shape.back() + index]);
+    }
+  }
+}
+
+TEST(TopK, MatchesSortThenSlice) {
+  // Small values produce lots of ties to check they resolve as in a stable
+  // sort. Covers both the heap and partitioning selections.
+  Shape shape = {4, 200};
+  std::vector<int32_t> src(GetShapeElementCount(shape));
+  for (size_t i = 0; i < src.size(); ++i) src[i] = (i * 7919) % 23;
+  for (int32_t k : {0, 1, 5, 12, 13, 100, 200}) {
+    for (bool descending : {false, true}) {
+      std::vector<int32_t> expected_values, expected_indices;
+      SortThenSlice(src, shape, k, descending, &expected_values,
+                    &expected_indices);
+      Shape dst_shape = {4, k};
+      std::vector<int32_t> values(4 * k), indices(4 * k);
+      IREE_ASSERT_OK(TopK::Execute<int32_t>(
+          src, absl::MakeSpan(values), absl::MakeSpan(indices), shape,
+          dst_shape, 1, descending));
+      EXPECT_EQ(expected_values, values) << "k=" << k;
+      EXPECT_EQ(expected_indices, indices) << "k=" << k;
+    }
+  }
+}
+
+TEST(TopK, NaNsAreSelectedLast) {
+  Shape shape = {5};
+  std::vector<float> src = {NAN, 1.0f, NAN, -1.0f, 4.0f};
+  Shape dst_shape = {4};
+  std::vector<float> values(4);
+  std::vector<int32_t> indices(4);
+  IREE_EXPECT_OK(TopK::Execute<float>(src, absl::MakeSpan(values),
+                                      absl::MakeSpan(indices), shape,
+                                      dst_shape, 0, /*descending=*/true));
+  EXPECT_EQ(indices, std::vector<int32_t>({4, 1, 3, 0}));
+  EXPECT_EQ(values[2], -1.0f);
+  EXPECT_TRUE(std::isnan(values[3]));
+}
+
+TEST(TopK, OuterDimension) {
+  Shape shape = {4, 2};
+  std::vector<float> src = {1.0f, 8.0f, 4.0f, 6.0f, 3.0f, 7.0f, 2.0f, 5.0f};
+  Shape dst_shape = {2, 2};
+  std::vector<float> values(4);
+  std::vector<int32_t> indices(4);
+  IREE_EXPECT_OK(TopK::Execute<float>(src, absl::MakeSpan(values),
+                                      absl::MakeSpan(indices), shape,
+                                      dst_shape, 0, /*descending=*/true));
+  EXPECT_EQ(values, std::vector<float>({4.0f, 8.0f, 3.0f, 7.0f}));
+  EXPECT_EQ(indices, std::vector<int32_t>({1, 0, 2, 2}));
+}
+
+TEST(TopK, InvalidShapes) {
+  Shape shape = {2, 3};
+  std::vector<float> src(6), values(8);
+  std::vector<int32_t> indices(8);
+  EXPECT_TRUE(IsInvalidArgument(TopK::Execute<float>(
+      src, absl::MakeSpan(values), absl::MakeSpan(indices), shape,
+      Shape{2, 4}, 1, false)));
+  EXPECT_TRUE(IsInvalidArgument(TopK::Execute<float>(
+      src, absl::MakeSpan(values), absl::MakeSpan(indices), shape,
+      Shape{1, 3}, 1, false)));
+}
+
+TEST(Parallel, SortAndTopKMatchSerial) {
+  auto thread_pool = ThreadPool::Create(3);
+  Shape shape = {256, 1000};
+  auto src = MakePattern<float>(GetShapeElementCount(shape));
+  std::vector<int32_t> expected(src.size()), dst(src.size());
+  IREE_ASSERT_OK(Sort::Execute<float>(src, absl::MakeSpan(expected), shape, 1,
+                                      true, false));
+  IREE_ASSERT_OK(Sort::Execute<float>(src, absl::MakeSpan(dst), shape, 1,
+                                      true, false, thread_pool.get()));
+  EXPECT_EQ(expected, dst);
+
+  Shape dst_shape = {256, 10};
+  std::vector<float> expected_values(2560), values(2560);
+  std::vector<int32_t> expected_indices(2560), indices(2560);
+  IREE_ASSERT_OK(TopK::Execute<float>(
+      src, absl::MakeSpan(expected_values), absl::MakeSpan(expected_indices),
+      shape, dst_shape, 1, true));
+  IREE_ASSERT_OK(TopK::Execute<float>(
+      src, absl::MakeSpan(values), absl::MakeSpan(indices), shape, dst_shape,
+      1, true, thread_pool.get()));
+  EXPECT_EQ(expected_values, values);
+  EXPECT_EQ(expected_indices, indices);
+}
+
+// Returns the fixed-point form of |value| as the compiler would compute it.
+QuantizedMultiplier MakeQuantizedMultiplier(double value) {
+  int exponent = 0;
+  double mantissa = std::frexp(value, &exponent);
+  auto multiplier = static_cast<int64_t>(std::round(mantissa * (1ll << 31)));
+  if (multiplier == (1ll << 31)) {
+    multiplier /= 2;
+    ++exponent;
+  }
+  return {static_cast<int32_t>(multiplier), exponent};
+}
+
+// Quantization parameters of a tensor.
+struct QuantParams {
+  float scale;
+  int32_t zero_point;
+};
+
+std::vector<int8_t> QuantizeReference(absl::Span<const float> values,
+                                      QuantParams params) {
+  std::vector<int8_t> result(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    float q = std::round(values[i] / params.scale) + params.zero_point;
+    result[i] = static_cast<int8_t>(std::min(std::max(q, -128.0f), 127.0f));
+  }
+  return result;
+}
+
+std::vector<float> DequantizeReference(absl::Span<const int8_t> values,
+                                       QuantParams params) {
+  std::vector<float> result(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    result[i] = (values[i] - params.zero_point) * params.scale;
+  }
+  return result;
+}
+
+// Expects quantized results to be within one step of the reference.
+void ExpectWithinOneStep(absl::Span<const int8_t> expected,
+                         absl::Span<const int8_t> actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_LE(std::abs(expected[i] - actual[i]), 1) << "index " << i;
+  }
+}
+
+std::vector<int8_t> MakeInt8Pattern(size_t size, int seed) {
+  std::vector<int8_t> v(size);
+  for (size_t i = 0; i < size; ++i) {
+    v[i] = static_cast<int8_t>(((i + seed) * 7919) % 256 - 128);
+  }
+  return v;
+}
+
+TEST(Quantize, RoundTrip) {
+  const QuantParams params = {0.05f, -3};
+  std::vector<float> src = {-7.0f, -1.234f, -0.025f, 0.0f, 0.024f, 0.026f,
+                            1.0f,  6.5f,    100.0f,  NAN};
+  std::vector<int8_t> quantized(src.size());
+  IREE_ASSERT_OK(Quantize::Execute<int8_t>(
+      src, absl::MakeSpan(quantized), params.zero_point,
+      MakeQuantizedMultiplier(1.0 / params.scale)));
+  EXPECT_EQ((std::vector<int8_t>{-128, -28, -4, -3, -3, -2, 17, 127, 127, -3}),
+            quantized);
+
+  std::vector<float> dequantized(src.size());
+  IREE_ASSERT_OK(Dequantize::Execute<int8_t>(
+      quantized, absl::MakeSpan(dequantized), params.zero_point,
+      MakeQuantizedMultiplier(params.scale)));
+  for (size_t i = 1; i < 7; ++i) {
+    EXPECT_NEAR(src[i], dequantized[i], params.scale / 2 + kEpsilon);
+  }
+}
+
+TEST(QuantizedAdd, MatchesFloatReference) {
+  const QuantParams lhs_params = {0.02f, 5};
+  const QuantParams rhs_params = {0.07f, -12};
+  const QuantParams dst_params = {0.08f, 3};
+  auto lhs = MakeInt8Pattern(256, 0);
+  auto rhs = MakeInt8Pattern(256, 17);
+
+  // Multipliers are derived as in the compiler.
+  const double twice_max_scale =
+      2.0 * std::max(lhs_params.scale, rhs_params.scale);
+  std::vector<int8_t> dst(lhs.size());
+  IREE_ASSERT_OK(QuantizedAdd::Execute<int8_t>(
+      lhs, lhs_params.zero_point,
+      MakeQuantizedMultiplier(lhs_params.scale / twice_max_scale), rhs,
+      rhs_params.zero_point,
+      MakeQuantizedMultiplier(rhs_params.scale / twice_max_scale),
+      absl::MakeSpan(dst), dst_params.zero_point,
+      MakeQuantizedMultiplier(twice_max_scale /
+                              ((1 << QuantizedAdd::kLeftShift) *
+                               static_cast<double>(dst_params.scale)))));
+
+  auto lhs_real = DequantizeReference(lhs, lhs_params);
+  auto rhs_real = DequantizeReference(rhs, rhs_params);
+  std::vector<float> sum(lhs.size());
+  for (size_t i = 0; i < sum.size(); ++i) sum[i] = lhs_real[i] + rhs_real[i];
+  ExpectWithinOneStep(QuantizeReference(sum, dst_params), dst);
+}
+
+TEST(QuantizedMul, MatchesFloatReference) {
+  const QuantParams lhs_params = {0.02f, 5};
+  const QuantParams rhs_params = {0.03f, -12};
+  const QuantParams dst_params = {0.1f, -7};
+  auto lhs = MakeInt8Pattern(256, 3);
+  auto rhs = MakeInt8Pattern(256, 41);
+
+  std::vector<int8_t> dst(lhs.size());
+  IREE_ASSERT_OK(QuantizedMul::Execute<int8_t>(
+      lhs, lhs_params.zero_point, rhs, rhs_params.zero_point,
+      absl::MakeSpan(dst), dst_params.zero_point,
+      MakeQuantizedMultiplier(static_cast<double>(lhs_params.scale) *
+                              rhs_params.scale / dst_params.scale)));
+
+  auto lhs_real = DequantizeReference(lhs, lhs_params);
+  auto rhs_real = DequantizeReference(rhs, rhs_params);
+  std::vector<float> product(lhs.size());
+  for (size_t i = 0; i < product.size(); ++i) {
+    product[i] = lhs_real[i] * rhs_real[i];
+  }
+  ExpectWithinOneStep(QuantizeReference(product, dst_params), dst);
+}
+
+// Quantized convolution test case with per-channel filter scales.
+struct QuantizedConv2DCase {
+  Shape input_shape;
+  Shape filter_shape;
+  Shape dst_shape;
+  Shape strides;
+  Shape pad_h;
+  Shape pad_w;
+  int32_t groups;
+
+  QuantParams input_params = {0.05f, 7};
+  QuantParams dst_params = {0.5f, -4};
+  std::vector<int8_t> input;
+  std::vector<int8_t> filter;
+  std::vector<float> filter_scales;
+  std::vector<int32_t> bias;
+  std::vector<int32_t> multiplier_mantissa;
+  std::vector<int32_t> multiplier_exponent;
+
+  QuantizedConv2DCase(Shape input_shape, Shape filter_shape, Shape dst_shape,
+                      Shape strides, Shape pad_h, Shape pad_w, int32_t groups)
+      : input_shape(input_shape),
+        filter_shape(filter_shape),
+        dst_shape(dst_shape),
+        strides(strides),
+        pad_h(pad_h),
+        pad_w(pad_w),
+        groups(groups) {
+    input = MakeInt8Pattern(GetShapeElementCount(input_shape), 0);
+    filter = MakeInt8Pattern(GetShapeElementCount(filter_shape), 29);
+    const int output_c = dst_shape[2];
+    for (int c = 0; c < output_c; ++c) {
+      filter_scales.push_back(0.002f * (c + 1));
+      const double accumulator_scale =
+          static_cast<double>(input_params.scale) * filter_scales[c];
+      bias.push_back(static_cast<int32_t>(std::round((c - 2) / 4.0 /
+                                                     accumulator_scale)));
+      auto multiplier =
+          MakeQuantizedMultiplier(accumulator_scale / dst_params.scale);
+      multiplier_mantissa.push_back(multiplier.multiplier);
+      multiplier_exponent.push_back(multiplier.exponent);
+    }
+  }
+
+  QuantizedConv2D::Params params() const {
+    QuantizedConv2D::Params params;
+    params.input_zero_point = input_params.zero_point;
+    params.dst_zero_point = dst_params.zero_point;
+    params.bias = bias;
+    params.multiplier_mantissa = multiplier_mantissa;
+    params.multiplier_exponent = multiplier_exponent;
+    return params;
+  }
+
+  // Computes the result by dequantizing, convolving in float and quantizing.
+  std::vector<int8_t> FloatReference() const {
+    auto input_real = DequantizeReference(input, input_params);
+    // Conv2D takes grouped filters as [kh, kw, input_c, output_group_size]
+    // while the quantized kernel uses [kh, kw, input_group_size, output_c].
+    const int input_c = input_shape[2];
+    const int output_c = dst_shape[2];
+    const int input_group_size = input_c / groups;
+    const int output_group_size = output_c / groups;
+    const int kernel_size = filter_shape[0] * filter_shape[1];
+    std::vector<float> filter_real(filter.size());
+    for (int k = 0; k < kernel_size; ++k) {
+      for (int ci = 0; ci < input_group_size; ++ci) {
+        for (int co = 0; co < output_c; ++co) {
+          const int g = co / output_group_size;
+          const int src = (k * input_group_size + ci) * output_c + co;
+          const int dst = (k * input_c + g * input_group_size + ci) *
+                              output_group_size +
+                          co % output_group_size;
+          filter_real[dst] = filter[src] * filter_scales[co];
+        }
+      }
+    }
+    std::vector<float> dst_real(GetShapeElementCount(dst_shape));
+    const Shape dilation = {1, 1};
+    const Shape filter_real_shape = {filter_shape[0], filter_shape[1], input_c,
+                                     output_group_size};
+    IREE_CHECK_OK(Conv2D::Execute<float>(
+        input_real, input_shape, filter_real, filter_real_shape,
+        absl::MakeSpan(dst_real), dst_shape, strides, pad_h, pad_w, dilation,
+        groups));
+    for (size_t i = 0; i < dst_real.size(); ++i) {
+      const int c = i % output_c;
+      dst_real[i] += bias[c] * input_params.scale * filter_scales[c];
+    }
+    return QuantizeReference(dst_real, dst_params);
+  }
+};
+
+TEST(QuantizedConv2D, DirectMatchesFloatReference) {
+  QuantizedConv2DCase test_case({7, 6, 3}, {3, 2, 3, 5}, {4, 6, 5}, {2, 1},
+                                {1, 1}, {0, 1}, 1);
+  std::vector<int8_t> dst(GetShapeElementCount(test_case.dst_shape));
+  const Shape dilation = {1, 1};
+  IREE_ASSERT_OK(QuantizedConv2D::Execute<int8_t>(
+      test_case.input, test_case.input_shape, test_case.filter,
+      test_case.filter_shape, absl::MakeSpan(dst), test_case.dst_shape,
+      test_case.params(), test_case.strides, test_case.pad_h, test_case.pad_w,
+      dilation, 1));
+  ExpectWithinOneStep(test_case.FloatReference(), dst);
+}
+
+TEST(QuantizedConv2D, DepthwiseMatchesFloatReference) {
+  QuantizedConv2DCase test_case({5, 5, 4}, {3, 3, 1, 4}, {5, 5, 4}, {1, 1},
+                                {1, 1}, {1, 1}, 4);
+  std::vector<int8_t> dst(GetShapeElementCount(test_case.dst_shape));
+  const Shape dilation = {1, 1};
+  RuntimeState runtime_state;
+  IREE_ASSERT_OK(QuantizedConv2D::Execute<int8_t>(
+      runtime_state.mat_mul_state.get(), test_case.input,
+      test_case.input_shape, test_case.filter, test_case.filter_shape,
+      absl::MakeSpan(dst), test_case.dst_shape, test_case.params(),
+      test_case.strides, test_case.pad_h, test_case.pad_w, dilation, 4));
+  ExpectWithinOneStep(test_case.FloatReference(), dst);
+}
+
+TEST(QuantizedConv2D, Im2ColMatchesDirect) {
+  QuantizedConv2DCase test_case({9, 8, 6}, {3, 3, 6, 7}, {5, 8, 7}, {2, 1},
+                                {1, 1}, {1, 1}, 1);
+  const Shape dilation = {1, 1};
+  std::vector<int8_t> expected(GetShapeElementCount(test_case.dst_shape));
+  IREE_ASSERT_OK(QuantizedConv2D::Execute<int8_t>(
+      test_case.input, test_case.input_shape, test_case.filter,
+      test_case.filter_shape, absl::MakeSpan(expected), test_case.dst_shape,
+      test_case.params(), test_case.strides, test_case.pad_h, test_case.pad_w,
+      dilation, 1));
+
+  RuntimeState runtime_state;
+  std::vector<int8_t> dst(expected.size());
+  IREE_ASSERT_OK(QuantizedConv2D::Execute<int8_t>(
+      runtime_state.mat_mul_state.get(), test_case.input,
+      test_case.input_shape, test_case.filter, test_case.filter_shape,
+      absl::MakeSpan(dst), test_case.dst_shape, test_case.params(),
+      test_case.strides, test_case.pad_h, test_case.pad_w, dilation, 1));
+  EXPECT_EQ(expected, dst);
+
+  // A single multiplier applies to all channels.
+  auto params = test_case.params();
+  params.multiplier_mantissa = absl::MakeConstSpan(
+      test_case.multiplier_mantissa.data(), 1);
+  params.multiplier_exponent = absl::MakeConstSpan(
+      test_case.multiplier_exponent.data(), 1);
+  IREE_ASSERT_OK(QuantizedConv2D::Execute<int8_t>(
+      test_case.input, test_case.input_shape, test_case.filter,
+      test_case.filter_shape, absl::MakeSpan(expected), test_case.dst_shape,
+      params, test_case.strides, test_case.pad_h, test_case.pad_w, dilation,
+      1));
+  IREE_ASSERT_OK(QuantizedConv2D::Execute<int8_t>(
+      runtime_state.mat_mul_state.get(), test_case.input,
+      test_case.input_shape, test_case.filter, test_case.filter_shape,
+      absl::MakeSpan(dst), test_case.dst_shape, params, test_case.strides,
+      test_case.pad_h, test_case.pad_w, dilation, 1));
+  EXPECT_EQ(expected, dst);
+}
+
+TEST(PoolingAvg, PaddingIsExcluded) {
+  // 3x3 windows with stride 2 over a 4x4 input padded by 1 on each side.
+  Shape src_shape = {4, 4};
+  Shape dst_shape = {2, 2};
+  Shape window_dimensions = {3, 3};
+  Shape strides = {2, 2};
+  Shape pad_low = {1, 1};
+  std::vector<int8_t> src = {-8, -3, 2,  7,  //
+                             1,  4,  -6, 9,  //
+                             3,  -2, 5,  0,  //
+                             8,  1,  -7, 6};
+  std::vector<int8_t> dst(4);
+  IREE_ASSERT_OK(PoolingAvg::Execute<int8_t>(src, absl::MakeSpan(dst),
+                                             src_shape, dst_shape,
+                                             window_dimensions, strides,
+                                             pad_low));
+  // (-8 - 3 + 1 + 4) / 4 = -1.5 rounds away from zero.
+  // (-3 + 2 + 7 + 4 - 6 + 9) / 6 = 2.17.
+  // (1 + 4 + 3 - 2 + 8 + 1) / 6 = 2.5 rounds away from zero.
+  // (4 - 6 + 9 - 2 + 5 + 0 + 1 - 7 + 6) / 9 = 1.11.
+  EXPECT_EQ((std::vector<int8_t>{-2, 2, 3, 1}), dst);
+
+  std::vector<float> src_float(src.begin(), src.end());
+  std::vector<float> dst_float(4);
+  IREE_ASSERT_OK(PoolingAvg::Execute<float>(
+      src_float, absl::MakeSpan(dst_float), src_shape, dst_shape,
+      window_dimensions, strides, pad_low));
+  EXPECT_NEAR(-1.5f, dst_float[0], kEpsilon);
+  EXPECT_NEAR(13.0f / 6, dst_float[1], kEpsilon);
+  EXPECT_NEAR(2.5f, dst_float[2], kEpsilon);
+  EXPECT_NEAR(10.0f / 9, dst_float[3], kEpsilon);
+}
+
+uint32_t FloatBits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float FloatFromBits(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+TEST(Half, RoundsToNearestEven) {
+  EXPECT_EQ(0x3C00, Half(1.0f).bits);
+  EXPECT_EQ(0xC000, Half(-2.0f).bits);
+  // 1 + 2^-11 is halfway between 1 and the next half; ties round to even.
+  EXPECT_EQ(0x3C00, Half(1.0f + 0.00048828125f).bits);
+  EXPECT_EQ(0x3C02, Half(1.0f + 3 * 0.00048828125f).bits);
+  // 65504 is the largest half; 65520 is halfway to the next power of two.
+  EXPECT_EQ(0x7BFF, Half(65519.0f).bits);
+  EXPECT_EQ(0x7C00, Half(65520.0f).bits);
+  EXPECT_EQ(0xFC00, Half(-std::numeric_limits<float>::infinity()).bits);
+  // Subnormals and underflow.
+  EXPECT_EQ(0x0001, Half(5.9604645e-08f).bits);
+  EXPECT_EQ(0x0000, Half(2.9802322e-08f).bits);
+  EXPECT_EQ(0x8000, Half(-0.0f).bits);
+  EXPECT_TRUE(std::isnan(static_cast<float>(
+      Half(std::numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST(Half, RoundTripsAllValues) {
+  for (uint32_t bits = 0; bits <= 0xFFFF; ++bits) {
+    Half value;
+    value.bits = static_cast<uint16_t>(bits);
+    float widened = value;
+    if ((bits & 0x7C00) == 0x7C00 && (bits & 0x3FF) != 0) {
+      EXPECT_TRUE(std::isnan(widened));
+    } else {
+      EXPECT_EQ(bits, Half(widened).bits);
+    }
+  }
+}
+
+TEST(BFloat16, RoundsToNearestEven) {
+  EXPECT_EQ(0x3F80, BFloat16(1.0f).bits);
+  EXPECT_EQ(0x3F80, BFloat16(FloatFromBits(0x3F808000)).bits);
+  EXPECT_EQ(0x3F82, BFloat16(FloatFromBits(0x3F818000)).bits);
+  EXPECT_EQ(0x3F81, BFloat16(FloatFromBits(0x3F808001)).bits);
+  EXPECT_EQ(0x7F80, BFloat16(std::numeric_limits<float>::max()).bits);
+  // Truncating the NaN payload must not produce an infinity.
+  EXPECT_TRUE(std::isnan(
+      static_cast<float>(BFloat16(FloatFromBits(0x7F800001)))));
+  EXPECT_EQ(FloatFromBits(0xC0490000), BFloat16(FloatFromBits(0xC0490000)));
+}
+
+// Converts |count| floats spread over the full range of bit patterns, with a
+// subnormal in every vector, with the vectorized kernels and compares them to
+// the scalar conversions.
+template <typename T>
+void ExpectConvertMatchesScalar(int count) {
+  std::vector<float> src(count);
+  uint32_t bits = 0x12345678;
+  for (int i = 0; i < count; ++i) {
+    bits = bits * 1664525u + 1013904223u;
+    src[i] = FloatFromBits(i % 16 == 5 ? bits & 0x807FFFFF : bits);
+  }
+  std::vector<T> narrowed(count);
+  IREE_ASSERT_OK(
+      (Convert::Execute<float, T>(src, absl::MakeSpan(narrowed))));
+  std::vector<float> widened(count);
+  IREE_ASSERT_OK(
+      (Convert::Execute<T, float>(narrowed, absl::MakeSpan(widened))));
+  for (int i = 0; i < count; ++i) {
+    if (std::isnan(src[i])) {
+      EXPECT_TRUE(std::isnan(widened[i])) << i;
+      continue;
+    }
+    EXPECT_EQ(T(src[i]).bits, narrowed[i].bits) << i << ": " << src[i];
+    EXPECT_EQ(FloatBits(T::ToFloat(narrowed[i].bits)), FloatBits(widened[i]))
+        << i;
+  }
+}
+
+TEST(Convert, HalfMatchesScalar) {
+  ExpectConvertMatchesScalar<Half>(4099);
+}
+
+TEST(Convert, BFloat16MatchesScalar) {
+  ExpectConvertMatchesScalar<BFloat16>(4099);
+}
+
+TEST(Widened, ComputesInFloat) {
+  // Values chosen so that each intermediate is exactly representable in float
+  // but not in half.
+  std::vector<Half> lhs = {Half(2048.0f), Half(1.0f), Half(-3.0f)};
+  std::vector<Half> rhs = {Half(1.0f), Half(3.0f), Half(0.5f)};
+  std::vector<Half> dst(3);
+  IREE_ASSERT_OK(
+      Widened<Add>::Execute<Half>(lhs, rhs, absl::MakeSpan(dst)));
+  // 2049 is a tie between 2048 and 2050 and rounds to even.
+  EXPECT_EQ(2048.0f, dst[0]);
+  EXPECT_EQ(4.0f, dst[1]);
+  EXPECT_EQ(-2.5f, dst[2]);
+
+  IREE_ASSERT_OK(Widened<Div>::Execute<Half>(rhs, lhs, absl::MakeSpan(dst)));
+  EXPECT_EQ(Half(1.0f / 2048).bits, dst[0].bits);
+  EXPECT_EQ(3.0f, dst[1]);
+  EXPECT_EQ(Half(0.5f / -3.0f).bits, dst[2].bits);
+
+  std::vector<BFloat16> src(1500);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = BFloat16(static_cast<float>(i) / 256);
+  }
+  std::vector<BFloat16> exp(src.size());
+  IREE_ASSERT_OK(Widened<Exp>::Execute<BFloat16>(src, absl::MakeSpan(exp)));
+  for (size_t i = 0; i < src.size(); ++i) {
+    std::vector<float> expected(1);
+    IREE_ASSERT_OK(Exp::Execute<float>({static_cast<float>(src[i])},
+                                       absl::MakeSpan(expected)));
+    EXPECT_EQ(BFloat16(expected[0]).bits, exp[i].bits) << i;
+  }
+}
+
+TEST(Widened, Clamp) {
+  std::vector<BFloat16> min = {BFloat16(0.0f), BFloat16(0.0f)};
+  std::vector<BFloat16> value = {BFloat16(-1.5f), BFloat16(7.0f)};
+  std::vector<BFloat16> max = {BFloat16(6.0f), BFloat16(6.0f)};
+  std::vector<BFloat16> dst(2);
+  IREE_ASSERT_OK(Widened<Clamp>::Execute<BFloat16>(min, value, max,
+                                                    absl::MakeSpan(dst)));
+  EXPECT_EQ(0.0f, dst[0]);
+  EXPECT_EQ(6.0f, dst[1]);
+}
+
+TEST(ReduceSum, HalfAccumulatesInFloat) {
+  // Accumulating ones in half stalls at 2048 where the spacing becomes 2.
+  const int32_t kCount = 5000;
+  std::vector<Half> src(kCount, Half(1.0f));
+  std::vector<Half> init_buffer = {Half(0.0f)};
+  std::vector<Half> dst(2);
+  IREE_ASSERT_OK(ReduceSum::Execute<Half>(src, init_buffer,
+                                          absl::MakeSpan(dst).first(1), 0,
+                                          Shape{kCount}, Shape{1}));
+  EXPECT_EQ(Half(5000.0f).bits, dst[0].bits);
+
+  // Columns are widened a block of rows at a time.
+  IREE_ASSERT_OK(ReduceSum::Execute<Half>(src, init_buffer,
+                                          absl::MakeSpan(dst), 0,
+                                          Shape{kCount / 2, 2}, Shape{2}));
+  EXPECT_EQ(Half(2500.0f).bits, dst[0].bits);
+  EXPECT_EQ(Half(2500.0f).bits, dst[1].bits);
+
+  std::vector<Half> max_src = {Half(-3.0f), Half(7.5f), Half(2.0f)};
+  std::vector<Half> max_init = {Half(-65504.0f)};
+  IREE_ASSERT_OK(ReduceMax::Execute<Half>(max_src, max_init,
+                                          absl::MakeSpan(dst).first(1), 0,
+                                          Shape{3}, Shape{1}));
+  EXPECT_EQ(7.5f, dst[0]);
+}
+
+TEST(ReduceSum, BFloat16AccumulatesInFloat) {
+  // Accumulating ones in bfloat16 stalls at 256.
+  std::vector<BFloat16> src(1000, BFloat16(1.0f));
+  std::vector<BFloat16> init_buffer = {BFloat16(0.0f)};
+  std::vector<BFloat16> dst(1);
+  IREE_ASSERT_OK(ReduceSum::Execute<BFloat16>(src, init_buffer,
+                                              absl::MakeSpan(dst), 0,
+                                              Shape{1000}, Shape{1}));
+  EXPECT_EQ(1000.0f, dst[0]);
+}
+
+TEST(PoolingSum, HalfAccumulatesInFloat) {
+  Shape src_shape = {2, 3000};
+  Shape window_dimensions = {1, 3000};
+  Shape strides = {1, 1};
+  Shape pad_low = {0, 0};
+  std::vector<Half> src(6000, Half(1.0f));
+  std::vector<Half> init_buffer = {Half(0.0f)};
+  std::vector<Half> dst(2);
+  IREE_ASSERT_OK(PoolingSum::Execute<Half>(src, init_buffer,
+                                           absl::MakeSpan(dst), src_shape,
+                                           Shape{2, 1}, window_dimensions,
+                                           strides, pad_low));
+  EXPECT_EQ(3000.0f, dst[0]);
+  EXPECT_EQ(3000.0f, dst[1]);
+
+  IREE_ASSERT_OK(PoolingAvg::Execute<Half>(src, absl::MakeSpan(dst),
+                                           src_shape, Shape{2, 1},
+                                           window_dimensions, strides,
+                                           pad_low));
+  EXPECT_EQ(1.0f, dst[0]);
+  EXPECT_EQ(1.0f, dst[1]);
+}
+
+TEST(CompareLT, Half) {
+  std::vector<Half> lhs = {Half(1.0f), Half(-2.0f),
+                           Half(std::numeric_limits<float>::quiet_NaN())};
+  std::vector<Half> rhs = {Half(1.5f), Half(-3.0f), Half(0.0f)};
+  std::vector<uint8_t> dst(3);
+  IREE_ASSERT_OK(CompareLT::Execute<Half>(lhs, rhs, absl::MakeSpan(dst)));
+  EXPECT_EQ((std::vector<uint8_t>{1, 0, 0}), dst);
+}
+
 }  // namespace
 }  // namespace kernels
 }  // namespace vmla
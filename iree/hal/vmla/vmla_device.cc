@@ -26,10 +26,12 @@ namespace vmla {
 VMLADevice::VMLADevice(DeviceInfo device_info,
                        std::unique_ptr<host::SchedulingModel> scheduling_model,
                        iree_vm_instance_t* instance,
-                       iree_vm_module_t* vmla_module)
+                       iree_vm_module_t* vmla_module,
+                       ref_ptr<ThreadPool> thread_pool)
     : HostLocalDevice(std::move(device_info), std::move(scheduling_model)),
       instance_(instance),
-      vmla_module_(vmla_module) {
+      vmla_module_(vmla_module),
+      thread_pool_(std::move(thread_pool)) {
   iree_vm_instance_retain(instance_);
   iree_vm_module_retain(vmla_module_);
 }
@@ -16,6 +16,7 @@
 #define IREE_HAL_VMLA_VMLA_DEVICE_H_
 
 #include "iree/base/memory.h"
+#include "iree/base/thread_pool.h"
 #include "iree/hal/host/host_local_device.h"
 #include "iree/vm/instance.h"
 #include "iree/vm/module.h"
@@ -26,10 +27,12 @@ namespace vmla {
 
 class VMLADevice final : public host::HostLocalDevice {
  public:
+  // |vmla_module| must have been created with |thread_pool|.
   explicit VMLADevice(DeviceInfo device_info,
                       std::unique_ptr<host::SchedulingModel> scheduling_model,
                       iree_vm_instance_t* instance,
-                      iree_vm_module_t* vmla_module);
+                      iree_vm_module_t* vmla_module,
+                      ref_ptr<ThreadPool> thread_pool);
   ~VMLADevice() override;
 
   ref_ptr<ExecutableCache> CreateExecutableCache() override;
@@ -37,6 +40,8 @@ class VMLADevice final : public host::HostLocalDevice {
  private:
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_module_t* vmla_module_ = nullptr;
+  // Workers shared by the kernels of all executables on the device.
+  ref_ptr<ThreadPool> thread_pool_;
 };
 
 }  // namespace vmla
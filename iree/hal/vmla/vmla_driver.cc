@@ -16,6 +16,8 @@
 
 #include <memory>
 
+#include "absl/flags/flag.h"
+#include "iree/base/thread_pool.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/device_info.h"
 #include "iree/hal/host/serial/serial_scheduling_model.h"
@@ -23,6 +25,10 @@
 #include "iree/hal/vmla/vmla_module.h"
 #include "iree/vm/module.h"
 
+ABSL_FLAG(int, vmla_worker_count, -1,
+          "Number of worker threads used by VMLA kernels in addition to the "
+          "calling thread. -1 uses all available hardware threads.");
+
 namespace iree {
 namespace hal {
 namespace vmla {
@@ -56,20 +62,14 @@ StatusOr<ref_ptr<Driver>> VMLADriver::Create() {
   IREE_RETURN_IF_ERROR(ModuleRegisterTypes())
       << "VMLA type registration failed";
 
-  iree_vm_module_t* vmla_module = nullptr;
-  IREE_RETURN_IF_ERROR(ModuleCreate(iree_allocator_system(), &vmla_module))
-      << "VMLA shared module creation failed";
-
-  return make_ref<VMLADriver>(instance, vmla_module);
+  return make_ref<VMLADriver>(instance);
 }
 
-VMLADriver::VMLADriver(iree_vm_instance_t* instance,
-                       iree_vm_module_t* vmla_module)
-    : Driver("vmla"), instance_(instance), vmla_module_(vmla_module) {}
+VMLADriver::VMLADriver(iree_vm_instance_t* instance)
+    : Driver("vmla"), instance_(instance) {}
 
 VMLADriver::~VMLADriver() {
   IREE_TRACE_SCOPE0("VMLADriver::dtor");
-  iree_vm_module_release(vmla_module_);
   iree_vm_instance_release(instance_);
 }
 
@@ -84,10 +84,20 @@ StatusOr<ref_ptr<Device>> VMLADriver::CreateDefaultDevice() {
 }
 
 StatusOr<ref_ptr<Device>> VMLADriver::CreateDevice(DriverDeviceID device_id) {
+  // Each device gets its own kernel thread pool and a VMLA module (shared by
+  // all executables on the device) that splits kernels across it.
+  auto thread_pool =
+      ThreadPool::Create(absl::GetFlag(FLAGS_vmla_worker_count));
+  iree_vm_module_t* vmla_module = nullptr;
+  IREE_RETURN_IF_ERROR(ModuleCreate(iree_allocator_system(), thread_pool.get(),
+                                    &vmla_module))
+      << "VMLA shared module creation failed";
+
   auto scheduling_model = std::make_unique<host::SerialSchedulingModel>();
-  auto device =
-      make_ref<VMLADevice>(GetDefaultDeviceInfo(), std::move(scheduling_model),
-                           instance_, vmla_module_);
+  auto device = make_ref<VMLADevice>(
+      GetDefaultDeviceInfo(), std::move(scheduling_model), instance_,
+      vmla_module, std::move(thread_pool));
+  iree_vm_module_release(vmla_module);
   return device;
 }
 
@@ -27,7 +27,7 @@ class VMLADriver final : public Driver {
  public:
   static StatusOr<ref_ptr<Driver>> Create();
 
-  VMLADriver(iree_vm_instance_t* instance, iree_vm_module_t* vmla_module);
+  explicit VMLADriver(iree_vm_instance_t* instance);
   ~VMLADriver() override;
 
   StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
@@ -38,7 +38,6 @@ class VMLADriver final : public Driver {
 
  private:
   iree_vm_instance_t* instance_ = nullptr;
-  iree_vm_module_t* vmla_module_ = nullptr;
 };
 
 }  // namespace vmla
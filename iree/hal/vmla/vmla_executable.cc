@@ -14,20 +14,69 @@
 
 #include "iree/hal/vmla/vmla_executable.h"
 
+#include <cstddef>
+#include <cstring>
+
+#include "iree/base/arena.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/host/host_buffer.h"
 #include "iree/hal/vmla/vmla_module.h"
 #include "iree/schemas/vmla_executable_def_generated.h"
 #include "iree/vm/bytecode_module.h"
-#include "iree/vm/invocation.h"
-#include "iree/vm/list.h"
 #include "iree/vm/module.h"
+#include "iree/vm/stack.h"
 
 namespace iree {
 namespace hal {
 namespace vmla {
 
+namespace {
+
+// Arguments of the `(interface, x, y, z)` entry function signature laid out
+// as the VM ABI expects them for the `0riii` calling convention.
+struct DispatchArguments {
+  iree_vm_ref_t interface_ref;
+  int32_t workgroup_xyz[3];
+};
+static_assert(offsetof(DispatchArguments, workgroup_xyz) ==
+                  sizeof(iree_vm_ref_t),
+              "ABI packs the i32 arguments directly after the ref");
+
+iree_status_t ArenaAllocateThunk(void* self, iree_allocation_mode_t mode,
+                                 iree_host_size_t byte_length, void** out_ptr) {
+  if ((mode & IREE_ALLOCATION_MODE_TRY_REUSE_EXISTING) && *out_ptr) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "arena allocations cannot be reallocated");
+  }
+  void* ptr = reinterpret_cast<Arena*>(self)->AllocateBytes(byte_length);
+  if (!ptr) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "allocations must be >0 bytes");
+  }
+  if (mode & IREE_ALLOCATION_MODE_ZERO_CONTENTS) {
+    std::memset(ptr, 0, byte_length);
+  }
+  *out_ptr = ptr;
+  return iree_ok_status();
+}
+
+void ArenaFreeThunk(void* self, void* ptr) {
+  // Reclaimed when the arena is reset.
+}
+
+// Returns an allocator that places allocations in |arena|. Frees are ignored
+// and all allocations must be released before the arena is reset.
+iree_allocator_t MakeArenaAllocator(Arena* arena) {
+  iree_allocator_t allocator;
+  allocator.self = arena;
+  allocator.alloc = ArenaAllocateThunk;
+  allocator.free = ArenaFreeThunk;
+  return allocator;
+}
+
+}  // namespace
+
 // static
 StatusOr<ref_ptr<VMLAExecutable>> VMLAExecutable::Load(
     iree_vm_instance_t* instance, iree_vm_module_t* vmla_module,
@@ -92,6 +141,16 @@ Status VMLAExecutable::Initialize(iree_vm_instance_t* instance,
     IREE_RETURN_IF_ERROR(iree_vm_module_lookup_function_by_ordinal(
         bytecode_module, IREE_VM_FUNCTION_LINKAGE_EXPORT, i,
         &entry_functions_[i], nullptr));
+    // DispatchTile calls entry functions directly with a fixed argument
+    // layout so reject anything that doesn't match it.
+    auto signature = iree_vm_function_signature(&entry_functions_[i]);
+    if (!iree_string_view_equal(signature.calling_convention,
+                                iree_make_cstring_view("0riii"))) {
+      iree_vm_module_release(bytecode_module);
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Entry function " << i
+             << " does not have the (interface, x, y, z) signature";
+    }
   }
 
   // Create context and initialize shared state. Note that each executable here
@@ -109,16 +168,25 @@ Status VMLAExecutable::Initialize(iree_vm_instance_t* instance,
 
 struct VMLADispatchState : public HostExecutable::DispatchState {
   VMLADispatchState() { interface_ref = Interface_retain_ref(&interface); }
-  ~VMLADispatchState() override { iree_vm_ref_release(&interface_ref); }
+  ~VMLADispatchState() override {
+    if (stack) iree_vm_stack_deinitialize(stack);
+    iree_vm_ref_release(&interface_ref);
+  }
 
   iree_vm_function_t function;
   Interface interface;
   iree_vm_ref_t interface_ref;
-  iree_host_size_t input_list_size = 0;
+
+  // VM stack reused by all tiles of the dispatch. VMLA devices use the
+  // SerialSchedulingModel so tiles of a dispatch never run concurrently.
+  // The stack lives in |stack_storage| within the dispatch arena and only
+  // touches the heap if a program outgrows it.
+  iree_byte_span_t stack_storage;
+  iree_vm_stack_t* stack = nullptr;
 };
 
-StatusOr<ref_ptr<HostExecutable::DispatchState>>
-VMLAExecutable::PrepareDispatch(const DispatchParams& params) {
+StatusOr<HostExecutable::DispatchStatePtr> VMLAExecutable::PrepareDispatch(
+    const DispatchParams& params, Arena* arena) {
   IREE_TRACE_SCOPE0("VMLAExecutable::PrepareDispatch");
 
   if (params.entry_point >= entry_functions_.size()) {
@@ -126,13 +194,23 @@ VMLAExecutable::PrepareDispatch(const DispatchParams& params) {
            << "Invalid entry point ordinal " << params.entry_point;
   }
 
-  auto dispatch_state = make_ref<VMLADispatchState>();
+  DispatchStatePtr dispatch_state_ptr(arena->Allocate<VMLADispatchState>());
+  auto* dispatch_state =
+      static_cast<VMLADispatchState*>(dispatch_state_ptr.get());
   dispatch_state->function = entry_functions_[params.entry_point];
-  dispatch_state->input_list_size = iree_vm_list_storage_size(
-      /*element_type=*/nullptr, /*interface*/ 1 + /*workgroup_xyz[3]*/ 3);
+  dispatch_state->stack_storage = iree_make_byte_span(
+      arena->AllocateBytes(IREE_VM_STACK_DEFAULT_SIZE),
+      IREE_VM_STACK_DEFAULT_SIZE);
+  IREE_RETURN_IF_ERROR(iree_vm_stack_initialize(
+      dispatch_state->stack_storage, iree_vm_context_state_resolver(context()),
+      iree_allocator_system(), &dispatch_state->stack));
 
   auto* interface = &dispatch_state->interface;
-  IREE_RETURN_IF_ERROR(interface->SetConstants(params.push_constants->values));
+  IREE_RETURN_IF_ERROR(interface->SetConstants(params.push_constants));
+
+  // The binding buffers are released with the dispatch state so their headers
+  // can live in the arena alongside it.
+  iree_allocator_t header_allocator = MakeArenaAllocator(arena);
 
   for (int set_ordinal = 0; set_ordinal < params.set_bindings.size();
        ++set_ordinal) {
@@ -143,14 +221,50 @@ VMLAExecutable::PrepareDispatch(const DispatchParams& params) {
       data = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(data) +
                                      binding.buffer->byte_offset());
       IREE_ASSIGN_OR_RETURN(
-          auto buffer, Buffer::WrapMutable(data, binding.buffer->byte_length(),
-                                           iree_allocator_null()));
+          auto buffer,
+          Buffer::WrapMutable(data, binding.buffer->byte_length(),
+                              iree_allocator_null(), header_allocator));
       IREE_RETURN_IF_ERROR(interface->SetBinding(set_ordinal, binding.binding,
                                                  {std::move(buffer)}));
     }
   }
 
-  return std::move(dispatch_state);
+  return std::move(dispatch_state_ptr);
+}
+
+// Calls the entry function of |state| for a single tile on |stack|, skipping
+// the list marshaling iree_vm_invoke would perform.
+static iree_status_t CallEntryFunction(iree_vm_stack_t* stack,
+                                       VMLADispatchState* state,
+                                       std::array<uint32_t, 3> workgroup_xyz) {
+  DispatchArguments arguments;
+  std::memset(&arguments, 0, sizeof(arguments));
+  iree_vm_ref_retain(&state->interface_ref, &arguments.interface_ref);
+  for (int i = 0; i < workgroup_xyz.size(); ++i) {
+    arguments.workgroup_xyz[i] = static_cast<int32_t>(workgroup_xyz[i]);
+  }
+
+  iree_vm_function_call_t call;
+  std::memset(&call, 0, sizeof(call));
+  call.function = state->function;
+  call.arguments = iree_make_byte_span(&arguments, sizeof(arguments));
+  iree_vm_execution_result_t result;
+  std::memset(&result, 0, sizeof(result));
+  iree_vm_module_t* module = call.function.module;
+  iree_status_t status =
+      module->begin_call(module->self, stack, &call, &result);
+
+  // The callee takes ownership of the interface ref on entry so this is only
+  // non-null if the call failed before getting that far.
+  iree_vm_ref_release(&arguments.interface_ref);
+  if (iree_status_is_ok(status) &&
+      (result.flags & IREE_VM_EXECUTION_RESULT_FLAG_YIELDED)) {
+    // Nothing would resume the call and the tile would silently be left
+    // incomplete.
+    return UnimplementedErrorBuilder(IREE_LOC)
+           << "Executable entry functions must not yield";
+  }
+  return status;
 }
 
 Status VMLAExecutable::DispatchTile(DispatchState* state,
@@ -158,26 +272,18 @@ Status VMLAExecutable::DispatchTile(DispatchState* state,
   IREE_TRACE_SCOPE0("VMLAExecutable::DispatchTile");
   auto* dispatch_state = static_cast<VMLADispatchState*>(state);
 
-  auto* input_list_storage = alloca(dispatch_state->input_list_size);
-  iree_vm_list_t* input_list = nullptr;
-  IREE_RETURN_IF_ERROR(iree_vm_list_initialize(
-      iree_make_byte_span(input_list_storage, dispatch_state->input_list_size),
-      /*element_type=*/nullptr,
-      /*interface*/ 1 + /*workgroup_xyz[3]*/ 3, &input_list));
-  iree_vm_list_push_ref_retain(input_list, &dispatch_state->interface_ref);
-  for (int i = 0; i < workgroup_xyz.size(); ++i) {
-    iree_vm_value_t value = iree_vm_value_make_i32(workgroup_xyz[i]);
-    iree_vm_list_push_value(input_list, &value);
+  Status status = Status(
+      CallEntryFunction(dispatch_state->stack, dispatch_state, workgroup_xyz));
+  if (!status.ok()) {
+    // Failed or yielded calls may leave frames behind. Reset the stack in
+    // place (without reallocating) so that any remaining tiles start clean.
+    iree_vm_stack_deinitialize(dispatch_state->stack);
+    dispatch_state->stack = nullptr;
+    IREE_RETURN_IF_ERROR(iree_vm_stack_initialize(
+        dispatch_state->stack_storage,
+        iree_vm_context_state_resolver(context()), iree_allocator_system(),
+        &dispatch_state->stack));
   }
-
-  // TODO(benvanik): switch to direct calling to avoid the invoke overhead.
-  auto status =
-      Status(iree_vm_invoke(context(), dispatch_state->function,
-                            /*policy=*/nullptr, input_list,
-                            /*outputs=*/nullptr, iree_allocator_system()));
-
-  iree_vm_list_deinitialize(input_list);
-
   return status;
 }
 
@@ -57,8 +57,8 @@ class VMLAExecutable final : public HostExecutable {
     return absl::MakeConstSpan(entry_functions_);
   }
 
-  StatusOr<ref_ptr<DispatchState>> PrepareDispatch(
-      const DispatchParams& params) override;
+  StatusOr<DispatchStatePtr> PrepareDispatch(const DispatchParams& params,
+                                              Arena* arena) override;
   Status DispatchTile(DispatchState* state,
                       std::array<uint32_t, 3> workgroup_xyz) override;
 
@@ -15,9 +15,17 @@
 #include "iree/hal/vmla/vmla_module.h"
 
 #include <cstdint>
-
+#include <new>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/functional/function_ref.h"
 #include "absl/types/span.h"
 #include "iree/base/tracing.h"
+#include "iree/hal/vmla/buffer_pool.h"
 #include "iree/hal/vmla/op_kernels.h"
 #include "iree/vm/module_abi_packing.h"
 
@@ -57,24 +65,55 @@ Status ModuleRegisterTypes() {
 // API type implementations
 //===----------------------------------------------------------------------===//
 
+namespace {
+
+// Byte length of the Buffer object when followed by its contents, padded so
+// that the contents keep the alignment of the allocator.
+constexpr size_t kBufferHeaderSize = (sizeof(Buffer) + 15) & ~size_t{15};
+
+// Alignment of the contents of allocated buffers. The compiler places
+// transient buffers at cache line aligned offsets within a single arena
+// allocation (see PlanBufferAllocations) which only holds if the arena itself
+// starts on a cache line.
+constexpr size_t kBufferDataAlignment = 64;
+
+}  // namespace
+
+// static
+StatusOr<vm::ref<Buffer>> Buffer::Create(size_t extra_byte_length,
+                                         iree_allocator_t header_allocator) {
+  void* storage = nullptr;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      header_allocator, kBufferHeaderSize + extra_byte_length, &storage))
+      << "Failed to allocate buffer of size " << extra_byte_length;
+  auto buffer = vm::assign_ref(new (storage) Buffer());
+  buffer->allocator_ = iree_allocator_null();
+  buffer->header_allocator_ = header_allocator;
+  return std::move(buffer);
+}
+
 // static
 StatusOr<vm::ref<Buffer>> Buffer::Allocate(size_t byte_length,
                                            iree_allocator_t allocator) {
-  void* data = nullptr;
-  IREE_RETURN_IF_ERROR(iree_allocator_malloc(allocator, byte_length, &data))
-      << "Failed to allocate buffer of size " << byte_length;
-
-  auto buffer = vm::assign_ref(new Buffer());
-  buffer->data_ = data;
+  // The contents are released along with the buffer object. Allocators only
+  // guarantee 16 byte alignment so the contents are over-allocated and
+  // aligned up.
+  IREE_ASSIGN_OR_RETURN(
+      auto buffer, Create(byte_length + kBufferDataAlignment - 1, allocator));
+  uintptr_t data_ptr =
+      reinterpret_cast<uintptr_t>(buffer.get()) + kBufferHeaderSize;
+  data_ptr =
+      (data_ptr + kBufferDataAlignment - 1) & ~(kBufferDataAlignment - 1);
+  buffer->data_ = reinterpret_cast<void*>(data_ptr);
   buffer->data_length_ = byte_length;
-  buffer->allocator_ = allocator;
   return std::move(buffer);
 }
 
 // static
 StatusOr<vm::ref<Buffer>> Buffer::Wrap(const void* data, size_t data_length,
-                                       iree_allocator_t allocator) {
-  auto buffer = vm::assign_ref(new Buffer());
+                                       iree_allocator_t allocator,
+                                       iree_allocator_t header_allocator) {
+  IREE_ASSIGN_OR_RETURN(auto buffer, Create(0, header_allocator));
   buffer->data_ = const_cast<void*>(data);
   buffer->data_length_ = data_length;
   buffer->allocator_ = allocator;
@@ -82,15 +121,23 @@ StatusOr<vm::ref<Buffer>> Buffer::Wrap(const void* data, size_t data_length,
 }
 
 // static
-StatusOr<vm::ref<Buffer>> Buffer::WrapMutable(void* data, size_t data_length,
-                                              iree_allocator_t allocator) {
-  auto buffer = vm::assign_ref(new Buffer());
+StatusOr<vm::ref<Buffer>> Buffer::WrapMutable(
+    void* data, size_t data_length, iree_allocator_t allocator,
+    iree_allocator_t header_allocator) {
+  IREE_ASSIGN_OR_RETURN(auto buffer, Create(0, header_allocator));
   buffer->data_ = data;
   buffer->data_length_ = data_length;
   buffer->allocator_ = allocator;
   return std::move(buffer);
 }
 
+// static
+void Buffer::Delete(Buffer* buffer) {
+  iree_allocator_t header_allocator = buffer->header_allocator_;
+  buffer->~Buffer();
+  iree_allocator_free(header_allocator, buffer);
+}
+
 Buffer::~Buffer() {
   if (!parent_) {
     iree_allocator_free(allocator_, data_);
@@ -190,7 +237,8 @@ class VMLAModuleState final {
  public:
   VMLAModuleState(iree_allocator_t allocator,
                   kernels::RuntimeState* kernel_state)
-      : allocator_(allocator), kernel_state_(kernel_state) {}
+      : buffer_pool_(BufferPool::Create(allocator)),
+        kernel_state_(kernel_state) {}
 
   ~VMLAModuleState() = default;
 
@@ -224,18 +272,23 @@ class VMLAModuleState final {
     external_allocator.free = +[](void* self, void* ptr) {
       vm::assign_ref(reinterpret_cast<iree_vm_ro_byte_buffer_t*>(self)).reset();
     };
-    return Buffer::Wrap(value->data.data, value->data.data_length,
-                        external_allocator);
+    IREE_ASSIGN_OR_RETURN(
+        auto buffer,
+        Buffer::Wrap(value->data.data, value->data.data_length,
+                     external_allocator, buffer_pool_->allocator()));
+    buffer->set_is_constant(true);
+    return std::move(buffer);
   }
 
   StatusOr<vm::ref<Buffer>> BufferAlloc(iree_vmla_size_t byte_length) {
     IREE_TRACE_SCOPE0("VMLAModuleState::BufferAlloc");
-    return Buffer::Allocate(byte_length, allocator_);
+    return Buffer::Allocate(byte_length, buffer_pool_->allocator());
   }
 
   StatusOr<vm::ref<Buffer>> BufferClone(vm::ref<Buffer> src) {
     IREE_TRACE_SCOPE0("VMLAModuleState::BufferClone");
-    IREE_ASSIGN_OR_RETURN(auto dst, Buffer::Allocate(src->size(), allocator_));
+    IREE_ASSIGN_OR_RETURN(
+        auto dst, Buffer::Allocate(src->size(), buffer_pool_->allocator()));
     std::memcpy(dst->data(), src->data(), dst->size());
     return std::move(dst);
   }
@@ -275,12 +328,17 @@ class VMLAModuleState final {
     uint8_t* data = reinterpret_cast<uint8_t*>(src->data()) + byte_offset;
     size_t data_length = byte_length;
 
+    const bool is_constant = src->is_constant();
     iree_allocator_t external_allocator = {0};
     external_allocator.self = vm::retain_ref(src).release();
     external_allocator.free = +[](void* self, void* ptr) {
       vm::assign_ref(reinterpret_cast<Buffer*>(self)).reset();
     };
-    return Buffer::Wrap(data, data_length, external_allocator);
+    IREE_ASSIGN_OR_RETURN(auto view,
+                          Buffer::Wrap(data, data_length, external_allocator,
+                                       buffer_pool_->allocator()));
+    view->set_is_constant(is_constant);
+    return std::move(view);
   }
 
   Status BufferCopy(vm::ref<Buffer> src, iree_vmla_size_t src_byte_offset,
@@ -336,25 +394,116 @@ class VMLAModuleState final {
     return kernel::Execute<type>(dst->As<type>()); \
   }
 
-#define IREE_VMLA_UNARY_OP(name, kernel, type)                      \
-  Status name(vm::ref<Buffer> src, vm::ref<Buffer> dst) {           \
-    IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                   \
-    return kernel::Execute<type>(src->As<type>(), dst->As<type>()); \
+  // Runs |fn| over disjoint ranges of |count| independent elements. Large
+  // elementwise ops are split across the device thread pool.
+  Status ForEachElementRange(size_t count,
+                             absl::FunctionRef<Status(size_t, size_t)> fn) {
+    return kernels::ParallelFor(thread_pool(), count,
+                                kernels::kMinParallelWork, fn);
+  }
+
+  // 16-bit float (Half and BFloat16) reductions and pooling accumulate in
+  // float within the kernels and elementwise ops widen in chunks with
+  // kernels::Widened. Convolutions and matmuls run their float implementation
+  // one batch element at a time on pooled float scratch buffers, with widened
+  // copies of constant weights cached across invocations.
+
+  // Converts the 16-bit float |src_buffer| into |dst_buffer|.
+  template <typename T>
+  Status WidenSpan(absl::Span<const T> src_buffer,
+                   absl::Span<float> dst_buffer) {
+    return ForEachElementRange(
+        src_buffer.size(), [&](size_t begin, size_t end) {
+          const size_t length = end - begin;
+          return kernels::Convert::Execute<T, float>(
+              src_buffer.subspan(begin, length),
+              dst_buffer.subspan(begin, length));
+        });
+  }
+
+  // Rounds the float |src_buffer| into the 16-bit float |dst_buffer|.
+  template <typename T>
+  Status NarrowSpan(absl::Span<const float> src_buffer,
+                    absl::Span<T> dst_buffer) {
+    return ForEachElementRange(
+        dst_buffer.size(), [&](size_t begin, size_t end) {
+          const size_t length = end - begin;
+          return kernels::Convert::Execute<float, T>(
+              src_buffer.subspan(begin, length),
+              dst_buffer.subspan(begin, length));
+        });
+  }
+
+  // Returns a zeroed float buffer with |element_count| elements.
+  StatusOr<vm::ref<Buffer>> AllocateFloatBuffer(size_t element_count) {
+    return Buffer::Allocate(element_count * sizeof(float),
+                            buffer_pool_->allocator());
+  }
+
+  // Returns a float copy of the 16-bit float weights in |src|. Copies of
+  // constant buffers are cached so that they are only widened once.
+  template <typename T>
+  StatusOr<vm::ref<Buffer>> WidenWeights(const vm::ref<Buffer>& src) {
+    auto src_buffer = src->As<T>();
+    const auto key = std::make_pair(src->data(), src->size());
+    if (src->is_constant()) {
+      auto it = widened_constants_.find(key);
+      if (it != widened_constants_.end()) return vm::retain_ref(it->second);
+    }
+    IREE_ASSIGN_OR_RETURN(auto dst, AllocateFloatBuffer(src_buffer.size()));
+    IREE_RETURN_IF_ERROR(WidenSpan<T>(src_buffer, dst->template As<float>()));
+    if (src->is_constant()) {
+      // The cached copy is never written again so it is constant as well.
+      dst->set_is_constant(true);
+      widened_constants_[key] = vm::retain_ref(dst);
+    }
+    return std::move(dst);
+  }
+
+#define IREE_VMLA_UNARY_OP(name, kernel, type)                              \
+  Status name(vm::ref<Buffer> src, vm::ref<Buffer> dst) {                   \
+    IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                           \
+    auto src_buffer = src->As<type>();                                      \
+    auto dst_buffer = dst->As<type>();                                      \
+    return ForEachElementRange(                                             \
+        dst_buffer.size(), [&](size_t begin, size_t end) {                  \
+          const size_t length = end - begin;                                \
+          return kernel::Execute<type>(src_buffer.subspan(begin, length),   \
+                                       dst_buffer.subspan(begin, length));  \
+        });                                                                 \
   }
 
 #define IREE_VMLA_BINARY_OP(name, kernel, type)                                \
   Status name(vm::ref<Buffer> lhs, vm::ref<Buffer> rhs, vm::ref<Buffer> dst) { \
     IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                              \
-    return kernel::Execute<type>(lhs->As<type>(), rhs->As<type>(),             \
-                                 dst->As<type>());                             \
+    auto lhs_buffer = lhs->As<type>();                                         \
+    auto rhs_buffer = rhs->As<type>();                                         \
+    auto dst_buffer = dst->As<type>();                                         \
+    return ForEachElementRange(                                                \
+        dst_buffer.size(), [&](size_t begin, size_t end) {                     \
+          const size_t length = end - begin;                                   \
+          return kernel::Execute<type>(lhs_buffer.subspan(begin, length),      \
+                                       rhs_buffer.subspan(begin, length),      \
+                                       dst_buffer.subspan(begin, length));     \
+        });                                                                    \
   }
 
 #define IREE_VMLA_TERNARY_OP(name, kernel, type)                              \
   Status name(vm::ref<Buffer> a, vm::ref<Buffer> b, vm::ref<Buffer> c,        \
               vm::ref<Buffer> dst) {                                          \
     IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                             \
-    return kernel::Execute<type>(a->As<type>(), b->As<type>(), c->As<type>(), \
-                                 dst->As<type>());                            \
+    auto a_buffer = a->As<type>();                                            \
+    auto b_buffer = b->As<type>();                                            \
+    auto c_buffer = c->As<type>();                                            \
+    auto dst_buffer = dst->As<type>();                                        \
+    return ForEachElementRange(                                               \
+        dst_buffer.size(), [&](size_t begin, size_t end) {                    \
+          const size_t length = end - begin;                                  \
+          return kernel::Execute<type>(a_buffer.subspan(begin, length),       \
+                                       b_buffer.subspan(begin, length),       \
+                                       c_buffer.subspan(begin, length),       \
+                                       dst_buffer.subspan(begin, length));    \
+        });                                                                   \
   }
 
   //===--------------------------------------------------------------------===//
@@ -402,6 +551,8 @@ class VMLAModuleState final {
   IREE_VMLA_COMPARE_OP(CmpI16, int16_t);
   IREE_VMLA_COMPARE_OP(CmpI32, int32_t);
   IREE_VMLA_COMPARE_OP(CmpF32, float);
+  IREE_VMLA_COMPARE_OP(CmpF16, kernels::Half);
+  IREE_VMLA_COMPARE_OP(CmpBF16, kernels::BFloat16);
 
 #define IREE_VMLA_SELECT_OP(name, type)                                       \
   Status name(vm::ref<Buffer> cond, vm::ref<Buffer> lhs, vm::ref<Buffer> rhs, \
@@ -421,6 +572,8 @@ class VMLAModuleState final {
     return kernel::Execute<type>(src->As<type>(), dst->As<bool>()); \
   }
   IREE_VMLA_UNARY_PREDICATE_OP(FiniteF32, kernels::Finite, float);
+  IREE_VMLA_UNARY_PREDICATE_OP(FiniteF16, kernels::Finite, kernels::Half);
+  IREE_VMLA_UNARY_PREDICATE_OP(FiniteBF16, kernels::Finite, kernels::BFloat16);
 
   //===--------------------------------------------------------------------===//
   // VMLA Ops: shape/structure
@@ -447,7 +600,8 @@ class VMLAModuleState final {
               iree_vmla_shape_t dst_shape) {                                   \
     IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                              \
     return kernels::Transpose::Execute<type>(src->As<type>(), dst->As<type>(), \
-                                             src_shape, permutation);          \
+                                             src_shape, permutation,           \
+                                             thread_pool());                   \
   }
   IREE_VMLA_TRANSPOSE_OP(TransposeX8, uint8_t);
   IREE_VMLA_TRANSPOSE_OP(TransposeX16, uint16_t);
@@ -489,12 +643,25 @@ class VMLAModuleState final {
     IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                        \
     return kernels::Gather::Execute<type>(                               \
         src->As<type>(), indices->As<int>(), dst->As<type>(), src_shape, \
-        indices_shape, dst_shape, dim, batch_dims);                      \
+        indices_shape, dst_shape, dim, batch_dims, thread_pool());       \
   }
   IREE_VMLA_GATHER_OP(GatherX8, uint8_t);
   IREE_VMLA_GATHER_OP(GatherX16, uint16_t);
   IREE_VMLA_GATHER_OP(GatherX32, uint32_t);
 
+#define IREE_VMLA_TAKE_ALONG_AXIS_OP(name, type)                              \
+  Status name(vm::ref<Buffer> src, iree_vmla_shape_t src_shape,               \
+              vm::ref<Buffer> indices, iree_vmla_shape_t indices_shape,       \
+              int32_t dimension, vm::ref<Buffer> dst) {                       \
+    IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                             \
+    return kernels::TakeAlongAxis::Execute<type>(                             \
+        src->As<type>(), indices->As<int32_t>(), dst->As<type>(), src_shape,  \
+        indices_shape, dimension, thread_pool());                             \
+  }
+  IREE_VMLA_TAKE_ALONG_AXIS_OP(TakeAlongAxisX8, uint8_t);
+  IREE_VMLA_TAKE_ALONG_AXIS_OP(TakeAlongAxisX16, uint16_t);
+  IREE_VMLA_TAKE_ALONG_AXIS_OP(TakeAlongAxisX32, uint32_t);
+
 #define IREE_VMLA_SCATTER_OP(name, type)                                 \
   Status name(vm::ref<Buffer> src, iree_vmla_shape_t src_shape,          \
               vm::ref<Buffer> indices, iree_vmla_shape_t indices_shape,  \
@@ -624,6 +791,103 @@ class VMLAModuleState final {
   IREE_VMLA_UNARY_OP(FloorF32, kernels::Floor, float);
   IREE_VMLA_UNARY_OP(CeilF32, kernels::Ceil, float);
 
+  // 16-bit float arithmetic is computed in float.
+  IREE_VMLA_BINARY_OP(AddF16, kernels::Widened<kernels::Add>, kernels::Half);
+  IREE_VMLA_BINARY_OP(SubF16, kernels::Widened<kernels::Sub>, kernels::Half);
+  IREE_VMLA_UNARY_OP(AbsF16, kernels::Widened<kernels::Abs>, kernels::Half);
+  IREE_VMLA_UNARY_OP(NegF16, kernels::Widened<kernels::Neg>, kernels::Half);
+  IREE_VMLA_BINARY_OP(MulF16, kernels::Widened<kernels::Mul>, kernels::Half);
+  IREE_VMLA_BINARY_OP(DivF16, kernels::Widened<kernels::Div>, kernels::Half);
+  IREE_VMLA_BINARY_OP(RemF16, kernels::Widened<kernels::Rem>, kernels::Half);
+  IREE_VMLA_BINARY_OP(PowF16, kernels::Widened<kernels::Pow>, kernels::Half);
+  IREE_VMLA_UNARY_OP(ExpF16, kernels::Widened<kernels::Exp>, kernels::Half);
+  IREE_VMLA_UNARY_OP(LogF16, kernels::Widened<kernels::Log>, kernels::Half);
+  IREE_VMLA_UNARY_OP(RsqrtF16, kernels::Widened<kernels::Rsqrt>, kernels::Half);
+  IREE_VMLA_UNARY_OP(SqrtF16, kernels::Widened<kernels::Sqrt>, kernels::Half);
+  IREE_VMLA_UNARY_OP(CosF16, kernels::Widened<kernels::Cos>, kernels::Half);
+  IREE_VMLA_UNARY_OP(SinF16, kernels::Widened<kernels::Sin>, kernels::Half);
+  IREE_VMLA_UNARY_OP(TanhF16, kernels::Widened<kernels::Tanh>, kernels::Half);
+  IREE_VMLA_BINARY_OP(Atan2F16, kernels::Widened<kernels::Atan2>,
+                      kernels::Half);
+  IREE_VMLA_BINARY_OP(MinF16, kernels::Widened<kernels::Min>, kernels::Half);
+  IREE_VMLA_BINARY_OP(MaxF16, kernels::Widened<kernels::Max>, kernels::Half);
+  IREE_VMLA_TERNARY_OP(ClampF16, kernels::Widened<kernels::Clamp>,
+                       kernels::Half);
+  IREE_VMLA_UNARY_OP(FloorF16, kernels::Widened<kernels::Floor>, kernels::Half);
+  IREE_VMLA_UNARY_OP(CeilF16, kernels::Widened<kernels::Ceil>, kernels::Half);
+  IREE_VMLA_BINARY_OP(AddBF16, kernels::Widened<kernels::Add>,
+                      kernels::BFloat16);
+  IREE_VMLA_BINARY_OP(SubBF16, kernels::Widened<kernels::Sub>,
+                      kernels::BFloat16);
+  IREE_VMLA_UNARY_OP(AbsBF16, kernels::Widened<kernels::Abs>,
+                     kernels::BFloat16);
+  IREE_VMLA_UNARY_OP(NegBF16, kernels::Widened<kernels::Neg>,
+                     kernels::BFloat16);
+  IREE_VMLA_BINARY_OP(MulBF16, kernels::Widened<kernels::Mul>,
+                      kernels::BFloat16);
+  IREE_VMLA_BINARY_OP(DivBF16, kernels::Widened<kernels::Div>,
+                      kernels::BFloat16);
+  IREE_VMLA_BINARY_OP(RemBF16, kernels::Widened<kernels::Rem>,
+                      kernels::BFloat16);
+  IREE_VMLA_BINARY_OP(PowBF16, kernels::Widened<kernels::Pow>,
+                      kernels::BFloat16);
+  IREE_VMLA_UNARY_OP(ExpBF16, kernels::Widened<kernels::Exp>,
+                     kernels::BFloat16);
+  IREE_VMLA_UNARY_OP(LogBF16, kernels::Widened<kernels::Log>,
+                     kernels::BFloat16);
+  IREE_VMLA_UNARY_OP(RsqrtBF16, kernels::Widened<kernels::Rsqrt>,
+                     kernels::BFloat16);
+  IREE_VMLA_UNARY_OP(SqrtBF16, kernels::Widened<kernels::Sqrt>,
+                     kernels::BFloat16);
+  IREE_VMLA_UNARY_OP(CosBF16, kernels::Widened<kernels::Cos>,
+                     kernels::BFloat16);
+  IREE_VMLA_UNARY_OP(SinBF16, kernels::Widened<kernels::Sin>,
+                     kernels::BFloat16);
+  IREE_VMLA_UNARY_OP(TanhBF16, kernels::Widened<kernels::Tanh>,
+                     kernels::BFloat16);
+  IREE_VMLA_BINARY_OP(Atan2BF16, kernels::Widened<kernels::Atan2>,
+                      kernels::BFloat16);
+  IREE_VMLA_BINARY_OP(MinBF16, kernels::Widened<kernels::Min>,
+                      kernels::BFloat16);
+  IREE_VMLA_BINARY_OP(MaxBF16, kernels::Widened<kernels::Max>,
+                      kernels::BFloat16);
+  IREE_VMLA_TERNARY_OP(ClampBF16, kernels::Widened<kernels::Clamp>,
+                       kernels::BFloat16);
+  IREE_VMLA_UNARY_OP(FloorBF16, kernels::Widened<kernels::Floor>,
+                     kernels::BFloat16);
+  IREE_VMLA_UNARY_OP(CeilBF16, kernels::Widened<kernels::Ceil>,
+                     kernels::BFloat16);
+
+  Status ElementwiseF32(absl::Span<const int32_t> program,
+                        absl::Span<const vm::ref<Buffer>> srcs,
+                        vm::ref<Buffer> dst) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::ElementwiseF32");
+    absl::InlinedVector<absl::Span<const float>, 8> src_buffers;
+    src_buffers.reserve(srcs.size());
+    for (const auto& src : srcs) {
+      src_buffers.push_back(src->As<float>());
+    }
+    auto dst_buffer = dst->As<float>();
+    for (const auto& src_buffer : src_buffers) {
+      if (src_buffer.size() != dst_buffer.size()) {
+        // Not splittable; let the kernel report the mismatch.
+        return kernels::Elementwise::Execute<float>(program, src_buffers,
+                                                    dst_buffer);
+      }
+    }
+    return ForEachElementRange(
+        dst_buffer.size(), [&](size_t begin, size_t end) {
+          const size_t length = end - begin;
+          absl::InlinedVector<absl::Span<const float>, 8> src_ranges;
+          src_ranges.reserve(src_buffers.size());
+          for (const auto& src_buffer : src_buffers) {
+            src_ranges.push_back(src_buffer.subspan(begin, length));
+          }
+          return kernels::Elementwise::Execute<float>(
+              program, src_ranges, dst_buffer.subspan(begin, length));
+        });
+  }
+
   //===--------------------------------------------------------------------===//
   // VMLA Ops: conversion
   //===--------------------------------------------------------------------===//
@@ -631,8 +895,15 @@ class VMLAModuleState final {
 #define IREE_VMLA_CONVERSION_OP(name, src_type, dst_type)                      \
   Status name(vm::ref<Buffer> src, vm::ref<Buffer> dst) {                      \
     IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                              \
-    return kernels::Convert::Execute<src_type, dst_type>(src->As<src_type>(),  \
-                                                         dst->As<dst_type>()); \
+    auto src_buffer = src->As<src_type>();                                     \
+    auto dst_buffer = dst->As<dst_type>();                                     \
+    return ForEachElementRange(                                                \
+        dst_buffer.size(), [&](size_t begin, size_t end) {                     \
+          const size_t length = end - begin;                                   \
+          return kernels::Convert::Execute<src_type, dst_type>(                \
+              src_buffer.subspan(begin, length),                               \
+              dst_buffer.subspan(begin, length));                              \
+        });                                                                    \
   }
   IREE_VMLA_CONVERSION_OP(ConvertI8I16, int8_t, int16_t);
   IREE_VMLA_CONVERSION_OP(ConvertI8I32, int8_t, int32_t);
@@ -646,11 +917,84 @@ class VMLAModuleState final {
   IREE_VMLA_CONVERSION_OP(ConvertF32I8, float, int8_t);
   IREE_VMLA_CONVERSION_OP(ConvertF32I16, float, int16_t);
   IREE_VMLA_CONVERSION_OP(ConvertF32I32, float, int32_t);
+  IREE_VMLA_CONVERSION_OP(ConvertF16F32, kernels::Half, float);
+  IREE_VMLA_CONVERSION_OP(ConvertF32F16, float, kernels::Half);
+  IREE_VMLA_CONVERSION_OP(ConvertBF16F32, kernels::BFloat16, float);
+  IREE_VMLA_CONVERSION_OP(ConvertF32BF16, float, kernels::BFloat16);
 
   //===--------------------------------------------------------------------===//
   // VMLA Ops: Convolution
   //===--------------------------------------------------------------------===//
 
+  // Selects the algorithm for convolving examples of |input_example_shape| and
+  // returns the filter in the layout it uses. Winograd filter transforms of
+  // constant filters are cached across invocations; others are computed into
+  // |storage| once per op and shared by all batch examples.
+  kernels::Conv2D::Algorithm PrepareConv2D(
+      const vm::ref<Buffer>& filter, iree_vmla_shape_t input_example_shape,
+      iree_vmla_shape_t filter_shape, absl::Span<const int32_t> window_strides,
+      absl::Span<const int32_t> padding, absl::Span<const int32_t> dilation,
+      const int32_t feature_group_count, std::vector<float>* storage,
+      absl::Span<const float>* out_transformed_filter) {
+    const auto algorithm = kernels::Conv2D::SelectAlgorithm(
+        input_example_shape, filter_shape, window_strides, padding.subspan(0, 2),
+        padding.subspan(2, 2), dilation, feature_group_count);
+    if (algorithm != kernels::Conv2D::Algorithm::kWinograd) {
+      *out_transformed_filter = {};
+      return algorithm;
+    }
+    // The transform depends on how the filter is split into channels.
+    const auto key =
+        std::make_tuple(filter->data(), filter->size(), filter_shape[2]);
+    if (filter->is_constant()) {
+      auto it = transformed_conv_filters_.find(key);
+      if (it != transformed_conv_filters_.end()) {
+        *out_transformed_filter = absl::MakeConstSpan(it->second);
+        return algorithm;
+      }
+    }
+    auto transformed_filter = kernels::Conv2D::TransformFilter<float>(
+        algorithm, filter->As<float>(), filter_shape);
+    if (filter->is_constant()) {
+      auto& cached = transformed_conv_filters_[key];
+      cached = std::move(transformed_filter);
+      *out_transformed_filter = absl::MakeConstSpan(cached);
+    } else {
+      *storage = std::move(transformed_filter);
+      *out_transformed_filter = absl::MakeConstSpan(*storage);
+    }
+    return algorithm;
+  }
+
+  // Convolves each of the |batch_size| examples in |input_buffer| into
+  // |dst_buffer| using an algorithm and filter from PrepareConv2D.
+  Status Conv2DF32(int32_t batch_size, absl::Span<const float> input_buffer,
+                   iree_vmla_shape_t input_example_shape,
+                   absl::Span<const float> filter_buffer,
+                   iree_vmla_shape_t filter_shape,
+                   kernels::Conv2D::Algorithm algorithm,
+                   absl::Span<const float> transformed_filter,
+                   absl::Span<float> dst_buffer,
+                   iree_vmla_shape_t output_example_shape,
+                   absl::Span<const int32_t> window_strides,
+                   absl::Span<const int32_t> padding,
+                   absl::Span<const int32_t> dilation,
+                   const int32_t feature_group_count) {
+    const size_t input_stride = kernels::GetElementCount(input_example_shape);
+    const size_t output_stride = kernels::GetElementCount(output_example_shape);
+    for (int i = 0; i < batch_size; ++i) {
+      IREE_RETURN_IF_ERROR(kernels::Conv2D::Execute(
+          kernel_state_->mat_mul_state.get(), algorithm,
+          input_buffer.subspan(i * input_stride, input_stride),
+          input_example_shape, filter_buffer, filter_shape,
+          dst_buffer.subspan(i * output_stride, output_stride),
+          output_example_shape, window_strides, padding.subspan(0, 2),
+          padding.subspan(2, 2), dilation, feature_group_count,
+          transformed_filter));
+    }
+    return OkStatus();
+  }
+
   Status ConvF32F32F32(vm::ref<Buffer> input, iree_vmla_shape_t input_shape,
                        vm::ref<Buffer> filter, iree_vmla_shape_t filter_shape,
                        vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape,
@@ -667,33 +1011,191 @@ class VMLAModuleState final {
              << "Expecting 4-d tensors for Conv2D kernel";
     }
 
-    const int32_t batch_size = input_shape[0];
     const auto input_example_shape = input_shape.subspan(1, 3);
     const auto output_example_shape = dst_shape.subspan(1, 3);
-    const auto filter_shape_4d = filter_shape.subspan(0, 4);
     const auto dilation = lhs_dilation.subspan(0, 2);
-    const auto pad_h = padding.subspan(0, 2);
-    const auto pad_w = padding.subspan(2, 2);
     const auto window_strides_2d = window_strides.subspan(0, 2);
 
-    const float* raw_inputs_data = input->As<float>().data();
-    const float* raw_filter_data = filter->As<float>().data();
-    float* raw_dst_data = dst->As<float>().data();
+    std::vector<float> filter_storage;
+    absl::Span<const float> transformed_filter;
+    const auto algorithm = PrepareConv2D(
+        filter, input_example_shape, filter_shape, window_strides_2d, padding,
+        dilation, feature_group_count, &filter_storage, &transformed_filter);
     auto filter_buffer = absl::MakeConstSpan(
-        raw_filter_data, kernels::GetElementCount(filter_shape_4d));
+        filter->As<float>().data(), kernels::GetElementCount(filter_shape));
+    return Conv2DF32(input_shape[0], input->As<float>(), input_example_shape,
+                     filter_buffer, filter_shape, algorithm, transformed_filter,
+                     dst->As<float>(), output_example_shape, window_strides_2d,
+                     padding, dilation, feature_group_count);
+  }
+
+  template <typename T>
+  Status WidenedConv(vm::ref<Buffer> input, iree_vmla_shape_t input_shape,
+                     vm::ref<Buffer> filter, iree_vmla_shape_t filter_shape,
+                     vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape,
+                     absl::Span<const int32_t> window_strides,
+                     absl::Span<const int32_t> padding,
+                     absl::Span<const int32_t> lhs_dilation,
+                     absl::Span<const int32_t> rhs_dilation,
+                     const int32_t feature_group_count,
+                     const int32_t batch_group_count) {
+    if (input_shape.size() != 4 || filter_shape.size() != 4 ||
+        dst_shape.size() != 4) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Expecting 4-d tensors for Conv2D kernel";
+    }
+    IREE_ASSIGN_OR_RETURN(auto filter_f32, WidenWeights<T>(filter));
+
+    const auto input_example_shape = input_shape.subspan(1, 3);
+    const auto output_example_shape = dst_shape.subspan(1, 3);
+    const auto dilation = lhs_dilation.subspan(0, 2);
+    const auto window_strides_2d = window_strides.subspan(0, 2);
 
+    // The filter is prepared once for the whole batch.
+    std::vector<float> filter_storage;
+    absl::Span<const float> transformed_filter;
+    const auto algorithm = PrepareConv2D(
+        filter_f32, input_example_shape, filter_shape, window_strides_2d,
+        padding, dilation, feature_group_count, &filter_storage,
+        &transformed_filter);
+    auto filter_buffer = absl::MakeConstSpan(
+        filter_f32->As<float>().data(), kernels::GetElementCount(filter_shape));
+
+    // Each batch example is widened, convolved and narrowed in turn.
+    const size_t input_stride = kernels::GetElementCount(input_example_shape);
+    const size_t dst_stride = kernels::GetElementCount(output_example_shape);
+    IREE_ASSIGN_OR_RETURN(auto input_f32, AllocateFloatBuffer(input_stride));
+    IREE_ASSIGN_OR_RETURN(auto dst_f32, AllocateFloatBuffer(dst_stride));
+    auto input_buffer = input->As<T>();
+    auto dst_buffer = dst->As<T>();
+    for (int i = 0; i < input_shape[0]; ++i) {
+      IREE_RETURN_IF_ERROR(
+          WidenSpan<T>(input_buffer.subspan(i * input_stride, input_stride),
+                       input_f32->As<float>()));
+      IREE_RETURN_IF_ERROR(Conv2DF32(
+          /*batch_size=*/1, input_f32->As<float>(), input_example_shape,
+          filter_buffer, filter_shape, algorithm, transformed_filter,
+          dst_f32->As<float>(), output_example_shape, window_strides_2d,
+          padding, dilation, feature_group_count));
+      IREE_RETURN_IF_ERROR(
+          NarrowSpan<T>(dst_f32->As<float>(),
+                        dst_buffer.subspan(i * dst_stride, dst_stride)));
+    }
+    return OkStatus();
+  }
+
+#define IREE_VMLA_WIDENED_CONV_OP(name, type)                                 \
+  Status name(vm::ref<Buffer> input, iree_vmla_shape_t input_shape,           \
+              vm::ref<Buffer> filter, iree_vmla_shape_t filter_shape,         \
+              vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape,               \
+              absl::Span<const int32_t> window_strides,                       \
+              absl::Span<const int32_t> padding,                              \
+              absl::Span<const int32_t> lhs_dilation,                         \
+              absl::Span<const int32_t> rhs_dilation,                         \
+              const int32_t feature_group_count,                              \
+              const int32_t batch_group_count) {                              \
+    IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                             \
+    return WidenedConv<type>(                                                 \
+        std::move(input), input_shape, std::move(filter), filter_shape,       \
+        std::move(dst), dst_shape, window_strides, padding, lhs_dilation,     \
+        rhs_dilation, feature_group_count, batch_group_count);                \
+  }
+  IREE_VMLA_WIDENED_CONV_OP(ConvF16F16F16, kernels::Half);
+  IREE_VMLA_WIDENED_CONV_OP(ConvBF16BF16BF16, kernels::BFloat16);
+
+  //===--------------------------------------------------------------------===//
+  // VMLA Ops: quantization
+  //===--------------------------------------------------------------------===//
+
+  static kernels::QuantizedMultiplier MakeMultiplier(int32_t multiplier,
+                                                     int32_t exponent) {
+    kernels::QuantizedMultiplier result;
+    result.multiplier = multiplier;
+    result.exponent = exponent;
+    return result;
+  }
+
+  Status QuantizeI8(vm::ref<Buffer> src, vm::ref<Buffer> dst,
+                    int32_t zero_point, int32_t multiplier, int32_t exponent) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::QuantizeI8");
+    return kernels::Quantize::Execute<int8_t>(
+        src->As<float>(), dst->As<int8_t>(), zero_point,
+        MakeMultiplier(multiplier, exponent));
+  }
+
+  Status DequantizeI8(vm::ref<Buffer> src, vm::ref<Buffer> dst,
+                      int32_t zero_point, int32_t multiplier,
+                      int32_t exponent) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::DequantizeI8");
+    return kernels::Dequantize::Execute<int8_t>(
+        src->As<int8_t>(), dst->As<float>(), zero_point,
+        MakeMultiplier(multiplier, exponent));
+  }
+
+  Status QuantizedAddI8(vm::ref<Buffer> lhs, int32_t lhs_zero_point,
+                        int32_t lhs_multiplier, int32_t lhs_exponent,
+                        vm::ref<Buffer> rhs, int32_t rhs_zero_point,
+                        int32_t rhs_multiplier, int32_t rhs_exponent,
+                        vm::ref<Buffer> dst, int32_t dst_zero_point,
+                        int32_t dst_multiplier, int32_t dst_exponent) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::QuantizedAddI8");
+    return kernels::QuantizedAdd::Execute<int8_t>(
+        lhs->As<int8_t>(), lhs_zero_point,
+        MakeMultiplier(lhs_multiplier, lhs_exponent), rhs->As<int8_t>(),
+        rhs_zero_point, MakeMultiplier(rhs_multiplier, rhs_exponent),
+        dst->As<int8_t>(), dst_zero_point,
+        MakeMultiplier(dst_multiplier, dst_exponent));
+  }
+
+  Status QuantizedMulI8(vm::ref<Buffer> lhs, int32_t lhs_zero_point,
+                        vm::ref<Buffer> rhs, int32_t rhs_zero_point,
+                        vm::ref<Buffer> dst, int32_t dst_zero_point,
+                        int32_t multiplier, int32_t exponent) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::QuantizedMulI8");
+    return kernels::QuantizedMul::Execute<int8_t>(
+        lhs->As<int8_t>(), lhs_zero_point, rhs->As<int8_t>(), rhs_zero_point,
+        dst->As<int8_t>(), dst_zero_point,
+        MakeMultiplier(multiplier, exponent));
+  }
+
+  Status QuantizedConvI8(
+      vm::ref<Buffer> input, iree_vmla_shape_t input_shape,
+      vm::ref<Buffer> filter, iree_vmla_shape_t filter_shape,
+      vm::ref<Buffer> bias, vm::ref<Buffer> multiplier_mantissa,
+      vm::ref<Buffer> multiplier_exponent, vm::ref<Buffer> dst,
+      iree_vmla_shape_t dst_shape, absl::Span<const int32_t> window_strides,
+      absl::Span<const int32_t> padding, absl::Span<const int32_t> dilation,
+      const int32_t feature_group_count, const int32_t input_zero_point,
+      const int32_t dst_zero_point) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::QuantizedConvI8");
+    if (input_shape.size() != 4 || filter_shape.size() != 4 ||
+        dst_shape.size() != 4) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Expecting 4-d tensors for QuantizedConv2D kernel";
+    }
+    const auto input_example_shape = input_shape.subspan(1, 3);
+    const auto output_example_shape = dst_shape.subspan(1, 3);
     const size_t input_stride = kernels::GetElementCount(input_example_shape);
     const size_t output_stride = kernels::GetElementCount(output_example_shape);
 
-    for (int i = 0; i < batch_size; ++i) {
-      auto input_example =
-          absl::MakeConstSpan(raw_inputs_data + i * input_stride, input_stride);
-      auto output_example =
-          absl::MakeSpan(raw_dst_data + i * output_stride, output_stride);
-      IREE_RETURN_IF_ERROR(kernels::Conv2D::Execute(
-          input_example, input_example_shape, filter_buffer, filter_shape_4d,
-          output_example, output_example_shape, window_strides_2d, pad_h, pad_w,
-          dilation, feature_group_count));
+    kernels::QuantizedConv2D::Params params;
+    params.input_zero_point = input_zero_point;
+    params.dst_zero_point = dst_zero_point;
+    params.bias = bias->As<int32_t>();
+    params.multiplier_mantissa = multiplier_mantissa->As<int32_t>();
+    params.multiplier_exponent = multiplier_exponent->As<int32_t>();
+
+    auto input_buffer = input->As<int8_t>();
+    auto dst_buffer = dst->As<int8_t>();
+    for (int i = 0; i < input_shape[0]; ++i) {
+      IREE_RETURN_IF_ERROR(kernels::QuantizedConv2D::Execute<int8_t>(
+          kernel_state_->mat_mul_state.get(),
+          input_buffer.subspan(i * input_stride, input_stride),
+          input_example_shape, filter->As<int8_t>(), filter_shape,
+          dst_buffer.subspan(i * output_stride, output_stride),
+          output_example_shape, params, window_strides.subspan(0, 2),
+          padding.subspan(0, 2), padding.subspan(2, 2),
+          dilation.subspan(0, 2), feature_group_count));
     }
     return OkStatus();
   }
@@ -743,6 +1245,56 @@ class VMLAModuleState final {
     return OkStatus();
   }
 
+  template <typename T>
+  Status WidenedBatchMatMul(vm::ref<Buffer> lhs, iree_vmla_shape_t lhs_shape,
+                            vm::ref<Buffer> rhs, iree_vmla_shape_t rhs_shape,
+                            vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape) {
+    IREE_ASSIGN_OR_RETURN(auto rhs_f32, WidenWeights<T>(rhs));
+
+    // Each batch element of lhs is widened, multiplied and narrowed in turn.
+    const int32_t lhs_element_shape[3] = {1, lhs_shape[1], lhs_shape[2]};
+    const int32_t rhs_element_shape[3] = {1, rhs_shape[1], rhs_shape[2]};
+    const int32_t dst_element_shape[3] = {1, dst_shape[1], dst_shape[2]};
+    const size_t lhs_stride = kernels::GetElementCount(lhs_element_shape);
+    const size_t rhs_stride = kernels::GetElementCount(rhs_element_shape);
+    const size_t dst_stride = kernels::GetElementCount(dst_element_shape);
+    IREE_ASSIGN_OR_RETURN(auto lhs_f32, AllocateFloatBuffer(lhs_stride));
+    IREE_ASSIGN_OR_RETURN(auto dst_f32, AllocateFloatBuffer(dst_stride));
+    auto lhs_buffer = lhs->As<T>();
+    auto dst_buffer = dst->As<T>();
+    for (int i = 0; i < lhs_shape[0]; ++i) {
+      IREE_RETURN_IF_ERROR(
+          WidenSpan<T>(lhs_buffer.subspan(i * lhs_stride, lhs_stride),
+                       lhs_f32->As<float>()));
+      kernels::MatMul::Buffers<float, float> buffers;
+      buffers.lhs_buffer = lhs_f32->As<float>();
+      buffers.lhs_shape = absl::MakeConstSpan(lhs_element_shape).subspan(1);
+      buffers.rhs_buffer =
+          rhs_f32->template As<float>().subspan(i * rhs_stride, rhs_stride);
+      buffers.rhs_shape = absl::MakeConstSpan(rhs_element_shape).subspan(1);
+      buffers.dst_buffer = dst_f32->As<float>();
+      buffers.dst_shape = absl::MakeConstSpan(dst_element_shape).subspan(1);
+      IREE_RETURN_IF_ERROR(kernels::MatMul::Execute(
+          kernel_state_->mat_mul_state.get(), buffers));
+      IREE_RETURN_IF_ERROR(
+          NarrowSpan<T>(dst_f32->As<float>(),
+                        dst_buffer.subspan(i * dst_stride, dst_stride)));
+    }
+    return OkStatus();
+  }
+
+#define IREE_VMLA_WIDENED_BATCH_MATMUL_OP(name, type)                         \
+  Status name(vm::ref<Buffer> lhs, iree_vmla_shape_t lhs_shape,               \
+              vm::ref<Buffer> rhs, iree_vmla_shape_t rhs_shape,               \
+              vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape) {             \
+    IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                             \
+    return WidenedBatchMatMul<type>(std::move(lhs), lhs_shape,                \
+                                    std::move(rhs), rhs_shape,                \
+                                    std::move(dst), dst_shape);               \
+  }
+  IREE_VMLA_WIDENED_BATCH_MATMUL_OP(BatchMatMulF16F16F16, kernels::Half);
+  IREE_VMLA_WIDENED_BATCH_MATMUL_OP(BatchMatMulBF16BF16BF16, kernels::BFloat16);
+
   //===--------------------------------------------------------------------===//
   // VMLA Ops: reduction
   //===--------------------------------------------------------------------===//
@@ -755,20 +1307,77 @@ class VMLAModuleState final {
     IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                       \
     return kernel::Execute<type>(src->As<type>(), init->As<type>(),     \
                                  dst->As<type>(), dimension, src_shape, \
-                                 dst_shape);                            \
+                                 dst_shape, thread_pool());             \
   }
   IREE_VMLA_REDUCTION_OP(ReduceSumI8, kernels::ReduceSum, int8_t);
   IREE_VMLA_REDUCTION_OP(ReduceSumI16, kernels::ReduceSum, int16_t);
   IREE_VMLA_REDUCTION_OP(ReduceSumI32, kernels::ReduceSum, int32_t);
   IREE_VMLA_REDUCTION_OP(ReduceSumF32, kernels::ReduceSum, float);
+  IREE_VMLA_REDUCTION_OP(ReduceSumF16, kernels::ReduceSum, kernels::Half);
+  IREE_VMLA_REDUCTION_OP(ReduceSumBF16, kernels::ReduceSum, kernels::BFloat16);
   IREE_VMLA_REDUCTION_OP(ReduceMinI8, kernels::ReduceMin, int8_t);
   IREE_VMLA_REDUCTION_OP(ReduceMinI16, kernels::ReduceMin, int16_t);
   IREE_VMLA_REDUCTION_OP(ReduceMinI32, kernels::ReduceMin, int32_t);
   IREE_VMLA_REDUCTION_OP(ReduceMinF32, kernels::ReduceMin, float);
+  IREE_VMLA_REDUCTION_OP(ReduceMinF16, kernels::ReduceMin, kernels::Half);
+  IREE_VMLA_REDUCTION_OP(ReduceMinBF16, kernels::ReduceMin, kernels::BFloat16);
   IREE_VMLA_REDUCTION_OP(ReduceMaxI8, kernels::ReduceMax, int8_t);
   IREE_VMLA_REDUCTION_OP(ReduceMaxI16, kernels::ReduceMax, int16_t);
   IREE_VMLA_REDUCTION_OP(ReduceMaxI32, kernels::ReduceMax, int32_t);
   IREE_VMLA_REDUCTION_OP(ReduceMaxF32, kernels::ReduceMax, float);
+  IREE_VMLA_REDUCTION_OP(ReduceMaxF16, kernels::ReduceMax, kernels::Half);
+  IREE_VMLA_REDUCTION_OP(ReduceMaxBF16, kernels::ReduceMax, kernels::BFloat16);
+
+  //===--------------------------------------------------------------------===//
+  // VMLA Ops: sorting
+  //===--------------------------------------------------------------------===//
+
+  // Sort orders are expressed as the predicate that holds between an element
+  // and any element following it.
+  static StatusOr<bool> IsDescendingOrder(int32_t predicate) {
+    switch (static_cast<CmpPredicate>(predicate)) {
+      case CmpPredicate::kLT:
+        return false;
+      case CmpPredicate::kGT:
+        return true;
+      default:
+        return InvalidArgumentErrorBuilder(IREE_LOC)
+               << "Unsupported sort predicate " << predicate;
+    }
+  }
+
+#define IREE_VMLA_SORT_OP(name, type, refine)                               \
+  Status name(vm::ref<Buffer> src, iree_vmla_shape_t src_shape,             \
+              int32_t dimension, int32_t predicate, vm::ref<Buffer> dst) {  \
+    IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                           \
+    IREE_ASSIGN_OR_RETURN(bool descending, IsDescendingOrder(predicate));   \
+    return kernels::Sort::Execute<type>(src->As<type>(), dst->As<int32_t>(), \
+                                        src_shape, dimension, descending,   \
+                                        refine, thread_pool());             \
+  }
+  IREE_VMLA_SORT_OP(SortI8, int8_t, false);
+  IREE_VMLA_SORT_OP(SortI16, int16_t, false);
+  IREE_VMLA_SORT_OP(SortI32, int32_t, false);
+  IREE_VMLA_SORT_OP(SortF32, float, false);
+  IREE_VMLA_SORT_OP(SortRefineI8, int8_t, true);
+  IREE_VMLA_SORT_OP(SortRefineI16, int16_t, true);
+  IREE_VMLA_SORT_OP(SortRefineI32, int32_t, true);
+  IREE_VMLA_SORT_OP(SortRefineF32, float, true);
+
+#define IREE_VMLA_TOPK_OP(name, type)                                         \
+  Status name(vm::ref<Buffer> src, iree_vmla_shape_t src_shape,               \
+              int32_t dimension, int32_t predicate, vm::ref<Buffer> dst,      \
+              vm::ref<Buffer> dst_indices, iree_vmla_shape_t dst_shape) {     \
+    IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                             \
+    IREE_ASSIGN_OR_RETURN(bool descending, IsDescendingOrder(predicate));     \
+    return kernels::TopK::Execute<type>(                                      \
+        src->As<type>(), dst->As<type>(), dst_indices->As<int32_t>(),         \
+        src_shape, dst_shape, dimension, descending, thread_pool());          \
+  }
+  IREE_VMLA_TOPK_OP(TopKI8, int8_t);
+  IREE_VMLA_TOPK_OP(TopKI16, int16_t);
+  IREE_VMLA_TOPK_OP(TopKI32, int32_t);
+  IREE_VMLA_TOPK_OP(TopKF32, float);
 
 #define IREE_VMLA_POOLING_OP(name, kernel, type)                              \
   Status name(vm::ref<Buffer> src, iree_vmla_shape_t src_shape,               \
@@ -785,22 +1394,61 @@ class VMLAModuleState final {
   IREE_VMLA_POOLING_OP(PoolingSumI16, kernels::PoolingSum, int16_t);
   IREE_VMLA_POOLING_OP(PoolingSumI32, kernels::PoolingSum, int32_t);
   IREE_VMLA_POOLING_OP(PoolingSumF32, kernels::PoolingSum, float);
+  IREE_VMLA_POOLING_OP(PoolingSumF16, kernels::PoolingSum, kernels::Half);
+  IREE_VMLA_POOLING_OP(PoolingSumBF16, kernels::PoolingSum, kernels::BFloat16);
   IREE_VMLA_POOLING_OP(PoolingMinI8, kernels::PoolingMin, int8_t);
   IREE_VMLA_POOLING_OP(PoolingMinI16, kernels::PoolingMin, int16_t);
   IREE_VMLA_POOLING_OP(PoolingMinI32, kernels::PoolingMin, int32_t);
   IREE_VMLA_POOLING_OP(PoolingMinF32, kernels::PoolingMin, float);
+  IREE_VMLA_POOLING_OP(PoolingMinF16, kernels::PoolingMin, kernels::Half);
+  IREE_VMLA_POOLING_OP(PoolingMinBF16, kernels::PoolingMin, kernels::BFloat16);
   IREE_VMLA_POOLING_OP(PoolingMaxI8, kernels::PoolingMax, int8_t);
   IREE_VMLA_POOLING_OP(PoolingMaxI16, kernels::PoolingMax, int16_t);
   IREE_VMLA_POOLING_OP(PoolingMaxI32, kernels::PoolingMax, int32_t);
   IREE_VMLA_POOLING_OP(PoolingMaxF32, kernels::PoolingMax, float);
+  IREE_VMLA_POOLING_OP(PoolingMaxF16, kernels::PoolingMax, kernels::Half);
+  IREE_VMLA_POOLING_OP(PoolingMaxBF16, kernels::PoolingMax, kernels::BFloat16);
+
+#define IREE_VMLA_POOLING_AVG_OP(name, type)                                  \
+  Status name(vm::ref<Buffer> src, iree_vmla_shape_t src_shape,               \
+              vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape,               \
+              iree_vmla_shape_t window_dimensions, iree_vmla_shape_t strides, \
+              iree_vmla_shape_t pad_low) {                                    \
+    IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                             \
+    return kernels::PoolingAvg::Execute<type>(                                \
+        src->As<type>(), dst->As<type>(), src_shape, dst_shape,               \
+        window_dimensions, strides, pad_low);                                 \
+  }
+  IREE_VMLA_POOLING_AVG_OP(PoolingAvgI8, int8_t);
+  IREE_VMLA_POOLING_AVG_OP(PoolingAvgI16, int16_t);
+  IREE_VMLA_POOLING_AVG_OP(PoolingAvgI32, int32_t);
+  IREE_VMLA_POOLING_AVG_OP(PoolingAvgF32, float);
+  IREE_VMLA_POOLING_AVG_OP(PoolingAvgF16, kernels::Half);
+  IREE_VMLA_POOLING_AVG_OP(PoolingAvgBF16, kernels::BFloat16);
 
  private:
-  iree_allocator_t allocator_;
+  ThreadPool* thread_pool() const { return kernel_state_->thread_pool.get(); }
+
+  // Caches transient buffer storage across invocations. Buffers retain the
+  // pool so it is only released once all buffers allocated from it are.
+  ref_ptr<BufferPool> buffer_pool_;
+
+  // Float copies of 16-bit float constant weights keyed by the constant data
+  // range they were widened from.
+  absl::flat_hash_map<std::pair<const void*, size_t>, vm::ref<Buffer>>
+      widened_constants_;
+
+  // Winograd transforms of constant (or widened constant) conv filters keyed
+  // by the filter data range and input channel count they were computed from.
+  absl::flat_hash_map<std::tuple<const void*, size_t, int32_t>,
+                      std::vector<float>>
+      transformed_conv_filters_;
 
   // NOTE: kernel state must be externally synchronized as it is shared across
-  // all contexts using the VMLA module. This is fine in our current design as
-  // we only ever execute a single context at a time but if we start to allow
-  // concurrency across contexts we'll need to introduce locks.
+  // all contexts using the VMLA module (one per device). This is fine in our
+  // current design as we only ever execute a single context at a time but if
+  // we start to allow concurrency across contexts we'll need to introduce
+  // locks. The thread pool itself is thread-safe.
   kernels::RuntimeState* kernel_state_ = nullptr;
 };
 
@@ -825,6 +1473,8 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("cmp.i16", &VMLAModuleState::CmpI16),
     vm::MakeNativeFunction("cmp.i32", &VMLAModuleState::CmpI32),
     vm::MakeNativeFunction("cmp.f32", &VMLAModuleState::CmpF32),
+    vm::MakeNativeFunction("cmp.f16", &VMLAModuleState::CmpF16),
+    vm::MakeNativeFunction("cmp.bf16", &VMLAModuleState::CmpBF16),
     vm::MakeNativeFunction("select.x8", &VMLAModuleState::SelectX8),
     vm::MakeNativeFunction("select.x16", &VMLAModuleState::SelectX16),
     vm::MakeNativeFunction("select.x32", &VMLAModuleState::SelectX32),
@@ -847,6 +1497,12 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("gather.x8", &VMLAModuleState::GatherX8),
     vm::MakeNativeFunction("gather.x16", &VMLAModuleState::GatherX16),
     vm::MakeNativeFunction("gather.x32", &VMLAModuleState::GatherX32),
+    vm::MakeNativeFunction("take_along_axis.x8",
+                           &VMLAModuleState::TakeAlongAxisX8),
+    vm::MakeNativeFunction("take_along_axis.x16",
+                           &VMLAModuleState::TakeAlongAxisX16),
+    vm::MakeNativeFunction("take_along_axis.x32",
+                           &VMLAModuleState::TakeAlongAxisX32),
     vm::MakeNativeFunction("scatter.x8", &VMLAModuleState::ScatterX8),
     vm::MakeNativeFunction("scatter.x16", &VMLAModuleState::ScatterX16),
     vm::MakeNativeFunction("scatter.x32", &VMLAModuleState::ScatterX32),
@@ -884,22 +1540,32 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("add.i16", &VMLAModuleState::AddI16),
     vm::MakeNativeFunction("add.i32", &VMLAModuleState::AddI32),
     vm::MakeNativeFunction("add.f32", &VMLAModuleState::AddF32),
+    vm::MakeNativeFunction("add.f16", &VMLAModuleState::AddF16),
+    vm::MakeNativeFunction("add.bf16", &VMLAModuleState::AddBF16),
     vm::MakeNativeFunction("sub.i8", &VMLAModuleState::SubI8),
     vm::MakeNativeFunction("sub.i16", &VMLAModuleState::SubI16),
     vm::MakeNativeFunction("sub.i32", &VMLAModuleState::SubI32),
     vm::MakeNativeFunction("sub.f32", &VMLAModuleState::SubF32),
+    vm::MakeNativeFunction("sub.f16", &VMLAModuleState::SubF16),
+    vm::MakeNativeFunction("sub.bf16", &VMLAModuleState::SubBF16),
     vm::MakeNativeFunction("abs.i8", &VMLAModuleState::AbsI8),
     vm::MakeNativeFunction("abs.i16", &VMLAModuleState::AbsI16),
     vm::MakeNativeFunction("abs.i32", &VMLAModuleState::AbsI32),
     vm::MakeNativeFunction("abs.f32", &VMLAModuleState::AbsF32),
+    vm::MakeNativeFunction("abs.f16", &VMLAModuleState::AbsF16),
+    vm::MakeNativeFunction("abs.bf16", &VMLAModuleState::AbsBF16),
     vm::MakeNativeFunction("neg.i8", &VMLAModuleState::NegI8),
     vm::MakeNativeFunction("neg.i16", &VMLAModuleState::NegI16),
     vm::MakeNativeFunction("neg.i32", &VMLAModuleState::NegI32),
     vm::MakeNativeFunction("neg.f32", &VMLAModuleState::NegF32),
+    vm::MakeNativeFunction("neg.f16", &VMLAModuleState::NegF16),
+    vm::MakeNativeFunction("neg.bf16", &VMLAModuleState::NegBF16),
     vm::MakeNativeFunction("mul.i8", &VMLAModuleState::MulI8),
     vm::MakeNativeFunction("mul.i16", &VMLAModuleState::MulI16),
     vm::MakeNativeFunction("mul.i32", &VMLAModuleState::MulI32),
     vm::MakeNativeFunction("mul.f32", &VMLAModuleState::MulF32),
+    vm::MakeNativeFunction("mul.f16", &VMLAModuleState::MulF16),
+    vm::MakeNativeFunction("mul.bf16", &VMLAModuleState::MulBF16),
     vm::MakeNativeFunction("div.i8", &VMLAModuleState::DivI8),
     vm::MakeNativeFunction("div.i16", &VMLAModuleState::DivI16),
     vm::MakeNativeFunction("div.i32", &VMLAModuleState::DivI32),
@@ -907,6 +1573,8 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("div.u16", &VMLAModuleState::DivU16),
     vm::MakeNativeFunction("div.u32", &VMLAModuleState::DivU32),
     vm::MakeNativeFunction("div.f32", &VMLAModuleState::DivF32),
+    vm::MakeNativeFunction("div.f16", &VMLAModuleState::DivF16),
+    vm::MakeNativeFunction("div.bf16", &VMLAModuleState::DivBF16),
     vm::MakeNativeFunction("rem.i8", &VMLAModuleState::RemI8),
     vm::MakeNativeFunction("rem.i16", &VMLAModuleState::RemI16),
     vm::MakeNativeFunction("rem.i32", &VMLAModuleState::RemI32),
@@ -914,31 +1582,65 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("rem.u16", &VMLAModuleState::RemU16),
     vm::MakeNativeFunction("rem.u32", &VMLAModuleState::RemU32),
     vm::MakeNativeFunction("rem.f32", &VMLAModuleState::RemF32),
+    vm::MakeNativeFunction("rem.f16", &VMLAModuleState::RemF16),
+    vm::MakeNativeFunction("rem.bf16", &VMLAModuleState::RemBF16),
     vm::MakeNativeFunction("pow.f32", &VMLAModuleState::PowF32),
+    vm::MakeNativeFunction("pow.f16", &VMLAModuleState::PowF16),
+    vm::MakeNativeFunction("pow.bf16", &VMLAModuleState::PowBF16),
     vm::MakeNativeFunction("exp.f32", &VMLAModuleState::ExpF32),
+    vm::MakeNativeFunction("exp.f16", &VMLAModuleState::ExpF16),
+    vm::MakeNativeFunction("exp.bf16", &VMLAModuleState::ExpBF16),
     vm::MakeNativeFunction("log.f32", &VMLAModuleState::LogF32),
+    vm::MakeNativeFunction("log.f16", &VMLAModuleState::LogF16),
+    vm::MakeNativeFunction("log.bf16", &VMLAModuleState::LogBF16),
     vm::MakeNativeFunction("rsqrt.f32", &VMLAModuleState::RsqrtF32),
+    vm::MakeNativeFunction("rsqrt.f16", &VMLAModuleState::RsqrtF16),
+    vm::MakeNativeFunction("rsqrt.bf16", &VMLAModuleState::RsqrtBF16),
     vm::MakeNativeFunction("sqrt.f32", &VMLAModuleState::SqrtF32),
+    vm::MakeNativeFunction("sqrt.f16", &VMLAModuleState::SqrtF16),
+    vm::MakeNativeFunction("sqrt.bf16", &VMLAModuleState::SqrtBF16),
     vm::MakeNativeFunction("cos.f32", &VMLAModuleState::CosF32),
+    vm::MakeNativeFunction("cos.f16", &VMLAModuleState::CosF16),
+    vm::MakeNativeFunction("cos.bf16", &VMLAModuleState::CosBF16),
     vm::MakeNativeFunction("sin.f32", &VMLAModuleState::SinF32),
+    vm::MakeNativeFunction("sin.f16", &VMLAModuleState::SinF16),
+    vm::MakeNativeFunction("sin.bf16", &VMLAModuleState::SinBF16),
     vm::MakeNativeFunction("tanh.f32", &VMLAModuleState::TanhF32),
+    vm::MakeNativeFunction("tanh.f16", &VMLAModuleState::TanhF16),
+    vm::MakeNativeFunction("tanh.bf16", &VMLAModuleState::TanhBF16),
     vm::MakeNativeFunction("atan2.f32", &VMLAModuleState::Atan2F32),
+    vm::MakeNativeFunction("atan2.f16", &VMLAModuleState::Atan2F16),
+    vm::MakeNativeFunction("atan2.bf16", &VMLAModuleState::Atan2BF16),
 
     vm::MakeNativeFunction("min.i8", &VMLAModuleState::MinI8),
     vm::MakeNativeFunction("min.i16", &VMLAModuleState::MinI16),
     vm::MakeNativeFunction("min.i32", &VMLAModuleState::MinI32),
     vm::MakeNativeFunction("min.f32", &VMLAModuleState::MinF32),
+    vm::MakeNativeFunction("min.f16", &VMLAModuleState::MinF16),
+    vm::MakeNativeFunction("min.bf16", &VMLAModuleState::MinBF16),
     vm::MakeNativeFunction("max.i8", &VMLAModuleState::MaxI8),
     vm::MakeNativeFunction("max.i16", &VMLAModuleState::MaxI16),
     vm::MakeNativeFunction("max.i32", &VMLAModuleState::MaxI32),
     vm::MakeNativeFunction("max.f32", &VMLAModuleState::MaxF32),
+    vm::MakeNativeFunction("max.f16", &VMLAModuleState::MaxF16),
+    vm::MakeNativeFunction("max.bf16", &VMLAModuleState::MaxBF16),
     vm::MakeNativeFunction("clamp.i8", &VMLAModuleState::ClampI8),
     vm::MakeNativeFunction("clamp.i16", &VMLAModuleState::ClampI16),
     vm::MakeNativeFunction("clamp.i32", &VMLAModuleState::ClampI32),
     vm::MakeNativeFunction("clamp.f32", &VMLAModuleState::ClampF32),
+    vm::MakeNativeFunction("clamp.f16", &VMLAModuleState::ClampF16),
+    vm::MakeNativeFunction("clamp.bf16", &VMLAModuleState::ClampBF16),
     vm::MakeNativeFunction("floor.f32", &VMLAModuleState::FloorF32),
+    vm::MakeNativeFunction("floor.f16", &VMLAModuleState::FloorF16),
+    vm::MakeNativeFunction("floor.bf16", &VMLAModuleState::FloorBF16),
     vm::MakeNativeFunction("ceil.f32", &VMLAModuleState::CeilF32),
+    vm::MakeNativeFunction("ceil.f16", &VMLAModuleState::CeilF16),
+    vm::MakeNativeFunction("ceil.bf16", &VMLAModuleState::CeilBF16),
+    vm::MakeNativeFunction("elementwise.f32",
+                           &VMLAModuleState::ElementwiseF32),
     vm::MakeNativeFunction("finite.f32", &VMLAModuleState::FiniteF32),
+    vm::MakeNativeFunction("finite.f16", &VMLAModuleState::FiniteF16),
+    vm::MakeNativeFunction("finite.bf16", &VMLAModuleState::FiniteBF16),
 
     vm::MakeNativeFunction("convert.i8.i16", &VMLAModuleState::ConvertI8I16),
     vm::MakeNativeFunction("convert.i8.i32", &VMLAModuleState::ConvertI8I32),
@@ -952,37 +1654,94 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("convert.f32.i8", &VMLAModuleState::ConvertF32I8),
     vm::MakeNativeFunction("convert.f32.i16", &VMLAModuleState::ConvertF32I16),
     vm::MakeNativeFunction("convert.f32.i32", &VMLAModuleState::ConvertF32I32),
+    vm::MakeNativeFunction("convert.f16.f32", &VMLAModuleState::ConvertF16F32),
+    vm::MakeNativeFunction("convert.f32.f16", &VMLAModuleState::ConvertF32F16),
+    vm::MakeNativeFunction("convert.bf16.f32",
+                           &VMLAModuleState::ConvertBF16F32),
+    vm::MakeNativeFunction("convert.f32.bf16",
+                           &VMLAModuleState::ConvertF32BF16),
 
     vm::MakeNativeFunction("reduce.sum.i8", &VMLAModuleState::ReduceSumI8),
     vm::MakeNativeFunction("reduce.sum.i16", &VMLAModuleState::ReduceSumI16),
     vm::MakeNativeFunction("reduce.sum.i32", &VMLAModuleState::ReduceSumI32),
     vm::MakeNativeFunction("reduce.sum.f32", &VMLAModuleState::ReduceSumF32),
+    vm::MakeNativeFunction("reduce.sum.f16", &VMLAModuleState::ReduceSumF16),
+    vm::MakeNativeFunction("reduce.sum.bf16", &VMLAModuleState::ReduceSumBF16),
     vm::MakeNativeFunction("reduce.min.i8", &VMLAModuleState::ReduceMinI8),
     vm::MakeNativeFunction("reduce.min.i16", &VMLAModuleState::ReduceMinI16),
     vm::MakeNativeFunction("reduce.min.i32", &VMLAModuleState::ReduceMinI32),
     vm::MakeNativeFunction("reduce.min.f32", &VMLAModuleState::ReduceMinF32),
+    vm::MakeNativeFunction("reduce.min.f16", &VMLAModuleState::ReduceMinF16),
+    vm::MakeNativeFunction("reduce.min.bf16", &VMLAModuleState::ReduceMinBF16),
     vm::MakeNativeFunction("reduce.max.i8", &VMLAModuleState::ReduceMaxI8),
     vm::MakeNativeFunction("reduce.max.i16", &VMLAModuleState::ReduceMaxI16),
     vm::MakeNativeFunction("reduce.max.i32", &VMLAModuleState::ReduceMaxI32),
     vm::MakeNativeFunction("reduce.max.f32", &VMLAModuleState::ReduceMaxF32),
+    vm::MakeNativeFunction("reduce.max.f16", &VMLAModuleState::ReduceMaxF16),
+    vm::MakeNativeFunction("reduce.max.bf16", &VMLAModuleState::ReduceMaxBF16),
 
     vm::MakeNativeFunction("pooling.sum.i8", &VMLAModuleState::PoolingSumI8),
     vm::MakeNativeFunction("pooling.sum.i16", &VMLAModuleState::PoolingSumI16),
     vm::MakeNativeFunction("pooling.sum.i32", &VMLAModuleState::PoolingSumI32),
     vm::MakeNativeFunction("pooling.sum.f32", &VMLAModuleState::PoolingSumF32),
+    vm::MakeNativeFunction("pooling.sum.f16", &VMLAModuleState::PoolingSumF16),
+    vm::MakeNativeFunction("pooling.sum.bf16",
+                           &VMLAModuleState::PoolingSumBF16),
     vm::MakeNativeFunction("pooling.min.i8", &VMLAModuleState::PoolingMinI8),
     vm::MakeNativeFunction("pooling.min.i16", &VMLAModuleState::PoolingMinI16),
     vm::MakeNativeFunction("pooling.min.i32", &VMLAModuleState::PoolingMinI32),
     vm::MakeNativeFunction("pooling.min.f32", &VMLAModuleState::PoolingMinF32),
+    vm::MakeNativeFunction("pooling.min.f16", &VMLAModuleState::PoolingMinF16),
+    vm::MakeNativeFunction("pooling.min.bf16",
+                           &VMLAModuleState::PoolingMinBF16),
     vm::MakeNativeFunction("pooling.max.i8", &VMLAModuleState::PoolingMaxI8),
     vm::MakeNativeFunction("pooling.max.i16", &VMLAModuleState::PoolingMaxI16),
     vm::MakeNativeFunction("pooling.max.i32", &VMLAModuleState::PoolingMaxI32),
     vm::MakeNativeFunction("pooling.max.f32", &VMLAModuleState::PoolingMaxF32),
+    vm::MakeNativeFunction("pooling.max.f16", &VMLAModuleState::PoolingMaxF16),
+    vm::MakeNativeFunction("pooling.max.bf16",
+                           &VMLAModuleState::PoolingMaxBF16),
+    vm::MakeNativeFunction("pooling.avg.i8", &VMLAModuleState::PoolingAvgI8),
+    vm::MakeNativeFunction("pooling.avg.i16", &VMLAModuleState::PoolingAvgI16),
+    vm::MakeNativeFunction("pooling.avg.i32", &VMLAModuleState::PoolingAvgI32),
+    vm::MakeNativeFunction("pooling.avg.f32", &VMLAModuleState::PoolingAvgF32),
+    vm::MakeNativeFunction("pooling.avg.f16", &VMLAModuleState::PoolingAvgF16),
+    vm::MakeNativeFunction("pooling.avg.bf16",
+                           &VMLAModuleState::PoolingAvgBF16),
+
+    vm::MakeNativeFunction("sort.i8", &VMLAModuleState::SortI8),
+    vm::MakeNativeFunction("sort.i16", &VMLAModuleState::SortI16),
+    vm::MakeNativeFunction("sort.i32", &VMLAModuleState::SortI32),
+    vm::MakeNativeFunction("sort.f32", &VMLAModuleState::SortF32),
+    vm::MakeNativeFunction("sort.refine.i8", &VMLAModuleState::SortRefineI8),
+    vm::MakeNativeFunction("sort.refine.i16", &VMLAModuleState::SortRefineI16),
+    vm::MakeNativeFunction("sort.refine.i32", &VMLAModuleState::SortRefineI32),
+    vm::MakeNativeFunction("sort.refine.f32", &VMLAModuleState::SortRefineF32),
+    vm::MakeNativeFunction("topk.i8", &VMLAModuleState::TopKI8),
+    vm::MakeNativeFunction("topk.i16", &VMLAModuleState::TopKI16),
+    vm::MakeNativeFunction("topk.i32", &VMLAModuleState::TopKI32),
+    vm::MakeNativeFunction("topk.f32", &VMLAModuleState::TopKF32),
 
     vm::MakeNativeFunction("batch.matmul.f32f32.f32",
                            &VMLAModuleState::BatchMatMulF32F32F32),
-
-    vm::MakeNativeFunction("conv.f32f32.f32", &VMLAModuleState::ConvF32F32F32)};
+    vm::MakeNativeFunction("batch.matmul.f16f16.f16",
+                           &VMLAModuleState::BatchMatMulF16F16F16),
+    vm::MakeNativeFunction("batch.matmul.bf16bf16.bf16",
+                           &VMLAModuleState::BatchMatMulBF16BF16BF16),
+
+    vm::MakeNativeFunction("conv.f32f32.f32", &VMLAModuleState::ConvF32F32F32),
+    vm::MakeNativeFunction("conv.f16f16.f16", &VMLAModuleState::ConvF16F16F16),
+    vm::MakeNativeFunction("conv.bf16bf16.bf16",
+                           &VMLAModuleState::ConvBF16BF16BF16),
+
+    vm::MakeNativeFunction("quantize.i8", &VMLAModuleState::QuantizeI8),
+    vm::MakeNativeFunction("dequantize.i8", &VMLAModuleState::DequantizeI8),
+    vm::MakeNativeFunction("quantized.add.i8",
+                           &VMLAModuleState::QuantizedAddI8),
+    vm::MakeNativeFunction("quantized.mul.i8",
+                           &VMLAModuleState::QuantizedMulI8),
+    vm::MakeNativeFunction("quantized.conv.i8",
+                           &VMLAModuleState::QuantizedConvI8)};
 
 // Per-device VMLA module.
 // One of these will be created per device and be shared across all executables
@@ -993,9 +1752,10 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
 // Thread-safe.
 class VMLAModule final : public vm::NativeModule<VMLAModuleState> {
  public:
-  explicit VMLAModule(iree_allocator_t allocator)
+  VMLAModule(iree_allocator_t allocator, ref_ptr<ThreadPool> thread_pool)
       : vm::NativeModule<VMLAModuleState>(
-            "vmla", allocator, absl::MakeConstSpan(kVMLAModuleFunctions)) {}
+            "vmla", allocator, absl::MakeConstSpan(kVMLAModuleFunctions)),
+        kernel_state_(std::move(thread_pool)) {}
   ~VMLAModule() = default;
 
   Status Initialize() {
@@ -1018,13 +1778,15 @@ class VMLAModule final : public vm::NativeModule<VMLAModuleState> {
 
 }  // namespace
 
-Status ModuleCreate(iree_allocator_t allocator, iree_vm_module_t** out_module) {
+Status ModuleCreate(iree_allocator_t allocator, ThreadPool* thread_pool,
+                    iree_vm_module_t** out_module) {
   if (!out_module) {
     return InvalidArgumentErrorBuilder(IREE_LOC)
            << "out_module must not be null";
   }
   *out_module = nullptr;
-  auto module = std::make_unique<VMLAModule>(allocator);
+  auto module =
+      std::make_unique<VMLAModule>(allocator, add_ref(thread_pool));
   IREE_RETURN_IF_ERROR(module->Initialize());
   *out_module = module.release()->interface();
   return OkStatus();
@@ -26,6 +26,7 @@
 #include "iree/base/memory.h"
 #include "iree/base/ref_ptr.h"
 #include "iree/base/status.h"
+#include "iree/base/thread_pool.h"
 #include "iree/vm/api.h"
 #include "iree/vm/native_module_cc.h"
 
@@ -48,16 +49,32 @@ constexpr iree_vmla_size_t kVMLAWholeBuffer = -1;
 //
 // The provided data pointer and length is always for the buffer itself; it'll
 // already be offset/clamped to parent buffer bounds when a view.
+//
+// The Buffer object is itself allocated from an iree_allocator_t so that
+// transient buffers can be served entirely from a pool (see BufferPool).
 class Buffer final : public RefObject<Buffer> {
  public:
+  // Allocates a buffer with the object and its contents stored in a single
+  // allocation from |allocator|. The contents are aligned to 64 bytes and are
+  // always zeroed, including when the storage is reused from a BufferPool.
+  // This is the guarantee vmla.buffer.alloc makes to compiled code. Views of
+  // another buffer (such as the planned transient arena) make no such
+  // guarantee; the compiler zero-fills those where required.
   static StatusOr<vm::ref<Buffer>> Allocate(size_t byte_length,
                                             iree_allocator_t allocator);
 
-  static StatusOr<vm::ref<Buffer>> Wrap(const void* data, size_t data_length,
-                                        iree_allocator_t allocator);
+  // Wraps |data| which will be released to |allocator| when the buffer is
+  // destroyed. The buffer object is allocated from |header_allocator|.
+  static StatusOr<vm::ref<Buffer>> Wrap(
+      const void* data, size_t data_length, iree_allocator_t allocator,
+      iree_allocator_t header_allocator = iree_allocator_system());
+
+  static StatusOr<vm::ref<Buffer>> WrapMutable(
+      void* data, size_t data_length, iree_allocator_t allocator,
+      iree_allocator_t header_allocator = iree_allocator_system());
 
-  static StatusOr<vm::ref<Buffer>> WrapMutable(void* data, size_t data_length,
-                                               iree_allocator_t allocator);
+  // Destroys |buffer| and returns its storage to the allocator it came from.
+  static void Delete(Buffer* buffer);
 
   ~Buffer();
 
@@ -65,6 +82,11 @@ class Buffer final : public RefObject<Buffer> {
   constexpr void* data() { return data_; }
   constexpr size_t size() const { return data_length_; }
 
+  // Whether the contents are (a view of) module constant data and never
+  // change.
+  bool is_constant() const { return is_constant_; }
+  void set_is_constant(bool is_constant) { is_constant_ = is_constant; }
+
   template <typename T>
   absl::Span<const T> As() const {
     return absl::MakeConstSpan(reinterpret_cast<const T*>(data_),
@@ -85,13 +107,18 @@ class Buffer final : public RefObject<Buffer> {
   }
 
  private:
+  static StatusOr<vm::ref<Buffer>> Create(size_t extra_byte_length,
+                                          iree_allocator_t header_allocator);
+
   StatusOr<absl::Span<uint8_t>> MakeRange(iree_vmla_size_t byte_offset,
                                           iree_vmla_size_t byte_length) const;
 
   vm::ref<Buffer> parent_;
   void* data_ = nullptr;
   size_t data_length_ = 0;
+  bool is_constant_ = false;
   iree_allocator_t allocator_;
+  iree_allocator_t header_allocator_;
 };
 
 class Interface final : public RefObject<Interface> {
@@ -127,7 +154,10 @@ class Interface final : public RefObject<Interface> {
 
 Status ModuleRegisterTypes();
 
-Status ModuleCreate(iree_allocator_t allocator, iree_vm_module_t** out_module);
+// Creates the VMLA module. Kernels split large ops across |thread_pool|, if
+// provided, which is retained by the module.
+Status ModuleCreate(iree_allocator_t allocator, ThreadPool* thread_pool,
+                    iree_vm_module_t** out_module);
 
 }  // namespace vmla
 }  // namespace hal
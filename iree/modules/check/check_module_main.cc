@@ -18,7 +18,6 @@
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 #include "iree/base/api.h"
-#include "iree/base/file_io.h"
 #include "iree/base/init.h"
 #include "iree/base/status.h"
 #include "iree/base/target_platform.h"
@@ -89,18 +88,19 @@ StatusOr<int> Run(std::string input_file_path) {
       iree_vm_instance_create(iree_allocator_system(), &instance))
       << "creating instance";
 
+  // Files are memory-mapped while stdin is read into |module_data|, which must
+  // outlive the module.
   std::string module_data;
+  iree_vm_module_t* input_module = nullptr;
   if (input_file_path == "-") {
     module_data = std::string{std::istreambuf_iterator<char>(std::cin),
                               std::istreambuf_iterator<char>()};
+    IREE_RETURN_IF_ERROR(LoadBytecodeModule(module_data, &input_module));
   } else {
-    IREE_ASSIGN_OR_RETURN(module_data,
-                          file_io::GetFileContents(input_file_path));
+    IREE_RETURN_IF_ERROR(
+        LoadBytecodeModuleFromFile(input_file_path, &input_module));
   }
 
-  iree_vm_module_t* input_module = nullptr;
-  IREE_RETURN_IF_ERROR(LoadBytecodeModule(module_data, &input_module));
-
   iree_hal_device_t* device = nullptr;
   IREE_RETURN_IF_ERROR(CreateDevice(absl::GetFlag(FLAGS_driver), &device));
   iree_vm_module_t* hal_module = nullptr;
@@ -231,6 +231,13 @@ class HALModuleState final {
              << "Constant data is too large for the minimum allocation size";
     }
 
+    // TODO(benvanik): import |value| without a copy when the allocator can
+    // wrap host memory and the data meets its alignment requirements (bytecode
+    // modules align rodata to 64 bytes by default and can be compiled with
+    // -iree-vm-bytecode-module-rodata-alignment=4096 for page alignment).
+    // This is blocked on two things: iree_hal_allocator_wrap_buffer is
+    // unimplemented on Vulkan, and a wrapped buffer has no way to keep the
+    // module that owns the rodata alive if it outlives the context.
     vm::ref<iree_hal_buffer_t> buffer;
     IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
         allocator.get(), memory_types, buffer_usage, allocation_size, &buffer))
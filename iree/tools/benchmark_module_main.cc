@@ -15,7 +15,6 @@
 #include "absl/flags/flag.h"
 #include "absl/strings/string_view.h"
 #include "benchmark/benchmark.h"
-#include "iree/base/file_io.h"
 #include "iree/base/init.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
@@ -56,14 +55,15 @@ ABSL_FLAG(std::string, inputs_file, "",
 namespace iree {
 namespace {
 
-StatusOr<std::string> GetModuleContentsFromFlags() {
-  IREE_TRACE_SCOPE0("GetModuleContentsFromFlags");
+// Memory-maps and loads the module specified by --input_file.
+Status LoadModuleFromFlags(iree_vm_module_t** out_module) {
+  IREE_TRACE_SCOPE0("LoadModuleFromFlags");
   auto input_file = absl::GetFlag(FLAGS_input_file);
   if (input_file.empty()) {
     return InvalidArgumentErrorBuilder(IREE_LOC)
            << "input_file must be specified";
   }
-  return file_io::GetFileContents(input_file);
+  return LoadBytecodeModuleFromFile(input_file, out_module);
 }
 
 Status RunFunction(::benchmark::State& state,
@@ -77,9 +77,8 @@ Status RunFunction(::benchmark::State& state,
       iree_vm_instance_create(iree_allocator_system(), &instance))
       << "creating instance";
 
-  IREE_ASSIGN_OR_RETURN(auto module_data, GetModuleContentsFromFlags());
   iree_vm_module_t* input_module = nullptr;
-  IREE_RETURN_IF_ERROR(LoadBytecodeModule(module_data, &input_module));
+  IREE_RETURN_IF_ERROR(LoadModuleFromFlags(&input_module));
 
   iree_hal_device_t* device = nullptr;
   IREE_RETURN_IF_ERROR(CreateDevice(absl::GetFlag(FLAGS_driver), &device));
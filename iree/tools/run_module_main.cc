@@ -16,7 +16,6 @@
 
 #include "absl/flags/flag.h"
 #include "absl/strings/string_view.h"
-#include "iree/base/file_io.h"
 #include "iree/base/init.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
@@ -54,17 +53,18 @@ ABSL_FLAG(std::string, inputs_file, "",
 namespace iree {
 namespace {
 
-StatusOr<std::string> GetModuleContentsFromFlags() {
-  IREE_TRACE_SCOPE0("GetModuleContentsFromFlags");
+// Loads the module specified by --input_file. Files are memory-mapped while
+// stdin is read into |out_contents|, which must outlive the module.
+Status LoadModuleFromFlags(std::string* out_contents,
+                           iree_vm_module_t** out_module) {
+  IREE_TRACE_SCOPE0("LoadModuleFromFlags");
   auto input_file = absl::GetFlag(FLAGS_input_file);
-  std::string contents;
-  if (input_file == "-") {
-    contents = std::string{std::istreambuf_iterator<char>(std::cin),
-                           std::istreambuf_iterator<char>()};
-  } else {
-    IREE_ASSIGN_OR_RETURN(contents, file_io::GetFileContents(input_file));
+  if (input_file != "-") {
+    return LoadBytecodeModuleFromFile(input_file, out_module);
   }
-  return contents;
+  *out_contents = std::string{std::istreambuf_iterator<char>(std::cin),
+                              std::istreambuf_iterator<char>()};
+  return LoadBytecodeModule(*out_contents, out_module);
 }
 
 Status Run() {
@@ -77,9 +77,9 @@ Status Run() {
       iree_vm_instance_create(iree_allocator_system(), &instance))
       << "creating instance";
 
-  IREE_ASSIGN_OR_RETURN(auto module_data, GetModuleContentsFromFlags());
+  std::string module_data;
   iree_vm_module_t* input_module = nullptr;
-  IREE_RETURN_IF_ERROR(LoadBytecodeModule(module_data, &input_module));
+  IREE_RETURN_IF_ERROR(LoadModuleFromFlags(&module_data, &input_module));
 
   iree_hal_device_t* device = nullptr;
   IREE_RETURN_IF_ERROR(CreateDevice(absl::GetFlag(FLAGS_driver), &device));
@@ -57,6 +57,12 @@ static llvm::cl::opt<bool> splitInputFile(
                    "process each chunk independently"),
     llvm::cl::init(false));
 
+static llvm::cl::opt<bool> verifyDiagnostics(
+    "verify-diagnostics",
+    llvm::cl::desc("Check that emitted diagnostics match "
+                   "expected-* lines on the corresponding line"),
+    llvm::cl::init(false));
+
 // TODO(#2958): We shouldn't need to register dialects here if translations
 // correctly declare the dialects they support.
 // TODO(#2958): Investigate whether we can use mlir-translate.cpp as an entry
@@ -118,8 +124,16 @@ int main(int argc, char **argv) {
     registry.appendTo(context.getDialectRegistry());
     llvm::SourceMgr sourceMgr;
     sourceMgr.AddNewSourceBuffer(std::move(ownedBuffer), llvm::SMLoc());
-    mlir::SourceMgrDiagnosticHandler diagHandler(sourceMgr, &context);
-    return (*translationRequested)(sourceMgr, os, &context);
+    if (!verifyDiagnostics) {
+      mlir::SourceMgrDiagnosticHandler diagHandler(sourceMgr, &context);
+      return (*translationRequested)(sourceMgr, os, &context);
+    }
+
+    // In the diagnostic verification flow the translation is expected to fail;
+    // only whether the diagnostics matched the expectations is reported.
+    mlir::SourceMgrDiagnosticVerifierHandler diagHandler(sourceMgr, &context);
+    (void)(*translationRequested)(sourceMgr, os, &context);
+    return diagHandler.verify();
   };
 
   if (splitInputFile) {
@@ -27,6 +27,7 @@
 #include "iree/hal/api.h"
 #include "iree/modules/hal/hal_module.h"
 #include "iree/vm/bytecode_module.h"
+#include "iree/vm/bytecode_module_file.h"
 
 namespace iree {
 
@@ -255,4 +256,13 @@ Status LoadBytecodeModule(absl::string_view module_data,
       << "Deserializing module";
   return OkStatus();
 }
+
+Status LoadBytecodeModuleFromFile(const std::string& path,
+                                  iree_vm_module_t** out_module) {
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_create_from_file(
+      iree_string_view_t{path.data(), path.size()}, iree_allocator_system(),
+      out_module))
+      << "Loading module from '" << path << "'";
+  return OkStatus();
+}
 }  // namespace iree
@@ -94,6 +94,13 @@ Status CreateHalModule(iree_hal_device_t* device,
 Status LoadBytecodeModule(absl::string_view module_data,
                           iree_vm_module_t** out_module);
 
+// Loads a VM bytecode module from the file at |path|.
+// The file is memory-mapped and the module references it in place instead of
+// reading it into memory.
+// The returned |out_module| must be released by the caller.
+Status LoadBytecodeModuleFromFile(const std::string& path,
+                                  iree_vm_module_t** out_module);
+
 }  // namespace iree
 
 #endif  // IREE_TOOLS_VM_UTIL_H_
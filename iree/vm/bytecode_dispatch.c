@@ -12,10 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <math.h>
 #include <string.h>
 
 #include "iree/vm/bytecode_dispatch_util.h"
 #include "iree/vm/list.h"
+#include "iree/vm/ops.h"
 
 //===----------------------------------------------------------------------===//
 // Math utilities, kept here to limit dependencies
@@ -213,7 +215,8 @@ static iree_status_t iree_vm_bytecode_external_enter(
   const uint8_t* p = arguments.data;
   for (iree_host_size_t i = 0; i < cconv_arguments.size; ++i) {
     switch (cconv_arguments.data[i]) {
-      case IREE_VM_CCONV_TYPE_INT32: {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
         uint16_t dst_reg = i32_reg++;
         memcpy(&callee_registers.i32[dst_reg & callee_registers.i32_mask], p,
                sizeof(int32_t));
@@ -254,7 +257,8 @@ static iree_status_t iree_vm_bytecode_external_leave(
   for (iree_host_size_t i = 0; i < cconv_results.size; ++i) {
     uint16_t src_reg = src_reg_list->registers[i];
     switch (cconv_results.data[i]) {
-      case IREE_VM_CCONV_TYPE_INT32: {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
         memcpy(p, &callee_registers->i32[src_reg & callee_registers->i32_mask],
                sizeof(int32_t));
         p += sizeof(int32_t);
@@ -279,6 +283,46 @@ static iree_status_t iree_vm_bytecode_external_leave(
   return iree_vm_stack_function_leave(stack);
 }
 
+// Suspends execution of the current frame at |pc|. The external call state is
+// stashed in the frame so that iree_vm_bytecode_external_resume can pick back
+// up where we left off.
+static void iree_vm_bytecode_external_yield(
+    iree_vm_stack_frame_t* current_frame, iree_vm_source_offset_t pc,
+    int32_t entry_frame_depth, iree_string_view_t cconv_results,
+    iree_byte_span_t call_results) {
+  current_frame->pc = pc;
+  iree_vm_bytecode_frame_storage_t* stack_storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+          current_frame);
+  stack_storage->entry_frame_depth = entry_frame_depth;
+  stack_storage->cconv_results = cconv_results;
+  stack_storage->call_results = call_results;
+}
+
+// Resumes the top bytecode stack frame previously suspended with
+// iree_vm_bytecode_external_yield and restores the external call state.
+static iree_status_t iree_vm_bytecode_external_resume(
+    iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
+    iree_vm_stack_frame_t** out_callee_frame,
+    iree_vm_registers_t* out_callee_registers, int32_t* out_entry_frame_depth,
+    iree_string_view_t* out_cconv_results, iree_byte_span_t* out_call_results) {
+  iree_vm_stack_frame_t* current_frame = iree_vm_stack_current_frame(stack);
+  if (IREE_UNLIKELY(!current_frame) ||
+      IREE_UNLIKELY(current_frame->function.module->self != module)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "stack has no suspended frame in this module");
+  }
+  const iree_vm_bytecode_frame_storage_t* stack_storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+          current_frame);
+  *out_callee_frame = current_frame;
+  *out_callee_registers = iree_vm_bytecode_get_register_storage(current_frame);
+  *out_entry_frame_depth = stack_storage->entry_frame_depth;
+  *out_cconv_results = stack_storage->cconv_results;
+  *out_call_results = stack_storage->call_results;
+  return iree_ok_status();
+}
+
 // Enters an internal bytecode stack frame from a parent bytecode frame.
 // Registers in |src_reg_list| will be marshaled into the callee frame and the
 // |dst_reg_list| will be stashed for use when leaving the frame.
@@ -393,7 +437,8 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
   for (iree_host_size_t i = 0, seg_i = 0, reg_i = 0; i < cconv_arguments.size;
        ++i, ++seg_i) {
     switch (cconv_arguments.data[i]) {
-      case IREE_VM_CCONV_TYPE_INT32: {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
         memcpy(p,
                &caller_registers.i32[src_reg_list->registers[reg_i++] &
                                      caller_registers.i32_mask],
@@ -436,7 +481,8 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
                ++i) {
             // TODO(benvanik): share with switch above.
             switch (cconv_arguments.data[i]) {
-              case IREE_VM_CCONV_TYPE_INT32: {
+              case IREE_VM_CCONV_TYPE_INT32:
+              case IREE_VM_CCONV_TYPE_FLOAT32: {
                 memcpy(p,
                        &caller_registers.i32[src_reg_list->registers[reg_i++] &
                                              caller_registers.i32_mask],
@@ -481,6 +527,12 @@ static iree_status_t iree_vm_bytecode_issue_import_call(
     // TODO(benvanik): set execution result to failure/capture stack.
     return iree_status_annotate(call_status,
                                 iree_make_cstring_view("while calling import"));
+  } else if (IREE_UNLIKELY(out_result->flags &
+                           IREE_VM_EXECUTION_RESULT_FLAG_YIELDED)) {
+    // TODO(benvanik): suspend the caller frame and resume the import first.
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "yielding within imported functions is not "
+                            "supported");
   }
 
   // NOTE: we don't support yielding within imported functions right now so it's
@@ -498,6 +550,7 @@ static iree_status_t iree_vm_bytecode_issue_import_call(
     uint16_t dst_reg = dst_reg_list->registers[i];
     switch (cconv_results.data[i]) {
       case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32:
         memcpy(&caller_registers.i32[dst_reg & caller_registers.i32_mask], p,
                sizeof(int32_t));
         p += sizeof(int32_t);
@@ -621,14 +674,25 @@ iree_status_t iree_vm_bytecode_dispatch(
   // defining below.
   DEFINE_DISPATCH_TABLES();
 
-  // Enter function (as this is the initial call).
+  // Enter function (as this is the initial call) or pick up the frame that
+  // yielded (when resuming).
   // The callee's return will take care of storing the output registers when it
   // actually does return, either immediately or in the future via a resume.
   iree_vm_stack_frame_t* current_frame = NULL;
   iree_vm_registers_t regs;
-  IREE_RETURN_IF_ERROR(
-      iree_vm_bytecode_external_enter(stack, call->function, cconv_arguments,
-                                      call->arguments, &current_frame, &regs));
+  int32_t entry_frame_depth = 0;
+  iree_byte_span_t call_results = iree_make_byte_span(NULL, 0);
+  if (call) {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_external_enter(
+        stack, call->function, cconv_arguments, call->arguments,
+        &current_frame, &regs));
+    entry_frame_depth = current_frame->depth;
+    call_results = call->results;
+  } else {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_external_resume(
+        stack, module, &current_frame, &regs, &entry_frame_depth,
+        &cconv_results, &call_results));
+  }
 
   // Primary dispatch state. This is our 'native stack frame' and really
   // just enough to make dereferencing common addresses (like the current
@@ -644,7 +708,6 @@ iree_status_t iree_vm_bytecode_dispatch(
       module->function_descriptor_table[current_frame->function.ordinal]
           .bytecode_offset;
   iree_vm_source_offset_t pc = current_frame->pc;
-  const int32_t entry_frame_depth = current_frame->depth;
 
   BEGIN_DISPATCH_CORE() {
     //===------------------------------------------------------------------===//
@@ -1196,7 +1259,7 @@ iree_status_t iree_vm_bytecode_dispatch(
         // Return from the top-level entry frame - return back to call().
         return iree_vm_bytecode_external_leave(stack, current_frame, &regs,
                                                src_reg_list, cconv_results,
-                                               call->results);
+                                               call_results);
       }
 
       // Store results into the caller frame and pop back to the parent.
@@ -1226,7 +1289,11 @@ iree_status_t iree_vm_bytecode_dispatch(
     //===------------------------------------------------------------------===//
 
     DISPATCH_OP(CORE, Yield, {
-      // TODO(benvanik): yield with execution results.
+      // Suspend at the next instruction. All state lives in the stack so the
+      // caller is free to resume us later (possibly from another thread).
+      iree_vm_bytecode_external_yield(current_frame, pc, entry_frame_depth,
+                                      cconv_results, call_results);
+      out_result->flags |= IREE_VM_EXECUTION_RESULT_FLAG_YIELDED;
       return iree_ok_status();
     });
 
@@ -1374,7 +1441,7 @@ iree_status_t iree_vm_bytecode_dispatch(
         iree_vm_value_t value;
         IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
             list, index, IREE_VM_VALUE_TYPE_I64, &value));
-        *result = value.i32;
+        *result = value.i64;
       });
 
       DISPATCH_OP(EXT_I64, ListSetI64, {
@@ -1505,8 +1572,235 @@ iree_status_t iree_vm_bytecode_dispatch(
     }
     END_DISPATCH_PREFIX();
 
-    DISPATCH_OP(CORE, PrefixExtF32,
-                { return iree_make_status(IREE_STATUS_UNIMPLEMENTED); });
+    BEGIN_DISPATCH_PREFIX(PrefixExtF32, EXT_F32) {
+#if IREE_VM_EXT_F32_ENABLE
+      //===----------------------------------------------------------------===//
+      // ExtF32: Globals
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, GlobalLoadF32, {
+        uint32_t byte_offset = VM_DecGlobalAttr("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float* value = VM_DecResultRegF32("value");
+        const float* global_ptr =
+            (const float*)(module_state->rwdata_storage.data + byte_offset);
+        *value = *global_ptr;
+      });
+
+      DISPATCH_OP(EXT_F32, GlobalStoreF32, {
+        uint32_t byte_offset = VM_DecGlobalAttr("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float value = VM_DecOperandRegF32("value");
+        float* global_ptr =
+            (float*)(module_state->rwdata_storage.data + byte_offset);
+        *global_ptr = value;
+      });
+
+      DISPATCH_OP(EXT_F32, GlobalLoadIndirectF32, {
+        uint32_t byte_offset = VM_DecOperandRegI32("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float* value = VM_DecResultRegF32("value");
+        const float* global_ptr =
+            (const float*)(module_state->rwdata_storage.data + byte_offset);
+        *value = *global_ptr;
+      });
+
+      DISPATCH_OP(EXT_F32, GlobalStoreIndirectF32, {
+        uint32_t byte_offset = VM_DecOperandRegI32("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float value = VM_DecOperandRegF32("value");
+        float* global_ptr =
+            (float*)(module_state->rwdata_storage.data + byte_offset);
+        *global_ptr = value;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Constants
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, ConstF32, {
+        float value = VM_DecFloatAttr32("value");
+        float* result = VM_DecResultRegF32("result");
+        *result = value;
+      });
+
+      DISPATCH_OP(EXT_F32, ConstF32Zero, {
+        float* result = VM_DecResultRegF32("result");
+        *result = 0.0f;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Lists
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, ListGetF32, {
+        bool list_is_move;
+        iree_vm_ref_t* list_ref = VM_DecOperandRegRef("list", &list_is_move);
+        iree_vm_list_t* list = iree_vm_list_deref(list_ref);
+        if (IREE_UNLIKELY(!list)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+        }
+        uint32_t index = VM_DecOperandRegI32("index");
+        float* result = VM_DecResultRegF32("result");
+        iree_vm_value_t value;
+        IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+            list, index, IREE_VM_VALUE_TYPE_F32, &value));
+        *result = value.f32;
+      });
+
+      DISPATCH_OP(EXT_F32, ListSetF32, {
+        bool list_is_move;
+        iree_vm_ref_t* list_ref = VM_DecOperandRegRef("list", &list_is_move);
+        iree_vm_list_t* list = iree_vm_list_deref(list_ref);
+        if (IREE_UNLIKELY(!list)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+        }
+        uint32_t index = VM_DecOperandRegI32("index");
+        float raw_value = VM_DecOperandRegF32("value");
+        iree_vm_value_t value = iree_vm_value_make_f32(raw_value);
+        IREE_RETURN_IF_ERROR(iree_vm_list_set_value(list, index, &value));
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Conditional assignment
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, SelectF32, {
+        int32_t condition = VM_DecOperandRegI32("condition");
+        float true_value = VM_DecOperandRegF32("true_value");
+        float false_value = VM_DecOperandRegF32("false_value");
+        float* result = VM_DecResultRegF32("result");
+        *result = condition ? true_value : false_value;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Native floating-point arithmetic
+      //===----------------------------------------------------------------===//
+
+#define DISPATCH_OP_EXT_F32_UNARY_ALU_F32(op_name, expr) \
+  DISPATCH_OP(EXT_F32, op_name, {                        \
+    float operand = VM_DecOperandRegF32("operand");      \
+    float* result = VM_DecResultRegF32("result");        \
+    *result = (expr);                                    \
+  });
+
+#define DISPATCH_OP_EXT_F32_BINARY_ALU_F32(op_name, expr) \
+  DISPATCH_OP(EXT_F32, op_name, {                         \
+    float lhs = VM_DecOperandRegF32("lhs");               \
+    float rhs = VM_DecOperandRegF32("rhs");               \
+    float* result = VM_DecResultRegF32("result");         \
+    *result = (expr);                                     \
+  });
+
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(AddF32, lhs + rhs);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(SubF32, lhs - rhs);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(MulF32, lhs * rhs);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(DivF32, lhs / rhs);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(RemF32, fmodf(lhs, rhs));
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(AbsF32, fabsf(operand));
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(NegF32, -operand);
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(CeilF32, ceilf(operand));
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(FloorF32, floorf(operand));
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(SqrtF32, sqrtf(operand));
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(RsqrtF32, 1.0f / sqrtf(operand));
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(ExpF32, expf(operand));
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(LogF32, logf(operand));
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(TanhF32, tanhf(operand));
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Casting and type conversion/emulation
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, CastSI32F32, {
+        int32_t operand = VM_DecOperandRegI32("operand");
+        float* result = VM_DecResultRegF32("result");
+        *result = (float)operand;
+      });
+
+      DISPATCH_OP(EXT_F32, CastUI32F32, {
+        int32_t operand = VM_DecOperandRegI32("operand");
+        float* result = VM_DecResultRegF32("result");
+        *result = (float)(uint32_t)operand;
+      });
+
+      // Saturating casts shared with generated C modules (see ops.h).
+      DISPATCH_OP(EXT_F32, CastF32SI32, {
+        float operand = VM_DecOperandRegF32("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = vm_cast_f32_si32(operand);
+      });
+
+      DISPATCH_OP(EXT_F32, CastF32UI32, {
+        float operand = VM_DecOperandRegF32("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = vm_cast_f32_ui32(operand);
+      });
+
+      // Bitcasts are no-ops as f32 values share the i32 register storage.
+      DISPATCH_OP(EXT_F32, BitcastI32F32, {
+        int32_t operand = VM_DecOperandRegI32("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = operand;
+      });
+
+      DISPATCH_OP(EXT_F32, BitcastF32I32, {
+        int32_t operand = VM_DecOperandRegI32("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = operand;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Comparison ops
+      //===----------------------------------------------------------------===//
+
+#define DISPATCH_OP_EXT_F32_CMP_F32(op_name, op)    \
+  DISPATCH_OP(EXT_F32, op_name, {                   \
+    float lhs = VM_DecOperandRegF32("lhs");         \
+    float rhs = VM_DecOperandRegF32("rhs");         \
+    int32_t* result = VM_DecResultRegI32("result"); \
+    *result = (lhs op rhs) ? 1 : 0;                 \
+  });
+
+      // NOTE: C comparison operators are ordered (false if either operand is
+      // NaN) with the exception of != which is unordered.
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpEQF32, ==);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpNEF32, !=);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpLTF32, <);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpLTEF32, <=);
+      DISPATCH_OP(EXT_F32, CmpNZF32, {
+        float operand = VM_DecOperandRegF32("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = (operand != 0.0f) ? 1 : 0;
+      });
+#else
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED);
+#endif  // IREE_VM_EXT_F32_ENABLE
+    }
+    END_DISPATCH_PREFIX();
 
     DISPATCH_OP(CORE, PrefixExtF64,
                 { return iree_make_status(IREE_STATUS_UNIMPLEMENTED); });
@@ -23,6 +23,7 @@
 #include "iree/base/logging.h"
 #include "iree/base/status.h"
 #include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
 #include "iree/vm/builtin_types.h"
 #include "iree/vm/bytecode_module.h"
 #include "iree/vm/context.h"
@@ -147,4 +148,67 @@ INSTANTIATE_TEST_SUITE_P(VMIRFunctions, VMBytecodeDispatchTest,
                          ::testing::ValuesIn(GetModuleTestParams()),
                          ::testing::PrintToStringParamName());
 
+// Steps each function in yield_ops.mlir one resume at a time to ensure every
+// vm.yield suspends the interpreter (instead of the synchronous iree_vm_invoke
+// above, which hides the yields).
+TEST(VMBytecodeDispatchYieldTest, ResumesOncePerYield) {
+  IREE_CHECK_OK(iree_vm_register_builtin_types());
+
+  const iree::FileToc* module_file = nullptr;
+  auto* module_file_toc = iree::vm::test::all_bytecode_modules_cc_create();
+  for (size_t i = 0; i < iree::vm::test::all_bytecode_modules_cc_size(); ++i) {
+    if (absl::string_view(module_file_toc[i].name) == "yield_ops.module") {
+      module_file = &module_file_toc[i];
+    }
+  }
+  ASSERT_NE(nullptr, module_file);
+
+  iree_vm_instance_t* instance = nullptr;
+  IREE_ASSERT_OK(iree_vm_instance_create(iree_allocator_system(), &instance));
+  iree_vm_module_t* module = nullptr;
+  IREE_ASSERT_OK(iree_vm_bytecode_module_create(
+      iree_const_byte_span_t{
+          reinterpret_cast<const uint8_t*>(module_file->data),
+          module_file->size},
+      iree_allocator_null(), iree_allocator_system(), &module));
+  iree_vm_context_t* context = nullptr;
+  IREE_ASSERT_OK(iree_vm_context_create_with_modules(
+      instance, &module, 1, iree_allocator_system(), &context));
+
+  const struct {
+    const char* function_name;
+    int yield_count;
+  } kExpectations[] = {
+      {"test_yield_sequence", 3},
+      {"test_yield_in_loop", 10},
+      {"test_yield_in_nested_calls", 6},
+      {"test_yield_in_nested_call_loop", 8},
+  };
+  for (const auto& expectation : kExpectations) {
+    SCOPED_TRACE(expectation.function_name);
+    iree_vm_function_t function;
+    IREE_ASSERT_OK(module->lookup_function(
+        module->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_make_cstring_view(expectation.function_name), &function));
+
+    iree_vm_invocation_t* invocation = nullptr;
+    IREE_ASSERT_OK(iree_vm_invocation_create(
+        context, function, /*policy=*/nullptr, /*inputs=*/nullptr,
+        iree_allocator_system(), &invocation));
+    int yield_count = 0;
+    iree::Status status = iree_vm_invocation_query_status(invocation);
+    while (iree::IsUnavailable(status)) {
+      ++yield_count;
+      status = iree_vm_invocation_resume(invocation);
+    }
+    IREE_EXPECT_OK(status);
+    EXPECT_EQ(expectation.yield_count, yield_count);
+    iree_vm_invocation_release(invocation);
+  }
+
+  iree_vm_context_release(context);
+  iree_vm_module_release(module);
+  iree_vm_instance_release(instance);
+}
+
 }  // namespace
@@ -55,6 +55,12 @@ static iree_vm_type_def_t iree_vm_bytecode_module_resolve_type(
   } else if (iree_vm_flatbuffer_strcmp(full_name,
                                        iree_make_cstring_view("i64")) == 0) {
     result.value_type = IREE_VM_VALUE_TYPE_I64;
+  } else if (iree_vm_flatbuffer_strcmp(full_name,
+                                       iree_make_cstring_view("f32")) == 0) {
+    result.value_type = IREE_VM_VALUE_TYPE_F32;
+  } else if (iree_vm_flatbuffer_strcmp(full_name,
+                                       iree_make_cstring_view("f64")) == 0) {
+    result.value_type = IREE_VM_VALUE_TYPE_F64;
   } else if (full_name[0] == '!') {
     // Note that we drop the ! prefix:
     iree_string_view_t type_name = {full_name + 1,
@@ -697,6 +703,20 @@ static iree_status_t iree_vm_bytecode_module_begin_call(
                                    cconv_results, out_result);
 }
 
+static iree_status_t iree_vm_bytecode_module_resume_call(
+    void* self, iree_vm_stack_t* stack,
+    iree_vm_execution_result_t* out_result) {
+  IREE_ASSERT_ARGUMENT(out_result);
+  memset(out_result, 0, sizeof(iree_vm_execution_result_t));
+
+  // The calling convention and result buffer of the original call were stashed
+  // in the stack when it yielded so there's nothing to look up here.
+  iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
+  return iree_vm_bytecode_dispatch(stack, module, /*call=*/NULL,
+                                   iree_string_view_empty(),
+                                   iree_string_view_empty(), out_result);
+}
+
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
     iree_const_byte_span_t flatbuffer_data,
     iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
@@ -761,6 +781,7 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
   module->interface.free_state = iree_vm_bytecode_module_free_state;
   module->interface.resolve_import = iree_vm_bytecode_module_resolve_import;
   module->interface.begin_call = iree_vm_bytecode_module_begin_call;
+  module->interface.resume_call = iree_vm_bytecode_module_resume_call;
   module->interface.get_function_reflection_attr =
       iree_vm_bytecode_module_get_function_reflection_attr;
 
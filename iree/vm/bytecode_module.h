@@ -28,6 +28,12 @@ extern "C" {
 // If a |flatbuffer_allocator| is provided then it will be used to free the
 // |flatbuffer_data| when the module is destroyed and otherwise the ownership of
 // the flatbuffer_data remains with the caller.
+//
+// Rodata segments reference |flatbuffer_data| directly and are aligned by the
+// compiler relative to its start (64 bytes by default). Callers wanting to use
+// rodata as typed or SIMD-aligned storage without copies should provide data
+// aligned to at least that (such as via
+// iree_vm_bytecode_module_create_from_file, which maps whole pages).
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
     iree_const_byte_span_t flatbuffer_data,
     iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
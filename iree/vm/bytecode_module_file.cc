@@ -0,0 +1,58 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/vm/bytecode_module_file.h"
+
+#include "iree/base/file_mapping.h"
+#include "iree/base/tracing.h"
+#include "iree/vm/bytecode_module.h"
+
+namespace iree {
+namespace vm {
+namespace {
+
+// Drops the FileMapping reference held by the flatbuffer allocator when the
+// bytecode module frees its flatbuffer data.
+void IREE_API_PTR ReleaseFileMapping(void* self, void* ptr) {
+  ref_ptr<FileMapping> file_mapping(static_cast<FileMapping*>(self));
+}
+
+}  // namespace
+}  // namespace vm
+}  // namespace iree
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_module_create_from_file(iree_string_view_t file_path,
+                                         iree_allocator_t allocator,
+                                         iree_vm_module_t** out_module) {
+  IREE_TRACE_SCOPE0("iree_vm_bytecode_module_create_from_file");
+  IREE_ASSERT_ARGUMENT(out_module);
+  *out_module = nullptr;
+
+  IREE_ASSIGN_OR_RETURN(
+      auto file_mapping,
+      iree::FileMapping::OpenRead(std::string(file_path.data, file_path.size)));
+  auto file_data = file_mapping->data();
+
+  // Ownership of the mapping transfers to the module on success; the allocator
+  // releases it when the module frees its flatbuffer data.
+  iree_allocator_t flatbuffer_allocator = {
+      file_mapping.get(), /*alloc=*/nullptr,
+      iree::vm::ReleaseFileMapping};
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_create(
+      iree_const_byte_span_t{file_data.data(), file_data.size()},
+      flatbuffer_allocator, allocator, out_module));
+  file_mapping.release();
+  return iree_ok_status();
+}
@@ -0,0 +1,39 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_VM_BYTECODE_MODULE_FILE_H_
+#define IREE_VM_BYTECODE_MODULE_FILE_H_
+
+#include "iree/base/api.h"
+#include "iree/vm/module.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Creates a VM module from a ModuleDef FlatBuffer file at |file_path|.
+// The file is memory-mapped read-only and verified in place; the module and
+// any rodata segments (including embedded executables) reference the mapped
+// pages directly and the mapping is kept alive until the module is destroyed.
+// Processes loading the same file share a single copy in the page cache.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_module_create_from_file(iree_string_view_t file_path,
+                                         iree_allocator_t allocator,
+                                         iree_vm_module_t** out_module);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_VM_BYTECODE_MODULE_FILE_H_
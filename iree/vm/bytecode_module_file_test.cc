@@ -0,0 +1,168 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/vm/bytecode_module_file.h"
+
+#include "absl/strings/string_view.h"
+#include "iree/base/file_io.h"
+#include "iree/base/status.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/builtin_types.h"
+#include "iree/vm/bytecode_module.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/invocation.h"
+#include "iree/vm/list.h"
+#include "iree/vm/ref_cc.h"
+
+// Compiled modules embedded here so that we can write them out to disk:
+#include "iree/vm/bytecode_module_file_test_align4096_module.h"
+#include "iree/vm/bytecode_module_file_test_align64_module.h"
+#include "iree/vm/test/all_bytecode_modules.h"
+
+namespace iree {
+namespace {
+
+class BytecodeModuleFileTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    IREE_CHECK_OK(iree_vm_register_builtin_types());
+  }
+
+  // Writes |contents| to a new temporary file and returns its path.
+  static std::string WriteTempFile(absl::string_view contents) {
+    auto path_or = file_io::GetTempFile("bytecode_module_file");
+    IREE_CHECK_OK(path_or.status());
+    IREE_CHECK_OK(file_io::SetFileContents(path_or.value(), contents));
+    return std::move(path_or).value();
+  }
+
+  static absl::string_view GetModuleContents() {
+    const auto& module_file = vm::test::all_bytecode_modules_cc_create()[0];
+    return absl::string_view(module_file.data, module_file.size);
+  }
+
+  // Loads |module_file| (compiled with |alignment| rodata alignment) from disk
+  // and verifies that every rodata segment it returns is aligned in memory.
+  // Mapped files are page-aligned so the in-module alignment carries over.
+  static void CheckRodataAlignment(const FileToc& module_file,
+                                   size_t alignment) {
+    auto path =
+        WriteTempFile(absl::string_view(module_file.data, module_file.size));
+    iree_vm_module_t* module = nullptr;
+    IREE_ASSERT_OK(iree_vm_bytecode_module_create_from_file(
+        iree_string_view_t{path.data(), path.size()}, iree_allocator_system(),
+        &module));
+
+    iree_vm_instance_t* instance = nullptr;
+    IREE_ASSERT_OK(iree_vm_instance_create(iree_allocator_system(), &instance));
+    iree_vm_context_t* context = nullptr;
+    IREE_ASSERT_OK(iree_vm_context_create_with_modules(
+        instance, &module, 1, iree_allocator_system(), &context));
+
+    iree_vm_function_t function;
+    IREE_ASSERT_OK(module->lookup_function(module->self,
+                                           IREE_VM_FUNCTION_LINKAGE_EXPORT,
+                                           iree_make_cstring_view("rodata"),
+                                           &function));
+    vm::ref<iree_vm_list_t> outputs;
+    IREE_ASSERT_OK(iree_vm_list_create(/*element_type=*/nullptr, 3,
+                                       iree_allocator_system(), &outputs));
+    IREE_ASSERT_OK(iree_vm_invoke(context, function, /*policy=*/nullptr,
+                                  /*inputs=*/nullptr, outputs.get(),
+                                  iree_allocator_system()));
+    ASSERT_EQ(3, iree_vm_list_size(outputs.get()));
+    for (iree_host_size_t i = 0; i < iree_vm_list_size(outputs.get()); ++i) {
+      SCOPED_TRACE(i);
+      auto* rodata = reinterpret_cast<iree_vm_ro_byte_buffer_t*>(
+          iree_vm_list_get_ref_deref(outputs.get(), i,
+                                     iree_vm_ro_byte_buffer_get_descriptor()));
+      ASSERT_NE(nullptr, rodata);
+      EXPECT_NE(0, rodata->data.data_length);
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(rodata->data.data) % alignment);
+    }
+
+    outputs.reset();
+    iree_vm_context_release(context);
+    iree_vm_instance_release(instance);
+    iree_vm_module_release(module);
+    IREE_EXPECT_OK(file_io::DeleteFile(path));
+  }
+};
+
+TEST_F(BytecodeModuleFileTest, MatchesInMemoryModule) {
+  auto contents = GetModuleContents();
+  iree_vm_module_t* memory_module = nullptr;
+  IREE_ASSERT_OK(iree_vm_bytecode_module_create(
+      iree_const_byte_span_t{reinterpret_cast<const uint8_t*>(contents.data()),
+                             contents.size()},
+      iree_allocator_null(), iree_allocator_system(), &memory_module));
+
+  auto path = WriteTempFile(contents);
+  iree_vm_module_t* file_module = nullptr;
+  IREE_ASSERT_OK(iree_vm_bytecode_module_create_from_file(
+      iree_string_view_t{path.data(), path.size()}, iree_allocator_system(),
+      &file_module));
+  IREE_EXPECT_OK(file_io::DeleteFile(path));
+
+  iree_string_view_t memory_name = iree_vm_module_name(memory_module);
+  iree_string_view_t file_name = iree_vm_module_name(file_module);
+  EXPECT_EQ(absl::string_view(file_name.data, file_name.size),
+            absl::string_view(memory_name.data, memory_name.size));
+  iree_vm_module_signature_t memory_signature =
+      iree_vm_module_signature(memory_module);
+  iree_vm_module_signature_t file_signature =
+      iree_vm_module_signature(file_module);
+  EXPECT_EQ(file_signature.export_function_count,
+            memory_signature.export_function_count);
+  EXPECT_EQ(file_signature.import_function_count,
+            memory_signature.import_function_count);
+
+  iree_vm_module_release(file_module);
+  iree_vm_module_release(memory_module);
+}
+
+TEST_F(BytecodeModuleFileTest, FileNotFound) {
+  iree_vm_module_t* module = nullptr;
+  EXPECT_FALSE(iree_status_is_ok(iree_vm_bytecode_module_create_from_file(
+      iree_make_cstring_view("/does/not/exist.vmfb"), iree_allocator_system(),
+      &module)));
+  EXPECT_EQ(module, nullptr);
+}
+
+TEST_F(BytecodeModuleFileTest, InvalidFile) {
+  auto path = WriteTempFile("not a flatbuffer");
+  iree_vm_module_t* module = nullptr;
+  iree_status_t status = iree_vm_bytecode_module_create_from_file(
+      iree_string_view_t{path.data(), path.size()}, iree_allocator_system(),
+      &module);
+  EXPECT_TRUE(iree_status_is_invalid_argument(status));
+  iree_status_ignore(status);
+  EXPECT_EQ(module, nullptr);
+  IREE_EXPECT_OK(file_io::DeleteFile(path));
+}
+
+TEST_F(BytecodeModuleFileTest, RodataAligned64) {
+  CheckRodataAlignment(vm::bytecode_module_file_test_align64_module_create()[0],
+                       64);
+}
+
+TEST_F(BytecodeModuleFileTest, RodataAligned4096) {
+  CheckRodataAlignment(
+      vm::bytecode_module_file_test_align4096_module_create()[0], 4096);
+}
+
+}  // namespace
+}  // namespace iree
@@ -0,0 +1,15 @@
+vm.module @bytecode_module_file_test {
+  // Segments with sizes that are not multiples of any alignment we test so
+  // that each one after the first would be misaligned without padding.
+  vm.rodata @buffer_a dense<[1, 2, 3]> : tensor<3xi8>
+  vm.rodata @buffer_b dense<[4, 5, 6, 7, 8]> : tensor<5xi8>
+  vm.rodata @buffer_c dense<[1.0, 2.0, 3.0]> : tensor<3xf32>
+
+  vm.export @rodata
+  vm.func @rodata() -> (!vm.ref<!iree.byte_buffer>, !vm.ref<!iree.byte_buffer>, !vm.ref<!iree.byte_buffer>) {
+    %a = vm.const.ref.rodata @buffer_a : !vm.ref<!iree.byte_buffer>
+    %b = vm.const.ref.rodata @buffer_b : !vm.ref<!iree.byte_buffer>
+    %c = vm.const.ref.rodata @buffer_c : !vm.ref<!iree.byte_buffer>
+    vm.return %a, %b, %c : !vm.ref<!iree.byte_buffer>, !vm.ref<!iree.byte_buffer>, !vm.ref<!iree.byte_buffer>
+  }
+}
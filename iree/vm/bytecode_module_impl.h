@@ -136,6 +136,10 @@ typedef struct {
 // Begins (or resumes) execution of the current frame and continues until
 // either a yield or return. |out_result| will contain the result status for
 // continuation, if needed.
+//
+// When |call| is NULL execution resumes from the top frame of |stack|, which
+// must have previously yielded; |cconv_arguments| and |cconv_results| are
+// ignored as the original call state is retained in the stack.
 iree_status_t iree_vm_bytecode_dispatch(iree_vm_stack_t* stack,
                                         iree_vm_bytecode_module_t* module,
                                         const iree_vm_function_call_t* call,
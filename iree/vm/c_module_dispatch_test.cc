@@ -0,0 +1,170 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs the op tests in iree/vm/test/ against modules compiled ahead of time to
+// C with --iree-vm-ir-to-c-module.
+//
+// These are the same functions bytecode_dispatch_test.cc runs through the
+// interpreter so any difference in behavior between the two paths shows up as
+// a failure here.
+
+#include "absl/strings/match.h"
+#include "iree/base/logging.h"
+#include "iree/base/status.h"
+#include "iree/testing/gtest.h"
+#include "iree/vm/api.h"
+
+// Entry points of the generated modules in iree/vm/test/.
+extern "C" {
+iree_status_t arithmetic_ops_create(iree_allocator_t allocator,
+                                    iree_vm_module_t** out_module);
+iree_status_t arithmetic_ops_f32_create(iree_allocator_t allocator,
+                                        iree_vm_module_t** out_module);
+iree_status_t arithmetic_ops_i64_create(iree_allocator_t allocator,
+                                        iree_vm_module_t** out_module);
+iree_status_t comparison_ops_create(iree_allocator_t allocator,
+                                    iree_vm_module_t** out_module);
+iree_status_t control_flow_ops_create(iree_allocator_t allocator,
+                                      iree_vm_module_t** out_module);
+iree_status_t list_ops_create(iree_allocator_t allocator,
+                              iree_vm_module_t** out_module);
+iree_status_t ref_ops_create(iree_allocator_t allocator,
+                             iree_vm_module_t** out_module);
+iree_status_t yield_ops_create(iree_allocator_t allocator,
+                               iree_vm_module_t** out_module);
+}  // extern "C"
+
+namespace {
+
+typedef iree_status_t (*CreateModuleFn)(iree_allocator_t allocator,
+                                        iree_vm_module_t** out_module);
+
+struct TestModule {
+  const char* name;
+  CreateModuleFn create;
+};
+
+const TestModule kTestModules[] = {
+    {"arithmetic_ops", arithmetic_ops_create},
+    {"arithmetic_ops_f32", arithmetic_ops_f32_create},
+    {"arithmetic_ops_i64", arithmetic_ops_i64_create},
+    {"comparison_ops", comparison_ops_create},
+    {"control_flow_ops", control_flow_ops_create},
+    {"list_ops", list_ops_create},
+    {"ref_ops", ref_ops_create},
+    {"yield_ops", yield_ops_create},
+};
+
+struct TestParams {
+  const TestModule& module;
+  std::string function_name;
+};
+
+std::ostream& operator<<(std::ostream& os, const TestParams& params) {
+  return os << params.module.name << "_" << params.function_name;
+}
+
+std::vector<TestParams> GetModuleTestParams() {
+  std::vector<TestParams> test_params;
+
+  IREE_CHECK_OK(iree_vm_register_builtin_types());
+
+  for (const auto& test_module : kTestModules) {
+    iree_vm_module_t* module = nullptr;
+    IREE_CHECK_OK(test_module.create(iree_allocator_system(), &module))
+        << "C module failed to load";
+    iree_vm_module_signature_t signature = module->signature(module->self);
+    test_params.reserve(test_params.size() + signature.export_function_count);
+    for (int i = 0; i < signature.export_function_count; ++i) {
+      iree_string_view_t name;
+      IREE_CHECK_OK(module->get_function(module->self,
+                                         IREE_VM_FUNCTION_LINKAGE_EXPORT, i,
+                                         nullptr, &name, nullptr));
+      test_params.push_back({test_module, std::string(name.data, name.size)});
+    }
+    iree_vm_module_release(module);
+  }
+
+  return test_params;
+}
+
+class VMCModuleDispatchTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<TestParams> {
+ protected:
+  virtual void SetUp() {
+    const auto& test_params = GetParam();
+
+    IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance_));
+
+    IREE_CHECK_OK(
+        test_params.module.create(iree_allocator_system(), &c_module_))
+        << "C module failed to load";
+
+    std::vector<iree_vm_module_t*> modules = {c_module_};
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, modules.data(), modules.size(), iree_allocator_system(),
+        &context_));
+  }
+
+  virtual void TearDown() {
+    iree_vm_module_release(c_module_);
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  iree_status_t RunFunction(absl::string_view function_name) {
+    iree_vm_function_t function;
+    IREE_CHECK_OK(c_module_->lookup_function(
+        c_module_->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_string_view_t{function_name.data(), function_name.size()},
+        &function))
+        << "Exported function '" << function_name << "' not found";
+
+    return iree_vm_invoke(context_, function,
+                          /*policy=*/nullptr, /*inputs=*/nullptr,
+                          /*outputs=*/nullptr, iree_allocator_system());
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+  iree_vm_module_t* c_module_ = nullptr;
+};
+
+TEST_P(VMCModuleDispatchTest, Check) {
+  const auto& test_params = GetParam();
+  bool expect_failure = absl::StartsWith(test_params.function_name, "fail_");
+
+  iree::Status result = RunFunction(test_params.function_name);
+  if (result.ok()) {
+    if (expect_failure) {
+      GTEST_FAIL() << "Function expected failure but succeeded";
+    } else {
+      GTEST_SUCCEED();
+    }
+  } else {
+    if (expect_failure) {
+      GTEST_SUCCEED();
+    } else {
+      GTEST_FAIL() << "Function expected success but failed with error: "
+                   << result.ToString();
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(VMIRFunctions, VMCModuleDispatchTest,
+                         ::testing::ValuesIn(GetModuleTestParams()),
+                         ::testing::PrintToStringParamName());
+
+}  // namespace
@@ -58,10 +58,14 @@ static iree_status_t iree_vm_context_run_function(
     return status;
   }
 
+  // Initializers are run synchronously: if they yield we immediately resume.
   iree_vm_execution_result_t result;
+  memset(&result, 0, sizeof(result));
   status = module->begin_call(module->self, stack, &call, &result);
-
-  // TODO(benvanik): ensure completed synchronously.
+  while (iree_status_is_ok(status) &&
+         (result.flags & IREE_VM_EXECUTION_RESULT_FLAG_YIELDED)) {
+    status = module->resume_call(module->self, stack, &result);
+  }
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -15,11 +15,12 @@
 #include "iree/vm/invocation.h"
 
 #include "iree/base/api.h"
+#include "iree/base/atomics.h"
 #include "iree/base/tracing.h"
 
 // Marshals caller arguments from the variant list to the ABI convention.
 static iree_status_t iree_vm_invoke_marshal_inputs(
-    iree_string_view_t cconv_arguments, iree_vm_list_t* inputs,
+    iree_string_view_t cconv_arguments, const iree_vm_list_t* inputs,
     iree_byte_span_t arguments) {
   // We are 1:1 right now with no variadic args, so do a quick verification on
   // the input list.
@@ -55,6 +56,13 @@ static iree_status_t iree_vm_invoke_marshal_inputs(
         memcpy(p, &value.i64, sizeof(int64_t));
         p += sizeof(int64_t);
       } break;
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
+        iree_vm_value_t value;
+        IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+            inputs, arg_i, IREE_VM_VALUE_TYPE_F32, &value));
+        memcpy(p, &value.f32, sizeof(float));
+        p += sizeof(float);
+      } break;
       case IREE_VM_CCONV_TYPE_REF: {
         // TODO(benvanik): see if we can't remove this retain by instead relying
         // on the caller still owning the list.
@@ -99,6 +107,11 @@ static iree_status_t iree_vm_invoke_marshal_outputs(
         IREE_RETURN_IF_ERROR(iree_vm_list_set_value(outputs, arg_i, &value));
         p += sizeof(int64_t);
       } break;
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
+        iree_vm_value_t value = iree_vm_value_make_f32(*(float*)p);
+        IREE_RETURN_IF_ERROR(iree_vm_list_set_value(outputs, arg_i, &value));
+        p += sizeof(float);
+      } break;
       case IREE_VM_CCONV_TYPE_REF: {
         IREE_RETURN_IF_ERROR(
             iree_vm_list_set_ref_move(outputs, arg_i, (iree_vm_ref_t*)p));
@@ -109,7 +122,22 @@ static iree_status_t iree_vm_invoke_marshal_outputs(
   return iree_ok_status();
 }
 
-// TODO(benvanik): implement this as an iree_vm_invocation_t sequence.
+// Begins |call| on |stack| and resumes it each time it yields until it
+// completes.
+static iree_status_t iree_vm_invoke_call_sync(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call) {
+  iree_vm_module_t* module = call->function.module;
+  iree_vm_execution_result_t result;
+  memset(&result, 0, sizeof(result));
+  iree_status_t status =
+      module->begin_call(module->self, stack, call, &result);
+  while (iree_status_is_ok(status) &&
+         (result.flags & IREE_VM_EXECUTION_RESULT_FLAG_YIELDED)) {
+    status = module->resume_call(module->self, stack, &result);
+  }
+  return status;
+}
+
 static iree_status_t iree_vm_invoke_within(
     iree_vm_context_t* context, iree_vm_stack_t* stack,
     iree_vm_function_t function, const iree_vm_invocation_policy_t* policy,
@@ -142,16 +170,14 @@ static iree_status_t iree_vm_invoke_within(
   results.data = iree_alloca(results.data_length);
   memset(results.data, 0, results.data_length);
 
-  // Perform execution. Note that for synchronous execution we expect this to
-  // complete without yielding.
+  // Perform execution. As this is synchronous any yields are resumed
+  // immediately on this thread.
   iree_vm_function_call_t call;
   memset(&call, 0, sizeof(call));
   call.function = function;
   call.arguments = arguments;
   call.results = results;
-  iree_vm_execution_result_t result;
-  iree_status_t status =
-      function.module->begin_call(function.module->self, stack, &call, &result);
+  iree_status_t status = iree_vm_invoke_call_sync(stack, &call);
   if (!iree_status_is_ok(status)) {
     iree_vm_function_call_release(&call, &signature);
     return status;
@@ -180,3 +206,242 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invocation_t
+//===----------------------------------------------------------------------===//
+
+struct iree_vm_invocation {
+  iree_atomic_intptr_t ref_count;
+  iree_allocator_t allocator;
+  iree_vm_context_t* context;
+
+  iree_vm_function_signature_t signature;
+  iree_string_view_t cconv_results;
+
+  // Call with argument and result storage allocated inline after the struct.
+  // The results buffer must remain valid across yields as the callee writes
+  // to it when it finally returns.
+  iree_vm_function_call_t call;
+
+  // Heap-allocated fiber stack holding the frames of the suspended call.
+  // NULL once the invocation has completed.
+  iree_vm_stack_t* stack;
+
+  // Completion status; IREE_STATUS_UNAVAILABLE while in-flight.
+  iree_status_t status;
+
+  // Outputs populated when the invocation completes successfully.
+  iree_vm_list_t* outputs;
+};
+
+static void iree_vm_invocation_destroy(iree_vm_invocation_t* invocation);
+
+static bool iree_vm_invocation_is_complete(iree_vm_invocation_t* invocation) {
+  return invocation->stack == NULL;
+}
+
+// Marks the invocation as completed with |status|, taking ownership of it.
+// Any frames remaining on the stack (such as after a failure or abort) are
+// unwound and the resources they hold are released.
+static void iree_vm_invocation_complete(iree_vm_invocation_t* invocation,
+                                        iree_status_t status) {
+  if (!iree_status_is_ok(status)) {
+    iree_vm_function_call_release(&invocation->call, &invocation->signature);
+  }
+  iree_vm_stack_free(invocation->stack);
+  invocation->stack = NULL;
+  invocation->status = status;
+}
+
+// Handles the result of a begin_call/resume_call by either leaving the
+// invocation in-flight (if it yielded) or completing it.
+static void iree_vm_invocation_handle_result(
+    iree_vm_invocation_t* invocation, iree_status_t status,
+    const iree_vm_execution_result_t* result) {
+  if (iree_status_is_ok(status)) {
+    if (result->flags & IREE_VM_EXECUTION_RESULT_FLAG_YIELDED) {
+      // Suspended; the stack retains everything we need to resume.
+      return;
+    }
+    status = iree_vm_invoke_marshal_outputs(
+        invocation->cconv_results, invocation->call.results,
+        invocation->outputs);
+  }
+  iree_vm_invocation_complete(invocation, status);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
+    iree_allocator_t allocator, iree_vm_invocation_t** out_invocation) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_invocation);
+  *out_invocation = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&function);
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  iree_string_view_t cconv_results = iree_string_view_empty();
+  iree_host_size_t arguments_size = 0;
+  iree_host_size_t results_size = 0;
+  iree_status_t status = iree_vm_function_call_get_cconv_fragments(
+      &signature, &cconv_arguments, &cconv_results);
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_function_call_compute_cconv_fragment_size(
+        cconv_arguments, /*segment_size_list=*/NULL, &arguments_size);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_function_call_compute_cconv_fragment_size(
+        cconv_results, /*segment_size_list=*/NULL, &results_size);
+  }
+
+  // Allocate the invocation with the ABI argument/result storage trailing it.
+  iree_host_size_t header_size =
+      iree_math_align(sizeof(iree_vm_invocation_t), 16);
+  iree_host_size_t arguments_offset = header_size;
+  iree_host_size_t results_offset =
+      arguments_offset + iree_math_align(arguments_size, 16);
+  iree_host_size_t total_size = results_offset + results_size;
+  iree_vm_invocation_t* invocation = NULL;
+  if (iree_status_is_ok(status)) {
+    status =
+        iree_allocator_malloc(allocator, total_size, (void**)&invocation);
+  }
+  if (!iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  memset(invocation, 0, total_size);
+  iree_atomic_store(&invocation->ref_count, 1);
+  invocation->allocator = allocator;
+  invocation->context = context;
+  iree_vm_context_retain(context);
+  invocation->signature = signature;
+  invocation->cconv_results = cconv_results;
+  invocation->call.function = function;
+  invocation->call.arguments = iree_make_byte_span(
+      (uint8_t*)invocation + arguments_offset, arguments_size);
+  invocation->call.results = iree_make_byte_span(
+      (uint8_t*)invocation + results_offset, results_size);
+  invocation->status = iree_status_from_code(IREE_STATUS_UNAVAILABLE);
+
+  // Marshal the inputs now so that the caller is free to reuse the list.
+  status = iree_vm_invoke_marshal_inputs(cconv_arguments, inputs,
+                                         invocation->call.arguments);
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_list_create(/*element_type=*/NULL, cconv_results.size,
+                                 allocator, &invocation->outputs);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_stack_allocate(iree_vm_context_state_resolver(context),
+                                    allocator, &invocation->stack);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_vm_function_call_release(&invocation->call, &invocation->signature);
+    iree_vm_invocation_release(invocation);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // Run until the first yield or completion. Failures during execution are
+  // reported via iree_vm_invocation_query_status.
+  iree_vm_module_t* module = function.module;
+  iree_vm_execution_result_t result;
+  memset(&result, 0, sizeof(result));
+  status = module->begin_call(module->self, invocation->stack,
+                              &invocation->call, &result);
+  iree_vm_invocation_handle_result(invocation, status, &result);
+
+  *out_invocation = invocation;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_vm_invocation_destroy(iree_vm_invocation_t* invocation) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (!iree_vm_invocation_is_complete(invocation)) {
+    iree_vm_invocation_complete(
+        invocation, iree_status_from_code(IREE_STATUS_ABORTED));
+  }
+  iree_status_ignore(invocation->status);
+  iree_vm_list_release(invocation->outputs);
+  iree_vm_context_release(invocation->context);
+  iree_allocator_free(invocation->allocator, invocation);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_invocation_retain(iree_vm_invocation_t* invocation) {
+  if (invocation) {
+    iree_atomic_fetch_add(&invocation->ref_count, 1);
+  }
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_invocation_release(iree_vm_invocation_t* invocation) {
+  if (invocation && iree_atomic_fetch_sub(&invocation->ref_count, 1) == 1) {
+    iree_vm_invocation_destroy(invocation);
+  }
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_query_status(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (!iree_vm_invocation_is_complete(invocation)) {
+    return iree_status_from_code(IREE_STATUS_UNAVAILABLE);
+  }
+  return iree_status_clone(invocation->status);
+}
+
+IREE_API_EXPORT const iree_vm_list_t* IREE_API_CALL
+iree_vm_invocation_output(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (!iree_vm_invocation_is_complete(invocation) ||
+      !iree_status_is_ok(invocation->status)) {
+    return NULL;
+  }
+  return invocation->outputs;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_resume(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (!iree_vm_invocation_is_complete(invocation)) {
+    IREE_TRACE_ZONE_BEGIN(z0);
+    iree_vm_module_t* module = invocation->call.function.module;
+    iree_vm_execution_result_t result;
+    memset(&result, 0, sizeof(result));
+    iree_status_t status =
+        module->resume_call(module->self, invocation->stack, &result);
+    iree_vm_invocation_handle_result(invocation, status, &result);
+    IREE_TRACE_ZONE_END(z0);
+  }
+  return iree_vm_invocation_query_status(invocation);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_await(
+    iree_vm_invocation_t* invocation, iree_time_t deadline) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  while (!iree_vm_invocation_is_complete(invocation)) {
+    if (deadline != IREE_TIME_INFINITE_FUTURE && iree_time_now() >= deadline) {
+      return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+    }
+    iree_status_ignore(iree_vm_invocation_resume(invocation));
+  }
+  return iree_vm_invocation_query_status(invocation);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_abort(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (!iree_vm_invocation_is_complete(invocation)) {
+    iree_vm_invocation_complete(
+        invocation, iree_make_status(IREE_STATUS_ABORTED,
+                                     "invocation aborted while in-flight"));
+  }
+  return iree_ok_status();
+}
@@ -47,18 +47,37 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
     const iree_vm_invocation_policy_t* policy, iree_vm_list_t* inputs,
     iree_vm_list_t* outputs, iree_allocator_t allocator);
 
-// TODO(benvanik): document and implement.
+// Creates an asynchronous invocation of |function| and begins executing it on
+// the calling thread until it either completes or yields.
+//
+// Invocations own their own VM stack so that execution can be suspended at
+// yield points and resumed later by a scheduler with iree_vm_invocation_resume
+// or iree_vm_invocation_await. This allows a small number of threads to
+// multiplex many in-flight invocations instead of blocking one thread per call.
+//
+// |policy| is used to schedule the invocation relative to other pending or
+// in-flight invocations. It may be omitted to leave the behavior up to the
+// implementation.
+//
+// |inputs| is used to pass values and objects into the target function and must
+// match the signature defined by the compiled function. List ownership remains
+// with the caller and any refs required are retained by the invocation.
+//
+// Invocations are not internally synchronized: resume, await, and abort must
+// not be called concurrently on the same invocation. Separate invocations may
+// be driven from different threads.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_create(
     iree_vm_context_t* context, iree_vm_function_t function,
     const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
     iree_allocator_t allocator, iree_vm_invocation_t** out_invocation);
 
 // Retains the given |invocation| for the caller.
-IREE_API_EXPORT iree_status_t IREE_API_CALL
+IREE_API_EXPORT void IREE_API_CALL
 iree_vm_invocation_retain(iree_vm_invocation_t* invocation);
 
 // Releases the given |invocation| from the caller.
-IREE_API_EXPORT iree_status_t IREE_API_CALL
+// In-flight invocations are aborted when the last reference is released.
+IREE_API_EXPORT void IREE_API_CALL
 iree_vm_invocation_release(iree_vm_invocation_t* invocation);
 
 // Queries the completion status of the invocation.
@@ -80,7 +99,16 @@ iree_vm_invocation_query_status(iree_vm_invocation_t* invocation);
 IREE_API_EXPORT const iree_vm_list_t* IREE_API_CALL
 iree_vm_invocation_output(iree_vm_invocation_t* invocation);
 
+// Resumes a yielded invocation on the calling thread and runs it until it
+// either yields again or completes. A no-op if the invocation has completed.
+//
+// Returns iree_vm_invocation_query_status after execution stops; schedulers
+// can use IREE_STATUS_UNAVAILABLE to requeue the invocation.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_resume(iree_vm_invocation_t* invocation);
+
 // Blocks the caller until the invocation completes (successfully or otherwise).
+// Yielded execution is resumed on the calling thread.
 //
 // Returns IREE_STATUS_DEADLINE_EXCEEDED if |deadline| elapses before the
 // invocation completes and otherwise returns iree_vm_invocation_query_status.
@@ -0,0 +1,262 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/vm/invocation.h"
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/list.h"
+#include "iree/vm/native_module.h"
+#include "iree/vm/ref_cc.h"
+#include "iree/vm/stack.h"
+
+namespace iree {
+namespace {
+
+//===----------------------------------------------------------------------===//
+// yield_module
+//===----------------------------------------------------------------------===//
+// A native module with a single `yield_module.count(i32) -> i32` export that
+// yields once per count before returning the count. Frame state is kept in the
+// VM stack so that it can be resumed from any thread.
+
+typedef struct {
+  int32_t remaining;
+  int32_t total;
+  iree_byte_span_t results;
+} yield_frame_t;
+
+// Runs the top |stack| frame until it yields or completes.
+static iree_status_t yield_module_run(iree_vm_stack_t* stack,
+                                      iree_vm_execution_result_t* out_result) {
+  yield_frame_t* frame = (yield_frame_t*)iree_vm_stack_frame_storage(
+      iree_vm_stack_current_frame(stack));
+  if (frame->remaining > 0) {
+    --frame->remaining;
+    out_result->flags |= IREE_VM_EXECUTION_RESULT_FLAG_YIELDED;
+    return iree_ok_status();
+  }
+  memcpy(frame->results.data, &frame->total, sizeof(frame->total));
+  return iree_vm_stack_function_leave(stack);
+}
+
+static iree_status_t IREE_API_PTR yield_module_begin_call(
+    void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  memset(out_result, 0, sizeof(*out_result));
+  iree_vm_stack_frame_t* callee_frame = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_stack_function_enter(
+      stack, &call->function, IREE_VM_STACK_FRAME_NATIVE,
+      sizeof(yield_frame_t), /*frame_cleanup_fn=*/NULL, &callee_frame));
+  yield_frame_t* frame =
+      (yield_frame_t*)iree_vm_stack_frame_storage(callee_frame);
+  memcpy(&frame->total, call->arguments.data, sizeof(frame->total));
+  frame->remaining = frame->total;
+  frame->results = call->results;
+  return yield_module_run(stack, out_result);
+}
+
+static iree_status_t IREE_API_PTR yield_module_resume_call(
+    void* self, iree_vm_stack_t* stack,
+    iree_vm_execution_result_t* out_result) {
+  memset(out_result, 0, sizeof(*out_result));
+  return yield_module_run(stack, out_result);
+}
+
+static void IREE_API_PTR yield_module_destroy(void* self) {}
+
+static iree_status_t IREE_API_PTR yield_module_alloc_state(
+    void* self, iree_allocator_t allocator,
+    iree_vm_module_state_t** out_module_state) {
+  *out_module_state = NULL;
+  return iree_ok_status();
+}
+
+static void IREE_API_PTR yield_module_free_state(
+    void* self, iree_vm_module_state_t* module_state) {}
+
+static const iree_vm_native_export_descriptor_t yield_module_exports_[] = {
+    {iree_make_cstring_view("count"), iree_make_cstring_view("0i.i"), 0,
+     NULL},
+};
+static const iree_vm_native_module_descriptor_t yield_module_descriptor_ = {
+    iree_make_cstring_view("yield_module"),
+    0,
+    NULL,
+    IREE_ARRAYSIZE(yield_module_exports_),
+    yield_module_exports_,
+    0,
+    NULL,
+    0,
+    NULL,
+};
+
+static iree_status_t yield_module_create(iree_allocator_t allocator,
+                                         iree_vm_module_t** out_module) {
+  iree_vm_module_t interface;
+  IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, NULL));
+  interface.destroy = yield_module_destroy;
+  interface.alloc_state = yield_module_alloc_state;
+  interface.free_state = yield_module_free_state;
+  interface.begin_call = yield_module_begin_call;
+  interface.resume_call = yield_module_resume_call;
+  return iree_vm_native_module_create(&interface, &yield_module_descriptor_,
+                                      allocator, out_module);
+}
+
+class VMInvocationTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance_));
+    iree_vm_module_t* module = nullptr;
+    IREE_CHECK_OK(yield_module_create(iree_allocator_system(), &module));
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, &module, 1, iree_allocator_system(), &context_));
+    iree_vm_module_release(module);
+    IREE_CHECK_OK(iree_vm_context_resolve_function(
+        context_, iree_make_cstring_view("yield_module.count"), &function_));
+  }
+
+  virtual void TearDown() {
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  vm::ref<iree_vm_list_t> MakeInputs(int32_t count) {
+    vm::ref<iree_vm_list_t> inputs;
+    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                      iree_allocator_system(), &inputs));
+    auto value = iree_vm_value_make_i32(count);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs.get(), &value));
+    return inputs;
+  }
+
+  iree_vm_invocation_t* CreateInvocation(int32_t count) {
+    auto inputs = MakeInputs(count);
+    iree_vm_invocation_t* invocation = nullptr;
+    IREE_CHECK_OK(iree_vm_invocation_create(context_, function_,
+                                            /*policy=*/nullptr, inputs.get(),
+                                            iree_allocator_system(),
+                                            &invocation));
+    return invocation;
+  }
+
+  static int32_t GetResult(iree_vm_invocation_t* invocation) {
+    const iree_vm_list_t* outputs = iree_vm_invocation_output(invocation);
+    if (!outputs) return -1;
+    iree_vm_value_t value;
+    IREE_CHECK_OK(iree_vm_list_get_value(outputs, 0, &value));
+    return value.i32;
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+  iree_vm_function_t function_;
+};
+
+TEST_F(VMInvocationTest, InvokeResumesSynchronously) {
+  auto inputs = MakeInputs(3);
+  vm::ref<iree_vm_list_t> outputs;
+  IREE_ASSERT_OK(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                     iree_allocator_system(), &outputs));
+  IREE_ASSERT_OK(iree_vm_invoke(context_, function_, /*policy=*/nullptr,
+                                inputs.get(), outputs.get(),
+                                iree_allocator_system()));
+  iree_vm_value_t value;
+  IREE_ASSERT_OK(iree_vm_list_get_value(outputs.get(), 0, &value));
+  EXPECT_EQ(value.i32, 3);
+}
+
+TEST_F(VMInvocationTest, CompletesWithoutYielding) {
+  iree_vm_invocation_t* invocation = CreateInvocation(0);
+  IREE_EXPECT_OK(iree_vm_invocation_query_status(invocation));
+  EXPECT_EQ(GetResult(invocation), 0);
+  iree_vm_invocation_release(invocation);
+}
+
+TEST_F(VMInvocationTest, ResumeUntilComplete) {
+  iree_vm_invocation_t* invocation = CreateInvocation(2);
+  EXPECT_TRUE(iree_status_is_unavailable(
+      iree_vm_invocation_query_status(invocation)));
+  EXPECT_EQ(iree_vm_invocation_output(invocation), nullptr);
+  EXPECT_TRUE(
+      iree_status_is_unavailable(iree_vm_invocation_resume(invocation)));
+  IREE_EXPECT_OK(iree_vm_invocation_resume(invocation));
+  EXPECT_EQ(GetResult(invocation), 2);
+
+  // Resuming a completed invocation is a no-op.
+  IREE_EXPECT_OK(iree_vm_invocation_resume(invocation));
+  iree_vm_invocation_release(invocation);
+}
+
+TEST_F(VMInvocationTest, InterleavedInvocations) {
+  // Multiplex several in-flight invocations on a single thread.
+  iree_vm_invocation_t* invocations[3] = {
+      CreateInvocation(3),
+      CreateInvocation(1),
+      CreateInvocation(2),
+  };
+  int pending = IREE_ARRAYSIZE(invocations);
+  while (pending > 0) {
+    pending = 0;
+    for (auto* invocation : invocations) {
+      iree_status_t status = iree_vm_invocation_resume(invocation);
+      if (iree_status_is_unavailable(status)) {
+        ++pending;
+      } else {
+        IREE_EXPECT_OK(status);
+      }
+    }
+  }
+  EXPECT_EQ(GetResult(invocations[0]), 3);
+  EXPECT_EQ(GetResult(invocations[1]), 1);
+  EXPECT_EQ(GetResult(invocations[2]), 2);
+  for (auto* invocation : invocations) {
+    iree_vm_invocation_release(invocation);
+  }
+}
+
+TEST_F(VMInvocationTest, Await) {
+  iree_vm_invocation_t* invocation = CreateInvocation(4);
+  EXPECT_TRUE(iree_status_is_deadline_exceeded(
+      iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_PAST)));
+  IREE_EXPECT_OK(
+      iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(GetResult(invocation), 4);
+  iree_vm_invocation_release(invocation);
+}
+
+TEST_F(VMInvocationTest, Abort) {
+  iree_vm_invocation_t* invocation = CreateInvocation(4);
+  IREE_EXPECT_OK(iree_vm_invocation_abort(invocation));
+  iree_status_t status = iree_vm_invocation_query_status(invocation);
+  EXPECT_TRUE(iree_status_is_aborted(status));
+  iree_status_ignore(status);
+  EXPECT_EQ(iree_vm_invocation_output(invocation), nullptr);
+
+  // Aborting a completed invocation is a no-op.
+  IREE_EXPECT_OK(iree_vm_invocation_abort(invocation));
+  iree_vm_invocation_release(invocation);
+}
+
+TEST_F(VMInvocationTest, ReleaseInFlight) {
+  iree_vm_invocation_t* invocation = CreateInvocation(4);
+  iree_vm_invocation_release(invocation);
+}
+
+}  // namespace
+}  // namespace iree
@@ -57,6 +57,7 @@ iree_vm_function_call_compute_cconv_fragment_size(
        ++i, ++seg_i) {
     switch (cconv_fragment.data[i]) {
       case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32:
         required_size += sizeof(int32_t);
         break;
       case IREE_VM_CCONV_TYPE_INT64:
@@ -80,6 +81,7 @@ iree_vm_function_call_compute_cconv_fragment_size(
              ++i) {
           switch (cconv_fragment.data[i]) {
             case IREE_VM_CCONV_TYPE_INT32:
+            case IREE_VM_CCONV_TYPE_FLOAT32:
               span_size += sizeof(int32_t);
               break;
             case IREE_VM_CCONV_TYPE_INT64:
@@ -123,6 +125,7 @@ iree_vm_function_call_release(iree_vm_function_call_t* call,
     }
     switch (c) {
       case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32:
         p += sizeof(int32_t);
         break;
       case IREE_VM_CCONV_TYPE_INT64:
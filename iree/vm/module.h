@@ -103,11 +103,12 @@ typedef struct {
   // - Zero or more arguments:
   //   - 'i': int32_t integer (i32)
   //   - 'I': int64_t integer (i64)
+  //   - 'f': IEEE-754 single precision float (f32)
   //   - 'r': ref-counted type pointer (!vm.ref<?>)
   //   - '[' ... ']': variadic list of flattened tuples of a specified type
   // - EOL or '.'
   // - Zero or more results:
-  //   - 'i' or 'I'
+  //   - 'i', 'I', or 'f'
   //   - 'r'
   //
   // Examples:
@@ -204,6 +205,7 @@ typedef struct {
 
 #define IREE_VM_CCONV_TYPE_INT32 'i'
 #define IREE_VM_CCONV_TYPE_INT64 'I'
+#define IREE_VM_CCONV_TYPE_FLOAT32 'f'
 #define IREE_VM_CCONV_TYPE_REF 'r'
 #define IREE_VM_CCONV_TYPE_SPAN_START '['
 #define IREE_VM_CCONV_TYPE_SPAN_END ']'
@@ -245,14 +247,22 @@ IREE_API_EXPORT void IREE_API_CALL
 iree_vm_function_call_release(iree_vm_function_call_t* call,
                               const iree_vm_function_signature_t* signature);
 
-// Results of an iree_vm_module_execute request.
+// Flags describing how execution returned to the caller.
+enum iree_vm_execution_result_flag_e {
+  IREE_VM_EXECUTION_RESULT_FLAG_NONE = 0u,
+  // Execution yielded before the call completed. All state required to
+  // continue is retained in the stack and the call must be continued with
+  // resume_call using the same stack. Results are not available until the call
+  // returns without this flag set.
+  IREE_VM_EXECUTION_RESULT_FLAG_YIELDED = 1u << 0,
+};
+typedef uint32_t iree_vm_execution_result_flags_t;
+
+// Results of a begin_call or resume_call request.
+// Callers must zero-initialize the result prior to making the request.
 typedef struct {
-  // TODO(benvanik): yield information.
-  // Yield modes:
-  // - yield (yield instruction)
-  // - await (with 1+ wait handles)
-  // - break
-  int reserved;
+  // TODO(benvanik): await (with 1+ wait handles) and break.
+  iree_vm_execution_result_flags_t flags;
 } iree_vm_execution_result_t;
 
 // Defines an interface that can be used to reflect and execute functions on a
@@ -308,12 +318,15 @@ typedef struct iree_vm_module {
 
   // Begins a function call with the given |call| arguments.
   // Execution may yield in the case of asynchronous code and require one or
-  // more calls to the resume method to complete.
+  // more calls to the resume method to complete. When execution yields the
+  // |call| results buffer must remain valid until the call completes.
   iree_status_t(IREE_API_PTR* begin_call)(
       void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
       iree_vm_execution_result_t* out_result);
 
   // Resumes execution of a previously-yielded call.
+  // |stack| must be the stack the call yielded on and may be resumed from any
+  // thread so long as it is not used concurrently.
   iree_status_t(IREE_API_PTR* resume_call)(
       void* self, iree_vm_stack_t* stack,
       iree_vm_execution_result_t* out_result);
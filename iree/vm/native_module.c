@@ -272,6 +272,7 @@ static iree_status_t IREE_API_PTR iree_vm_native_module_begin_call(
     void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
     iree_vm_execution_result_t* out_result) {
   iree_vm_native_module_t* module = (iree_vm_native_module_t*)self;
+  memset(out_result, 0, sizeof(*out_result));
   if (IREE_UNLIKELY(call->function.linkage !=
                     IREE_VM_FUNCTION_LINKAGE_EXPORT) ||
       IREE_UNLIKELY(call->function.ordinal >=
@@ -0,0 +1,504 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Inline C implementations of the primitive VM ops.
+//
+// These are used by modules generated with the --iree-vm-ir-to-c-module
+// translation: each VM op `vm.foo.bar` lowers to a call to `vm_foo_bar` with
+// the same operand order. Pseudo ops are canonicalized away prior to
+// translation and have no implementation here. The semantics must match the
+// bytecode interpreter in bytecode_dispatch.c exactly so that a module behaves
+// the same regardless of whether it is interpreted or compiled ahead of time.
+
+#ifndef IREE_VM_OPS_H_
+#define IREE_VM_OPS_H_
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/atomics.h"
+#include "iree/vm/builtin_types.h"
+#include "iree/vm/list.h"
+#include "iree/vm/ref.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Globals
+//===----------------------------------------------------------------------===//
+// Primitive globals are stored in the module state rwdata buffer at the byte
+// offset assigned by the ordinal allocation pass.
+
+static inline int32_t vm_global_load_i32(const uint8_t* base, uint32_t offset) {
+  int32_t value;
+  memcpy(&value, base + offset, sizeof(value));
+  return value;
+}
+static inline int64_t vm_global_load_i64(const uint8_t* base, uint32_t offset) {
+  int64_t value;
+  memcpy(&value, base + offset, sizeof(value));
+  return value;
+}
+static inline float vm_global_load_f32(const uint8_t* base, uint32_t offset) {
+  float value;
+  memcpy(&value, base + offset, sizeof(value));
+  return value;
+}
+
+static inline void vm_global_store_i32(uint8_t* base, uint32_t offset,
+                                       int32_t value) {
+  memcpy(base + offset, &value, sizeof(value));
+}
+static inline void vm_global_store_i64(uint8_t* base, uint32_t offset,
+                                       int64_t value) {
+  memcpy(base + offset, &value, sizeof(value));
+}
+static inline void vm_global_store_f32(uint8_t* base, uint32_t offset,
+                                       float value) {
+  memcpy(base + offset, &value, sizeof(value));
+}
+
+//===----------------------------------------------------------------------===//
+// Refs
+//===----------------------------------------------------------------------===//
+// Ref values are iree_vm_ref_t locals owned by the generated function. Ops that
+// produce a ref release whatever the result local previously referenced.
+
+// Retains |src| into |dst|, releasing the prior contents of |dst|.
+// Unlike iree_vm_ref_retain this is correct when |dst| already references the
+// same object as |src| (as happens when a loop carries a ref).
+static inline void vm_ref_retain(iree_vm_ref_t* src, iree_vm_ref_t* dst) {
+  iree_vm_ref_t temp;
+  memset(&temp, 0, sizeof(temp));
+  iree_vm_ref_retain(src, &temp);
+  iree_vm_ref_move(&temp, dst);
+}
+
+// Initializes a rodata segment in the module state. The state owns the initial
+// reference so the (unowned) data is never destroyed through the ref.
+static inline void vm_rodata_initialize(iree_vm_ro_byte_buffer_t* rodata,
+                                        const uint8_t* data,
+                                        iree_host_size_t data_length) {
+  iree_atomic_store(&rodata->ref_object.counter, 1);
+  rodata->data = iree_make_const_byte_span(data, data_length);
+  rodata->destroy = NULL;
+}
+
+static inline void vm_const_ref_zero(iree_vm_ref_t* result) {
+  iree_vm_ref_release(result);
+}
+static inline iree_status_t vm_const_ref_rodata(
+    iree_vm_ro_byte_buffer_t* rodata, iree_vm_ref_t* result) {
+  return iree_vm_ref_wrap_retain(rodata, iree_vm_ro_byte_buffer_type_id(),
+                                 result);
+}
+
+static inline void vm_global_load_ref(iree_vm_ref_t* global,
+                                      iree_vm_ref_t* result) {
+  vm_ref_retain(global, result);
+}
+static inline void vm_global_store_ref(iree_vm_ref_t* global,
+                                       iree_vm_ref_t* value) {
+  vm_ref_retain(value, global);
+}
+
+//===----------------------------------------------------------------------===//
+// Lists
+//===----------------------------------------------------------------------===//
+
+static inline iree_status_t vm_list_check_deref(iree_vm_ref_t* list_ref,
+                                                iree_vm_list_t** out_list) {
+  *out_list = iree_vm_list_deref(list_ref);
+  if (IREE_UNLIKELY(!*out_list)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+  }
+  return iree_ok_status();
+}
+
+static inline iree_status_t vm_list_alloc(iree_vm_type_def_t element_type,
+                                          int32_t initial_capacity,
+                                          iree_allocator_t allocator,
+                                          iree_vm_ref_t* result) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_list_create(
+      &element_type, (uint32_t)initial_capacity, allocator, &list));
+  return iree_vm_ref_wrap_assign(list, iree_vm_list_type_id(), result);
+}
+
+static inline iree_status_t vm_list_reserve(iree_vm_ref_t* list_ref,
+                                            int32_t minimum_capacity) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_check_deref(list_ref, &list));
+  return iree_vm_list_reserve(list, (uint32_t)minimum_capacity);
+}
+
+static inline iree_status_t vm_list_size(iree_vm_ref_t* list_ref,
+                                         int32_t* result) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_check_deref(list_ref, &list));
+  *result = (int32_t)iree_vm_list_size(list);
+  return iree_ok_status();
+}
+
+static inline iree_status_t vm_list_resize(iree_vm_ref_t* list_ref,
+                                           int32_t new_size) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_check_deref(list_ref, &list));
+  return iree_vm_list_resize(list, (uint32_t)new_size);
+}
+
+static inline iree_status_t vm_list_get_i32(iree_vm_ref_t* list_ref,
+                                            int32_t index, int32_t* result) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_check_deref(list_ref, &list));
+  iree_vm_value_t value;
+  IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+      list, (uint32_t)index, IREE_VM_VALUE_TYPE_I32, &value));
+  *result = value.i32;
+  return iree_ok_status();
+}
+static inline iree_status_t vm_list_get_i64(iree_vm_ref_t* list_ref,
+                                            int32_t index, int64_t* result) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_check_deref(list_ref, &list));
+  iree_vm_value_t value;
+  IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+      list, (uint32_t)index, IREE_VM_VALUE_TYPE_I64, &value));
+  *result = value.i64;
+  return iree_ok_status();
+}
+static inline iree_status_t vm_list_get_f32(iree_vm_ref_t* list_ref,
+                                            int32_t index, float* result) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_check_deref(list_ref, &list));
+  iree_vm_value_t value;
+  IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+      list, (uint32_t)index, IREE_VM_VALUE_TYPE_F32, &value));
+  *result = value.f32;
+  return iree_ok_status();
+}
+
+static inline iree_status_t vm_list_set_i32(iree_vm_ref_t* list_ref,
+                                            int32_t index, int32_t raw_value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_check_deref(list_ref, &list));
+  iree_vm_value_t value = iree_vm_value_make_i32(raw_value);
+  return iree_vm_list_set_value(list, (uint32_t)index, &value);
+}
+static inline iree_status_t vm_list_set_i64(iree_vm_ref_t* list_ref,
+                                            int32_t index, int64_t raw_value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_check_deref(list_ref, &list));
+  iree_vm_value_t value = iree_vm_value_make_i64(raw_value);
+  return iree_vm_list_set_value(list, (uint32_t)index, &value);
+}
+static inline iree_status_t vm_list_set_f32(iree_vm_ref_t* list_ref,
+                                            int32_t index, float raw_value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_check_deref(list_ref, &list));
+  iree_vm_value_t value = iree_vm_value_make_f32(raw_value);
+  return iree_vm_list_set_value(list, (uint32_t)index, &value);
+}
+
+// NOTE: the interpreter does not implement ref elements yet either.
+static inline iree_status_t vm_list_get_ref(iree_vm_ref_t* list_ref,
+                                            int32_t index,
+                                            iree_vm_ref_t* result) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "vm.list.get.ref not implemented");
+}
+static inline iree_status_t vm_list_set_ref(iree_vm_ref_t* list_ref,
+                                            int32_t index,
+                                            iree_vm_ref_t* value) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "vm.list.set.ref not implemented");
+}
+
+//===----------------------------------------------------------------------===//
+// Conditional assignment
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_select_i32(int32_t condition, int32_t true_value,
+                                    int32_t false_value) {
+  return condition ? true_value : false_value;
+}
+static inline int64_t vm_select_i64(int32_t condition, int64_t true_value,
+                                    int64_t false_value) {
+  return condition ? true_value : false_value;
+}
+static inline float vm_select_f32(int32_t condition, float true_value,
+                                  float false_value) {
+  return condition ? true_value : false_value;
+}
+static inline void vm_select_ref(int32_t condition, iree_vm_ref_t* true_value,
+                                 iree_vm_ref_t* false_value,
+                                 iree_vm_ref_t* result) {
+  vm_ref_retain(condition ? true_value : false_value, result);
+}
+
+//===----------------------------------------------------------------------===//
+// Native integer arithmetic
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_add_i32(int32_t lhs, int32_t rhs) {
+  return (int32_t)((uint32_t)lhs + (uint32_t)rhs);
+}
+static inline int32_t vm_sub_i32(int32_t lhs, int32_t rhs) {
+  return (int32_t)((uint32_t)lhs - (uint32_t)rhs);
+}
+static inline int32_t vm_mul_i32(int32_t lhs, int32_t rhs) {
+  return (int32_t)((uint32_t)lhs * (uint32_t)rhs);
+}
+static inline int32_t vm_div_i32_s(int32_t lhs, int32_t rhs) {
+  return lhs / rhs;
+}
+static inline int32_t vm_div_i32_u(int32_t lhs, int32_t rhs) {
+  return (int32_t)((uint32_t)lhs / (uint32_t)rhs);
+}
+static inline int32_t vm_rem_i32_s(int32_t lhs, int32_t rhs) {
+  return lhs % rhs;
+}
+static inline int32_t vm_rem_i32_u(int32_t lhs, int32_t rhs) {
+  return (int32_t)((uint32_t)lhs % (uint32_t)rhs);
+}
+static inline int32_t vm_not_i32(int32_t operand) {
+  return (int32_t)(~(uint32_t)operand);
+}
+static inline int32_t vm_and_i32(int32_t lhs, int32_t rhs) {
+  return (int32_t)((uint32_t)lhs & (uint32_t)rhs);
+}
+static inline int32_t vm_or_i32(int32_t lhs, int32_t rhs) {
+  return (int32_t)((uint32_t)lhs | (uint32_t)rhs);
+}
+static inline int32_t vm_xor_i32(int32_t lhs, int32_t rhs) {
+  return (int32_t)((uint32_t)lhs ^ (uint32_t)rhs);
+}
+
+static inline int64_t vm_add_i64(int64_t lhs, int64_t rhs) {
+  return (int64_t)((uint64_t)lhs + (uint64_t)rhs);
+}
+static inline int64_t vm_sub_i64(int64_t lhs, int64_t rhs) {
+  return (int64_t)((uint64_t)lhs - (uint64_t)rhs);
+}
+static inline int64_t vm_mul_i64(int64_t lhs, int64_t rhs) {
+  return (int64_t)((uint64_t)lhs * (uint64_t)rhs);
+}
+static inline int64_t vm_div_i64_s(int64_t lhs, int64_t rhs) {
+  return lhs / rhs;
+}
+static inline int64_t vm_div_i64_u(int64_t lhs, int64_t rhs) {
+  return (int64_t)((uint64_t)lhs / (uint64_t)rhs);
+}
+static inline int64_t vm_rem_i64_s(int64_t lhs, int64_t rhs) {
+  return lhs % rhs;
+}
+static inline int64_t vm_rem_i64_u(int64_t lhs, int64_t rhs) {
+  return (int64_t)((uint64_t)lhs % (uint64_t)rhs);
+}
+static inline int64_t vm_not_i64(int64_t operand) {
+  return (int64_t)(~(uint64_t)operand);
+}
+static inline int64_t vm_and_i64(int64_t lhs, int64_t rhs) {
+  return (int64_t)((uint64_t)lhs & (uint64_t)rhs);
+}
+static inline int64_t vm_or_i64(int64_t lhs, int64_t rhs) {
+  return (int64_t)((uint64_t)lhs | (uint64_t)rhs);
+}
+static inline int64_t vm_xor_i64(int64_t lhs, int64_t rhs) {
+  return (int64_t)((uint64_t)lhs ^ (uint64_t)rhs);
+}
+
+//===----------------------------------------------------------------------===//
+// Native bitwise shifts
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_shl_i32(int32_t operand, int8_t amount) {
+  return (int32_t)((uint32_t)operand << amount);
+}
+static inline int32_t vm_shr_i32_s(int32_t operand, int8_t amount) {
+  return operand >> amount;
+}
+static inline int32_t vm_shr_i32_u(int32_t operand, int8_t amount) {
+  return (int32_t)((uint32_t)operand >> amount);
+}
+
+static inline int64_t vm_shl_i64(int64_t operand, int8_t amount) {
+  return (int64_t)((uint64_t)operand << amount);
+}
+static inline int64_t vm_shr_i64_s(int64_t operand, int8_t amount) {
+  return operand >> amount;
+}
+static inline int64_t vm_shr_i64_u(int64_t operand, int8_t amount) {
+  return (int64_t)((uint64_t)operand >> amount);
+}
+
+//===----------------------------------------------------------------------===//
+// Native floating-point arithmetic
+//===----------------------------------------------------------------------===//
+
+static inline float vm_add_f32(float lhs, float rhs) { return lhs + rhs; }
+static inline float vm_sub_f32(float lhs, float rhs) { return lhs - rhs; }
+static inline float vm_mul_f32(float lhs, float rhs) { return lhs * rhs; }
+static inline float vm_div_f32(float lhs, float rhs) { return lhs / rhs; }
+static inline float vm_rem_f32(float lhs, float rhs) {
+  return fmodf(lhs, rhs);
+}
+static inline float vm_abs_f32(float operand) { return fabsf(operand); }
+static inline float vm_neg_f32(float operand) { return -operand; }
+static inline float vm_ceil_f32(float operand) { return ceilf(operand); }
+static inline float vm_floor_f32(float operand) { return floorf(operand); }
+static inline float vm_sqrt_f32(float operand) { return sqrtf(operand); }
+static inline float vm_rsqrt_f32(float operand) {
+  return 1.0f / sqrtf(operand);
+}
+static inline float vm_exp_f32(float operand) { return expf(operand); }
+static inline float vm_log_f32(float operand) { return logf(operand); }
+static inline float vm_tanh_f32(float operand) { return tanhf(operand); }
+
+//===----------------------------------------------------------------------===//
+// Casting and type conversion/emulation
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_trunc_i32_i8(int32_t operand) {
+  return (int32_t)(uint8_t)operand;
+}
+static inline int32_t vm_trunc_i32_i16(int32_t operand) {
+  return (int32_t)(uint16_t)operand;
+}
+static inline int32_t vm_trunc_i64_i32(int64_t operand) {
+  return (int32_t)(uint32_t)operand;
+}
+
+static inline int32_t vm_ext_i8_i32_s(int32_t operand) {
+  return (int32_t)(int8_t)operand;
+}
+static inline int32_t vm_ext_i8_i32_u(int32_t operand) {
+  return (int32_t)(uint8_t)operand;
+}
+static inline int32_t vm_ext_i16_i32_s(int32_t operand) {
+  return (int32_t)(int16_t)operand;
+}
+static inline int32_t vm_ext_i16_i32_u(int32_t operand) {
+  return (int32_t)(uint16_t)operand;
+}
+static inline int64_t vm_ext_i32_i64_s(int32_t operand) {
+  return (int64_t)operand;
+}
+static inline int64_t vm_ext_i32_i64_u(int32_t operand) {
+  return (int64_t)(uint32_t)operand;
+}
+
+static inline float vm_cast_si32_f32(int32_t operand) {
+  return (float)operand;
+}
+static inline float vm_cast_ui32_f32(int32_t operand) {
+  return (float)(uint32_t)operand;
+}
+// Out of range values saturate and NaN converts to 0. A plain C cast of those
+// values is undefined behavior. The interpreter uses these directly.
+static inline int32_t vm_cast_f32_si32(float operand) {
+  if (isnan(operand)) return 0;
+  if (operand <= -2147483648.0f) return INT32_MIN;
+  if (operand >= 2147483648.0f) return INT32_MAX;
+  return (int32_t)operand;
+}
+static inline int32_t vm_cast_f32_ui32(float operand) {
+  if (!(operand > 0.0f)) return 0;
+  if (operand >= 4294967296.0f) return (int32_t)UINT32_MAX;
+  return (int32_t)(uint32_t)operand;
+}
+static inline float vm_bitcast_i32_f32(int32_t operand) {
+  float result;
+  memcpy(&result, &operand, sizeof(result));
+  return result;
+}
+static inline int32_t vm_bitcast_f32_i32(float operand) {
+  int32_t result;
+  memcpy(&result, &operand, sizeof(result));
+  return result;
+}
+
+//===----------------------------------------------------------------------===//
+// Comparison ops
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_cmp_eq_i32(int32_t lhs, int32_t rhs) {
+  return (lhs == rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_i32(int32_t lhs, int32_t rhs) {
+  return (lhs != rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_i32_s(int32_t lhs, int32_t rhs) {
+  return (lhs < rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_i32_u(int32_t lhs, int32_t rhs) {
+  return ((uint32_t)lhs < (uint32_t)rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_nz_i32(int32_t operand) {
+  return (operand != 0) ? 1 : 0;
+}
+
+static inline int32_t vm_cmp_eq_i64(int64_t lhs, int64_t rhs) {
+  return (lhs == rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_i64(int64_t lhs, int64_t rhs) {
+  return (lhs != rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_i64_s(int64_t lhs, int64_t rhs) {
+  return (lhs < rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_i64_u(int64_t lhs, int64_t rhs) {
+  return ((uint64_t)lhs < (uint64_t)rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_nz_i64(int64_t operand) {
+  return (operand != 0) ? 1 : 0;
+}
+
+// NOTE: C comparison operators are ordered (false if either operand is NaN)
+// with the exception of != which is unordered.
+static inline int32_t vm_cmp_eq_f32(float lhs, float rhs) {
+  return (lhs == rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_f32(float lhs, float rhs) {
+  return (lhs != rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_f32(float lhs, float rhs) {
+  return (lhs < rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lte_f32(float lhs, float rhs) {
+  return (lhs <= rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_nz_f32(float operand) {
+  return (operand != 0.0f) ? 1 : 0;
+}
+
+static inline int32_t vm_cmp_eq_ref(iree_vm_ref_t* lhs, iree_vm_ref_t* rhs) {
+  return iree_vm_ref_equal(lhs, rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_ref(iree_vm_ref_t* lhs, iree_vm_ref_t* rhs) {
+  return iree_vm_ref_equal(lhs, rhs) ? 0 : 1;
+}
+static inline int32_t vm_cmp_nz_ref(iree_vm_ref_t* operand) {
+  return operand->ptr != NULL ? 1 : 0;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_VM_OPS_H_
@@ -0,0 +1,230 @@
+vm.module @arithmetic_ops_f32 {
+
+  //===--------------------------------------------------------------------===//
+  // F32 Arithmetic
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_add_f32
+  vm.func @test_add_f32() {
+    %c1 = vm.const.f32 1.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.add.f32 %c1dno, %c1dno : f32
+    %c2 = vm.const.f32 3.0 : f32
+    vm.check.eq %v, %c2, "1.5+1.5=3" : f32
+    vm.return
+  }
+
+  vm.export @test_sub_f32
+  vm.func @test_sub_f32() {
+    %c1 = vm.const.f32 3.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 2.5 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.sub.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 0.5 : f32
+    vm.check.eq %v, %c3, "3.0-2.5=0.5" : f32
+    vm.return
+  }
+
+  vm.export @test_mul_f32
+  vm.func @test_mul_f32() {
+    %c1 = vm.const.f32 2.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.mul.f32 %c1dno, %c1dno : f32
+    %c2 = vm.const.f32 6.25 : f32
+    vm.check.eq %v, %c2, "2.5*2.5=6.25" : f32
+    vm.return
+  }
+
+  vm.export @test_div_f32
+  vm.func @test_div_f32() {
+    %c1 = vm.const.f32 4.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 -2.0 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.div.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 -2.0 : f32
+    vm.check.eq %v, %c3, "4.0/-2.0=-2.0" : f32
+    vm.return
+  }
+
+  vm.export @test_rem_f32
+  vm.func @test_rem_f32() {
+    %c1 = vm.const.f32 -3.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 -2.0 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.rem.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 -1.0 : f32
+    vm.check.eq %v, %c3, "-3.0%-2.0=-1.0" : f32
+    vm.return
+  }
+
+  vm.export @test_abs_f32
+  vm.func @test_abs_f32() {
+    %c1 = vm.const.f32 -1.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.abs.f32 %c1dno : f32
+    %c2 = vm.const.f32 1.5 : f32
+    vm.check.eq %v, %c2, "abs(-1.5)=1.5" : f32
+    vm.return
+  }
+
+  vm.export @test_neg_f32
+  vm.func @test_neg_f32() {
+    %c1 = vm.const.f32 -1.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.neg.f32 %c1dno : f32
+    %c2 = vm.const.f32 1.5 : f32
+    vm.check.eq %v, %c2, "neg(-1.5)=1.5" : f32
+    vm.return
+  }
+
+  vm.export @test_ceil_f32
+  vm.func @test_ceil_f32() {
+    %c1 = vm.const.f32 1.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.ceil.f32 %c1dno : f32
+    %c2 = vm.const.f32 2.0 : f32
+    vm.check.eq %v, %c2, "ceil(1.5)=2.0" : f32
+    vm.return
+  }
+
+  vm.export @test_floor_f32
+  vm.func @test_floor_f32() {
+    %c1 = vm.const.f32 -1.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.floor.f32 %c1dno : f32
+    %c2 = vm.const.f32 -2.0 : f32
+    vm.check.eq %v, %c2, "floor(-1.5)=-2.0" : f32
+    vm.return
+  }
+
+  vm.export @test_sqrt_f32
+  vm.func @test_sqrt_f32() {
+    %c1 = vm.const.f32 6.25 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.sqrt.f32 %c1dno : f32
+    %c2 = vm.const.f32 2.5 : f32
+    vm.check.eq %v, %c2, "sqrt(6.25)=2.5" : f32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // F32 Casts
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cast_si32_f32
+  vm.func @test_cast_si32_f32() {
+    %c1 = vm.const.i32 -3 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %v = vm.cast.si32.f32 %c1dno : i32 -> f32
+    %c2 = vm.const.f32 -3.0 : f32
+    vm.check.eq %v, %c2, "cast(-3)=-3.0" : f32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_si32
+  vm.func @test_cast_f32_si32() {
+    %c1 = vm.const.f32 -3.75 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.cast.f32.si32 %c1dno : f32 -> i32
+    %c2 = vm.const.i32 -3 : i32
+    vm.check.eq %v, %c2, "cast(-3.75)=-3" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_si32_saturate
+  vm.func @test_cast_f32_si32_saturate() {
+    %c1 = vm.const.f32 3.0e9 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v1 = vm.cast.f32.si32 %c1dno : f32 -> i32
+    %max = vm.const.i32 2147483647 : i32
+    vm.check.eq %v1, %max, "cast(3e9)=INT32_MAX" : i32
+    %c2 = vm.const.f32 -3.0e9 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v2 = vm.cast.f32.si32 %c2dno : f32 -> i32
+    %min = vm.const.i32 -2147483648 : i32
+    vm.check.eq %v2, %min, "cast(-3e9)=INT32_MIN" : i32
+    %zero = vm.const.f32.zero : f32
+    %zero_dno = iree.do_not_optimize(%zero) : f32
+    %nan = vm.div.f32 %zero_dno, %zero_dno : f32
+    %v3 = vm.cast.f32.si32 %nan : f32 -> i32
+    %c0 = vm.const.i32 0 : i32
+    vm.check.eq %v3, %c0, "cast(NaN)=0" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_ui32_saturate
+  vm.func @test_cast_f32_ui32_saturate() {
+    %c1 = vm.const.f32 5.0e9 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v1 = vm.cast.f32.ui32 %c1dno : f32 -> i32
+    %max = vm.const.i32 -1 : i32
+    vm.check.eq %v1, %max, "cast(5e9)=UINT32_MAX" : i32
+    %c2 = vm.const.f32 -3.75 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v2 = vm.cast.f32.ui32 %c2dno : f32 -> i32
+    %c0 = vm.const.i32 0 : i32
+    vm.check.eq %v2, %c0, "cast(-3.75)=0" : i32
+    %zero = vm.const.f32.zero : f32
+    %zero_dno = iree.do_not_optimize(%zero) : f32
+    %nan = vm.div.f32 %zero_dno, %zero_dno : f32
+    %v3 = vm.cast.f32.ui32 %nan : f32 -> i32
+    vm.check.eq %v3, %c0, "cast(NaN)=0" : i32
+    vm.return
+  }
+
+  vm.export @test_bitcast_f32_i32
+  vm.func @test_bitcast_f32_i32() {
+    %c1 = vm.const.f32 1.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.bitcast.f32.i32 %c1dno : f32 -> i32
+    %c2 = vm.const.i32 1065353216 : i32
+    vm.check.eq %v, %c2, "bitcast(1.0)=0x3F800000" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // F32 Comparisons
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_lt_f32
+  vm.func @test_cmp_lt_f32() {
+    %lhs = vm.const.f32 -2.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 2.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.lt.f32 %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "-2.0 < 2.0" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gte_f32
+  vm.func @test_cmp_gte_f32() {
+    %lhs = vm.const.f32 2.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 2.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.gte.f32 %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "2.0 >= 2.0" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_nan_f32
+  vm.func @test_cmp_nan_f32() {
+    %zero = vm.const.f32.zero : f32
+    %zero_dno = iree.do_not_optimize(%zero) : f32
+    %nan = vm.div.f32 %zero_dno, %zero_dno : f32
+    %eq = vm.cmp.eq.f32 %nan, %nan : f32
+    %ne = vm.cmp.ne.f32 %nan, %nan : f32
+    %c0 = vm.const.i32 0 : i32
+    %c1 = vm.const.i32 1 : i32
+    vm.check.eq %eq, %c0, "NaN == NaN is false" : i32
+    vm.check.eq %ne, %c1, "NaN != NaN is true" : i32
+    vm.return
+  }
+
+}
@@ -0,0 +1,124 @@
+vm.module @ref_ops {
+
+  vm.rodata @buffer_a dense<[1, 2, 3]> : tensor<3xi8>
+  vm.rodata @buffer_b dense<[4.0, 5.0]> : tensor<2xf32>
+
+  vm.global.ref @g0 mutable : !vm.ref<!iree.byte_buffer>
+
+  //===--------------------------------------------------------------------===//
+  // vm.const.ref.*
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_zero_ref
+  vm.func @test_zero_ref() {
+    %ref = vm.const.ref.zero : !vm.ref<!iree.byte_buffer>
+    %ref_dno = iree.do_not_optimize(%ref) : !vm.ref<!iree.byte_buffer>
+    %nz = vm.cmp.nz.ref %ref_dno : !vm.ref<!iree.byte_buffer>
+    %c0 = vm.const.i32 0 : i32
+    vm.check.eq %nz, %c0, "null ref is nonzero" : i32
+    vm.return
+  }
+
+  vm.export @fail_zero_ref
+  vm.func @fail_zero_ref() {
+    %ref = vm.const.ref.zero : !vm.ref<!iree.byte_buffer>
+    %ref_dno = iree.do_not_optimize(%ref) : !vm.ref<!iree.byte_buffer>
+    vm.check.nz %ref_dno, "expected null" : !vm.ref<!iree.byte_buffer>
+    vm.return
+  }
+
+  vm.export @test_rodata_ref
+  vm.func @test_rodata_ref() {
+    %ref_a = vm.const.ref.rodata @buffer_a : !vm.ref<!iree.byte_buffer>
+    %ref_a_dno = iree.do_not_optimize(%ref_a) : !vm.ref<!iree.byte_buffer>
+    vm.check.nz %ref_a_dno, "rodata ref is null" : !vm.ref<!iree.byte_buffer>
+    %ref_a2 = vm.const.ref.rodata @buffer_a : !vm.ref<!iree.byte_buffer>
+    %ref_a2_dno = iree.do_not_optimize(%ref_a2) : !vm.ref<!iree.byte_buffer>
+    vm.check.eq %ref_a_dno, %ref_a2_dno, "same rodata differs" : !vm.ref<!iree.byte_buffer>
+    %ref_b = vm.const.ref.rodata @buffer_b : !vm.ref<!iree.byte_buffer>
+    %ref_b_dno = iree.do_not_optimize(%ref_b) : !vm.ref<!iree.byte_buffer>
+    vm.check.ne %ref_a_dno, %ref_b_dno, "different rodata is equal" : !vm.ref<!iree.byte_buffer>
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.select.ref
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_select_ref
+  vm.func @test_select_ref() {
+    %c0 = vm.const.i32 0 : i32
+    %c0dno = iree.do_not_optimize(%c0) : i32
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %ref_a = vm.const.ref.rodata @buffer_a : !vm.ref<!iree.byte_buffer>
+    %ref_b = vm.const.ref.rodata @buffer_b : !vm.ref<!iree.byte_buffer>
+    %v0 = vm.select.ref %c0dno, %ref_a, %ref_b : !vm.ref<!iree.byte_buffer>
+    vm.check.eq %v0, %ref_b, "0 ? a : b = b" : !vm.ref<!iree.byte_buffer>
+    %v1 = vm.select.ref %c1dno, %ref_a, %ref_b : !vm.ref<!iree.byte_buffer>
+    vm.check.eq %v1, %ref_a, "1 ? a : b = a" : !vm.ref<!iree.byte_buffer>
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.global.*.ref
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_global_ref
+  vm.func @test_global_ref() {
+    %null = vm.global.load.ref @g0 : !vm.ref<!iree.byte_buffer>
+    %nz = vm.cmp.nz.ref %null : !vm.ref<!iree.byte_buffer>
+    %c0 = vm.const.i32 0 : i32
+    vm.check.eq %nz, %c0, "global is initially nonzero" : i32
+    %ref_a = vm.const.ref.rodata @buffer_a : !vm.ref<!iree.byte_buffer>
+    %ref_a_dno = iree.do_not_optimize(%ref_a) : !vm.ref<!iree.byte_buffer>
+    vm.global.store.ref %ref_a_dno, @g0 : !vm.ref<!iree.byte_buffer>
+    %loaded = vm.global.load.ref @g0 : !vm.ref<!iree.byte_buffer>
+    vm.check.eq %loaded, %ref_a_dno, "global round trip" : !vm.ref<!iree.byte_buffer>
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Refs across calls and branches
+  //===--------------------------------------------------------------------===//
+
+  vm.func @pick_ref(%cond : i32, %lhs : !vm.ref<!iree.byte_buffer>, %rhs : !vm.ref<!iree.byte_buffer>) -> !vm.ref<!iree.byte_buffer> attributes {noinline} {
+    vm.cond_br %cond, ^bb1(%lhs : !vm.ref<!iree.byte_buffer>), ^bb1(%rhs : !vm.ref<!iree.byte_buffer>)
+  ^bb1(%result : !vm.ref<!iree.byte_buffer>):
+    vm.return %result : !vm.ref<!iree.byte_buffer>
+  }
+
+  vm.export @test_ref_call
+  vm.func @test_ref_call() {
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %ref_a = vm.const.ref.rodata @buffer_a : !vm.ref<!iree.byte_buffer>
+    %ref_b = vm.const.ref.rodata @buffer_b : !vm.ref<!iree.byte_buffer>
+    %v = vm.call @pick_ref(%c1dno, %ref_a, %ref_b) : (i32, !vm.ref<!iree.byte_buffer>, !vm.ref<!iree.byte_buffer>) -> !vm.ref<!iree.byte_buffer>
+    vm.check.eq %v, %ref_a, "picked lhs" : !vm.ref<!iree.byte_buffer>
+    vm.return
+  }
+
+  // Swaps two refs through block arguments several times to ensure the
+  // branch copies neither leak nor drop references.
+  vm.export @test_ref_loop
+  vm.func @test_ref_loop() {
+    %c0 = vm.const.i32 0 : i32
+    %c1 = vm.const.i32 1 : i32
+    %c5 = vm.const.i32 5 : i32
+    %c0dno = iree.do_not_optimize(%c0) : i32
+    %ref_a = vm.const.ref.rodata @buffer_a : !vm.ref<!iree.byte_buffer>
+    %ref_b = vm.const.ref.rodata @buffer_b : !vm.ref<!iree.byte_buffer>
+    vm.br ^loop(%c0dno, %ref_a, %ref_b : i32, !vm.ref<!iree.byte_buffer>, !vm.ref<!iree.byte_buffer>)
+  ^loop(%i : i32, %x : !vm.ref<!iree.byte_buffer>, %y : !vm.ref<!iree.byte_buffer>):
+    %i_next = vm.add.i32 %i, %c1 : i32
+    %cond = vm.cmp.lt.i32.s %i_next, %c5 : i32
+    vm.cond_br %cond, ^loop(%i_next, %y, %x : i32, !vm.ref<!iree.byte_buffer>, !vm.ref<!iree.byte_buffer>), ^exit(%x, %y : !vm.ref<!iree.byte_buffer>, !vm.ref<!iree.byte_buffer>)
+  ^exit(%x_final : !vm.ref<!iree.byte_buffer>, %y_final : !vm.ref<!iree.byte_buffer>):
+    // 5 iterations swap 4 times so the refs end where they started.
+    vm.check.eq %x_final, %ref_a, "x after swaps" : !vm.ref<!iree.byte_buffer>
+    vm.check.eq %y_final, %ref_b, "y after swaps" : !vm.ref<!iree.byte_buffer>
+    vm.return
+  }
+
+}
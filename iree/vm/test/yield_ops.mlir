@@ -0,0 +1,100 @@
+vm.module @yield_ops {
+
+  //===--------------------------------------------------------------------===//
+  // vm.yield
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_yield_sequence
+  vm.func @test_yield_sequence() {
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %v1 = vm.add.i32 %c1dno, %c1dno : i32
+    vm.yield
+    %v2 = vm.add.i32 %v1, %c1dno : i32
+    vm.yield
+    %v3 = vm.add.i32 %v2, %v1 : i32
+    vm.yield
+    %c2 = vm.const.i32 2 : i32
+    %c3 = vm.const.i32 3 : i32
+    %c5 = vm.const.i32 5 : i32
+    vm.check.eq %v1, %c2, "1+1=2 across yields" : i32
+    vm.check.eq %v2, %c3, "2+1=3 across yields" : i32
+    vm.check.eq %v3, %c5, "3+2=5 across yields" : i32
+    vm.return
+  }
+
+  vm.export @test_yield_in_loop
+  vm.func @test_yield_in_loop() {
+    %c0 = vm.const.i32 0 : i32
+    %c1 = vm.const.i32 1 : i32
+    %c3 = vm.const.i32 3 : i32
+    %c10 = vm.const.i32 10 : i32
+    %c30 = vm.const.i32 30 : i32
+    %c0dno = iree.do_not_optimize(%c0) : i32
+    %c3dno = iree.do_not_optimize(%c3) : i32
+    %c10dno = iree.do_not_optimize(%c10) : i32
+    vm.br ^loop(%c0dno, %c0dno : i32, i32)
+  ^loop(%i : i32, %sum : i32):
+    vm.yield
+    %sum_next = vm.add.i32 %sum, %c3dno : i32
+    %i_next = vm.add.i32 %i, %c1 : i32
+    %cond = vm.cmp.lt.i32.s %i_next, %c10dno : i32
+    vm.cond_br %cond, ^loop(%i_next, %sum_next : i32, i32), ^exit(%i_next, %sum_next : i32, i32)
+  ^exit(%count : i32, %total : i32):
+    vm.check.eq %count, %c10, "loop ran 10 times" : i32
+    vm.check.eq %total, %c30, "sum of 10 x 3 = 30" : i32
+    vm.return
+  }
+
+  // Yields once before and once after doing its work so that both the
+  // argument and the result have to survive a resume.
+  vm.func @yield_add(%lhs : i32, %rhs : i32) -> i32 attributes {noinline} {
+    vm.yield
+    %sum = vm.add.i32 %lhs, %rhs : i32
+    vm.yield
+    vm.return %sum : i32
+  }
+
+  vm.func @yield_add_twice(%lhs : i32, %rhs : i32) -> i32 attributes {noinline} {
+    %0 = vm.call @yield_add(%lhs, %rhs) : (i32, i32) -> i32
+    vm.yield
+    %1 = vm.call @yield_add(%0, %rhs) : (i32, i32) -> i32
+    vm.return %1 : i32
+  }
+
+  vm.export @test_yield_in_nested_calls
+  vm.func @test_yield_in_nested_calls() {
+    %c2 = vm.const.i32 2 : i32
+    %c7 = vm.const.i32 7 : i32
+    %c2dno = iree.do_not_optimize(%c2) : i32
+    %c7dno = iree.do_not_optimize(%c7) : i32
+    %v = vm.call @yield_add_twice(%c2dno, %c7dno) : (i32, i32) -> i32
+    vm.yield
+    %c16 = vm.const.i32 16 : i32
+    vm.check.eq %v, %c16, "2+7+7=16 across nested yields" : i32
+    // Registers in the caller must not be clobbered by the callee frames.
+    vm.check.eq %c2dno, %c2, "caller lhs preserved" : i32
+    vm.check.eq %c7dno, %c7, "caller rhs preserved" : i32
+    vm.return
+  }
+
+  vm.export @test_yield_in_nested_call_loop
+  vm.func @test_yield_in_nested_call_loop() {
+    %c0 = vm.const.i32 0 : i32
+    %c1 = vm.const.i32 1 : i32
+    %c4 = vm.const.i32 4 : i32
+    %c0dno = iree.do_not_optimize(%c0) : i32
+    %c4dno = iree.do_not_optimize(%c4) : i32
+    vm.br ^loop(%c0dno, %c0dno : i32, i32)
+  ^loop(%i : i32, %acc : i32):
+    %acc_next = vm.call @yield_add(%acc, %c4dno) : (i32, i32) -> i32
+    %i_next = vm.add.i32 %i, %c1 : i32
+    %cond = vm.cmp.lt.i32.s %i_next, %c4dno : i32
+    vm.cond_br %cond, ^loop(%i_next, %acc_next : i32, i32), ^exit(%acc_next : i32)
+  ^exit(%result : i32):
+    %c16 = vm.const.i32 16 : i32
+    vm.check.eq %result, %c16, "4 x 4 = 16 across nested yields" : i32
+    vm.return
+  }
+
+}